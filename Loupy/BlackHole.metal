@@ -174,3 +174,66 @@ static float2 getMousePos(constant RMDLUniforms& uniforms, uint2 texelId, thread
 
     return pos.xy; // float3 { 0.0f, 0.0f, -0.95f };
 }
+
+// Text: one instance per glyph, drawn with the shared unit-quad index buffer
+// (0, 1, 2, 2, 3, 0). Layout matches text::GlyphInstance in RMDLTextBatch.hpp.
+struct GlyphInstance
+{
+    float2 position;
+    float2 size;
+    ushort4 uvRect;
+    uint color;
+    uint page;
+};
+
+struct TextUniforms
+{
+    float2 invViewportSize;
+};
+
+struct TextVtxOut
+{
+    float4 position [[position]];
+    float2 uv;
+    half4 color;
+    uint page [[flat]];
+};
+
+vertex TextVtxOut TextGlyphVs(uint vid [[vertex_id]],
+                              uint iid [[instance_id]],
+                              const device GlyphInstance* glyphs [[buffer(0)]],
+                              constant TextUniforms& uniforms [[buffer(1)]])
+{
+    const GlyphInstance glyph = glyphs[iid];
+    const float2 corner = float2(vid >= 2, vid == 1 || vid == 2);
+
+    float2 ndc = (glyph.position + corner * glyph.size) * uniforms.invViewportSize;
+    ndc = ndc * 2 - 1;
+    ndc.y *= -1;
+
+    TextVtxOut out;
+    out.position = float4(ndc, 0.0, 1.0);
+    out.uv = mix(float2(glyph.uvRect.xy), float2(glyph.uvRect.zw), corner) / 65535.f;
+    out.color = unpack_unorm4x8_to_half(glyph.color);
+    out.page = glyph.page;
+    return out;
+}
+
+fragment half4 TextGlyphPs(TextVtxOut in [[stage_in]],
+                           texture2d_array<half> atlas [[texture(0)]])
+{
+    constexpr sampler linearSampler(filter::linear, address::clamp_to_edge);
+    const half coverage = atlas.sample(linearSampler, in.uv, in.page).a;
+    return half4(in.color.rgb, in.color.a * coverage);
+}
+
+// Single-channel distance field: 0.5 on the outline, one screen pixel of antialiasing at any scale.
+fragment half4 TextSdfPs(TextVtxOut in [[stage_in]],
+                         texture2d_array<half> atlas [[texture(0)]])
+{
+    constexpr sampler linearSampler(filter::linear, address::clamp_to_edge);
+    const float distance = float(atlas.sample(linearSampler, in.uv, in.page).r) - 0.5f;
+    const float width = max(fwidth(distance), 1e-4f);
+    const half coverage = half(smoothstep(-width, width, distance));
+    return half4(in.color.rgb, in.color.a * coverage);
+}
@@ -0,0 +1,137 @@
+//
+//  Culling.metal
+//  Loupy
+//
+//  Created by Rémy on 19/10/2026.
+//
+
+#include <metal_stdlib>
+using namespace metal;
+
+#include "RMDLCulling_shared.h"
+
+// GPU-driven draw generation in three dispatches: test and count per threadgroup,
+// scan the counts, write the survivors' draw arguments at their scanned offsets.
+// The output is in instance order, as culling::cullAndCompact() produces on the CPU.
+
+// Exclusive prefix sum over a threadgroup of N threads (N a multiple of 32, at most
+// 1024, on Apple's 32-wide SIMD groups); `total` receives the sum over the whole
+// threadgroup.
+template< ushort N >
+inline uint threadgroupExclusiveSum( uint value, threadgroup uint* pSimdTotals,
+                                     ushort lane, ushort simdGroup, thread uint& total )
+{
+    constexpr ushort kSimdGroups = N / 32;
+    const uint prefix = simd_prefix_exclusive_sum(value);
+    if (lane == 31)
+        pSimdTotals[simdGroup] = prefix + value;
+    threadgroup_barrier(mem_flags::mem_threadgroup);
+    if (simdGroup == 0)
+    {
+        const uint groupTotal = lane < kSimdGroups ? pSimdTotals[lane] : 0;
+        const uint groupPrefix = simd_prefix_exclusive_sum(groupTotal);
+        if (lane < kSimdGroups)
+            pSimdTotals[lane] = groupPrefix;
+        if (lane == kSimdGroups - 1)
+            pSimdTotals[kSimdGroups] = groupPrefix + groupTotal;
+    }
+    threadgroup_barrier(mem_flags::mem_threadgroup);
+    total = pSimdTotals[kSimdGroups];
+    const uint result = prefix + pSimdTotals[simdGroup];
+    threadgroup_barrier(mem_flags::mem_threadgroup);
+    return result;
+}
+
+// Same operations as culling::sphereVisible(): fused multiply-adds, so CPU and GPU
+// round identically.
+inline bool sphereVisible( constant RMDLCullParams& params, device const RMDLCullInstance& instance )
+{
+    if (instance.meshIndex >= params.meshCount)
+        return false;
+    const float4 s = float4(instance.boundingSphere[0], instance.boundingSphere[1],
+                            instance.boundingSphere[2], instance.boundingSphere[3]);
+    for (uint p = 0; p < 6; ++p)
+    {
+        const float4 plane = float4(params.frustumPlanes[p][0], params.frustumPlanes[p][1],
+                                    params.frustumPlanes[p][2], params.frustumPlanes[p][3]);
+        const float t = precise::fma(plane.z, s.z, precise::fma(plane.y, s.y, precise::fma(plane.x, s.x, plane.w)));
+        if (!(t >= -s.w))
+            return false;
+    }
+    return true;
+}
+
+kernel void cullInstances( constant RMDLCullParams&         params      [[buffer(CullBufferIndexParams)]],
+                           device const RMDLCullInstance*   pInstances  [[buffer(CullBufferIndexInstances)]],
+                           device uchar*                    pVisibility [[buffer(CullBufferIndexVisibility)]],
+                           device uint*                     pGroups     [[buffer(CullBufferIndexGroups)]],
+                           uint                             tid         [[thread_position_in_grid]],
+                           uint                             group       [[threadgroup_position_in_grid]],
+                           ushort                           lane        [[thread_index_in_simdgroup]],
+                           ushort                           simdGroup   [[simdgroup_index_in_threadgroup]] )
+{
+    threadgroup uint simdTotals[kCullThreadgroupSize / 32 + 1];
+    const uint visible = (tid < params.instanceCount && sphereVisible(params, pInstances[tid])) ? 1 : 0;
+    if (tid < params.instanceCount)
+        pVisibility[tid] = (uchar)visible;
+
+    uint total;
+    threadgroupExclusiveSum<kCullThreadgroupSize>(visible, simdTotals, lane, simdGroup, total);
+    if (tid == group * kCullThreadgroupSize)
+        pGroups[group] = total;
+}
+
+kernel void scanCullGroups( constant RMDLCullParams&    params      [[buffer(CullBufferIndexParams)]],
+                            device uint*                pGroups     [[buffer(CullBufferIndexGroups)]],
+                            device RMDLDrawRange*       pDrawRange  [[buffer(CullBufferIndexDrawRange)]],
+                            ushort                      tid         [[thread_position_in_threadgroup]],
+                            ushort                      lane        [[thread_index_in_simdgroup]],
+                            ushort                      simdGroup   [[simdgroup_index_in_threadgroup]] )
+{
+    // One threadgroup walks the counts in slices, turning them into offsets in place.
+    threadgroup uint simdTotals[kCullScanThreadgroupSize / 32 + 1];
+    uint carry = 0;
+    for (uint first = 0; first < params.groupCount; first += kCullScanThreadgroupSize)
+    {
+        const uint i = first + tid;
+        const uint count = i < params.groupCount ? pGroups[i] : 0;
+        uint total;
+        const uint offset = threadgroupExclusiveSum<kCullScanThreadgroupSize>(count, simdTotals, lane, simdGroup, total);
+        if (i < params.groupCount)
+            pGroups[i] = carry + offset;
+        carry += total;
+    }
+    if (tid == 0)
+    {
+        pDrawRange->location = 0;
+        pDrawRange->length = carry;
+    }
+}
+
+kernel void compactDraws( constant RMDLCullParams&          params      [[buffer(CullBufferIndexParams)]],
+                          device const RMDLCullInstance*    pInstances  [[buffer(CullBufferIndexInstances)]],
+                          device const RMDLCullMesh*        pMeshes     [[buffer(CullBufferIndexMeshes)]],
+                          device const uchar*               pVisibility [[buffer(CullBufferIndexVisibility)]],
+                          device const uint*                pGroups     [[buffer(CullBufferIndexGroups)]],
+                          device RMDLDrawIndexedArguments*  pArguments  [[buffer(CullBufferIndexArguments)]],
+                          uint                              tid         [[thread_position_in_grid]],
+                          uint                              group       [[threadgroup_position_in_grid]],
+                          ushort                            lane        [[thread_index_in_simdgroup]],
+                          ushort                            simdGroup   [[simdgroup_index_in_threadgroup]] )
+{
+    threadgroup uint simdTotals[kCullThreadgroupSize / 32 + 1];
+    const uint visible = tid < params.instanceCount ? (uint)pVisibility[tid] : 0;
+    uint total;
+    const uint rank = threadgroupExclusiveSum<kCullThreadgroupSize>(visible, simdTotals, lane, simdGroup, total);
+    if (!visible)
+        return;
+
+    device const RMDLCullMesh& mesh = pMeshes[pInstances[tid].meshIndex];
+    RMDLDrawIndexedArguments arguments;
+    arguments.indexCount = mesh.indexCount;
+    arguments.instanceCount = 1;
+    arguments.indexStart = mesh.indexStart;
+    arguments.baseVertex = mesh.baseVertex;
+    arguments.baseInstance = tid;
+    pArguments[pGroups[group] + rank] = arguments;
+}
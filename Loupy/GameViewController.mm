@@ -14,51 +14,73 @@
 
 @end
 
+@interface RMDLGameApplicationLoupy ()
+
+- (void)postInputEvent:(const input::InputEvent &)event;
+
+@end
+
+// Virtual key codes (QWERTY positions) to engine buttons.
+static bool buttonForKeyCode(unsigned short keyCode, input::Button* pButton)
+{
+    switch (keyCode)
+    {
+        case 0x0d: *pButton = input::Button::KeyW; return (true);
+        case 0x00: *pButton = input::Button::KeyA; return (true);
+        case 0x01: *pButton = input::Button::KeyS; return (true);
+        case 0x02: *pButton = input::Button::KeyD; return (true);
+        case 0x0c: *pButton = input::Button::KeyQ; return (true);
+        case 0x0e: *pButton = input::Button::KeyE; return (true);
+        case 0x07: *pButton = input::Button::KeyX; return (true);
+        case 0x31: *pButton = input::Button::Space; return (true);
+        case 0x7b: *pButton = input::Button::LeftArrow; return (true);
+        case 0x7c: *pButton = input::Button::RightArrow; return (true);
+        case 0x7e: *pButton = input::Button::UpArrow; return (true);
+        case 0x7d: *pButton = input::Button::DownArrow; return (true);
+        default: return (false);
+    }
+}
+
 @implementation GameWindow
 
-- (void)keyDown:(NSEvent *)event
+// Keys become down/up events stamped with the event's own time; the simulation
+// moves the camera for as long as a key is held, not once per key repeat.
+- (BOOL)postKey:(NSEvent *)event type:(input::EventType)type
 {
-    NSString *chars = [event charactersIgnoringModifiers];
-    if (chars.length == 0) { return; }
-    unichar character = [chars characterAtIndex:0];
-    float moveSpeed = 0.065f;
-    switch (character)
+    input::Button button;
+    if (!buttonForKeyCode(event.keyCode, &button))
+        return (NO);
+    if (!event.isARepeat)
     {
-        case 'w':
-            [self.gameCoordinator moveCameraX : 0 Y : 0 Z : -moveSpeed];
-            break;
-        case 's':
-            [self.gameCoordinator moveCameraX : 0 Y : 0 Z : moveSpeed];
-            break;
-        case 'a':
-            [self.gameCoordinator moveCameraX : -moveSpeed Y : 0 Z : 0];
-            break;
-        case 'd':
-            [self.gameCoordinator moveCameraX : moveSpeed Y : 0 Z : 0];
-            break;
-        case 'q':
-            [self.gameCoordinator moveCameraX : 0 Y : moveSpeed Z : 0];
-            break;
-        case 'e':
-            [self.gameCoordinator moveCameraX : 0 Y : -moveSpeed Z : 0];
-            break;
-        case ' ':
-            [self.gameCoordinator moveCameraX : moveSpeed * moveSpeed Y : 0 Z : 0];
-            break;
-        default:
-            [super keyDown:event];
-            break;
+        input::InputEvent input;
+        input.time = event.timestamp;
+        input.type = type;
+        input.code = (uint8_t)button;
+        [self.gameCoordinator postInputEvent:input];
     }
+    return (YES);
 }
 
-- (void)mouseDragged:(NSEvent *)event
+- (void)keyDown:(NSEvent *)event
 {
-    float sensitivity = 0.009f;
+    if (![self postKey:event type:input::EventType::ButtonDown])
+        [super keyDown:event];
+}
 
-    float deltaX = [event deltaX] * sensitivity;
-    float deltaY = [event deltaY] * sensitivity;
+- (void)keyUp:(NSEvent *)event
+{
+    if (![self postKey:event type:input::EventType::ButtonUp])
+        [super keyUp:event];
+}
 
-    [self.gameCoordinator rotateCameraYaw : deltaX Pitch : deltaY];
+- (void)mouseDragged:(NSEvent *)event
+{
+    input::InputEvent input;
+    input.time = event.timestamp;
+    input.type = input::EventType::MouseDelta;
+    input.value[0] = (float)[event deltaX];
+    input.value[1] = (float)[event deltaY];
+    [self.gameCoordinator postInputEvent:input];
 }
 
 - (void)mouseDown:(NSEvent *)event
@@ -148,12 +170,18 @@
 
 - (void)moveCameraX:(float)x Y:(float)y Z:(float)z
 {
-    //_pGameCoordinator->moveCamera( simd::float3 {x, y, z} );
+    _pGameCoordinator->moveCamera( simd::float3 {x, y, z} );
 }
 
 - (void)rotateCameraYaw:(float)yaw Pitch:(float)pitch
 {
-    //_pGameCoordinator->rotateCamera(yaw, pitch);
+    _pGameCoordinator->rotateCamera(yaw, pitch);
+}
+
+- (void)postInputEvent:(const input::InputEvent &)event
+{
+    if (_pGameCoordinator)
+        _pGameCoordinator->inputQueue().post(event);
 }
 
 - (void)drawInMTKView:(nonnull MTKView *)view
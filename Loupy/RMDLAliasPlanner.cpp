@@ -0,0 +1,192 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLAliasPlanner.cpp         +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 21:34:47      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLAliasPlanner.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace alias_planner
+{
+
+static uint64_t alignUp( uint64_t value, uint64_t alignment )
+{
+    if (alignment <= 1)
+        return (value);
+    return ((value + alignment - 1) & ~(alignment - 1));
+}
+
+static bool overlapInTime( const Allocation& a, const Allocation& b )
+{
+    return (a.first <= b.last && b.first <= a.last);
+}
+
+struct Range
+{
+    uint64_t    begin;
+    uint64_t    end;
+};
+
+static void planBestFit( const std::vector<Allocation>& allocations, Plan& out )
+{
+    // Big, long-lived allocations first: they are the hardest to fit later.
+    std::vector<uint32_t> order(allocations.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [&allocations]( uint32_t a, uint32_t b ) {
+        const Allocation& x = allocations[a];
+        const Allocation& y = allocations[b];
+        if (x.size != y.size)
+            return (x.size > y.size);
+        if (x.last - x.first != y.last - y.first)
+            return (x.last - x.first > y.last - y.first);
+        return (a < b);
+    });
+
+    std::vector<uint32_t> placed;
+    std::vector<Range> live;
+    placed.reserve(allocations.size());
+    for (uint32_t i : order)
+    {
+        const Allocation& alloc = allocations[i];
+        live.clear();
+        for (uint32_t j : placed)
+        {
+            if (overlapInTime(alloc, allocations[j]))
+                live.push_back({ out.offsets[j], out.offsets[j] + allocations[j].size });
+        }
+        std::sort(live.begin(), live.end(), []( const Range& a, const Range& b ) { return (a.begin < b.begin); });
+
+        // Tightest gap between live neighbours that holds the aligned allocation, else the top.
+        uint64_t cursor = 0;
+        uint64_t bestOffset = 0;
+        uint64_t bestGap = ~0ull;
+        for (const Range& range : live)
+        {
+            const uint64_t offset = alignUp(cursor, alloc.alignment);
+            if (range.begin > cursor && offset + alloc.size <= range.begin && range.begin - cursor < bestGap)
+            {
+                bestGap = range.begin - cursor;
+                bestOffset = offset;
+            }
+            cursor = std::max(cursor, range.end);
+        }
+        if (bestGap == ~0ull)
+            bestOffset = alignUp(cursor, alloc.alignment);
+
+        out.offsets[i] = bestOffset;
+        out.heapSize = std::max(out.heapSize, bestOffset + alloc.size);
+        placed.push_back(i);
+    }
+}
+
+static void planIntervalColoring( const std::vector<Allocation>& allocations, Plan& out )
+{
+    std::vector<uint32_t> order(allocations.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [&allocations]( uint32_t a, uint32_t b ) {
+        return (allocations[a].first != allocations[b].first ? allocations[a].first < allocations[b].first : a < b);
+    });
+
+    // A block keeps its offset and size forever; an allocation takes the smallest
+    // block that is free, large enough and suitably aligned, or opens a new one.
+    struct Block { uint64_t offset; uint64_t size; uint32_t busyUntil; bool used; };
+    std::vector<Block> blocks;
+    for (uint32_t i : order)
+    {
+        const Allocation& alloc = allocations[i];
+        int best = -1;
+        for (int b = 0; b < (int)blocks.size(); ++b)
+        {
+            const Block& block = blocks[b];
+            if (block.used && block.busyUntil >= alloc.first)
+                continue;
+            if (block.size < alloc.size || alignUp(block.offset, alloc.alignment) != block.offset)
+                continue;
+            if (best < 0 || block.size < blocks[best].size)
+                best = b;
+        }
+        if (best < 0)
+        {
+            best = (int)blocks.size();
+            blocks.push_back({ alignUp(out.heapSize, alloc.alignment), alloc.size, 0, false });
+            out.heapSize = blocks.back().offset + alloc.size;
+        }
+        blocks[best].busyUntil = alloc.last;
+        blocks[best].used = true;
+        out.offsets[i] = blocks[best].offset;
+    }
+}
+
+Plan plan( const std::vector<Allocation>& allocations, Strategy strategy )
+{
+    Plan out;
+    out.offsets.assign(allocations.size(), 0);
+
+    uint32_t lastPass = 0;
+    std::vector<uint64_t> stacked(allocations.size());
+    for (size_t i = 0; i < allocations.size(); ++i)
+    {
+        stacked[i] = alignUp(out.unaliasedSize, allocations[i].alignment);
+        out.unaliasedSize = stacked[i] + allocations[i].size;
+        lastPass = std::max(lastPass, allocations[i].last);
+    }
+
+    // Sweep: bytes alive per pass.
+    if (!allocations.empty())
+    {
+        std::vector<int64_t> delta((size_t)lastPass + 2, 0);
+        for (const Allocation& alloc : allocations)
+        {
+            delta[alloc.first] += (int64_t)alloc.size;
+            delta[(size_t)alloc.last + 1] -= (int64_t)alloc.size;
+        }
+        int64_t alive = 0;
+        for (int64_t d : delta)
+        {
+            alive += d;
+            out.peakLiveSize = std::max(out.peakLiveSize, (uint64_t)alive);
+        }
+    }
+
+    if (strategy == Strategy::BestFit)
+        planBestFit(allocations, out);
+    else
+        planIntervalColoring(allocations, out);
+
+    // Alignment padding can fragment a graph where everything is alive at once past
+    // the plain stacking; never do worse than not aliasing.
+    if (out.heapSize > out.unaliasedSize)
+    {
+        out.offsets = std::move(stacked);
+        out.heapSize = out.unaliasedSize;
+    }
+    return (out);
+}
+
+bool validate( const std::vector<Allocation>& allocations, const Plan& plan )
+{
+    if (plan.offsets.size() != allocations.size())
+        return (false);
+    for (size_t i = 0; i < allocations.size(); ++i)
+    {
+        const Allocation& a = allocations[i];
+        if (alignUp(plan.offsets[i], a.alignment) != plan.offsets[i] || plan.offsets[i] + a.size > plan.heapSize)
+            return (false);
+        for (size_t j = i + 1; j < allocations.size(); ++j)
+        {
+            const Allocation& b = allocations[j];
+            if (overlapInTime(a, b) && plan.offsets[i] < plan.offsets[j] + b.size && plan.offsets[j] < plan.offsets[i] + a.size)
+                return (false);
+        }
+    }
+    return (true);
+}
+
+}
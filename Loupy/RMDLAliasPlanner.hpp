@@ -0,0 +1,52 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLAliasPlanner.hpp         +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 21:34:40      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLALIASPLANNER_HPP
+# define RMDLALIASPLANNER_HPP
+
+# include <cstdint>
+# include <vector>
+
+// Places transient allocations in one heap so that allocations which are never
+// alive at the same time share bytes. Lifetimes are inclusive pass intervals,
+// sizes and alignments come from the API (heapTextureSizeAndAlign). Pure CPU.
+
+namespace alias_planner
+{
+    struct Allocation
+    {
+        uint32_t    first;          // first pass using it
+        uint32_t    last;           // last pass using it, inclusive
+        uint64_t    size;
+        uint64_t    alignment;      // power of two, 0 or 1 for none
+    };
+
+    enum class Strategy : uint32_t
+    {
+        BestFit,            // largest first, into the tightest free gap among live neighbours
+        IntervalColoring    // in start order, reusing whole freed blocks; cheaper, looser
+    };
+
+    struct Plan
+    {
+        std::vector<uint64_t>   offsets;            // per allocation
+        uint64_t                heapSize        = 0;
+        uint64_t                unaliasedSize   = 0;    // one aligned allocation each
+        uint64_t                peakLiveSize    = 0;    // most bytes alive in one pass: no plan goes below
+
+        uint64_t                saved() const       { return (unaliasedSize - heapSize); }
+    };
+
+    Plan        plan( const std::vector<Allocation>& allocations, Strategy strategy = Strategy::BestFit );
+    /// True if every offset is aligned and no two allocations alive in the same pass overlap.
+    bool        validate( const std::vector<Allocation>& allocations, const Plan& plan );
+}
+
+#endif /* RMDLALIASPLANNER_HPP */
@@ -0,0 +1,372 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLBatchMath.cpp            +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 03:21:52      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLBatchMath.hpp"
+
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+#if defined(__aarch64__)
+# include <arm_neon.h>
+#elif defined(__x86_64__) || defined(__i386__)
+# include <immintrin.h>
+# define RMDL_BATCH_X86 1
+#endif
+
+// The x86 kernels are compiled for instruction sets the rest of the program may
+// not assume; each one only runs once the CPU has been seen to support it.
+#if defined(__clang__)
+# define RMDL_BATCH_TARGET_BEGIN_SSE4       _Pragma("clang attribute push (__attribute__((target(\"sse4.1\"))), apply_to = function)")
+# define RMDL_BATCH_TARGET_BEGIN_AVX2       _Pragma("clang attribute push (__attribute__((target(\"avx2,fma\"))), apply_to = function)")
+# define RMDL_BATCH_TARGET_BEGIN_AVX512     _Pragma("clang attribute push (__attribute__((target(\"avx512f,avx2,fma\"))), apply_to = function)")
+# define RMDL_BATCH_TARGET_END              _Pragma("clang attribute pop")
+#else
+# define RMDL_BATCH_TARGET_BEGIN_SSE4       _Pragma("GCC push_options") _Pragma("GCC target(\"sse4.1\")")
+# define RMDL_BATCH_TARGET_BEGIN_AVX2       _Pragma("GCC push_options") _Pragma("GCC target(\"avx2,fma\")")
+# define RMDL_BATCH_TARGET_BEGIN_AVX512     _Pragma("GCC push_options") _Pragma("GCC target(\"avx512f,avx2,fma\")")
+# define RMDL_BATCH_TARGET_END              _Pragma("GCC pop_options")
+#endif
+
+namespace batch_math
+{
+
+namespace
+{
+    struct Kernels
+    {
+        Isa     isa;
+        void    (*composeTransforms)( Vec3Streams, QuatStreams, Vec3Streams, float*, size_t );
+        void    (*multiplyMatrices)( const float*, const float*, float*, size_t );
+        void    (*slerp)( QuatStreams, QuatStreams, const float*, QuatOutStreams, size_t );
+        void    (*nlerp)( QuatStreams, QuatStreams, const float*, QuatOutStreams, size_t );
+        void    (*rotateVectors)( QuatStreams, Vec3Streams, Vec3OutStreams, size_t );
+    };
+
+#pragma mark - Scalar
+
+    namespace scalar
+    {
+        constexpr Isa kIsa = Isa::Scalar;
+
+        struct Lanes
+        {
+            static constexpr size_t kWidth = 4;
+            float v[4];
+
+            static Lanes    load( const float* p )      { return { { p[0], p[1], p[2], p[3] } }; }
+            static Lanes    splat( float s )            { return { { s, s, s, s } }; }
+            void            store( float* p ) const     { for (int i = 0; i < 4; ++i) p[i] = v[i]; }
+            Lanes           operator+( Lanes o ) const  { Lanes r; for (int i = 0; i < 4; ++i) r.v[i] = v[i] + o.v[i]; return (r); }
+            Lanes           operator-( Lanes o ) const  { Lanes r; for (int i = 0; i < 4; ++i) r.v[i] = v[i] - o.v[i]; return (r); }
+            Lanes           operator*( Lanes o ) const  { Lanes r; for (int i = 0; i < 4; ++i) r.v[i] = v[i] * o.v[i]; return (r); }
+            Lanes           operator/( Lanes o ) const  { Lanes r; for (int i = 0; i < 4; ++i) r.v[i] = v[i] / o.v[i]; return (r); }
+            Lanes           operator-() const           { return { { -v[0], -v[1], -v[2], -v[3] } }; }
+        };
+
+        struct Mask
+        {
+            bool m[4];
+        };
+
+        inline Lanes    fmadd( Lanes a, Lanes b, Lanes c )  { return (a * b + c); }
+        inline Lanes    sqrt( Lanes a )                     { Lanes r; for (int i = 0; i < 4; ++i) r.v[i] = std::sqrt(a.v[i]); return (r); }
+        inline Lanes    abs( Lanes a )                      { Lanes r; for (int i = 0; i < 4; ++i) r.v[i] = std::fabs(a.v[i]); return (r); }
+        inline Lanes    min( Lanes a, Lanes b )             { Lanes r; for (int i = 0; i < 4; ++i) r.v[i] = a.v[i] < b.v[i] ? a.v[i] : b.v[i]; return (r); }
+        inline Lanes    max( Lanes a, Lanes b )             { Lanes r; for (int i = 0; i < 4; ++i) r.v[i] = a.v[i] > b.v[i] ? a.v[i] : b.v[i]; return (r); }
+        inline Lanes    roundNearest( Lanes a )             { Lanes r; for (int i = 0; i < 4; ++i) r.v[i] = std::nearbyint(a.v[i]); return (r); }
+        inline Mask     lessThan( Lanes a, Lanes b )        { Mask m; for (int i = 0; i < 4; ++i) m.m[i] = a.v[i] < b.v[i]; return (m); }
+        inline Lanes    select( Mask m, Lanes a, Lanes b )  { Lanes r; for (int i = 0; i < 4; ++i) r.v[i] = m.m[i] ? a.v[i] : b.v[i]; return (r); }
+        inline Lanes    loadColumnRepeated( const float* p ) { return (Lanes::load(p)); }
+        template< int K >
+        inline Lanes    splatInColumns( Lanes a )           { return (Lanes::splat(a.v[K])); }
+
+# include "RMDLBatchMathKernels.hpp"
+    }
+
+#if defined(__aarch64__)
+
+#pragma mark - NEON
+
+    namespace neon
+    {
+        constexpr Isa kIsa = Isa::Neon;
+
+        struct Lanes
+        {
+            static constexpr size_t kWidth = 4;
+            float32x4_t v;
+
+            static Lanes    load( const float* p )      { return { vld1q_f32(p) }; }
+            static Lanes    splat( float s )            { return { vdupq_n_f32(s) }; }
+            void            store( float* p ) const     { vst1q_f32(p, v); }
+            Lanes           operator+( Lanes o ) const  { return { vaddq_f32(v, o.v) }; }
+            Lanes           operator-( Lanes o ) const  { return { vsubq_f32(v, o.v) }; }
+            Lanes           operator*( Lanes o ) const  { return { vmulq_f32(v, o.v) }; }
+            Lanes           operator/( Lanes o ) const  { return { vdivq_f32(v, o.v) }; }
+            Lanes           operator-() const           { return { vnegq_f32(v) }; }
+        };
+
+        using Mask = uint32x4_t;
+
+        inline Lanes    fmadd( Lanes a, Lanes b, Lanes c )  { return { vfmaq_f32(c.v, a.v, b.v) }; }
+        inline Lanes    sqrt( Lanes a )                     { return { vsqrtq_f32(a.v) }; }
+        inline Lanes    abs( Lanes a )                      { return { vabsq_f32(a.v) }; }
+        inline Lanes    min( Lanes a, Lanes b )             { return { vminq_f32(a.v, b.v) }; }
+        inline Lanes    max( Lanes a, Lanes b )             { return { vmaxq_f32(a.v, b.v) }; }
+        inline Lanes    roundNearest( Lanes a )             { return { vrndnq_f32(a.v) }; }
+        inline Mask     lessThan( Lanes a, Lanes b )        { return (vcltq_f32(a.v, b.v)); }
+        inline Lanes    select( Mask m, Lanes a, Lanes b )  { return { vbslq_f32(m, a.v, b.v) }; }
+        inline Lanes    loadColumnRepeated( const float* p ) { return (Lanes::load(p)); }
+        template< int K >
+        inline Lanes    splatInColumns( Lanes a )           { return { vdupq_laneq_f32(a.v, K) }; }
+
+# include "RMDLBatchMathKernels.hpp"
+    }
+
+#elif defined(RMDL_BATCH_X86)
+
+#pragma mark - SSE4.1
+
+RMDL_BATCH_TARGET_BEGIN_SSE4
+    namespace sse4
+    {
+        constexpr Isa kIsa = Isa::Sse4;
+
+        struct Lanes
+        {
+            static constexpr size_t kWidth = 4;
+            __m128 v;
+
+            static Lanes    load( const float* p )      { return { _mm_loadu_ps(p) }; }
+            static Lanes    splat( float s )            { return { _mm_set1_ps(s) }; }
+            void            store( float* p ) const     { _mm_storeu_ps(p, v); }
+            Lanes           operator+( Lanes o ) const  { return { _mm_add_ps(v, o.v) }; }
+            Lanes           operator-( Lanes o ) const  { return { _mm_sub_ps(v, o.v) }; }
+            Lanes           operator*( Lanes o ) const  { return { _mm_mul_ps(v, o.v) }; }
+            Lanes           operator/( Lanes o ) const  { return { _mm_div_ps(v, o.v) }; }
+            Lanes           operator-() const           { return { _mm_xor_ps(v, _mm_set1_ps(-0.f)) }; }
+        };
+
+        using Mask = __m128;
+
+        inline Lanes    fmadd( Lanes a, Lanes b, Lanes c )  { return { _mm_add_ps(_mm_mul_ps(a.v, b.v), c.v) }; }
+        inline Lanes    sqrt( Lanes a )                     { return { _mm_sqrt_ps(a.v) }; }
+        inline Lanes    abs( Lanes a )                      { return { _mm_andnot_ps(_mm_set1_ps(-0.f), a.v) }; }
+        inline Lanes    min( Lanes a, Lanes b )             { return { _mm_min_ps(a.v, b.v) }; }
+        inline Lanes    max( Lanes a, Lanes b )             { return { _mm_max_ps(a.v, b.v) }; }
+        inline Lanes    roundNearest( Lanes a )             { return { _mm_round_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC) }; }
+        inline Mask     lessThan( Lanes a, Lanes b )        { return (_mm_cmplt_ps(a.v, b.v)); }
+        inline Lanes    select( Mask m, Lanes a, Lanes b )  { return { _mm_blendv_ps(b.v, a.v, m) }; }
+        inline Lanes    loadColumnRepeated( const float* p ) { return (Lanes::load(p)); }
+        template< int K >
+        inline Lanes    splatInColumns( Lanes a )           { return { _mm_shuffle_ps(a.v, a.v, K * 0x55) }; }
+
+# include "RMDLBatchMathKernels.hpp"
+    }
+RMDL_BATCH_TARGET_END
+
+#pragma mark - AVX2
+
+RMDL_BATCH_TARGET_BEGIN_AVX2
+    namespace avx2
+    {
+        constexpr Isa kIsa = Isa::Avx2;
+
+        struct Lanes
+        {
+            static constexpr size_t kWidth = 8;
+            __m256 v;
+
+            static Lanes    load( const float* p )      { return { _mm256_loadu_ps(p) }; }
+            static Lanes    splat( float s )            { return { _mm256_set1_ps(s) }; }
+            void            store( float* p ) const     { _mm256_storeu_ps(p, v); }
+            Lanes           operator+( Lanes o ) const  { return { _mm256_add_ps(v, o.v) }; }
+            Lanes           operator-( Lanes o ) const  { return { _mm256_sub_ps(v, o.v) }; }
+            Lanes           operator*( Lanes o ) const  { return { _mm256_mul_ps(v, o.v) }; }
+            Lanes           operator/( Lanes o ) const  { return { _mm256_div_ps(v, o.v) }; }
+            Lanes           operator-() const           { return { _mm256_xor_ps(v, _mm256_set1_ps(-0.f)) }; }
+        };
+
+        using Mask = __m256;
+
+        inline Lanes    fmadd( Lanes a, Lanes b, Lanes c )  { return { _mm256_fmadd_ps(a.v, b.v, c.v) }; }
+        inline Lanes    sqrt( Lanes a )                     { return { _mm256_sqrt_ps(a.v) }; }
+        inline Lanes    abs( Lanes a )                      { return { _mm256_andnot_ps(_mm256_set1_ps(-0.f), a.v) }; }
+        inline Lanes    min( Lanes a, Lanes b )             { return { _mm256_min_ps(a.v, b.v) }; }
+        inline Lanes    max( Lanes a, Lanes b )             { return { _mm256_max_ps(a.v, b.v) }; }
+        inline Lanes    roundNearest( Lanes a )             { return { _mm256_round_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC) }; }
+        inline Mask     lessThan( Lanes a, Lanes b )        { return (_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)); }
+        inline Lanes    select( Mask m, Lanes a, Lanes b )  { return { _mm256_blendv_ps(b.v, a.v, m) }; }
+        inline Lanes    loadColumnRepeated( const float* p ) { return { _mm256_broadcast_ps((const __m128*)p) }; }
+        template< int K >
+        inline Lanes    splatInColumns( Lanes a )           { return { _mm256_permute_ps(a.v, K * 0x55) }; }
+
+# include "RMDLBatchMathKernels.hpp"
+    }
+RMDL_BATCH_TARGET_END
+
+#pragma mark - AVX-512
+
+RMDL_BATCH_TARGET_BEGIN_AVX512
+    namespace avx512
+    {
+        constexpr Isa kIsa = Isa::Avx512;
+
+        struct Lanes
+        {
+            static constexpr size_t kWidth = 16;
+            __m512 v;
+
+            static Lanes    load( const float* p )      { return { _mm512_loadu_ps(p) }; }
+            static Lanes    splat( float s )            { return { _mm512_set1_ps(s) }; }
+            void            store( float* p ) const     { _mm512_storeu_ps(p, v); }
+            Lanes           operator+( Lanes o ) const  { return { _mm512_add_ps(v, o.v) }; }
+            Lanes           operator-( Lanes o ) const  { return { _mm512_sub_ps(v, o.v) }; }
+            Lanes           operator*( Lanes o ) const  { return { _mm512_mul_ps(v, o.v) }; }
+            Lanes           operator/( Lanes o ) const  { return { _mm512_div_ps(v, o.v) }; }
+            Lanes           operator-() const           { return { _mm512_sub_ps(_mm512_setzero_ps(), v) }; }
+        };
+
+        using Mask = __mmask16;
+
+        // The unmasked forms of some intrinsics pass _mm512_undefined_ps() on to
+        // the masked builtin, which GCC reports as maybe uninitialized; the
+        // zero-masked forms with every lane set compile to the same instructions.
+        constexpr Mask kAllLanes = 0xffff;
+
+        inline Lanes    fmadd( Lanes a, Lanes b, Lanes c )  { return { _mm512_fmadd_ps(a.v, b.v, c.v) }; }
+        inline Lanes    sqrt( Lanes a )                     { return { _mm512_maskz_sqrt_ps(kAllLanes, a.v) }; }
+        inline Lanes    abs( Lanes a )                      { return { _mm512_abs_ps(a.v) }; }
+        inline Lanes    min( Lanes a, Lanes b )             { return { _mm512_min_ps(a.v, b.v) }; }
+        inline Lanes    max( Lanes a, Lanes b )             { return { _mm512_maskz_max_ps(kAllLanes, a.v, b.v) }; }
+        inline Lanes    roundNearest( Lanes a )             { return { _mm512_maskz_roundscale_ps(kAllLanes, a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC) }; }
+        inline Mask     lessThan( Lanes a, Lanes b )        { return (_mm512_cmp_ps_mask(a.v, b.v, _CMP_LT_OQ)); }
+        inline Lanes    select( Mask m, Lanes a, Lanes b )  { return { _mm512_mask_blend_ps(m, b.v, a.v) }; }
+        inline Lanes    loadColumnRepeated( const float* p ) { return { _mm512_maskz_broadcast_f32x4(kAllLanes, _mm_loadu_ps(p)) }; }
+        template< int K >
+        inline Lanes    splatInColumns( Lanes a )           { return { _mm512_maskz_permute_ps(kAllLanes, a.v, K * 0x55) }; }
+
+# include "RMDLBatchMathKernels.hpp"
+    }
+RMDL_BATCH_TARGET_END
+
+#endif
+
+#pragma mark - Dispatch
+
+    const Kernels* kernelsFor( Isa isa )
+    {
+        switch (isa)
+        {
+#if defined(__aarch64__)
+            case Isa::Neon:     return (&neon::kKernels);
+#elif defined(RMDL_BATCH_X86)
+            case Isa::Sse4:     return (__builtin_cpu_supports("sse4.1") ? &sse4::kKernels : nullptr);
+            case Isa::Avx2:     return (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") ? &avx2::kKernels : nullptr);
+            case Isa::Avx512:   return (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") ? &avx512::kKernels : nullptr);
+#endif
+            case Isa::Scalar:   return (&scalar::kKernels);
+            default:            return (nullptr);
+        }
+    }
+
+    const Kernels* bestKernels()
+    {
+        for (Isa isa : { Isa::Avx512, Isa::Avx2, Isa::Sse4, Isa::Neon })
+        {
+            if (const Kernels* pKernels = kernelsFor(isa))
+                return (pKernels);
+        }
+        return (&scalar::kKernels);
+    }
+
+    std::atomic<const Kernels*>& activeKernels()
+    {
+        static std::atomic<const Kernels*> active( bestKernels() );
+        return (active);
+    }
+
+    const Kernels& kernels()
+    {
+        return (*activeKernels().load(std::memory_order_relaxed));
+    }
+}
+
+Isa activeIsa()
+{
+    return (kernels().isa);
+}
+
+bool isaSupported( Isa isa )
+{
+    return (kernelsFor(isa) != nullptr);
+}
+
+bool forceIsa( Isa isa )
+{
+    const Kernels* pKernels = kernelsFor(isa);
+    if (!pKernels)
+        return (false);
+    activeKernels().store(pKernels, std::memory_order_relaxed);
+    return (true);
+}
+
+const char* isaName( Isa isa )
+{
+    switch (isa)
+    {
+        case Isa::Scalar:   return ("scalar");
+        case Isa::Neon:     return ("NEON");
+        case Isa::Sse4:     return ("SSE4.1");
+        case Isa::Avx2:     return ("AVX2");
+        case Isa::Avx512:   return ("AVX-512");
+    }
+    return ("unknown");
+}
+
+uint32_t laneCount( Isa isa )
+{
+    switch (isa)
+    {
+        case Isa::Avx512:   return (16);
+        case Isa::Avx2:     return (8);
+        default:            return (4);
+    }
+}
+
+#pragma mark - Entry points
+
+void composeTransforms( Vec3Streams translation, QuatStreams rotation, Vec3Streams scale, float* pMatrices, size_t count )
+{
+    kernels().composeTransforms(translation, rotation, scale, pMatrices, count);
+}
+
+void multiplyMatrices( const float* pA, const float* pB, float* pOut, size_t count )
+{
+    kernels().multiplyMatrices(pA, pB, pOut, count);
+}
+
+void slerp( QuatStreams q0, QuatStreams q1, const float* t, QuatOutStreams out, size_t count )
+{
+    kernels().slerp(q0, q1, t, out, count);
+}
+
+void nlerp( QuatStreams q0, QuatStreams q1, const float* t, QuatOutStreams out, size_t count )
+{
+    kernels().nlerp(q0, q1, t, out, count);
+}
+
+void rotateVectors( QuatStreams rotation, Vec3Streams v, Vec3OutStreams out, size_t count )
+{
+    kernels().rotateVectors(rotation, v, out, count);
+}
+
+}
@@ -0,0 +1,93 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLBatchMath.hpp            +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 03:21:44      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLBATCHMATH_HPP
+# define RMDLBATCHMATH_HPP
+
+# include <cstddef>
+# include <cstdint>
+
+// The transform functions of RMDLMathUtils over whole arrays: one call per
+// component stream (structure of arrays) instead of one per value, 4, 8 or 16
+// elements per instruction. The widest instruction set the CPU has is picked
+// at first use: NEON on arm64, AVX-512, AVX2 or SSE4.1 on x86, plain C++
+// otherwise. Results match the scalar functions to rounding; fused
+// multiply-adds are used where the instruction set has them.
+
+namespace batch_math
+{
+    struct Vec3Streams
+    {
+        const float*    x;
+        const float*    y;
+        const float*    z;
+    };
+
+    struct Vec3OutStreams
+    {
+        float*          x;
+        float*          y;
+        float*          z;
+    };
+
+    struct QuatStreams
+    {
+        const float*    x;
+        const float*    y;
+        const float*    z;
+        const float*    w;
+    };
+
+    struct QuatOutStreams
+    {
+        float*          x;
+        float*          y;
+        float*          z;
+        float*          w;
+    };
+
+    enum class Isa : uint8_t
+    {
+        Scalar,
+        Neon,
+        Sse4,
+        Avx2,
+        Avx512
+    };
+
+    /// The instruction set the functions below run on.
+    Isa             activeIsa();
+    bool            isaSupported( Isa isa );
+    /// For tests and benchmarks; false, and nothing changes, if the CPU lacks it.
+    bool            forceIsa( Isa isa );
+    const char*     isaName( Isa isa );
+    /// Elements per instruction.
+    uint32_t        laneCount( Isa isa );
+
+    /// T * R * S per element, written as column-major 4x4 matrices (the layout of
+    /// simd::float4x4, 16 floats each). Rotations are unit quaternions, as in
+    /// matrix4x4_from_quaternion.
+    void            composeTransforms( Vec3Streams translation, QuatStreams rotation, Vec3Streams scale,
+                                       float* pMatrices, size_t count );
+
+    /// pOut[i] = pA[i] * pB[i], column-major 4x4 each. pOut may alias either input.
+    void            multiplyMatrices( const float* pA, const float* pB, float* pOut, size_t count );
+
+    /// quaternion_slerp per element, with t[i] in [0, 1]. Like it, neither
+    /// function flips q1 onto q0's hemisphere.
+    void            slerp( QuatStreams q0, QuatStreams q1, const float* t, QuatOutStreams out, size_t count );
+    /// Normalized linear blend: cheaper than slerp, exact at the ends.
+    void            nlerp( QuatStreams q0, QuatStreams q1, const float* t, QuatOutStreams out, size_t count );
+
+    /// quaternion_rotate_vector per element.
+    void            rotateVectors( QuatStreams rotation, Vec3Streams v, Vec3OutStreams out, size_t count );
+}
+
+#endif /* RMDLBATCHMATH_HPP */
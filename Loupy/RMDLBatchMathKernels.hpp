@@ -0,0 +1,225 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLBatchMathKernels.hpp     +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 03:22:10      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+// No include guard: RMDLBatchMath.cpp includes this once per instruction set,
+// inside that set's namespace, after its Lanes type. Lanes is kWidth floats with
+// load/store/splat, + - * / and unary -, plus these free functions:
+// fmadd(a, b, c) = a * b + c, sqrt, abs, min, max, roundNearest, lessThan giving
+// a Mask, select(mask, a, b), loadColumnRepeated(p) (the 4 floats at p in every
+// group of 4 lanes) and splatInColumns<k>(v) (lane k of every group of 4).
+
+static constexpr size_t kWidth = Lanes::kWidth;
+
+static inline Lanes loadLanes( const float* p, size_t n, float fill )
+{
+    if (n == kWidth)
+        return (Lanes::load(p));
+    alignas(64) float staged[kWidth];
+    for (size_t i = 0; i < kWidth; ++i)
+        staged[i] = i < n ? p[i] : fill;
+    return (Lanes::load(staged));
+}
+
+static inline void storeLanes( float* p, Lanes v, size_t n )
+{
+    if (n == kWidth)
+    {
+        v.store(p);
+        return;
+    }
+    alignas(64) float staged[kWidth];
+    v.store(staged);
+    for (size_t i = 0; i < n; ++i)
+        p[i] = staged[i];
+}
+
+/// One lane per matrix, one Lanes per element: scattered into column-major order.
+static inline void storeMatrices( float* pMatrices, const Lanes (&elements)[16], size_t n )
+{
+    alignas(64) float staged[kWidth][16];
+    for (int e = 0; e < 16; ++e)
+    {
+        alignas(64) float lanes[kWidth];
+        elements[e].store(lanes);
+        for (size_t i = 0; i < kWidth; ++i)
+            staged[i][e] = lanes[i];
+    }
+    if (n == kWidth)
+        std::memcpy(pMatrices, staged, sizeof(staged));
+    else
+        std::memcpy(pMatrices, staged, n * sizeof(staged[0]));
+}
+
+/// Accurate to a few ulp over several turns; slerp only needs [0, pi].
+static inline Lanes sinLanes( Lanes x )
+{
+    const Lanes turns = roundNearest(x * Lanes::splat(0.159154943f));
+    x = fmadd(turns, Lanes::splat(-6.28125f), x);
+    x = fmadd(turns, Lanes::splat(-1.93530717e-3f), x);
+    const Lanes halfPi = Lanes::splat(1.57079633f);
+    const Lanes pi = Lanes::splat(3.14159265f);
+    x = select(lessThan(halfPi, x), pi - x, x);
+    x = select(lessThan(x, -halfPi), -pi - x, x);
+    const Lanes x2 = x * x;
+    Lanes p = Lanes::splat(-2.50521084e-8f);
+    p = fmadd(p, x2, Lanes::splat(2.75573192e-6f));
+    p = fmadd(p, x2, Lanes::splat(-1.98412698e-4f));
+    p = fmadd(p, x2, Lanes::splat(8.33333333e-3f));
+    p = fmadd(p, x2, Lanes::splat(-1.66666667e-1f));
+    return (fmadd(p * x2, x, x));
+}
+
+/// Abramowitz and Stegun 4.4.46, within 2e-8 of acos over [-1, 1].
+static inline Lanes acosLanes( Lanes c )
+{
+    const Lanes a = abs(c);
+    Lanes p = Lanes::splat(-0.0012624911f);
+    p = fmadd(p, a, Lanes::splat(0.0066700901f));
+    p = fmadd(p, a, Lanes::splat(-0.0170881256f));
+    p = fmadd(p, a, Lanes::splat(0.0308918810f));
+    p = fmadd(p, a, Lanes::splat(-0.0501743046f));
+    p = fmadd(p, a, Lanes::splat(0.0889789874f));
+    p = fmadd(p, a, Lanes::splat(-0.2145988016f));
+    p = fmadd(p, a, Lanes::splat(1.5707963050f));
+    const Lanes r = sqrt(max(Lanes::splat(1.f) - a, Lanes::splat(0.f))) * p;
+    return (select(lessThan(c, Lanes::splat(0.f)), Lanes::splat(3.14159265f) - r, r));
+}
+
+static void composeTransforms( Vec3Streams t, QuatStreams r, Vec3Streams s, float* pMatrices, size_t count )
+{
+    for (size_t i = 0; i < count; i += kWidth)
+    {
+        const size_t n = count - i < kWidth ? count - i : kWidth;
+        const Lanes x = loadLanes(r.x + i, n, 0.f), y = loadLanes(r.y + i, n, 0.f);
+        const Lanes z = loadLanes(r.z + i, n, 0.f), w = loadLanes(r.w + i, n, 1.f);
+        const Lanes sx = loadLanes(s.x + i, n, 1.f), sy = loadLanes(s.y + i, n, 1.f), sz = loadLanes(s.z + i, n, 1.f);
+        const Lanes one = Lanes::splat(1.f), two = Lanes::splat(2.f), zero = Lanes::splat(0.f);
+
+        const Lanes xx = x * x, xy = x * y, xz = x * z, xw = x * w;
+        const Lanes yy = y * y, yz = y * z, yw = y * w;
+        const Lanes zz = z * z, zw = z * w;
+
+        // matrix4x4_from_quaternion, each rotation column scaled by its factor.
+        const Lanes elements[16] = {
+            (one - two * (yy + zz)) * sx,   two * (xy + zw) * sx,           two * (xz - yw) * sx,           zero,
+            two * (xy - zw) * sy,           (one - two * (xx + zz)) * sy,   two * (yz + xw) * sy,           zero,
+            two * (xz + yw) * sz,           two * (yz - xw) * sz,           (one - two * (xx + yy)) * sz,   zero,
+            loadLanes(t.x + i, n, 0.f),     loadLanes(t.y + i, n, 0.f),     loadLanes(t.z + i, n, 0.f),     one
+        };
+        storeMatrices(pMatrices + i * 16, elements, n);
+    }
+}
+
+static void multiplyMatrices( const float* pA, const float* pB, float* pOut, size_t count )
+{
+    // Within one matrix: kWidth / 4 output columns per step, each the columns of A
+    // weighted by one column of B.
+    constexpr size_t kChunks = 16 / kWidth;
+    for (size_t m = 0; m < count; ++m)
+    {
+        const float* a = pA + m * 16;
+        const float* b = pB + m * 16;
+        const Lanes a0 = loadColumnRepeated(a), a1 = loadColumnRepeated(a + 4);
+        const Lanes a2 = loadColumnRepeated(a + 8), a3 = loadColumnRepeated(a + 12);
+        Lanes bColumns[kChunks];
+        for (size_t c = 0; c < kChunks; ++c)
+            bColumns[c] = Lanes::load(b + c * kWidth);
+        for (size_t c = 0; c < kChunks; ++c)
+        {
+            Lanes out = a0 * splatInColumns<0>(bColumns[c]);
+            out = fmadd(a1, splatInColumns<1>(bColumns[c]), out);
+            out = fmadd(a2, splatInColumns<2>(bColumns[c]), out);
+            out = fmadd(a3, splatInColumns<3>(bColumns[c]), out);
+            out.store(pOut + m * 16 + c * kWidth);
+        }
+    }
+}
+
+static void slerp( QuatStreams q0, QuatStreams q1, const float* t, QuatOutStreams out, size_t count )
+{
+    for (size_t i = 0; i < count; i += kWidth)
+    {
+        const size_t n = count - i < kWidth ? count - i : kWidth;
+        const Lanes ax = loadLanes(q0.x + i, n, 0.f), ay = loadLanes(q0.y + i, n, 0.f);
+        const Lanes az = loadLanes(q0.z + i, n, 0.f), aw = loadLanes(q0.w + i, n, 1.f);
+        const Lanes bx = loadLanes(q1.x + i, n, 0.f), by = loadLanes(q1.y + i, n, 0.f);
+        const Lanes bz = loadLanes(q1.z + i, n, 0.f), bw = loadLanes(q1.w + i, n, 1.f);
+        const Lanes ti = loadLanes(t + i, n, 0.f);
+
+        const Lanes cosHalf = fmadd(ax, bx, fmadd(ay, by, fmadd(az, bz, aw * bw)));
+        const Lanes halfTheta = acosLanes(cosHalf);
+        const Lanes sinHalf = sqrt(max(Lanes::splat(1.f) - cosHalf * cosHalf, Lanes::splat(0.f)));
+        const Lanes invSin = Lanes::splat(1.f) / max(sinHalf, Lanes::splat(1e-3f));
+        Lanes wa = sinLanes((Lanes::splat(1.f) - ti) * halfTheta) * invSin;
+        Lanes wb = sinLanes(ti * halfTheta) * invSin;
+
+        // The scalar function's special cases: equal (or opposite) inputs return
+        // q0, nearly parallel ones the plain average.
+        const auto nearlyParallel = lessThan(sinHalf, Lanes::splat(1e-3f));
+        wa = select(nearlyParallel, Lanes::splat(0.5f), wa);
+        wb = select(nearlyParallel, Lanes::splat(0.5f), wb);
+        const auto distinct = lessThan(abs(cosHalf), Lanes::splat(1.f));
+        wa = select(distinct, wa, Lanes::splat(1.f));
+        wb = select(distinct, wb, Lanes::splat(0.f));
+
+        storeLanes(out.x + i, fmadd(wa, ax, wb * bx), n);
+        storeLanes(out.y + i, fmadd(wa, ay, wb * by), n);
+        storeLanes(out.z + i, fmadd(wa, az, wb * bz), n);
+        storeLanes(out.w + i, fmadd(wa, aw, wb * bw), n);
+    }
+}
+
+static void nlerp( QuatStreams q0, QuatStreams q1, const float* t, QuatOutStreams out, size_t count )
+{
+    for (size_t i = 0; i < count; i += kWidth)
+    {
+        const size_t n = count - i < kWidth ? count - i : kWidth;
+        const Lanes ti = loadLanes(t + i, n, 0.f);
+        const Lanes si = Lanes::splat(1.f) - ti;
+        const Lanes x = fmadd(si, loadLanes(q0.x + i, n, 0.f), ti * loadLanes(q1.x + i, n, 0.f));
+        const Lanes y = fmadd(si, loadLanes(q0.y + i, n, 0.f), ti * loadLanes(q1.y + i, n, 0.f));
+        const Lanes z = fmadd(si, loadLanes(q0.z + i, n, 0.f), ti * loadLanes(q1.z + i, n, 0.f));
+        const Lanes w = fmadd(si, loadLanes(q0.w + i, n, 1.f), ti * loadLanes(q1.w + i, n, 1.f));
+        const Lanes invLength = Lanes::splat(1.f) / sqrt(fmadd(x, x, fmadd(y, y, fmadd(z, z, w * w))));
+        storeLanes(out.x + i, x * invLength, n);
+        storeLanes(out.y + i, y * invLength, n);
+        storeLanes(out.z + i, z * invLength, n);
+        storeLanes(out.w + i, w * invLength, n);
+    }
+}
+
+static void rotateVectors( QuatStreams r, Vec3Streams v, Vec3OutStreams out, size_t count )
+{
+    for (size_t i = 0; i < count; i += kWidth)
+    {
+        const size_t n = count - i < kWidth ? count - i : kWidth;
+        const Lanes qx = loadLanes(r.x + i, n, 0.f), qy = loadLanes(r.y + i, n, 0.f);
+        const Lanes qz = loadLanes(r.z + i, n, 0.f), qw = loadLanes(r.w + i, n, 1.f);
+        const Lanes vx = loadLanes(v.x + i, n, 0.f), vy = loadLanes(v.y + i, n, 0.f), vz = loadLanes(v.z + i, n, 0.f);
+
+        // 2 (q.v) q + (w^2 - q.q) v + 2w (q x v)
+        const Lanes two = Lanes::splat(2.f);
+        const Lanes qv2 = two * fmadd(qx, vx, fmadd(qy, vy, qz * vz));
+        const Lanes ww = qw * qw - fmadd(qx, qx, fmadd(qy, qy, qz * qz));
+        const Lanes w2 = two * qw;
+        storeLanes(out.x + i, fmadd(qv2, qx, fmadd(ww, vx, w2 * (qy * vz - qz * vy))), n);
+        storeLanes(out.y + i, fmadd(qv2, qy, fmadd(ww, vy, w2 * (qz * vx - qx * vz))), n);
+        storeLanes(out.z + i, fmadd(qv2, qz, fmadd(ww, vz, w2 * (qx * vy - qy * vx))), n);
+    }
+}
+
+static const Kernels kKernels = {
+    kIsa,
+    &composeTransforms,
+    &multiplyMatrices,
+    &slerp,
+    &nlerp,
+    &rotateVectors
+};
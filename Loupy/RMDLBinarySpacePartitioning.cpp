@@ -10,6 +10,9 @@
 
 #include "RMDLBinarySpacePartitioning.hpp"
 
+#include <cassert>
+#include <cstdint>
+
 Fixed::Fixed() : _fixedPointValue(0)
 {
 }
@@ -89,24 +92,36 @@ bool    Fixed::operator != (const Fixed &rhs) const
     return (this->getRawBits() != rhs.getRawBits());
 }
 
+// Integer arithmetic on the raw values, so results do not depend on how the
+// compiler evaluates floats.
 Fixed   Fixed::operator + (const Fixed &rhs) const
 {
-    return (Fixed(this->toFloat() + rhs.toFloat()));
+    Fixed   result;
+    result.setRawBits(this->_fixedPointValue + rhs.getRawBits());
+    return (result);
 }
 
 Fixed   Fixed::operator - (const Fixed &rhs) const
 {
-    return (Fixed(this->toFloat() - rhs.toFloat()));
+    Fixed   result;
+    result.setRawBits(this->_fixedPointValue - rhs.getRawBits());
+    return (result);
 }
 
 Fixed   Fixed::operator * (const Fixed &rhs) const
 {
-    return (Fixed(this->toFloat() * rhs.toFloat()));
+    const int64_t   product = (int64_t)this->_fixedPointValue * rhs.getRawBits();
+    Fixed   result;
+    result.setRawBits((int)((product + (1 << (_fractionalBits - 1))) >> _fractionalBits));
+    return (result);
 }
 
 Fixed   Fixed::operator / (const Fixed &rhs) const
 {
-    return (Fixed(this->toFloat() / rhs.toFloat()));
+    assert(rhs.getRawBits() != 0);
+    Fixed   result;
+    result.setRawBits((int)((int64_t)this->_fixedPointValue * (1 << _fractionalBits) / rhs.getRawBits()));
+    return (result);
 }
 
 Fixed   &Fixed::operator ++ ()
@@ -0,0 +1,936 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLBvh.cpp                  +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 06:31:55      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLBvh.hpp"
+#include "RMDLParallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cstring>
+#include <utility>
+
+// The edge functions are differences of products; fused, they lose the
+// exactness the watertight test relies on.
+#if defined(__clang__)
+# pragma STDC FP_CONTRACT OFF
+#endif
+
+namespace bvh
+{
+
+namespace
+{
+    static constexpr uint32_t kMaxBins = 32;
+    static constexpr uint32_t kStackSize = 96;
+    /// From this depth on, nodes split at the middle of their range; with at
+    /// most 2^32 triangles that keeps the tree under kStackSize levels.
+    static constexpr uint32_t kMedianDepth = 60;
+    static constexpr size_t kGrain = 4096;
+    /// Widens the far slab distance so the box test is as watertight as the
+    /// triangle test (Ize, "Robust BVH ray traversal", 2013): 1 + 2 gamma(3).
+    static constexpr float kFarScale = 1.f + 2.f * 3.5762793e-7f;
+    static constexpr float kTinyDirection = 1e-20f;
+
+    typedef float   Lanes4 __attribute__((vector_size(16)));
+    typedef int32_t Ints4 __attribute__((vector_size(16)));
+
+    /// Lanes 0-2 are x, y, z; lane 3 is ignored.
+    struct Box
+    {
+        Lanes4  lo = { FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX };
+        Lanes4  hi = { -FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+        void    grow( Lanes4 boxLo, Lanes4 boxHi )
+        {
+            lo = boxLo < lo ? boxLo : lo;
+            hi = boxHi > hi ? boxHi : hi;
+        }
+
+        void    grow( const float p[3] )
+        {
+            const Lanes4 v = { p[0], p[1], p[2], p[2] };
+            grow(v, v);
+        }
+
+        void    grow( const Box& b )      { grow(b.lo, b.hi); }
+
+        float   area() const
+        {
+            if (lo[0] > hi[0])
+                return (0.f);
+            const Lanes4 e = hi - lo;
+            return (2.f * (e[0] * e[1] + e[1] * e[2] + e[2] * e[0]));
+        }
+    };
+
+    /// A triangle's box, moved around by the partitions so every pass over a
+    /// node's range reads memory in order.
+    struct PrimRef
+    {
+        float       lo[3];
+        uint32_t    triangle;
+        float       hi[3];
+        uint32_t    unused;
+
+        Lanes4      loLanes() const                 { Lanes4 v; memcpy(&v, lo, sizeof(v)); return (v); }
+        Lanes4      hiLanes() const                 { Lanes4 v; memcpy(&v, hi, sizeof(v)); return (v); }
+        /// Twice the centroid, which bins just as well.
+        Lanes4      centroids() const               { return (loLanes() + hiLanes()); }
+        float       centroid( int axis ) const      { return (lo[axis] + hi[axis]); }
+    };
+    static_assert(sizeof(PrimRef) == 32, "PrimRef layout");
+
+    struct Bins
+    {
+        Box         box[3][kMaxBins];
+        uint32_t    count[3][kMaxBins];
+
+        /// Only the bins in use; a full reset per node costs more than the binning.
+        void        reset( uint32_t binCount )
+        {
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                for (uint32_t bin = 0; bin < binCount; ++bin)
+                {
+                    box[axis][bin] = Box();
+                    count[axis][bin] = 0;
+                }
+            }
+        }
+    };
+
+    struct Builder
+    {
+        const BuildOptions&     options;
+        const uint32_t          maxBins;
+        std::vector<PrimRef>    refs;
+        Node*                   pNodes;
+        std::atomic<uint32_t>   nodeCount{ 1 };
+
+        Builder( const BuildOptions& buildOptions, size_t triangleCount, Node* pNodeStorage )
+        : options( buildOptions )
+        , maxBins( std::clamp(buildOptions.binCount, 2u, kMaxBins) )
+        , refs( triangleCount )
+        , pNodes( pNodeStorage )
+        {
+        }
+
+        void    rangeBounds( uint32_t begin, uint32_t end, Box& bounds, Box& centroidBounds ) const;
+        void    binRange( uint32_t begin, uint32_t end, const Box& centroidBounds, const float scale[3], uint32_t binCount, Bins& bins ) const;
+        /// `bounds` and `centroidBounds` are those of the range, from the parent's partition.
+        void    buildNode( uint32_t node, uint32_t begin, uint32_t end, uint32_t depth, const Box& bounds, const Box& centroidBounds );
+    };
+
+    inline uint32_t binOf( float c, float lo, float scale, uint32_t binCount )
+    {
+        return (std::min(binCount - 1, (uint32_t)std::max(0.f, (c - lo) * scale)));
+    }
+
+    /// binOf on the three axes at once.
+    inline Ints4 binsOf( Lanes4 c, Lanes4 lo, Lanes4 scale, uint32_t binCount )
+    {
+        Lanes4 f = (c - lo) * scale;
+        f = f > 0.f ? f : Lanes4{};
+        const Ints4 bins = __builtin_convertvector(f, Ints4);
+        const Ints4 last = Ints4{} + (int32_t)(binCount - 1);
+        return (bins < last ? bins : last);
+    }
+
+    void Builder::rangeBounds( uint32_t begin, uint32_t end, Box& bounds, Box& centroidBounds ) const
+    {
+        auto reduce = [this]( uint32_t first, uint32_t last, Box& b, Box& c )
+        {
+            for (uint32_t i = first; i < last; ++i)
+            {
+                const PrimRef& ref = refs[i];
+                const Lanes4 centroid = ref.centroids();
+                b.grow(ref.loLanes(), ref.hiLanes());
+                c.grow(centroid, centroid);
+            }
+        };
+
+        const size_t count = end - begin;
+        if (count <= options.parallelThreshold)
+        {
+            reduce(begin, end, bounds, centroidBounds);
+            return;
+        }
+        const size_t chunks = (count + kGrain - 1) / kGrain;
+        std::vector<std::pair<Box, Box>> partial(chunks);
+        parallel::forRange(chunks, 1, [&]( size_t first, size_t last ) {
+            for (size_t chunk = first; chunk < last; ++chunk)
+            {
+                const uint32_t b = begin + (uint32_t)(chunk * kGrain);
+                reduce(b, std::min(end, b + (uint32_t)kGrain), partial[chunk].first, partial[chunk].second);
+            }
+        });
+        for (const std::pair<Box, Box>& p : partial)
+        {
+            bounds.grow(p.first);
+            centroidBounds.grow(p.second);
+        }
+    }
+
+    void Builder::binRange( uint32_t begin, uint32_t end, const Box& centroidBounds, const float scale[3], uint32_t binCount, Bins& bins ) const
+    {
+        const Lanes4 scales = { scale[0], scale[1], scale[2], 0.f };
+        auto fill = [&]( uint32_t first, uint32_t last, Bins& into )
+        {
+            for (uint32_t i = first; i < last; ++i)
+            {
+                const PrimRef& ref = refs[i];
+                const Lanes4 lo = ref.loLanes(), hi = ref.hiLanes();
+                const Ints4 bins = binsOf(lo + hi, centroidBounds.lo, scales, binCount);
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    into.box[axis][bins[axis]].grow(lo, hi);
+                    ++into.count[axis][bins[axis]];
+                }
+            }
+        };
+
+        const size_t count = end - begin;
+        if (count <= options.parallelThreshold)
+        {
+            fill(begin, end, bins);
+            return;
+        }
+        // Fewer, larger chunks: every chunk carries a full set of bins.
+        const size_t grain = std::max<size_t>(kGrain * 4, count / 64);
+        const size_t chunks = (count + grain - 1) / grain;
+        std::vector<Bins> partial(chunks);
+        parallel::forRange(chunks, 1, [&]( size_t first, size_t last ) {
+            for (size_t chunk = first; chunk < last; ++chunk)
+            {
+                const uint32_t b = begin + (uint32_t)(chunk * grain);
+                partial[chunk].reset(binCount);
+                fill(b, (uint32_t)std::min<size_t>(end, b + grain), partial[chunk]);
+            }
+        });
+        for (const Bins& p : partial)
+        {
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                for (uint32_t bin = 0; bin < binCount; ++bin)
+                {
+                    bins.box[axis][bin].grow(p.box[axis][bin]);
+                    bins.count[axis][bin] += p.count[axis][bin];
+                }
+            }
+        }
+    }
+
+    void Builder::buildNode( uint32_t node, uint32_t begin, uint32_t end, uint32_t depth, const Box& bounds, const Box& centroidBounds )
+    {
+        Node& n = pNodes[node];
+        memcpy(n.boundsMin, &bounds.lo, sizeof(n.boundsMin));
+        memcpy(n.boundsMax, &bounds.hi, sizeof(n.boundsMax));
+        n.axis = 0;
+
+        const uint32_t count = end - begin;
+        const uint32_t maxLeafSize = std::clamp(options.maxLeafSize, 1u, 255u);
+        auto makeLeaf = [&]()
+        {
+            n.offset = begin;
+            n.count = (uint16_t)count;
+        };
+        if (count == 1)
+        {
+            makeLeaf();
+            return;
+        }
+
+        int axis = 0;
+        for (int a = 1; a < 3; ++a)
+        {
+            if (centroidBounds.hi[a] - centroidBounds.lo[a] > centroidBounds.hi[axis] - centroidBounds.lo[axis])
+                axis = a;
+        }
+        const bool degenerate = !(centroidBounds.hi[axis] > centroidBounds.lo[axis]);
+
+        // Binned SAH: the cheapest of binCount - 1 planes on each axis.
+        const uint32_t binCount = std::min(maxBins, count);
+        float bestCost = FLT_MAX;
+        int bestAxis = -1;
+        uint32_t bestBin = 0;
+        float scale[3] = { 0.f, 0.f, 0.f };
+        if (!degenerate && depth < kMedianDepth)
+        {
+            for (int a = 0; a < 3; ++a)
+            {
+                const float extent = centroidBounds.hi[a] - centroidBounds.lo[a];
+                scale[a] = extent > 0.f ? binCount * (1.f - 1e-6f) / extent : 0.f;
+            }
+            Bins bins;
+            bins.reset(binCount);
+            binRange(begin, end, centroidBounds, scale, binCount, bins);
+
+            const float parentArea = std::max(bounds.area(), FLT_MIN);
+            for (int a = 0; a < 3; ++a)
+            {
+                if (scale[a] == 0.f)
+                    continue;
+                float rightArea[kMaxBins];
+                uint32_t rightCount[kMaxBins];
+                Box right;
+                uint32_t rightTotal = 0;
+                for (uint32_t bin = binCount - 1; bin > 0; --bin)
+                {
+                    right.grow(bins.box[a][bin]);
+                    rightTotal += bins.count[a][bin];
+                    rightArea[bin] = right.area();
+                    rightCount[bin] = rightTotal;
+                }
+                Box left;
+                uint32_t leftTotal = 0;
+                for (uint32_t bin = 0; bin + 1 < binCount; ++bin)
+                {
+                    left.grow(bins.box[a][bin]);
+                    leftTotal += bins.count[a][bin];
+                    if (leftTotal == 0 || rightCount[bin + 1] == 0)
+                        continue;
+                    const float cost = options.traversalCost
+                                     + (left.area() * leftTotal + rightArea[bin + 1] * rightCount[bin + 1]) / parentArea;
+                    if (cost < bestCost)
+                    {
+                        bestCost = cost;
+                        bestAxis = a;
+                        bestBin = bin;
+                    }
+                }
+            }
+            if (count <= maxLeafSize && (float)count <= bestCost)
+            {
+                makeLeaf();
+                return;
+            }
+        }
+        else if (count <= maxLeafSize)
+        {
+            makeLeaf();
+            return;
+        }
+
+        PrimRef* const pBegin = refs.data() + begin;
+        PrimRef* const pEnd = refs.data() + end;
+        PrimRef* pMiddle = pBegin;
+        Box leftBounds, leftCentroids, rightBounds, rightCentroids;
+        if (bestAxis >= 0)
+        {
+            // Hoare partition that also measures both sides, so the children
+            // start with their bounds instead of another pass over the range.
+            axis = bestAxis;
+            const float lo = centroidBounds.lo[axis], s = scale[axis];
+            auto goesLeft = [&]( const PrimRef& ref ) { return (binOf(ref.centroid(axis), lo, s, binCount) <= bestBin); };
+            auto add = []( const PrimRef& ref, Box& box, Box& centroids )
+            {
+                const Lanes4 refLo = ref.loLanes(), refHi = ref.hiLanes(), centroid = refLo + refHi;
+                box.grow(refLo, refHi);
+                centroids.grow(centroid, centroid);
+            };
+            PrimRef* pLeft = pBegin;
+            PrimRef* pRight = pEnd;
+            for (;;)
+            {
+                while (pLeft < pRight && goesLeft(*pLeft))
+                    add(*pLeft++, leftBounds, leftCentroids);
+                while (pLeft < pRight && !goesLeft(pRight[-1]))
+                    add(*--pRight, rightBounds, rightCentroids);
+                if (pLeft == pRight)
+                    break;
+                std::swap(*pLeft, *--pRight);
+                add(*pLeft++, leftBounds, leftCentroids);
+                add(*pRight, rightBounds, rightCentroids);
+            }
+            pMiddle = pLeft;
+        }
+        if (pMiddle == pBegin || pMiddle == pEnd)
+        {
+            // No usable plane: halve the range, ordered along the longest axis.
+            pMiddle = pBegin + count / 2;
+            if (!degenerate)
+            {
+                std::nth_element(pBegin, pMiddle, pEnd, [&]( const PrimRef& a, const PrimRef& b ) {
+                    return (a.centroid(axis) < b.centroid(axis));
+                });
+            }
+            leftBounds = leftCentroids = rightBounds = rightCentroids = Box();
+            rangeBounds(begin, begin + (uint32_t)(pMiddle - pBegin), leftBounds, leftCentroids);
+            rangeBounds(begin + (uint32_t)(pMiddle - pBegin), end, rightBounds, rightCentroids);
+        }
+        const uint32_t middle = begin + (uint32_t)(pMiddle - pBegin);
+
+        const uint32_t child = nodeCount.fetch_add(2, std::memory_order_relaxed);
+        n.offset = child;
+        n.count = 0;
+        n.axis = (uint16_t)axis;
+        if (count > options.parallelThreshold)
+        {
+            parallel::forEach(2, [&]( size_t i ) {
+                if (i == 0)
+                    buildNode(child, begin, middle, depth + 1, leftBounds, leftCentroids);
+                else
+                    buildNode(child + 1, middle, end, depth + 1, rightBounds, rightCentroids);
+            });
+        }
+        else
+        {
+            buildNode(child, begin, middle, depth + 1, leftBounds, leftCentroids);
+            buildNode(child + 1, middle, end, depth + 1, rightBounds, rightCentroids);
+        }
+    }
+
+#pragma mark - Ray setup
+
+    /// The per-ray constants of the watertight test: the axis the ray mostly
+    /// follows becomes z, and the shear that makes the ray (0, 0, 1).
+    struct RaySetup
+    {
+        float   origin[3];
+        float   inverse[3];
+        int     kx, ky, kz;
+        float   sx, sy, sz;
+
+        RaySetup() = default;
+        explicit RaySetup( const float o[3], const float d[3] )
+        {
+            kz = 0;
+            for (int i = 0; i < 3; ++i)
+            {
+                origin[i] = o[i];
+                const float di = std::fabs(d[i]) < kTinyDirection ? std::copysign(kTinyDirection, d[i]) : d[i];
+                inverse[i] = 1.f / di;
+                if (std::fabs(d[i]) > std::fabs(d[kz]))
+                    kz = i;
+            }
+            kx = (kz + 1) % 3;
+            ky = (kx + 1) % 3;
+            if (d[kz] < 0.f)
+                std::swap(kx, ky);
+            sx = d[kx] / d[kz];
+            sy = d[ky] / d[kz];
+            sz = 1.f / d[kz];
+        }
+    };
+
+    inline bool hitBox( const RaySetup& r, const Node& node, float tMin, float tMax, float& tNear )
+    {
+        float lo = tMin, hi = tMax;
+        for (int i = 0; i < 3; ++i)
+        {
+            float t0 = (node.boundsMin[i] - r.origin[i]) * r.inverse[i];
+            float t1 = (node.boundsMax[i] - r.origin[i]) * r.inverse[i];
+            if (r.inverse[i] < 0.f)
+                std::swap(t0, t1);
+            lo = std::max(lo, t0);
+            hi = std::min(hi, t1 * kFarScale);
+        }
+        tNear = lo;
+        return (lo <= hi);
+    }
+
+    /// Woop, Benthin and Wald, "Watertight ray/triangle intersection", 2013.
+    inline bool hitTriangle( const RaySetup& r, const float* pVertices, float tMin, float tMax, float& t, float& u, float& v )
+    {
+        const float a[3] = { pVertices[0] - r.origin[0], pVertices[1] - r.origin[1], pVertices[2] - r.origin[2] };
+        const float b[3] = { pVertices[3] - r.origin[0], pVertices[4] - r.origin[1], pVertices[5] - r.origin[2] };
+        const float c[3] = { pVertices[6] - r.origin[0], pVertices[7] - r.origin[1], pVertices[8] - r.origin[2] };
+        const float ax = a[r.kx] - r.sx * a[r.kz], ay = a[r.ky] - r.sy * a[r.kz];
+        const float bx = b[r.kx] - r.sx * b[r.kz], by = b[r.ky] - r.sy * b[r.kz];
+        const float cx = c[r.kx] - r.sx * c[r.kz], cy = c[r.ky] - r.sy * c[r.kz];
+        float e0 = cx * by - cy * bx;
+        float e1 = ax * cy - ay * cx;
+        float e2 = bx * ay - by * ax;
+        if (e0 == 0.f || e1 == 0.f || e2 == 0.f)
+        {
+            // On an edge in float: decide it in double so neighbours agree.
+            e0 = (float)((double)cx * by - (double)cy * bx);
+            e1 = (float)((double)ax * cy - (double)ay * cx);
+            e2 = (float)((double)bx * ay - (double)by * ax);
+        }
+        if ((e0 < 0.f || e1 < 0.f || e2 < 0.f) && (e0 > 0.f || e1 > 0.f || e2 > 0.f))
+            return (false);
+        const float det = e0 + e1 + e2;
+        if (det == 0.f)
+            return (false);
+        const float tScaled = e0 * (r.sz * a[r.kz]) + e1 * (r.sz * b[r.kz]) + e2 * (r.sz * c[r.kz]);
+        const float sign = det < 0.f ? -1.f : 1.f;
+        const float tSigned = tScaled * sign, detAbs = det * sign;
+        if (tSigned < tMin * detAbs || tSigned > tMax * detAbs)
+            return (false);
+        const float inverseDet = 1.f / det;
+        t = tScaled * inverseDet;
+        u = e1 * inverseDet;
+        v = e2 * inverseDet;
+        return (true);
+    }
+
+    struct StackEntry
+    {
+        uint32_t    node;
+        float       tNear;
+    };
+
+    template< typename Leaf >
+    inline void traverse( const std::vector<Node>& nodes, const RaySetup& r, float tMin, float& tMax, Leaf&& leaf )
+    {
+        StackEntry stack[kStackSize];
+        uint32_t top = 0;
+        float tNear;
+        if (nodes.empty() || !hitBox(r, nodes[0], tMin, tMax, tNear))
+            return;
+        stack[top++] = { 0, tNear };
+        while (top > 0)
+        {
+            const StackEntry entry = stack[--top];
+            if (entry.tNear > tMax)
+                continue;
+            const Node* pNode = &nodes[entry.node];
+            while (pNode->count == 0)
+            {
+                const Node& left = nodes[pNode->offset];
+                const Node& right = nodes[pNode->offset + 1];
+                float tLeft, tRight;
+                const bool hitLeft = hitBox(r, left, tMin, tMax, tLeft);
+                const bool hitRight = hitBox(r, right, tMin, tMax, tRight);
+                if (hitLeft && hitRight)
+                {
+                    // Nearer child first, the other waits with its distance.
+                    if (tLeft <= tRight)
+                    {
+                        stack[top++] = { pNode->offset + 1, tRight };
+                        pNode = &left;
+                    }
+                    else
+                    {
+                        stack[top++] = { pNode->offset, tLeft };
+                        pNode = &right;
+                    }
+                }
+                else if (hitLeft)
+                    pNode = &left;
+                else if (hitRight)
+                    pNode = &right;
+                else
+                    break;
+            }
+            if (pNode->count > 0 && leaf(*pNode))
+                return;
+        }
+    }
+}
+
+#pragma mark - Build
+
+void Bvh::build( const TriangleMesh& mesh, const BuildOptions& options )
+{
+    const size_t count = mesh.triangleCount;
+    _nodes.clear();
+    _triangles.resize(count);
+    _stats = BuildStats();
+    if (count == 0)
+    {
+        _vertices.clear();
+        return;
+    }
+
+    _nodes.resize(2 * count - 1);
+    Builder builder(options, count, _nodes.data());
+    parallel::forRange(count, kGrain, [&]( size_t begin, size_t end ) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            Box box;
+            for (int corner = 0; corner < 3; ++corner)
+                box.grow(mesh.pPositions + mesh.stride * mesh.pIndices[3 * i + corner]);
+            PrimRef& ref = builder.refs[i];
+            memcpy(ref.lo, &box.lo, sizeof(ref.lo));
+            memcpy(ref.hi, &box.hi, sizeof(ref.hi));
+            ref.triangle = (uint32_t)i;
+            ref.unused = 0;
+        }
+    });
+    Box bounds, centroidBounds;
+    builder.rangeBounds(0, (uint32_t)count, bounds, centroidBounds);
+    builder.buildNode(0, 0, (uint32_t)count, 0, bounds, centroidBounds);
+    _nodes.resize(builder.nodeCount.load());
+    for (size_t i = 0; i < count; ++i)
+        _triangles[i] = builder.refs[i].triangle;
+
+    gatherVertices(mesh);
+    computeStats();
+}
+
+void Bvh::gatherVertices( const TriangleMesh& mesh )
+{
+    _vertices.resize(9 * _triangles.size());
+    parallel::forRange(_triangles.size(), kGrain, [&]( size_t begin, size_t end ) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const uint32_t* pCorners = mesh.pIndices + 3 * _triangles[i];
+            for (int corner = 0; corner < 3; ++corner)
+                memcpy(&_vertices[9 * i + 3 * corner], mesh.pPositions + mesh.stride * pCorners[corner], 3 * sizeof(float));
+        }
+    });
+}
+
+void Bvh::refit( const TriangleMesh& mesh )
+{
+    gatherVertices(mesh);
+    parallel::forRange(_nodes.size(), kGrain, [&]( size_t begin, size_t end ) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            Node& node = _nodes[i];
+            if (node.count == 0)
+                continue;
+            Box box;
+            for (uint32_t k = 0; k < 3u * node.count; ++k)
+                box.grow(&_vertices[9 * node.offset + 3 * k]);
+            memcpy(node.boundsMin, &box.lo, sizeof(node.boundsMin));
+            memcpy(node.boundsMax, &box.hi, sizeof(node.boundsMax));
+        }
+    });
+    // Children always come after their parent.
+    for (size_t i = _nodes.size(); i-- > 0; )
+    {
+        Node& node = _nodes[i];
+        if (node.count > 0)
+            continue;
+        const Node& left = _nodes[node.offset];
+        const Node& right = _nodes[node.offset + 1];
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            node.boundsMin[axis] = std::min(left.boundsMin[axis], right.boundsMin[axis]);
+            node.boundsMax[axis] = std::max(left.boundsMax[axis], right.boundsMax[axis]);
+        }
+    }
+    computeStats();
+}
+
+void Bvh::computeStats()
+{
+    _stats = BuildStats();
+    _stats.nodeCount = _nodes.size();
+    if (_nodes.empty())
+        return;
+    auto area = []( const Node& node )
+    {
+        const float x = node.boundsMax[0] - node.boundsMin[0];
+        const float y = node.boundsMax[1] - node.boundsMin[1];
+        const float z = node.boundsMax[2] - node.boundsMin[2];
+        return (2.f * (x * y + y * z + z * x));
+    };
+    const float rootArea = std::max(area(_nodes[0]), FLT_MIN);
+    std::vector<std::pair<uint32_t, uint32_t>> stack = { { 0, 1 } };
+    double cost = 0.0;
+    while (!stack.empty())
+    {
+        const auto [index, depth] = stack.back();
+        stack.pop_back();
+        const Node& node = _nodes[index];
+        _stats.depth = std::max(_stats.depth, depth);
+        if (node.count > 0)
+        {
+            ++_stats.leafCount;
+            cost += area(node) / rootArea * node.count;
+            continue;
+        }
+        cost += area(node) / rootArea;
+        stack.push_back({ node.offset, depth + 1 });
+        stack.push_back({ node.offset + 1, depth + 1 });
+    }
+    _stats.sahCost = (float)cost;
+}
+
+#pragma mark - Single rays
+
+Hit Bvh::intersect( const Ray& ray ) const
+{
+    const float origin[3] = { ray.origin.x, ray.origin.y, ray.origin.z };
+    const float direction[3] = { ray.direction.x, ray.direction.y, ray.direction.z };
+    const RaySetup r(origin, direction);
+    Hit hit;
+    float tMax = ray.tMax;
+    traverse(_nodes, r, ray.tMin, tMax, [&]( const Node& leaf ) {
+        for (uint32_t i = leaf.offset; i < leaf.offset + leaf.count; ++i)
+        {
+            float t, u, v;
+            if (hitTriangle(r, &_vertices[9 * i], ray.tMin, tMax, t, u, v))
+            {
+                tMax = t;
+                hit = { t, u, v, _triangles[i] };
+            }
+        }
+        return (false);
+    });
+    return (hit);
+}
+
+bool Bvh::occluded( const Ray& ray ) const
+{
+    const float origin[3] = { ray.origin.x, ray.origin.y, ray.origin.z };
+    const float direction[3] = { ray.direction.x, ray.direction.y, ray.direction.z };
+    const RaySetup r(origin, direction);
+    bool found = false;
+    float tMax = ray.tMax;
+    traverse(_nodes, r, ray.tMin, tMax, [&]( const Node& leaf ) {
+        for (uint32_t i = leaf.offset; i < leaf.offset + leaf.count; ++i)
+        {
+            float t, u, v;
+            if (hitTriangle(r, &_vertices[9 * i], ray.tMin, tMax, t, u, v))
+                return (found = true);
+        }
+        return (false);
+    });
+    return (found);
+}
+
+#pragma mark - Packets
+
+namespace
+{
+    /// W lanes of float and int; the compiler maps them to SSE/AVX or NEON.
+    template< int W >
+    struct Lanes
+    {
+        typedef float   F __attribute__((vector_size(W * sizeof(float))));
+        typedef int32_t I __attribute__((vector_size(W * sizeof(int32_t))));
+    };
+
+    // Vectors go out through references: an eight-lane vector returned by value
+    // has a different ABI with and without AVX, and GCC says so (-Wpsabi).
+    template< typename V >
+    __attribute__((always_inline)) inline void load( V& v, const float* p )
+    {
+        memcpy(&v, p, sizeof(v));
+    }
+
+    template< typename I >
+    __attribute__((always_inline)) inline bool any( const I& mask, int lanes )
+    {
+        int32_t bits = 0;
+        for (int i = 0; i < lanes; ++i)
+            bits |= mask[i];
+        return (bits != 0);
+    }
+
+    /// The packet traversal. Inlined into each caller so it is compiled for
+    /// the caller's instruction set.
+    template< int W >
+    __attribute__((always_inline)) inline void intersectPacket( const std::vector<Node>& nodes, const float* pVertices, const uint32_t* pTriangles,
+                                                                const RayPacket<W>& rays, HitPacket<W>& hits )
+    {
+        typedef typename Lanes<W>::F F;
+        typedef typename Lanes<W>::I I;
+
+        F ox, oy, oz, tMin, tMax;
+        load(ox, rays.originX);
+        load(oy, rays.originY);
+        load(oz, rays.originZ);
+        load(tMin, rays.tMin);
+        load(tMax, rays.tMax);
+        F hitU = {}, hitV = {};
+        I hitIndex = {};
+        hitIndex -= 1;
+
+        // Per lane: slab inverses, and the watertight shear with its axes as masks.
+        F ix, iy, iz, sx, sy, sz;
+        I xIsX, xIsY, yIsX, yIsY, zIsX, zIsY;
+        RaySetup setup[W];
+        for (int lane = 0; lane < W; ++lane)
+        {
+            const float o[3] = { rays.originX[lane], rays.originY[lane], rays.originZ[lane] };
+            const float d[3] = { rays.directionX[lane], rays.directionY[lane], rays.directionZ[lane] };
+            setup[lane] = RaySetup(o, d);
+            const RaySetup& r = setup[lane];
+            ix[lane] = r.inverse[0]; iy[lane] = r.inverse[1]; iz[lane] = r.inverse[2];
+            sx[lane] = r.sx; sy[lane] = r.sy; sz[lane] = r.sz;
+            xIsX[lane] = -(r.kx == 0); xIsY[lane] = -(r.kx == 1);
+            yIsX[lane] = -(r.ky == 0); yIsY[lane] = -(r.ky == 1);
+            zIsX[lane] = -(r.kz == 0); zIsY[lane] = -(r.kz == 1);
+        }
+        // Children in the order the first ray would visit them.
+        const bool firstNegative[3] = { setup[0].inverse[0] < 0.f, setup[0].inverse[1] < 0.f, setup[0].inverse[2] < 0.f };
+
+        // Lambdas would be compiled without the caller's target; forced inline they take it on.
+        auto pick = []( F& out, const I& isX, const I& isY, const F& x, const F& y, const F& z ) __attribute__((always_inline))
+        {
+            out = isX ? x : (isY ? y : z);
+        };
+
+        uint32_t stack[kStackSize];
+        uint32_t top = 0;
+        if (!nodes.empty())
+            stack[top++] = 0;
+        while (top > 0)
+        {
+            const Node& node = nodes[stack[--top]];
+            const F t0x = (node.boundsMin[0] - ox) * ix, t1x = (node.boundsMax[0] - ox) * ix;
+            const F t0y = (node.boundsMin[1] - oy) * iy, t1y = (node.boundsMax[1] - oy) * iy;
+            const F t0z = (node.boundsMin[2] - oz) * iz, t1z = (node.boundsMax[2] - oz) * iz;
+            const F nearX = t0x < t1x ? t0x : t1x, nearY = t0y < t1y ? t0y : t1y, nearZ = t0z < t1z ? t0z : t1z;
+            const F farX = t0x > t1x ? t0x : t1x, farY = t0y > t1y ? t0y : t1y, farZ = t0z > t1z ? t0z : t1z;
+            const F loX = tMin > nearX ? tMin : nearX, loYZ = nearY > nearZ ? nearY : nearZ;
+            const F lo = loX > loYZ ? loX : loYZ;
+            const F farYZ = farY < farZ ? farY : farZ;
+            const F far = (farX < farYZ ? farX : farYZ) * kFarScale;
+            const F hi = tMax < far ? tMax : far;
+            const I active = lo <= hi;
+            if (!any(active, W))
+                continue;
+
+            if (node.count == 0)
+            {
+                const bool rightFirst = firstNegative[node.axis];
+                stack[top++] = node.offset + (rightFirst ? 0 : 1);
+                stack[top++] = node.offset + (rightFirst ? 1 : 0);
+                continue;
+            }
+
+            for (uint32_t i = node.offset; i < node.offset + node.count; ++i)
+            {
+                const float* pV = pVertices + 9 * i;
+                const F axw = pV[0] - ox, ayw = pV[1] - oy, azw = pV[2] - oz;
+                const F bxw = pV[3] - ox, byw = pV[4] - oy, bzw = pV[5] - oz;
+                const F cxw = pV[6] - ox, cyw = pV[7] - oy, czw = pV[8] - oz;
+                F az, bz, cz, ax, ay, bx, by, cx, cy;
+                pick(az, zIsX, zIsY, axw, ayw, azw);
+                pick(bz, zIsX, zIsY, bxw, byw, bzw);
+                pick(cz, zIsX, zIsY, cxw, cyw, czw);
+                pick(ax, xIsX, xIsY, axw, ayw, azw);
+                pick(ay, yIsX, yIsY, axw, ayw, azw);
+                pick(bx, xIsX, xIsY, bxw, byw, bzw);
+                pick(by, yIsX, yIsY, bxw, byw, bzw);
+                pick(cx, xIsX, xIsY, cxw, cyw, czw);
+                pick(cy, yIsX, yIsY, cxw, cyw, czw);
+                ax -= sx * az; ay -= sy * az;
+                bx -= sx * bz; by -= sy * bz;
+                cx -= sx * cz; cy -= sy * cz;
+                const F e0 = cx * by - cy * bx;
+                const F e1 = ax * cy - ay * cx;
+                const F e2 = bx * ay - by * ax;
+                const I onEdge = (e0 == 0.f) | (e1 == 0.f) | (e2 == 0.f);
+                if (any(onEdge & active, W))
+                {
+                    // Rare: the scalar test settles edges in double, lane by lane.
+                    for (int lane = 0; lane < W; ++lane)
+                    {
+                        float t, u, v;
+                        if (active[lane] && hitTriangle(setup[lane], pV, tMin[lane], tMax[lane], t, u, v))
+                        {
+                            tMax[lane] = t;
+                            hitU[lane] = u;
+                            hitV[lane] = v;
+                            hitIndex[lane] = (int32_t)pTriangles[i];
+                        }
+                    }
+                    continue;
+                }
+                const I inside = ~(((e0 < 0.f) | (e1 < 0.f) | (e2 < 0.f)) & ((e0 > 0.f) | (e1 > 0.f) | (e2 > 0.f)));
+                const F det = e0 + e1 + e2;
+                const F tScaled = sz * (e0 * az + e1 * bz + e2 * cz);
+                const F tSigned = det < 0.f ? -tScaled : tScaled;
+                const F detAbs = det < 0.f ? -det : det;
+                const I hit = active & inside & (det != 0.f) & (tSigned >= tMin * detAbs) & (tSigned <= tMax * detAbs);
+                if (!any(hit, W))
+                    continue;
+                const F inverseDet = 1.f / (det != 0.f ? det : 1.f);
+                tMax = hit ? tScaled * inverseDet : tMax;
+                hitU = hit ? e1 * inverseDet : hitU;
+                hitV = hit ? e2 * inverseDet : hitV;
+                hitIndex = hit ? (I{} + (int32_t)pTriangles[i]) : hitIndex;
+            }
+        }
+
+        for (int lane = 0; lane < W; ++lane)
+        {
+            const bool found = hitIndex[lane] != -1;
+            hits.t[lane] = found ? tMax[lane] : INFINITY;
+            hits.u[lane] = found ? hitU[lane] : 0.f;
+            hits.v[lane] = found ? hitV[lane] : 0.f;
+            hits.triangle[lane] = found ? (uint32_t)hitIndex[lane] : kNoHit;
+        }
+    }
+
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(__AVX2__)
+    /// Eight lanes want 256-bit registers; built for the baseline they would be
+    /// split into scalar code.
+    __attribute__((target("avx2"))) void intersectPacket8Avx2( const std::vector<Node>& nodes, const float* pVertices, const uint32_t* pTriangles,
+                                                               const RayPacket<8>& rays, HitPacket<8>& hits )
+    {
+        intersectPacket<8>(nodes, pVertices, pTriangles, rays, hits);
+    }
+#endif
+}
+
+template< int W >
+void Bvh::intersect( const RayPacket<W>& rays, HitPacket<W>& hits ) const
+{
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(__AVX2__)
+    if constexpr (W == 8)
+    {
+        static const bool avx2 = __builtin_cpu_supports("avx2");
+        if (avx2)
+        {
+            intersectPacket8Avx2(_nodes, _vertices.data(), _triangles.data(), rays, hits);
+            return;
+        }
+        // Without it, two packets of four.
+        for (int o = 0; o < 8; o += 4)
+        {
+            RayPacket<4> quarter;
+            HitPacket<4> quarterHits;
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                quarter.originX[lane] = rays.originX[o + lane];
+                quarter.originY[lane] = rays.originY[o + lane];
+                quarter.originZ[lane] = rays.originZ[o + lane];
+                quarter.directionX[lane] = rays.directionX[o + lane];
+                quarter.directionY[lane] = rays.directionY[o + lane];
+                quarter.directionZ[lane] = rays.directionZ[o + lane];
+                quarter.tMin[lane] = rays.tMin[o + lane];
+                quarter.tMax[lane] = rays.tMax[o + lane];
+            }
+            intersectPacket<4>(_nodes, _vertices.data(), _triangles.data(), quarter, quarterHits);
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                hits.t[o + lane] = quarterHits.t[lane];
+                hits.u[o + lane] = quarterHits.u[lane];
+                hits.v[o + lane] = quarterHits.v[lane];
+                hits.triangle[o + lane] = quarterHits.triangle[lane];
+            }
+        }
+        return;
+    }
+#endif
+    intersectPacket<W>(_nodes, _vertices.data(), _triangles.data(), rays, hits);
+}
+
+template void Bvh::intersect<4>( const RayPacket<4>& rays, HitPacket<4>& hits ) const;
+template void Bvh::intersect<8>( const RayPacket<8>& rays, HitPacket<8>& hits ) const;
+
+#pragma mark - Picking
+
+Ray rayThroughPixel( float x, float y, float width, float height, const simd::float4x4& inverseViewProjection )
+{
+    const float ndcX = 2.f * x / width - 1.f;
+    const float ndcY = 1.f - 2.f * y / height;
+    simd::float4 nearPoint = inverseViewProjection * simd_make_float4(ndcX, ndcY, 0.f, 1.f);
+    simd::float4 farPoint = inverseViewProjection * simd_make_float4(ndcX, ndcY, 1.f, 1.f);
+    nearPoint *= 1.f / nearPoint.w;
+    farPoint *= 1.f / farPoint.w;
+
+    Ray ray;
+    ray.origin = nearPoint.xyz;
+    ray.direction = simd::normalize(farPoint.xyz - nearPoint.xyz);
+    return (ray);
+}
+
+}
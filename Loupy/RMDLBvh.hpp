@@ -0,0 +1,137 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLBvh.hpp                  +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 06:31:47      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLBVH_HPP
+# define RMDLBVH_HPP
+
+# include <cmath>
+# include <cstddef>
+# include <cstdint>
+# include <vector>
+
+# include "RMDLSimd.hpp"
+
+// Bounding volume hierarchy over a triangle mesh, for CPU ray queries such as
+// picking the triangle under the cursor. build() splits with binned SAH, in
+// parallel once a node is large; nodes are 32 bytes with both children side by
+// side. Triangle tests are watertight (Woop, Benthin and Wald 2013), so a ray
+// through a shared edge or vertex hits one of the triangles. refit() keeps the
+// tree and refreshes the bounds after the vertices move.
+
+namespace bvh
+{
+    static constexpr uint32_t kNoHit = ~0u;
+
+    struct Node
+    {
+        float       boundsMin[3];
+        uint32_t    offset;     // leaf: first triangle; otherwise the left child, right is offset + 1
+        float       boundsMax[3];
+        uint16_t    count;      // triangles in a leaf, 0 otherwise
+        uint16_t    axis;       // split axis
+    };
+    static_assert(sizeof(Node) == 32, "Node layout");
+
+    /// Positions are x, y, z at every `stride` floats; three indices per triangle.
+    struct TriangleMesh
+    {
+        const float*    pPositions      = nullptr;
+        size_t          stride          = 3;
+        size_t          vertexCount     = 0;
+        const uint32_t* pIndices        = nullptr;
+        size_t          triangleCount   = 0;
+    };
+
+    struct BuildOptions
+    {
+        uint32_t    maxLeafSize         = 4;
+        uint32_t    binCount            = 16;       // up to 32
+        float       traversalCost       = 1.f;      // in triangle tests
+        /// Triangles in a node before its binning and its children go to the thread pool.
+        size_t      parallelThreshold   = 32 * 1024;
+    };
+
+    struct BuildStats
+    {
+        size_t      nodeCount   = 0;
+        size_t      leafCount   = 0;
+        uint32_t    depth       = 0;
+        float       sahCost     = 0.f;      // expected tests per ray, relative to the root box
+    };
+
+    struct Ray
+    {
+        simd::float3    origin;
+        simd::float3    direction;
+        float           tMin    = 0.f;
+        float           tMax    = INFINITY;
+    };
+
+    /// `triangle` indexes the mesh given to build(); u and v weight its second
+    /// and third vertices.
+    struct Hit
+    {
+        float       t           = INFINITY;
+        float       u           = 0.f;
+        float       v           = 0.f;
+        uint32_t    triangle    = kNoHit;
+    };
+
+    /// W rays that start near each other and point roughly the same way.
+    template< int W >
+    struct RayPacket
+    {
+        float       originX[W], originY[W], originZ[W];
+        float       directionX[W], directionY[W], directionZ[W];
+        float       tMin[W], tMax[W];
+    };
+
+    template< int W >
+    struct HitPacket
+    {
+        float       t[W], u[W], v[W];
+        uint32_t    triangle[W];
+    };
+
+    class Bvh
+    {
+    public:
+        void            build( const TriangleMesh& mesh, const BuildOptions& options = {} );
+        /// Same triangles, moved vertices: new bounds, same tree. Quality drops
+        /// as the motion grows; build() again when queries slow down.
+        void            refit( const TriangleMesh& mesh );
+
+        Hit             intersect( const Ray& ray ) const;
+        /// Any hit in [tMin, tMax]; stops at the first one.
+        bool            occluded( const Ray& ray ) const;
+        /// W = 4 or 8. One traversal for the packet; each ray gets its own nearest hit.
+        template< int W >
+        void            intersect( const RayPacket<W>& rays, HitPacket<W>& hits ) const;
+
+        const std::vector<Node>&    nodes() const       { return (_nodes); }
+        size_t          triangleCount() const           { return (_triangles.size()); }
+        const BuildStats&   stats() const               { return (_stats); }
+
+    private:
+        void            gatherVertices( const TriangleMesh& mesh );
+        void            computeStats();
+
+        std::vector<Node>       _nodes;
+        std::vector<uint32_t>   _triangles;     // leaf order -> mesh triangle
+        std::vector<float>      _vertices;      // nine floats per triangle, leaf order
+        BuildStats              _stats;
+    };
+
+    /// The ray through pixel (x, y) of a width x height viewport, origin top
+    /// left as in RMDLUniforms::mouseState, from the near plane outwards.
+    Ray         rayThroughPixel( float x, float y, float width, float height, const simd::float4x4& inverseViewProjection );
+}
+
+#endif /* RMDLBVH_HPP */
@@ -27,7 +27,7 @@ static simd::float4 sPlaneNormalize( const simd::float4& inPlane )
     return (inPlane / simd::length(inPlane.xyz));
 }
 
-RMDLCamera::RMDLCamera() : _position{0, 0, 0}, _direction{0, 0, 1}, _up{0, 1, 0}, _viewAngle(0), _aspectRatio(1.0), _nearPlane(0.1f), _farPlane(100.0f), _width(0), _uniformsDirty(true)
+RMDLCamera::RMDLCamera() : _nearPlane(0.1f), _farPlane(100.0f), _aspectRatio(1.0), _viewAngle(0), _width(0), _up{0, 1, 0}, _position{0, 0, 0}, _direction{0, 0, 1}, _uniformsDirty(true)
 {
 }
 
@@ -11,9 +11,9 @@
 #ifndef RMDLCAMERA_HPP
 # define RMDLCAMERA_HPP
 
-# include <simd/simd.h>
+# include "RMDLSimd.hpp"
 
-# import "RMDLMainRenderer_shared.h"
+# include "RMDLMainRenderer_shared.h"
 
 class RMDLCamera
 {
@@ -0,0 +1,108 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLCameraSimulation.cpp     +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 01:58:47      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLCameraSimulation.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace simulation
+{
+
+static constexpr float kMaxPitch = 1.55f;   // just short of straight up or down
+
+void cameraForward( const CameraState& state, float out[3] )
+{
+    const float cosPitch = std::cos(state.pitch);
+    out[0] = cosPitch * std::sin(state.yaw);
+    out[1] = std::sin(state.pitch);
+    out[2] = -cosPitch * std::cos(state.yaw);
+}
+
+CameraState interpolate( const CameraState& a, const CameraState& b, float t )
+{
+    CameraState out = b;
+    for (int i = 0; i < 3; ++i)
+        out.position[i] = a.position[i] + (b.position[i] - a.position[i]) * t;
+    out.yaw = a.yaw + (b.yaw - a.yaw) * t;
+    out.pitch = a.pitch + (b.pitch - a.pitch) * t;
+    return (out);
+}
+
+CameraController::CameraController( float smoothing )
+: _smoothing( std::max(1e-4f, smoothing) )
+, _pLog( nullptr )
+{
+}
+
+void CameraController::queue( const CameraCommand& command )
+{
+    // Input arrives in step order; a late command (replay merged with live input)
+    // still lands in place.
+    auto it = std::upper_bound(_pending.begin(), _pending.end(), command.step,
+                               []( uint64_t step, const CameraCommand& c ) { return (step < c.step); });
+    if (it != _pending.begin() && (it - 1)->step == command.step)
+    {
+        CameraCommand& merged = *(it - 1);
+        for (int i = 0; i < 3; ++i)
+            merged.move[i] += command.move[i];
+        merged.yaw += command.yaw;
+        merged.pitch += command.pitch;
+        return;
+    }
+    _pending.insert(it, command);
+}
+
+void CameraController::replay( const std::vector<CameraCommand>& log )
+{
+    for (const CameraCommand& command : log)
+        queue(command);
+}
+
+void CameraController::step( CameraState& state, uint64_t stepIndex, double dt )
+{
+    // Commands stamped for a step already run apply now rather than never.
+    size_t consumed = 0;
+    while (consumed < _pending.size() && _pending[consumed].step <= stepIndex)
+    {
+        const CameraCommand& command = _pending[consumed++];
+        state.targetYaw += command.yaw;
+        state.targetPitch = std::clamp(state.targetPitch + command.pitch, -kMaxPitch, kMaxPitch);
+
+        // Moves are along the orientation the camera is heading to.
+        CameraState heading = state;
+        heading.yaw = state.targetYaw;
+        heading.pitch = state.targetPitch;
+        float forward[3];
+        cameraForward(heading, forward);
+        const float right[3] = { std::cos(state.targetYaw), 0.f, std::sin(state.targetYaw) };
+        for (int i = 0; i < 3; ++i)
+            state.targetPosition[i] += right[i] * command.move[0] - forward[i] * command.move[2];
+        state.targetPosition[1] += command.move[1];
+
+        if (_pLog)
+        {
+            CameraCommand applied = command;
+            applied.step = stepIndex;
+            _pLog->push_back(applied);
+        }
+    }
+    _pending.erase(_pending.begin(), _pending.begin() + (std::ptrdiff_t)consumed);
+
+    // Exponential easing; dt is fixed, so this factor is the same every step.
+    const float k = 1.f - (float)std::exp(-dt / (double)_smoothing);
+    for (int i = 0; i < 3; ++i)
+        state.position[i] += (state.targetPosition[i] - state.position[i]) * k;
+    state.yaw += (state.targetYaw - state.yaw) * k;
+    state.pitch += (state.targetPitch - state.pitch) * k;
+}
+
+}
@@ -0,0 +1,71 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLCameraSimulation.hpp     +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 01:58:40      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLCAMERASIMULATION_HPP
+# define RMDLCAMERASIMULATION_HPP
+
+# include <cstdint>
+# include <vector>
+
+// The fly camera as simulated state. Moves and turns are commands stamped with
+// the simulation step they apply to; each step adds them to a target and eases
+// the camera toward it, so the motion depends on steps and commands only, never
+// on the frame rate. The command log replays a session step for step.
+
+namespace simulation
+{
+    struct CameraState
+    {
+        float   position[3]         = { 0.f, 0.f, 0.f };
+        float   yaw                 = 0.f;      // radians around +Y, 0 looks down -Z
+        float   pitch               = 0.f;
+        float   targetPosition[3]   = { 0.f, 0.f, 0.f };
+        float   targetYaw           = 0.f;
+        float   targetPitch         = 0.f;
+    };
+
+    struct CameraCommand
+    {
+        uint64_t    step        = 0;
+        float       move[3]     = { 0.f, 0.f, 0.f };    // camera space: +X right, +Y up, +Z back
+        float       yaw         = 0.f;
+        float       pitch       = 0.f;
+    };
+
+    /// Unit vector the camera looks along.
+    void        cameraForward( const CameraState& state, float out[3] );
+    /// Blends position and orientation; the targets are taken from `b`.
+    CameraState interpolate( const CameraState& a, const CameraState& b, float t );
+
+    class CameraController
+    {
+    public:
+        /// `smoothing` is the time constant of the easing, in seconds.
+        explicit CameraController( float smoothing = 0.05f );
+
+        /// Applies at step `step`; commands for the same step add up.
+        void        queue( const CameraCommand& command );
+        /// One fixed step: FixedStepLoop's step function.
+        void        step( CameraState& state, uint64_t stepIndex, double dt );
+
+        /// Applied commands are appended to `pLog`, in step order, until it is set
+        /// to null; nothing is kept otherwise.
+        void        record( std::vector<CameraCommand>* pLog )     { _pLog = pLog; }
+        /// Queues a recorded log instead of live input.
+        void        replay( const std::vector<CameraCommand>& log );
+
+    private:
+        float                       _smoothing;
+        std::vector<CameraCommand>  _pending;   // by step
+        std::vector<CameraCommand>* _pLog;
+    };
+}
+
+#endif /* RMDLCAMERASIMULATION_HPP */
@@ -0,0 +1,237 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLCommandRecorder.cpp      +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 22:16:38      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLCommandRecorder.hpp"
+#include "RMDLParallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <queue>
+
+namespace command_recording
+{
+
+bool submissionOrder( const std::vector<RecordJob>& jobs, std::vector<uint32_t>& order )
+{
+    const uint32_t count = (uint32_t)jobs.size();
+    std::vector<uint32_t> pending(count, 0);
+    std::vector<std::vector<uint32_t>> dependents(count);
+    for (uint32_t j = 0; j < count; ++j)
+    {
+        for (uint32_t before : jobs[j].after)
+        {
+            if (before >= count || before == j)
+                continue;
+            dependents[before].push_back(j);
+            ++pending[j];
+        }
+    }
+
+    // Kahn's algorithm, lowest index first, so jobs without dependencies keep their order.
+    std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<uint32_t>> ready;
+    for (uint32_t j = 0; j < count; ++j)
+        if (pending[j] == 0)
+            ready.push(j);
+    order.clear();
+    order.reserve(count);
+    std::vector<bool> placed(count, false);
+    while (!ready.empty())
+    {
+        const uint32_t j = ready.top();
+        ready.pop();
+        order.push_back(j);
+        placed[j] = true;
+        for (uint32_t d : dependents[j])
+            if (--pending[d] == 0)
+                ready.push(d);
+    }
+    if (order.size() == count)
+        return (true);
+    for (uint32_t j = 0; j < count; ++j)
+        if (!placed[j])
+            order.push_back(j);
+    return (false);
+}
+
+#pragma mark - ParallelRecorder
+
+ParallelRecorder::ParallelRecorder( RecordingBackend& backend, uint32_t framesInFlight )
+: ParallelRecorder( backend, framesInFlight, parallel::defaultPool() )
+{
+}
+
+ParallelRecorder::ParallelRecorder( RecordingBackend& backend, uint32_t framesInFlight, parallel::ThreadPool& pool )
+: _backend( backend )
+, _pool( pool )
+, _frames( std::max(1u, framesInFlight) )
+, _currentFrame( 0 )
+{
+}
+
+ParallelRecorder::~ParallelRecorder()
+{
+    for (FramePool& frame : _frames)
+    {
+        for (void* pAllocator : frame.all)
+        {
+            _backend.releaseAllocator(pAllocator);
+        }
+    }
+}
+
+void ParallelRecorder::beginFrame( uint64_t frameIndex )
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _currentFrame = (uint32_t)(frameIndex % _frames.size());
+    FramePool& frame = _frames[_currentFrame];
+    for (void* pAllocator : frame.all)
+    {
+        _backend.resetAllocator(pAllocator);
+    }
+    frame.free = frame.all;
+}
+
+void* ParallelRecorder::leaseAllocator()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        FramePool& frame = _frames[_currentFrame];
+        if (!frame.free.empty())
+        {
+            void* pAllocator = frame.free.back();
+            frame.free.pop_back();
+            return (pAllocator);
+        }
+    }
+    void* pAllocator = _backend.newAllocator();
+    std::lock_guard<std::mutex> lock(_mutex);
+    _frames[_currentFrame].all.push_back(pAllocator);
+    ++_stats.allocators;
+    return (pAllocator);
+}
+
+void ParallelRecorder::returnAllocator( void* pAllocator )
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _frames[_currentFrame].free.push_back(pAllocator);
+}
+
+bool ParallelRecorder::record( const std::vector<RecordJob>& jobs )
+{
+    // State shared with the pool jobs. A pool job that starts after everything was
+    // claimed only touches `next`, so it may outlive this call.
+    struct Shared
+    {
+        std::vector<uint32_t>       order;
+        std::atomic<uint32_t>       next { 0 };
+        std::mutex                  mutex;
+        std::condition_variable     changed;
+        std::vector<void*>          commandBuffers;     // per job, once recorded
+        uint32_t                    recording = 0;      // threads holding an allocator
+        uint32_t                    maxRecording = 0;
+    };
+    std::shared_ptr<Shared> pShared = std::make_shared<Shared>();
+    const bool acyclic = submissionOrder(jobs, pShared->order);
+    const uint32_t count = (uint32_t)jobs.size();
+    if (count == 0)
+        return (acyclic);
+    pShared->commandBuffers.assign(count, nullptr);
+
+    // Jobs are claimed in commit order, so the front of the order is ready first.
+    const std::vector<RecordJob>* pJobs = &jobs;
+    const auto drain = [this, pJobs]( Shared& shared, const std::function<void()>& afterEach ) {
+        void* pAllocator = nullptr;
+        for (;;)
+        {
+            const uint32_t slot = shared.next.fetch_add(1, std::memory_order_relaxed);
+            if (slot >= shared.order.size())
+                break;
+            if (!pAllocator)
+            {
+                pAllocator = leaseAllocator();
+                std::lock_guard<std::mutex> lock(shared.mutex);
+                shared.maxRecording = std::max(shared.maxRecording, ++shared.recording);
+            }
+            const uint32_t job = shared.order[slot];
+            void* pCommandBuffer = _backend.beginCommandBuffer(pAllocator);
+            (*pJobs)[job].record(pCommandBuffer);
+            _backend.endCommandBuffer(pCommandBuffer);
+            {
+                std::lock_guard<std::mutex> lock(shared.mutex);
+                shared.commandBuffers[job] = pCommandBuffer;
+            }
+            shared.changed.notify_all();
+            if (afterEach)
+                afterEach();
+        }
+        if (pAllocator)
+        {
+            returnAllocator(pAllocator);
+            {
+                std::lock_guard<std::mutex> lock(shared.mutex);
+                --shared.recording;
+            }
+            shared.changed.notify_all();
+        }
+    };
+
+    const uint32_t helpers = std::min<uint32_t>(_pool.size(), count - 1);
+    for (uint32_t i = 0; i < helpers; ++i)
+    {
+        _pool.enqueue( [pShared, drain]() { drain(*pShared, {}); } );
+    }
+
+    // The calling thread records too, and commits whatever prefix of the order is ready.
+    uint32_t submitted = 0;
+    uint64_t submits = 0;
+    std::vector<void*> ready;
+    const auto flush = [&]() {
+        ready.clear();
+        {
+            std::lock_guard<std::mutex> lock(pShared->mutex);
+            while (submitted < count && pShared->commandBuffers[pShared->order[submitted]])
+                ready.push_back(pShared->commandBuffers[pShared->order[submitted++]]);
+        }
+        if (!ready.empty())
+        {
+            _backend.submit(ready.data(), ready.size());
+            ++submits;
+        }
+    };
+    drain(*pShared, flush);
+    for (;;)
+    {
+        flush();
+        std::unique_lock<std::mutex> lock(pShared->mutex);
+        if (submitted == count && pShared->recording == 0)
+            break;
+        pShared->changed.wait(lock, [&]() {
+            return ((submitted < count && pShared->commandBuffers[pShared->order[submitted]]) ||
+                    (submitted == count && pShared->recording == 0));
+        });
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.jobs += count;
+    _stats.submits += submits;
+    _stats.maxConcurrent = std::max(_stats.maxConcurrent, pShared->maxRecording);
+    return (acyclic);
+}
+
+RecorderStats ParallelRecorder::stats() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return (_stats);
+}
+
+}
@@ -0,0 +1,108 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLCommandRecorder.hpp      +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 22:16:31      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLCOMMANDRECORDER_HPP
+# define RMDLCOMMANDRECORDER_HPP
+
+# include <cstdint>
+# include <functional>
+# include <mutex>
+# include <vector>
+
+# include "NonCopyable.h"
+
+// Command buffers recorded on several threads at once. Each recording thread
+// leases one allocator from the pool of the current frame and keeps it for as
+// long as it takes jobs; the pool is reset when that frame comes round again.
+// Command buffers are committed in a fixed order that respects the jobs'
+// dependencies, each as soon as everything before it is recorded. No Metal
+// here; RMDLMetalRecordingBackend talks to the queue.
+
+namespace parallel
+{
+    class ThreadPool;
+}
+
+namespace command_recording
+{
+    /// Allocators, command buffers and the queue. Everything but submit() is
+    /// called from worker threads, never twice at once on the same allocator.
+    class RecordingBackend
+    {
+    public:
+        virtual         ~RecordingBackend() = default;
+
+        virtual void*   newAllocator() = 0;
+        virtual void    resetAllocator( void* pAllocator ) = 0;
+        virtual void    releaseAllocator( void* pAllocator ) = 0;
+
+        /// A new command buffer, begun on `pAllocator`.
+        virtual void*   beginCommandBuffer( void* pAllocator ) = 0;
+        virtual void    endCommandBuffer( void* pCommandBuffer ) = 0;
+        /// Commits in array order and takes ownership. Called from the recording thread only.
+        virtual void    submit( void* const* pCommandBuffers, size_t count ) = 0;
+    };
+
+    struct RecordJob
+    {
+        std::function<void( void* pCommandBuffer )>    record;
+        std::vector<uint32_t>                          after;      // jobs committed before this one
+    };
+
+    struct RecorderStats
+    {
+        uint64_t    jobs            = 0;
+        uint64_t    submits         = 0;    // backend submit() calls
+        uint32_t    allocators      = 0;    // over every frame
+        uint32_t    maxConcurrent   = 0;    // most threads recording at once
+    };
+
+    class ParallelRecorder : public NonCopyable
+    {
+    public:
+        ParallelRecorder( RecordingBackend& backend, uint32_t framesInFlight );
+        ParallelRecorder( RecordingBackend& backend, uint32_t framesInFlight, parallel::ThreadPool& pool );
+        ~ParallelRecorder();
+
+        /// Resets the allocators of this frame's pool. The GPU must be done with
+        /// what was recorded `framesInFlight` frames ago.
+        void            beginFrame( uint64_t frameIndex );
+
+        /// Records every job on the pool and the calling thread, and submits them.
+        /// Returns once everything is committed. False if `after` has a cycle; the
+        /// jobs on it are then committed in index order.
+        bool            record( const std::vector<RecordJob>& jobs );
+
+        RecorderStats   stats() const;
+
+    private:
+        struct FramePool
+        {
+            std::vector<void*>  all;
+            std::vector<void*>  free;
+        };
+
+        void*           leaseAllocator();
+        void            returnAllocator( void* pAllocator );
+
+        RecordingBackend&       _backend;
+        parallel::ThreadPool&   _pool;
+        std::vector<FramePool>  _frames;
+        uint32_t                _currentFrame;
+        mutable std::mutex      _mutex;
+        RecorderStats           _stats;
+    };
+
+    /// Commit order: every job after the ones it depends on, otherwise by index.
+    /// False on a cycle, in which case the remaining jobs follow in index order.
+    bool    submissionOrder( const std::vector<RecordJob>& jobs, std::vector<uint32_t>& order );
+}
+
+#endif /* RMDLCOMMANDRECORDER_HPP */
@@ -6,11 +6,13 @@
 #import <CoreMotion/CoreMotion.h>
 #import <GameController/GameController.h>
 
+#include <atomic>
 #include <unordered_map>
 
 #include <simd/simd.h>
 
 #include "NonCopyable.h"
+#include "RMDLInput.hpp"
 #import "Haptics.h"
 
 namespace MTL
@@ -41,9 +43,24 @@ public:
     void  renderOverlay( MTL::RenderCommandEncoder* pEnc );
     
     simd::float3 accelerometerData() const;
+
+    /// Also forwards every change as a timestamped event; null to stop. The
+    /// handlers run on the main queue, the producer side of the queue.
+    void setEventSink( input::InputQueue* pSink ) { _pEventSink.store(pSink, std::memory_order_release); }
+
 private:
+    void        registerKeyboard( GCKeyboard* keyboard );
+    void        registerGamepad( GCController* controller );
+    void        setButton( input::Button button, bool down );
+    void        setAxis( input::Axis axis, float value );
+
     CFTypeRef   _haptics;
     CFTypeRef   _motionManager;
+
+    // Kept current by the GameController handlers, so queries are plain loads.
+    std::atomic<uint32_t>           _buttons;
+    std::atomic<float>              _axes[input::kAxisCount];
+    std::atomic<input::InputQueue*> _pEventSink;
 };
 
 #endif // RMDLCONTROLLER_H
@@ -1,5 +1,7 @@
 #include "RMDLController.h"
 
+#include <time.h>
+
 typedef NS_OPTIONS(uint8_t, Controls) // QWERTY
 {
     // Keycodes that control translation
@@ -30,10 +32,33 @@ typedef NS_OPTIONS(uint8_t, Controls) // QWERTY
     inventory           = 0x0f  // R Key
 };
 
+static bool buttonForKeyCode( GCKeyCode keyCode, input::Button* pButton )
+{
+    if (keyCode == GCKeyCodeKeyW)               *pButton = input::Button::KeyW;
+    else if (keyCode == GCKeyCodeKeyA)          *pButton = input::Button::KeyA;
+    else if (keyCode == GCKeyCodeKeyS)          *pButton = input::Button::KeyS;
+    else if (keyCode == GCKeyCodeKeyD)          *pButton = input::Button::KeyD;
+    else if (keyCode == GCKeyCodeKeyQ)          *pButton = input::Button::KeyQ;
+    else if (keyCode == GCKeyCodeKeyE)          *pButton = input::Button::KeyE;
+    else if (keyCode == GCKeyCodeKeyX)          *pButton = input::Button::KeyX;
+    else if (keyCode == GCKeyCodeSpacebar)      *pButton = input::Button::Space;
+    else if (keyCode == GCKeyCodeLeftArrow)     *pButton = input::Button::LeftArrow;
+    else if (keyCode == GCKeyCodeRightArrow)    *pButton = input::Button::RightArrow;
+    else if (keyCode == GCKeyCodeUpArrow)       *pButton = input::Button::UpArrow;
+    else if (keyCode == GCKeyCodeDownArrow)     *pButton = input::Button::DownArrow;
+    else return (false);
+    return (true);
+}
+
 GameController::GameController()
 : _haptics(nil)
 , _motionManager(nil)
+, _buttons(0)
+, _pEventSink(nullptr)
 {
+    for (std::atomic<float>& axis : _axes)
+        axis.store(0.f, std::memory_order_relaxed);
+
     [NSNotificationCenter.defaultCenter addObserverForName:GCControllerDidDisconnectNotification
                                                     object:nil
                                                      queue:nil
@@ -50,12 +75,23 @@ GameController::GameController()
     
     __block GameController* pOwner = this;
     
+    [NSNotificationCenter.defaultCenter addObserverForName:GCKeyboardDidConnectNotification
+                                                    object: nil
+                                                     queue: nil
+                                                usingBlock:^(NSNotification * _Nonnull notification) {
+        pOwner->registerKeyboard((GCKeyboard *)(notification.object));
+    }];
+    registerKeyboard(GCKeyboard.coalescedKeyboard);
+    for (GCController* controller in GCController.controllers)
+        registerGamepad(controller);
+
     [NSNotificationCenter.defaultCenter addObserverForName:GCControllerDidConnectNotification
                                                     object: nil
                                                      queue: nil
                                                 usingBlock:^(NSNotification * _Nonnull notification) {
         
         GCController* controller = (GCController *)(notification.object);
+        pOwner->registerGamepad(controller);
         if (controller.haptics)
         {
             CHHapticEngine* hapticEngine =
@@ -91,60 +127,124 @@ simd::float3 GameController::accelerometerData() const
     return ( simd::float3{ 0, 0, 0 } );
 }
 
+void GameController::registerKeyboard( GCKeyboard* keyboard )
+{
+    if (!keyboard)
+        return;
+    GameController* pOwner = this;
+    keyboard.keyboardInput.keyChangedHandler = ^(GCKeyboardInput* _Nonnull, GCControllerButtonInput* _Nonnull, GCKeyCode keyCode, BOOL pressed) {
+        input::Button button;
+        if (buttonForKeyCode(keyCode, &button))
+            pOwner->setButton(button, pressed);
+    };
+}
+
+void GameController::registerGamepad( GCController* controller )
+{
+    if (!controller.extendedGamepad)
+        return;
+    GameController* pOwner = this;
+    controller.extendedGamepad.valueChangedHandler = ^(GCExtendedGamepad* _Nonnull gamepad, GCControllerElement* _Nonnull element) {
+        if (element == gamepad.buttonA)
+            pOwner->setButton(input::Button::PadA, gamepad.buttonA.pressed);
+        else if (element == gamepad.buttonB)
+            pOwner->setButton(input::Button::PadB, gamepad.buttonB.pressed);
+        else if (element == gamepad.buttonX)
+            pOwner->setButton(input::Button::PadX, gamepad.buttonX.pressed);
+        else if (element == gamepad.buttonY)
+            pOwner->setButton(input::Button::PadY, gamepad.buttonY.pressed);
+        else if (element == gamepad.leftThumbstick)
+        {
+            pOwner->setAxis(input::Axis::LeftStickX, gamepad.leftThumbstick.xAxis.value);
+            pOwner->setAxis(input::Axis::LeftStickY, gamepad.leftThumbstick.yAxis.value);
+        }
+        else if (element == gamepad.rightThumbstick)
+        {
+            pOwner->setAxis(input::Axis::RightStickX, gamepad.rightThumbstick.xAxis.value);
+            pOwner->setAxis(input::Axis::RightStickY, gamepad.rightThumbstick.yAxis.value);
+        }
+    };
+}
+
+// Handlers only report changes, so every call here is an edge or a new value.
+void GameController::setButton( input::Button button, bool down )
+{
+    const uint32_t bit = 1u << (uint32_t)button;
+    const uint32_t previous = down ? _buttons.fetch_or(bit, std::memory_order_relaxed)
+                                   : _buttons.fetch_and(~bit, std::memory_order_relaxed);
+    input::InputQueue* pSink = _pEventSink.load(std::memory_order_acquire);
+    if (!pSink || (bool)(previous & bit) == down)
+        return;
+    input::InputEvent event;
+    event.time = (double)clock_gettime_nsec_np(CLOCK_UPTIME_RAW) * 1e-9;
+    event.type = down ? input::EventType::ButtonDown : input::EventType::ButtonUp;
+    event.code = (uint8_t)button;
+    pSink->post(event);
+}
+
+void GameController::setAxis( input::Axis axis, float value )
+{
+    if (_axes[(uint32_t)axis].exchange(value, std::memory_order_relaxed) == value)
+        return;
+    input::InputQueue* pSink = _pEventSink.load(std::memory_order_acquire);
+    if (!pSink)
+        return;
+    input::InputEvent event;
+    event.time = (double)clock_gettime_nsec_np(CLOCK_UPTIME_RAW) * 1e-9;
+    event.type = input::EventType::AxisValue;
+    event.code = (uint8_t)axis;
+    event.value[0] = value;
+    pSink->post(event);
+}
+
 bool GameController::isLeftArrowDown() const
 {
-    return ( [GCKeyboard.coalescedKeyboard.keyboardInput buttonForKeyCode:GCKeyCodeLeftArrow].pressed );
+    return ((_buttons.load(std::memory_order_relaxed) >> (uint32_t)input::Button::LeftArrow) & 1u);
 }
 
 bool GameController::isRightArrowDown() const
 {
-    return [GCKeyboard.coalescedKeyboard.keyboardInput buttonForKeyCode:GCKeyCodeRightArrow].pressed;
+    return ((_buttons.load(std::memory_order_relaxed) >> (uint32_t)input::Button::RightArrow) & 1u);
 }
 
 bool GameController::isSpacebarDown() const
 {
-    return [GCKeyboard.coalescedKeyboard.keyboardInput buttonForKeyCode:GCKeyCodeSpacebar].pressed;
+    return ((_buttons.load(std::memory_order_relaxed) >> (uint32_t)input::Button::Space) & 1u);
 }
 
 bool GameController::isXMacDown() const
 {
-    return [GCKeyboard.coalescedKeyboard.keyboardInput buttonForKeyCode:GCKeyCodeKeyX].pressed;
+    return ((_buttons.load(std::memory_order_relaxed) >> (uint32_t)input::Button::KeyX) & 1u);
 }
 
 float GameController::leftThumbstickX() const
 {
-    GCExtendedGamepad* gamepad = GCController.controllers.firstObject.extendedGamepad;
-    return gamepad.leftThumbstick.xAxis.value;
+    return (_axes[(uint32_t)input::Axis::LeftStickX].load(std::memory_order_relaxed));
 }
 
 float GameController::rightThumbstickX() const
 {
-    GCExtendedGamepad* gamepad = GCController.controllers.firstObject.extendedGamepad;
-    return gamepad.rightThumbstick.xAxis.value;
+    return (_axes[(uint32_t)input::Axis::RightStickX].load(std::memory_order_relaxed));
 }
 
 bool GameController::isButtonADown() const
 {
-    GCExtendedGamepad* gamepad = GCController.controllers.firstObject.extendedGamepad;
-    return gamepad.buttonA.pressed;
+    return ((_buttons.load(std::memory_order_relaxed) >> (uint32_t)input::Button::PadA) & 1u);
 }
 
 bool GameController::isButtonBDown() const
 {
-    GCExtendedGamepad* gamepad = GCController.controllers.firstObject.extendedGamepad;
-    return (gamepad.buttonB.pressed);
+    return ((_buttons.load(std::memory_order_relaxed) >> (uint32_t)input::Button::PadB) & 1u);
 }
 
 bool GameController::isButtonXDown() const
 {
-    GCExtendedGamepad* gamepad = GCController.controllers.firstObject.extendedGamepad;
-    return (gamepad.buttonX.pressed);
+    return ((_buttons.load(std::memory_order_relaxed) >> (uint32_t)input::Button::PadX) & 1u);
 }
 
 bool GameController::isButtonYDown() const
 {
-    GCExtendedGamepad* gamepad = GCController.controllers.firstObject.extendedGamepad;
-    return (gamepad.buttonY.pressed);
+    return ((_buttons.load(std::memory_order_relaxed) >> (uint32_t)input::Button::PadY) & 1u);
 }
 
 void GameController::setHapticIntensity(float intensity) const
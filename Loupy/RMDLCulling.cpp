@@ -0,0 +1,280 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLCulling.cpp              +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 23:02:25      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLCulling.hpp"
+#include "RMDLParallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#if defined(__ARM_NEON)
+# include <arm_neon.h>
+#elif defined(__SSE2__)
+# include <immintrin.h>
+#endif
+
+namespace culling
+{
+
+namespace
+{
+    constexpr size_t kChunkSize = 16384;    // instances per parallel job, a multiple of 4
+
+    // Four instances per register, one per lane. fmadd is always fused, like the
+    // kernel's precise::fma, so every lane rounds exactly as the GPU does.
+#if defined(__ARM_NEON)
+    using Lanes = float32x4_t;
+
+    inline Lanes    splat( float s )                    { return (vdupq_n_f32(s)); }
+    inline Lanes    negate( Lanes a )                   { return (vnegq_f32(a)); }
+    inline Lanes    fmadd( Lanes a, Lanes b, Lanes c )  { return (vfmaq_f32(c, a, b)); }
+    inline uint32_t greaterEqualMask( Lanes a, Lanes b )
+    {
+        static const uint32_t kBits[4] = { 1, 2, 4, 8 };
+        return (vaddvq_u32(vandq_u32(vcgeq_f32(a, b), vld1q_u32(kBits))));
+    }
+    inline void     loadSpheres( const RMDLCullInstance* p, Lanes& x, Lanes& y, Lanes& z, Lanes& r )
+    {
+        const float32x4x2_t t01 = vtrnq_f32(vld1q_f32(p[0].boundingSphere), vld1q_f32(p[1].boundingSphere));
+        const float32x4x2_t t23 = vtrnq_f32(vld1q_f32(p[2].boundingSphere), vld1q_f32(p[3].boundingSphere));
+        x = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+        y = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+        z = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+        r = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+    }
+#elif defined(__SSE2__)
+    using Lanes = __m128;
+
+    inline Lanes    splat( float s )                    { return (_mm_set1_ps(s)); }
+    inline Lanes    negate( Lanes a )                   { return (_mm_xor_ps(a, _mm_set1_ps(-0.f))); }
+    inline Lanes    fmadd( Lanes a, Lanes b, Lanes c )
+    {
+# if defined(__FMA__)
+        return (_mm_fmadd_ps(a, b, c));
+# else
+        alignas(16) float fa[4], fb[4], fc[4];
+        _mm_store_ps(fa, a);
+        _mm_store_ps(fb, b);
+        _mm_store_ps(fc, c);
+        for (int i = 0; i < 4; ++i)
+            fc[i] = std::fma(fa[i], fb[i], fc[i]);
+        return (_mm_load_ps(fc));
+# endif
+    }
+    inline uint32_t greaterEqualMask( Lanes a, Lanes b ) { return ((uint32_t)_mm_movemask_ps(_mm_cmpge_ps(a, b))); }
+    inline void     loadSpheres( const RMDLCullInstance* p, Lanes& x, Lanes& y, Lanes& z, Lanes& r )
+    {
+        x = _mm_loadu_ps(p[0].boundingSphere);
+        y = _mm_loadu_ps(p[1].boundingSphere);
+        z = _mm_loadu_ps(p[2].boundingSphere);
+        r = _mm_loadu_ps(p[3].boundingSphere);
+        _MM_TRANSPOSE4_PS(x, y, z, r);
+    }
+#else
+    struct Lanes
+    {
+        float v[4];
+    };
+
+    inline Lanes    splat( float s )                    { return { { s, s, s, s } }; }
+    inline Lanes    negate( Lanes a )                   { return { { -a.v[0], -a.v[1], -a.v[2], -a.v[3] } }; }
+    inline Lanes    fmadd( Lanes a, Lanes b, Lanes c )
+    {
+        Lanes out;
+        for (int i = 0; i < 4; ++i)
+            out.v[i] = std::fma(a.v[i], b.v[i], c.v[i]);
+        return (out);
+    }
+    inline uint32_t greaterEqualMask( Lanes a, Lanes b )
+    {
+        uint32_t mask = 0;
+        for (int i = 0; i < 4; ++i)
+            mask |= (a.v[i] >= b.v[i] ? 1u : 0u) << i;
+        return (mask);
+    }
+    inline void     loadSpheres( const RMDLCullInstance* p, Lanes& x, Lanes& y, Lanes& z, Lanes& r )
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            x.v[i] = p[i].boundingSphere[0];
+            y.v[i] = p[i].boundingSphere[1];
+            z.v[i] = p[i].boundingSphere[2];
+            r.v[i] = p[i].boundingSphere[3];
+        }
+    }
+#endif
+
+    /// Visibility bits of instances [first, first + 4).
+    inline uint32_t visibleMask4( const RMDLCullParams& params, const RMDLCullInstance* pInstances, size_t first )
+    {
+        Lanes x, y, z, r;
+        loadSpheres(pInstances + first, x, y, z, r);
+        const Lanes minusR = negate(r);
+        uint32_t mask = 0xF;
+        for (int p = 0; p < 6; ++p)
+        {
+            const float* plane = params.frustumPlanes[p];
+            const Lanes t = fmadd(splat(plane[2]), z, fmadd(splat(plane[1]), y, fmadd(splat(plane[0]), x, splat(plane[3]))));
+            mask &= greaterEqualMask(t, minusR);
+        }
+        for (int i = 0; i < 4; ++i)
+        {
+            if (pInstances[first + i].meshIndex >= params.meshCount)
+                mask &= ~(1u << i);
+        }
+        return (mask);
+    }
+
+    using MaskFunction = uint32_t (*)( const RMDLCullParams& params, const RMDLCullInstance* pInstances, size_t first );
+
+#if defined(__SSE2__) && !defined(__ARM_NEON) && !defined(__FMA__) && (defined(__GNUC__) || defined(__clang__))
+    // Baseline x86-64 builds (the Intel slice of a universal binary) have no FMA at
+    // compile time, and emulating it lane by lane loses to the scalar test, which
+    // stops at the first plane. Use the instruction when the CPU has it.
+    __attribute__((target("fma")))
+    uint32_t visibleMask4Fma( const RMDLCullParams& params, const RMDLCullInstance* pInstances, size_t first )
+    {
+        Lanes x, y, z, r;
+        loadSpheres(pInstances + first, x, y, z, r);
+        const Lanes minusR = negate(r);
+        uint32_t mask = 0xF;
+        for (int p = 0; p < 6; ++p)
+        {
+            const float* plane = params.frustumPlanes[p];
+            const Lanes t = _mm_fmadd_ps(splat(plane[2]), z, _mm_fmadd_ps(splat(plane[1]), y, _mm_fmadd_ps(splat(plane[0]), x, splat(plane[3]))));
+            mask &= greaterEqualMask(t, minusR);
+        }
+        for (int i = 0; i < 4; ++i)
+        {
+            if (pInstances[first + i].meshIndex >= params.meshCount)
+                mask &= ~(1u << i);
+        }
+        return (mask);
+    }
+
+    uint32_t visibleMask4Scalar( const RMDLCullParams& params, const RMDLCullInstance* pInstances, size_t first )
+    {
+        uint32_t mask = 0;
+        for (int i = 0; i < 4; ++i)
+            mask |= (sphereVisible(params, pInstances[first + i]) ? 1u : 0u) << i;
+        return (mask);
+    }
+
+    MaskFunction maskFunction()
+    {
+        return (__builtin_cpu_supports("fma") ? visibleMask4Fma : visibleMask4Scalar);
+    }
+#else
+    MaskFunction maskFunction()
+    {
+        return (visibleMask4);
+    }
+#endif
+
+    inline RMDLDrawIndexedArguments drawFor( const RMDLCullMesh& mesh, uint32_t instance )
+    {
+        return { mesh.indexCount, 1, mesh.indexStart, mesh.baseVertex, instance };
+    }
+}
+
+bool sphereVisible( const RMDLCullParams& params, const RMDLCullInstance& instance )
+{
+    if (instance.meshIndex >= params.meshCount)
+        return (false);
+    const float* c = instance.boundingSphere;
+    for (int p = 0; p < 6; ++p)
+    {
+        const float* plane = params.frustumPlanes[p];
+        const float t = std::fma(plane[2], c[2], std::fma(plane[1], c[1], std::fma(plane[0], c[0], plane[3])));
+        if (!(t >= -c[3]))
+            return (false);
+    }
+    return (true);
+}
+
+uint32_t cullAndCompactScalar( const RMDLCullParams& params, const RMDLCullInstance* pInstances,
+                               const RMDLCullMesh* pMeshes, RMDLDrawIndexedArguments* pArguments )
+{
+    uint32_t written = 0;
+    for (uint32_t i = 0; i < params.instanceCount; ++i)
+    {
+        if (sphereVisible(params, pInstances[i]))
+            pArguments[written++] = drawFor(pMeshes[pInstances[i].meshIndex], i);
+    }
+    return (written);
+}
+
+uint32_t cullAndCompact( const RMDLCullParams& params, const RMDLCullInstance* pInstances,
+                         const RMDLCullMesh* pMeshes, RMDLDrawIndexedArguments* pArguments )
+{
+    return (cullAndCompact(params, pInstances, pMeshes, pArguments, parallel::defaultPool()));
+}
+
+uint32_t cullAndCompact( const RMDLCullParams& params, const RMDLCullInstance* pInstances,
+                         const RMDLCullMesh* pMeshes, RMDLDrawIndexedArguments* pArguments,
+                         parallel::ThreadPool& pool )
+{
+    // Same shape as the kernels: count per chunk, scan, then write each chunk at its
+    // offset, so the order is the instance order whatever the thread count.
+    const size_t count = params.instanceCount;
+    const size_t chunkCount = (count + kChunkSize - 1) / kChunkSize;
+    std::vector<uint8_t> masks((count + 3) / 4);
+    std::vector<uint32_t> offsets(chunkCount + 1, 0);
+    const MaskFunction visibleMask = maskFunction();
+
+    pool.forRange(chunkCount, 1, [&]( size_t begin, size_t end ) {
+        for (size_t chunk = begin; chunk < end; ++chunk)
+        {
+            const size_t first = chunk * kChunkSize;
+            const size_t last = std::min(count, first + kChunkSize);
+            uint32_t visible = 0;
+            size_t i = first;
+            for (; i + 4 <= last; i += 4)
+            {
+                const uint32_t mask = visibleMask(params, pInstances, i);
+                masks[i / 4] = (uint8_t)mask;
+                visible += (uint32_t)__builtin_popcount(mask);
+            }
+            if (i < last)
+            {
+                uint32_t mask = 0;
+                for (size_t k = i; k < last; ++k)
+                    mask |= (sphereVisible(params, pInstances[k]) ? 1u : 0u) << (k - i);
+                masks[i / 4] = (uint8_t)mask;
+                visible += (uint32_t)__builtin_popcount(mask);
+            }
+            offsets[chunk + 1] = visible;
+        }
+    });
+
+    for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+        offsets[chunk + 1] += offsets[chunk];
+
+    pool.forRange(chunkCount, 1, [&]( size_t begin, size_t end ) {
+        for (size_t chunk = begin; chunk < end; ++chunk)
+        {
+            const size_t first = chunk * kChunkSize;
+            const size_t last = std::min(count, first + kChunkSize);
+            RMDLDrawIndexedArguments* pOut = pArguments + offsets[chunk];
+            for (size_t group = first; group < last; group += 4)
+            {
+                for (uint32_t mask = masks[group / 4]; mask; mask &= mask - 1)
+                {
+                    const uint32_t i = (uint32_t)group + (uint32_t)__builtin_ctz(mask);
+                    *pOut++ = drawFor(pMeshes[pInstances[i].meshIndex], i);
+                }
+            }
+        }
+    });
+    return (offsets[chunkCount]);
+}
+
+}
@@ -0,0 +1,48 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLCulling.hpp              +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 23:02:18      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLCULLING_HPP
+# define RMDLCULLING_HPP
+
+# include <cstddef>
+# include <cstdint>
+
+# include "RMDLCulling_shared.h"
+
+// CPU reference of the GPU culling in Culling.metal: frustum-test every instance's
+// bounding sphere and write one indexed draw per survivor, in instance order. The
+// arithmetic is the kernel's, fused multiply-adds included, so both produce the
+// same argument buffer bit for bit; the CPU path validates the GPU one and stands
+// in for it.
+
+namespace parallel
+{
+    class ThreadPool;
+}
+
+namespace culling
+{
+    /// The kernel's test: visible unless one plane has the whole sphere behind it.
+    bool        sphereVisible( const RMDLCullParams& params, const RMDLCullInstance& instance );
+
+    /// One instance at a time on one thread; the definition the others are checked against.
+    uint32_t    cullAndCompactScalar( const RMDLCullParams& params, const RMDLCullInstance* pInstances,
+                                      const RMDLCullMesh* pMeshes, RMDLDrawIndexedArguments* pArguments );
+
+    /// SIMD, four instances per step, split over the pool. `pArguments` holds
+    /// params.instanceCount entries; returns how many were written.
+    uint32_t    cullAndCompact( const RMDLCullParams& params, const RMDLCullInstance* pInstances,
+                                const RMDLCullMesh* pMeshes, RMDLDrawIndexedArguments* pArguments );
+    uint32_t    cullAndCompact( const RMDLCullParams& params, const RMDLCullInstance* pInstances,
+                                const RMDLCullMesh* pMeshes, RMDLDrawIndexedArguments* pArguments,
+                                parallel::ThreadPool& pool );
+}
+
+#endif /* RMDLCULLING_HPP */
@@ -0,0 +1,74 @@
+//
+//  RMDLCulling_shared.h
+//  Loupy
+//
+//  Created by Rémy on 19/10/2026.
+//
+
+#ifndef RMDLCulling_shared_h
+#define RMDLCulling_shared_h
+
+// Layouts shared by Culling.metal and the CPU reference in RMDLCulling.cpp.
+// Plain arrays rather than simd types so the CPU side builds anywhere.
+
+#ifndef __METAL_VERSION__
+# include <stdint.h>
+#endif
+
+#define kCullThreadgroupSize    256
+#define kCullScanThreadgroupSize 1024
+
+struct RMDLCullInstance
+{
+    float       boundingSphere[4];      // world-space centre xyz, radius w
+    uint32_t    meshIndex;
+    uint32_t    pad[3];
+};
+
+struct RMDLCullMesh
+{
+    uint32_t    indexCount;
+    uint32_t    indexStart;
+    int32_t     baseVertex;
+    uint32_t    pad;
+};
+
+struct RMDLCullParams
+{
+    float       frustumPlanes[6][4];    // RMDLCameraUniforms::frustumPlanes, normals inward
+    uint32_t    instanceCount;
+    uint32_t    meshCount;
+    uint32_t    groupCount;             // ceil(instanceCount / kCullThreadgroupSize)
+    uint32_t    pad;
+};
+
+// Same layout as MTLDrawIndexedPrimitivesIndirectArguments.
+struct RMDLDrawIndexedArguments
+{
+    uint32_t    indexCount;
+    uint32_t    instanceCount;
+    uint32_t    indexStart;
+    int32_t     baseVertex;
+    uint32_t    baseInstance;           // the instance, for the vertex shader's table lookup
+};
+
+// Same layout as MTLIndirectCommandBufferExecutionRange.
+struct RMDLDrawRange
+{
+    uint32_t    location;
+    uint32_t    length;
+};
+
+typedef enum CullBufferIndex
+{
+    CullBufferIndexParams       = 0,
+    CullBufferIndexInstances    = 1,
+    CullBufferIndexMeshes       = 2,
+    CullBufferIndexVisibility   = 3,
+    CullBufferIndexGroups       = 4,
+    CullBufferIndexArguments    = 5,
+    CullBufferIndexDrawRange    = 6,
+    CullBufferIndexCount        = 7
+}   CullBufferIndex;
+
+#endif /* RMDLCulling_shared_h */
@@ -0,0 +1,500 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLEcs.cpp                  +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 06:02:20      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLEcs.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+namespace ecs
+{
+
+namespace
+{
+    static constexpr uint32_t kNoArchetype = ~0u;
+    /// Placeholders from CommandBuffer::create(); real generations skip it.
+    static constexpr uint32_t kPendingGeneration = ~0u;
+    static constexpr size_t kCommandBlockBytes = 16 * 1024;
+
+    struct Registry
+    {
+        ComponentInfo           infos[kMaxComponents];
+        std::atomic<uint32_t>   count{ 0 };
+        std::mutex              mutex;
+    };
+
+    Registry& registry()
+    {
+        static Registry registry;
+        return (registry);
+    }
+
+    inline size_t alignUp( size_t value, size_t alignment )
+    {
+        return ((value + alignment - 1) & ~(alignment - 1));
+    }
+
+    std::byte* allocateBlock( size_t bytes )
+    {
+        return (static_cast<std::byte*>(::operator new(bytes, std::align_val_t(64))));
+    }
+
+    void freeBlock( std::byte* pBlock )
+    {
+        ::operator delete(pBlock, std::align_val_t(64));
+    }
+
+    inline void relocate( const ComponentInfo& info, void* pDst, void* pSrc )
+    {
+        if (info.relocate)
+            info.relocate(pDst, pSrc);
+        else
+            memcpy(pDst, pSrc, info.size);
+    }
+}
+
+#pragma mark - Components
+
+ComponentId registerComponent( const ComponentInfo& info )
+{
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    const uint32_t id = r.count.load(std::memory_order_relaxed);
+    assert(id < kMaxComponents && "too many component types for a ComponentMask");
+    r.infos[id] = info;
+    r.count.store(id + 1, std::memory_order_release);
+    return (id);
+}
+
+const ComponentInfo& componentInfo( ComponentId id )
+{
+    return (registry().infos[id]);
+}
+
+uint32_t componentCount()
+{
+    return (registry().count.load(std::memory_order_acquire));
+}
+
+#pragma mark - Command buffer
+
+CommandBuffer::CommandBuffer()
+: _blockUsed( 0 )
+, _pendingCount( 0 )
+, _blockIndex( 0 )
+{
+}
+
+CommandBuffer::~CommandBuffer()
+{
+    clear();
+    for (const Block& block : _blocks)
+        freeBlock(block.pData);
+}
+
+Entity CommandBuffer::create()
+{
+    const Entity entity = { _pendingCount++, kPendingGeneration };
+    _commands.push_back({ Op::Create, 0, entity, nullptr });
+    return (entity);
+}
+
+void CommandBuffer::destroy( Entity entity )
+{
+    _commands.push_back({ Op::Destroy, 0, entity, nullptr });
+}
+
+void* CommandBuffer::allocate( size_t size, size_t alignment )
+{
+    // Payloads never move once written, so any component type can wait here.
+    while (_blockIndex < _blocks.size() && alignUp(_blockUsed, alignment) + size > _blocks[_blockIndex].size)
+    {
+        ++_blockIndex;
+        _blockUsed = 0;
+    }
+    if (_blockIndex == _blocks.size())
+    {
+        const size_t bytes = std::max(kCommandBlockBytes, alignUp(size, 64));
+        _blocks.push_back({ allocateBlock(bytes), bytes });
+        _blockUsed = 0;
+    }
+    _blockUsed = alignUp(_blockUsed, alignment);
+    void* p = _blocks[_blockIndex].pData + _blockUsed;
+    _blockUsed += size;
+    return (p);
+}
+
+void CommandBuffer::clear()
+{
+    for (const Command& command : _commands)
+    {
+        if (command.pPayload)
+        {
+            const ComponentInfo& info = componentInfo(command.component);
+            if (info.destroy)
+                info.destroy(command.pPayload);
+        }
+    }
+    _commands.clear();
+    _blockIndex = 0;
+    _blockUsed = 0;
+    _pendingCount = 0;
+}
+
+#pragma mark - World
+
+World::World()
+{
+    archetypeFor(0);
+}
+
+World::~World()
+{
+    for (const std::unique_ptr<Archetype>& pArchetype : _archetypes)
+    {
+        const Archetype& a = *pArchetype;
+        for (uint32_t column = 0; column < a.components.size(); ++column)
+        {
+            const ComponentInfo& info = componentInfo(a.components[column]);
+            if (!info.destroy)
+                continue;
+            for (uint32_t row = 0; row < a.count; ++row)
+                info.destroy(slot(a, column, row));
+        }
+        for (std::byte* pChunk : a.chunks)
+            freeBlock(pChunk);
+    }
+    for (std::byte* pChunk : _spareChunks)
+        freeBlock(pChunk);
+}
+
+uint32_t World::archetypeFor( ComponentMask mask )
+{
+    const auto found = _archetypeOf.find(mask);
+    if (found != _archetypeOf.end())
+        return (found->second);
+
+    auto pArchetype = std::make_unique<Archetype>();
+    Archetype& a = *pArchetype;
+    a.mask = mask;
+    a.count = 0;
+    std::fill(std::begin(a.column), std::end(a.column), (int8_t)-1);
+    std::fill(std::begin(a.addEdge), std::end(a.addEdge), kNoArchetype);
+    std::fill(std::begin(a.removeEdge), std::end(a.removeEdge), kNoArchetype);
+
+    size_t rowBytes = sizeof(Entity);
+    for (ComponentId id = 0; id < kMaxComponents; ++id)
+    {
+        if (!(mask & (ComponentMask(1) << id)))
+            continue;
+        a.column[id] = (int8_t)a.components.size();
+        a.components.push_back(id);
+        a.sizes.push_back(componentInfo(id).size);
+        rowBytes += componentInfo(id).size;
+    }
+
+    // As many rows as fit once every array starts on a 16-byte boundary.
+    a.offsets.resize(a.components.size());
+    for (a.capacity = (uint32_t)(kChunkBytes / rowBytes); a.capacity > 0; --a.capacity)
+    {
+        size_t offset = sizeof(Entity) * a.capacity;
+        for (size_t column = 0; column < a.components.size(); ++column)
+        {
+            offset = alignUp(offset, std::max<size_t>(16, componentInfo(a.components[column]).alignment));
+            a.offsets[column] = (uint32_t)offset;
+            offset += (size_t)a.sizes[column] * a.capacity;
+        }
+        if (offset <= kChunkBytes)
+            break;
+    }
+    assert(a.capacity > 0 && "one entity of this archetype does not fit in a chunk");
+
+    const uint32_t index = (uint32_t)_archetypes.size();
+    _archetypes.push_back(std::move(pArchetype));
+    _archetypeOf.emplace(mask, index);
+    return (index);
+}
+
+uint32_t World::neighbour( uint32_t archetype, ComponentId component, bool adding )
+{
+    uint32_t& edge = adding ? _archetypes[archetype]->addEdge[component] : _archetypes[archetype]->removeEdge[component];
+    if (edge == kNoArchetype)
+    {
+        const ComponentMask bit = ComponentMask(1) << component;
+        const ComponentMask mask = _archetypes[archetype]->mask;
+        // archetypeFor() may grow _archetypes, but each Archetype stays put.
+        edge = archetypeFor(adding ? (mask | bit) : (mask & ~bit));
+    }
+    return (edge);
+}
+
+uint32_t World::pushRow( Archetype& archetype, Entity entity )
+{
+    if (archetype.count == archetype.chunks.size() * archetype.capacity)
+    {
+        if (_spareChunks.empty())
+            archetype.chunks.push_back(allocateBlock(kChunkBytes));
+        else
+        {
+            archetype.chunks.push_back(_spareChunks.back());
+            _spareChunks.pop_back();
+        }
+    }
+    const uint32_t row = archetype.count++;
+    const uint32_t chunk = row / archetype.capacity;
+    reinterpret_cast<Entity*>(archetype.chunks[chunk])[row - chunk * archetype.capacity] = entity;
+    return (row);
+}
+
+void World::removeRow( Archetype& archetype, uint32_t row )
+{
+    // The row's components are gone already; the last row fills the hole.
+    const uint32_t last = archetype.count - 1;
+    if (row != last)
+    {
+        for (uint32_t column = 0; column < archetype.components.size(); ++column)
+            relocate(componentInfo(archetype.components[column]), slot(archetype, column, row), slot(archetype, column, last));
+        const uint32_t lastChunk = last / archetype.capacity;
+        const uint32_t rowChunk = row / archetype.capacity;
+        const Entity moved = reinterpret_cast<Entity*>(archetype.chunks[lastChunk])[last - lastChunk * archetype.capacity];
+        reinterpret_cast<Entity*>(archetype.chunks[rowChunk])[row - rowChunk * archetype.capacity] = moved;
+        _records[moved.index].row = row;
+    }
+    archetype.count = last;
+    if (archetype.count == (archetype.chunks.size() - 1) * archetype.capacity)
+    {
+        _spareChunks.push_back(archetype.chunks.back());
+        archetype.chunks.pop_back();
+    }
+}
+
+Entity World::allocateEntity( uint32_t archetype )
+{
+    Entity entity;
+    if (!_freeIndices.empty())
+    {
+        entity.index = _freeIndices.back();
+        _freeIndices.pop_back();
+    }
+    else
+    {
+        entity.index = (uint32_t)_records.size();
+        _records.push_back({ kNoArchetype, 0, 0 });
+    }
+    entity.generation = _records[entity.index].generation;
+    const uint32_t row = pushRow(*_archetypes[archetype], entity);
+    _records[entity.index].archetype = archetype;
+    _records[entity.index].row = row;
+    return (entity);
+}
+
+void World::moveEntity( Entity entity, uint32_t target )
+{
+    const uint32_t source = _records[entity.index].archetype;
+    const uint32_t sourceRow = _records[entity.index].row;
+    Archetype& from = *_archetypes[source];
+    Archetype& to = *_archetypes[target];
+
+    const uint32_t row = pushRow(to, entity);
+    for (uint32_t column = 0; column < from.components.size(); ++column)
+    {
+        const ComponentId id = from.components[column];
+        const ComponentInfo& info = componentInfo(id);
+        void* pSrc = slot(from, column, sourceRow);
+        if (to.column[id] >= 0)
+            relocate(info, slot(to, to.column[id], row), pSrc);
+        else if (info.destroy)
+            info.destroy(pSrc);
+    }
+    removeRow(from, sourceRow);
+    _records[entity.index].archetype = target;
+    _records[entity.index].row = row;
+}
+
+Entity World::create()
+{
+    return (allocateEntity(0));
+}
+
+void World::destroy( Entity entity )
+{
+    if (!isAlive(entity))
+        return;
+    Record& record = _records[entity.index];
+    Archetype& a = *_archetypes[record.archetype];
+    for (uint32_t column = 0; column < a.components.size(); ++column)
+    {
+        const ComponentInfo& info = componentInfo(a.components[column]);
+        if (info.destroy)
+            info.destroy(slot(a, column, record.row));
+    }
+    removeRow(a, record.row);
+    record.archetype = kNoArchetype;
+    if (++record.generation == kPendingGeneration)
+        record.generation = 0;
+    _freeIndices.push_back(entity.index);
+}
+
+bool World::isAlive( Entity entity ) const
+{
+    return (entity.index < _records.size()
+            && _records[entity.index].generation == entity.generation
+            && _records[entity.index].archetype != kNoArchetype);
+}
+
+void* World::addRaw( Entity entity, ComponentId component )
+{
+    assert(isAlive(entity));
+    const Record& record = _records[entity.index];
+    const Archetype& a = *_archetypes[record.archetype];
+    if (a.column[component] >= 0)
+    {
+        void* p = slot(a, a.column[component], record.row);
+        if (componentInfo(component).destroy)
+            componentInfo(component).destroy(p);
+        return (p);
+    }
+    const uint32_t target = neighbour(record.archetype, component, true);
+    moveEntity(entity, target);
+    const Archetype& to = *_archetypes[target];
+    return (slot(to, to.column[component], _records[entity.index].row));
+}
+
+void World::removeRaw( Entity entity, ComponentId component )
+{
+    if (!getRaw(entity, component))
+        return;
+    moveEntity(entity, neighbour(_records[entity.index].archetype, component, false));
+}
+
+void* World::getRaw( Entity entity, ComponentId component ) const
+{
+    if (!isAlive(entity))
+        return (nullptr);
+    const Record& record = _records[entity.index];
+    const Archetype& a = *_archetypes[record.archetype];
+    if (a.column[component] < 0)
+        return (nullptr);
+    return (slot(a, a.column[component], record.row));
+}
+
+std::vector<World::ChunkRef> World::matchingChunks( ComponentMask required )
+{
+    std::vector<ChunkRef> chunks;
+    for (const std::unique_ptr<Archetype>& pArchetype : _archetypes)
+    {
+        if ((pArchetype->mask & required) != required)
+            continue;
+        for (uint32_t chunk = 0; chunk < pArchetype->chunks.size(); ++chunk)
+            chunks.push_back({ pArchetype.get(), chunk });
+    }
+    return (chunks);
+}
+
+void World::apply( CommandBuffer& commands )
+{
+    std::vector<Entity> created(commands._pendingCount);
+    auto resolve = [&created]( Entity entity )
+    {
+        return (entity.generation == kPendingGeneration ? created[entity.index] : entity);
+    };
+
+    for (CommandBuffer::Command& command : commands._commands)
+    {
+        switch (command.op)
+        {
+            case CommandBuffer::Op::Create:
+                created[command.entity.index] = create();
+                break;
+            case CommandBuffer::Op::Destroy:
+                destroy(resolve(command.entity));
+                break;
+            case CommandBuffer::Op::Add:
+            {
+                // A command for an entity destroyed in the meantime is dropped.
+                const Entity entity = resolve(command.entity);
+                if (!isAlive(entity))
+                    break;
+                relocate(componentInfo(command.component), addRaw(entity, command.component), command.pPayload);
+                command.pPayload = nullptr;
+                break;
+            }
+            case CommandBuffer::Op::Remove:
+                removeRaw(resolve(command.entity), command.component);
+                break;
+        }
+    }
+    commands.clear();
+}
+
+size_t World::entityCount() const
+{
+    size_t count = 0;
+    for (const std::unique_ptr<Archetype>& pArchetype : _archetypes)
+        count += pArchetype->count;
+    return (count);
+}
+
+size_t World::chunkCount() const
+{
+    size_t count = 0;
+    for (const std::unique_ptr<Archetype>& pArchetype : _archetypes)
+        count += pArchetype->chunks.size();
+    return (count);
+}
+
+#pragma mark - Schedule
+
+uint32_t Schedule::add( const std::string& name, const SystemAccess& access, System system )
+{
+    auto conflicts = [&access]( const SystemAccess& other )
+    {
+        return (access.exclusive || other.exclusive
+                || (access.writes & (other.reads | other.writes))
+                || (other.writes & access.reads));
+    };
+
+    // One phase after the last system it conflicts with.
+    uint32_t phase = 0;
+    for (const Entry& entry : _systems)
+    {
+        if (conflicts(entry.access))
+            phase = std::max(phase, entry.phase + 1);
+    }
+    const uint32_t index = (uint32_t)_systems.size();
+    _systems.push_back({ name, access, std::move(system), std::make_unique<CommandBuffer>(), phase });
+    if (_phases.size() <= phase)
+        _phases.resize(phase + 1);
+    _phases[phase].push_back(index);
+    return (index);
+}
+
+void Schedule::run( World& world )
+{
+    for (const std::vector<uint32_t>& phase : _phases)
+    {
+        auto runSystem = [&]( size_t i )
+        {
+            Entry& entry = _systems[phase[i]];
+            entry.system(world, *entry.pCommands);
+        };
+        if (phase.size() == 1)
+            runSystem(0);
+        else
+            parallel::forEach(phase.size(), runSystem);
+
+        // The sync point.
+        for (uint32_t system : phase)
+            world.apply(*_systems[system].pCommands);
+    }
+}
+
+}
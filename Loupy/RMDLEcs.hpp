@@ -0,0 +1,446 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLEcs.hpp                  +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 06:02:14      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLECS_HPP
+# define RMDLECS_HPP
+
+# include <cassert>
+# include <cstddef>
+# include <cstdint>
+# include <cstring>
+# include <functional>
+# include <memory>
+# include <new>
+# include <string>
+# include <type_traits>
+# include <typeinfo>
+# include <unordered_map>
+# include <utility>
+# include <vector>
+
+# include "NonCopyable.h"
+# include "RMDLParallel.hpp"
+
+// Entities and components, stored by archetype. Every distinct set of component
+// types is one archetype, whose entities live in 16 KB chunks: an array of
+// entity handles followed by one array per component, so iterating a query
+// walks a few arrays front to back. Adding or removing a component moves the
+// entity to the neighbouring archetype. While systems run, structural changes
+// go to a CommandBuffer and are applied at the next sync point; a Schedule
+// groups systems whose declared reads and writes do not conflict and runs each
+// group in parallel.
+
+namespace ecs
+{
+    static constexpr uint32_t   kMaxComponents  = 64;
+    static constexpr size_t     kChunkBytes     = 16 * 1024;
+
+    typedef uint32_t ComponentId;
+    /// Bit `componentId<T>()` is set for every T in the set.
+    typedef uint64_t ComponentMask;
+
+    struct Entity
+    {
+        uint32_t    index       = ~0u;
+        uint32_t    generation  = 0;
+
+        bool        operator==( const Entity& o ) const     { return (index == o.index && generation == o.generation); }
+        bool        operator!=( const Entity& o ) const     { return (!(*this == o)); }
+    };
+
+    struct ComponentInfo
+    {
+        const char* name;
+        uint32_t    size;
+        uint32_t    alignment;
+        /// Move-constructs into pDst and destroys pSrc; nullptr means memcpy.
+        void        (*relocate)( void* pDst, void* pSrc );
+        /// nullptr when trivially destructible.
+        void        (*destroy)( void* p );
+    };
+
+    ComponentId             registerComponent( const ComponentInfo& info );
+    const ComponentInfo&    componentInfo( ComponentId id );
+    uint32_t                componentCount();
+
+    /// Registered on first use, so ids depend on that order.
+    template< typename T >
+    ComponentId             componentId();
+
+    template< typename... Ts >
+    ComponentMask           maskOf()        { return ((ComponentMask(0) | ... | (ComponentMask(1) << componentId<Ts>()))); }
+
+    class World;
+
+    /// Structural changes recorded now and applied by World::apply(), in order.
+    /// Not thread-safe; use one per thread or system.
+    class CommandBuffer : public NonCopyable
+    {
+    public:
+        CommandBuffer();
+        ~CommandBuffer();
+
+        /// A placeholder that the other calls on this buffer accept; it becomes
+        /// a real entity when the buffer is applied.
+        Entity          create();
+        void            destroy( Entity entity );
+        template< typename T >
+        void            add( Entity entity, T value );
+        template< typename T >
+        void            remove( Entity entity );
+
+        bool            empty() const       { return (_commands.empty()); }
+        size_t          size() const        { return (_commands.size()); }
+        /// Drops every command without applying it.
+        void            clear();
+
+    private:
+        friend class World;
+
+        enum class Op : uint8_t
+        {
+            Create,
+            Destroy,
+            Add,
+            Remove
+        };
+
+        struct Command
+        {
+            Op          op;
+            ComponentId component;
+            Entity      entity;
+            void*       pPayload;
+        };
+
+        struct Block
+        {
+            std::byte*  pData;
+            size_t      size;
+        };
+
+        void*           allocate( size_t size, size_t alignment );
+
+        std::vector<Command>    _commands;
+        std::vector<Block>      _blocks;        // kept across clear()
+        size_t                  _blockUsed;
+        uint32_t                _pendingCount;
+        size_t                  _blockIndex;
+    };
+
+    class World : public NonCopyable
+    {
+    public:
+        World();
+        ~World();
+
+        Entity          create();
+        template< typename... Ts >
+        Entity          create( Ts&&... values );
+        void            destroy( Entity entity );
+        bool            isAlive( Entity entity ) const;
+
+        /// Replaces the value if the entity has one already.
+        template< typename T >
+        T&              add( Entity entity, T value );
+        template< typename T >
+        void            remove( Entity entity );
+        template< typename T >
+        bool            has( Entity entity ) const;
+        /// nullptr if the entity does not have it.
+        template< typename T >
+        T*              get( Entity entity );
+
+        /// `fn(Ts&...)` or `fn(Entity, Ts&...)` for every entity with all of Ts.
+        template< typename... Ts, typename F >
+        void            each( F&& fn );
+        /// `fn(count, Ts*...)` or `fn(count, const Entity*, Ts*...)` once per chunk.
+        template< typename... Ts, typename F >
+        void            eachChunk( F&& fn );
+        /// As eachChunk, with the chunks spread over the default thread pool.
+        template< typename... Ts, typename F >
+        void            parallelEachChunk( F&& fn );
+        /// As each, with the chunks spread over the default thread pool.
+        template< typename... Ts, typename F >
+        void            parallelEach( F&& fn );
+
+        /// A sync point: no query may be running.
+        void            apply( CommandBuffer& commands );
+
+        size_t          entityCount() const;
+        size_t          archetypeCount() const      { return (_archetypes.size()); }
+        size_t          chunkCount() const;
+
+    private:
+        struct Archetype
+        {
+            ComponentMask               mask;
+            std::vector<ComponentId>    components;
+            std::vector<uint32_t>       sizes;
+            std::vector<uint32_t>       offsets;        // of each component's array in a chunk
+            int8_t                      column[kMaxComponents];
+            uint32_t                    capacity;       // entities per chunk
+            uint32_t                    count;
+            std::vector<std::byte*>     chunks;
+            uint32_t                    addEdge[kMaxComponents];
+            uint32_t                    removeEdge[kMaxComponents];
+        };
+
+        struct Record
+        {
+            uint32_t    archetype;
+            uint32_t    row;
+            uint32_t    generation;
+        };
+
+        struct ChunkRef
+        {
+            Archetype*  pArchetype;
+            uint32_t    chunk;
+        };
+
+        uint32_t        archetypeFor( ComponentMask mask );
+        uint32_t        neighbour( uint32_t archetype, ComponentId component, bool adding );
+        Entity          allocateEntity( uint32_t archetype );
+        uint32_t        pushRow( Archetype& archetype, Entity entity );
+        void            removeRow( Archetype& archetype, uint32_t row );
+        void            moveEntity( Entity entity, uint32_t target );
+        /// Storage for the component, uninitialised; an old value is destroyed.
+        void*           addRaw( Entity entity, ComponentId component );
+        void            removeRaw( Entity entity, ComponentId component );
+        void*           getRaw( Entity entity, ComponentId component ) const;
+        std::vector<ChunkRef>   matchingChunks( ComponentMask required );
+
+        static void*    slot( const Archetype& archetype, uint32_t column, uint32_t row );
+        static uint32_t rowsIn( const Archetype& archetype, uint32_t chunk );
+        template< typename T >
+        static T*       columnOf( const Archetype& archetype, uint32_t chunk );
+        template< typename... Ts, typename F >
+        static void     visitChunk( const Archetype& archetype, uint32_t chunk, F& fn );
+        template< typename... Ts, typename F >
+        static void     visitRows( const Archetype& archetype, uint32_t chunk, F& fn );
+
+        std::vector<std::unique_ptr<Archetype>>     _archetypes;
+        std::unordered_map<ComponentMask, uint32_t> _archetypeOf;
+        std::vector<Record>                         _records;
+        std::vector<uint32_t>                       _freeIndices;
+        std::vector<std::byte*>                     _spareChunks;
+    };
+
+    /// What a system touches. Systems conflict when one writes what the other
+    /// reads or writes; an exclusive system conflicts with every other.
+    struct SystemAccess
+    {
+        ComponentMask   reads       = 0;
+        ComponentMask   writes      = 0;
+        bool            exclusive   = false;
+    };
+
+    class Schedule : public NonCopyable
+    {
+    public:
+        using System = std::function<void( World& world, CommandBuffer& commands )>;
+
+        /// Systems run as if in the order added, apart from non-conflicting ones
+        /// that may share a phase.
+        uint32_t        add( const std::string& name, const SystemAccess& access, System system );
+
+        /// Phase by phase: the systems of a phase run in parallel, then their
+        /// command buffers are applied in the order the systems were added.
+        void            run( World& world );
+
+        uint32_t            systemCount() const             { return ((uint32_t)_systems.size()); }
+        const std::string&  systemName( uint32_t system ) const     { return (_systems[system].name); }
+        uint32_t            phaseOf( uint32_t system ) const        { return (_systems[system].phase); }
+        uint32_t            phaseCount() const              { return ((uint32_t)_phases.size()); }
+
+    private:
+        struct Entry
+        {
+            std::string                     name;
+            SystemAccess                    access;
+            System                          system;
+            std::unique_ptr<CommandBuffer>  pCommands;
+            uint32_t                        phase;
+        };
+
+        std::vector<Entry>                  _systems;
+        std::vector<std::vector<uint32_t>>  _phases;
+    };
+}
+
+#pragma mark - Components
+
+template< typename T >
+ecs::ComponentId ecs::componentId()
+{
+    using U = std::remove_cv_t<T>;
+    if constexpr (!std::is_same<T, U>::value)
+        return (componentId<U>());
+    static_assert(alignof(U) <= 64, "components are aligned to at most a cache line");
+    static const ComponentId id = registerComponent({
+        typeid(U).name(),
+        (uint32_t)sizeof(U),
+        (uint32_t)alignof(U),
+        std::is_trivially_copyable<U>::value ? nullptr : +[]( void* pDst, void* pSrc ) {
+            new (pDst) U(std::move(*static_cast<U*>(pSrc)));
+            static_cast<U*>(pSrc)->~U();
+        },
+        std::is_trivially_destructible<U>::value ? nullptr : +[]( void* p ) {
+            static_cast<U*>(p)->~U();
+        }
+    });
+    return (id);
+}
+
+#pragma mark - Command buffer
+
+template< typename T >
+void ecs::CommandBuffer::add( Entity entity, T value )
+{
+    void* pPayload = allocate(sizeof(T), alignof(T));
+    new (pPayload) T(std::move(value));
+    _commands.push_back({ Op::Add, componentId<T>(), entity, pPayload });
+}
+
+template< typename T >
+void ecs::CommandBuffer::remove( Entity entity )
+{
+    _commands.push_back({ Op::Remove, componentId<T>(), entity, nullptr });
+}
+
+#pragma mark - World
+
+template< typename... Ts >
+ecs::Entity ecs::World::create( Ts&&... values )
+{
+    const ComponentId ids[] = { componentId<std::decay_t<Ts>>()... };
+    const uint32_t archetype = archetypeFor(maskOf<std::decay_t<Ts>...>());
+    const Entity entity = allocateEntity(archetype);
+    const Archetype& a = *_archetypes[archetype];
+    const uint32_t row = _records[entity.index].row;
+    size_t i = 0;
+    ((new (slot(a, a.column[ids[i++]], row)) std::decay_t<Ts>(std::forward<Ts>(values))), ...);
+    return (entity);
+}
+
+template< typename T >
+T& ecs::World::add( Entity entity, T value )
+{
+    return (*new (addRaw(entity, componentId<T>())) T(std::move(value)));
+}
+
+template< typename T >
+void ecs::World::remove( Entity entity )
+{
+    removeRaw(entity, componentId<T>());
+}
+
+template< typename T >
+bool ecs::World::has( Entity entity ) const
+{
+    return (getRaw(entity, componentId<T>()) != nullptr);
+}
+
+template< typename T >
+T* ecs::World::get( Entity entity )
+{
+    return (static_cast<T*>(getRaw(entity, componentId<T>())));
+}
+
+inline void* ecs::World::slot( const Archetype& archetype, uint32_t column, uint32_t row )
+{
+    const uint32_t chunk = row / archetype.capacity;
+    return (archetype.chunks[chunk] + archetype.offsets[column] + (size_t)(row - chunk * archetype.capacity) * archetype.sizes[column]);
+}
+
+inline uint32_t ecs::World::rowsIn( const Archetype& archetype, uint32_t chunk )
+{
+    const uint32_t first = chunk * archetype.capacity;
+    return (archetype.count - first < archetype.capacity ? archetype.count - first : archetype.capacity);
+}
+
+template< typename T >
+T* ecs::World::columnOf( const Archetype& archetype, uint32_t chunk )
+{
+    return (reinterpret_cast<T*>(archetype.chunks[chunk] + archetype.offsets[archetype.column[componentId<T>()]]));
+}
+
+template< typename... Ts, typename F >
+void ecs::World::visitChunk( const Archetype& archetype, uint32_t chunk, F& fn )
+{
+    const size_t count = rowsIn(archetype, chunk);
+    if constexpr (std::is_invocable<F&, size_t, const Entity*, Ts*...>::value)
+        fn(count, reinterpret_cast<const Entity*>(archetype.chunks[chunk]), columnOf<Ts>(archetype, chunk)...);
+    else
+        fn(count, columnOf<Ts>(archetype, chunk)...);
+}
+
+template< typename... Ts, typename F >
+void ecs::World::visitRows( const Archetype& archetype, uint32_t chunk, F& fn )
+{
+    auto rows = [&fn]( size_t count, const Entity* pEntities, Ts*... columns )
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            if constexpr (std::is_invocable<F&, Entity, Ts&...>::value)
+                fn(pEntities[i], columns[i]...);
+            else
+                fn(columns[i]...);
+        }
+    };
+    visitChunk<Ts...>(archetype, chunk, rows);
+}
+
+template< typename... Ts, typename F >
+void ecs::World::each( F&& fn )
+{
+    const ComponentMask required = maskOf<Ts...>();
+    for (const std::unique_ptr<Archetype>& pArchetype : _archetypes)
+    {
+        if ((pArchetype->mask & required) != required)
+            continue;
+        for (uint32_t chunk = 0; chunk < pArchetype->chunks.size(); ++chunk)
+            visitRows<Ts...>(*pArchetype, chunk, fn);
+    }
+}
+
+template< typename... Ts, typename F >
+void ecs::World::eachChunk( F&& fn )
+{
+    const ComponentMask required = maskOf<Ts...>();
+    for (const std::unique_ptr<Archetype>& pArchetype : _archetypes)
+    {
+        if ((pArchetype->mask & required) != required)
+            continue;
+        for (uint32_t chunk = 0; chunk < pArchetype->chunks.size(); ++chunk)
+            visitChunk<Ts...>(*pArchetype, chunk, fn);
+    }
+}
+
+template< typename... Ts, typename F >
+void ecs::World::parallelEachChunk( F&& fn )
+{
+    const std::vector<ChunkRef> chunks = matchingChunks(maskOf<Ts...>());
+    parallel::forEach(chunks.size(), [&]( size_t i ) {
+        visitChunk<Ts...>(*chunks[i].pArchetype, chunks[i].chunk, fn);
+    });
+}
+
+template< typename... Ts, typename F >
+void ecs::World::parallelEach( F&& fn )
+{
+    const std::vector<ChunkRef> chunks = matchingChunks(maskOf<Ts...>());
+    parallel::forEach(chunks.size(), [&]( size_t i ) {
+        visitRows<Ts...>(*chunks[i].pArchetype, chunks[i].chunk, fn);
+    });
+}
+
+#endif /* RMDLECS_HPP */
@@ -0,0 +1,176 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLFixedPoint.hpp           +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 07:54:08      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLFIXEDPOINT_HPP
+# define RMDLFIXEDPOINT_HPP
+
+# include <cassert>
+# include <cmath>
+# include <cstdint>
+
+# include "RMDLBinarySpacePartitioning.hpp"
+
+// 48.16 fixed-point numbers and vectors for simulation that has to give the
+// same bits on every machine: only integer arithmetic, with products and
+// quotients through 128 bits. Fixed from the BSP code has 8 fractional bits,
+// too few to integrate velocities at 60 Hz; it converts here exactly. 48
+// integer bits leave room for squared lengths and products of dot products
+// of geometry a few thousand units across; the resolution is 1/65536.
+// Multiplication rounds to nearest, division truncates towards zero.
+
+namespace fixed_point
+{
+    struct Scalar
+    {
+        static constexpr int    kFractionBits = 16;
+        static constexpr int64_t kOne = (int64_t)1 << kFractionBits;
+
+        int64_t     raw = 0;
+
+        static constexpr Scalar fromRaw( int64_t raw )          { return (Scalar{ raw }); }
+        static constexpr Scalar fromInt( int64_t n )            { return (Scalar{ n * kOne }); }
+        /// num / den, truncated.
+        static constexpr Scalar fromRatio( int64_t num, int64_t den )
+        {
+            assert(den != 0);
+            return (Scalar{ (int64_t)((__int128)num * kOne / den) });
+        }
+        /// Fixed has 8 fractional bits, so this is exact.
+        static Scalar           fromFixed( const Fixed& f )     { return (Scalar{ (int64_t)f.getRawBits() * (kOne >> 8) }); }
+        /// For loading content only: rounding a float is exact, but where the
+        /// float came from may not be.
+        static Scalar           fromFloat( float f )            { return (Scalar{ (int64_t)std::llround((double)f * (double)kOne) }); }
+
+        float                   toFloat() const                 { return ((float)((double)raw / (double)kOne)); }
+        double                  toDouble() const                { return ((double)raw / (double)kOne); }
+        /// Rounded towards minus infinity.
+        int64_t                 toInt() const                   { return (raw >> kFractionBits); }
+    };
+
+    constexpr Scalar    operator+( Scalar a, Scalar b )     { return (Scalar{ a.raw + b.raw }); }
+    constexpr Scalar    operator-( Scalar a, Scalar b )     { return (Scalar{ a.raw - b.raw }); }
+    constexpr Scalar    operator-( Scalar a )               { return (Scalar{ -a.raw }); }
+    constexpr Scalar    operator*( Scalar a, Scalar b )
+    {
+        const __int128 p = (__int128)a.raw * b.raw + ((__int128)1 << (Scalar::kFractionBits - 1));
+        return (Scalar{ (int64_t)(p >> Scalar::kFractionBits) });
+    }
+    /// Integer division: callers rule out a zero divisor, it would trap.
+    constexpr Scalar    operator/( Scalar a, Scalar b )
+    {
+        assert(b.raw != 0);
+        return (Scalar{ (int64_t)((__int128)a.raw * Scalar::kOne / b.raw) });
+    }
+    constexpr Scalar&   operator+=( Scalar& a, Scalar b )   { a.raw += b.raw; return (a); }
+    constexpr Scalar&   operator-=( Scalar& a, Scalar b )   { a.raw -= b.raw; return (a); }
+    constexpr Scalar&   operator*=( Scalar& a, Scalar b )   { a = a * b; return (a); }
+
+    constexpr bool      operator==( Scalar a, Scalar b )    { return (a.raw == b.raw); }
+    constexpr bool      operator!=( Scalar a, Scalar b )    { return (a.raw != b.raw); }
+    constexpr bool      operator<( Scalar a, Scalar b )     { return (a.raw < b.raw); }
+    constexpr bool      operator>( Scalar a, Scalar b )     { return (a.raw > b.raw); }
+    constexpr bool      operator<=( Scalar a, Scalar b )    { return (a.raw <= b.raw); }
+    constexpr bool      operator>=( Scalar a, Scalar b )    { return (a.raw >= b.raw); }
+
+    constexpr Scalar    abs( Scalar a )                     { return (a.raw < 0 ? -a : a); }
+    constexpr Scalar    min( Scalar a, Scalar b )           { return (a.raw < b.raw ? a : b); }
+    constexpr Scalar    max( Scalar a, Scalar b )           { return (a.raw > b.raw ? a : b); }
+    constexpr Scalar    clamp( Scalar a, Scalar lo, Scalar hi ) { return (max(lo, min(a, hi))); }
+
+    /// Floor of the exact root. The double estimate is only a starting point;
+    /// the integer correction makes the result the same everywhere.
+    inline Scalar       sqrt( Scalar a )
+    {
+        assert(a.raw >= 0);
+        const unsigned __int128 v = (unsigned __int128)a.raw << Scalar::kFractionBits;
+        uint64_t r = (uint64_t)std::sqrt((double)v);
+        while ((unsigned __int128)r * r > v)
+            --r;
+        while ((unsigned __int128)(r + 1) * (r + 1) <= v)
+            ++r;
+        return (Scalar{ (int64_t)r });
+    }
+
+    struct Vec3
+    {
+        Scalar      x, y, z;
+
+        static Vec3     fromPoint( const Point& p )         { return (Vec3{ Scalar::fromFixed(p.getX()), Scalar::fromFixed(p.getY()), Scalar{} }); }
+    };
+
+    constexpr Vec3      operator+( const Vec3& a, const Vec3& b )   { return (Vec3{ a.x + b.x, a.y + b.y, a.z + b.z }); }
+    constexpr Vec3      operator-( const Vec3& a, const Vec3& b )   { return (Vec3{ a.x - b.x, a.y - b.y, a.z - b.z }); }
+    constexpr Vec3      operator-( const Vec3& a )                  { return (Vec3{ -a.x, -a.y, -a.z }); }
+    constexpr Vec3      operator*( const Vec3& a, Scalar s )        { return (Vec3{ a.x * s, a.y * s, a.z * s }); }
+    constexpr Vec3      operator*( Scalar s, const Vec3& a )        { return (a * s); }
+    constexpr Vec3&     operator+=( Vec3& a, const Vec3& b )        { a = a + b; return (a); }
+    constexpr Vec3&     operator-=( Vec3& a, const Vec3& b )        { a = a - b; return (a); }
+    constexpr bool      operator==( const Vec3& a, const Vec3& b )  { return (a.x == b.x && a.y == b.y && a.z == b.z); }
+
+    constexpr Scalar    dot( const Vec3& a, const Vec3& b )         { return (a.x * b.x + a.y * b.y + a.z * b.z); }
+    constexpr Vec3      cross( const Vec3& a, const Vec3& b )
+    {
+        return (Vec3{ a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x });
+    }
+    constexpr Scalar    lengthSquared( const Vec3& a )              { return (dot(a, a)); }
+    inline Scalar       length( const Vec3& a )                     { return (sqrt(dot(a, a))); }
+    constexpr Vec3      min( const Vec3& a, const Vec3& b )         { return (Vec3{ min(a.x, b.x), min(a.y, b.y), min(a.z, b.z) }); }
+    constexpr Vec3      max( const Vec3& a, const Vec3& b )         { return (Vec3{ max(a.x, b.x), max(a.y, b.y), max(a.z, b.z) }); }
+    constexpr Vec3      abs( const Vec3& a )                        { return (Vec3{ abs(a.x), abs(a.y), abs(a.z) }); }
+
+    /// Rotation as a unit quaternion; w is the real part.
+    struct Quat
+    {
+        Scalar      x, y, z;
+        Scalar      w = Scalar::fromInt(1);
+    };
+
+    constexpr Quat      operator+( const Quat& a, const Quat& b )   { return (Quat{ a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w }); }
+    constexpr Quat      operator*( const Quat& a, Scalar s )        { return (Quat{ a.x * s, a.y * s, a.z * s, a.w * s }); }
+    constexpr Quat      operator*( const Quat& a, const Quat& b )
+    {
+        return (Quat{ a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+                      a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+                      a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+                      a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z });
+    }
+    constexpr bool      operator==( const Quat& a, const Quat& b )  { return (a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w); }
+
+    /// The identity when `q` has no length.
+    inline Quat         normalize( const Quat& q )
+    {
+        const Scalar length = sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+        if (length.raw == 0)
+            return (Quat{});
+        return (Quat{ q.x / length, q.y / length, q.z / length, q.w / length });
+    }
+
+    /// `angle` radians around the unit vector `axis`. Goes through libm, which
+    /// is not bit-identical everywhere: for tools and tests, not the simulation.
+    inline Quat         fromAxisAngle( const Vec3& axis, double angle )
+    {
+        const Scalar s = Scalar::fromFloat((float)std::sin(angle * 0.5)), c = Scalar::fromFloat((float)std::cos(angle * 0.5));
+        return (normalize(Quat{ axis.x * s, axis.y * s, axis.z * s, c }));
+    }
+
+    /// The rotated x, y and z axes: the columns of the rotation matrix.
+    inline void         rotationAxes( const Quat& q, Vec3 axes[3] )
+    {
+        const Scalar one = Scalar::fromInt(1), two = Scalar::fromInt(2);
+        const Scalar xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+        const Scalar xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+        const Scalar wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+        axes[0] = Vec3{ one - two * (yy + zz), two * (xy + wz), two * (xz - wy) };
+        axes[1] = Vec3{ two * (xy - wz), one - two * (xx + zz), two * (yz + wx) };
+        axes[2] = Vec3{ two * (xz + wy), two * (yz - wx), one - two * (xx + yy) };
+    }
+}
+
+#endif /* RMDLFIXEDPOINT_HPP */
@@ -0,0 +1,95 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLFloat4.hpp               +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 17:38:20      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLFLOAT4_HPP
+# define RMDLFLOAT4_HPP
+
+# if defined(__ARM_NEON)
+#  include <arm_neon.h>
+# elif defined(__SSE2__)
+#  include <emmintrin.h>
+# endif
+
+// Four floats in one register (NEON, SSE2, or plain scalars), used by the texture
+// tools for one RGBA texel at a time. Kept out of the public headers.
+
+namespace texture_utils
+{
+# if defined(__ARM_NEON)
+    struct Float4
+    {
+        float32x4_t v;
+
+        static Float4   load( const float* p )                      { return { vld1q_f32(p) }; }
+        static Float4   zero()                                      { return { vdupq_n_f32(0.f) }; }
+        static Float4   splat( float s )                            { return { vdupq_n_f32(s) }; }
+        static Float4   make( float x, float y, float z, float w )  { const float t[4] = { x, y, z, w }; return { vld1q_f32(t) }; }
+        void            store( float* p ) const                     { vst1q_f32(p, v); }
+        Float4          operator+( Float4 o ) const                 { return { vaddq_f32(v, o.v) }; }
+        Float4          operator-( Float4 o ) const                 { return { vsubq_f32(v, o.v) }; }
+        Float4          operator*( Float4 o ) const                 { return { vmulq_f32(v, o.v) }; }
+        Float4          operator*( float s ) const                  { return { vmulq_n_f32(v, s) }; }
+        Float4          madd( Float4 o, float s ) const             { return { vmlaq_n_f32(v, o.v, s) }; }
+        Float4          min( Float4 o ) const                       { return { vminq_f32(v, o.v) }; }
+        Float4          max( Float4 o ) const                       { return { vmaxq_f32(v, o.v) }; }
+        float           sum() const                                 { return (vaddvq_f32(v)); }
+    };
+# elif defined(__SSE2__)
+    struct Float4
+    {
+        __m128 v;
+
+        static Float4   load( const float* p )                      { return { _mm_loadu_ps(p) }; }
+        static Float4   zero()                                      { return { _mm_setzero_ps() }; }
+        static Float4   splat( float s )                            { return { _mm_set1_ps(s) }; }
+        static Float4   make( float x, float y, float z, float w )  { return { _mm_setr_ps(x, y, z, w) }; }
+        void            store( float* p ) const                     { _mm_storeu_ps(p, v); }
+        Float4          operator+( Float4 o ) const                 { return { _mm_add_ps(v, o.v) }; }
+        Float4          operator-( Float4 o ) const                 { return { _mm_sub_ps(v, o.v) }; }
+        Float4          operator*( Float4 o ) const                 { return { _mm_mul_ps(v, o.v) }; }
+        Float4          operator*( float s ) const                  { return { _mm_mul_ps(v, _mm_set1_ps(s)) }; }
+        Float4          madd( Float4 o, float s ) const             { return { _mm_add_ps(v, _mm_mul_ps(o.v, _mm_set1_ps(s))) }; }
+        Float4          min( Float4 o ) const                       { return { _mm_min_ps(v, o.v) }; }
+        Float4          max( Float4 o ) const                       { return { _mm_max_ps(v, o.v) }; }
+        float           sum() const
+        {
+            const __m128 hi = _mm_movehl_ps(v, v);
+            const __m128 s2 = _mm_add_ps(v, hi);
+            return (_mm_cvtss_f32(_mm_add_ss(s2, _mm_shuffle_ps(s2, s2, 1))));
+        }
+    };
+# else
+    struct Float4
+    {
+        float v[4];
+
+        static Float4   load( const float* p )                      { return { { p[0], p[1], p[2], p[3] } }; }
+        static Float4   zero()                                      { return { { 0.f, 0.f, 0.f, 0.f } }; }
+        static Float4   splat( float s )                            { return { { s, s, s, s } }; }
+        static Float4   make( float x, float y, float z, float w )  { return { { x, y, z, w } }; }
+        void            store( float* p ) const                     { for (int i = 0; i < 4; ++i) p[i] = v[i]; }
+        Float4          operator+( Float4 o ) const                 { return { { v[0] + o.v[0], v[1] + o.v[1], v[2] + o.v[2], v[3] + o.v[3] } }; }
+        Float4          operator-( Float4 o ) const                 { return { { v[0] - o.v[0], v[1] - o.v[1], v[2] - o.v[2], v[3] - o.v[3] } }; }
+        Float4          operator*( Float4 o ) const                 { return { { v[0] * o.v[0], v[1] * o.v[1], v[2] * o.v[2], v[3] * o.v[3] } }; }
+        Float4          operator*( float s ) const                  { return { { v[0] * s, v[1] * s, v[2] * s, v[3] * s } }; }
+        Float4          madd( Float4 o, float s ) const             { return { { v[0] + o.v[0] * s, v[1] + o.v[1] * s, v[2] + o.v[2] * s, v[3] + o.v[3] * s } }; }
+        Float4          min( Float4 o ) const                       { Float4 r; for (int i = 0; i < 4; ++i) r.v[i] = v[i] < o.v[i] ? v[i] : o.v[i]; return (r); }
+        Float4          max( Float4 o ) const                       { Float4 r; for (int i = 0; i < 4; ++i) r.v[i] = v[i] > o.v[i] ? v[i] : o.v[i]; return (r); }
+        float           sum() const                                 { return (v[0] + v[1] + v[2] + v[3]); }
+    };
+# endif
+
+    inline float dot( Float4 a, Float4 b )
+    {
+        return ((a * b).sum());
+    }
+}
+
+#endif /* RMDLFLOAT4_HPP */
@@ -4,13 +4,25 @@
 #include <Foundation/Foundation.hpp>
 #include <Metal/Metal.hpp>
 
+#include <memory>
 #include <string>
+#include <vector>
 #include <simd/simd.h>
 
 #include "RMDLUtils.hpp"
+#include "RMDLTextBatch.hpp"
+#include "RMDLSdfAtlas.hpp"
+#include "RMDLGlyphCache.hpp"
+#include "RMDLTextureUtils.hpp"
+#include "RMDLTextureCooker.hpp"
 
 MTL::Texture* newTextureFromFile( const std::string& texturePath, MTL::Device* pDevice );
-MTL::Texture* newTextureArrayFromFiles( const std::vector<std::string>& texturePaths, MTL::Device* pDevice, MTL::CommandBuffer* pCommandBuffer );
+/// Decodes and mips the files on worker threads (see texture_utils::SliceStream) and encodes
+/// their upload into `pCommandBuffer`. Every file must have the size of the first one decoded.
+MTL::Texture* newTextureArrayFromFiles( const std::vector<std::string>& texturePaths, MTL::Device* pDevice, MTL::CommandBuffer* pCommandBuffer,
+                                        const texture_utils::MipChainDesc& mipDesc = {} );
+/// Shared BC7 / BC5 texture with every level of `cooked` (see texture_utils::cookTexture).
+MTL::Texture* newTextureFromCooked( const texture_utils::CookedTexture& cooked, MTL::Device* pDevice );
 
 static char g_chars[] = {
     '!', '\"', '#', '$', '%', '&', '\'', '(', ')', '*', '+', ',',  '-', '.', '/', '0',
@@ -39,6 +51,31 @@ struct FontAtlas
 
 FontAtlas newFontAtlas( MTL::Device* pDevice );
 
+/// Monospaced metrics for the glyphs baked in `fontAtlas`, one unit per cell, for text::layoutText.
+text::GlyphTable newGlyphTable( const FontAtlas& fontAtlas );
+
+struct SdfFontAtlas
+{
+    NS::SharedPtr<MTL::Texture> texture;        // R8Unorm, 2D array of one slice
+    text::GlyphTable            glyphs;
+    float                       distanceRange;  // atlas texels
+};
+
+/// Printable ASCII of `fontName` as a distance field, sharp at any TextStyle::scale.
+/// The atlas is cached in `cachePath` (the user caches directory when empty) and only
+/// rebuilt when the font, charset or build parameters change.
+SdfFontAtlas newSdfFontAtlas( MTL::Device* pDevice, const char* fontName, const std::string& cachePath = "" );
+
+/// Rasterizer for text::GlyphCache; the font id is the index into `fontNames`.
+std::unique_ptr<text::GlyphRasterizer> newCoreTextRasterizer( const std::vector<std::string>& fontNames );
+
+/// R8 texture array matching `cache`, swizzled so coverage reads as alpha.
+MTL::Texture* newGlyphCacheTexture( MTL::Device* pDevice, const text::GlyphCache& cache );
+
+/// Copies the rectangles dirtied by the last GlyphCache::update(). Only cells no frame in flight
+/// can sample are ever rewritten, so this is safe on a texture the GPU is reading.
+void uploadGlyphCache( MTL::Texture* pTexture, const text::GlyphCache& cache );
+
 struct FiraCode
 {
     struct CharUVs
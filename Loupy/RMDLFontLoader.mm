@@ -3,6 +3,7 @@
 #import <MetalKit/MetalKit.h>
 #import <CoreGraphics/CoreGraphics.h>
 #import <CoreText/CoreText.h>
+#import <ImageIO/ImageIO.h>
 
 #include <stdio.h>
 
@@ -28,42 +29,205 @@ MTL::Texture* newTextureFromFile( const std::string& texturePath, MTL::Device* p
     return (__bridge_retained MTL::Texture *)texture;
 }
 
-MTL::Texture* newTextureArrayFromFiles(const std::vector<std::string>& texturePaths, MTL::Device* pDevice, MTL::CommandBuffer* pCommandBuffer)
+// Linear data (normals, roughness, SDFs) must reach the texture as the file stores
+// it. 8-bit gray, RGB and RGBA bitmaps are copied byte for byte; anything else is
+// drawn in its own color space, so there is no profile conversion, and un-premultiplied.
+static bool copyLinearPixels( CGImageRef image, texture_utils::Image& out )
 {
-    std::vector<NS::SharedPtr<MTL::Texture>> textures;
-    for (size_t i = 0; i < texturePaths.size(); ++i)
+    const CGBitmapInfo byteOrder = CGImageGetBitmapInfo(image) & kCGBitmapByteOrderMask;
+    const CGImageAlphaInfo alpha = CGImageGetAlphaInfo(image);
+    const size_t bitsPerPixel = CGImageGetBitsPerPixel(image);
+    if (!out.width || !out.height || CGImageGetBitsPerComponent(image) != 8 || (byteOrder != kCGBitmapByteOrderDefault && byteOrder != kCGBitmapByteOrder32Big)
+        || CGImageGetBitmapInfo(image) & kCGBitmapFloatComponents)
+        return (false);
+
+    uint32_t channels = 0;
+    if (bitsPerPixel == 8 && alpha == kCGImageAlphaNone)
+        channels = 1;
+    else if (bitsPerPixel == 24 && alpha == kCGImageAlphaNone)
+        channels = 3;
+    else if (bitsPerPixel == 32 && (alpha == kCGImageAlphaLast || alpha == kCGImageAlphaPremultipliedLast || alpha == kCGImageAlphaNoneSkipLast))
+        channels = 4;
+    else
+        return (false);
+
+    CFDataRef data = CGDataProviderCopyData(CGImageGetDataProvider(image));
+    if (!data)
+        return (false);
+    const uint8_t* pBytes = CFDataGetBytePtr(data);
+    const size_t bytesPerRow = CGImageGetBytesPerRow(image);
+    if ((size_t)CFDataGetLength(data) < bytesPerRow * (out.height - 1) + (size_t)out.width * channels)
     {
-        //printf("%u\n", i); // 0, 1, 2, 0, 1
-        textures.push_back( NS::TransferPtr(newTextureFromFile(texturePaths[i], pDevice)) );
+        CFRelease(data);
+        return (false);
     }
-    
-    MTL::Texture* pTexture = nullptr;
-    if (textures.size() > 0)
+    for (uint32_t y = 0; y < out.height; ++y)
+    {
+        const uint8_t* src = pBytes + bytesPerRow * y;
+        uint8_t* dst = &out.rgba[(size_t)y * out.width * 4];
+        for (uint32_t x = 0; x < out.width; ++x, src += channels, dst += 4)
+        {
+            dst[0] = src[0];
+            dst[1] = channels == 1 ? src[0] : src[1];
+            dst[2] = channels == 1 ? src[0] : src[2];
+            dst[3] = channels == 4 && alpha != kCGImageAlphaNoneSkipLast ? src[3] : 255;
+        }
+    }
+    CFRelease(data);
+    if (alpha == kCGImageAlphaPremultipliedLast)
+        texture_utils::unpremultiply(out);
+    return (true);
+}
+
+static bool decodeImageFile( const std::string& path, bool srgb, texture_utils::Image& out )
+{
+    @autoreleasepool
+    {
+        NSURL* url = [NSURL fileURLWithPath:[NSString stringWithUTF8String:path.c_str()]];
+        CGImageSourceRef source = CGImageSourceCreateWithURL((__bridge CFURLRef)url, nullptr);
+        if (!source)
+            return (false);
+        CGImageRef image = CGImageSourceCreateImageAtIndex(source, 0, nullptr);
+        CFRelease(source);
+        if (!image)
+            return (false);
+
+        out.width = (uint32_t)CGImageGetWidth(image);
+        out.height = (uint32_t)CGImageGetHeight(image);
+        out.rgba.assign((size_t)out.width * out.height * 4, 0);
+        if (!srgb && copyLinearPixels(image, out))
+        {
+            CGImageRelease(image);
+            return (true);
+        }
+
+        // CoreGraphics only draws premultiplied RGBA8. Color goes through sRGB, and stays
+        // premultiplied, which is what the mip filter wants to avoid dark fringes around
+        // transparent texels.
+        CGColorSpaceRef imageSpace = CGImageGetColorSpace(image);
+        CGColorSpaceRef colorSpace = !srgb && imageSpace && CGColorSpaceGetModel(imageSpace) == kCGColorSpaceModelRGB
+                                   ? CGColorSpaceRetain(imageSpace)
+                                   : CGColorSpaceCreateWithName(srgb ? kCGColorSpaceSRGB : kCGColorSpaceLinearSRGB);
+        CGContextRef ctx = CGBitmapContextCreate(out.rgba.data(), out.width, out.height, 8, out.width * 4,
+                                                 colorSpace, kCGImageAlphaPremultipliedLast);
+        CFRelease(colorSpace);
+        if (!ctx)
+        {
+            CGImageRelease(image);
+            return (false);
+        }
+        CGContextSetBlendMode(ctx, kCGBlendModeCopy);
+        CGContextDrawImage(ctx, CGRectMake(0, 0, out.width, out.height), image);
+        CFRelease(ctx);
+        CGImageRelease(image);
+        if (!srgb)
+            texture_utils::unpremultiply(out);
+        return (true);
+    }
+}
+
+MTL::Texture* newTextureArrayFromFiles( const std::vector<std::string>& texturePaths, MTL::Device* pDevice, MTL::CommandBuffer* pCommandBuffer,
+                                        const texture_utils::MipChainDesc& mipDesc )
+{
+    // Slices are decoded and mipped on the worker pool; each one is staged and its
+    // copies encoded as soon as it is done, in whatever order they finish.
+    // The pixel format follows mipDesc.srgb, and so does the decode.
+    const bool srgb = mipDesc.srgb;
+    texture_utils::SliceStream stream(texturePaths, [srgb]( const std::string& path, texture_utils::Image& out ) {
+        return (decodeImageFile(path, srgb, out));
+    }, mipDesc);
+
+    MTL::Texture*               pTexture = nullptr;
+    MTL::BlitCommandEncoder*    pBlit = nullptr;
+    std::vector<MTL::Buffer*>   stagingBuffers;
+    texture_utils::SliceStream::Slice slice;
+    while (stream.next(slice))
     {
-        auto pTextureDesc = NS::TransferPtr(MTL::TextureDescriptor::alloc()->init());
-        pTextureDesc->setWidth(textures[0]->width());
-        pTextureDesc->setHeight(textures[0]->height());
-        pTextureDesc->setPixelFormat(textures[0]->pixelFormat());
-        pTextureDesc->setTextureType(MTL::TextureType2DArray);
-        pTextureDesc->setUsage(MTL::TextureUsageShaderRead);
-        pTextureDesc->setStorageMode(MTL::StorageModePrivate);
-        pTextureDesc->setArrayLength(textures.size());
-        pTextureDesc->setMipmapLevelCount(std::log2(textures[0]->width()));
-        pTexture = pDevice->newTexture(pTextureDesc.get());
-        auto pAutoreleasePool = NS::TransferPtr(NS::AutoreleasePool::alloc()->init());
-        MTL::CommandBuffer* pCmd       = pCommandBuffer;
-        MTL::BlitCommandEncoder* pBlit = pCmd->blitCommandEncoder();
-        for (size_t i = 0; i < textures.size(); ++i)
+        if (!slice.ok)
+        {
+            printf("Error loading texture at \"%s\"\n", texturePaths[slice.index].c_str());
+            continue;
+        }
+        const texture_utils::Image& base = slice.levels[0];
+        if (!pTexture)
+        {
+            auto pTextureDesc = NS::TransferPtr(MTL::TextureDescriptor::alloc()->init());
+            pTextureDesc->setWidth(base.width);
+            pTextureDesc->setHeight(base.height);
+            pTextureDesc->setPixelFormat(mipDesc.srgb ? MTL::PixelFormatRGBA8Unorm_sRGB : MTL::PixelFormatRGBA8Unorm);
+            pTextureDesc->setTextureType(MTL::TextureType2DArray);
+            pTextureDesc->setUsage(MTL::TextureUsageShaderRead);
+            pTextureDesc->setStorageMode(MTL::StorageModePrivate);
+            pTextureDesc->setArrayLength(texturePaths.size());
+            pTextureDesc->setMipmapLevelCount(texture_utils::mipLevelCount(base.width, base.height));
+            pTexture = pDevice->newTexture(pTextureDesc.get());
+            pBlit = pCommandBuffer->blitCommandEncoder();
+        }
+        if (base.width != pTexture->width() || base.height != pTexture->height())
         {
-            auto w = textures[i]->width();
-            auto h = textures[i]->height();
-            auto d = textures[i]->depth();
-            
-            pBlit->copyFromTexture(textures[i].get(), 0, 0, MTL::Origin(0,0,0), MTL::Size(w,h,d),
-                                   pTexture, i, 0, MTL::Origin(0,0,0));
+            printf("Texture \"%s\" is %ux%u, the array is %lux%lu\n", texturePaths[slice.index].c_str(),
+                   base.width, base.height, pTexture->width(), pTexture->height());
+            continue;
         }
-        pBlit->generateMipmaps(pTexture);
+
+        size_t stagingSize = 0;
+        for (const texture_utils::Image& level : slice.levels)
+            stagingSize += level.rgba.size();
+        MTL::Buffer* pStaging = pDevice->newBuffer(stagingSize, MTL::ResourceStorageModeShared);
+        stagingBuffers.push_back(pStaging);
+
+        size_t offset = 0;
+        for (size_t level = 0; level < slice.levels.size(); ++level)
+        {
+            const texture_utils::Image& image = slice.levels[level];
+            memcpy((uint8_t *)pStaging->contents() + offset, image.rgba.data(), image.rgba.size());
+            pBlit->copyFromBuffer(pStaging, offset, image.width * 4, image.rgba.size(), MTL::Size(image.width, image.height, 1),
+                                  pTexture, slice.index, level, MTL::Origin(0, 0, 0));
+            offset += image.rgba.size();
+        }
+    }
+
+    if (pBlit)
+    {
         pBlit->endEncoding();
+        pCommandBuffer->addCompletedHandler([stagingBuffers]( MTL::CommandBuffer* ) {
+            for (MTL::Buffer* pStaging : stagingBuffers)
+                pStaging->release();
+        });
+    }
+    return (pTexture);
+}
+
+MTL::Texture* newTextureFromCooked( const texture_utils::CookedTexture& cooked, MTL::Device* pDevice )
+{
+    if (cooked.levels.empty())
+        return (nullptr);
+
+    MTL::PixelFormat format = MTL::PixelFormatBC5_RGUnorm;
+    if (cooked.format == texture_utils::BlockFormat::BC7)
+        format = cooked.srgb ? MTL::PixelFormatBC7_RGBAUnorm_sRGB : MTL::PixelFormatBC7_RGBAUnorm;
+
+    auto pTextureDesc = NS::TransferPtr(MTL::TextureDescriptor::alloc()->init());
+    pTextureDesc->setWidth(cooked.levels[0].width);
+    pTextureDesc->setHeight(cooked.levels[0].height);
+    pTextureDesc->setPixelFormat(format);
+    pTextureDesc->setTextureType(MTL::TextureType2D);
+    pTextureDesc->setUsage(MTL::TextureUsageShaderRead);
+    pTextureDesc->setStorageMode(MTL::StorageModeShared);
+    pTextureDesc->setMipmapLevelCount(cooked.levels.size());
+    MTL::Texture* pTexture = pDevice->newTexture(pTextureDesc.get());
+    if (!pTexture)
+    {
+        printf("Could not create a %ux%u cooked texture with %zu levels\n",
+               cooked.levels[0].width, cooked.levels[0].height, cooked.levels.size());
+        return (nullptr);
+    }
+
+    // Block formats take bytesPerRow for one row of 4x4 blocks.
+    for (size_t level = 0; level < cooked.levels.size(); ++level)
+    {
+        const texture_utils::CookedLevel& l = cooked.levels[level];
+        pTexture->replaceRegion(MTL::Region(0, 0, l.width, l.height), level, cooked.data.data() + l.offset, l.bytesPerRow);
     }
     return (pTexture);
 }
@@ -234,6 +398,231 @@ FontAtlas newFontAtlas(MTL::Device* pDevice)
     return fontAtlas;
 }
 
+text::GlyphTable newGlyphTable( const FontAtlas& fontAtlas )
+{
+    auto toUnorm16 = [](float v) -> uint16_t {
+        return (uint16_t)(std::clamp(v, 0.f, 1.f) * 65535.f + 0.5f);
+    };
+
+    text::GlyphTable table(1.2f, 1.f);
+    text::GlyphMetrics space = { 1.f, 0.f, 0.f, 0.f, 0.f, { 0, 0, 0, 0 }, 0 };
+    table.setGlyph(' ', space);
+    for (size_t i = 0; i < kNumCharacters; ++i)
+    {
+        const FontAtlas::CharUVs& uvs = fontAtlas.charToUVs[i];
+        text::GlyphMetrics metrics = { 1.f, 0.f, 1.f, 1.f, 1.f,
+                                       { toUnorm16(uvs.nw.x), toUnorm16(uvs.nw.y), toUnorm16(uvs.se.x), toUnorm16(uvs.se.y) },
+                                       0 };
+        table.setGlyph((uint32_t)g_chars[i], metrics);
+    }
+    return (table);
+}
+
+static bool rasterizeGlyph( CTFontRef font, uint32_t codepoint, text::GlyphBitmap& bitmap )
+{
+    bitmap = { codepoint, 0, 0, {}, 0.f, 0.f, 0.f };
+
+    // Outside the BMP the glyph comes from a surrogate pair; CoreText puts it in the first slot.
+    UniChar characters[2];
+    CGGlyph glyphs[2] = { 0, 0 };
+    CFIndex length = 1;
+    if (codepoint > 0xFFFF)
+    {
+        characters[0] = (UniChar)(0xD800 + ((codepoint - 0x10000) >> 10));
+        characters[1] = (UniChar)(0xDC00 + ((codepoint - 0x10000) & 0x3FF));
+        length = 2;
+    }
+    else
+    {
+        characters[0] = (UniChar)codepoint;
+    }
+    if (!CTFontGetGlyphsForCharacters(font, characters, glyphs, length))
+        return (false);
+    CGGlyph glyph = glyphs[0];
+
+    CGRect bounds;
+    CGSize advance;
+    CTFontGetBoundingRectsForGlyphs(font, kCTFontOrientationHorizontal, &glyph, &bounds, 1);
+    CTFontGetAdvancesForGlyphs(font, kCTFontOrientationHorizontal, &glyph, &advance, 1);
+    bitmap.advance = advance.width;
+    if (CGRectIsEmpty(bounds))
+        return (true);
+
+    // One pixel of slack around the ink box so antialiased edges are not clipped.
+    const CGFloat left   = std::floor(CGRectGetMinX(bounds)) - 1;
+    const CGFloat bottom = std::floor(CGRectGetMinY(bounds)) - 1;
+    bitmap.width  = (uint32_t)(std::ceil(CGRectGetMaxX(bounds)) - left) + 1;
+    bitmap.height = (uint32_t)(std::ceil(CGRectGetMaxY(bounds)) - bottom) + 1;
+    bitmap.bearingX = left;
+    bitmap.bearingY = bottom + bitmap.height;
+    bitmap.coverage.assign((size_t)bitmap.width * bitmap.height, 0);
+
+    CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceGray();
+    CGContextRef ctx = CGBitmapContextCreate(bitmap.coverage.data(), bitmap.width, bitmap.height, 8,
+                                             bitmap.width, colorSpace, kCGImageAlphaNone);
+    assert(ctx);
+    CGContextSetGrayFillColor(ctx, 1.0, 1.0);
+    CGPoint position = CGPointMake(-left, -bottom);
+    CTFontDrawGlyphs(font, &glyph, &position, 1, ctx);
+    CFRelease(ctx);
+    CFRelease(colorSpace);
+    return (true);
+}
+
+SdfFontAtlas newSdfFontAtlas( MTL::Device* pDevice, const char* fontName, const std::string& cachePath )
+{
+    text::SdfAtlasDesc desc;
+    CFStringRef name = CFStringCreateWithCString(kCFAllocatorDefault, fontName, kCFStringEncodingUTF8);
+    CTFontRef font = CTFontCreateWithName(name, desc.rasterSize, nullptr);
+    CFRelease(name);
+    desc.ascent     = CTFontGetAscent(font) / desc.rasterSize;
+    desc.lineHeight = (CTFontGetAscent(font) + CTFontGetDescent(font) + CTFontGetLeading(font)) / desc.rasterSize;
+
+    std::vector<uint32_t> codepoints;
+    for (uint32_t c = ' '; c <= '~'; ++c)
+    {
+        codepoints.push_back(c);
+    }
+
+    std::string path = cachePath;
+    if (path.empty())
+    {
+        NSString* caches = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES).firstObject;
+        path = std::string(caches.UTF8String) + "/" + fontName + ".rsdf";
+    }
+
+    const uint64_t key = text::sdfAtlasKey(fontName, codepoints, desc);
+    text::SdfAtlas atlas;
+    if (!text::loadSdfAtlas(path, key, atlas))
+    {
+        std::vector<text::GlyphBitmap> bitmaps;
+        bitmaps.reserve(codepoints.size());
+        for (uint32_t c : codepoints)
+        {
+            bitmaps.emplace_back();
+            rasterizeGlyph(font, c, bitmaps.back());
+        }
+        atlas = text::buildSdfAtlas(bitmaps, desc);
+        if (!atlas.dropped.empty())
+        {
+            // Not cached, so a later run with a larger maxSize builds it whole.
+            printf("SDF atlas for %s: %zu glyphs did not fit in %ux%u\n", fontName, atlas.dropped.size(), desc.maxSize, desc.maxSize);
+        }
+        else if (!text::saveSdfAtlas(path, key, atlas))
+        {
+            printf("Could not write SDF atlas cache to %s\n", path.c_str());
+        }
+    }
+    CFRelease(font);
+
+    auto pTextureDesc = NS::TransferPtr(MTL::TextureDescriptor::alloc()->init());
+    pTextureDesc->setWidth(atlas.width);
+    pTextureDesc->setHeight(atlas.height);
+    pTextureDesc->setPixelFormat(MTL::PixelFormatR8Unorm);
+    pTextureDesc->setTextureType(MTL::TextureType2DArray);
+    pTextureDesc->setUsage(MTL::TextureUsageShaderRead);
+    pTextureDesc->setArrayLength(1);
+    pTextureDesc->setStorageMode(MTL::StorageModeShared);
+    pTextureDesc->setMipmapLevelCount(1);
+
+    SdfFontAtlas sdfAtlas = { NS::TransferPtr(pDevice->newTexture(pTextureDesc.get())), text::makeGlyphTable(atlas), atlas.distanceRange };
+    sdfAtlas.texture->setLabel(MTLSTR("SDF Font Atlas Texture"));
+    sdfAtlas.texture->replaceRegion(MTL::Region(0, 0, atlas.width, atlas.height), 0, 0,
+                                    atlas.pixels.data(), atlas.width, atlas.pixels.size());
+    return (sdfAtlas);
+}
+
+namespace
+{
+    class CoreTextGlyphRasterizer : public text::GlyphRasterizer
+    {
+    public:
+        explicit CoreTextGlyphRasterizer( const std::vector<std::string>& fontNames )
+        {
+            for (const std::string& name : fontNames)
+            {
+                CFStringRef cfName = CFStringCreateWithCString(kCFAllocatorDefault, name.c_str(), kCFStringEncodingUTF8);
+                _baseFonts.push_back(CTFontCreateWithName(cfName, 16.0, nullptr));
+                CFRelease(cfName);
+            }
+        }
+
+        ~CoreTextGlyphRasterizer() override
+        {
+            for (auto& it : _sizedFonts)
+                CFRelease(it.second);
+            for (CTFontRef font : _baseFonts)
+                CFRelease(font);
+        }
+
+        bool rasterize( uint32_t codepoint, uint16_t font, uint16_t pixelSize, text::GlyphBitmap& out ) override
+        {
+            CTFontRef sized = sizedFont(font, pixelSize);
+            return (sized && rasterizeGlyph(sized, codepoint, out));
+        }
+
+        void lineMetrics( uint16_t font, uint16_t pixelSize, float& lineHeight, float& ascent ) override
+        {
+            CTFontRef sized = sizedFont(font, pixelSize);
+            ascent     = sized ? CTFontGetAscent(sized) : pixelSize;
+            lineHeight = sized ? CTFontGetAscent(sized) + CTFontGetDescent(sized) + CTFontGetLeading(sized) : pixelSize * 1.2f;
+        }
+
+    private:
+        CTFontRef sizedFont( uint16_t font, uint16_t pixelSize )
+        {
+            if (font >= _baseFonts.size())
+                return (nullptr);
+            const uint32_t key = ((uint32_t)font << 16) | pixelSize;
+            auto it = _sizedFonts.find(key);
+            if (it != _sizedFonts.end())
+                return (it->second);
+            CTFontRef sized = CTFontCreateCopyWithAttributes(_baseFonts[font], pixelSize, nullptr, nullptr);
+            _sizedFonts.emplace(key, sized);
+            return (sized);
+        }
+
+        std::vector<CTFontRef>                      _baseFonts;
+        std::unordered_map<uint32_t, CTFontRef>     _sizedFonts;
+    };
+}
+
+std::unique_ptr<text::GlyphRasterizer> newCoreTextRasterizer( const std::vector<std::string>& fontNames )
+{
+    return (std::make_unique<CoreTextGlyphRasterizer>(fontNames));
+}
+
+MTL::Texture* newGlyphCacheTexture( MTL::Device* pDevice, const text::GlyphCache& cache )
+{
+    auto pTextureDesc = NS::TransferPtr(MTL::TextureDescriptor::alloc()->init());
+    pTextureDesc->setWidth(cache.width());
+    pTextureDesc->setHeight(cache.height());
+    pTextureDesc->setPixelFormat(MTL::PixelFormatR8Unorm);
+    pTextureDesc->setTextureType(MTL::TextureType2DArray);
+    pTextureDesc->setUsage(MTL::TextureUsageShaderRead);
+    pTextureDesc->setArrayLength(cache.pages());
+    pTextureDesc->setStorageMode(MTL::StorageModeShared);
+    pTextureDesc->setMipmapLevelCount(1);
+    // TextGlyphPs reads coverage from alpha.
+    pTextureDesc->setSwizzle(MTL::TextureSwizzleChannels(MTL::TextureSwizzleOne, MTL::TextureSwizzleOne,
+                                                         MTL::TextureSwizzleOne, MTL::TextureSwizzleRed));
+
+    MTL::Texture* pTexture = pDevice->newTexture(pTextureDesc.get());
+    pTexture->setLabel(MTLSTR("Glyph Cache Texture"));
+    return (pTexture);
+}
+
+void uploadGlyphCache( MTL::Texture* pTexture, const text::GlyphCache& cache )
+{
+    const NS::UInteger bytesPerRow = cache.width();
+    for (const text::GlyphUpload& upload : cache.uploads())
+    {
+        const uint8_t* pSource = cache.pixels(upload.page) + (size_t)upload.y * bytesPerRow + upload.x;
+        pTexture->replaceRegion(MTL::Region(upload.x, upload.y, upload.width, upload.height), 0, upload.page,
+                                pSource, bytesPerRow, 0);
+    }
+}
+
 FiraCode newFiraCode( MTL::Device* pDevice )
 {
     FiraCode firaCode;
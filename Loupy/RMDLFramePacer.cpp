@@ -0,0 +1,252 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLFramePacer.cpp           +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 00:52:44      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLFramePacer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace frame_pacing
+{
+
+#pragma mark - PercentileWindow
+
+PercentileWindow::PercentileWindow( uint32_t capacity )
+: _capacity( std::max(1u, capacity) )
+, _next( 0 )
+{
+    _values.reserve(_capacity);
+}
+
+void PercentileWindow::push( double value )
+{
+    if (_values.size() < _capacity)
+        _values.push_back(value);
+    else
+        _values[_next] = value;
+    _next = (_next + 1) % _capacity;
+}
+
+double PercentileWindow::percentile( double p ) const
+{
+    if (_values.empty())
+        return (0.0);
+    // Nearest rank.
+    _scratch = _values;
+    const double rank = std::ceil(std::clamp(p, 0.0, 1.0) * (double)_scratch.size());
+    const size_t k = (size_t)std::max(1.0, rank) - 1;
+    std::nth_element(_scratch.begin(), _scratch.begin() + k, _scratch.end());
+    return (_scratch[k]);
+}
+
+#pragma mark - FramePacer
+
+FramePacer::FramePacer( const PacerConfig& config )
+: _config( config )
+, _cpu( config.window )
+, _gpu( config.window )
+, _serial( config.window )
+, _overlap( config.window )
+, _interval( config.window )
+, _latency( config.window )
+, _wantedFor( 0 )
+, _lastStart( -1.0 )
+, _lastPresent( -1.0 )
+, _serialP99( 0.0 )
+, _lastInterval( config.targetInterval )
+, _lateFrames( 0 )
+, _depthChanges( 0 )
+{
+    // A frame is accounted for maxInFlight frames after it starts, while its record is still kept.
+    _config.maxInFlight = std::clamp(_config.maxInFlight, 1u, kRecordCount - 2);
+    _config.minInFlight = std::clamp(_config.minInFlight, 1u, _config.maxInFlight);
+    _inFlight = _config.maxInFlight;
+    _wanted = _inFlight;
+}
+
+uint32_t FramePacer::inFlight() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return (_inFlight);
+}
+
+uint64_t FramePacer::waitTarget( uint64_t frame ) const
+{
+    const uint32_t depth = inFlight();
+    return (frame > depth ? frame - depth : 0);
+}
+
+double FramePacer::startTime( double now ) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_lastPresent < 0.0 || _serialP99 <= 0.0)
+        return (now);
+    // Presents land on vsyncs: the first one the frame can make with some margin,
+    // minus the time it takes. Only while the frames in flight cover that time,
+    // otherwise the queue is what keeps the GPU busy.
+    const double margin = _serialP99 / _config.headroom;
+    if (margin > _inFlight * _config.targetInterval)
+        return (now);
+    const double vsyncs = std::ceil((now + margin - _lastPresent) / _config.targetInterval);
+    const double present = _lastPresent + std::max(1.0, vsyncs) * _config.targetInterval;
+    return (std::max(now, present - margin));
+}
+
+FramePacer::FrameRecord& FramePacer::record( uint64_t frame )
+{
+    return (_records[frame % kRecordCount]);
+}
+
+void FramePacer::beginFrame( uint64_t frame, double now )
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_lastStart >= 0.0)
+    {
+        _lastInterval = now - _lastStart;
+        _interval.push(_lastInterval);
+        if (_lastInterval > 1.5 * _config.targetInterval)
+            ++_lateFrames;
+    }
+    _lastStart = now;
+
+    // The frame maxInFlight + 1 back has been waited for, and its feedback is in by now.
+    const uint64_t done = frame - std::min<uint64_t>(frame, _config.maxInFlight + 1);
+    if (done > 0 && record(done).frame == done)
+    {
+        account(record(done));
+        adapt();
+    }
+
+    FrameRecord& current = record(frame);
+    current = FrameRecord();
+    current.frame = frame;
+    current.cpuStart = now;
+}
+
+void FramePacer::blocked( uint64_t frame, double seconds )
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    FrameRecord& current = record(frame);
+    if (current.frame == frame)
+        current.blocked += seconds;
+}
+
+void FramePacer::latchInput( uint64_t frame, double now )
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    FrameRecord& current = record(frame);
+    if (current.frame == frame)
+    {
+        current.inputLatch = now;
+        current.hasLatch = true;
+    }
+}
+
+void FramePacer::endCpu( uint64_t frame, double now )
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    FrameRecord& current = record(frame);
+    if (current.frame == frame)
+        current.cpuEnd = now;
+}
+
+void FramePacer::gpuCompleted( uint64_t frame, double gpuStart, double gpuEnd )
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    FrameRecord& current = record(frame);
+    if (current.frame != frame)
+        return;
+    current.gpuStart = current.hasGpu ? std::min(current.gpuStart, gpuStart) : gpuStart;
+    current.gpuEnd = current.hasGpu ? std::max(current.gpuEnd, gpuEnd) : gpuEnd;
+    current.hasGpu = true;
+}
+
+void FramePacer::presented( uint64_t frame, double presentTime )
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    const FrameRecord& current = record(frame);
+    // presentTime is 0 for a drawable that was never shown.
+    if (presentTime <= 0.0)
+        return;
+    _lastPresent = std::max(_lastPresent, presentTime);
+    if (current.frame == frame && current.hasLatch && presentTime > current.inputLatch)
+        _latency.push(presentTime - current.inputLatch);
+}
+
+void FramePacer::account( const FrameRecord& done )
+{
+    const double cpu = std::max(0.0, done.cpuEnd - done.cpuStart - done.blocked);
+    _cpu.push(cpu);
+    if (!done.hasGpu)
+        return;
+    // Several command buffers may have idle gaps between them; the span is what a
+    // single frame in flight would have to wait for.
+    const double gpu = std::max(0.0, done.gpuEnd - done.gpuStart);
+    _gpu.push(gpu);
+    _serial.push(cpu + gpu);
+    _overlap.push(std::max(cpu, gpu));
+}
+
+void FramePacer::adapt()
+{
+    // Not enough history yet to trade latency away safely.
+    if (_serial.count() < std::min(_config.window, 30u))
+        return;
+    const double budget = _config.targetInterval * _config.headroom;
+    _serialP99 = _serial.percentile(0.99);
+    uint32_t wanted = 3;
+    if (_serialP99 <= budget)
+        wanted = 1;
+    else if (_overlap.percentile(0.99) <= budget)
+        wanted = 2;
+    wanted = std::clamp(wanted, _config.minInFlight, _config.maxInFlight);
+
+    if (wanted != _wanted)
+    {
+        _wanted = wanted;
+        _wantedFor = 0;
+    }
+    ++_wantedFor;
+    if (_wanted == _inFlight)
+        return;
+    // Deeper quickly, since a miss is visible; shallower only once it has been safe for a while.
+    const uint32_t after = _wanted > _inFlight ? _config.raiseAfter : _config.lowerAfter;
+    if (_wantedFor >= after)
+    {
+        _inFlight = _wanted;
+        ++_depthChanges;
+    }
+}
+
+double FramePacer::lastFrameInterval() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return (_lastInterval);
+}
+
+PacingStats FramePacer::stats() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    PacingStats out;
+    out.cpuP50 = _cpu.percentile(0.50);
+    out.cpuP99 = _cpu.percentile(0.99);
+    out.gpuP50 = _gpu.percentile(0.50);
+    out.gpuP99 = _gpu.percentile(0.99);
+    out.frameP50 = _interval.percentile(0.50);
+    out.frameP99 = _interval.percentile(0.99);
+    out.latencyP50 = _latency.percentile(0.50);
+    out.latencyP99 = _latency.percentile(0.99);
+    out.inFlight = _inFlight;
+    out.lateFrames = _lateFrames;
+    out.depthChanges = _depthChanges;
+    return (out);
+}
+
+}
@@ -0,0 +1,147 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLFramePacer.hpp           +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 00:52:37      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLFRAMEPACER_HPP
+# define RMDLFRAMEPACER_HPP
+
+# include <cstdint>
+# include <mutex>
+# include <vector>
+
+// Frame pacing for the in-flight frame loop. The pacer is told when each frame's
+// CPU work starts and ends, when its GPU work ran and when it was presented, and
+// from that picks how many frames may be in flight: one when CPU and GPU together
+// fit in the frame interval (lowest latency), two when they only fit side by
+// side, three when even that is tight. With one in flight it also delays the
+// start of a frame so that it completes right before the vsync it is shown at.
+// Timestamps are seconds on any clock shared
+// by every caller, so a simulated one works as well as the host's. GPU and
+// presentation reports may come from other threads.
+
+namespace frame_pacing
+{
+    /// The last `capacity` samples, with percentiles over them.
+    class PercentileWindow
+    {
+    public:
+        explicit PercentileWindow( uint32_t capacity );
+
+        void        push( double value );
+        /// `p` in [0, 1]; 0 with no samples.
+        double      percentile( double p ) const;
+        uint32_t    count() const       { return ((uint32_t)_values.size()); }
+        void        clear()             { _values.clear(); _next = 0; }
+
+    private:
+        std::vector<double>     _values;
+        uint32_t                _capacity;
+        uint32_t                _next;
+        mutable std::vector<double> _scratch;
+    };
+
+    struct PacerConfig
+    {
+        double      targetInterval  = 1.0 / 60.0;
+        uint32_t    minInFlight     = 1;
+        uint32_t    maxInFlight     = 3;
+        double      headroom        = 0.85;     // share of the interval a prediction may use
+        uint32_t    window          = 120;      // frames the percentiles cover
+        uint32_t    raiseAfter      = 4;        // frames a deeper pipeline is wanted before switching
+        uint32_t    lowerAfter      = 90;       // same for a shallower one
+    };
+
+    struct PacingStats
+    {
+        double      cpuP50          = 0;
+        double      cpuP99          = 0;
+        double      gpuP50          = 0;
+        double      gpuP99          = 0;
+        double      frameP50        = 0;    // start to start
+        double      frameP99        = 0;
+        double      latencyP50      = 0;    // input latch to present
+        double      latencyP99      = 0;
+        uint32_t    inFlight        = 0;
+        uint64_t    lateFrames      = 0;    // interval over 1.5 targets
+        uint64_t    depthChanges    = 0;
+    };
+
+    class FramePacer
+    {
+    public:
+        explicit FramePacer( const PacerConfig& config = PacerConfig() );
+
+        uint32_t    inFlight() const;
+        /// The frame that has to be complete before `frame` may start; 0 for none.
+        uint64_t    waitTarget( uint64_t frame ) const;
+
+        /// With one frame in flight, when to start the next one so it finishes just
+        /// before a vsync instead of queueing for one; `now` when there is nothing to gain.
+        double      startTime( double now ) const;
+
+        /// Render thread, in frame order.
+        void        beginFrame( uint64_t frame, double now );
+        /// Time spent waiting rather than working (drawable acquisition); not CPU time.
+        void        blocked( uint64_t frame, double seconds );
+        /// When the frame sampled input and camera, as late as possible.
+        void        latchInput( uint64_t frame, double now );
+        /// Everything is submitted.
+        void        endCpu( uint64_t frame, double now );
+
+        /// Any thread. GPU spans of one frame may come in several reports; the
+        /// frame is accounted for once maxInFlight frames have started after it.
+        void        gpuCompleted( uint64_t frame, double gpuStart, double gpuEnd );
+        void        presented( uint64_t frame, double presentTime );
+
+        /// Start-to-start time of the last frame, for animation.
+        double      lastFrameInterval() const;
+        PacingStats stats() const;
+
+    private:
+        struct FrameRecord
+        {
+            uint64_t    frame       = 0;
+            double      cpuStart    = 0;
+            double      cpuEnd      = 0;
+            double      blocked     = 0;
+            double      gpuStart    = 0;
+            double      gpuEnd      = 0;
+            double      inputLatch  = 0;
+            bool        hasGpu      = false;
+            bool        hasLatch    = false;
+        };
+
+        FrameRecord&    record( uint64_t frame );
+        void            account( const FrameRecord& record );
+        void            adapt();
+
+        static constexpr uint32_t kRecordCount = 8;
+
+        PacerConfig         _config;
+        mutable std::mutex  _mutex;
+        FrameRecord         _records[kRecordCount];
+        PercentileWindow    _cpu;
+        PercentileWindow    _gpu;
+        PercentileWindow    _serial;    // cpu + gpu: the interval with one frame in flight
+        PercentileWindow    _overlap;   // max(cpu, gpu): the interval with several
+        PercentileWindow    _interval;
+        PercentileWindow    _latency;
+        uint32_t            _inFlight;
+        uint32_t            _wanted;
+        uint32_t            _wantedFor;
+        double              _lastStart;
+        double              _lastPresent;
+        double              _serialP99;
+        double              _lastInterval;
+        uint64_t            _lateFrames;
+        uint64_t            _depthChanges;
+    };
+}
+
+#endif /* RMDLFRAMEPACER_HPP */
@@ -16,6 +16,7 @@
 #include <MetalFX/MetalFX.hpp>
 
 #include <simd/simd.h>
+#include <chrono>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -23,37 +24,93 @@
 #include <stdio.h>
 #include <iostream>
 #include <memory>
+#include <filesystem>
 #include <thread>
 #include <sys/sysctl.h>
+#include <time.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "RMDLGameRendererLoupy.hpp"
 #include "RMDLUtilities.h"
+#include "RMDLRenderGraphExecutor.hpp"
+#include "RMDLMetalRecordingBackend.hpp"
+#include "RMDLResidencyManager.hpp"
 
 #define kMaxFramesInFlight 3
 
+// Share of the device's recommended working set the budgeted residency set may use.
+static constexpr double kResidencyBudgetRatio = 0.75;
+
+// Seconds on the clock Metal reports GPU and presentation times on.
+static double hostTime()
+{
+    return ((double)clock_gettime_nsec_np(CLOCK_UPTIME_RAW) * 1e-9);
+}
+
+static frame_pacing::PacerConfig pacerConfig()
+{
+    frame_pacing::PacerConfig config;
+    config.maxInFlight = kMaxFramesInFlight;
+    return (config);
+}
+
+// Camera speeds for held input: units per second, radians per second, radians per mouse point.
+static constexpr float kCameraMoveSpeed = 2.0f;
+static constexpr float kCameraTurnSpeed = 1.5f;
+static constexpr float kMouseSensitivity = 0.009f;
+
+// One step's worth of input as a camera command. Held time rather than key
+// repeats drives the motion, so its speed is the same at any frame or step rate.
+static simulation::CameraCommand cameraCommand( const input::InputState& state, uint64_t step )
+{
+    using input::Axis;
+    using input::Button;
+    const float dt = (float)(state.end - state.start);
+    simulation::CameraCommand command;
+    command.step = step;
+    command.move[0] = kCameraMoveSpeed * (state.held(Button::KeyD) - state.held(Button::KeyA) + state.axis(Axis::LeftStickX) * dt);
+    command.move[1] = kCameraMoveSpeed * (state.held(Button::KeyQ) - state.held(Button::KeyE));
+    command.move[2] = kCameraMoveSpeed * (state.held(Button::KeyS) - state.held(Button::KeyW) - state.axis(Axis::LeftStickY) * dt);
+    command.yaw = kCameraTurnSpeed * (state.held(Button::RightArrow) - state.held(Button::LeftArrow) + state.axis(Axis::RightStickX) * dt)
+                + kMouseSensitivity * state.mouseDelta[0];
+    command.pitch = kCameraTurnSpeed * (state.held(Button::UpArrow) - state.held(Button::DownArrow) + state.axis(Axis::RightStickY) * dt)
+                  + kMouseSensitivity * state.mouseDelta[1];
+    return (command);
+}
+
+static std::string pipelineManifestPath()
+{
+    return ((std::filesystem::temp_directory_path() / "Loupy.pipelines").string());
+}
+
 GameCoordinatorLoupy::GameCoordinatorLoupy( MTL::Device* pDevice, MTL::PixelFormat layerPixelFormat, NS::UInteger w, NS::UInteger h )
     : _pPixelFormat(layerPixelFormat)
+    , _pPacer(std::make_shared<frame_pacing::FramePacer>(pacerConfig()))
     , _pDevice(pDevice->retain())
+    , _currentFrameIndex(0)
     , _frame(0)
     , _pShaderLibrary(nullptr)
+    , _lastLatchTime(-1.0)
 {
     _pCommandQueue = _pDevice->newMTL4CommandQueue();
     _pShaderLibrary = _pDevice->newDefaultLibrary();
     
     _sharedEvent = _pDevice->newSharedEvent();
     _sharedEvent->setSignaledValue(_currentFrameIndex);
-    
-    _semaphore = dispatch_semaphore_create( kMaxFramesInFlight );
 
-    NS::Error* pError = nullptr;
-    
-    for (uint8_t i = 0; i < kMaxFramesInFlight; i++)
-    {
-        _pCommandAllocator[i] = _pDevice->newCommandAllocator();
 
-        _pShadowPassDataBuffer[i] = _pDevice->newBuffer( sizeof(simd::float4x4), MTL::ResourceStorageModeShared );
+    // Each cascade writes its matrix while earlier frames may still read theirs.
+    NS::SharedPtr<MTL4::ArgumentTableDescriptor> shadowTableDesc = NS::TransferPtr( MTL4::ArgumentTableDescriptor::alloc()->init() );
+    shadowTableDesc->setMaxBufferBindCount(1);
+    for (uint32_t cascade = 0; cascade < kShadowCascadeCount; ++cascade)
+    {
+        for (uint8_t i = 0; i < kMaxFramesInFlight; i++)
+        {
+            _pShadowPassDataBuffer[i][cascade] = _pDevice->newBuffer( sizeof(simd::float4x4), MTL::ResourceStorageModeShared );
+        }
+        NS::Error* pError = nullptr;
+        _pShadowArgumentTable[cascade] = _pDevice->newArgumentTable( shadowTableDesc.get(), &pError );
     }
     //    buildJDLVPipelines();
     //    buildDepthStencilStates();
@@ -65,157 +122,227 @@ GameCoordinatorLoupy::GameCoordinatorLoupy( MTL::Device* pDevice, MTL::PixelForm
     ft_memcpy(_pViewportSizeBuffer->contents(), &_pViewportSize, sizeof(_pViewportSize));
 
     _brushSize = 1000.0f;
-    {
-        static const NS::UInteger shadowWidth = 1024;
-        _pTextureDesc = MTL::TextureDescriptor::texture2DDescriptor( MTL::PixelFormatDepth32Float, shadowWidth, shadowWidth, false );
-        _pTextureDesc->setTextureType( MTL::TextureType2DArray );
-        _pTextureDesc->setArrayLength(3);
-        _pTextureDesc->setUsage( MTL::TextureUsageRenderTarget) ;
-        _pTextureDesc->setStorageMode( MTL::StorageModePrivate );
-        _shadowMap = _pDevice->newTexture(_pTextureDesc);
-        _shadowMap->setLabel(MTLSTR("Shadow"));
-    }
+
+    // Camera motion runs on fixed steps; draw() shows it blended between the last two.
+    _pCameraLoop = std::make_unique<simulation::FixedStepLoop<simulation::CameraState>>(
+        simulation::ClockConfig(), simulation::CameraState(),
+        [this]( simulation::CameraState& state, uint64_t step, double dt ) {
+            // Steps run inside advance() at the latch; the last one due ends `alpha`
+            // steps before the latch, and each one takes the input of its own span.
+            const double end = _lastLatchTime - ((double)(_pCameraLoop->nextStep() - 1 - step) + _pCameraLoop->alpha()) * dt;
+            _cameraController.queue(cameraCommand(_input.tick(end - dt, end), step));
+            _cameraController.step(state, step, dt);
+        },
+        simulation::interpolate );
 
     NS::SharedPtr<MTL::DepthStencilDescriptor> depthStateDesc = NS::TransferPtr( MTL::DepthStencilDescriptor::alloc()->init() );
     depthStateDesc->setDepthCompareFunction( MTL::CompareFunctionLess );
     depthStateDesc->setDepthWriteEnabled( true );
-
-    
-    _shadowPassDesc->depthAttachment()->setTexture(_shadowMap);
-    _shadowPassDesc->depthAttachment()->setClearDepth( 1.f );
-    _shadowPassDesc->depthAttachment()->setLoadAction( MTL::LoadActionClear );
-    _shadowPassDesc->depthAttachment()->setStoreAction( MTL::StoreActionStore );
-
     _shadowDepthState = _pDevice->newDepthStencilState(depthStateDesc.get());
-
-    _gBufferPassDesc->depthAttachment()->setClearDepth( 1.0f );
-    _gBufferPassDesc->depthAttachment()->setLevel(0);
-    _gBufferPassDesc->depthAttachment()->setSlice(0);
-    _gBufferPassDesc->depthAttachment()->setTexture( _shadowMap );
-    _gBufferPassDesc->depthAttachment()->setLoadAction( MTL::LoadActionClear );
-    _gBufferPassDesc->depthAttachment()->setStoreAction( MTL::StoreActionStore );
-
-    _gBufferPassDesc->colorAttachments()->object(0)->setLoadAction( MTL::LoadActionDontCare );
-    _gBufferPassDesc->colorAttachments()->object(0)->setStoreAction( MTL::StoreActionStore );
-    _gBufferPassDesc->colorAttachments()->object(1)->setLoadAction( MTL::LoadActionDontCare );
-    _gBufferPassDesc->colorAttachments()->object(1)->setStoreAction( MTL::StoreActionStore );
-
-    depthStateDesc->setDepthCompareFunction( MTL::CompareFunctionLess );
-    depthStateDesc->setDepthWriteEnabled( true );
-
     _gBufferDepthState = _pDevice->newDepthStencilState(depthStateDesc.get());
 
-    _gBufferWithLoadPassDesc = _gBufferPassDesc;
-    _gBufferWithLoadPassDesc->depthAttachment()->setLoadAction( MTL::LoadActionLoad );
-    _gBufferWithLoadPassDesc->colorAttachments()->object(0)->setLoadAction( MTL::LoadActionLoad );
-    _gBufferWithLoadPassDesc->colorAttachments()->object(1)->setLoadAction( MTL::LoadActionLoad );
-
-    _lightingPassDesc->colorAttachments()->object(0)->setLoadAction( MTL::LoadActionDontCare );
-    _lightingPassDesc->colorAttachments()->object(0)->setStoreAction( MTL::StoreActionStore );
-
     depthStateDesc->setDepthCompareFunction( MTL::CompareFunctionAlways );
     depthStateDesc->setDepthWriteEnabled( false );
     _lightingDepthState = _pDevice->newDepthStencilState(depthStateDesc.get());
     {
-        NS::SharedPtr<MTL4::RenderPipelineDescriptor> pRenderPipDesc = NS::TransferPtr( MTL4::RenderPipelineDescriptor::alloc()->init() );
-        pRenderPipDesc->setLabel(MTLSTR("Lighting"));
-
-        NS::SharedPtr<MTL4::LibraryFunctionDescriptor> vertexFunction = NS::TransferPtr( MTL4::LibraryFunctionDescriptor::alloc()->init() );
-        vertexFunction->setName(MTLSTR("LightingVs"));
-        vertexFunction->setLibrary(_pShaderLibrary);
-        pRenderPipDesc->setVertexFunctionDescriptor(vertexFunction.get());
-
-        NS::SharedPtr<MTL4::LibraryFunctionDescriptor> fragmentFunction = NS::TransferPtr( MTL4::LibraryFunctionDescriptor::alloc()->init() );
-        fragmentFunction->setName( NS::String::string( "LightingPs", NS::ASCIIStringEncoding ) );
-        fragmentFunction->setLibrary(_pShaderLibrary);
-        pRenderPipDesc->setFragmentFunctionDescriptor(fragmentFunction.get());
-
-        pRenderPipDesc->setRasterSampleCount(1);
-        pRenderPipDesc->colorAttachments()->object(0)->setPixelFormat( MTL::PixelFormatRGBA16Float );
-
-        NS::SharedPtr<MTL4::Compiler> compiler = NS::TransferPtr(_pDevice->newCompiler( MTL4::CompilerDescriptor::alloc()->init(), &pError ));
-        _pPSO = compiler->newRenderPipelineState(pRenderPipDesc.get(), nullptr, &pError);
-
+        // Compiled on the worker pool; draw() skips the passes whose pipeline is not ready yet.
+        _pPipelineCompiler = std::make_unique<MetalPipelineCompiler>(_pDevice, _pShaderLibrary);
+        _pPipelines = std::make_unique<pipeline_cache::PipelineManager>(*_pPipelineCompiler);
+        _pPipelines->prewarm(pipelineManifestPath());
+
+        pipeline_cache::PipelineDesc lightingDesc;
+        lightingDesc.label = "Lighting";
+        lightingDesc.vertexFunction = "LightingVs";
+        lightingDesc.fragmentFunction = "LightingPs";
+        lightingDesc.colorFormats[0] = MTL::PixelFormatRGBA16Float;
+        _lightingPSO = _pPipelines->request(lightingDesc);
+
+        pipeline_cache::PipelineDesc mousePositionDesc;
+        mousePositionDesc.kind = pipeline_cache::PipelineKind::Compute;
+        mousePositionDesc.label = "mousePositionUpdate";
+        mousePositionDesc.computeFunction = "mousePositionUpdate";
+        mousePositionDesc.threadGroupSizeIsMultipleOfExecutionWidth = true;
+        _mousePositionKnl = _pPipelines->request(mousePositionDesc);
 
         simd::float4 initialMouseWorldPos = (simd::float4){ 0.f, 0.f, 0.f, 0.f };
         _mouseBuffer = _pDevice->newBuffer( &initialMouseWorldPos, sizeof(initialMouseWorldPos), MTL::ResourceStorageModeManaged );
 
-        MTL4::ComputePipelineDescriptor *pPipStateDesc = MTL4::ComputePipelineDescriptor::alloc()->init();
-        pPipStateDesc->setThreadGroupSizeIsMultipleOfThreadExecutionWidth(true);
-
-
-        NS::SharedPtr<MTL::Function> computeFunction = NS::TransferPtr(_pShaderLibrary->newFunction(MTLSTR("mousePositionUpdate")));
-        _mousePositionComputeKnl = _pDevice->newComputePipelineState(computeFunction.get(), 0, nullptr, &pError);
-
-
-
-        NS::SharedPtr<MTL::ResidencySetDescriptor> residencySetDescriptor =
-            NS::TransferPtr( MTL::ResidencySetDescriptor::alloc()->init() );
-        _pResidencySet = _pDevice->newResidencySet(residencySetDescriptor.get(), &pError);
-        _pResidencySet->requestResidency();
-        for (uint8_t i = 0u; i < kMaxFramesInFlight; ++i)
+        // Meshes and textures are tracked here as they stream in and listed in
+        // _frameAllocations for the frames that draw them; draw() marks the list
+        // and commits the set once per frame.
+        const uint64_t residencyBudget = (uint64_t)(_pDevice->recommendedMaxWorkingSetSize() * kResidencyBudgetRatio);
+        _pResidency = std::make_unique<ResidencyManager>(_pDevice, residencyBudget, kMaxFramesInFlight);
+        const residency::AllocationId viewportSize = _pResidency->track(_pViewportSizeBuffer, residency::Priority::Pinned);
+        for (uint8_t i = 0; i < kMaxFramesInFlight; ++i)
         {
+            _frameAllocations[i].push_back(viewportSize);
+            for (uint32_t cascade = 0; cascade < kShadowCascadeCount; ++cascade)
+                _frameAllocations[i].push_back(_pResidency->track(_pShadowPassDataBuffer[i][cascade], residency::Priority::Pinned));
         }
-        _pResidencySet->addAllocation(_pViewportSizeBuffer);
-        _pResidencySet->commit();
-        _pCommandQueue->addResidencySet(_pResidencySet); // .get() is for struct
+        _pResidency->endFrame();
+        _pCommandQueue->addResidencySet(_pResidency->residencySet());
+    }
+
+    _pRecordingBackend = std::make_unique<MetalRecordingBackend>(_pDevice, _pCommandQueue);
+    _pRecorder = std::make_unique<command_recording::ParallelRecorder>(*_pRecordingBackend, kMaxFramesInFlight);
+    _pGraphExecutor = std::make_unique<RenderGraphExecutor>(_pDevice, kMaxFramesInFlight);
+    _pCommandQueue->addResidencySet(_pGraphExecutor->residencySet());
+    buildFrameGraph( (uint32_t)w, (uint32_t)h );
+}
+
+void GameCoordinatorLoupy::buildFrameGraph( uint32_t width, uint32_t height )
+{
+    using namespace render_graph;
+
+    // Attachments, load/store actions, barriers and ordering all come from the
+    // declarations below; see RenderGraph::compile().
+    _frameGraph = RenderGraph();
+    const float clearDepth[4] = { 1.f, 0.f, 0.f, 0.f };
+    const float clearColor[4] = { 0.f, 0.f, 0.f, 0.f };
+
+    const ResourceId shadow = _frameGraph.createTexture( "Shadow", { kShadowMapSize, kShadowMapSize, kShadowCascadeCount, MTL::PixelFormatDepth32Float, 0 } );
+    const ResourceId gBuffer0 = _frameGraph.createTexture( "GBuffer0", { width, height, 1, MTL::PixelFormatRGBA8Unorm_sRGB, 0 } );
+    const ResourceId gBuffer1 = _frameGraph.createTexture( "GBuffer1", { width, height, 1, MTL::PixelFormatRGBA16Float, 0 } );
+    const ResourceId depth = _frameGraph.createTexture( "Depth", { width, height, 1, MTL::PixelFormatDepth32Float, 0 } );
+    const ResourceId lit = _frameGraph.createTexture( "Lit", { width, height, 1, MTL::PixelFormatRGBA16Float, 0 } );
+    _frameGraph.markOutput(lit);
+    _mouseResource = _frameGraph.importResource( "Mouse", { 0, 0, 1, 0, sizeof(simd::float4) } );
+
+    for (uint32_t cascade = 0; cascade < kShadowCascadeCount; ++cascade)
+    {
+        const PassId pass = _frameGraph.addPass( "Shadow " + std::to_string(cascade), PassKind::Render, [this, cascade]( const PassContext& context ) {
+            MTL4::RenderCommandEncoder* pEncoder = context.encoder<MTL4::RenderCommandEncoder>();
+            pEncoder->setCullMode( MTL::CullModeFront );
+            pEncoder->setDepthClipMode( MTL::DepthClipModeClamp );
+            pEncoder->setDepthStencilState( _shadowDepthState );
+            pEncoder->setViewport( MTL::Viewport { 0.0, 0.0, (double)kShadowMapSize, (double)kShadowMapSize, 0.0, 1.0 } );
+            pEncoder->setScissorRect( MTL::ScissorRect { 0, 0, kShadowMapSize, kShadowMapSize } );
+            MTL::Buffer* pShadowPassData = _pShadowPassDataBuffer[_currentFrameIndex % kMaxFramesInFlight][cascade];
+            ft_memcpy(pShadowPassData->contents(), &_uniforms_cpu->shadowCameraUniforms[cascade].viewProjectionMatrix,
+                      sizeof(_uniforms_cpu->shadowCameraUniforms[cascade].viewProjectionMatrix));
+            _pShadowArgumentTable[cascade]->setAddress( pShadowPassData->gpuAddress(), 0 );
+            pEncoder->setArgumentTable( _pShadowArgumentTable[cascade], MTL::RenderStageVertex );
+        } );
+        _frameGraph.clear( pass, shadow, Access::DepthAttachment, clearDepth, cascade );
     }
+
+    const PassId gBufferPass = _frameGraph.addPass( "GBuffer", PassKind::Render, [this]( const PassContext& context ) {
+        MTL4::RenderCommandEncoder* pEncoder = context.encoder<MTL4::RenderCommandEncoder>();
+        pEncoder->setCullMode( MTL::CullModeBack );
+        pEncoder->setDepthStencilState( _gBufferDepthState );
+    } );
+    _frameGraph.clear( gBufferPass, gBuffer0, Access::ColorAttachment, clearColor );
+    _frameGraph.clear( gBufferPass, gBuffer1, Access::ColorAttachment, clearColor );
+    _frameGraph.clear( gBufferPass, depth, Access::DepthAttachment, clearDepth );
+
+    const PassId mousePass = _frameGraph.addPass( "CCE2knlMousePos", PassKind::Compute, [this]( const PassContext& context ) {
+        if (MTL::ComputePipelineState* pMousePositionKnl = _mousePositionKnl.as<MTL::ComputePipelineState>())
+            context.encoder<MTL4::ComputeCommandEncoder>()->setComputePipelineState( pMousePositionKnl );
+    } );
+    _frameGraph.read( mousePass, depth );
+    _frameGraph.write( mousePass, _mouseResource, Access::ShaderWrite );
+    _frameGraph.setSideEffects( mousePass );
+
+    const PassId lightingPass = _frameGraph.addPass( "Lighting", PassKind::Render, [this]( const PassContext& context ) {
+        MTL4::RenderCommandEncoder* pEncoder = context.encoder<MTL4::RenderCommandEncoder>();
+        pEncoder->setDepthStencilState( _lightingDepthState );
+        if (MTL::RenderPipelineState* pLightingPSO = _lightingPSO.as<MTL::RenderPipelineState>())
+            pEncoder->setRenderPipelineState( pLightingPSO );
+    } );
+    _frameGraph.read( lightingPass, gBuffer0 );
+    _frameGraph.read( lightingPass, gBuffer1 );
+    _frameGraph.read( lightingPass, depth );
+    _frameGraph.read( lightingPass, shadow );
+    _frameGraph.clear( lightingPass, lit, Access::ColorAttachment, clearColor );
+
+    CompileOptions options;
+    // Three command buffers recorded in parallel, cut into runs of equal cost:
+    // [Shadow 0, Shadow 1], [Shadow 2, GBuffer], [CCE2knlMousePos, Lighting].
+    options.maxBatches = 3;
+    options.heapSizeAndAlign = _pGraphExecutor->heapSizeAndAlign();
+    _compiledFrame = _frameGraph.compile(options);
 }
 
 GameCoordinatorLoupy::~GameCoordinatorLoupy()
 {
+    // Presented handlers may still fire after the GPU is done; they hold their
+    // own reference to the pacer, so nothing they touch goes away with us.
+    _sharedEvent->waitUntilSignaledValue(_currentFrameIndex, DISPATCH_TIME_FOREVER);
+    _pRecordingBackend->setCommitFeedback( nullptr );
     for (uint8_t i = 0; i < kMaxFramesInFlight; ++i)
     {
         _pTriangleDataBuffer[i]->release();
-        _pCommandAllocator[i]->release();
         _pInstanceDataBuffer[i]->release();
         _pJDLVStateBuffer[i]->release();
         _pGridBuffer_A[i]->release();
         _pGridBuffer_B[i]->release();
+        for (uint32_t cascade = 0; cascade < kShadowCascadeCount; ++cascade)
+            _pShadowPassDataBuffer[i][cascade]->release();
     }
+    for (uint32_t cascade = 0; cascade < kShadowCascadeCount; ++cascade)
+        _pShadowArgumentTable[cascade]->release();
     _pJDLVComputePSO->release();
     _pJDLVRenderPSO->release();
     _pTexture->release();
-    _pTextureDesc->release();
     _pDepthStencilState->release();
     _pDepthStencilStateJDLV->release();
-    _pPSO->release();
+    _shadowDepthState->release();
+    _gBufferDepthState->release();
+    _lightingDepthState->release();
+    _pPipelines->saveManifest(pipelineManifestPath());
     _pShaderLibrary->release();
-    _gBuffer0->release();
-    _gBuffer1->release();
-    _shadowMap->release();
-    _depth->release();
-    _gBufferPassDesc->release();
-    _shadowPassDesc->release();
-    _lightingPassDesc->release();
-    _gBufferWithLoadPassDesc->release();
     
     
     
-    _shadowMap->release();
 
 
 //    _pCommandBuffer->release();
+    _pResidency.reset();
     _pCommandQueue->release();
-    _pResidencySet->release();
     _pArgumentTable->release();
     _pArgumentTableJDLV->release();
     _sharedEvent->release();
     _pViewportSizeBuffer->release();
-    dispatch_release(_semaphore);
     _pDevice->release();
 }
 
+void GameCoordinatorLoupy::moveCamera( simd::float3 translation )
+{
+    simulation::CameraCommand command;
+    command.step = _pCameraLoop->nextStep();
+    command.move[0] = translation.x;
+    command.move[1] = translation.y;
+    command.move[2] = translation.z;
+    _cameraController.queue(command);
+}
+
+void GameCoordinatorLoupy::rotateCamera( float deltaYaw, float deltaPitch )
+{
+    simulation::CameraCommand command;
+    command.step = _pCameraLoop->nextStep();
+    command.yaw = deltaYaw;
+    command.pitch = deltaPitch;
+    _cameraController.queue(command);
+}
+
 void GameCoordinatorLoupy::updateUniforms()
 {
-#if !USE_CONST_GAME_TIME
+#if USE_CONST_GAME_TIME
     _uniforms_cpu->gameTime                     = 0.f;
+#else
+    _uniforms_cpu->gameTime                     = (float)_pCameraLoop->renderTime();
 #endif
+    {
+        const simulation::CameraState camera = _pCameraLoop->interpolated();
+        float forward[3];
+        simulation::cameraForward(camera, forward);
+        _pCamera->setPosition((simd::float3){ camera.position[0], camera.position[1], camera.position[2] });
+        _pCamera->setDirection((simd::float3){ forward[0], forward[1], forward[2] });
+    }
     _uniforms_cpu->cameraUniforms               = _pCamera->uniforms();
-    float gameTime                              = _frame * (1.0 / 60.f);
-    _uniforms_cpu->frameTime                    = simd_max(0.001f, gameTime - 0);
+    _uniforms_cpu->frameTime                    = simd_max(0.001f, (float)_pPacer->lastFrameInterval());
     _uniforms_cpu->mouseState                   = (simd::float3){ _cursorPosition.x, _cursorPosition.y, float(_mouseButtonMask) };
-    _uniforms_cpu->invScreenSize                = (simd::float2){ 1.f / _gBuffer0->width(), 1.f / _gBuffer0->height() };
+    _uniforms_cpu->invScreenSize                = (simd::float2){ 1.f / _pViewportSize.x, 1.f / _pViewportSize.y };
     _uniforms_cpu->projectionYScale             = 1.73205066;
     _uniforms_cpu->ambientOcclusionContrast     = 3;
     _uniforms_cpu->ambientOcclusionScale        = 0.800000011;
@@ -273,62 +400,62 @@ void GameCoordinatorLoupy::draw( MTK::View* _pView )
     NS::AutoreleasePool *pPool = NS::AutoreleasePool::alloc()->init();
 
     _currentFrameIndex += 1;
+    const uint64_t frame = _currentFrameIndex;
 
-    const uint32_t frameIndex = _currentFrameIndex % kMaxFramesInFlight;
-    
-    if (_currentFrameIndex > kMaxFramesInFlight)
+    // The pacer decides how many frames may be in flight (never more than the
+    // kMaxFramesInFlight the per-frame resources are sized for), and with a
+    // shallow pipeline how long to hold the frame so it lands right on a vsync.
+    if (const uint64_t timeStampToWait = _pPacer->waitTarget(frame))
     {
-        uint64_t const timeStampToWait = _currentFrameIndex - kMaxFramesInFlight;
         _sharedEvent->waitUntilSignaledValue(timeStampToWait, DISPATCH_TIME_FOREVER);
     }
-
-    MTL::Viewport viewPort;
-    viewPort.originX = 0.0;
-    viewPort.originY = 0.0;
-    viewPort.znear = 0.0;
-    viewPort.zfar = 1.0;
-    viewPort.width = (double)_shadowMap->width();
-    viewPort.height = (double)_shadowMap->height();
-
-    updateUniforms();
-    
-    MTL4::CommandAllocator* pFrameAllocator = _pCommandAllocator[frameIndex];
-    pFrameAllocator->reset();
-
-    _pCommandBuffer[0] = _pDevice->newCommandBuffer();
-    _pCommandBuffer[0]->beginCommandBuffer(pFrameAllocator);
-
-    for (uint32_t i = 0; i < 3; i++)
+    const double now = hostTime();
+    const double start = _pPacer->startTime(now);
+    if (start > now)
     {
-        _shadowPassDesc->depthAttachment()->setSlice(i);
-        MTL4::RenderCommandEncoder* renderPassEncoder = _pCommandBuffer[0]->renderCommandEncoder(_shadowPassDesc);
-        renderPassEncoder->setCullMode( MTL::CullModeFront );
-        renderPassEncoder->setDepthClipMode( MTL::DepthClipModeClamp );
-        renderPassEncoder->setDepthStencilState(_shadowDepthState);
-
-        renderPassEncoder->setViewport(viewPort);
-        renderPassEncoder->setScissorRect( MTL::ScissorRect {0, 0, _shadowMap->width(), _shadowMap->height()} );
-        ft_memcpy(_pShadowPassDataBuffer[i], &_uniforms_cpu->shadowCameraUniforms[i].viewProjectionMatrix, sizeof(_uniforms_cpu->shadowCameraUniforms[i].viewProjectionMatrix));
+        std::this_thread::sleep_for(std::chrono::duration<double>(start - now));
     }
-    _pCommandBuffer[0]->endCommandBuffer();
+    _pPacer->beginFrame(frame, hostTime());
 
-    _pCommandBuffer[1] = _pDevice->newCommandBuffer();
-    _pCommandBuffer[1]->beginCommandBuffer(_pCommandAllocator[frameIndex]);
+    // Everything the frame will draw with is marked up front: uses made while
+    // recording would only reach the set with the next frame's commit.
+    _pResidency->beginFrame(frame);
+    for (residency::AllocationId allocation : _frameAllocations[frame % kMaxFramesInFlight])
     {
-        MTL4::RenderCommandEncoder* renderEncoder = _pCommandBuffer[1]->renderCommandEncoder(_gBufferPassDesc);
-        renderEncoder->setCullMode( MTL::CullModeBack );
-        renderEncoder->setDepthStencilState(_gBufferDepthState);
-    }
-    {
-        MTL4::ComputeCommandEncoder* computeEncoder = _pCommandBuffer[2]->computeCommandEncoder();
-        computeEncoder->setLabel(MTLSTR("CCE2knlMousePos"));
-        computeEncoder->setComputePipelineState(_mousePositionComputeKnl);
-    }
-    {
-        MTL4::RenderCommandEncoder* renderEncoderDepth = _pCommandBuffer[3]->renderCommandEncoder(_lightingPassDesc);
-        
+        _pResidency->use(allocation);
     }
 
+    // Command buffers are committed as soon as they are recorded, so the drawable
+    // wait has to be queued first.
+    const double acquireStart = hostTime();
+    CA::MetalDrawable* currentDrawable = _pView->currentDrawable();
+    _pCommandQueue->wait(currentDrawable);
+    _pPacer->blocked(frame, hostTime() - acquireStart);
+
+    // Late latch: camera and input are sampled after the last wait, right before recording.
+    const double latchTime = hostTime();
+    _pPacer->latchInput(frame, latchTime);
+    _inputQueue.drainInto(_input);
+    const double realDelta = _lastLatchTime < 0.0 ? 0.0 : latchTime - _lastLatchTime;
+    _lastLatchTime = latchTime;
+    _pCameraLoop->advance(realDelta);
+    updateUniforms();
+
+    // Both may run after the coordinator is gone: they capture the pacer, not `this`.
+    std::shared_ptr<frame_pacing::FramePacer> pPacer = _pPacer;
+    currentDrawable->addPresentedHandler( [pPacer, frame]( MTL::Drawable* pDrawable ) {
+        pPacer->presented(frame, pDrawable->presentedTime());
+    } );
+    _pRecordingBackend->setCommitFeedback( [pPacer, frame]( MTL4::CommitFeedback* pFeedback ) {
+        pPacer->gpuCompleted(frame, pFeedback->GPUStartTime(), pFeedback->GPUEndTime());
+    } );
+
+    // Adds and evictions go out in one commit, before the first command buffer does.
+    _pResidency->endFrame();
+    _pRecorder->beginFrame(frame);
+    _pGraphExecutor->bindImported(_mouseResource, _mouseBuffer);
+    _pGraphExecutor->record(_frameGraph, _compiledFrame, *_pRecorder, frame);
+
 //    MTL4::RenderPassDescriptor* pRenderPassDescriptor = _pView->currentMTL4RenderPassDescriptor();
 //    MTL::RenderPassColorAttachmentDescriptor* color0 = pRenderPassDescriptor->colorAttachments()->object(0);
 //    color0->setLoadAction( MTL::LoadActionClear );
@@ -336,7 +463,7 @@ void GameCoordinatorLoupy::draw( MTK::View* _pView )
 ////    color0->setClearColor( MTL::ClearColor(0.1, 0.1, 0.1, 1.0) );
 //
 //    MTL4::RenderCommandEncoder* renderPassEncoder = _pCommandBuffer[0]->renderCommandEncoder(pRenderPassDescriptor);
-//    renderPassEncoder->setRenderPipelineState(_pPSO);
+//    renderPassEncoder->setRenderPipelineState(_lightingPSO.as<MTL::RenderPipelineState>());
 //    renderPassEncoder->setDepthStencilState( _pDepthStencilState );
 //    renderPassEncoder->setViewport(viewPort);
 //    
@@ -399,11 +526,9 @@ void GameCoordinatorLoupy::draw( MTK::View* _pView )
 //
 //    _useBufferAAsSource = !_useBufferAAsSource;
 //
-    CA::MetalDrawable* currentDrawable = _pView->currentDrawable();
-    _pCommandQueue->wait(currentDrawable);
-    _pCommandQueue->commit(_pCommandBuffer, 0);
     _pCommandQueue->signalDrawable(currentDrawable);
-    _pCommandQueue->signalEvent(_sharedEvent, _currentFrameIndex);
+    _pCommandQueue->signalEvent(_sharedEvent, frame);
     currentDrawable->present();
+    _pPacer->endCpu(frame, hostTime());
     pPool->release();
 }
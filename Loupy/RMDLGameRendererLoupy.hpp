@@ -9,15 +9,32 @@
 #define RMDLGAMECOORDINATORLOUPY_HPP
 
 #include <MetalKit/MetalKit.hpp>
+#include <memory>
 #include <string>
 #include <unordered_map>
 
 #include "RMDLMainRenderer_shared.h"
 #include "RMDLCamera.hpp"
 #include "RMDLUtils.hpp"
+#include "RMDLPipelineCache.hpp"
+#include "RMDLPipelineCompiler.hpp"
+#include "RMDLRenderGraph.hpp"
+#include "RMDLCommandRecorder.hpp"
+#include "RMDLFramePacer.hpp"
+#include "RMDLSimulationClock.hpp"
+#include "RMDLCameraSimulation.hpp"
+#include "RMDLInput.hpp"
+#include "RMDLResidencyBudget.hpp"
+
+class RenderGraphExecutor;
+class MetalRecordingBackend;
+class ResidencyManager;
 
 #define kMaxBuffersInFlight 3
 
+static constexpr uint32_t kShadowMapSize = 1024;
+static constexpr uint32_t kShadowCascadeCount = 3;
+
 class GameCoordinatorLoupy
 {
 public:
@@ -29,6 +46,10 @@ public:
     void moveCamera( simd::float3 translation );
     void rotateCamera(float deltaYaw, float deltaPitch);
     void setCameraAspectRatio(float aspectRatio);
+    /// Platform input goes here, from the main thread, stamped with hostTime().
+    input::InputQueue& inputQueue() { return (_inputQueue); }
+    /// Frame, CPU, GPU and latency percentiles, for a HUD or a log. Any thread.
+    frame_pacing::PacingStats pacingStats() const { return (_pPacer->stats()); }
 
     void buildShaders();
     void buildComputePipeline();
@@ -40,23 +61,27 @@ public:
     void makeArgumentTable();
     void makeResidencySet();
     void compileRenderPipeline( MTL::PixelFormat );
+    void buildFrameGraph( uint32_t width, uint32_t height );
 
     void updateUniforms();
 
 private:
     MTL::PixelFormat                    _pPixelFormat;
     MTL4::CommandQueue*                 _pCommandQueue;
-    MTL4::CommandBuffer*                _pCommandBuffer[4];
-    MTL4::CommandAllocator*             _pCommandAllocator[kMaxBuffersInFlight];
+    std::unique_ptr<MetalRecordingBackend>              _pRecordingBackend;
+    std::unique_ptr<command_recording::ParallelRecorder> _pRecorder;
     MTL4::ArgumentTable*                _pArgumentTable;
-    MTL::ResidencySet*                  _pResidencySet;
+    std::unique_ptr<ResidencyManager>   _pResidency;
+    std::vector<residency::AllocationId> _frameAllocations[kMaxBuffersInFlight];   // use()d by each frame before it is recorded
     MTL::SharedEvent*                   _sharedEvent;
-    dispatch_semaphore_t                _semaphore;
+    std::shared_ptr<frame_pacing::FramePacer>   _pPacer;    // shared with the presented and GPU feedback handlers
     MTL::Buffer*                        _pInstanceDataBuffer[kMaxBuffersInFlight];
     MTL::Buffer*                        _pTriangleDataBuffer[kMaxBuffersInFlight];
     MTL::Buffer*                        _pViewportSizeBuffer;
     MTL::Device*                        _pDevice;
-    MTL::RenderPipelineState*           _pPSO;
+    std::unique_ptr<MetalPipelineCompiler>              _pPipelineCompiler;
+    std::unique_ptr<pipeline_cache::PipelineManager>    _pPipelines;
+    pipeline_cache::PipelineRef         _lightingPSO;
     MTL::DepthStencilState*             _pDepthStencilState;
     MTL::DepthStencilState*             _pDepthStencilStateJDLV;
     MTL::Texture*                       _pTexture;
@@ -66,30 +91,29 @@ private:
     simd_uint2                          _pViewportSize;
     MTL::Library*                       _pShaderLibrary;
     int                                 _frame;
-    NS::SharedPtr<MTL::SharedEvent>     _pPacingEvent;
     RMDLUniforms*                       _uniforms_cpu;
     RMDLCamera*                         _pCamera;
+    simulation::CameraController        _cameraController;
+    std::unique_ptr<simulation::FixedStepLoop<simulation::CameraState>> _pCameraLoop;
+    double                              _lastLatchTime;
+    input::InputQueue                   _inputQueue;
+    input::InputStateMachine            _input;
     simd::float2                        _cursorPosition;
     MTL::Buffer*                        _mouseBuffer;
     NS::UInteger                        _mouseButtonMask;
     float                               _brushSize;
-    MTL::Texture*                       _gBuffer0;
-    MTL::Texture*                       _gBuffer1;
-    MTL::Texture*                       _shadowMap;
-    MTL::Texture*                       _depth;
-    MTL::TextureDescriptor*             _pTextureDesc;
-
-    MTL4::RenderPassDescriptor*         _gBufferPassDesc;
-    MTL4::RenderPassDescriptor*         _shadowPassDesc;
-    MTL4::RenderPassDescriptor*         _lightingPassDesc;
-    MTL4::RenderPassDescriptor*         _gBufferWithLoadPassDesc;
+    render_graph::RenderGraph           _frameGraph;
+    render_graph::CompiledGraph         _compiledFrame;
+    render_graph::ResourceId            _mouseResource;
+    std::unique_ptr<RenderGraphExecutor>    _pGraphExecutor;
 
     MTL::DepthStencilState*             _shadowDepthState;
     MTL::DepthStencilState*             _gBufferDepthState;
     MTL::DepthStencilState*             _lightingDepthState;
     MTL::ComputePipelineState*          _pipelineStateDescriptor;
-    MTL::ComputePipelineState*          _mousePositionComputeKnl;
-    MTL::Buffer*                        _pShadowPassDataBuffer[kMaxBuffersInFlight];
+    pipeline_cache::PipelineRef         _mousePositionKnl;
+    MTL::Buffer*                        _pShadowPassDataBuffer[kMaxBuffersInFlight][kShadowCascadeCount];
+    MTL4::ArgumentTable*                _pShadowArgumentTable[kShadowCascadeCount];    // one per cascade: cascades in different batches record at the same time
 
 
     MTL::Buffer* _pJDLVStateBuffer[kMaxBuffersInFlight];
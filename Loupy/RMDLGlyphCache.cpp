@@ -0,0 +1,662 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLGlyphCache.cpp           +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 15:20:16      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLGlyphCache.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace text
+{
+
+static constexpr uint64_t   kEmptyKey = 0;                  // pixel size 0 is never a valid key
+static constexpr uint64_t   kTombstoneKey = UINT64_MAX;
+static constexpr uint32_t   kCelllessEntries = 4096;        // spaces, missing and oversized glyphs
+
+static inline uint64_t packKey( uint32_t codepoint, uint16_t font, uint16_t pixelSize )
+{
+    return (((uint64_t)pixelSize << 48) | ((uint64_t)font << 32) | codepoint);
+}
+
+static inline uint64_t hashKey( uint64_t key )
+{
+    key ^= key >> 30;
+    key *= 0xBF58476D1CE4E5B9ull;
+    key ^= key >> 27;
+    key *= 0x94D049BB133111EBull;
+    key ^= key >> 31;
+    return (key);
+}
+
+static inline uint16_t toUnorm16( uint32_t texel, uint32_t size )
+{
+    return ((uint16_t)(((uint64_t)texel * 65535 + size / 2) / size));
+}
+
+#pragma mark - GlyphCache
+
+GlyphCache::GlyphCache( GlyphRasterizer& rasterizer, const GlyphCacheDesc& desc )
+: _rasterizer( rasterizer )
+, _desc( desc )
+, _indexTombstones( 0 )
+, _classDemand{}
+, _classRetired{}
+, _missCount( 0 )
+, _stats{}
+, _generation( 1 )
+, _frame( 1 )
+{
+    _desc.width  = std::max(kBlockSize, _desc.width / kBlockSize * kBlockSize);
+    _desc.height = std::max(kBlockSize, _desc.height / kBlockSize * kBlockSize);
+    _desc.pages  = std::max(1u, _desc.pages);
+    _desc.framesInFlight = std::max(1u, _desc.framesInFlight);
+    _desc.maxMissesPerFrame = std::max(1u, _desc.maxMissesPerFrame);
+
+    _blocksPerRow  = _desc.width / kBlockSize;
+    _blocksPerPage = _blocksPerRow * (_desc.height / kBlockSize);
+    _pixels.assign((size_t)_desc.width * _desc.height * _desc.pages, 0);
+
+    const uint32_t blockCount = _blocksPerPage * _desc.pages;
+    _blocks.assign(blockCount, Block{ -1, 0 });
+    _freeBlocks.reserve(blockCount);
+    for (uint32_t b = blockCount; b-- > 0; )
+        _freeBlocks.push_back(b);
+    _cellEntry.assign((size_t)blockCount * kMaxCellsPerBlock, kNone);
+
+    _entryCapacity = blockCount * kMaxCellsPerBlock + kCelllessEntries;
+    _entries.reset(new Entry[_entryCapacity]);
+    // rebuildIndex() and the eviction scans read every entry's key, used or not.
+    for (uint32_t i = 0; i < _entryCapacity; ++i)
+    {
+        Entry& entry = _entries[i];
+        entry.key = kEmptyKey;
+        entry.metrics = {};
+        entry.lastUsed.store(0, std::memory_order_relaxed);
+        entry.cell = kNone;
+        entry.present = false;
+    }
+    _freeEntries.reserve(_entryCapacity);
+    for (uint32_t i = _entryCapacity; i-- > 0; )
+        _freeEntries.push_back(i);
+
+    uint32_t indexSize = 1;
+    while (indexSize < _entryCapacity * 2)
+        indexSize <<= 1;
+    _indexKeys.assign(indexSize, kEmptyKey);
+    _indexValues.assign(indexSize, kNone);
+    _indexMask = indexSize - 1;
+
+    _misses.reset(new uint64_t[_desc.maxMissesPerFrame]);
+    _missFilter.reset(new std::atomic<uint64_t>[kMissFilterSize]);
+    for (uint32_t i = 0; i < kMissFilterSize; ++i)
+        _missFilter[i].store(kEmptyKey, std::memory_order_relaxed);
+}
+
+GlyphCache::~GlyphCache()
+{
+}
+
+void GlyphCache::beginFrame()
+{
+    ++_frame;
+    _uploads.clear();
+    releaseRetired();
+}
+
+const GlyphMetrics* GlyphCache::find( uint32_t codepoint, uint16_t font, uint16_t pixelSize )
+{
+    if (pixelSize == 0)
+        return (nullptr);
+
+    const uint64_t key = packKey(codepoint, font, pixelSize);
+    const uint32_t index = lookupIndex(key);
+    if (index != kNone)
+    {
+        Entry& entry = _entries[index];
+        // Only write when the frame changes so hot glyphs do not bounce their cache line between readers.
+        if (entry.lastUsed.load(std::memory_order_relaxed) != _frame)
+            entry.lastUsed.store(_frame, std::memory_order_relaxed);
+        return (entry.present ? &entry.metrics : nullptr);
+    }
+
+    // Direct-mapped filter: a string repeating a missing glyph reports it once.
+    std::atomic<uint64_t>& recent = _missFilter[hashKey(key) & (kMissFilterSize - 1)];
+    if (recent.load(std::memory_order_relaxed) == key)
+        return (nullptr);
+    recent.store(key, std::memory_order_relaxed);
+
+    const uint32_t slot = _missCount.fetch_add(1, std::memory_order_relaxed);
+    if (slot < _desc.maxMissesPerFrame)
+        _misses[slot] = key;
+    return (nullptr);
+}
+
+void GlyphCache::update()
+{
+    const uint32_t resident = _stats.resident;
+    _stats = {};
+    _stats.resident = resident;
+    std::fill(std::begin(_classDemand), std::end(_classDemand), 0u);
+
+    const uint32_t missCount = std::min(_missCount.exchange(0, std::memory_order_relaxed), _desc.maxMissesPerFrame);
+    for (uint32_t i = 0; i < kMissFilterSize; ++i)
+        _missFilter[i].store(kEmptyKey, std::memory_order_relaxed);
+
+    _work.assign(_misses.get(), _misses.get() + missCount);
+    std::sort(_work.begin(), _work.end());
+    _work.erase(std::unique(_work.begin(), _work.end()), _work.end());
+
+    // Deferred bitmaps nobody asked for again are dropped.
+    for (auto it = _deferred.begin(); it != _deferred.end(); )
+    {
+        if (std::binary_search(_work.begin(), _work.end(), it->first))
+            ++it;
+        else
+            it = _deferred.erase(it);
+    }
+
+    for (uint64_t key : _work)
+    {
+        if (lookupIndex(key) != kNone)
+            continue;
+        ++_stats.misses;
+
+        GlyphBitmap bitmap = { (uint32_t)key, 0, 0, {}, 0.f, 0.f, 0.f };
+        bool present = true;
+        auto deferred = _deferred.find(key);
+        if (deferred != _deferred.end())
+        {
+            bitmap = std::move(deferred->second);
+            _deferred.erase(deferred);
+        }
+        else
+        {
+            present = _rasterizer.rasterize((uint32_t)key, (uint16_t)(key >> 32), (uint16_t)(key >> 48), bitmap);
+        }
+        insertGlyph(key, bitmap, present);
+    }
+
+    // Classes that ran out of cells evict now; the cells come back once no frame in flight can
+    // sample them, so cells already on their way back count against the demand.
+    for (uint32_t c = 0; c < kClassCount; ++c)
+    {
+        if (_classDemand[c] > _classRetired[c])
+            evictFromClass(c, _classDemand[c] - _classRetired[c]);
+    }
+
+    _stats.pending = (uint32_t)_deferred.size();
+    mergeUploads();
+}
+
+void GlyphCache::insertGlyph( uint64_t key, GlyphBitmap& bitmap, bool present )
+{
+    GlyphMetrics metrics = {};
+    metrics.advance  = bitmap.advance;
+    metrics.bearingX = bitmap.bearingX;
+    metrics.bearingY = bitmap.bearingY;
+
+    uint32_t cell = kNone;
+    if (present && bitmap.width && bitmap.height)
+    {
+        // One texel of clear border on each side keeps bilinear taps off the neighbouring cell.
+        const uint32_t side = std::max(bitmap.width, bitmap.height) + 2;
+        uint32_t sizeClass = 0;
+        while (sizeClass < kClassCount && kClassSizes[sizeClass] < side)
+            ++sizeClass;
+        if (sizeClass == kClassCount)
+        {
+            ++_stats.rejected;
+        }
+        else
+        {
+            cell = allocateCell(sizeClass);
+            if (cell == kNone)
+            {
+                ++_classDemand[sizeClass];
+                _deferred.emplace(key, std::move(bitmap));
+                return;
+            }
+        }
+    }
+
+    const uint32_t index = allocateEntry(key);
+    if (index == kNone)
+    {
+        if (cell != kNone)
+        {
+            const uint32_t block = cell / kMaxCellsPerBlock;
+            _freeCells[_blocks[block].sizeClass].push_back(cell);
+            --_blocks[block].used;
+        }
+        ++_stats.rejected;
+        return;
+    }
+
+    Entry& entry = _entries[index];
+    entry.present = present;
+    entry.cell = cell;
+    if (cell != kNone)
+    {
+        uint32_t x, y, page;
+        cellRect(cell, x, y, page);
+        const uint32_t w = bitmap.width + 2;
+        const uint32_t h = bitmap.height + 2;
+        uint8_t* dst = _pixels.data() + (size_t)page * _desc.width * _desc.height;
+        for (uint32_t row = 0; row < h; ++row)
+        {
+            uint8_t* line = dst + (size_t)(y + row) * _desc.width + x;
+            std::memset(line, 0, w);
+            if (row > 0 && row <= bitmap.height)
+                std::memcpy(line + 1, &bitmap.coverage[(size_t)(row - 1) * bitmap.width], bitmap.width);
+        }
+        _uploads.push_back({ x, y, w, h, page });
+
+        metrics.width     = (float)bitmap.width;
+        metrics.height    = (float)bitmap.height;
+        metrics.uvRect[0] = toUnorm16(x + 1, _desc.width);
+        metrics.uvRect[1] = toUnorm16(y + 1, _desc.height);
+        metrics.uvRect[2] = toUnorm16(x + 1 + bitmap.width, _desc.width);
+        metrics.uvRect[3] = toUnorm16(y + 1 + bitmap.height, _desc.height);
+        metrics.page      = page;
+        _cellEntry[cell]  = index;
+        ++_stats.resident;
+    }
+    entry.metrics = metrics;
+    insertIndex(key, index);
+    ++_stats.inserts;
+    ++_generation;
+}
+
+uint32_t GlyphCache::allocateEntry( uint64_t key )
+{
+    if (_freeEntries.empty())
+    {
+        // Every cell-backed glyph has an entry reserved, so only cell-less ones can run out.
+        uint32_t victim = kNone;
+        uint32_t oldest = _frame;
+        for (uint32_t i = 0; i < _entryCapacity; ++i)
+        {
+            const Entry& e = _entries[i];
+            const uint32_t used = e.lastUsed.load(std::memory_order_relaxed);
+            if (e.key != kEmptyKey && e.cell == kNone && used < oldest)
+            {
+                victim = i;
+                oldest = used;
+            }
+        }
+        if (victim == kNone)
+            return (kNone);
+        evict(victim);
+    }
+
+    const uint32_t index = _freeEntries.back();
+    _freeEntries.pop_back();
+    Entry& entry = _entries[index];
+    entry.key = key;
+    entry.lastUsed.store(_frame, std::memory_order_relaxed);
+    entry.cell = kNone;
+    entry.present = false;
+    return (index);
+}
+
+uint32_t GlyphCache::allocateCell( uint32_t sizeClass )
+{
+    std::vector<uint32_t>& freeCells = _freeCells[sizeClass];
+    if (freeCells.empty() && !acquireBlock(sizeClass))
+        return (kNone);
+
+    const uint32_t cell = freeCells.back();
+    freeCells.pop_back();
+    ++_blocks[cell / kMaxCellsPerBlock].used;
+    return (cell);
+}
+
+bool GlyphCache::acquireBlock( uint32_t sizeClass )
+{
+    uint32_t block = kNone;
+    if (!_freeBlocks.empty())
+    {
+        block = _freeBlocks.back();
+        _freeBlocks.pop_back();
+    }
+    else
+    {
+        // Take back an empty block from another size class.
+        for (uint32_t b = 0; b < (uint32_t)_blocks.size() && block == kNone; ++b)
+        {
+            if (_blocks[b].sizeClass >= 0 && _blocks[b].sizeClass != (int32_t)sizeClass && _blocks[b].used == 0)
+                block = b;
+        }
+        if (block == kNone)
+            return (false);
+        std::vector<uint32_t>& previous = _freeCells[_blocks[block].sizeClass];
+        previous.erase(std::remove_if(previous.begin(), previous.end(),
+                                      [block]( uint32_t cell ) { return (cell / kMaxCellsPerBlock == block); }),
+                       previous.end());
+    }
+
+    _blocks[block] = Block{ (int32_t)sizeClass, 0 };
+    const uint32_t perRow = kBlockSize / kClassSizes[sizeClass];
+    for (uint32_t local = perRow * perRow; local-- > 0; )
+        _freeCells[sizeClass].push_back(block * kMaxCellsPerBlock + local);
+    return (true);
+}
+
+void GlyphCache::evict( uint32_t index )
+{
+    Entry& entry = _entries[index];
+    eraseIndex(entry.key);
+    if (entry.cell != kNone)
+    {
+        _cellEntry[entry.cell] = kNone;
+        _retired.push_back({ entry.cell, _frame });
+        ++_classRetired[_blocks[entry.cell / kMaxCellsPerBlock].sizeClass];
+        --_stats.resident;
+    }
+    entry.key = kEmptyKey;
+    entry.cell = kNone;
+    _freeEntries.push_back(index);
+    ++_stats.evictions;
+    ++_generation;
+}
+
+void GlyphCache::evictFromClass( uint32_t sizeClass, uint32_t count )
+{
+    // Least recently used first; glyphs looked up this frame are never candidates.
+    _candidates.clear();
+    const uint32_t perRow = kBlockSize / kClassSizes[sizeClass];
+    for (uint32_t b = 0; b < (uint32_t)_blocks.size(); ++b)
+    {
+        if (_blocks[b].sizeClass != (int32_t)sizeClass)
+            continue;
+        for (uint32_t local = 0; local < perRow * perRow; ++local)
+        {
+            const uint32_t index = _cellEntry[b * kMaxCellsPerBlock + local];
+            if (index == kNone)
+                continue;
+            const uint32_t used = _entries[index].lastUsed.load(std::memory_order_relaxed);
+            if (used < _frame)
+                _candidates.emplace_back(used, index);
+        }
+    }
+
+    const size_t evictCount = std::min<size_t>(count, _candidates.size());
+    std::partial_sort(_candidates.begin(), _candidates.begin() + evictCount, _candidates.end());
+    for (size_t i = 0; i < evictCount; ++i)
+        evict(_candidates[i].second);
+
+    if (evictCount < count)
+        evictBlock(sizeClass);
+}
+
+void GlyphCache::evictBlock( uint32_t exceptClass )
+{
+    // Empties the block of another class whose most recent use is the oldest, so it can change class.
+    uint32_t victim = kNone;
+    uint32_t victimNewest = _frame;
+    for (uint32_t b = 0; b < (uint32_t)_blocks.size(); ++b)
+    {
+        const Block& block = _blocks[b];
+        if (block.sizeClass < 0 || block.sizeClass == (int32_t)exceptClass || block.used == 0)
+            continue;
+        uint32_t newest = 0;
+        for (uint32_t local = 0; local < kMaxCellsPerBlock; ++local)
+        {
+            const uint32_t index = _cellEntry[b * kMaxCellsPerBlock + local];
+            if (index != kNone)
+                newest = std::max(newest, _entries[index].lastUsed.load(std::memory_order_relaxed));
+        }
+        if (newest < victimNewest)
+        {
+            victim = b;
+            victimNewest = newest;
+        }
+    }
+    if (victim == kNone)
+        return;
+
+    for (uint32_t local = 0; local < kMaxCellsPerBlock; ++local)
+    {
+        const uint32_t index = _cellEntry[victim * kMaxCellsPerBlock + local];
+        if (index != kNone)
+            evict(index);
+    }
+}
+
+void GlyphCache::releaseRetired()
+{
+    // A cell is rewritten only once every frame that could have sampled it has completed.
+    size_t kept = 0;
+    for (const Retired& retired : _retired)
+    {
+        if (_frame - retired.frame < _desc.framesInFlight)
+        {
+            _retired[kept++] = retired;
+            continue;
+        }
+        Block& block = _blocks[retired.cell / kMaxCellsPerBlock];
+        _freeCells[block.sizeClass].push_back(retired.cell);
+        --_classRetired[block.sizeClass];
+        --block.used;
+    }
+    _retired.resize(kept);
+}
+
+void GlyphCache::cellRect( uint32_t cell, uint32_t& x, uint32_t& y, uint32_t& page ) const
+{
+    const uint32_t block  = cell / kMaxCellsPerBlock;
+    const uint32_t local  = cell % kMaxCellsPerBlock;
+    const uint32_t size   = kClassSizes[_blocks[block].sizeClass];
+    const uint32_t perRow = kBlockSize / size;
+    const uint32_t inPage = block % _blocksPerPage;
+
+    page = block / _blocksPerPage;
+    x = (inPage % _blocksPerRow) * kBlockSize + (local % perRow) * size;
+    y = (inPage / _blocksPerRow) * kBlockSize + (local / perRow) * size;
+}
+
+void GlyphCache::mergeUploads()
+{
+    // Glyphs of one size class filled in the same frame usually sit side by side on a row.
+    std::sort(_uploads.begin(), _uploads.end(), []( const GlyphUpload& a, const GlyphUpload& b ) {
+        if (a.page != b.page)
+            return (a.page < b.page);
+        if (a.y != b.y)
+            return (a.y < b.y);
+        if (a.height != b.height)
+            return (a.height < b.height);
+        return (a.x < b.x);
+    });
+
+    size_t merged = 0;
+    for (size_t i = 0; i < _uploads.size(); ++i)
+    {
+        const GlyphUpload& u = _uploads[i];
+        if (merged > 0)
+        {
+            GlyphUpload& last = _uploads[merged - 1];
+            if (last.page == u.page && last.y == u.y && last.height == u.height && last.x + last.width == u.x)
+            {
+                last.width += u.width;
+                continue;
+            }
+        }
+        _uploads[merged++] = u;
+    }
+    _uploads.resize(merged);
+
+    _stats.uploads = (uint32_t)_uploads.size();
+    for (const GlyphUpload& u : _uploads)
+        _stats.uploadBytes += (uint64_t)u.width * u.height;
+}
+
+#pragma mark - Index
+
+uint32_t GlyphCache::lookupIndex( uint64_t key ) const
+{
+    for (uint32_t slot = (uint32_t)hashKey(key) & _indexMask; ; slot = (slot + 1) & _indexMask)
+    {
+        const uint64_t k = _indexKeys[slot];
+        if (k == key)
+            return (_indexValues[slot]);
+        if (k == kEmptyKey)
+            return (kNone);
+    }
+}
+
+void GlyphCache::insertIndex( uint64_t key, uint32_t entry )
+{
+    for (uint32_t slot = (uint32_t)hashKey(key) & _indexMask; ; slot = (slot + 1) & _indexMask)
+    {
+        const uint64_t k = _indexKeys[slot];
+        if (k == kEmptyKey || k == kTombstoneKey)
+        {
+            if (k == kTombstoneKey)
+                --_indexTombstones;
+            _indexKeys[slot] = key;
+            _indexValues[slot] = entry;
+            return;
+        }
+    }
+}
+
+void GlyphCache::eraseIndex( uint64_t key )
+{
+    for (uint32_t slot = (uint32_t)hashKey(key) & _indexMask; ; slot = (slot + 1) & _indexMask)
+    {
+        const uint64_t k = _indexKeys[slot];
+        if (k == kEmptyKey)
+            return;
+        if (k == key)
+        {
+            _indexKeys[slot] = kTombstoneKey;
+            _indexValues[slot] = kNone;
+            ++_indexTombstones;
+            break;
+        }
+    }
+    if (_indexTombstones > (_indexMask + 1) / 4)
+        rebuildIndex();
+}
+
+void GlyphCache::rebuildIndex()
+{
+    std::fill(_indexKeys.begin(), _indexKeys.end(), kEmptyKey);
+    std::fill(_indexValues.begin(), _indexValues.end(), kNone);
+    _indexTombstones = 0;
+    for (uint32_t i = 0; i < _entryCapacity; ++i)
+    {
+        if (_entries[i].key != kEmptyKey)
+            insertIndex(_entries[i].key, i);
+    }
+}
+
+#pragma mark - Accessors
+
+const std::vector<GlyphUpload>& GlyphCache::uploads() const
+{
+    return (_uploads);
+}
+
+const uint8_t* GlyphCache::pixels( uint32_t page ) const
+{
+    return (_pixels.data() + (size_t)page * _desc.width * _desc.height);
+}
+
+uint32_t GlyphCache::width() const
+{
+    return (_desc.width);
+}
+
+uint32_t GlyphCache::height() const
+{
+    return (_desc.height);
+}
+
+uint32_t GlyphCache::pages() const
+{
+    return (_desc.pages);
+}
+
+uint64_t GlyphCache::generation() const
+{
+    return (_generation);
+}
+
+const GlyphCacheStats& GlyphCache::stats() const
+{
+    return (_stats);
+}
+
+GlyphRasterizer& GlyphCache::rasterizer() const
+{
+    return (_rasterizer);
+}
+
+#pragma mark - GlyphCacheFont
+
+GlyphCacheFont::GlyphCacheFont( GlyphCache& cache, uint16_t font, uint16_t pixelSize )
+: _cache( cache )
+, _font( font )
+, _pixelSize( pixelSize )
+, _lineHeight( 0.f )
+, _ascent( 0.f )
+, _lookups( 0 )
+, _hits( 0 )
+{
+    _cache.rasterizer().lineMetrics(font, pixelSize, _lineHeight, _ascent);
+}
+
+void GlyphCacheFont::prefetch( std::string_view str ) const
+{
+    size_t i = 0;
+    while (i < str.size())
+    {
+        const uint32_t cp = decodeUtf8(str, i);
+        if (cp >= ' ')
+            glyph(cp);
+    }
+}
+
+const GlyphMetrics* GlyphCacheFont::glyph( uint32_t codepoint ) const
+{
+    const GlyphMetrics* pMetrics = _cache.find(codepoint, _font, _pixelSize);
+    _lookups.fetch_add(1, std::memory_order_relaxed);
+    if (pMetrics)
+        _hits.fetch_add(1, std::memory_order_relaxed);
+    return (pMetrics);
+}
+
+float GlyphCacheFont::lineHeight() const
+{
+    return (_lineHeight);
+}
+
+float GlyphCacheFont::ascent() const
+{
+    return (_ascent);
+}
+
+uint64_t GlyphCacheFont::generation() const
+{
+    return (_cache.generation());
+}
+
+uint64_t GlyphCacheFont::lookups() const
+{
+    return (_lookups.load(std::memory_order_relaxed));
+}
+
+uint64_t GlyphCacheFont::hits() const
+{
+    return (_hits.load(std::memory_order_relaxed));
+}
+
+}
@@ -0,0 +1,220 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLGlyphCache.hpp           +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 15:20:11      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLGLYPHCACHE_HPP
+# define RMDLGLYPHCACHE_HPP
+
+# include <atomic>
+# include <cstdint>
+# include <memory>
+# include <string_view>
+# include <unordered_map>
+# include <vector>
+
+# include "RMDLTextBatch.hpp"
+# include "RMDLSdfAtlas.hpp"
+# include "NonCopyable.h"
+
+// On-demand glyph atlas for arbitrary Unicode. Glyphs are keyed by
+// (codepoint, font, pixel size), rasterized the first time they are looked up
+// and evicted least-recently-used first when their size class runs out of room.
+//
+// Frame protocol (owner = the thread that records the frame):
+//   beginFrame()  owner
+//   find()        any thread, lock-free; marks the glyph used or records a miss
+//   update()      owner, once lookups are done: rasterizes misses, evicts,
+//                 collects the dirty rectangles to upload
+//   layout/draw   any thread, lock-free, through GlyphCacheFont
+// find() never runs concurrently with update(); that is what keeps readers
+// free of locks and of per-entry synchronisation.
+
+namespace text
+{
+    /// Produces coverage bitmaps; pixel sizes are pixels per em.
+    class GlyphRasterizer
+    {
+    public:
+        virtual ~GlyphRasterizer() = default;
+
+        /// False when the font has no glyph for `codepoint`.
+        virtual bool    rasterize( uint32_t codepoint, uint16_t font, uint16_t pixelSize, GlyphBitmap& out ) = 0;
+        virtual void    lineMetrics( uint16_t font, uint16_t pixelSize, float& lineHeight, float& ascent ) = 0;
+    };
+
+    struct GlyphCacheDesc
+    {
+        uint32_t    width           = 1024;     // multiple of GlyphCache::kBlockSize
+        uint32_t    height          = 1024;
+        uint32_t    pages           = 1;        // texture array slices
+        uint32_t    framesInFlight  = 3;
+        uint32_t    maxMissesPerFrame = 1024;
+    };
+
+    /// Texel rectangle of the atlas to copy from GlyphCache::pixels() to the texture.
+    struct GlyphUpload
+    {
+        uint32_t    x;
+        uint32_t    y;
+        uint32_t    width;
+        uint32_t    height;
+        uint32_t    page;
+    };
+
+    /// Counters for the last update().
+    struct GlyphCacheStats
+    {
+        uint32_t    misses;         // distinct keys requested since the previous update
+        uint32_t    inserts;
+        uint32_t    evictions;
+        uint32_t    pending;        // rasterized misses waiting for a cell to come out of quarantine
+        uint32_t    rejected;       // too large for a cell, or no entry left
+        uint32_t    uploads;        // rectangles after merging
+        uint64_t    uploadBytes;
+        uint32_t    resident;       // glyphs with pixels in the atlas
+    };
+
+    class GlyphCache : public NonCopyable
+    {
+    public:
+        /// Atlas space is handed out in square blocks, each split into equal cells of one size class.
+        static constexpr uint32_t   kBlockSize = 128;
+        static constexpr uint32_t   kClassCount = 6;
+        static constexpr uint32_t   kClassSizes[kClassCount] = { 16, 24, 32, 48, 64, 128 };
+
+        GlyphCache( GlyphRasterizer& rasterizer, const GlyphCacheDesc& desc );
+        ~GlyphCache();
+
+        void                        beginFrame();
+        /// Lock-free. Returns nullptr on a miss (the glyph is then rasterized by the next update())
+        /// or when the font has no such glyph.
+        const GlyphMetrics*         find( uint32_t codepoint, uint16_t font, uint16_t pixelSize );
+        void                        update();
+
+        /// Dirty rectangles produced by the last update(), merged along rows.
+        const std::vector<GlyphUpload>& uploads() const;
+        /// CPU copy of the atlas, R8 coverage, `width()` bytes per row.
+        const uint8_t*              pixels( uint32_t page ) const;
+        uint32_t                    width() const;
+        uint32_t                    height() const;
+        uint32_t                    pages() const;
+
+        /// Bumped whenever a glyph is added or moved, so cached layouts are redone.
+        uint64_t                    generation() const;
+        const GlyphCacheStats&      stats() const;
+        GlyphRasterizer&            rasterizer() const;
+
+    private:
+        static constexpr uint32_t   kNone = UINT32_MAX;
+        static constexpr uint32_t   kMaxCellsPerBlock = (kBlockSize / 16) * (kBlockSize / 16);
+        static constexpr uint32_t   kMissFilterSize = 256;
+
+        struct Entry
+        {
+            uint64_t                key;
+            GlyphMetrics            metrics;
+            std::atomic<uint32_t>   lastUsed;
+            uint32_t                cell;       // kNone: nothing to draw (space, missing glyph)
+            bool                    present;
+        };
+
+        struct Block
+        {
+            int32_t                 sizeClass;  // -1 when free
+            uint32_t                used;       // cells holding a glyph or in quarantine
+        };
+
+        struct Retired
+        {
+            uint32_t                cell;
+            uint32_t                frame;
+        };
+
+        uint32_t                    lookupIndex( uint64_t key ) const;
+        void                        insertIndex( uint64_t key, uint32_t entry );
+        void                        eraseIndex( uint64_t key );
+        void                        rebuildIndex();
+
+        void                        insertGlyph( uint64_t key, GlyphBitmap& bitmap, bool present );
+        uint32_t                    allocateEntry( uint64_t key );
+        uint32_t                    allocateCell( uint32_t sizeClass );
+        bool                        acquireBlock( uint32_t sizeClass );
+        void                        evict( uint32_t entry );
+        void                        evictFromClass( uint32_t sizeClass, uint32_t count );
+        void                        evictBlock( uint32_t exceptClass );
+        void                        releaseRetired();
+        void                        cellRect( uint32_t cell, uint32_t& x, uint32_t& y, uint32_t& page ) const;
+        void                        mergeUploads();
+
+        GlyphRasterizer&            _rasterizer;
+        GlyphCacheDesc              _desc;
+        uint32_t                    _blocksPerRow;
+        uint32_t                    _blocksPerPage;
+        std::vector<uint8_t>        _pixels;
+
+        std::unique_ptr<Entry[]>    _entries;
+        uint32_t                    _entryCapacity;
+        std::vector<uint32_t>       _freeEntries;
+
+        std::vector<uint64_t>       _indexKeys;
+        std::vector<uint32_t>       _indexValues;
+        uint32_t                    _indexMask;
+        uint32_t                    _indexTombstones;
+
+        std::vector<Block>          _blocks;
+        std::vector<uint32_t>       _freeBlocks;
+        std::vector<uint32_t>       _cellEntry;
+        std::vector<uint32_t>       _freeCells[kClassCount];
+        uint32_t                    _classDemand[kClassCount];
+        uint32_t                    _classRetired[kClassCount];
+        std::vector<Retired>        _retired;
+
+        std::unique_ptr<uint64_t[]>                 _misses;
+        std::atomic<uint32_t>                       _missCount;
+        std::unique_ptr<std::atomic<uint64_t>[]>    _missFilter;
+        std::unordered_map<uint64_t, GlyphBitmap>  _deferred;  // rasterized, waiting for a cell
+
+        std::vector<uint64_t>       _work;
+        std::vector<std::pair<uint32_t, uint32_t>>  _candidates;
+        std::vector<GlyphUpload>    _uploads;
+        GlyphCacheStats             _stats;
+        uint64_t                    _generation;
+        uint32_t                    _frame;
+    };
+
+    /// GlyphProvider over one font at one pixel size of a GlyphCache; TextStyle::scale stays 1.
+    /// Lookups are counted per provider, so give each thread its own to keep the counters uncontended.
+    class GlyphCacheFont : public GlyphProvider
+    {
+    public:
+        GlyphCacheFont( GlyphCache& cache, uint16_t font, uint16_t pixelSize );
+
+        /// Looks up every codepoint of `str` so misses are filled by the next GlyphCache::update().
+        void                prefetch( std::string_view str ) const;
+
+        const GlyphMetrics* glyph( uint32_t codepoint ) const override;
+        float               lineHeight() const override;
+        float               ascent() const override;
+        uint64_t            generation() const override;
+
+        uint64_t            lookups() const;
+        uint64_t            hits() const;
+
+    private:
+        GlyphCache&                     _cache;
+        uint16_t                        _font;
+        uint16_t                        _pixelSize;
+        float                           _lineHeight;
+        float                           _ascent;
+        mutable std::atomic<uint64_t>   _lookups;
+        mutable std::atomic<uint64_t>   _hits;
+    };
+}
+
+#endif /* RMDLGLYPHCACHE_HPP */
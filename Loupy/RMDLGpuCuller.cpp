@@ -0,0 +1,152 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLGpuCuller.cpp            +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 23:32:03      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLGpuCuller.hpp"
+
+#include <cstring>
+#include <algorithm>
+
+static pipeline_cache::PipelineRef requestKernel( pipeline_cache::PipelineManager& pipelines, const char* name )
+{
+    pipeline_cache::PipelineDesc desc;
+    desc.kind = pipeline_cache::PipelineKind::Compute;
+    desc.label = name;
+    desc.computeFunction = name;
+    desc.threadGroupSizeIsMultipleOfExecutionWidth = true;
+    return (pipelines.request(desc));
+}
+
+GpuCuller::GpuCuller( MTL::Device* pDevice, pipeline_cache::PipelineManager& pipelines, uint32_t maxInstances, uint32_t framesInFlight )
+: _pDevice( pDevice->retain() )
+, _maxInstances( maxInstances )
+, _frames( std::max(1u, framesInFlight) )
+{
+    const uint32_t groupCount = (maxInstances + kCullThreadgroupSize - 1) / kCullThreadgroupSize;
+    for (Frame& frame : _frames)
+    {
+        // The next frame's cull may run while this one still scans and compacts.
+        frame.pVisibility = _pDevice->newBuffer( std::max(1u, maxInstances), MTL::ResourceStorageModePrivate );
+        frame.pGroups = _pDevice->newBuffer( std::max(1u, groupCount) * sizeof(uint32_t), MTL::ResourceStorageModePrivate );
+        // Shared so the CPU fallback can write them and the validation read them.
+        frame.pParams = _pDevice->newBuffer( sizeof(RMDLCullParams), MTL::ResourceStorageModeShared );
+        frame.pArguments = _pDevice->newBuffer( std::max(1u, maxInstances) * sizeof(RMDLDrawIndexedArguments), MTL::ResourceStorageModeShared );
+        frame.pDrawRange = _pDevice->newBuffer( sizeof(RMDLDrawRange), MTL::ResourceStorageModeShared );
+    }
+
+    NS::Error* pError = nullptr;
+    NS::SharedPtr<MTL4::ArgumentTableDescriptor> argumentTableDescriptor = NS::TransferPtr( MTL4::ArgumentTableDescriptor::alloc()->init() );
+    argumentTableDescriptor->setMaxBufferBindCount( CullBufferIndexCount );
+    _pArgumentTable = _pDevice->newArgumentTable( argumentTableDescriptor.get(), &pError );
+
+    _cullKnl = requestKernel(pipelines, "cullInstances");
+    _scanKnl = requestKernel(pipelines, "scanCullGroups");
+    _compactKnl = requestKernel(pipelines, "compactDraws");
+}
+
+GpuCuller::~GpuCuller()
+{
+    for (Frame& frame : _frames)
+    {
+        frame.pParams->release();
+        frame.pArguments->release();
+        frame.pDrawRange->release();
+        frame.pVisibility->release();
+        frame.pGroups->release();
+    }
+    _pArgumentTable->release();
+    _pDevice->release();
+}
+
+void GpuCuller::addToResidencySet( MTL::ResidencySet* pResidencySet ) const
+{
+    for (const Frame& frame : _frames)
+    {
+        pResidencySet->addAllocation( frame.pParams );
+        pResidencySet->addAllocation( frame.pArguments );
+        pResidencySet->addAllocation( frame.pDrawRange );
+        pResidencySet->addAllocation( frame.pVisibility );
+        pResidencySet->addAllocation( frame.pGroups );
+    }
+}
+
+RMDLCullParams GpuCuller::makeParams( uint32_t instanceCount, uint32_t meshCount, const float frustumPlanes[6][4] ) const
+{
+    RMDLCullParams params = {};
+    std::memcpy(params.frustumPlanes, frustumPlanes, sizeof(params.frustumPlanes));
+    params.instanceCount = std::min(instanceCount, _maxInstances);
+    params.meshCount = meshCount;
+    params.groupCount = (params.instanceCount + kCullThreadgroupSize - 1) / kCullThreadgroupSize;
+    return (params);
+}
+
+bool GpuCuller::encode( MTL4::ComputeCommandEncoder* pEncoder, uint64_t frameIndex,
+                        const MTL::Buffer* pInstances, const MTL::Buffer* pMeshes,
+                        uint32_t instanceCount, uint32_t meshCount, const float frustumPlanes[6][4] )
+{
+    MTL::ComputePipelineState* pCullKnl = _cullKnl.as<MTL::ComputePipelineState>();
+    MTL::ComputePipelineState* pScanKnl = _scanKnl.as<MTL::ComputePipelineState>();
+    MTL::ComputePipelineState* pCompactKnl = _compactKnl.as<MTL::ComputePipelineState>();
+    if (!pCullKnl || !pScanKnl || !pCompactKnl)
+        return (false);
+
+    const Frame& frame = _frames[frameIndex % _frames.size()];
+    const RMDLCullParams params = makeParams(instanceCount, meshCount, frustumPlanes);
+    std::memcpy(frame.pParams->contents(), &params, sizeof(params));
+
+    _pArgumentTable->setAddress( frame.pParams->gpuAddress(), CullBufferIndexParams );
+    _pArgumentTable->setAddress( pInstances->gpuAddress(), CullBufferIndexInstances );
+    _pArgumentTable->setAddress( pMeshes->gpuAddress(), CullBufferIndexMeshes );
+    _pArgumentTable->setAddress( frame.pVisibility->gpuAddress(), CullBufferIndexVisibility );
+    _pArgumentTable->setAddress( frame.pGroups->gpuAddress(), CullBufferIndexGroups );
+    _pArgumentTable->setAddress( frame.pArguments->gpuAddress(), CullBufferIndexArguments );
+    _pArgumentTable->setAddress( frame.pDrawRange->gpuAddress(), CullBufferIndexDrawRange );
+    pEncoder->setArgumentTable( _pArgumentTable );
+
+    const MTL::Size groups( std::max(1u, params.groupCount), 1, 1 );
+    const MTL::Size groupSize( kCullThreadgroupSize, 1, 1 );
+
+    pEncoder->setComputePipelineState( pCullKnl );
+    pEncoder->dispatchThreadgroups( groups, groupSize );
+    pEncoder->barrierAfterEncoderStages( MTL::StageDispatch, MTL::StageDispatch, MTL4::VisibilityOptionDevice );
+
+    pEncoder->setComputePipelineState( pScanKnl );
+    pEncoder->dispatchThreadgroups( MTL::Size( 1, 1, 1 ), MTL::Size( kCullScanThreadgroupSize, 1, 1 ) );
+    pEncoder->barrierAfterEncoderStages( MTL::StageDispatch, MTL::StageDispatch, MTL4::VisibilityOptionDevice );
+
+    pEncoder->setComputePipelineState( pCompactKnl );
+    pEncoder->dispatchThreadgroups( groups, groupSize );
+    return (true);
+}
+
+uint32_t GpuCuller::cullOnCpu( uint64_t frameIndex, const RMDLCullInstance* pInstances, const RMDLCullMesh* pMeshes,
+                               uint32_t instanceCount, uint32_t meshCount, const float frustumPlanes[6][4] )
+{
+    const Frame& frame = _frames[frameIndex % _frames.size()];
+    const RMDLCullParams params = makeParams(instanceCount, meshCount, frustumPlanes);
+    std::memcpy(frame.pParams->contents(), &params, sizeof(params));
+
+    const uint32_t drawCount = culling::cullAndCompact(params, pInstances, pMeshes,
+                                                       static_cast<RMDLDrawIndexedArguments*>(frame.pArguments->contents()));
+    const RMDLDrawRange range = { 0, drawCount };
+    std::memcpy(frame.pDrawRange->contents(), &range, sizeof(range));
+    return (drawCount);
+}
+
+bool GpuCuller::matchesReference( uint64_t frameIndex, const RMDLCullInstance* pInstances, const RMDLCullMesh* pMeshes ) const
+{
+    const Frame& frame = _frames[frameIndex % _frames.size()];
+    const RMDLCullParams& params = *static_cast<const RMDLCullParams*>(frame.pParams->contents());
+    const RMDLDrawRange& range = *static_cast<const RMDLDrawRange*>(frame.pDrawRange->contents());
+
+    std::vector<RMDLDrawIndexedArguments> expected(std::max(1u, params.instanceCount));
+    const uint32_t drawCount = culling::cullAndCompact(params, pInstances, pMeshes, expected.data());
+    return (range.location == 0 && range.length == drawCount &&
+            std::memcmp(frame.pArguments->contents(), expected.data(), drawCount * sizeof(RMDLDrawIndexedArguments)) == 0);
+}
@@ -0,0 +1,74 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLGpuCuller.hpp            +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 23:31:54      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLGPUCULLER_HPP
+# define RMDLGPUCULLER_HPP
+
+# include <Metal/Metal.hpp>
+
+# include <vector>
+
+# include "RMDLCulling.hpp"
+# include "RMDLPipelineCache.hpp"
+# include "NonCopyable.h"
+
+/// GPU-driven draw generation: takes a table of RMDLCullInstance and one of
+/// RMDLCullMesh, and fills an indirect argument buffer with one indexed draw per
+/// visible instance plus its RMDLDrawRange, using the kernels of Culling.metal.
+/// cullOnCpu() fills the same buffers with culling::cullAndCompact() instead,
+/// and matchesReference() checks a GPU result against it.
+class GpuCuller : public NonCopyable
+{
+public:
+    GpuCuller( MTL::Device* pDevice, pipeline_cache::PipelineManager& pipelines, uint32_t maxInstances, uint32_t framesInFlight );
+    ~GpuCuller();
+
+    /// Encodes the three dispatches for `frameIndex`. False, with nothing encoded,
+    /// while the kernels are still compiling.
+    bool            encode( MTL4::ComputeCommandEncoder* pEncoder, uint64_t frameIndex,
+                            const MTL::Buffer* pInstances, const MTL::Buffer* pMeshes,
+                            uint32_t instanceCount, uint32_t meshCount, const float frustumPlanes[6][4] );
+
+    /// Fallback: the same output written by the CPU. Returns the draw count.
+    uint32_t        cullOnCpu( uint64_t frameIndex, const RMDLCullInstance* pInstances, const RMDLCullMesh* pMeshes,
+                               uint32_t instanceCount, uint32_t meshCount, const float frustumPlanes[6][4] );
+
+    /// Once the GPU is done with `frameIndex`: true if its output is bit-identical to the CPU reference.
+    bool            matchesReference( uint64_t frameIndex, const RMDLCullInstance* pInstances, const RMDLCullMesh* pMeshes ) const;
+
+    /// RMDLDrawIndexedArguments, one per visible instance, in instance order.
+    MTL::Buffer*    argumentBuffer( uint64_t frameIndex ) const     { return (_frames[frameIndex % _frames.size()].pArguments); }
+    /// RMDLDrawRange, for executeCommandsInBuffer() or a CPU readback.
+    MTL::Buffer*    drawRangeBuffer( uint64_t frameIndex ) const    { return (_frames[frameIndex % _frames.size()].pDrawRange); }
+
+    void            addToResidencySet( MTL::ResidencySet* pResidencySet ) const;
+
+private:
+    struct Frame
+    {
+        MTL::Buffer*    pParams;
+        MTL::Buffer*    pArguments;
+        MTL::Buffer*    pDrawRange;
+        MTL::Buffer*    pVisibility;    // per instance, cull -> compact
+        MTL::Buffer*    pGroups;        // per threadgroup, cull -> scan -> compact
+    };
+
+    RMDLCullParams  makeParams( uint32_t instanceCount, uint32_t meshCount, const float frustumPlanes[6][4] ) const;
+
+    MTL::Device*                    _pDevice;
+    uint32_t                        _maxInstances;
+    std::vector<Frame>              _frames;
+    MTL4::ArgumentTable*            _pArgumentTable;
+    pipeline_cache::PipelineRef     _cullKnl;
+    pipeline_cache::PipelineRef     _scanKnl;
+    pipeline_cache::PipelineRef     _compactKnl;
+};
+
+#endif /* RMDLGPUCULLER_HPP */
@@ -0,0 +1,212 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLHalf.cpp                 +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 04:31:15      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLHalf.hpp"
+
+#include <atomic>
+
+#if defined(__aarch64__)
+# include <arm_neon.h>
+#elif defined(__x86_64__) || defined(__i386__)
+# include <immintrin.h>
+# define RMDL_HALF_X86 1
+#endif
+
+namespace half_float
+{
+
+namespace
+{
+    struct Converters
+    {
+        Path    path;
+        void    (*toHalf)( const float*, uint16_t*, size_t );
+        void    (*toFloat)( const uint16_t*, float*, size_t );
+    };
+
+#pragma mark - Software
+
+    void softwareToHalf( const float* pSrc, uint16_t* pDst, size_t count )
+    {
+        for (size_t i = 0; i < count; ++i)
+            pDst[i] = halfFromFloat(pSrc[i]);
+    }
+
+    void softwareToFloat( const uint16_t* pSrc, float* pDst, size_t count )
+    {
+        for (size_t i = 0; i < count; ++i)
+            pDst[i] = floatFromHalf(pSrc[i]);
+    }
+
+    constexpr Converters kSoftware = { Path::Software, softwareToHalf, softwareToFloat };
+
+#pragma mark - NEON
+
+#if defined(__aarch64__)
+    // FCVT rounds by FPCR, which is round-to-nearest-even with FZ16 clear unless
+    // someone changed it; the software path assumes the same.
+    void neonToHalf( const float* pSrc, uint16_t* pDst, size_t count )
+    {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const float16x8_t h = vcvt_high_f16_f32(vcvt_f16_f32(vld1q_f32(pSrc + i)), vld1q_f32(pSrc + i + 4));
+            vst1q_u16(pDst + i, vreinterpretq_u16_f16(h));
+        }
+        softwareToHalf(pSrc + i, pDst + i, count - i);
+    }
+
+    void neonToFloat( const uint16_t* pSrc, float* pDst, size_t count )
+    {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const float16x8_t h = vreinterpretq_f16_u16(vld1q_u16(pSrc + i));
+            vst1q_f32(pDst + i, vcvt_f32_f16(vget_low_f16(h)));
+            vst1q_f32(pDst + i + 4, vcvt_high_f32_f16(h));
+        }
+        softwareToFloat(pSrc + i, pDst + i, count - i);
+    }
+
+    constexpr Converters kNeon = { Path::Neon, neonToHalf, neonToFloat };
+#endif
+
+#pragma mark - F16C and AVX-512
+
+#if defined(RMDL_HALF_X86)
+    // The rounding mode is in the instruction, not MXCSR. Half denormals are
+    // neither produced as zero nor read as zero whatever FTZ and DAZ say.
+    __attribute__((target("avx,f16c")))
+    void f16cToHalf( const float* pSrc, uint16_t* pDst, size_t count )
+    {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+            _mm_storeu_si128((__m128i*)(pDst + i), _mm256_cvtps_ph(_mm256_loadu_ps(pSrc + i), _MM_FROUND_TO_NEAREST_INT));
+        softwareToHalf(pSrc + i, pDst + i, count - i);
+    }
+
+    __attribute__((target("avx,f16c")))
+    void f16cToFloat( const uint16_t* pSrc, float* pDst, size_t count )
+    {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+            _mm256_storeu_ps(pDst + i, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(pSrc + i))));
+        softwareToFloat(pSrc + i, pDst + i, count - i);
+    }
+
+    // AVX-512F already converts 16 lanes; the FP16 extension adds half arithmetic,
+    // which this does not need. The zero-masked forms with every lane set compile
+    // to the plain conversions; the unmasked ones pass an undefined source that
+    // GCC reports as maybe uninitialized.
+    __attribute__((target("avx512f")))
+    void avx512ToHalf( const float* pSrc, uint16_t* pDst, size_t count )
+    {
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+            _mm256_storeu_si256((__m256i*)(pDst + i), _mm512_maskz_cvtps_ph(0xffff, _mm512_loadu_ps(pSrc + i), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+        softwareToHalf(pSrc + i, pDst + i, count - i);
+    }
+
+    __attribute__((target("avx512f")))
+    void avx512ToFloat( const uint16_t* pSrc, float* pDst, size_t count )
+    {
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+            _mm512_storeu_ps(pDst + i, _mm512_maskz_cvtph_ps(0xffff, _mm256_loadu_si256((const __m256i*)(pSrc + i))));
+        softwareToFloat(pSrc + i, pDst + i, count - i);
+    }
+
+    constexpr Converters kF16c = { Path::F16c, f16cToHalf, f16cToFloat };
+    constexpr Converters kAvx512 = { Path::Avx512, avx512ToHalf, avx512ToFloat };
+#endif
+
+#pragma mark - Dispatch
+
+    const Converters* convertersFor( Path path )
+    {
+        switch (path)
+        {
+#if defined(__aarch64__)
+            case Path::Neon:        return (&kNeon);
+#elif defined(RMDL_HALF_X86)
+            case Path::F16c:        return (__builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c") ? &kF16c : nullptr);
+            case Path::Avx512:      return (__builtin_cpu_supports("avx512f") ? &kAvx512 : nullptr);
+#endif
+            case Path::Software:    return (&kSoftware);
+            default:                return (nullptr);
+        }
+    }
+
+    const Converters* bestConverters()
+    {
+        for (Path path : { Path::Avx512, Path::F16c, Path::Neon })
+        {
+            if (const Converters* pConverters = convertersFor(path))
+                return (pConverters);
+        }
+        return (&kSoftware);
+    }
+
+    std::atomic<const Converters*>& activeConverters()
+    {
+        static std::atomic<const Converters*> active( bestConverters() );
+        return (active);
+    }
+
+    const Converters& converters()
+    {
+        return (*activeConverters().load(std::memory_order_relaxed));
+    }
+}
+
+Path activePath()
+{
+    return (converters().path);
+}
+
+bool pathSupported( Path path )
+{
+    return (convertersFor(path) != nullptr);
+}
+
+bool forcePath( Path path )
+{
+    const Converters* pConverters = convertersFor(path);
+    if (!pConverters)
+        return (false);
+    activeConverters().store(pConverters, std::memory_order_relaxed);
+    return (true);
+}
+
+const char* pathName( Path path )
+{
+    switch (path)
+    {
+        case Path::Software:    return ("software");
+        case Path::Neon:        return ("NEON");
+        case Path::F16c:        return ("F16C");
+        case Path::Avx512:      return ("AVX-512");
+    }
+    return ("unknown");
+}
+
+#pragma mark - Entry points
+
+void toHalf( const float* pSrc, uint16_t* pDst, size_t count )
+{
+    converters().toHalf(pSrc, pDst, count);
+}
+
+void toFloat( const uint16_t* pSrc, float* pDst, size_t count )
+{
+    converters().toFloat(pSrc, pDst, count);
+}
+
+}
@@ -0,0 +1,94 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLHalf.hpp                 +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 04:31:08      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLHALF_HPP
+# define RMDLHALF_HPP
+
+# include <cstddef>
+# include <cstdint>
+# include <cstring>
+
+// IEEE binary16 <-> binary32 over arrays. Float to half rounds to nearest even,
+// keeps denormals, overflows to infinity and keeps NaNs quiet with the top of
+// their payload. The bulk functions use the conversion instructions when the
+// CPU has them (NEON on arm64, AVX-512 or F16C on x86) and the inline
+// functions below otherwise; all paths give the same bits.
+
+namespace half_float
+{
+    enum class Path : uint8_t
+    {
+        Software,
+        Neon,
+        F16c,
+        Avx512
+    };
+
+    /// The path the bulk functions take.
+    Path            activePath();
+    bool            pathSupported( Path path );
+    /// For tests and benchmarks; false, and nothing changes, if the CPU lacks it.
+    bool            forcePath( Path path );
+    const char*     pathName( Path path );
+
+    void            toHalf( const float* pSrc, uint16_t* pDst, size_t count );
+    void            toFloat( const uint16_t* pSrc, float* pDst, size_t count );
+
+    inline float    floatFromHalf( uint16_t h )
+    {
+        const uint32_t sign = (uint32_t)(h & 0x8000) << 16;
+        const uint32_t magnitude = h & 0x7FFF;
+        uint32_t bits = (magnitude << 13) + 0x38000000;     // exponent bias 15 -> 127
+        if (magnitude >= 0x7C00)
+        {
+            bits += 0x38000000;                             // infinity and NaN keep exponent 255
+            if (magnitude > 0x7C00)
+                bits |= 0x00400000;                         // quiet, as the instructions do
+        }
+        else if (magnitude < 0x0400)
+        {
+            // Zero or denormal: magnitude * 2^-24, exact in float.
+            const float f = (float)magnitude * 0x1p-24f;
+            memcpy(&bits, &f, sizeof(bits));
+        }
+        const uint32_t result = sign | bits;
+        float f;
+        memcpy(&f, &result, sizeof(f));
+        return (f);
+    }
+
+    inline uint16_t halfFromFloat( float f )
+    {
+        uint32_t bits;
+        memcpy(&bits, &f, sizeof(bits));
+        const uint16_t sign = (uint16_t)((bits >> 16) & 0x8000);
+        const uint32_t magnitude = bits & 0x7FFFFFFF;
+        if (magnitude > 0x7F800000)
+            return (sign | 0x7E00 | ((magnitude >> 13) & 0x3FF));
+        if (magnitude >= 0x477FF000)                        // 65520 and up round to infinity
+            return (sign | 0x7C00);
+        if (magnitude < 0x38800000)
+        {
+            // Below 2^-14: a denormal half, in units of 2^-24.
+            if (magnitude < 0x33000000)
+                return (sign);
+            const uint32_t shift = 126 - (magnitude >> 23);
+            const uint32_t mantissa = (magnitude & 0x7FFFFF) | 0x800000;
+            const uint32_t truncated = mantissa >> shift;
+            const uint32_t rest = mantissa & ((1u << shift) - 1);
+            const uint32_t midpoint = 1u << (shift - 1);
+            return (sign | (uint16_t)(truncated + (rest > midpoint || (rest == midpoint && (truncated & 1)))));
+        }
+        const uint32_t rounded = magnitude + 0xFFF + ((magnitude >> 13) & 1);
+        return (sign | (uint16_t)((rounded - 0x38000000) >> 13));
+    }
+}
+
+#endif /* RMDLHALF_HPP */
@@ -0,0 +1,204 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLInput.cpp                +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 02:48:27      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLInput.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace input
+{
+
+#pragma mark - InputStateMachine
+
+InputStateMachine::InputStateMachine()
+: _next( 0 )
+, _down( 0 )
+, _pRecording( nullptr )
+{
+    std::fill(std::begin(_downSince), std::end(_downSince), 0.0);
+    std::fill(std::begin(_axes), std::end(_axes), 0.f);
+}
+
+void InputStateMachine::push( const InputEvent& event )
+{
+    // Consumed events are compacted away once they are most of the buffer.
+    if (_next > 0 && _next * 2 >= _pending.size())
+    {
+        _pending.erase(_pending.begin(), _pending.begin() + (std::ptrdiff_t)_next);
+        _next = 0;
+    }
+    _pending.push_back(event);
+}
+
+InputState InputStateMachine::tick( double start, double end )
+{
+    InputState state;
+    state.start = start;
+    state.end = end;
+    for (uint32_t b = 0; b < kButtonCount; ++b)
+    {
+        if ((_down >> b) & 1u)
+            _downSince[b] = std::max(_downSince[b], start);
+    }
+
+    for (; _next < _pending.size() && _pending[_next].time < end; ++_next)
+    {
+        const InputEvent& event = _pending[_next];
+        const double t = std::max(event.time, start);
+        if (_pRecording)
+        {
+            // Late events are recorded when they took effect, so a replay through
+            // the same ticks does not depend on when the queue was drained.
+            _pRecording->push_back(event);
+            _pRecording->back().time = t;
+        }
+        switch (event.type)
+        {
+            case EventType::ButtonDown:
+            case EventType::ButtonUp:
+            {
+                if (event.code >= kButtonCount)
+                    break;
+                const uint32_t bit = 1u << event.code;
+                const bool down = event.type == EventType::ButtonDown;
+                // Key repeats and unmatched releases change nothing.
+                if (down == (bool)(_down & bit))
+                    break;
+                if (down)
+                {
+                    _down |= bit;
+                    _downSince[event.code] = t;
+                    state.pressed |= bit;
+                }
+                else
+                {
+                    _down &= ~bit;
+                    state.heldTime[event.code] += (float)(t - _downSince[event.code]);
+                    state.released |= bit;
+                }
+                break;
+            }
+            case EventType::AxisValue:
+                if (event.code < kAxisCount)
+                    _axes[event.code] = event.value[0];
+                break;
+            case EventType::MouseDelta:
+                state.mouseDelta[0] += event.value[0];
+                state.mouseDelta[1] += event.value[1];
+                break;
+        }
+    }
+
+    for (uint32_t b = 0; b < kButtonCount; ++b)
+    {
+        if ((_down >> b) & 1u)
+        {
+            state.heldTime[b] += (float)(end - _downSince[b]);
+            _downSince[b] = end;
+        }
+    }
+    state.down = _down;
+    std::copy(std::begin(_axes), std::end(_axes), state.axes);
+    return (state);
+}
+
+#pragma mark - InputQueue
+
+bool InputQueue::post( const InputEvent& event )
+{
+    if (_ring.push(event))
+        return (true);
+    _dropped.fetch_add(1, std::memory_order_relaxed);
+    return (false);
+}
+
+size_t InputQueue::drainInto( InputStateMachine& machine )
+{
+    return (_ring.drain( [&machine]( const InputEvent& event ) { machine.push(event); } ));
+}
+
+#pragma mark - Recordings
+
+namespace
+{
+    constexpr uint32_t kRecordingVersion = 1;
+
+    struct RecordingHeader
+    {
+        char        magic[4];
+        uint32_t    version;
+        uint64_t    eventCount;
+    };
+
+    struct RecordedEvent
+    {
+        double      time;
+        uint8_t     type;
+        uint8_t     code;
+        uint8_t     reserved[2];
+        float       value[2];
+    };
+}
+
+bool saveRecording( const std::string& path, const std::vector<InputEvent>& events )
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        return (false);
+
+    RecordingHeader header = {};
+    std::memcpy(header.magic, "RINP", 4);
+    header.version = kRecordingVersion;
+    header.eventCount = events.size();
+    out.write((const char *)&header, sizeof(header));
+    for (const InputEvent& event : events)
+    {
+        RecordedEvent record = {};
+        record.time = event.time;
+        record.type = (uint8_t)event.type;
+        record.code = event.code;
+        record.value[0] = event.value[0];
+        record.value[1] = event.value[1];
+        out.write((const char *)&record, sizeof(record));
+    }
+    return ((bool)out);
+}
+
+bool loadRecording( const std::string& path, std::vector<InputEvent>& events )
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        return (false);
+
+    RecordingHeader header;
+    if (!in.read((char *)&header, sizeof(header)) || std::memcmp(header.magic, "RINP", 4) != 0 || header.version != kRecordingVersion)
+        return (false);
+
+    events.clear();
+    events.reserve((size_t)std::min<uint64_t>(header.eventCount, 1u << 20));
+    for (uint64_t i = 0; i < header.eventCount; ++i)
+    {
+        RecordedEvent record;
+        if (!in.read((char *)&record, sizeof(record)) || record.type > (uint8_t)EventType::MouseDelta)
+            return (false);
+        InputEvent event;
+        event.time = record.time;
+        event.type = (EventType)record.type;
+        event.code = record.code;
+        event.value[0] = record.value[0];
+        event.value[1] = record.value[1];
+        events.push_back(event);
+    }
+    return (true);
+}
+
+}
@@ -0,0 +1,126 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLInput.hpp                +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 02:48:19      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLINPUT_HPP
+# define RMDLINPUT_HPP
+
+# include <atomic>
+# include <cstdint>
+# include <string>
+# include <vector>
+
+# include "RMDLSpscRing.hpp"
+
+// Input as timestamped events. Platform callbacks (NSEvent, GameController) push
+// them into an InputQueue from the main thread; the simulation drains the queue
+// and asks an InputStateMachine for one coalesced InputState per tick: what is
+// held, pressed and released, for how long each button was held inside the tick,
+// the latest axis values and the summed mouse motion. Movement driven by held
+// time does not depend on key repeat or frame rate. Consumed events can be
+// recorded and replayed through the same ticks for identical states.
+
+namespace input
+{
+    enum class Button : uint8_t
+    {
+        KeyW, KeyA, KeyS, KeyD, KeyQ, KeyE, KeyX, Space,
+        LeftArrow, RightArrow, UpArrow, DownArrow,
+        PadA, PadB, PadX, PadY,
+        Count
+    };
+
+    enum class Axis : uint8_t
+    {
+        LeftStickX, LeftStickY, RightStickX, RightStickY,
+        Count
+    };
+
+    enum class EventType : uint8_t
+    {
+        ButtonDown,
+        ButtonUp,
+        AxisValue,
+        MouseDelta
+    };
+
+    struct InputEvent
+    {
+        double      time    = 0.0;      // seconds, on the simulation's clock
+        EventType   type    = EventType::ButtonDown;
+        uint8_t     code    = 0;        // Button or Axis
+        float       value[2] = { 0.f, 0.f };    // axis value, or mouse dx, dy
+    };
+
+    static constexpr uint32_t kButtonCount = (uint32_t)Button::Count;
+    static constexpr uint32_t kAxisCount = (uint32_t)Axis::Count;
+
+    struct InputState
+    {
+        double      start           = 0.0;
+        double      end             = 0.0;
+        uint32_t    down            = 0;    // bit per Button, at the end of the tick
+        uint32_t    pressed         = 0;    // went down during the tick
+        uint32_t    released        = 0;    // went up; a tap inside one tick sets both
+        float       heldTime[kButtonCount]  = {};
+        float       axes[kAxisCount]        = {};
+        float       mouseDelta[2]           = { 0.f, 0.f };
+
+        bool        isDown( Button b ) const        { return ((down >> (uint32_t)b) & 1u); }
+        bool        wasPressed( Button b ) const    { return ((pressed >> (uint32_t)b) & 1u); }
+        bool        wasReleased( Button b ) const   { return ((released >> (uint32_t)b) & 1u); }
+        float       held( Button b ) const          { return (heldTime[(uint32_t)b]); }
+        float       axis( Axis a ) const            { return (axes[(uint32_t)a]); }
+    };
+
+    class InputStateMachine
+    {
+    public:
+        InputStateMachine();
+
+        /// Events in time order, as drained from the queue or read from a recording.
+        void        push( const InputEvent& event );
+        /// Consumes the events before `end`. Events older than `start` count as
+        /// happening at `start`; later ones wait for their tick.
+        InputState  tick( double start, double end );
+
+        /// Consumed events are appended to `pRecording` until it is set to null.
+        /// Pushed back through the same ticks, they give the same states.
+        void        record( std::vector<InputEvent>* pRecording )  { _pRecording = pRecording; }
+        size_t      pendingCount() const    { return (_pending.size() - _next); }
+
+    private:
+        std::vector<InputEvent>     _pending;
+        size_t                      _next;
+        uint32_t                    _down;
+        double                      _downSince[kButtonCount];
+        float                       _axes[kAxisCount];
+        std::vector<InputEvent>*    _pRecording;
+    };
+
+    /// Main thread to simulation thread.
+    class InputQueue
+    {
+    public:
+        /// Producer. False, and counted, when the ring is full.
+        bool        post( const InputEvent& event );
+        /// Consumer.
+        size_t      drainInto( InputStateMachine& machine );
+        uint64_t    dropped() const     { return (_dropped.load(std::memory_order_relaxed)); }
+
+    private:
+        parallel::SpscRing<InputEvent, 1024>    _ring;
+        std::atomic<uint64_t>                   _dropped { 0 };
+    };
+
+    bool    saveRecording( const std::string& path, const std::vector<InputEvent>& events );
+    bool    loadRecording( const std::string& path, std::vector<InputEvent>& events );
+}
+
+#endif /* RMDLINPUT_HPP */
@@ -8,7 +8,11 @@
 #ifndef RMDLMainRenderer_shared_h
 #define RMDLMainRenderer_shared_h
 
+#ifdef __METAL_VERSION__
 #include <simd/simd.h>
+#else
+#include "RMDLSimd.hpp"
+#endif
 
 struct RMDLCameraUniforms
 {
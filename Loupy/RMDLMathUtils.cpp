@@ -9,6 +9,7 @@
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
 #include "RMDLMathUtils.hpp"
+#include "RMDLHalf.hpp"
 
 namespace math
 {
@@ -111,46 +112,26 @@ namespace math
     }
 }
 
-uint32_t seed_lo, seed_hi;
-
-static float inline F16ToF32(const __fp16 *address) {
-    return *address;
-}
-
 float AAPL_SIMD_OVERLOAD float32_from_float16(uint16_t i) {
-    return F16ToF32((__fp16 *)&i);
-}
-
-static inline void F32ToF16(float F32, __fp16 *F16Ptr) {
-    *F16Ptr = F32;
+    return half_float::floatFromHalf(i);
 }
 
 uint16_t AAPL_SIMD_OVERLOAD float16_from_float32(float f) {
-    uint16_t f16;
-    F32ToF16(f, (__fp16 *)&f16);
-    return f16;
+    return half_float::halfFromFloat(f);
 }
 
 vector_float3 AAPL_SIMD_OVERLOAD generate_random_vector(float min, float max)
 {
-    vector_float3 rand;
-
-    float range = max - min;
-    rand.x = ((double)random() / (double) (0x7FFFFFFF)) * range + min;
-    rand.y = ((double)random() / (double) (0x7FFFFFFF)) * range + min;
-    rand.z = ((double)random() / (double) (0x7FFFFFFF)) * range + min;
-
-    return rand;
+    rng::Stream& stream = rng::threadStream();
+    return (vector_float3){ stream.uniform(min, max), stream.uniform(min, max), stream.uniform(min, max) };
 }
 
 void AAPL_SIMD_OVERLOAD seedRand(uint32_t seed) {
-    seed_lo = seed; seed_hi = ~seed;
+    rng::seedThreadStreams(seed);
 }
 
 int32_t AAPL_SIMD_OVERLOAD randi(void) {
-    seed_hi = (seed_hi<<16) + (seed_hi>>16);
-    seed_hi += seed_lo; seed_lo += seed_hi;
-    return seed_hi;
+    return (int32_t)rng::threadStream().nextU32();
 }
 
 float AAPL_SIMD_OVERLOAD randf(float x) {
@@ -676,8 +657,7 @@ static inline quaternion_float AAPL_SIMD_OVERLOAD quaternion_from_direction_vect
     quaternion_float q = quaternion_from_matrix3x3(m);
 
     if(right_handed) {
-        q = q.yxwz;
-        q.xw = -q.xw;
+        q = simd_make_float4(-q.y, q.x, q.w, -q.z);
     }
 
     q = vector_normalize(q);
@@ -11,8 +11,10 @@
 #ifndef MathUtils_hpp
 # define MathUtils_hpp
 
-# include <simd/simd.h>
+# include "RMDLSimd.hpp"
+# include "RMDLRandom.hpp"
 # include <assert.h>
+# include <stdint.h>
 # include <stdlib.h>
 
 namespace math
@@ -31,7 +33,11 @@ namespace math
 }
 
 // Because these are common methods, allow other libraries to overload their implementation.
+#if defined(__clang__)
 #define AAPL_SIMD_OVERLOAD __attribute__((__overloadable__))
+#else
+#define AAPL_SIMD_OVERLOAD
+#endif
 
 /// A single-precision quaternion type.
 typedef vector_float4 quaternion_float;
@@ -48,16 +54,16 @@ float AAPL_SIMD_OVERLOAD degrees_from_radians(float radians);
 /// Returns the number of radians in the specified number of degrees.
 float AAPL_SIMD_OVERLOAD radians_from_degrees(float degrees);
 
-// Generates a random float value inside the given range.
+// Generates a random float value inside the given range, from the calling thread's rng::Stream.
 inline static float AAPL_SIMD_OVERLOAD  random_float(float min, float max)
 {
-    return (((double)random()/RAND_MAX) * (max-min)) + min;
+    return rng::threadStream().uniform(min, max);
 }
 
 /// Generate a random three-component vector with values between min and max.
 vector_float3 AAPL_SIMD_OVERLOAD generate_random_vector(float min, float max);
 
-/// Fast random seed.
+/// Fast random seed: restarts every thread's stream.
 void AAPL_SIMD_OVERLOAD seedRand(uint32_t seed);
 
 /// Fast integer random.
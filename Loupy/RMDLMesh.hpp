@@ -133,6 +133,14 @@ Mesh makeIcosahedronMesh(MTL::Device* pDevice,
                          const MTL::VertexDescriptor& vertexDescriptor,
                          float radius);
 
+/// Every triangle of the mesh's triangle-list submeshes, as x, y, z per vertex
+/// and three indices per triangle, for CPU ray queries (RMDLBvh.hpp). Reads the
+/// buffers' contents(), so a mesh in private storage gives nothing.
+void meshTriangles(const Mesh& mesh,
+                   const MTL::VertexDescriptor& vertexDescriptor,
+                   std::vector<float>& positions,
+                   std::vector<uint32_t>& indices);
+
 MTL::Texture* newTextureFromCatalog( MTL::Device* pDevice, const char* name, MTL::StorageMode storageMode, MTL::TextureUsage usage );
 
 #pragma mark - MeshBuffer inline implementations
@@ -4,6 +4,7 @@
 #include <unordered_map>
 
 #include "RMDLMesh.hpp"
+#include "RMDLHalf.hpp"
 
 #import "RMDLMainRenderer_shared.h"
 #include "RMDLUtilities.h"
@@ -640,12 +641,13 @@ static void packVertexData(void *output, MTL::VertexFormat format, vector_float4
             ((int16_t*)output)[0] = 0x7FFF * (2.0 * value.x -1.0);
             break;
         case MTL::VertexFormatHalf4:
-            ((__fp16 *)output)[3] = value.w;
+            half_float::toHalf((const float *)&value, (uint16_t *)output, 4);
+            break;
         case MTL::VertexFormatHalf3:
-            ((__fp16 *)output)[2] = value.z;
+            half_float::toHalf((const float *)&value, (uint16_t *)output, 3);
+            break;
         case MTL::VertexFormatHalf2:
-            ((__fp16 *)output)[1] = value.y;
-            ((__fp16 *)output)[0] = value.x;
+            half_float::toHalf((const float *)&value, (uint16_t *)output, 2);
             break;
         case MTL::VertexFormatFloat4:
             ((float*)output)[3] = value.w;
@@ -928,6 +930,76 @@ Mesh makeIcosahedronMesh(MTL::Device* pDevice,
     return Mesh(submesh, vertexBuffers);
 }
 
+void meshTriangles(const Mesh& mesh,
+                   const MTL::VertexDescriptor& vertexDescriptor,
+                   std::vector<float>& positions,
+                   std::vector<uint32_t>& indices)
+{
+    positions.clear();
+    indices.clear();
+
+    MTL::VertexFormat positionFormat      = vertexDescriptor.attributes()->object(VertexAttributePosition)->format();
+    NS::UInteger positionBufferIndex  = vertexDescriptor.attributes()->object(VertexAttributePosition)->bufferIndex();
+    NS::UInteger positionVertexOffset = vertexDescriptor.attributes()->object(VertexAttributePosition)->offset();
+    if (positionBufferIndex >= mesh.vertexBuffers().size())
+        return;
+    const MeshBuffer& positionBuffer  = mesh.vertexBuffers()[positionBufferIndex];
+    NS::UInteger positionStride       = vertexDescriptor.layouts()->object(positionBufferIndex)->stride();
+
+    NS::UInteger positionSize;
+    switch (positionFormat)
+    {
+        case MTL::VertexFormatFloat3:
+        case MTL::VertexFormatFloat4:
+            positionSize = 3 * sizeof(float);
+            break;
+        case MTL::VertexFormatHalf3:
+        case MTL::VertexFormatHalf4:
+            positionSize = 3 * sizeof(uint16_t);
+            break;
+        default:
+            return;
+    }
+
+    const uint8_t* bufferContents = (const uint8_t*)positionBuffer.buffer()->contents();
+    if (!bufferContents || positionStride == 0 || positionBuffer.length() < positionVertexOffset + positionSize)
+        return;
+    const NS::UInteger vertexCount = (positionBuffer.length() - positionVertexOffset - positionSize) / positionStride + 1;
+
+    positions.resize(3 * vertexCount);
+    const uint8_t* positionData = bufferContents + positionBuffer.offset() + positionVertexOffset;
+    for (NS::UInteger vertexIndex = 0; vertexIndex < vertexCount; vertexIndex++)
+    {
+        if (positionSize == 3 * sizeof(float))
+            memcpy(&positions[3 * vertexIndex], positionData, positionSize);
+        else
+            half_float::toFloat((const uint16_t *)positionData, &positions[3 * vertexIndex], 3);
+        positionData += positionStride;
+    }
+
+    for (const Submesh& submesh : mesh.submeshes())
+    {
+        if (submesh.primitiveType() != MTL::PrimitiveTypeTriangle)
+            continue;
+        const uint8_t* indexContents = (const uint8_t*)submesh.indexBuffer().buffer()->contents();
+        if (!indexContents)
+            continue;
+        indexContents += submesh.indexBuffer().offset();
+        const bool shortIndices = submesh.indexType() == MTL::IndexTypeUInt16;
+        for (NS::UInteger first = 0; first + 3 <= submesh.indexCount(); first += 3)
+        {
+            uint32_t corners[3];
+            for (NS::UInteger corner = 0; corner < 3; corner++)
+            {
+                corners[corner] = shortIndices ? ((const uint16_t*)indexContents)[first + corner]
+                                               : ((const uint32_t*)indexContents)[first + corner];
+            }
+            if (corners[0] < vertexCount && corners[1] < vertexCount && corners[2] < vertexCount)
+                indices.insert(indices.end(), corners, corners + 3);
+        }
+    }
+}
+
 MTL::Texture* newTextureFromCatalog( MTL::Device* pDevice, const char* name, MTL::StorageMode storageMode, MTL::TextureUsage usage )
 {
     NSDictionary<MTKTextureLoaderOption, id>* options = @{
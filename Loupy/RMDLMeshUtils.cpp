@@ -1,5 +1,4 @@
 #include <simd/simd.h>
-#include <sstream>
 
 #include "RMDLUtils.hpp"
 #include "RMDLMeshUtils.hpp"
@@ -221,16 +220,19 @@ IndexedMesh mesh_utils::newTextMesh( const std::string& text, const FontAtlas& f
     const size_t numVertices = 4 * text.size();
     const float charWidth = 1.0f;
     const float meshWidth = charWidth * (float)text.size();
+    // 16-bit indices only address 65536 vertices (16384 characters).
+    const bool wideIndices = numVertices > 0xFFFF;
     std::vector<VertexData> meshVertices(numVertices);
-    std::vector<uint16_t> indices;
+    std::vector<uint32_t> indices;
+    indices.reserve(6 * text.size());
     for (size_t i = 0; i < text.size(); ++i)
     {
         float x = i / (float)(text.size() - 1);
         float tx = (meshWidth * x) - (meshWidth * 0.5f);
         FontAtlas::CharUVs UVMap = {0};
-        if (text[i] >= '!' && text[i] < '_')
+        if (text[i] >= g_chars[0] && text[i] <= g_chars[kNumCharacters - 1])
         {
-            UVMap = (fontAtlas.charToUVs[text[i]-'!']);
+            UVMap = (fontAtlas.charToUVs[text[i]-g_chars[0]]);
         }
         
         meshVertices[i * 4 + 0].position = simd_make_float4(-0.5 + tx, +0.5, 0.0, 1.0);
@@ -246,30 +248,42 @@ IndexedMesh mesh_utils::newTextMesh( const std::string& text, const FontAtlas& f
         meshVertices[i * 4 + 3].texcoord = simd_make_float4(UVMap.ne, 0, 1);
         
 
-        indices.push_back(i * 4 + 0 );
-        indices.push_back(i * 4 + 1);
-        indices.push_back(i * 4 + 2);
+        indices.push_back((uint32_t)(i * 4 + 0));
+        indices.push_back((uint32_t)(i * 4 + 1));
+        indices.push_back((uint32_t)(i * 4 + 2));
         
-        indices.push_back(i * 4 + 2);
-        indices.push_back(i * 4 + 3);
-        indices.push_back(i * 4 + 0);
+        indices.push_back((uint32_t)(i * 4 + 2));
+        indices.push_back((uint32_t)(i * 4 + 3));
+        indices.push_back((uint32_t)(i * 4 + 0));
     }
     IndexedMesh result;
     result.pVertices = pDevice->newBuffer(meshVertices.data(), sizeof(VertexData) * meshVertices.size(), MTL::ResourceStorageModeShared);
-    result.pIndices = pDevice->newBuffer(indices.data(), sizeof(uint16_t) * indices.size(), MTL::ResourceStorageModeShared);
-    result.numIndices = (uint32_t)indices.size();
-    result.indexType = MTL::IndexTypeUInt16;
-    result.winding = MTL::WindingCounterClockwise;
+    if (wideIndices)
     {
-        std::stringstream ss;
-        ss << "TextMesh: " << text << "(vertices)";
-        result.pVertices->setLabel(NS::String::string(ss.str().c_str(), NS::UTF8StringEncoding));
+        result.pIndices = pDevice->newBuffer(indices.data(), sizeof(uint32_t) * indices.size(), MTL::ResourceStorageModeShared);
+        result.indexType = MTL::IndexTypeUInt32;
     }
+    else
     {
-        std::stringstream ss;
-        ss << "TextMesh" << text << "(indices)";
-        result.pIndices->setLabel(NS::String::string(ss.str().c_str(), NS::UTF8StringEncoding));
+        std::vector<uint16_t> narrowIndices(indices.begin(), indices.end());
+        result.pIndices = pDevice->newBuffer(narrowIndices.data(), sizeof(uint16_t) * narrowIndices.size(), MTL::ResourceStorageModeShared);
+        result.indexType = MTL::IndexTypeUInt16;
     }
+    result.numIndices = (uint32_t)indices.size();
+    result.winding = MTL::WindingCounterClockwise;
+    result.pVertices->setLabel(MTLSTR("TextMesh (vertices)"));
+    result.pIndices->setLabel(MTLSTR("TextMesh (indices)"));
     
     return (result);
 }
+
+// Shared by every instanced quad draw (text glyphs): corners 0..3 are
+// top-left, bottom-left, bottom-right, top-right.
+MTL::Buffer* mesh_utils::newUnitQuadIndexBuffer( MTL::Device* pDevice )
+{
+    static const uint16_t indexData[] = { 0, 1, 2, 2, 3, 0 };
+
+    MTL::Buffer* pIndexBuffer = pDevice->newBuffer( indexData, sizeof(indexData), MTL::ResourceStorageModeShared );
+    pIndexBuffer->setLabel(MTLSTR("Unit Quad (indices)"));
+    return (pIndexBuffer);
+}
@@ -5,7 +5,6 @@
 
 #include <vector>
 #include <simd/simd.h>
-#include <sstream>
 
 #include "RMDLFontLoader.h"
 #include "RMDLUtils.hpp"
@@ -26,6 +25,7 @@ namespace mesh_utils
     IndexedMesh newScreenQuad( MTL::Device* pDevice, float horizontalScale = 1.0f, float verticalScale = 1.0f );
     void        releaseMesh(IndexedMesh* pIndexedMesh);
     IndexedMesh newTextMesh( const std::string& text, const FontAtlas& fontAtlas, MTL::Device* pDevice );
+    MTL::Buffer* newUnitQuadIndexBuffer( MTL::Device* pDevice );
 }
 
 #endif // RMDLMESHUTILS_HPP
@@ -0,0 +1,70 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLMetalRecordingBackend.cpp +++    +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 22:41:20      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLMetalRecordingBackend.hpp"
+
+MetalRecordingBackend::MetalRecordingBackend( MTL::Device* pDevice, MTL4::CommandQueue* pCommandQueue )
+: _pDevice( pDevice->retain() )
+, _pCommandQueue( pCommandQueue->retain() )
+{
+}
+
+MetalRecordingBackend::~MetalRecordingBackend()
+{
+    _pCommandQueue->release();
+    _pDevice->release();
+}
+
+void* MetalRecordingBackend::newAllocator()
+{
+    return (_pDevice->newCommandAllocator());
+}
+
+void MetalRecordingBackend::resetAllocator( void* pAllocator )
+{
+    static_cast<MTL4::CommandAllocator*>(pAllocator)->reset();
+}
+
+void MetalRecordingBackend::releaseAllocator( void* pAllocator )
+{
+    static_cast<MTL4::CommandAllocator*>(pAllocator)->release();
+}
+
+void* MetalRecordingBackend::beginCommandBuffer( void* pAllocator )
+{
+    MTL4::CommandBuffer* pCommandBuffer = _pDevice->newCommandBuffer();
+    pCommandBuffer->beginCommandBuffer( static_cast<MTL4::CommandAllocator*>(pAllocator) );
+    return (pCommandBuffer);
+}
+
+void MetalRecordingBackend::endCommandBuffer( void* pCommandBuffer )
+{
+    static_cast<MTL4::CommandBuffer*>(pCommandBuffer)->endCommandBuffer();
+}
+
+void MetalRecordingBackend::submit( void* const* pCommandBuffers, size_t count )
+{
+    const MTL4::CommandBuffer* const* ppCommandBuffers = reinterpret_cast<const MTL4::CommandBuffer* const*>(pCommandBuffers);
+    if (_commitFeedback)
+    {
+        MTL4::CommitOptions* pOptions = MTL4::CommitOptions::alloc()->init();
+        pOptions->addFeedbackHandler( _commitFeedback );
+        _pCommandQueue->commit( ppCommandBuffers, count, pOptions );
+        pOptions->release();
+    }
+    else
+    {
+        _pCommandQueue->commit( ppCommandBuffers, count );
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        static_cast<MTL4::CommandBuffer*>(pCommandBuffers[i])->release();
+    }
+}
@@ -0,0 +1,44 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLMetalRecordingBackend.hpp +++    +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 22:41:12      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLMETALRECORDINGBACKEND_HPP
+# define RMDLMETALRECORDINGBACKEND_HPP
+
+# include <Metal/Metal.hpp>
+
+# include "RMDLCommandRecorder.hpp"
+# include "NonCopyable.h"
+
+/// command_recording::RecordingBackend on one MTL4::CommandQueue: allocators are
+/// MTL4::CommandAllocator, command buffers MTL4::CommandBuffer.
+class MetalRecordingBackend : public command_recording::RecordingBackend, public NonCopyable
+{
+public:
+    MetalRecordingBackend( MTL::Device* pDevice, MTL4::CommandQueue* pCommandQueue );
+    ~MetalRecordingBackend() override;
+
+    void*   newAllocator() override;
+    void    resetAllocator( void* pAllocator ) override;
+    void    releaseAllocator( void* pAllocator ) override;
+
+    void*   beginCommandBuffer( void* pAllocator ) override;
+    void    endCommandBuffer( void* pCommandBuffer ) override;
+    void    submit( void* const* pCommandBuffers, size_t count ) override;
+
+    /// Attached to every commit from now on, e.g. to time a frame's GPU work; empty to stop.
+    void    setCommitFeedback( const MTL4::CommitFeedbackHandlerFunction& handler ) { _commitFeedback = handler; }
+
+private:
+    MTL::Device*                            _pDevice;
+    MTL4::CommandQueue*                     _pCommandQueue;
+    MTL4::CommitFeedbackHandlerFunction     _commitFeedback;
+};
+
+#endif /* RMDLMETALRECORDINGBACKEND_HPP */
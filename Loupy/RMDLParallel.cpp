@@ -0,0 +1,140 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLParallel.cpp             +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 13:40:09      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLParallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+parallel::ThreadPool::ThreadPool( unsigned threadCount )
+: _stopping( false )
+{
+    if (threadCount == 0)
+    {
+        const unsigned hw = std::thread::hardware_concurrency();
+        threadCount = hw > 1 ? hw - 1 : 1;
+    }
+    _threads.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i)
+    {
+        _threads.emplace_back( [this]() { workerLoop(); } );
+    }
+}
+
+parallel::ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _wake.notify_all();
+    for (std::thread& thread : _threads)
+    {
+        thread.join();
+    }
+}
+
+unsigned parallel::ThreadPool::size() const
+{
+    return ((unsigned)_threads.size());
+}
+
+void parallel::ThreadPool::enqueue( std::function<void()> job )
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _jobs.push_back(std::move(job));
+    }
+    _wake.notify_one();
+}
+
+void parallel::ThreadPool::workerLoop()
+{
+    for (;;)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wake.wait(lock, [this]() { return (_stopping || !_jobs.empty()); });
+            if (_jobs.empty())
+                return;
+            job = std::move(_jobs.front());
+            _jobs.pop_front();
+        }
+        job();
+    }
+}
+
+namespace
+{
+    // Shared with the helper jobs, which may start after forRange returned.
+    struct RangeState
+    {
+        std::function<void(size_t, size_t)> fn;
+        size_t                              count;
+        size_t                              grain;
+        size_t                              chunks;
+        std::atomic<size_t>                 next { 0 };
+        std::atomic<size_t>                 done { 0 };
+        std::mutex                          mutex;
+        std::condition_variable             finished;
+
+        void run()
+        {
+            size_t chunk;
+            while ((chunk = next.fetch_add(1, std::memory_order_relaxed)) < chunks)
+            {
+                const size_t begin = chunk * grain;
+                fn(begin, std::min(begin + grain, count));
+                if (done.fetch_add(1, std::memory_order_acq_rel) + 1 == chunks)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    finished.notify_all();
+                }
+            }
+        }
+    };
+}
+
+void parallel::ThreadPool::forRange( size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn )
+{
+    if (count == 0)
+        return;
+    grain = std::max<size_t>(grain, 1);
+    const size_t chunks = (count + grain - 1) / grain;
+    if (chunks == 1 || _threads.empty())
+    {
+        for (size_t begin = 0; begin < count; begin += grain)
+            fn(begin, std::min(begin + grain, count));
+        return;
+    }
+
+    auto pState = std::make_shared<RangeState>();
+    pState->fn = fn;
+    pState->count = count;
+    pState->grain = grain;
+    pState->chunks = chunks;
+
+    const size_t helpers = std::min<size_t>(_threads.size(), chunks - 1);
+    for (size_t i = 0; i < helpers; ++i)
+    {
+        enqueue( [pState]() { pState->run(); } );
+    }
+    pState->run();
+
+    std::unique_lock<std::mutex> lock(pState->mutex);
+    pState->finished.wait(lock, [&]() { return (pState->done.load(std::memory_order_acquire) == chunks); });
+}
+
+parallel::ThreadPool& parallel::defaultPool()
+{
+    static ThreadPool pool;
+    return (pool);
+}
@@ -0,0 +1,94 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLParallel.hpp             +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 13:40:05      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLPARALLEL_HPP
+# define RMDLPARALLEL_HPP
+
+# include <condition_variable>
+# include <cstddef>
+# include <deque>
+# include <functional>
+# include <future>
+# include <memory>
+# include <mutex>
+# include <thread>
+# include <vector>
+
+# include "NonCopyable.h"
+
+namespace parallel
+{
+    /// Fixed set of worker threads fed from one FIFO queue.
+    class ThreadPool : public NonCopyable
+    {
+    public:
+        /// `threadCount` 0 picks hardware_concurrency() - 1 (the caller is the extra worker).
+        explicit ThreadPool( unsigned threadCount = 0 );
+        ~ThreadPool();
+
+        unsigned    size() const;
+        void        enqueue( std::function<void()> job );
+
+        template< typename F >
+        auto        submit( F&& fn ) -> std::future<decltype(fn())>;
+
+        /// Splits [0, count) into chunks of `grain` and runs `fn(begin, end)` on the
+        /// workers and the calling thread. Blocks until every chunk is done; safe to
+        /// call from inside a job because the caller keeps claiming chunks itself.
+        void        forRange( size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn );
+
+    private:
+        void        workerLoop();
+
+        std::vector<std::thread>            _threads;
+        std::deque<std::function<void()>>   _jobs;
+        std::mutex                          _mutex;
+        std::condition_variable             _wake;
+        bool                                _stopping;
+    };
+
+    /// Process-wide pool, created on first use.
+    ThreadPool& defaultPool();
+
+    /// Runs `fn(i)` for every i in [0, count) on the default pool.
+    template< typename F >
+    void        forEach( size_t count, F&& fn );
+
+    /// Runs `fn(begin, end)` over [0, count) in chunks of `grain` on the default pool.
+    template< typename F >
+    void        forRange( size_t count, size_t grain, F&& fn );
+}
+
+template< typename F >
+auto parallel::ThreadPool::submit( F&& fn ) -> std::future<decltype(fn())>
+{
+    using Result = decltype(fn());
+    auto pTask = std::make_shared<std::packaged_task<Result()>>( std::forward<F>(fn) );
+    std::future<Result> future = pTask->get_future();
+    enqueue( [pTask]() { (*pTask)(); } );
+    return (future);
+}
+
+template< typename F >
+void parallel::forEach( size_t count, F&& fn )
+{
+    defaultPool().forRange( count, 1, [&fn]( size_t begin, size_t end ) {
+        for (size_t i = begin; i < end; ++i)
+            fn(i);
+    });
+}
+
+template< typename F >
+void parallel::forRange( size_t count, size_t grain, F&& fn )
+{
+    defaultPool().forRange( count, grain, [&fn]( size_t begin, size_t end ) { fn(begin, end); } );
+}
+
+#endif /* RMDLPARALLEL_HPP */
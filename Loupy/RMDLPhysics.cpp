@@ -0,0 +1,956 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLPhysics.cpp              +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 07:58:47      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLPhysics.hpp"
+#include "RMDLParallel.hpp"
+
+#include <algorithm>
+
+namespace physics
+{
+
+namespace
+{
+    static constexpr uint32_t kTriangleBit = 1u << 31;
+    /// Sorted proxies per sweep job, and pairs per narrow-phase job.
+    static constexpr size_t kSweepChunk = 512;
+    static constexpr size_t kContactChunk = 512;
+    /// Approach speeds below this do not bounce, so resting contacts settle.
+    static constexpr Scalar kBounceThreshold = Scalar::fromRatio(1, 2);
+    /// Edge-cross axes shorter than 1/32 of their edge are nearly parallel to
+    /// a box axis; their direction is mostly rounding.
+    static constexpr int64_t kParallelRatio = 1024;
+    /// An edge-edge contact must be this much shallower than the best face to
+    /// win, so a box lying on a face does not flicker to an edge.
+    static constexpr Scalar kEdgeBias = Scalar::fromRatio(1, 200);
+    /// Contact points per pair, and a clipped polygon's worst case: a quad
+    /// cut by four planes.
+    static constexpr int kMaxPoints = 4;
+    static constexpr int kMaxClipped = 8;
+
+    inline Scalar component( const Vec3& v, int axis )
+    {
+        return (axis == 0 ? v.x : (axis == 1 ? v.y : v.z));
+    }
+
+    inline Vec3 unitAxis( int axis, Scalar sign )
+    {
+        Vec3 v = {};
+        (axis == 0 ? v.x : (axis == 1 ? v.y : v.z)) = sign;
+        return (v);
+    }
+
+    inline Vec3 divide( const Vec3& v, Scalar s )
+    {
+        return (Vec3{ v.x / s, v.y / s, v.z / s });
+    }
+
+    inline bool isZero( const Vec3& v )
+    {
+        return (v.x.raw == 0 && v.y.raw == 0 && v.z.raw == 0);
+    }
+
+    /// Closest point of the segment [a, b] to p; a when the segment is a point.
+    Vec3 closestOnSegment( const Vec3& p, const Vec3& a, const Vec3& b )
+    {
+        const Vec3 ab = b - a;
+        const Scalar along = dot(p - a, ab), lengthSq = lengthSquared(ab);
+        if (along.raw <= 0 || lengthSq.raw == 0)
+            return (a);
+        if (along >= lengthSq)
+            return (b);
+        return (a + ab * (along / lengthSq));
+    }
+
+    /// The nearest of the edges' closest points: the answer for a triangle
+    /// too thin for the barycentric ratios, whose denominators round to 0.
+    Vec3 closestOnEdges( const Vec3& p, const Triangle& t )
+    {
+        const Vec3 candidates[3] = { closestOnSegment(p, t.a, t.b), closestOnSegment(p, t.b, t.c), closestOnSegment(p, t.c, t.a) };
+        Vec3 best = candidates[0];
+        Scalar bestDistance = lengthSquared(best - p);
+        for (int k = 1; k < 3; ++k)
+        {
+            const Scalar distance = lengthSquared(candidates[k] - p);
+            if (distance < bestDistance)
+            {
+                best = candidates[k];
+                bestDistance = distance;
+            }
+        }
+        return (best);
+    }
+
+    /// Closest point of the triangle to p (Ericson, Real-Time Collision
+    /// Detection, 5.1.5). Every ratio checks its denominator.
+    Vec3 closestOnTriangle( const Vec3& p, const Triangle& t )
+    {
+        const Vec3 ab = t.b - t.a, ac = t.c - t.a, ap = p - t.a;
+        const Scalar d1 = dot(ab, ap), d2 = dot(ac, ap);
+        if (d1.raw <= 0 && d2.raw <= 0)
+            return (t.a);
+        const Vec3 bp = p - t.b;
+        const Scalar d3 = dot(ab, bp), d4 = dot(ac, bp);
+        if (d3.raw >= 0 && d4 <= d3)
+            return (t.b);
+        const Scalar vc = d1 * d4 - d3 * d2;
+        if (vc.raw <= 0 && d1.raw >= 0 && d3.raw <= 0)
+        {
+            const Scalar den = d1 - d3;
+            return (den.raw == 0 ? closestOnEdges(p, t) : t.a + ab * (d1 / den));
+        }
+        const Vec3 cp = p - t.c;
+        const Scalar d5 = dot(ab, cp), d6 = dot(ac, cp);
+        if (d6.raw >= 0 && d5 <= d6)
+            return (t.c);
+        const Scalar vb = d5 * d2 - d1 * d6;
+        if (vb.raw <= 0 && d2.raw >= 0 && d6.raw <= 0)
+        {
+            const Scalar den = d2 - d6;
+            return (den.raw == 0 ? closestOnEdges(p, t) : t.a + ac * (d2 / den));
+        }
+        const Scalar va = d3 * d6 - d5 * d4;
+        if (va.raw <= 0 && (d4 - d3).raw >= 0 && (d5 - d6).raw >= 0)
+        {
+            const Scalar den = (d4 - d3) + (d5 - d6);
+            return (den.raw == 0 ? closestOnEdges(p, t) : t.b + (t.c - t.b) * ((d4 - d3) / den));
+        }
+        // Inside the face: drop p onto the plane. The barycentric ratios would
+        // carry 1/65536 of the triangle's size in error, and tilt the normal.
+        const Vec3 n = cross(ab, ac);
+        const Scalar nLength = length(n);
+        if (nLength.raw == 0)
+            return (closestOnEdges(p, t));
+        const Vec3 unit = divide(n, nLength);
+        return (p - unit * dot(ap, unit));
+    }
+
+    /// Unit normal and depth that push a sphere at `center` out of a sphere
+    /// or point at `target`; false when they do not touch.
+    bool separateFromPoint( const Vec3& center, Scalar radius, const Vec3& target, const Vec3& fallback,
+                            Vec3& normal, Scalar& depth )
+    {
+        const Vec3 d = target - center;
+        const Scalar distanceSquared = lengthSquared(d);
+        if (distanceSquared > radius * radius)
+            return (false);
+        const Scalar distance = sqrt(distanceSquared);
+        normal = distance.raw > 0 ? divide(d, distance) : fallback;
+        depth = radius - distance;
+        return (true);
+    }
+
+    void tangentBasis( const Vec3& n, Vec3 tangent[2] )
+    {
+        // Cross with the axis n is least aligned with.
+        const Scalar limit = Scalar::fromRatio(577, 1000);
+        const int axis = abs(n.x) < limit ? 0 : (abs(n.y) < limit ? 1 : 2);
+        const Vec3 t = cross(n, unitAxis(axis, Scalar::fromInt(1)));
+        tangent[0] = divide(t, length(t));
+        tangent[1] = cross(n, tangent[0]);
+    }
+
+    /// Up to four points sharing one normal, from a to b, each inside the
+    /// overlap with its own depth.
+    struct Manifold
+    {
+        Vec3        normal;
+        int         count = 0;
+        Vec3        points[kMaxPoints];
+        Scalar      depths[kMaxPoints];
+
+        void        add( const Vec3& point, Scalar depth )
+        {
+            if (count < kMaxPoints)
+            {
+                points[count] = point;
+                depths[count++] = depth;
+            }
+        }
+    };
+
+    struct Box
+    {
+        Vec3        center;
+        Vec3        axes[3];
+        Vec3        half;
+    };
+
+    /// Sphere against a box centred on the origin, in the box's frame;
+    /// `point` is on the box's surface.
+    bool sphereBox( const Vec3& center, Scalar radius, const Vec3& half, Vec3& normal, Scalar& depth, Vec3& point )
+    {
+        const Vec3 q = max(-half, min(center, half));
+        if (!(q == center))
+        {
+            if (!separateFromPoint(center, radius, q, Vec3{}, normal, depth))
+                return (false);
+            point = q;
+            if (!isZero(normal))
+                return (true);
+        }
+        // Centre inside the box: out through the nearest face.
+        int bestAxis = 0;
+        Scalar bestSign = Scalar::fromInt(1), bestDistance;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            const Scalar up = component(half, axis) - component(center, axis);
+            const Scalar down = component(center, axis) + component(half, axis);
+            const Scalar distance = min(up, down);
+            if (axis == 0 || distance < bestDistance)
+            {
+                bestAxis = axis;
+                bestDistance = distance;
+                bestSign = up <= down ? Scalar::fromInt(-1) : Scalar::fromInt(1);
+            }
+        }
+        normal = unitAxis(bestAxis, bestSign);
+        depth = radius + bestDistance;
+        point = center - normal * bestDistance;
+        return (true);
+    }
+
+    /// Keeps the part of the polygon where dot(p, plane) <= offset
+    /// (Sutherland-Hodgman); adds at most one point.
+    int clip( const Vec3* pIn, int count, const Vec3& plane, Scalar offset, Vec3* pOut )
+    {
+        int kept = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            const Vec3& p = pIn[i];
+            const Vec3& q = pIn[(i + 1) % count];
+            const Scalar dp = dot(p, plane) - offset, dq = dot(q, plane) - offset;
+            if (dp.raw <= 0)
+                pOut[kept++] = p;
+            if ((dp.raw <= 0) != (dq.raw <= 0))
+                pOut[kept++] = p + (q - p) * (dp / (dp - dq));
+        }
+        return (kept);
+    }
+
+    /// Adds the clipped points below the reference plane dot(p, normal) =
+    /// offset. More than four keep the extremes along u and v, which span
+    /// the footprint.
+    void addBelow( const Vec3* pPoints, int count, const Vec3& normal, Scalar offset, const Vec3& u, const Vec3& v, Manifold& m )
+    {
+        Vec3 points[kMaxClipped];
+        Scalar depths[kMaxClipped];
+        int kept = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            const Scalar depth = offset - dot(pPoints[i], normal);
+            if (depth.raw < 0)
+                continue;
+            points[kept] = pPoints[i] + normal * (depth * Scalar::fromRatio(1, 2));
+            depths[kept++] = depth;
+        }
+        if (kept <= kMaxPoints)
+        {
+            for (int i = 0; i < kept; ++i)
+                m.add(points[i], depths[i]);
+            return;
+        }
+        int extremes[4] = { 0, 0, 0, 0 };
+        for (int i = 1; i < kept; ++i)
+        {
+            const Scalar pu = dot(points[i], u), pv = dot(points[i], v);
+            extremes[0] = pu < dot(points[extremes[0]], u) ? i : extremes[0];
+            extremes[1] = pu > dot(points[extremes[1]], u) ? i : extremes[1];
+            extremes[2] = pv < dot(points[extremes[2]], v) ? i : extremes[2];
+            extremes[3] = pv > dot(points[extremes[3]], v) ? i : extremes[3];
+        }
+        for (int k = 0; k < 4; ++k)
+        {
+            if (std::find(extremes, extremes + k, extremes[k]) == extremes + k)
+                m.add(points[extremes[k]], depths[extremes[k]]);
+        }
+    }
+
+    /// The face on the + or - side of `axis`, as a quad.
+    void boxFace( const Box& box, int axis, bool positive, Vec3 quad[4] )
+    {
+        const int u = (axis + 1) % 3, v = (axis + 2) % 3;
+        const Scalar h = component(box.half, axis);
+        const Vec3 c = box.center + box.axes[axis] * (positive ? h : -h);
+        const Vec3 du = box.axes[u] * component(box.half, u), dv = box.axes[v] * component(box.half, v);
+        quad[0] = c + du + dv;
+        quad[1] = c - du + dv;
+        quad[2] = c - du - dv;
+        quad[3] = c + du - dv;
+    }
+
+    /// The face of `box` most against `normal`.
+    void incidentFace( const Box& box, const Vec3& normal, Vec3 quad[4] )
+    {
+        int best = 0;
+        Scalar bestAlong = dot(box.axes[0], normal);
+        for (int axis = 1; axis < 3; ++axis)
+        {
+            const Scalar along = dot(box.axes[axis], normal);
+            if (abs(along) > abs(bestAlong))
+            {
+                best = axis;
+                bestAlong = along;
+            }
+        }
+        boxFace(box, best, bestAlong.raw < 0, quad);
+    }
+
+    /// Clips `polygon` to the sides of the reference face (`axis`, on the
+    /// side `normal` points to) and adds what lies under it.
+    void clipToFace( const Box& reference, int axis, const Vec3& normal, const Vec3* pPolygon, int count, Manifold& m )
+    {
+        Vec3 buffers[2][kMaxClipped];
+        std::copy(pPolygon, pPolygon + count, buffers[0]);
+        int current = 0;
+        for (int side = 1; side < 3 && count > 0; ++side)
+        {
+            const Vec3& tangent = reference.axes[(axis + side) % 3];
+            const Scalar center = dot(reference.center, tangent), h = component(reference.half, (axis + side) % 3);
+            count = clip(buffers[current], count, tangent, center + h, buffers[1 - current]);
+            current = 1 - current;
+            count = clip(buffers[current], count, -tangent, h - center, buffers[1 - current]);
+            current = 1 - current;
+        }
+        const Scalar offset = dot(reference.center, normal) + component(reference.half, axis);
+        addBelow(buffers[current], count, normal, offset, reference.axes[(axis + 1) % 3], reference.axes[(axis + 2) % 3], m);
+    }
+
+    /// The box edge along `axis` furthest along `direction`.
+    void supportEdge( const Box& box, int axis, const Vec3& direction, Vec3& from, Vec3& to )
+    {
+        Vec3 c = box.center;
+        for (int k = 0; k < 3; ++k)
+        {
+            if (k == axis)
+                continue;
+            const Scalar h = component(box.half, k);
+            c += box.axes[k] * (dot(direction, box.axes[k]).raw >= 0 ? h : -h);
+        }
+        const Vec3 along = box.axes[axis] * component(box.half, axis);
+        from = c - along;
+        to = c + along;
+    }
+
+    Vec3 supportPoint( const Box& box, const Vec3& direction )
+    {
+        Vec3 p = box.center;
+        for (int k = 0; k < 3; ++k)
+        {
+            const Scalar h = component(box.half, k);
+            p += box.axes[k] * (dot(direction, box.axes[k]).raw >= 0 ? h : -h);
+        }
+        return (p);
+    }
+
+    /// Midpoint of the closest points of [p1, q1] and [p2, q2] (Ericson
+    /// 5.1.9). Every ratio checks its denominator.
+    Vec3 closestBetweenSegments( const Vec3& p1, const Vec3& q1, const Vec3& p2, const Vec3& q2 )
+    {
+        const Scalar zero, one = Scalar::fromInt(1);
+        const Vec3 d1 = q1 - p1, d2 = q2 - p2, r = p1 - p2;
+        const Scalar a = lengthSquared(d1), e = lengthSquared(d2), f = dot(d2, r);
+        Scalar s, t;
+        if (a.raw == 0)
+            t = e.raw == 0 ? zero : clamp(f / e, zero, one);
+        else
+        {
+            const Scalar c = dot(d1, r);
+            if (e.raw == 0)
+                s = clamp(-c / a, zero, one);
+            else
+            {
+                const Scalar b = dot(d1, d2), denominator = a * e - b * b;
+                s = denominator.raw > 0 ? clamp((b * f - c * e) / denominator, zero, one) : zero;
+                t = (b * s + f) / e;
+                if (t.raw < 0)
+                {
+                    t = zero;
+                    s = clamp(-c / a, zero, one);
+                }
+                else if (t > one)
+                {
+                    t = one;
+                    s = clamp((b - c) / a, zero, one);
+                }
+            }
+        }
+        return ((p1 + d1 * s + p2 + d2 * t) * Scalar::fromRatio(1, 2));
+    }
+
+    /// Half the box's extent along `axis`, times the axis's length.
+    Scalar radiusAlong( const Box& box, const Vec3& axis )
+    {
+        return (box.half.x * abs(dot(axis, box.axes[0])) + box.half.y * abs(dot(axis, box.axes[1])) + box.half.z * abs(dot(axis, box.axes[2])));
+    }
+
+    Vec3 toLocal( const Box& box, const Vec3& p )
+    {
+        const Vec3 d = p - box.center;
+        return (Vec3{ dot(d, box.axes[0]), dot(d, box.axes[1]), dot(d, box.axes[2]) });
+    }
+
+    Vec3 toWorld( const Box& box, const Vec3& v )
+    {
+        return (box.axes[0] * v.x + box.axes[1] * v.y + box.axes[2] * v.z);
+    }
+
+    /// Separating-axis search against a box: each axis either separates the
+    /// shapes or says how far they overlap along it. The shallowest face axis
+    /// and the shallowest edge cross are kept apart, and an edge wins only
+    /// when clearly shallower, so flat contacts stay face contacts.
+    struct AxisSearch
+    {
+        Scalar      faceDepth, edgeDepth;
+        Vec3        faceNormal, edgeNormal;     // from the box to the other shape
+        int         face = -1, edge = -1;
+
+        /// `r` is the box's radius along `axis`; `lo` and `hi` bound the other
+        /// shape, relative to the box's centre. False when the axis separates.
+        bool        test( const Vec3& axis, Scalar r, Scalar lo, Scalar hi, int feature, bool isEdge )
+        {
+            if (lo > r || hi < -r)
+                return (false);
+            const Scalar length = sqrt(lengthSquared(axis));
+            if (length.raw == 0)
+                return (true);
+            // Other shape on the + side: the box leaves along -axis, and the other way.
+            const Scalar towards = (r - lo) / length, away = (hi + r) / length;
+            const Scalar depth = min(towards, away);
+            Scalar& best = isEdge ? edgeDepth : faceDepth;
+            int& bestFeature = isEdge ? edge : face;
+            if (bestFeature < 0 || depth < best)
+            {
+                best = depth;
+                bestFeature = feature;
+                (isEdge ? edgeNormal : faceNormal) = divide(towards <= away ? axis : -axis, length);
+            }
+            return (true);
+        }
+
+        bool        edgeWins() const        { return (edge >= 0 && edgeDepth + kEdgeBias < faceDepth); }
+    };
+
+    /// Oriented boxes: both boxes' faces and the nine crosses of their axes
+    /// (Gottschalk's OBB test), then a clipped face or an edge-edge point.
+    bool boxBox( const Box& a, const Box& b, Manifold& m )
+    {
+        const Vec3 d = b.center - a.center;
+        AxisSearch search;
+        auto test = [&]( const Vec3& axis, int feature, bool isEdge )
+        {
+            const Scalar center = dot(axis, d), r = radiusAlong(b, axis);
+            return (search.test(axis, radiusAlong(a, axis), center - r, center + r, feature, isEdge));
+        };
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            if (!test(a.axes[axis], axis, false) || !test(b.axes[axis], 3 + axis, false))
+                return (false);
+        }
+        for (int i = 0; i < 3; ++i)
+        {
+            for (int j = 0; j < 3; ++j)
+            {
+                const Vec3 l = cross(a.axes[i], b.axes[j]);
+                if (lengthSquared(l).raw * kParallelRatio < lengthSquared(b.axes[j]).raw)
+                    continue;
+                if (!test(l, 3 * i + j, true))
+                    return (false);
+            }
+        }
+
+        if (search.edgeWins())
+        {
+            m.normal = search.edgeNormal;
+            Vec3 fromA, toA, fromB, toB;
+            supportEdge(a, search.edge / 3, m.normal, fromA, toA);
+            supportEdge(b, search.edge % 3, -m.normal, fromB, toB);
+            m.add(closestBetweenSegments(fromA, toA, fromB, toB), search.edgeDepth);
+            return (true);
+        }
+        m.normal = search.faceNormal;
+        Vec3 quad[4];
+        if (search.face < 3)
+        {
+            incidentFace(b, m.normal, quad);
+            clipToFace(a, search.face, m.normal, quad, 4, m);
+        }
+        else
+        {
+            incidentFace(a, -m.normal, quad);
+            clipToFace(b, search.face - 3, -m.normal, quad, 4, m);
+        }
+        // Rounding clipped every point away: a's deepest corner.
+        if (m.count == 0)
+            m.add(supportPoint(a, m.normal) - m.normal * (search.faceDepth * Scalar::fromRatio(1, 2)), search.faceDepth);
+        return (true);
+    }
+
+    /// Separating axes of an oriented box and a triangle (Akenine-Moller):
+    /// the box's faces, the triangle's plane, and the nine edge crosses.
+    bool boxTriangle( const Box& box, const Triangle& t, Manifold& m )
+    {
+        const Vec3 corners[3] = { t.a, t.b, t.c };
+        const Vec3 v[3] = { t.a - box.center, t.b - box.center, t.c - box.center };
+        const Vec3 edges[3] = { v[1] - v[0], v[2] - v[1], v[0] - v[2] };
+        const Vec3 n = cross(edges[0], edges[1]);
+        AxisSearch search;
+        auto test = [&]( const Vec3& axis, int feature, bool isEdge )
+        {
+            const Scalar p0 = dot(axis, v[0]), p1 = dot(axis, v[1]), p2 = dot(axis, v[2]);
+            return (search.test(axis, radiusAlong(box, axis), min(p0, min(p1, p2)), max(p0, max(p1, p2)), feature, isEdge));
+        };
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            if (!test(box.axes[axis], axis, false))
+                return (false);
+        }
+        if (!test(n, 3, false))
+            return (false);
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                const Vec3 l = cross(box.axes[axis], edges[k]);
+                if (lengthSquared(l).raw * kParallelRatio < lengthSquared(edges[k]).raw)
+                    continue;
+                if (!test(l, 3 * axis + k, true))
+                    return (false);
+            }
+        }
+        if (search.edgeWins())
+        {
+            m.normal = search.edgeNormal;
+            Vec3 from, to;
+            supportEdge(box, search.edge / 3, m.normal, from, to);
+            const int k = search.edge % 3;
+            m.add(closestBetweenSegments(from, to, corners[k], corners[(k + 1) % 3]), search.edgeDepth);
+            return (true);
+        }
+        m.normal = search.faceNormal;
+        if (search.face < 3)
+            clipToFace(box, search.face, m.normal, corners, 3, m);
+        else
+        {
+            // The triangle is the reference: clip the box's face to the
+            // planes through its edges, facing out.
+            Vec3 buffers[2][kMaxClipped];
+            incidentFace(box, -m.normal, buffers[0]);
+            int count = 4, current = 0;
+            for (int k = 0; k < 3 && count > 0; ++k)
+            {
+                const Vec3 side = cross(edges[k], n);
+                count = clip(buffers[current], count, side, dot(corners[k], side), buffers[1 - current]);
+                current = 1 - current;
+            }
+            Vec3 tangent[2];
+            tangentBasis(m.normal, tangent);
+            addBelow(buffers[current], count, -m.normal, dot(t.a, -m.normal), tangent[0], tangent[1], m);
+        }
+        if (m.count == 0)
+            m.add(supportPoint(box, m.normal) - m.normal * (search.faceDepth * Scalar::fromRatio(1, 2)), search.faceDepth);
+        return (true);
+    }
+
+    /// The world-space inverse inertia times v: R diag(i) R^T v, one axis at
+    /// a time.
+    inline Vec3 inverseInertiaTimes( const Vec3 axes[3], const Vec3& inverseInertia, const Vec3& v )
+    {
+        return (axes[0] * (inverseInertia.x * dot(axes[0], v)) + axes[1] * (inverseInertia.y * dot(axes[1], v)) + axes[2] * (inverseInertia.z * dot(axes[2], v)));
+    }
+
+    inline void hashValue( uint64_t& hash, int64_t value )
+    {
+        for (int byte = 0; byte < 8; ++byte)
+        {
+            hash ^= (uint64_t)(value >> (8 * byte)) & 0xff;
+            hash *= 0x100000001b3ull;
+        }
+    }
+}
+
+#pragma mark - World
+
+World::World( const WorldConfig& config )
+: _config( config )
+, _proxiesSorted( true )
+{
+}
+
+BodyId World::addBody( const BodyDesc& desc )
+{
+    const BodyId body = (BodyId)_bodies.size();
+    Body b = {};
+    b.position = desc.position;
+    b.velocity = desc.velocity;
+    b.orientation = fixed_point::normalize(desc.orientation);
+    b.angularVelocity = desc.angularVelocity;
+    b.halfExtents = desc.halfExtents;
+    b.inverseMass = desc.inverseMass;
+    b.restitution = desc.restitution;
+    b.friction = desc.friction;
+    b.shape = desc.shape;
+    // Solid sphere and box: I = 2/5 m r^2, and m (b^2 + c^2) / 3 per axis.
+    // No area across an axis, or no mass, and the body does not turn.
+    if (desc.inverseMass.raw > 0)
+    {
+        const Vec3& h = desc.halfExtents;
+        auto inverse = [&]( Scalar factor, Scalar squared )
+        {
+            return (squared.raw > 0 ? factor * desc.inverseMass / squared : Scalar());
+        };
+        if (desc.shape == Shape::Sphere)
+        {
+            const Scalar i = inverse(Scalar::fromRatio(5, 2), h.x * h.x);
+            b.inverseInertia = Vec3{ i, i, i };
+        }
+        else
+        {
+            const Scalar three = Scalar::fromInt(3);
+            b.inverseInertia = Vec3{ inverse(three, h.y * h.y + h.z * h.z), inverse(three, h.x * h.x + h.z * h.z), inverse(three, h.x * h.x + h.y * h.y) };
+        }
+    }
+    fixed_point::rotationAxes(b.orientation, b.axes);
+    _bodies.push_back(b);
+    _proxies.push_back({ Vec3{}, Vec3{}, body });
+    _proxiesSorted = false;
+    return (body);
+}
+
+size_t World::addTriangles( const Triangle* pTriangles, size_t count )
+{
+    const size_t first = _triangles.size();
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Triangle& t = pTriangles[i];
+        // No normal to push along, and nothing to land on.
+        if (isZero(cross(t.b - t.a, t.c - t.a)))
+            continue;
+        const uint32_t id = (uint32_t)_triangles.size() | kTriangleBit;
+        _triangles.push_back(t);
+        _proxies.push_back({ min(t.a, min(t.b, t.c)), max(t.a, max(t.b, t.c)), id });
+    }
+    _proxiesSorted = false;
+    return (_triangles.size() - first);
+}
+
+uint64_t World::stateHash() const
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (const Body& body : _bodies)
+    {
+        hashValue(hash, body.position.x.raw);
+        hashValue(hash, body.position.y.raw);
+        hashValue(hash, body.position.z.raw);
+        hashValue(hash, body.orientation.x.raw);
+        hashValue(hash, body.orientation.y.raw);
+        hashValue(hash, body.orientation.z.raw);
+        hashValue(hash, body.orientation.w.raw);
+        hashValue(hash, body.velocity.x.raw);
+        hashValue(hash, body.velocity.y.raw);
+        hashValue(hash, body.velocity.z.raw);
+        hashValue(hash, body.angularVelocity.x.raw);
+        hashValue(hash, body.angularVelocity.y.raw);
+        hashValue(hash, body.angularVelocity.z.raw);
+    }
+    return (hash);
+}
+
+#pragma mark - Step
+
+void World::step()
+{
+    step(parallel::defaultPool());
+}
+
+void World::step( parallel::ThreadPool& pool )
+{
+    const Scalar dt = _config.timeStep;
+    const Vec3 gravityStep = _config.gravity * dt;
+    for (Body& body : _bodies)
+    {
+        fixed_point::rotationAxes(body.orientation, body.axes);
+        if (body.inverseMass.raw == 0)
+            continue;
+        body.velocity += gravityStep;
+        if (_config.planar)
+        {
+            body.velocity.z = Scalar();
+            body.angularVelocity.x = body.angularVelocity.y = Scalar();
+        }
+    }
+
+    updateProxies();
+    findPairs(pool);
+    findContacts(pool);
+    solve();
+
+    const Scalar halfStep = dt * Scalar::fromRatio(1, 2);
+    for (Body& body : _bodies)
+    {
+        if (body.inverseMass.raw == 0)
+            continue;
+        if (_config.planar)
+        {
+            body.velocity.z = Scalar();
+            body.angularVelocity.x = body.angularVelocity.y = Scalar();
+        }
+        body.position += body.velocity * dt;
+        // dq/dt = (w, 0) q / 2, renormalised so rounding does not pile up.
+        const Vec3& w = body.angularVelocity;
+        const Quat spin = Quat{ w.x, w.y, w.z, Scalar() } * body.orientation;
+        body.orientation = fixed_point::normalize(body.orientation + spin * halfStep);
+    }
+}
+
+void World::updateProxies()
+{
+    for (Proxy& proxy : _proxies)
+    {
+        if (proxy.id & kTriangleBit)
+            continue;
+        const Body& body = _bodies[proxy.id];
+        const Scalar r = body.halfExtents.x;
+        // A turned box's bounds: each axis's reach, summed.
+        const Vec3 half = body.shape == Shape::Sphere ? Vec3{ r, r, r }
+                        : abs(body.axes[0]) * body.halfExtents.x + abs(body.axes[1]) * body.halfExtents.y + abs(body.axes[2]) * body.halfExtents.z;
+        proxy.lo = body.position - half;
+        proxy.hi = body.position + half;
+    }
+
+    // Bodies move little per step, so last step's order is nearly sorted.
+    auto before = []( const Proxy& a, const Proxy& b )
+    {
+        return (a.lo.x < b.lo.x || (a.lo.x == b.lo.x && a.id < b.id));
+    };
+    if (!_proxiesSorted)
+    {
+        std::sort(_proxies.begin(), _proxies.end(), before);
+        _proxiesSorted = true;
+        return;
+    }
+    for (size_t i = 1; i < _proxies.size(); ++i)
+    {
+        const Proxy proxy = _proxies[i];
+        size_t j = i;
+        for (; j > 0 && before(proxy, _proxies[j - 1]); --j)
+            _proxies[j] = _proxies[j - 1];
+        _proxies[j] = proxy;
+    }
+}
+
+void World::findPairs( parallel::ThreadPool& pool )
+{
+    const size_t count = _proxies.size();
+    const size_t chunkCount = (count + kSweepChunk - 1) / kSweepChunk;
+    std::vector<std::vector<Pair>> chunkPairs(chunkCount);
+
+    auto isStatic = [&]( uint32_t id )
+    {
+        return ((id & kTriangleBit) || _bodies[id].inverseMass.raw == 0);
+    };
+    pool.forRange(chunkCount, 1, [&]( size_t begin, size_t end )
+    {
+        for (size_t chunk = begin; chunk < end; ++chunk)
+        {
+            std::vector<Pair>& pairs = chunkPairs[chunk];
+            const size_t last = std::min(count, (chunk + 1) * kSweepChunk);
+            for (size_t i = chunk * kSweepChunk; i < last; ++i)
+            {
+                const Proxy& p = _proxies[i];
+                for (size_t j = i + 1; j < count && _proxies[j].lo.x <= p.hi.x; ++j)
+                {
+                    const Proxy& q = _proxies[j];
+                    if (p.lo.y > q.hi.y || q.lo.y > p.hi.y || p.lo.z > q.hi.z || q.lo.z > p.hi.z)
+                        continue;
+                    if (isStatic(p.id) && isStatic(q.id))
+                        continue;
+                    // A body first; a triangle is always b.
+                    const bool swap = (p.id & kTriangleBit) || (!(q.id & kTriangleBit) && q.id < p.id);
+                    pairs.push_back(swap ? Pair{ q.id, p.id } : Pair{ p.id, q.id });
+                }
+            }
+        }
+    });
+
+    _pairs.clear();
+    for (const std::vector<Pair>& pairs : chunkPairs)
+        _pairs.insert(_pairs.end(), pairs.begin(), pairs.end());
+    _stats.pairs = (uint32_t)_pairs.size();
+}
+
+void World::collide( const Pair& pair, std::vector<Contact>& contacts ) const
+{
+    const Body& a = _bodies[pair.a];
+    const Body* pB = (pair.b & kTriangleBit) ? nullptr : &_bodies[pair.b];
+    auto boxOf = []( const Body& body )
+    {
+        return (Box{ body.position, { body.axes[0], body.axes[1], body.axes[2] }, body.halfExtents });
+    };
+    const Scalar half = Scalar::fromRatio(1, 2);
+    Manifold m;
+    Vec3 normal, point;
+    Scalar depth;
+    bool touching;
+    Scalar friction = a.friction, restitution = a.restitution;
+    if (!pB)
+    {
+        const Triangle& t = _triangles[pair.b & ~kTriangleBit];
+        if (a.shape == Shape::Sphere)
+        {
+            const Vec3 n = cross(t.b - t.a, t.c - t.a);
+            const Scalar nLength = length(n);
+            const Vec3 below = nLength.raw > 0 ? -divide(n, nLength) : unitAxis(1, Scalar::fromInt(-1));
+            // The point on the normal through the centre, not the closest
+            // point: rounding in that must not turn the normal impulse into a spin.
+            touching = separateFromPoint(a.position, a.halfExtents.x, closestOnTriangle(a.position, t), below, m.normal, depth);
+            if (touching)
+                m.add(a.position + m.normal * (a.halfExtents.x - depth * half), depth);
+        }
+        else
+            touching = boxTriangle(boxOf(a), t, m);
+    }
+    else
+    {
+        const Body& b = *pB;
+        if (a.shape == Shape::Sphere && b.shape == Shape::Sphere)
+        {
+            touching = separateFromPoint(a.position, a.halfExtents.x + b.halfExtents.x, b.position, unitAxis(1, Scalar::fromInt(1)), m.normal, depth);
+            if (touching)
+                m.add(a.position + m.normal * (a.halfExtents.x - depth * half), depth);
+        }
+        else if (a.shape == Shape::Sphere || b.shape == Shape::Sphere)
+        {
+            // In the box's frame, then back; the normal still runs from a to b.
+            const Body& sphere = a.shape == Shape::Sphere ? a : b;
+            const Box box = boxOf(a.shape == Shape::Sphere ? b : a);
+            touching = sphereBox(toLocal(box, sphere.position), sphere.halfExtents.x, box.half, normal, depth, point);
+            if (touching)
+            {
+                m.normal = a.shape == Shape::Sphere ? toWorld(box, normal) : -toWorld(box, normal);
+                m.add(box.center + toWorld(box, point), depth);
+            }
+        }
+        else
+            touching = boxBox(boxOf(a), boxOf(b), m);
+        friction = (a.friction + b.friction) * half;
+        restitution = max(a.restitution, b.restitution);
+    }
+    if (!touching)
+        return;
+
+    Vec3 tangent[2];
+    tangentBasis(m.normal, tangent);
+    for (int i = 0; i < m.count; ++i)
+    {
+        Contact contact = {};
+        contact.a = pair.a;
+        contact.b = pair.b;
+        contact.axes[0] = m.normal;
+        contact.axes[1] = tangent[0];
+        contact.axes[2] = tangent[1];
+        const Vec3 armA = m.points[i] - a.position;
+        const Vec3 armB = pB ? m.points[i] - pB->position : Vec3{};
+        // The effective mass along each axis: 1 / (both inverse masses, plus
+        // what the lever arms turn). Divided once here, not per iteration.
+        bool solvable = true;
+        for (int k = 0; k < 3; ++k)
+        {
+            contact.turnA[k] = cross(armA, contact.axes[k]);
+            contact.spinA[k] = inverseInertiaTimes(a.axes, a.inverseInertia, contact.turnA[k]);
+            Scalar inverseMass = a.inverseMass + dot(contact.turnA[k], contact.spinA[k]);
+            if (pB)
+            {
+                contact.turnB[k] = cross(armB, contact.axes[k]);
+                contact.spinB[k] = inverseInertiaTimes(pB->axes, pB->inverseInertia, contact.turnB[k]);
+                inverseMass += pB->inverseMass + dot(contact.turnB[k], contact.spinB[k]);
+            }
+            solvable = solvable && inverseMass.raw > 0;
+            if (solvable)
+                contact.mass[k] = Scalar::fromInt(1) / inverseMass;
+        }
+        if (!solvable)
+            continue;
+        contact.depth = m.depths[i];
+        contact.friction = friction;
+
+        // Bounce off fast approaches, push apart what overlaps beyond the slop.
+        Vec3 relative = -(a.velocity + cross(a.angularVelocity, armA));
+        if (pB)
+            relative += pB->velocity + cross(pB->angularVelocity, armB);
+        const Scalar approach = dot(relative, m.normal);
+        const Scalar bounce = approach < -kBounceThreshold ? -(restitution * approach) : Scalar();
+        const Scalar push = _config.correction * max(contact.depth - _config.slop, Scalar()) / _config.timeStep;
+        contact.target = max(bounce, push);
+        contacts.push_back(contact);
+    }
+}
+
+void World::findContacts( parallel::ThreadPool& pool )
+{
+    const size_t count = _pairs.size();
+    const size_t chunkCount = (count + kContactChunk - 1) / kContactChunk;
+    std::vector<std::vector<Contact>> chunkContacts(chunkCount);
+    pool.forRange(chunkCount, 1, [&]( size_t begin, size_t end )
+    {
+        for (size_t chunk = begin; chunk < end; ++chunk)
+        {
+            const size_t last = std::min(count, (chunk + 1) * kContactChunk);
+            for (size_t i = chunk * kContactChunk; i < last; ++i)
+                collide(_pairs[i], chunkContacts[chunk]);
+        }
+    });
+
+    _contacts.clear();
+    for (const std::vector<Contact>& contacts : chunkContacts)
+        _contacts.insert(_contacts.end(), contacts.begin(), contacts.end());
+    _stats.contacts = (uint32_t)_contacts.size();
+}
+
+void World::solve()
+{
+    for (uint32_t iteration = 0; iteration < _config.iterations; ++iteration)
+    {
+        for (Contact& c : _contacts)
+        {
+            Body& a = _bodies[c.a];
+            Body* pB = (c.b & kTriangleBit) ? nullptr : &_bodies[c.b];
+
+            // Speed of b's point against a's at the contact, along axis k:
+            // (w x r) . d is w . (r x d).
+            auto speed = [&]( int k )
+            {
+                Scalar s = -(dot(a.velocity, c.axes[k]) + dot(a.angularVelocity, c.turnA[k]));
+                if (pB)
+                    s += dot(pB->velocity, c.axes[k]) + dot(pB->angularVelocity, c.turnB[k]);
+                return (s);
+            };
+            auto apply = [&]( int k, Scalar total )
+            {
+                const Scalar impulse = total - c.impulse[k];
+                c.impulse[k] = total;
+                a.velocity -= c.axes[k] * (impulse * a.inverseMass);
+                a.angularVelocity -= c.spinA[k] * impulse;
+                if (pB)
+                {
+                    pB->velocity += c.axes[k] * (impulse * pB->inverseMass);
+                    pB->angularVelocity += c.spinB[k] * impulse;
+                }
+            };
+
+            apply(0, max(c.impulse[0] + (c.target - speed(0)) * c.mass[0], Scalar()));
+            const Scalar limit = c.friction * c.impulse[0];
+            for (int k = 1; k < 3; ++k)
+                apply(k, clamp(c.impulse[k] - speed(k) * c.mass[k], -limit, limit));
+        }
+    }
+}
+
+}
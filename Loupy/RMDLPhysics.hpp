@@ -0,0 +1,178 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLPhysics.hpp              +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 07:58:41      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLPHYSICS_HPP
+# define RMDLPHYSICS_HPP
+
+# include <cstddef>
+# include <cstdint>
+# include <vector>
+
+# include "RMDLFixedPoint.hpp"
+
+// Deterministic rigid bodies for lockstep simulation: every value is 48.16
+// fixed point, so the same inputs give the same bits on every machine and at
+// every thread count. A step integrates gravity, finds pairs by sort and
+// sweep along x, builds up to four contact points per touching pair
+// (spheres, oriented boxes, static triangles), then runs a sequential-impulse
+// solver over the points in pair order. Impulses act at the contact points,
+// so they turn bodies as well as push them.
+// The parallel parts (sweep, narrow phase) split their work in chunks that
+// do not depend on the pool and write the results back in order.
+
+namespace parallel
+{
+    class ThreadPool;
+}
+
+namespace physics
+{
+    using fixed_point::Quat;
+    using fixed_point::Scalar;
+    using fixed_point::Vec3;
+
+    typedef uint32_t BodyId;
+
+    enum class Shape : uint8_t
+    {
+        Sphere,
+        Box,
+    };
+
+    struct BodyDesc
+    {
+        Shape       shape           = Shape::Sphere;
+        Vec3        position;
+        Vec3        velocity;
+        Quat        orientation;
+        Vec3        angularVelocity;                                // world space, radians per second
+        Vec3        halfExtents     = { Scalar::fromRatio(1, 2), Scalar::fromRatio(1, 2), Scalar::fromRatio(1, 2) };   // a sphere's radius is x
+        Scalar      inverseMass     = Scalar::fromInt(1);           // 0 never moves
+        Scalar      restitution     = Scalar::fromInt(0);
+        Scalar      friction        = Scalar::fromRatio(1, 2);
+    };
+
+    /// Static; collides on both sides.
+    struct Triangle
+    {
+        Vec3        a, b, c;
+    };
+
+    struct WorldConfig
+    {
+        Vec3        gravity         = { Scalar(), Scalar::fromRatio(-981, 100), Scalar() };
+        Scalar      timeStep        = Scalar::fromRatio(1, 60);
+        uint32_t    iterations      = 8;
+        /// Fraction of the penetration beyond `slop` pushed out per step.
+        Scalar      correction      = Scalar::fromRatio(1, 5);
+        Scalar      slop            = Scalar::fromRatio(1, 100);
+        /// 2D: z velocities stay 0, so bodies keep their z, and bodies turn
+        /// only around z.
+        bool        planar          = false;
+    };
+
+    struct StepStats
+    {
+        uint32_t    pairs       = 0;
+        uint32_t    contacts    = 0;
+    };
+
+    class World
+    {
+    public:
+        explicit World( const WorldConfig& config = WorldConfig() );
+
+        BodyId          addBody( const BodyDesc& desc );
+        /// Skips triangles with no area at fixed-point resolution; returns how
+        /// many it kept.
+        size_t          addTriangles( const Triangle* pTriangles, size_t count );
+
+        void            step();
+        void            step( parallel::ThreadPool& pool );
+
+        /// FNV-1a over every body's position, orientation and velocity bits,
+        /// for checking that peers (or replays) are still in step.
+        uint64_t        stateHash() const;
+
+        size_t          bodyCount() const                   { return (_bodies.size()); }
+        const Vec3&     position( BodyId body ) const       { return (_bodies[body].position); }
+        const Vec3&     velocity( BodyId body ) const       { return (_bodies[body].velocity); }
+        void            setVelocity( BodyId body, const Vec3& velocity ) { _bodies[body].velocity = velocity; }
+        const Quat&     orientation( BodyId body ) const    { return (_bodies[body].orientation); }
+        const Vec3&     angularVelocity( BodyId body ) const { return (_bodies[body].angularVelocity); }
+        void            setAngularVelocity( BodyId body, const Vec3& angularVelocity ) { _bodies[body].angularVelocity = angularVelocity; }
+        const StepStats&    stats() const                   { return (_stats); }
+
+    private:
+        struct Body
+        {
+            Vec3        position;
+            Vec3        velocity;
+            Quat        orientation;
+            Vec3        angularVelocity;
+            Vec3        halfExtents;
+            Vec3        inverseInertia;     // about the body's own axes
+            Vec3        axes[3];            // of the orientation, refreshed each step
+            Scalar      inverseMass;
+            Scalar      restitution;
+            Scalar      friction;
+            Shape       shape;
+        };
+
+        /// A body, or a triangle with kTriangleBit set, with its bounds.
+        struct Proxy
+        {
+            Vec3        lo;
+            Vec3        hi;
+            uint32_t    id;
+        };
+
+        struct Pair
+        {
+            uint32_t    a;
+            uint32_t    b;
+        };
+
+        /// One point of a manifold. The lever-arm terms are fixed for the
+        /// step, so the solver only scales them.
+        struct Contact
+        {
+            uint32_t    a;
+            uint32_t    b;                  // body, or triangle with kTriangleBit
+            Vec3        axes[3];            // the normal, from a to b, then two tangents
+            Vec3        turnA[3];           // a's lever arm crossed with each axis
+            Vec3        turnB[3];           // and b's; 0 for a triangle
+            Vec3        spinA[3];           // turnA through a's inverse inertia
+            Vec3        spinB[3];
+            Scalar      mass[3];            // effective, of an impulse along each axis at the point
+            Scalar      impulse[3];
+            Scalar      depth;
+            Scalar      target;             // normal speed the solver aims for
+            Scalar      friction;
+        };
+
+        void            updateProxies();
+        void            findPairs( parallel::ThreadPool& pool );
+        void            findContacts( parallel::ThreadPool& pool );
+        void            collide( const Pair& pair, std::vector<Contact>& contacts ) const;
+        void            solve();
+
+        WorldConfig             _config;
+        std::vector<Body>       _bodies;
+        std::vector<Triangle>   _triangles;
+        std::vector<Proxy>      _proxies;       // sorted by lo.x, then id
+        bool                    _proxiesSorted;
+        std::vector<Pair>       _pairs;
+        std::vector<Contact>    _contacts;
+        StepStats               _stats;
+    };
+}
+
+#endif /* RMDLPHYSICS_HPP */
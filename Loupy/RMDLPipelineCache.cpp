@@ -0,0 +1,406 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLPipelineCache.cpp        +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 19:12:11      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLPipelineCache.hpp"
+#include "RMDLParallel.hpp"
+#include "RMDLShaderCache.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+
+namespace pipeline_cache
+{
+
+struct PipelineRef::Entry
+{
+    uint64_t                key;
+    PipelineDesc            desc;
+    std::atomic<void*>      pPipeline       { nullptr };
+    std::atomic<uint32_t>   state           { (uint32_t)PipelineState::Pending };
+    std::atomic<const Entry*> pPlaceholder  { nullptr };    // has no placeholder itself, see setPlaceholder()
+    mutable uint32_t        dependents      = 0;        // entries using this one as placeholder
+    bool                    queued          = false;    // in _immediate and/or _background, not claimed yet
+    bool                    background      = false;
+};
+
+#pragma mark - Canonical form
+
+namespace
+{
+    constexpr uint32_t kCanonicalVersion = 1;
+
+    void put32( std::vector<uint8_t>& out, uint32_t value )
+    {
+        const uint8_t bytes[4] = { (uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24) };
+        out.insert(out.end(), bytes, bytes + 4);
+    }
+
+    void putString( std::vector<uint8_t>& out, const std::string& str )
+    {
+        put32(out, (uint32_t)str.size());
+        out.insert(out.end(), str.begin(), str.end());
+    }
+
+    struct Reader
+    {
+        const uint8_t*  p;
+        const uint8_t*  end;
+
+        bool get32( uint32_t& value )
+        {
+            if (end - p < 4)
+                return (false);
+            value = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+            p += 4;
+            return (true);
+        }
+
+        bool getString( std::string& str )
+        {
+            uint32_t length;
+            if (!get32(length) || (size_t)(end - p) < length)
+                return (false);
+            str.assign((const char *)p, length);
+            p += length;
+            return (true);
+        }
+    };
+}
+
+std::vector<uint8_t> canonicalBytes( const PipelineDesc& desc )
+{
+    // Unused stages and attachments are zeroed so they cannot split keys.
+    const bool render = desc.kind == PipelineKind::Render;
+    std::vector<uint8_t> out;
+    out.reserve(96 + desc.vertexFunction.size() + desc.fragmentFunction.size() + desc.computeFunction.size());
+    put32(out, kCanonicalVersion);
+    put32(out, (uint32_t)desc.kind);
+    putString(out, render ? desc.vertexFunction : std::string());
+    putString(out, render ? desc.fragmentFunction : std::string());
+    putString(out, render ? std::string() : desc.computeFunction);
+    for (uint32_t i = 0; i < kMaxColorAttachments; ++i)
+    {
+        const bool used = render && desc.colorFormats[i] != 0;
+        put32(out, used ? desc.colorFormats[i] : 0);
+        put32(out, used ? (uint32_t)desc.blend[i] : 0);
+    }
+    put32(out, render ? desc.depthFormat : 0);
+    put32(out, render ? desc.sampleCount : 0);
+    put32(out, !render && desc.threadGroupSizeIsMultipleOfExecutionWidth ? 1 : 0);
+    return (out);
+}
+
+bool parseCanonicalBytes( const uint8_t* data, size_t size, PipelineDesc& desc )
+{
+    Reader in{ data, data + size };
+    uint32_t version, kind, flag;
+    PipelineDesc parsed;
+    if (!in.get32(version) || version != kCanonicalVersion || !in.get32(kind) || kind > (uint32_t)PipelineKind::Compute)
+        return (false);
+    parsed.kind = (PipelineKind)kind;
+    if (!in.getString(parsed.vertexFunction) || !in.getString(parsed.fragmentFunction) || !in.getString(parsed.computeFunction))
+        return (false);
+    for (uint32_t i = 0; i < kMaxColorAttachments; ++i)
+    {
+        uint32_t blend;
+        if (!in.get32(parsed.colorFormats[i]) || !in.get32(blend) || blend > (uint32_t)BlendMode::Premultiplied)
+            return (false);
+        parsed.blend[i] = (BlendMode)blend;
+    }
+    if (!in.get32(parsed.depthFormat) || !in.get32(parsed.sampleCount) || !in.get32(flag) || in.p != in.end)
+        return (false);
+    parsed.threadGroupSizeIsMultipleOfExecutionWidth = flag != 0;
+    desc = std::move(parsed);
+    return (true);
+}
+
+uint64_t pipelineKey( const PipelineDesc& desc )
+{
+    const std::vector<uint8_t> bytes = canonicalBytes(desc);
+    return (shader_cache::hashBytes(bytes.data(), bytes.size()));
+}
+
+#pragma mark - PipelineRef
+
+void* PipelineRef::get() const
+{
+    if (!_pEntry)
+        return (nullptr);
+    if (void* pPipeline = _pEntry->pPipeline.load(std::memory_order_acquire))
+        return (pPipeline);
+    const Entry* pPlaceholder = _pEntry->pPlaceholder.load(std::memory_order_acquire);
+    return (pPlaceholder ? pPlaceholder->pPipeline.load(std::memory_order_acquire) : nullptr);
+}
+
+PipelineState PipelineRef::state() const
+{
+    return (_pEntry ? (PipelineState)_pEntry->state.load(std::memory_order_acquire) : PipelineState::Failed);
+}
+
+uint64_t PipelineRef::key() const
+{
+    return (_pEntry ? _pEntry->key : 0);
+}
+
+#pragma mark - PipelineManager
+
+PipelineManager::PipelineManager( PipelineCompiler& compiler )
+: PipelineManager( compiler, parallel::defaultPool() )
+{
+}
+
+PipelineManager::PipelineManager( PipelineCompiler& compiler, parallel::ThreadPool& pool )
+: _compiler( compiler )
+, _pool( pool )
+, _running( 0 )
+, _scheduled( 0 )
+, _stopping( false )
+{
+}
+
+PipelineManager::~PipelineManager()
+{
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _stopping = true;
+        _immediate.clear();
+        _background.clear();
+        _done.wait(lock, [this]() { return (_running == 0 && _scheduled == 0); });
+    }
+    for (auto& [key, pEntry] : _entries)
+    {
+        if (void* pPipeline = pEntry->pPipeline.load(std::memory_order_relaxed))
+            _compiler.release(pPipeline);
+    }
+}
+
+PipelineRef PipelineManager::request( const PipelineDesc& desc, Priority priority, PipelineRef placeholder )
+{
+    const uint64_t key = pipelineKey(desc);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    ++_stats.requested;
+    auto it = _entries.find(key);
+    if (it != _entries.end())
+    {
+        ++_stats.deduplicated;
+        PipelineRef::Entry* pEntry = it->second.get();
+        if (pEntry->queued && pEntry->background && priority == Priority::Immediate)
+        {
+            // The stale _background slot is skipped when it comes up.
+            pEntry->background = false;
+            _immediate.push_back(pEntry);
+        }
+        if (!pEntry->pPlaceholder.load(std::memory_order_relaxed))
+            setPlaceholder(pEntry, placeholder._pEntry);
+        return (PipelineRef(pEntry));
+    }
+
+    auto pEntry = std::make_unique<PipelineRef::Entry>();
+    pEntry->key = key;
+    pEntry->desc = desc;
+    setPlaceholder(pEntry.get(), placeholder._pEntry);
+    pEntry->queued = true;
+    pEntry->background = priority == Priority::Background;
+    (pEntry->background ? _background : _immediate).push_back(pEntry.get());
+    PipelineRef ref(pEntry.get());
+    _entries.emplace(key, std::move(pEntry));
+
+    ++_scheduled;
+    _pool.enqueue([this]() { runOne(); });
+    return (ref);
+}
+
+void PipelineManager::setPlaceholder( PipelineRef::Entry* pEntry, const PipelineRef::Entry* pPlaceholder )
+{
+    // Placeholders always point at an entry that has none, so get() follows one
+    // link and a chain can never loop back.
+    if (pPlaceholder)
+    {
+        if (const PipelineRef::Entry* pFinal = pPlaceholder->pPlaceholder.load(std::memory_order_relaxed))
+            pPlaceholder = pFinal;
+    }
+    if (!pPlaceholder || pPlaceholder == pEntry)
+        return;
+    pEntry->pPlaceholder.store(pPlaceholder, std::memory_order_release);
+    ++pPlaceholder->dependents;
+
+    // pEntry is not final any more: whatever pointed at it now points past it.
+    if (pEntry->dependents == 0)
+        return;
+    for (auto& [key, pOther] : _entries)
+    {
+        if (pOther->pPlaceholder.load(std::memory_order_relaxed) == pEntry)
+            pOther->pPlaceholder.store(pPlaceholder, std::memory_order_release);
+    }
+    pPlaceholder->dependents += pEntry->dependents;
+    pEntry->dependents = 0;
+}
+
+void PipelineManager::runOne()
+{
+    PipelineRef::Entry* pEntry = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        --_scheduled;
+        // One pool job per queued entry; immediate work always goes first.
+        while (!_stopping && !pEntry && (!_immediate.empty() || !_background.empty()))
+        {
+            std::deque<PipelineRef::Entry*>& queue = _immediate.empty() ? _background : _immediate;
+            PipelineRef::Entry* pFront = queue.front();
+            queue.pop_front();
+            if (pFront->queued && (&queue == &_immediate || pFront->background))
+                pEntry = pFront;
+        }
+        if (!pEntry)
+        {
+            _done.notify_all();
+            return;
+        }
+        pEntry->queued = false;
+        ++_running;
+    }
+    compileEntry(pEntry);
+}
+
+void PipelineManager::compileEntry( PipelineRef::Entry* pEntry )
+{
+    const auto start = std::chrono::steady_clock::now();
+    void* pPipeline = _compiler.compile(pEntry->desc);
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    pEntry->pPipeline.store(pPipeline, std::memory_order_release);
+    pEntry->state.store((uint32_t)(pPipeline ? PipelineState::Ready : PipelineState::Failed), std::memory_order_release);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    --_running;
+    ++(pPipeline ? _stats.compiled : _stats.failed);
+    _stats.compileMs += ms;
+    _done.notify_all();
+}
+
+void* PipelineManager::wait( PipelineRef ref )
+{
+    PipelineRef::Entry* pEntry = const_cast<PipelineRef::Entry*>(ref._pEntry);
+    if (!pEntry)
+        return (nullptr);
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (pEntry->queued)
+    {
+        // Still queued: compiling it here beats waiting behind the rest of the queue.
+        pEntry->queued = false;
+        ++_running;
+        lock.unlock();
+        compileEntry(pEntry);
+        lock.lock();
+    }
+    _done.wait(lock, [pEntry]() { return (pEntry->state.load(std::memory_order_acquire) != (uint32_t)PipelineState::Pending); });
+    return (pEntry->pPipeline.load(std::memory_order_acquire));
+}
+
+void PipelineManager::waitAll()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _done.wait(lock, [this]() { return (_running == 0 && _scheduled == 0); });
+}
+
+#pragma mark - Manifest
+
+namespace
+{
+    constexpr uint32_t kManifestVersion = 1;
+
+    struct ManifestHeader
+    {
+        char        magic[4];
+        uint32_t    version;
+        uint32_t    entryCount;
+        uint32_t    reserved;
+    };
+
+    struct ManifestRecord
+    {
+        uint32_t    canonicalSize;
+        uint32_t    labelSize;
+    };
+}
+
+bool PipelineManager::saveManifest( const std::string& path ) const
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        return (false);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    ManifestHeader header = {};
+    std::memcpy(header.magic, "RPLM", 4);
+    header.version = kManifestVersion;
+    for (const auto& [key, pEntry] : _entries)
+    {
+        if (pEntry->state.load(std::memory_order_relaxed) != (uint32_t)PipelineState::Failed)
+            ++header.entryCount;
+    }
+    out.write((const char *)&header, sizeof(header));
+
+    for (const auto& [key, pEntry] : _entries)
+    {
+        if (pEntry->state.load(std::memory_order_relaxed) == (uint32_t)PipelineState::Failed)
+            continue;
+        const std::vector<uint8_t> bytes = canonicalBytes(pEntry->desc);
+        const ManifestRecord record = { (uint32_t)bytes.size(), (uint32_t)pEntry->desc.label.size() };
+        out.write((const char *)&record, sizeof(record));
+        out.write((const char *)bytes.data(), bytes.size());
+        out.write(pEntry->desc.label.data(), pEntry->desc.label.size());
+    }
+    return ((bool)out);
+}
+
+size_t PipelineManager::prewarm( const std::string& path )
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        return (0);
+
+    ManifestHeader header;
+    if (!in.read((char *)&header, sizeof(header)) || std::memcmp(header.magic, "RPLM", 4) != 0 || header.version != kManifestVersion)
+        return (0);
+
+    size_t count = 0;
+    std::vector<uint8_t> bytes;
+    for (uint32_t i = 0; i < header.entryCount; ++i)
+    {
+        ManifestRecord record;
+        if (!in.read((char *)&record, sizeof(record)) || record.canonicalSize > 65536 || record.labelSize > 4096)
+            break;
+        bytes.resize(record.canonicalSize);
+        PipelineDesc desc;
+        desc.label.resize(record.labelSize);
+        if (!in.read((char *)bytes.data(), bytes.size()) || !in.read(desc.label.data(), desc.label.size()))
+            break;
+        std::string label = std::move(desc.label);
+        // Entries from an older canonical version are skipped, not fatal.
+        if (!parseCanonicalBytes(bytes.data(), bytes.size(), desc))
+            continue;
+        desc.label = std::move(label);
+        request(desc, Priority::Background);
+        ++count;
+    }
+    return (count);
+}
+
+PipelineStats PipelineManager::stats() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return (_stats);
+}
+
+}
@@ -0,0 +1,178 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLPipelineCache.hpp        +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 19:12:05      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLPIPELINECACHE_HPP
+# define RMDLPIPELINECACHE_HPP
+
+# include <atomic>
+# include <condition_variable>
+# include <cstdint>
+# include <deque>
+# include <memory>
+# include <mutex>
+# include <string>
+# include <unordered_map>
+# include <vector>
+
+# include "NonCopyable.h"
+
+// Pipelines compiled off the render thread. Descriptors are reduced to a
+// canonical byte string, so two requests for the same pipeline (whatever their
+// label) share one compile. Frames read a PipelineRef and draw with whatever is
+// ready -- the pipeline, its placeholder, or nothing -- instead of waiting.
+// No Metal here; RMDLPipelineCompiler does the actual compiling.
+
+namespace parallel
+{
+    class ThreadPool;
+}
+
+namespace pipeline_cache
+{
+    enum class PipelineKind : uint32_t
+    {
+        Render,
+        Compute
+    };
+
+    enum class BlendMode : uint32_t
+    {
+        Opaque,
+        Alpha,          // src * a + dst * (1 - a)
+        Premultiplied   // src + dst * (1 - a)
+    };
+
+    constexpr uint32_t kMaxColorAttachments = 4;
+
+    /// Everything that changes the compiled pipeline. Pixel formats are the raw
+    /// MTL::PixelFormat values, 0 for unused attachments.
+    struct PipelineDesc
+    {
+        PipelineKind    kind                = PipelineKind::Render;
+        std::string     label;              // not part of the key
+        std::string     vertexFunction;
+        std::string     fragmentFunction;
+        std::string     computeFunction;
+        uint32_t        colorFormats[kMaxColorAttachments] = {};
+        BlendMode       blend[kMaxColorAttachments] = {};
+        uint32_t        depthFormat         = 0;
+        uint32_t        sampleCount         = 1;
+        bool            threadGroupSizeIsMultipleOfExecutionWidth = false;
+    };
+
+    /// Fixed-order encoding of every field but the label: equal bytes, equal pipeline.
+    std::vector<uint8_t>    canonicalBytes( const PipelineDesc& desc );
+    /// Inverse of canonicalBytes (the label stays empty). False on malformed input.
+    bool                    parseCanonicalBytes( const uint8_t* data, size_t size, PipelineDesc& desc );
+    uint64_t                pipelineKey( const PipelineDesc& desc );
+
+    /// Turns a descriptor into a retained API object. Called from worker threads,
+    /// several at a time.
+    class PipelineCompiler
+    {
+    public:
+        virtual         ~PipelineCompiler() = default;
+        /// nullptr on failure.
+        virtual void*   compile( const PipelineDesc& desc ) = 0;
+        virtual void    release( void* pPipeline ) = 0;
+    };
+
+    enum class Priority : uint32_t
+    {
+        Immediate,      // wanted by a frame being recorded
+        Background      // prewarming from the manifest
+    };
+
+    enum class PipelineState : uint32_t
+    {
+        Pending,
+        Ready,
+        Failed
+    };
+
+    struct PipelineStats
+    {
+        uint32_t    requested       = 0;
+        uint32_t    deduplicated    = 0;    // requests that found their key already known
+        uint32_t    compiled        = 0;
+        uint32_t    failed          = 0;
+        double      compileMs       = 0.0;  // summed over workers
+    };
+
+    class PipelineManager;
+
+    /// Stable handle; valid as long as its manager. Reading it never blocks.
+    class PipelineRef
+    {
+    public:
+        PipelineRef() = default;
+
+        /// The pipeline once compiled, else the placeholder's, else nullptr. A placeholder
+        /// that has its own placeholder stands for that one: chains are resolved when set.
+        void*           get() const;
+        PipelineState   state() const;
+        uint64_t        key() const;
+        explicit        operator bool() const   { return (_pEntry != nullptr); }
+
+        template< typename T >
+        T*              as() const              { return (static_cast<T*>(get())); }
+
+    private:
+        friend class PipelineManager;
+        struct Entry;
+        explicit PipelineRef( const Entry* pEntry ) : _pEntry( pEntry ) {}
+
+        const Entry*    _pEntry = nullptr;
+    };
+
+    class PipelineManager : public NonCopyable
+    {
+    public:
+        explicit PipelineManager( PipelineCompiler& compiler );
+        PipelineManager( PipelineCompiler& compiler, parallel::ThreadPool& pool );
+        /// Drops queued compiles, waits for running ones and releases every pipeline.
+        ~PipelineManager();
+
+        /// Queues `desc` unless its key is already known and returns at once. Until it is
+        /// compiled the ref reads as `placeholder` (if any). An Immediate request raises
+        /// a queued Background one.
+        PipelineRef     request( const PipelineDesc& desc, Priority priority = Priority::Immediate, PipelineRef placeholder = {} );
+        /// Blocks until `ref` is Ready or Failed; for the few pipelines a start cannot do without.
+        void*           wait( PipelineRef ref );
+        void            waitAll();
+
+        /// Every descriptor requested so far, canonical bytes plus label.
+        bool            saveManifest( const std::string& path ) const;
+        /// Requests every descriptor of a manifest in the background. Returns how many.
+        size_t          prewarm( const std::string& path );
+
+        PipelineStats   stats() const;
+
+    private:
+        void            runOne();
+        void            compileEntry( PipelineRef::Entry* pEntry );
+        void            setPlaceholder( PipelineRef::Entry* pEntry, const PipelineRef::Entry* pPlaceholder );
+
+        PipelineCompiler&                                               _compiler;
+        parallel::ThreadPool&                                           _pool;
+
+        mutable std::mutex                                              _mutex;
+        std::condition_variable                                         _done;
+        std::unordered_map<uint64_t, std::unique_ptr<PipelineRef::Entry>> _entries;
+        std::deque<PipelineRef::Entry*>                                 _immediate;
+        std::deque<PipelineRef::Entry*>                                 _background;
+        uint32_t                                                        _running;
+        uint32_t                                                        _scheduled;     // pool jobs not yet started
+        bool                                                            _stopping;
+        PipelineStats                                                   _stats;
+    };
+}
+
+#endif /* RMDLPIPELINECACHE_HPP */
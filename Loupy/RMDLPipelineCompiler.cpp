@@ -0,0 +1,111 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLPipelineCompiler.cpp     +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 19:40:33      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLPipelineCompiler.hpp"
+
+#include <stdio.h>
+
+MetalPipelineCompiler::MetalPipelineCompiler( MTL::Device* pDevice, MTL::Library* pShaderLibrary )
+: _pDevice( pDevice->retain() )
+, _pShaderLibrary( pShaderLibrary->retain() )
+{
+    NS::Error* pError = nullptr;
+    NS::SharedPtr<MTL4::CompilerDescriptor> compilerDesc = NS::TransferPtr( MTL4::CompilerDescriptor::alloc()->init() );
+    _pCompiler = _pDevice->newCompiler( compilerDesc.get(), &pError );
+    if (!_pCompiler)
+    {
+        printf("Error creating pipeline compiler: %s\n", pError->localizedDescription()->utf8String());
+        assert(_pCompiler);
+    }
+}
+
+MetalPipelineCompiler::~MetalPipelineCompiler()
+{
+    _pCompiler->release();
+    _pShaderLibrary->release();
+    _pDevice->release();
+}
+
+void* MetalPipelineCompiler::compile( const pipeline_cache::PipelineDesc& desc )
+{
+    // Worker threads have no autorelease pool of their own.
+    NS::AutoreleasePool* pPool = NS::AutoreleasePool::alloc()->init();
+    NS::Error* pError = nullptr;
+    void* pPipeline = nullptr;
+    if (desc.kind == pipeline_cache::PipelineKind::Render)
+        pPipeline = newRenderPipeline( desc, &pError );
+    else
+        pPipeline = newComputePipeline( desc, &pError );
+    if (!pPipeline)
+    {
+        printf("Error building pipeline \"%s\": %s\n", desc.label.c_str(),
+               pError ? pError->localizedDescription()->utf8String() : "unknown error");
+    }
+    pPool->release();
+    return (pPipeline);
+}
+
+void MetalPipelineCompiler::release( void* pPipeline )
+{
+    // Both pipeline kinds are plain NS::Objects as far as reference counting goes.
+    static_cast<NS::Object*>(pPipeline)->release();
+}
+
+MTL::RenderPipelineState* MetalPipelineCompiler::newRenderPipeline( const pipeline_cache::PipelineDesc& desc, NS::Error** ppError )
+{
+    NS::SharedPtr<MTL4::RenderPipelineDescriptor> pRenderPipDesc = NS::TransferPtr( MTL4::RenderPipelineDescriptor::alloc()->init() );
+    pRenderPipDesc->setLabel( NS::String::string( desc.label.c_str(), NS::UTF8StringEncoding ) );
+
+    NS::SharedPtr<MTL4::LibraryFunctionDescriptor> vertexFunction = NS::TransferPtr( MTL4::LibraryFunctionDescriptor::alloc()->init() );
+    vertexFunction->setName( NS::String::string( desc.vertexFunction.c_str(), NS::UTF8StringEncoding ) );
+    vertexFunction->setLibrary( _pShaderLibrary );
+    pRenderPipDesc->setVertexFunctionDescriptor( vertexFunction.get() );
+
+    NS::SharedPtr<MTL4::LibraryFunctionDescriptor> fragmentFunction;
+    if (!desc.fragmentFunction.empty())
+    {
+        fragmentFunction = NS::TransferPtr( MTL4::LibraryFunctionDescriptor::alloc()->init() );
+        fragmentFunction->setName( NS::String::string( desc.fragmentFunction.c_str(), NS::UTF8StringEncoding ) );
+        fragmentFunction->setLibrary( _pShaderLibrary );
+        pRenderPipDesc->setFragmentFunctionDescriptor( fragmentFunction.get() );
+    }
+
+    pRenderPipDesc->setRasterSampleCount( desc.sampleCount );
+    for (uint32_t i = 0; i < pipeline_cache::kMaxColorAttachments; ++i)
+    {
+        if (desc.colorFormats[i] == 0)
+            continue;
+        MTL4::RenderPipelineColorAttachmentDescriptor* pColor = pRenderPipDesc->colorAttachments()->object(i);
+        pColor->setPixelFormat( (MTL::PixelFormat)desc.colorFormats[i] );
+        if (desc.blend[i] == pipeline_cache::BlendMode::Opaque)
+            continue;
+        pColor->setBlendingState( MTL4::BlendStateEnabled );
+        pColor->setSourceRGBBlendFactor( desc.blend[i] == pipeline_cache::BlendMode::Alpha ? MTL::BlendFactorSourceAlpha : MTL::BlendFactorOne );
+        pColor->setDestinationRGBBlendFactor( MTL::BlendFactorOneMinusSourceAlpha );
+        pColor->setSourceAlphaBlendFactor( MTL::BlendFactorOne );
+        pColor->setDestinationAlphaBlendFactor( MTL::BlendFactorOneMinusSourceAlpha );
+    }
+
+    return (_pCompiler->newRenderPipelineState( pRenderPipDesc.get(), nullptr, ppError ));
+}
+
+MTL::ComputePipelineState* MetalPipelineCompiler::newComputePipeline( const pipeline_cache::PipelineDesc& desc, NS::Error** ppError )
+{
+    NS::SharedPtr<MTL4::ComputePipelineDescriptor> pPipStateDesc = NS::TransferPtr( MTL4::ComputePipelineDescriptor::alloc()->init() );
+    pPipStateDesc->setLabel( NS::String::string( desc.label.c_str(), NS::UTF8StringEncoding ) );
+    pPipStateDesc->setThreadGroupSizeIsMultipleOfThreadExecutionWidth( desc.threadGroupSizeIsMultipleOfExecutionWidth );
+
+    NS::SharedPtr<MTL4::LibraryFunctionDescriptor> computeFunction = NS::TransferPtr( MTL4::LibraryFunctionDescriptor::alloc()->init() );
+    computeFunction->setName( NS::String::string( desc.computeFunction.c_str(), NS::UTF8StringEncoding ) );
+    computeFunction->setLibrary( _pShaderLibrary );
+    pPipStateDesc->setComputeFunctionDescriptor( computeFunction.get() );
+
+    return (_pCompiler->newComputePipelineState( pPipStateDesc.get(), nullptr, ppError ));
+}
@@ -0,0 +1,40 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLPipelineCompiler.hpp     +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 19:40:27      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLPIPELINECOMPILER_HPP
+# define RMDLPIPELINECOMPILER_HPP
+
+# include <Metal/Metal.hpp>
+
+# include "RMDLPipelineCache.hpp"
+# include "NonCopyable.h"
+
+/// pipeline_cache::PipelineCompiler on one MTL4::Compiler. Functions are looked up
+/// in a single library. Returns retained MTL::RenderPipelineState or
+/// MTL::ComputePipelineState depending on PipelineDesc::kind.
+class MetalPipelineCompiler : public pipeline_cache::PipelineCompiler, public NonCopyable
+{
+public:
+    MetalPipelineCompiler( MTL::Device* pDevice, MTL::Library* pShaderLibrary );
+    ~MetalPipelineCompiler() override;
+
+    void*   compile( const pipeline_cache::PipelineDesc& desc ) override;
+    void    release( void* pPipeline ) override;
+
+private:
+    MTL::RenderPipelineState*   newRenderPipeline( const pipeline_cache::PipelineDesc& desc, NS::Error** ppError );
+    MTL::ComputePipelineState*  newComputePipeline( const pipeline_cache::PipelineDesc& desc, NS::Error** ppError );
+
+    MTL::Device*                _pDevice;
+    MTL::Library*               _pShaderLibrary;
+    MTL4::Compiler*             _pCompiler;
+};
+
+#endif /* RMDLPIPELINECOMPILER_HPP */
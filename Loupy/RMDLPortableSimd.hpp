@@ -0,0 +1,284 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLPortableSimd.hpp         +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 04:07:31      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLPORTABLESIMD_HPP
+# define RMDLPORTABLESIMD_HPP
+
+# include <cmath>
+# include <cstddef>
+# include <type_traits>
+
+# if defined(__SSE2__)
+#  include <xmmintrin.h>
+# elif defined(__ARM_NEON)
+#  include <arm_neon.h>
+# endif
+
+// The part of <simd/simd.h> the CPU-side math and camera use, for toolchains
+// that do not ship it. Same layout: float3 takes 16 bytes and 16-byte alignment
+// like float4, float2 takes 8, matrices are arrays of columns. Lanes are gcc/clang
+// vector extensions under named members; horizontal sums and the 4x4 transpose
+// have SSE and NEON versions. RMDLSimd.hpp decides whether this or the system
+// header provides simd::. Only reads of .xyz are supported: writing it would
+// also write w.
+
+namespace portable_simd
+{
+    typedef float native2 __attribute__((__vector_size__(8)));
+    typedef float native4 __attribute__((__vector_size__(16)));
+
+    struct float2
+    {
+        union
+        {
+            struct { float x, y; };
+            native2 v;
+        };
+
+        float&  operator[]( int i )         { return (v[i]); }
+        float   operator[]( int i ) const   { return (v[i]); }
+    };
+
+    /// The fourth lane is padding; aggregate initialization zeroes it, nothing reads it.
+    struct float3
+    {
+        union
+        {
+            struct { float x, y, z; };
+            native4 v;
+        };
+
+        float&  operator[]( int i )         { return (v[i]); }
+        float   operator[]( int i ) const   { return (v[i]); }
+    };
+
+    struct float4
+    {
+        union
+        {
+            struct { float x, y, z, w; };
+            native4 v;
+            float3  xyz;
+        };
+
+        float&  operator[]( int i )         { return (v[i]); }
+        float   operator[]( int i ) const   { return (v[i]); }
+    };
+
+    static_assert(sizeof(float2) == 8 && alignof(float2) == 8, "float2 layout");
+    static_assert(sizeof(float3) == 16 && alignof(float3) == 16, "float3 layout");
+    static_assert(sizeof(float4) == 16 && alignof(float4) == 16, "float4 layout");
+
+    template< typename V > struct is_vector : std::false_type {};
+    template<> struct is_vector<float2> : std::true_type {};
+    template<> struct is_vector<float3> : std::true_type {};
+    template<> struct is_vector<float4> : std::true_type {};
+
+    template< typename V >
+    using if_vector = typename std::enable_if<is_vector<V>::value, V>::type;
+
+#pragma mark - Lanes
+
+    namespace detail
+    {
+        template< typename V, typename N >
+        inline V    make( N v )     { V r; r.v = v; return (r); }
+
+        inline float sum3( native4 p )
+        {
+            return (p[0] + p[1] + p[2]);
+        }
+
+        inline float sum4( native4 p )
+        {
+# if defined(__SSE2__)
+            const __m128 m = (__m128)p;
+            const __m128 hi = _mm_movehl_ps(m, m);
+            const __m128 s2 = _mm_add_ps(m, hi);
+            return (_mm_cvtss_f32(_mm_add_ss(s2, _mm_shuffle_ps(s2, s2, 1))));
+# elif defined(__ARM_NEON) && defined(__aarch64__)
+            return (vaddvq_f32((float32x4_t)p));
+# else
+            return ((p[0] + p[2]) + (p[1] + p[3]));
+# endif
+        }
+
+        /// In place: columns become rows.
+        inline void transpose4( native4& c0, native4& c1, native4& c2, native4& c3 )
+        {
+# if defined(__SSE2__)
+            __m128 r0 = (__m128)c0, r1 = (__m128)c1, r2 = (__m128)c2, r3 = (__m128)c3;
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            c0 = (native4)r0; c1 = (native4)r1; c2 = (native4)r2; c3 = (native4)r3;
+# elif defined(__ARM_NEON) && defined(__aarch64__)
+            const float32x4_t t0 = vtrn1q_f32((float32x4_t)c0, (float32x4_t)c1);
+            const float32x4_t t1 = vtrn2q_f32((float32x4_t)c0, (float32x4_t)c1);
+            const float32x4_t t2 = vtrn1q_f32((float32x4_t)c2, (float32x4_t)c3);
+            const float32x4_t t3 = vtrn2q_f32((float32x4_t)c2, (float32x4_t)c3);
+            c0 = (native4)vreinterpretq_f32_f64(vtrn1q_f64(vreinterpretq_f64_f32(t0), vreinterpretq_f64_f32(t2)));
+            c1 = (native4)vreinterpretq_f32_f64(vtrn1q_f64(vreinterpretq_f64_f32(t1), vreinterpretq_f64_f32(t3)));
+            c2 = (native4)vreinterpretq_f32_f64(vtrn2q_f64(vreinterpretq_f64_f32(t0), vreinterpretq_f64_f32(t2)));
+            c3 = (native4)vreinterpretq_f32_f64(vtrn2q_f64(vreinterpretq_f64_f32(t1), vreinterpretq_f64_f32(t3)));
+# else
+            const native4 r0 = { c0[0], c1[0], c2[0], c3[0] };
+            const native4 r1 = { c0[1], c1[1], c2[1], c3[1] };
+            const native4 r2 = { c0[2], c1[2], c2[2], c3[2] };
+            const native4 r3 = { c0[3], c1[3], c2[3], c3[3] };
+            c0 = r0; c1 = r1; c2 = r2; c3 = r3;
+# endif
+        }
+    }
+
+    template< typename V > inline if_vector<V> operator+( V a, V b )        { return (detail::make<V>(a.v + b.v)); }
+    template< typename V > inline if_vector<V> operator-( V a, V b )        { return (detail::make<V>(a.v - b.v)); }
+    template< typename V > inline if_vector<V> operator*( V a, V b )        { return (detail::make<V>(a.v * b.v)); }
+    template< typename V > inline if_vector<V> operator/( V a, V b )        { return (detail::make<V>(a.v / b.v)); }
+    template< typename V > inline if_vector<V> operator*( V a, float s )    { return (detail::make<V>(a.v * s)); }
+    template< typename V > inline if_vector<V> operator*( float s, V a )    { return (detail::make<V>(s * a.v)); }
+    template< typename V > inline if_vector<V> operator/( V a, float s )    { return (detail::make<V>(a.v / s)); }
+    template< typename V > inline if_vector<V> operator-( V a )             { return (detail::make<V>(-a.v)); }
+    template< typename V > inline if_vector<V>& operator+=( V& a, V b )     { a.v += b.v; return (a); }
+    template< typename V > inline if_vector<V>& operator-=( V& a, V b )     { a.v -= b.v; return (a); }
+    template< typename V > inline if_vector<V>& operator*=( V& a, V b )     { a.v *= b.v; return (a); }
+    template< typename V > inline if_vector<V>& operator*=( V& a, float s ) { a.v *= s; return (a); }
+    template< typename V > inline if_vector<V>& operator/=( V& a, float s ) { a.v /= s; return (a); }
+
+    inline float    dot( float2 a, float2 b )       { return (a.x * b.x + a.y * b.y); }
+    inline float    dot( float3 a, float3 b )       { return (detail::sum3(a.v * b.v)); }
+    inline float    dot( float4 a, float4 b )       { return (detail::sum4(a.v * b.v)); }
+
+    inline float3   cross( float3 a, float3 b )
+    {
+        const native4 ayzx = __builtin_shufflevector(a.v, a.v, 1, 2, 0, 3);
+        const native4 bzxy = __builtin_shufflevector(b.v, b.v, 2, 0, 1, 3);
+        const native4 azxy = __builtin_shufflevector(a.v, a.v, 2, 0, 1, 3);
+        const native4 byzx = __builtin_shufflevector(b.v, b.v, 1, 2, 0, 3);
+        return (detail::make<float3>(ayzx * bzxy - azxy * byzx));
+    }
+
+    template< typename V > inline typename std::enable_if<is_vector<V>::value, float>::type length_squared( V a )  { return (dot(a, a)); }
+    template< typename V > inline typename std::enable_if<is_vector<V>::value, float>::type length( V a )          { return (std::sqrt(dot(a, a))); }
+    template< typename V > inline if_vector<V> normalize( V a )     { return (a * (1.f / std::sqrt(dot(a, a)))); }
+    template< typename V > inline if_vector<V> lerp( V a, V b, float t )    { return (a + (b - a) * t); }
+
+#pragma mark - Matrices
+
+    /// Columns, as the C types of <simd/simd.h>; the classes below add constructors.
+    struct simd_float3x3 { float3 columns[3]; };
+    struct simd_float4x3 { float3 columns[4]; };
+    struct simd_float4x4 { float4 columns[4]; };
+
+    struct float3x3 : simd_float3x3
+    {
+        float3x3() : simd_float3x3{} {}
+        explicit float3x3( float diagonal ) : simd_float3x3{ { { diagonal, 0.f, 0.f }, { 0.f, diagonal, 0.f }, { 0.f, 0.f, diagonal } } } {}
+        float3x3( float3 c0, float3 c1, float3 c2 ) : simd_float3x3{ { c0, c1, c2 } } {}
+        float3x3( const simd_float3x3& m ) : simd_float3x3(m) {}
+    };
+
+    struct float4x3 : simd_float4x3
+    {
+        float4x3() : simd_float4x3{} {}
+        float4x3( float3 c0, float3 c1, float3 c2, float3 c3 ) : simd_float4x3{ { c0, c1, c2, c3 } } {}
+        float4x3( const simd_float4x3& m ) : simd_float4x3(m) {}
+    };
+
+    struct float4x4 : simd_float4x4
+    {
+        float4x4() : simd_float4x4{} {}
+        explicit float4x4( float diagonal ) : simd_float4x4{ { { diagonal, 0.f, 0.f, 0.f }, { 0.f, diagonal, 0.f, 0.f },
+                                                                { 0.f, 0.f, diagonal, 0.f }, { 0.f, 0.f, 0.f, diagonal } } } {}
+        float4x4( float4 c0, float4 c1, float4 c2, float4 c3 ) : simd_float4x4{ { c0, c1, c2, c3 } } {}
+        float4x4( const simd_float4x4& m ) : simd_float4x4(m) {}
+    };
+
+    static_assert(sizeof(simd_float3x3) == 48 && sizeof(simd_float4x3) == 64 && sizeof(simd_float4x4) == 64, "matrix layout");
+    static_assert(sizeof(float4x4) == sizeof(simd_float4x4) && sizeof(float3x3) == sizeof(simd_float3x3), "matrix layout");
+
+    inline float3   mul( const simd_float3x3& m, float3 v )
+    {
+        return (detail::make<float3>(m.columns[0].v * v.x + m.columns[1].v * v.y + m.columns[2].v * v.z));
+    }
+
+    inline float4   mul( const simd_float4x4& m, float4 v )
+    {
+        return (detail::make<float4>(m.columns[0].v * v.x + m.columns[1].v * v.y + m.columns[2].v * v.z + m.columns[3].v * v.w));
+    }
+
+    inline simd_float3x3 mul( const simd_float3x3& a, const simd_float3x3& b )
+    {
+        return { { mul(a, b.columns[0]), mul(a, b.columns[1]), mul(a, b.columns[2]) } };
+    }
+
+    inline simd_float4x4 mul( const simd_float4x4& a, const simd_float4x4& b )
+    {
+        return { { mul(a, b.columns[0]), mul(a, b.columns[1]), mul(a, b.columns[2]), mul(a, b.columns[3]) } };
+    }
+
+    inline float3           operator*( const simd_float3x3& m, float3 v )               { return (mul(m, v)); }
+    inline float4           operator*( const simd_float4x4& m, float4 v )               { return (mul(m, v)); }
+    inline simd_float3x3    operator*( const simd_float3x3& a, const simd_float3x3& b ) { return (mul(a, b)); }
+    inline simd_float4x4    operator*( const simd_float4x4& a, const simd_float4x4& b ) { return (mul(a, b)); }
+
+    inline simd_float3x3 transpose( const simd_float3x3& m )
+    {
+        return { { { m.columns[0].x, m.columns[1].x, m.columns[2].x },
+                   { m.columns[0].y, m.columns[1].y, m.columns[2].y },
+                   { m.columns[0].z, m.columns[1].z, m.columns[2].z } } };
+    }
+
+    inline simd_float4x4 transpose( const simd_float4x4& m )
+    {
+        simd_float4x4 t = m;
+        detail::transpose4(t.columns[0].v, t.columns[1].v, t.columns[2].v, t.columns[3].v);
+        return (t);
+    }
+
+    inline simd_float3x3 inverse( const simd_float3x3& m )
+    {
+        // The rows of the inverse are the cross products of column pairs, over the determinant.
+        const float3 r0 = cross(m.columns[1], m.columns[2]);
+        const float3 r1 = cross(m.columns[2], m.columns[0]);
+        const float3 r2 = cross(m.columns[0], m.columns[1]);
+        const float invDet = 1.f / dot(m.columns[0], r0);
+        return (transpose(simd_float3x3{ { r0 * invDet, r1 * invDet, r2 * invDet } }));
+    }
+
+    inline simd_float4x4 inverse( const simd_float4x4& m )
+    {
+        // Cofactors from the 2x2 minors of the two column pairs.
+        const float3 a = m.columns[0].xyz, b = m.columns[1].xyz, c = m.columns[2].xyz, d = m.columns[3].xyz;
+        const float x = m.columns[0].w, y = m.columns[1].w, z = m.columns[2].w, w = m.columns[3].w;
+
+        float3 s = cross(a, b);
+        float3 t = cross(c, d);
+        float3 u = a * y - b * x;
+        float3 v = c * w - d * z;
+
+        const float invDet = 1.f / (dot(s, v) + dot(t, u));
+        s = s * invDet;
+        t = t * invDet;
+        u = u * invDet;
+        v = v * invDet;
+
+        const float3 r0 = cross(b, v) + t * y;
+        const float3 r1 = cross(v, a) - t * x;
+        const float3 r2 = cross(d, u) + s * w;
+        const float3 r3 = cross(u, c) - s * z;
+
+        simd_float4x4 rows = { { { r0.x, r0.y, r0.z, -dot(b, t) },
+                                 { r1.x, r1.y, r1.z,  dot(a, t) },
+                                 { r2.x, r2.y, r2.z, -dot(d, s) },
+                                 { r3.x, r3.y, r3.z,  dot(c, s) } } };
+        return (transpose(rows));
+    }
+}
+
+#endif /* RMDLPORTABLESIMD_HPP */
@@ -0,0 +1,317 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLRadixSort.cpp            +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 08:31:17      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLRadixSort.hpp"
+#include "RMDLParallel.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace radix_sort
+{
+
+namespace
+{
+    static constexpr uint32_t kRadixBits = 8;
+    static constexpr uint32_t kRadix = 1u << kRadixBits;
+    static constexpr uint32_t kMaxDigits = (64 + kRadixBits - 1) / kRadixBits;
+    /// Keys per block: below this a block's counters cost more than its keys.
+    static constexpr size_t kMinBlock = 16 * 1024;
+    static constexpr size_t kMaxBlocks = 64;
+    /// Below this an insertion sort wins.
+    static constexpr size_t kSmallSort = 64;
+    /// Keys counted per step, each into its own counters, so equal digits in
+    /// a row do not wait on each other's increments.
+    static constexpr uint32_t kLanes = 4;
+    static constexpr size_t kCacheLine = 64;
+
+    // 16 bytes of keys in gcc/clang vector extensions, the width SSE2 and
+    // NEON always have: the shifts and masks of a digit run on all of them.
+    template< typename Key > struct Vector;
+    template<> struct Vector<uint32_t> { typedef uint32_t Type __attribute__((__vector_size__(16))); };
+    template<> struct Vector<uint64_t> { typedef uint64_t Type __attribute__((__vector_size__(16))); };
+
+    /// A cache line of keys, and their values, per digit.
+    template< typename Key >
+    struct WriteBuffer
+    {
+        static constexpr uint32_t kSize = kCacheLine / sizeof(Key);
+
+        alignas(kCacheLine) Key keys[kRadix][kSize];
+        uint32_t        values[kRadix][kSize];
+        uint8_t         fill[kRadix];
+    };
+
+    template< typename Key >
+    inline Key keyMask( uint32_t keyBits )
+    {
+        return (keyBits >= sizeof(Key) * 8 ? (Key)~(Key)0 : (Key)(((Key)1 << keyBits) - 1));
+    }
+
+    /// Counts `digitCount` digits, from bit `shift` up, of keys [begin, end)
+    /// into pCounts[digit * kRadix + value].
+    template< typename Key >
+    void countDigits( const Key* pKeys, size_t begin, size_t end, Key mask, uint32_t shift, uint32_t digitCount, uint32_t* pCounts )
+    {
+        typedef typename Vector<Key>::Type Keys;
+        static constexpr uint32_t kPerVector = sizeof(Keys) / sizeof(Key);
+
+        uint32_t lanes[kMaxDigits * kLanes * kRadix];
+        std::fill_n(lanes, digitCount * kLanes * kRadix, 0u);
+        const Keys masks = Keys{} + mask;
+        size_t i = begin;
+        for (; i + kLanes <= end; i += kLanes)
+        {
+            for (uint32_t v = 0; v < kLanes / kPerVector; ++v)
+            {
+                Keys keys;
+                std::memcpy(&keys, pKeys + i + v * kPerVector, sizeof(keys));
+                keys &= masks;
+                for (uint32_t d = 0; d < digitCount; ++d)
+                {
+                    const Keys digits = (keys >> (Key)(shift + d * kRadixBits)) & (Key)(kRadix - 1);
+                    uint32_t* pLanes = lanes + (d * kLanes + v * kPerVector) * kRadix;
+                    for (uint32_t l = 0; l < kPerVector; ++l)
+                        ++pLanes[l * kRadix + (uint32_t)digits[l]];
+                }
+            }
+        }
+        for (; i < end; ++i)
+        {
+            for (uint32_t d = 0; d < digitCount; ++d)
+                ++lanes[d * kLanes * kRadix + (((pKeys[i] & mask) >> (shift + d * kRadixBits)) & (kRadix - 1))];
+        }
+
+        for (uint32_t d = 0; d < digitCount; ++d)
+        {
+            const uint32_t* pLanes = lanes + d * kLanes * kRadix;
+            for (uint32_t value = 0; value < kRadix; ++value)
+            {
+                uint32_t n = 0;
+                for (uint32_t l = 0; l < kLanes; ++l)
+                    n += pLanes[l * kRadix + value];
+                pCounts[d * kRadix + value] = n;
+            }
+        }
+    }
+
+    /// Moves keys [begin, end) to pOffsets[digit]++, in order. Past the
+    /// caches, a store per key into 256 output streams misses every time;
+    /// keys gather per digit and leave a cache line at once.
+    template< typename Key >
+    void scatter( const Key* pKeys, const uint32_t* pValues, size_t begin, size_t end, Key mask, uint32_t shift,
+                  uint32_t* pOffsets, Key* pKeysOut, uint32_t* pValuesOut )
+    {
+        typedef WriteBuffer<Key> Buffer;
+        Buffer buffer;
+        std::fill_n(buffer.fill, kRadix, 0);
+
+        for (size_t i = begin; i < end; ++i)
+        {
+            const uint32_t digit = ((pKeys[i] & mask) >> shift) & (kRadix - 1);
+            const uint32_t slot = buffer.fill[digit]++;
+            buffer.keys[digit][slot] = pKeys[i];
+            if (pValues)
+                buffer.values[digit][slot] = pValues[i];
+            if (slot + 1 == Buffer::kSize)
+            {
+                const uint32_t to = pOffsets[digit];
+                std::memcpy(pKeysOut + to, buffer.keys[digit], sizeof(buffer.keys[digit]));
+                if (pValues)
+                    std::memcpy(pValuesOut + to, buffer.values[digit], sizeof(buffer.values[digit]));
+                pOffsets[digit] = to + Buffer::kSize;
+                buffer.fill[digit] = 0;
+            }
+        }
+        for (uint32_t digit = 0; digit < kRadix; ++digit)
+        {
+            const uint32_t to = pOffsets[digit];
+            std::copy_n(buffer.keys[digit], buffer.fill[digit], pKeysOut + to);
+            if (pValues)
+                std::copy_n(buffer.values[digit], buffer.fill[digit], pValuesOut + to);
+            pOffsets[digit] = to + buffer.fill[digit];
+        }
+    }
+
+    template< typename Key >
+    void insertionSort( Key* pKeys, uint32_t* pValues, size_t count, Key mask )
+    {
+        for (size_t i = 1; i < count; ++i)
+        {
+            const Key key = pKeys[i];
+            const uint32_t value = pValues ? pValues[i] : 0;
+            size_t j = i;
+            for (; j > 0 && (pKeys[j - 1] & mask) > (key & mask); --j)
+            {
+                pKeys[j] = pKeys[j - 1];
+                if (pValues)
+                    pValues[j] = pValues[j - 1];
+            }
+            pKeys[j] = key;
+            if (pValues)
+                pValues[j] = value;
+        }
+    }
+
+    template< typename Key >
+    void sortKeys( parallel::ThreadPool& pool, Key* pKeys, uint32_t* pValues, size_t count, uint32_t keyBits )
+    {
+        assert(keyBits <= sizeof(Key) * 8);
+        assert(count <= UINT32_MAX);
+        const Key mask = keyMask<Key>(keyBits);
+        if (count < kSmallSort)
+        {
+            insertionSort(pKeys, pValues, count, mask);
+            return;
+        }
+        const uint32_t digitCount = (keyBits + kRadixBits - 1) / kRadixBits;
+        const size_t blockCount = std::min(kMaxBlocks, (count + kMinBlock - 1) / kMinBlock);
+        const size_t blockSize = (count + blockCount - 1) / blockCount;
+        auto blockEnd = [&]( size_t block ) { return (std::min(count, (block + 1) * blockSize)); };
+
+        // Every digit of every block at once; the totals do not change from
+        // pass to pass, so they tell which digits all keys share.
+        std::vector<uint32_t> counts(blockCount * digitCount * kRadix);
+        pool.forRange(blockCount, 1, [&]( size_t begin, size_t end )
+        {
+            for (size_t block = begin; block < end; ++block)
+                countDigits(pKeys, block * blockSize, blockEnd(block), mask, 0, digitCount, counts.data() + block * digitCount * kRadix);
+        });
+        bool needed[kMaxDigits] = {};
+        for (uint32_t d = 0; d < digitCount; ++d)
+        {
+            needed[d] = true;
+            for (uint32_t value = 0; value < kRadix && needed[d]; ++value)
+            {
+                size_t total = 0;
+                for (size_t block = 0; block < blockCount; ++block)
+                    total += counts[(block * digitCount + d) * kRadix + value];
+                needed[d] = (total != count);
+            }
+        }
+
+        std::vector<Key> keyScratch(count);
+        std::vector<uint32_t> valueScratch(pValues ? count : 0);
+        Key* pFrom = pKeys;
+        Key* pTo = keyScratch.data();
+        uint32_t* pValuesFrom = pValues;
+        uint32_t* pValuesTo = pValues ? valueScratch.data() : nullptr;
+        std::vector<uint32_t> offsets(blockCount * kRadix);
+        bool counted = true;
+        for (uint32_t d = 0; d < digitCount; ++d)
+        {
+            if (!needed[d])
+                continue;
+            const uint32_t shift = d * kRadixBits;
+            if (counted)
+            {
+                for (size_t block = 0; block < blockCount; ++block)
+                    std::copy_n(counts.data() + (block * digitCount + d) * kRadix, kRadix, offsets.data() + block * kRadix);
+                counted = false;
+            }
+            else
+            {
+                pool.forRange(blockCount, 1, [&]( size_t begin, size_t end )
+                {
+                    for (size_t block = begin; block < end; ++block)
+                        countDigits(pFrom, block * blockSize, blockEnd(block), mask, shift, 1, offsets.data() + block * kRadix);
+                });
+            }
+
+            // Digit-major, block-minor: each block writes after the earlier
+            // blocks' keys with the same digit.
+            uint32_t running = 0;
+            for (uint32_t value = 0; value < kRadix; ++value)
+            {
+                for (size_t block = 0; block < blockCount; ++block)
+                {
+                    const uint32_t n = offsets[block * kRadix + value];
+                    offsets[block * kRadix + value] = running;
+                    running += n;
+                }
+            }
+
+            pool.forRange(blockCount, 1, [&]( size_t begin, size_t end )
+            {
+                for (size_t block = begin; block < end; ++block)
+                    scatter(pFrom, pValuesFrom, block * blockSize, blockEnd(block), mask, shift, offsets.data() + block * kRadix, pTo, pValuesTo);
+            });
+            std::swap(pFrom, pTo);
+            std::swap(pValuesFrom, pValuesTo);
+        }
+
+        if (pFrom != pKeys)
+        {
+            pool.forRange(blockCount, 1, [&]( size_t begin, size_t end )
+            {
+                const size_t first = begin * blockSize, last = blockEnd(end - 1);
+                std::copy(pFrom + first, pFrom + last, pKeys + first);
+                if (pValues)
+                    std::copy(pValuesFrom + first, pValuesFrom + last, pValues + first);
+            });
+        }
+    }
+
+    template< typename Key >
+    void orderKeys( parallel::ThreadPool& pool, const Key* pKeys, size_t count, uint32_t* pOrder, uint32_t keyBits )
+    {
+        std::vector<Key> keys(pKeys, pKeys + count);
+        for (size_t i = 0; i < count; ++i)
+            pOrder[i] = (uint32_t)i;
+        sortKeys(pool, keys.data(), pOrder, count, keyBits);
+    }
+}
+
+#pragma mark - Sort
+
+void sort( uint32_t* pKeys, uint32_t* pValues, size_t count, uint32_t keyBits )
+{
+    sortKeys(parallel::defaultPool(), pKeys, pValues, count, keyBits);
+}
+
+void sort( uint64_t* pKeys, uint32_t* pValues, size_t count, uint32_t keyBits )
+{
+    sortKeys(parallel::defaultPool(), pKeys, pValues, count, keyBits);
+}
+
+void sort( parallel::ThreadPool& pool, uint32_t* pKeys, uint32_t* pValues, size_t count, uint32_t keyBits )
+{
+    sortKeys(pool, pKeys, pValues, count, keyBits);
+}
+
+void sort( parallel::ThreadPool& pool, uint64_t* pKeys, uint32_t* pValues, size_t count, uint32_t keyBits )
+{
+    sortKeys(pool, pKeys, pValues, count, keyBits);
+}
+
+#pragma mark - Permutation
+
+void sortedOrder( const uint32_t* pKeys, size_t count, uint32_t* pOrder, uint32_t keyBits )
+{
+    orderKeys(parallel::defaultPool(), pKeys, count, pOrder, keyBits);
+}
+
+void sortedOrder( const uint64_t* pKeys, size_t count, uint32_t* pOrder, uint32_t keyBits )
+{
+    orderKeys(parallel::defaultPool(), pKeys, count, pOrder, keyBits);
+}
+
+void sortedOrder( parallel::ThreadPool& pool, const uint32_t* pKeys, size_t count, uint32_t* pOrder, uint32_t keyBits )
+{
+    orderKeys(pool, pKeys, count, pOrder, keyBits);
+}
+
+void sortedOrder( parallel::ThreadPool& pool, const uint64_t* pKeys, size_t count, uint32_t* pOrder, uint32_t keyBits )
+{
+    orderKeys(pool, pKeys, count, pOrder, keyBits);
+}
+
+}
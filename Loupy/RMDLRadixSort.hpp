@@ -0,0 +1,59 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLRadixSort.hpp            +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 08:31:12      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLRADIXSORT_HPP
+# define RMDLRADIXSORT_HPP
+
+# include <cstddef>
+# include <cstdint>
+# include <cstring>
+
+// Stable LSD radix sort of 32- and 64-bit keys, for draw keys, depths and
+// spatial keys: eight bits per pass. Every pass splits the keys in blocks;
+// each block counts its digits, then a digit-major prefix sum gives every
+// block its own output ranges, so the blocks scatter in parallel and equal
+// keys keep their order. One counting pass up front reads each key once for
+// all its digits, and a digit that every key shares costs no pass. Keys can
+// carry a 32-bit payload (an index, a handle) that moves with them.
+
+namespace parallel
+{
+    class ThreadPool;
+}
+
+namespace radix_sort
+{
+    /// Sorts pKeys[0, count) by their low `keyBits` bits, carrying pValues
+    /// (or nullptr) along; bits above are ignored. Equal keys keep their order.
+    void        sort( uint32_t* pKeys, uint32_t* pValues, size_t count, uint32_t keyBits = 32 );
+    void        sort( uint64_t* pKeys, uint32_t* pValues, size_t count, uint32_t keyBits = 64 );
+    void        sort( parallel::ThreadPool& pool, uint32_t* pKeys, uint32_t* pValues, size_t count, uint32_t keyBits = 32 );
+    void        sort( parallel::ThreadPool& pool, uint64_t* pKeys, uint32_t* pValues, size_t count, uint32_t keyBits = 64 );
+
+    /// Leaves the keys alone and writes the permutation that sorts them:
+    /// pKeys[pOrder[0]] <= pKeys[pOrder[1]] <= ..., ties by index. Sorting
+    /// keys and a draw index is cheaper than moving the draws.
+    void        sortedOrder( const uint32_t* pKeys, size_t count, uint32_t* pOrder, uint32_t keyBits = 32 );
+    void        sortedOrder( const uint64_t* pKeys, size_t count, uint32_t* pOrder, uint32_t keyBits = 64 );
+    void        sortedOrder( parallel::ThreadPool& pool, const uint32_t* pKeys, size_t count, uint32_t* pOrder, uint32_t keyBits = 32 );
+    void        sortedOrder( parallel::ThreadPool& pool, const uint64_t* pKeys, size_t count, uint32_t* pOrder, uint32_t keyBits = 64 );
+
+    /// Bits of `f` that sort as unsigned integers in the order of the floats,
+    /// -0 just before +0; NaNs go past the infinities. ~floatKey(f) sorts
+    /// back to front.
+    inline uint32_t floatKey( float f )
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+        return (bits ^ ((uint32_t)((int32_t)bits >> 31) | 0x80000000u));
+    }
+}
+
+#endif /* RMDLRADIXSORT_HPP */
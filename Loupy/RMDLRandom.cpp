@@ -0,0 +1,548 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLRandom.cpp               +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 04:58:47      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLRandom.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__)
+# include <emmintrin.h>
+#elif defined(__aarch64__)
+# include <arm_neon.h>
+#endif
+
+namespace rng
+{
+
+namespace
+{
+    constexpr uint32_t kMul0 = 0xD2511F53;
+    constexpr uint32_t kMul1 = 0xCD9E8D57;
+    constexpr uint32_t kWeyl0 = 0x9E3779B9;
+    constexpr uint32_t kWeyl1 = 0xBB67AE85;
+
+    uint64_t splitMix64( uint64_t x )
+    {
+        x += 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return (x ^ (x >> 31));
+    }
+
+#pragma mark - Lanes
+
+    // Four counters per vector in gcc/clang vector extensions, the width SSE2
+    // and NEON always have; two vectors per batch, so one multiply's latency
+    // hides behind the other's.
+    static constexpr uint32_t kLanes = 4;
+    static constexpr uint32_t kBatch = 2 * kLanes;
+
+    typedef uint32_t    U32s __attribute__((__vector_size__(16)));
+    typedef int32_t     I32s __attribute__((__vector_size__(16)));
+    typedef float       F32s __attribute__((__vector_size__(16)));
+
+    /// High and low words of the 32x32 -> 64 products. Compilers turn the plain
+    /// vector version into full 64-bit multiplies, hence the intrinsics.
+    inline void mulHiLo( U32s a, uint32_t m, U32s& hi, U32s& lo )
+    {
+#if defined(__SSE2__)
+        const __m128i factor = _mm_set1_epi32((int)m);
+        const __m128i even = _mm_mul_epu32((__m128i)a, factor);
+        const __m128i odd = _mm_mul_epu32(_mm_srli_epi64((__m128i)a, 32), factor);
+        lo = __builtin_shufflevector((U32s)even, (U32s)odd, 0, 4, 2, 6);
+        hi = __builtin_shufflevector((U32s)even, (U32s)odd, 1, 5, 3, 7);
+#elif defined(__aarch64__)
+        const uint32x4_t va = (uint32x4_t)a;
+        const uint32x4_t low = vreinterpretq_u32_u64(vmull_n_u32(vget_low_u32(va), m));
+        const uint32x4_t high = vreinterpretq_u32_u64(vmull_high_n_u32(va, m));
+        lo = (U32s)vuzp1q_u32(low, high);
+        hi = (U32s)vuzp2q_u32(low, high);
+#else
+        for (uint32_t i = 0; i < kLanes; ++i)
+        {
+            const uint64_t product = (uint64_t)a[i] * m;
+            lo[i] = (uint32_t)product;
+            hi[i] = (uint32_t)(product >> 32);
+        }
+#endif
+    }
+
+    struct Counters
+    {
+        U32s    x0, x1, x2, x3;
+
+        void    round( uint32_t k0, uint32_t k1 )
+        {
+            U32s hi0, lo0, hi1, lo1;
+            mulHiLo(x0, kMul0, hi0, lo0);
+            mulHiLo(x2, kMul1, hi1, lo1);
+            x0 = hi1 ^ x1 ^ k0;
+            x1 = lo1;
+            x2 = hi0 ^ x3 ^ k1;
+            x3 = lo0;
+        }
+
+        /// Counter-major to block-major, a 4x4 transpose: 16 words in stream order.
+        void    store( uint32_t* pOut ) const
+        {
+            const U32s t0 = __builtin_shufflevector(x0, x1, 0, 4, 1, 5);
+            const U32s t1 = __builtin_shufflevector(x2, x3, 0, 4, 1, 5);
+            const U32s t2 = __builtin_shufflevector(x0, x1, 2, 6, 3, 7);
+            const U32s t3 = __builtin_shufflevector(x2, x3, 2, 6, 3, 7);
+            const U32s blocks[kLanes] =
+            {
+                __builtin_shufflevector(t0, t1, 0, 1, 4, 5),
+                __builtin_shufflevector(t0, t1, 2, 3, 6, 7),
+                __builtin_shufflevector(t2, t3, 0, 1, 4, 5),
+                __builtin_shufflevector(t2, t3, 2, 3, 6, 7),
+            };
+            memcpy(pOut, blocks, sizeof(blocks));
+        }
+    };
+
+    inline Counters counters( uint64_t stream, uint64_t block )
+    {
+        const U32s lane = { 0, 1, 2, 3 };
+        const uint32_t blockLo = (uint32_t)block;
+        Counters c;
+        c.x0 = blockLo + lane;
+        c.x1 = (uint32_t)(block >> 32) - (U32s)(c.x0 < blockLo);   // carry: the comparison is -1
+        c.x2 = U32s{} + (uint32_t)stream;
+        c.x3 = U32s{} + (uint32_t)(stream >> 32);
+        return (c);
+    }
+
+    /// Blocks `block` .. `block + 7` of a stream, 32 words in stream order.
+    void philoxBatch( uint64_t key, uint64_t stream, uint64_t block, uint32_t* pOut )
+    {
+        Counters a = counters(stream, block);
+        Counters b = counters(stream, block + kLanes);
+        uint32_t k0 = (uint32_t)key;
+        uint32_t k1 = (uint32_t)(key >> 32);
+        for (int round = 0; round < 10; ++round)
+        {
+            a.round(k0, k1);
+            b.round(k0, k1);
+            k0 += kWeyl0;
+            k1 += kWeyl1;
+        }
+        a.store(pOut);
+        b.store(pOut + 4 * kLanes);
+    }
+
+    /// [0, 1) with 24 bits, or (0, 1] with `offset` 1.
+    inline F32s unitFloats( U32s words, uint32_t offset )
+    {
+        return (__builtin_convertvector((words >> 8) + offset, F32s) * 0x1p-24f);
+    }
+
+    inline F32s sqrtLanes( F32s x )
+    {
+        for (uint32_t i = 0; i < kLanes; ++i)
+            x[i] = __builtin_sqrtf(x[i]);
+        return (x);
+    }
+
+    /// Natural log of normal, positive floats; Cephes logf, within 2 ulp.
+    F32s logLanes( F32s x )
+    {
+        const I32s bits = (I32s)x;
+        I32s exponent = ((bits >> 23) & 0xFF) - 126;
+        F32s m = (F32s)((bits & 0x007FFFFF) | 0x3F000000);      // x = m * 2^exponent, m in [0.5, 1)
+        const I32s small = m < 0.70710678f;
+        exponent += small;                                      // -1 where m is rescaled below
+        m = (small ? m + m : m) - 1.f;
+
+        const F32s z = m * m;
+        F32s y = F32s{} + 7.0376836292e-2f;
+        y = y * m - 1.1514610310e-1f;
+        y = y * m + 1.1676998740e-1f;
+        y = y * m - 1.2420140846e-1f;
+        y = y * m + 1.4249322787e-1f;
+        y = y * m - 1.6668057665e-1f;
+        y = y * m + 2.0000714765e-1f;
+        y = y * m - 2.4999993993e-1f;
+        y = y * m + 3.3333331174e-1f;
+        y = y * m * z;
+
+        const F32s e = __builtin_convertvector(exponent, F32s);
+        y += e * -2.12194440e-4f;
+        y -= 0.5f * z;
+        return (m + y + e * 0.693359375f);
+    }
+
+    /// sin and cos of 2 pi u for u in [0, 1): quadrant from u, Taylor on [0, pi/2).
+    void sinCosTurns( F32s u, F32s& s, F32s& c )
+    {
+        const F32s t = u * 4.f;
+        const I32s quadrant = __builtin_convertvector(t, I32s);
+        const F32s a = (t - __builtin_convertvector(quadrant, F32s)) * 1.57079633f;
+        const F32s a2 = a * a;
+
+        F32s sa = F32s{} - 2.50521084e-8f;
+        sa = sa * a2 + 2.75573192e-6f;
+        sa = sa * a2 - 1.98412698e-4f;
+        sa = sa * a2 + 8.33333333e-3f;
+        sa = sa * a2 - 1.66666667e-1f;
+        sa = (sa * a2 + 1.f) * a;
+
+        F32s ca = F32s{} + 2.08767570e-9f;
+        ca = ca * a2 - 2.75573192e-7f;
+        ca = ca * a2 + 2.48015873e-5f;
+        ca = ca * a2 - 1.38888889e-3f;
+        ca = ca * a2 + 4.16666667e-2f;
+        ca = ca * a2 - 0.5f;
+        ca = ca * a2 + 1.f;
+
+        const I32s odd = (quadrant & 1) != 0;
+        s = odd ? ca : sa;
+        c = odd ? sa : ca;
+        s = ((quadrant & 2) != 0) ? -s : s;
+        c = (((quadrant ^ (quadrant >> 1)) & 1) != 0) ? -c : c;
+    }
+
+    std::atomic<uint64_t> gThreadSeed { 0 };
+    std::atomic<uint32_t> gThreadGeneration { 0 };
+    std::atomic<uint32_t> gThreadCount { 0 };
+}
+
+void philox4x32( uint64_t key, const uint32_t counter[4], uint32_t out[4] )
+{
+    uint32_t x0 = counter[0], x1 = counter[1], x2 = counter[2], x3 = counter[3];
+    uint32_t k0 = (uint32_t)key;
+    uint32_t k1 = (uint32_t)(key >> 32);
+    for (int round = 0; round < 10; ++round)
+    {
+        const uint64_t p0 = (uint64_t)kMul0 * x0;
+        const uint64_t p1 = (uint64_t)kMul1 * x2;
+        x0 = (uint32_t)(p1 >> 32) ^ x1 ^ k0;
+        x1 = (uint32_t)p1;
+        x2 = (uint32_t)(p0 >> 32) ^ x3 ^ k1;
+        x3 = (uint32_t)p0;
+        k0 += kWeyl0;
+        k1 += kWeyl1;
+    }
+    out[0] = x0;
+    out[1] = x1;
+    out[2] = x2;
+    out[3] = x3;
+}
+
+#pragma mark - Stream
+
+Stream::Stream( uint64_t seed, uint64_t stream )
+: _key( seed )
+, _stream( stream )
+, _block( 0 )
+, _words{ 0, 0, 0, 0 }
+, _used( 4 )
+, _spareNormal( 0.f )
+, _hasSpareNormal( false )
+{
+}
+
+Stream Stream::split( uint64_t index ) const
+{
+    // Children share the key; their stream ids are hashes, so grandchildren and
+    // siblings do not collide in practice.
+    return (Stream(_key, splitMix64(_stream ^ splitMix64(index + 1))));
+}
+
+void Stream::refill()
+{
+    const uint32_t counter[4] = { (uint32_t)_block, (uint32_t)(_block >> 32), (uint32_t)_stream, (uint32_t)(_stream >> 32) };
+    philox4x32(_key, counter, _words);
+    ++_block;
+    _used = 0;
+}
+
+uint32_t Stream::nextU32()
+{
+    if (_used == 4)
+        refill();
+    return (_words[_used++]);
+}
+
+uint64_t Stream::nextU64()
+{
+    const uint64_t lo = nextU32();
+    return (lo | ((uint64_t)nextU32() << 32));
+}
+
+float Stream::nextFloat()
+{
+    return ((float)(nextU32() >> 8) * 0x1p-24f);
+}
+
+float Stream::normal()
+{
+    if (_hasSpareNormal)
+    {
+        _hasSpareNormal = false;
+        return (_spareNormal);
+    }
+    const float u1 = (float)((nextU32() >> 8) + 1) * 0x1p-24f;
+    const float u2 = (float)(nextU32() >> 8) * 0x1p-24f;
+    const float r = std::sqrt(-2.f * std::log(u1));
+    const float theta = 6.28318531f * u2;
+    _spareNormal = r * std::sin(theta);
+    _hasSpareNormal = true;
+    return (r * std::cos(theta));
+}
+
+void Stream::fillU32( uint32_t* pOut, size_t count )
+{
+    while (count && _used < 4)
+    {
+        *pOut++ = _words[_used++];
+        --count;
+    }
+    for (; count >= 4 * kBatch; count -= 4 * kBatch, pOut += 4 * kBatch)
+    {
+        philoxBatch(_key, _stream, _block, pOut);
+        _block += kBatch;
+    }
+    while (count--)
+        *pOut++ = nextU32();
+}
+
+void Stream::fillUniform( float* pOut, size_t count, float min, float max )
+{
+    const float range = max - min;
+    uint32_t words[4 * kBatch];
+    while (count)
+    {
+        const size_t n = std::min<size_t>(count, 4 * kBatch);
+        fillU32(words, n);
+        if (n == 4 * kBatch)
+        {
+            for (uint32_t i = 0; i < 4 * kBatch; i += kLanes)
+            {
+                U32s w;
+                memcpy(&w, words + i, sizeof(w));
+                const F32s f = unitFloats(w, 0) * range + min;
+                memcpy(pOut + i, &f, sizeof(f));
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < n; ++i)
+                pOut[i] = (float)(words[i] >> 8) * 0x1p-24f * range + min;
+        }
+        pOut += n;
+        count -= n;
+    }
+}
+
+void Stream::fillNormal( float* pOut, size_t count, float mean, float stddev )
+{
+    // Each 8 words make 8 values: u1 from the first 4, u2 from the next 4,
+    // cosines then sines.
+    uint32_t words[4 * kBatch];
+    float values[2 * kLanes];
+    while (count)
+    {
+        fillU32(words, 4 * kBatch);
+        for (uint32_t group = 0; group < 4 * kBatch && count; group += 2 * kLanes)
+        {
+            U32s w1, w2;
+            memcpy(&w1, words + group, sizeof(w1));
+            memcpy(&w2, words + group + kLanes, sizeof(w2));
+            const F32s r = sqrtLanes(logLanes(unitFloats(w1, 1)) * -2.f) * stddev;
+            F32s s, c;
+            sinCosTurns(unitFloats(w2, 0), s, c);
+            const F32s z0 = c * r + mean;
+            const F32s z1 = s * r + mean;
+
+            if (count >= 2 * kLanes)
+            {
+                memcpy(pOut, &z0, sizeof(z0));
+                memcpy(pOut + kLanes, &z1, sizeof(z1));
+                pOut += 2 * kLanes;
+                count -= 2 * kLanes;
+            }
+            else
+            {
+                memcpy(values, &z0, sizeof(z0));
+                memcpy(values + kLanes, &z1, sizeof(z1));
+                memcpy(pOut, values, count * sizeof(float));
+                count = 0;
+            }
+        }
+    }
+}
+
+#pragma mark - Per thread
+
+Stream& threadStream()
+{
+    thread_local const uint32_t ordinal = gThreadCount.fetch_add(1, std::memory_order_relaxed);
+    thread_local uint32_t generation = ~0u;
+    thread_local Stream stream;
+
+    const uint32_t current = gThreadGeneration.load(std::memory_order_acquire);
+    if (current != generation)
+    {
+        stream = Stream(gThreadSeed.load(std::memory_order_relaxed)).split(ordinal);
+        generation = current;
+    }
+    return (stream);
+}
+
+void seedThreadStreams( uint64_t seed )
+{
+    gThreadSeed.store(seed, std::memory_order_relaxed);
+    gThreadGeneration.fetch_add(1, std::memory_order_release);
+}
+
+#pragma mark - Low discrepancy
+
+float radicalInverse( uint32_t index, uint32_t base )
+{
+    double result = 0.0;
+    double scale = 1.0 / base;
+    for (; index; index /= base, scale /= base)
+        result += (double)(index % base) * scale;
+    return (std::min((float)result, 0x1.fffffep-1f));
+}
+
+void halton( uint32_t first, size_t count, float* pX, float* pY )
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        pX[i] = radicalInverse(first + (uint32_t)i, 2);
+        pY[i] = radicalInverse(first + (uint32_t)i, 3);
+    }
+}
+
+namespace
+{
+    struct SobolDirections
+    {
+        uint32_t    v[Sobol::kMaxDimensions][32];       // direction number per index bit
+        uint32_t    flip[Sobol::kMaxDimensions][32];    // v[0] ^ .. ^ v[k]: going from n to n + 1
+
+        SobolDirections()
+        {
+            // Primitive polynomials and initial numbers from Joe and Kuo
+            // (new-joe-kuo-6.21201), dimensions 2 to 8; the first is van der Corput.
+            struct Polynomial { uint32_t s, a, m[5]; };
+            static const Polynomial kPolynomials[Sobol::kMaxDimensions - 1] =
+            {
+                { 1, 0, { 1 } },
+                { 2, 1, { 1, 3 } },
+                { 3, 1, { 1, 3, 1 } },
+                { 3, 2, { 1, 1, 1 } },
+                { 4, 1, { 1, 1, 3, 3 } },
+                { 4, 4, { 1, 3, 5, 13 } },
+                { 5, 2, { 1, 1, 5, 5, 17 } },
+            };
+
+            for (uint32_t k = 0; k < 32; ++k)
+                v[0][k] = 1u << (31 - k);
+            for (uint32_t d = 1; d < Sobol::kMaxDimensions; ++d)
+            {
+                const Polynomial& p = kPolynomials[d - 1];
+                for (uint32_t k = 0; k < 32; ++k)
+                {
+                    if (k < p.s)
+                    {
+                        v[d][k] = p.m[k] << (31 - k);
+                        continue;
+                    }
+                    uint32_t x = v[d][k - p.s] ^ (v[d][k - p.s] >> p.s);
+                    for (uint32_t l = 1; l < p.s; ++l)
+                    {
+                        if ((p.a >> (p.s - 1 - l)) & 1)
+                            x ^= v[d][k - l];
+                    }
+                    v[d][k] = x;
+                }
+            }
+            for (uint32_t d = 0; d < Sobol::kMaxDimensions; ++d)
+            {
+                flip[d][0] = v[d][0];
+                for (uint32_t k = 1; k < 32; ++k)
+                    flip[d][k] = flip[d][k - 1] ^ v[d][k];
+            }
+        }
+    };
+
+    const SobolDirections& sobolDirections()
+    {
+        static const SobolDirections directions;
+        return (directions);
+    }
+
+    inline float sobolFloat( uint32_t bits )
+    {
+        return ((float)(bits >> 8) * 0x1p-24f);
+    }
+}
+
+Sobol::Sobol( uint32_t dimensions, uint64_t scramble )
+: _dimensions( std::min(std::max(dimensions, 1u), kMaxDimensions) )
+, _shift{}
+{
+    if (scramble)
+    {
+        for (uint32_t d = 0; d < _dimensions; ++d)
+            _shift[d] = (uint32_t)splitMix64(scramble + d);
+    }
+}
+
+void Sobol::sample( uint32_t index, float* pOut ) const
+{
+    const SobolDirections& directions = sobolDirections();
+    for (uint32_t d = 0; d < _dimensions; ++d)
+    {
+        uint32_t x = _shift[d];
+        for (uint32_t bits = index, k = 0; bits; bits >>= 1, ++k)
+        {
+            if (bits & 1)
+                x ^= directions.v[d][k];
+        }
+        pOut[d] = sobolFloat(x);
+    }
+}
+
+void Sobol::fill( uint32_t first, size_t count, float* pOut ) const
+{
+    if (!count)
+        return;
+    const SobolDirections& directions = sobolDirections();
+    uint32_t x[kMaxDimensions];
+    for (uint32_t d = 0; d < _dimensions; ++d)
+    {
+        x[d] = _shift[d];
+        for (uint32_t bits = first, k = 0; bits; bits >>= 1, ++k)
+        {
+            if (bits & 1)
+                x[d] ^= directions.v[d][k];
+        }
+    }
+    for (size_t i = 0; ; ++i)
+    {
+        for (uint32_t d = 0; d < _dimensions; ++d)
+            pOut[i * _dimensions + d] = sobolFloat(x[d]);
+        if (i + 1 == count)
+            break;
+        // n -> n + 1 flips the trailing ones and the zero above them.
+        const uint32_t next = first + (uint32_t)i + 1;
+        const uint32_t k = next ? (uint32_t)__builtin_ctz(next) : 31;
+        for (uint32_t d = 0; d < _dimensions; ++d)
+            x[d] ^= directions.flip[d][k];
+    }
+}
+
+}
@@ -0,0 +1,98 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLRandom.hpp               +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 04:58:40      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLRANDOM_HPP
+# define RMDLRANDOM_HPP
+
+# include <cstddef>
+# include <cstdint>
+
+// Random numbers without shared state. A Stream is a seed, a stream id and a
+// position, and its words are Philox4x32-10 of that counter: no lock, no
+// global, and the same seed gives the same words on any thread. Streams split
+// into independent child streams, one per thread or per task, and fill arrays
+// four blocks at a time. Halton and Sobol give low-discrepancy points for
+// jitter and sampling.
+
+namespace rng
+{
+    /// Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3").
+    void        philox4x32( uint64_t key, const uint32_t counter[4], uint32_t out[4] );
+
+    class Stream
+    {
+    public:
+        explicit Stream( uint64_t seed = 0, uint64_t stream = 0 );
+
+        /// An independent stream for thread or task `index`; this one is unchanged.
+        Stream      split( uint64_t index ) const;
+
+        uint32_t    nextU32();
+        uint64_t    nextU64();
+        /// [0, 1), 24 random bits.
+        float       nextFloat();
+        float       uniform( float min, float max )     { return (min + nextFloat() * (max - min)); }
+        /// Standard normal, Box-Muller.
+        float       normal();
+
+        /// The same words, in the same order, as that many nextU32 calls.
+        void        fillU32( uint32_t* pOut, size_t count );
+        /// [min, max), from the same words as fillU32.
+        void        fillUniform( float* pOut, size_t count, float min = 0.f, float max = 1.f );
+        /// Box-Muller on four pairs at a time; its own sequence, not normal()'s.
+        void        fillNormal( float* pOut, size_t count, float mean = 0.f, float stddev = 1.f );
+
+    private:
+        void        refill();
+
+        uint64_t    _key;
+        uint64_t    _stream;
+        uint64_t    _block;
+        uint32_t    _words[4];
+        uint32_t    _used;
+        float       _spareNormal;
+        bool        _hasSpareNormal;
+    };
+
+    /// The calling thread's stream: seedThreadStreams' seed, split by the order
+    /// in which threads first asked for one.
+    Stream&     threadStream();
+    /// Restarts every thread's stream from `seed` at its next use.
+    void        seedThreadStreams( uint64_t seed );
+
+#pragma mark - Low discrepancy
+
+    /// Van der Corput in `base`: the digits of `index` mirrored around the point.
+    float       radicalInverse( uint32_t index, uint32_t base );
+    /// Halton points in bases 2 and 3, from `first`; the usual jitter sequence.
+    void        halton( uint32_t first, size_t count, float* pX, float* pY );
+
+    class Sobol
+    {
+    public:
+        static constexpr uint32_t kMaxDimensions = 8;
+
+        /// A non-zero `scramble` applies a random digital shift per dimension,
+        /// which keeps the stratification.
+        explicit Sobol( uint32_t dimensions, uint64_t scramble = 0 );
+
+        /// One point, `dimensions` floats in [0, 1).
+        void        sample( uint32_t index, float* pOut ) const;
+        /// `count` points from `first`, one after the other.
+        void        fill( uint32_t first, size_t count, float* pOut ) const;
+        uint32_t    dimensions() const      { return (_dimensions); }
+
+    private:
+        uint32_t    _dimensions;
+        uint32_t    _shift[kMaxDimensions];
+    };
+}
+
+#endif /* RMDLRANDOM_HPP */
@@ -0,0 +1,539 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLRenderGraph.cpp          +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 20:05:24      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLRenderGraph.hpp"
+#include "RMDLAliasPlanner.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace render_graph
+{
+
+bool ResourceDesc::operator==( const ResourceDesc& o ) const
+{
+    return (width == o.width && height == o.height && arrayLength == o.arrayLength &&
+            pixelFormat == o.pixelFormat && bytes == o.bytes);
+}
+
+#pragma mark - Declaration
+
+ResourceId RenderGraph::createTexture( const std::string& name, const ResourceDesc& desc )
+{
+    _resources.push_back({ name, desc, false, false });
+    return ((ResourceId)_resources.size() - 1);
+}
+
+ResourceId RenderGraph::importResource( const std::string& name, const ResourceDesc& desc )
+{
+    _resources.push_back({ name, desc, true, false });
+    return ((ResourceId)_resources.size() - 1);
+}
+
+void RenderGraph::markOutput( ResourceId resource )
+{
+    _resources[resource].output = true;
+}
+
+PassId RenderGraph::addPass( const std::string& name, PassKind kind, Execute execute )
+{
+    _passes.push_back({ name, kind, std::move(execute), false, 1.f, {} });
+    return ((PassId)_passes.size() - 1);
+}
+
+void RenderGraph::setSideEffects( PassId pass )
+{
+    _passes[pass].sideEffects = true;
+}
+
+void RenderGraph::setCost( PassId pass, float cost )
+{
+    _passes[pass].cost = cost;
+}
+
+void RenderGraph::read( PassId pass, ResourceId resource, Access access )
+{
+    _passes[pass].accesses.push_back({ resource, access, kAllSlices, false, false, {} });
+}
+
+void RenderGraph::write( PassId pass, ResourceId resource, Access access, uint32_t slice )
+{
+    _passes[pass].accesses.push_back({ resource, access, slice, true, false, {} });
+}
+
+void RenderGraph::clear( PassId pass, ResourceId resource, Access access, const float value[4], uint32_t slice )
+{
+    AccessDecl decl = { resource, access, slice, true, true, {} };
+    std::memcpy(decl.clearValue, value, sizeof(decl.clearValue));
+    _passes[pass].accesses.push_back(decl);
+}
+
+#pragma mark - Compile
+
+namespace
+{
+    struct Edge
+    {
+        uint32_t    from;
+        uint32_t    to;
+        ResourceId  resource;
+        uint32_t    fromStages;
+        uint32_t    toStages;
+        bool        data;       // `to` consumes what `from` wrote (not just ordering)
+    };
+
+    uint32_t stagesOf( PassKind kind, Access access )
+    {
+        switch (kind)
+        {
+            case PassKind::Compute:
+                return (StageDispatch);
+            case PassKind::Blit:
+                return (StageBlit);
+            case PassKind::Render:
+                break;
+        }
+        switch (access)
+        {
+            case Access::ShaderRead:
+            case Access::CopySource:
+                return (StageVertex | StageFragment);
+            default:
+                return (StageFragment);
+        }
+    }
+
+    bool isAttachment( Access access )
+    {
+        return (access == Access::ColorAttachment || access == Access::DepthAttachment);
+    }
+
+    bool overlaps( uint32_t a, uint32_t b )
+    {
+        return (a == kAllSlices || b == kAllSlices || a == b);
+    }
+
+    constexpr uint32_t kStageBits[4] = { StageVertex, StageFragment, StageDispatch, StageBlit };
+
+    /// Last execution position holding a barrier from stage a to stage b.
+    struct BarrierTracker
+    {
+        int     last[4][4];
+
+        BarrierTracker()
+        {
+            for (auto& row : last)
+                std::fill(std::begin(row), std::end(row), -1);
+        }
+
+        /// Adds to `barrier` what it takes to order `fromStages` at `fromPosition` before `toStages` now.
+        void require( int fromPosition, uint32_t fromStages, uint32_t toStages, Barrier& barrier ) const
+        {
+            for (int a = 0; a < 4; ++a)
+            {
+                if (!(fromStages & kStageBits[a]))
+                    continue;
+                for (int b = 0; b < 4; ++b)
+                {
+                    if ((toStages & kStageBits[b]) && last[a][b] <= fromPosition)
+                    {
+                        barrier.afterStages |= kStageBits[a];
+                        barrier.beforeStages |= kStageBits[b];
+                    }
+                }
+            }
+        }
+
+        void issue( int position, const Barrier& barrier )
+        {
+            for (int a = 0; a < 4; ++a)
+                for (int b = 0; b < 4; ++b)
+                    if ((barrier.afterStages & kStageBits[a]) && (barrier.beforeStages & kStageBits[b]))
+                        last[a][b] = position;
+        }
+    };
+}
+
+CompiledGraph RenderGraph::compile( const CompileOptions& options ) const
+{
+    const uint32_t passCount = (uint32_t)_passes.size();
+    const uint32_t resourceCount = (uint32_t)_resources.size();
+    CompiledGraph out;
+
+    // 1. Dependencies, from the declaration order. Writes track slices so the three
+    //    shadow cascades of one array do not serialise on each other.
+    struct Writer { uint32_t slice, pass, stages; };
+    struct Reader { uint32_t pass, stages; };
+    struct Track
+    {
+        std::vector<Writer> writers;
+        std::vector<Reader> readers;
+    };
+    std::vector<Track> tracks(resourceCount);
+    std::vector<Edge> edges;
+    std::vector<std::vector<bool>> hasPrior(passCount);
+
+    for (uint32_t p = 0; p < passCount; ++p)
+    {
+        const Pass& pass = _passes[p];
+        hasPrior[p].assign(pass.accesses.size(), false);
+        for (size_t a = 0; a < pass.accesses.size(); ++a)
+        {
+            const AccessDecl& decl = pass.accesses[a];
+            Track& track = tracks[decl.resource];
+            const uint32_t stages = stagesOf(pass.kind, decl.access);
+            if (!decl.write)
+            {
+                for (const Writer& w : track.writers)
+                    if (w.pass != p)
+                        edges.push_back({ w.pass, p, decl.resource, w.stages, stages, true });
+                track.readers.push_back({ p, stages });
+                continue;
+            }
+
+            for (const Writer& w : track.writers)
+            {
+                if (w.pass != p && overlaps(w.slice, decl.slice))
+                {
+                    edges.push_back({ w.pass, p, decl.resource, w.stages, stages, !decl.clear });
+                    hasPrior[p][a] = true;
+                }
+            }
+            for (const Reader& r : track.readers)
+                if (r.pass != p)
+                    edges.push_back({ r.pass, p, decl.resource, r.stages, stages, false });
+
+            track.writers.erase(std::remove_if(track.writers.begin(), track.writers.end(), [&decl]( const Writer& w ) {
+                return (decl.slice == kAllSlices || w.slice == decl.slice);
+            }), track.writers.end());
+            track.writers.push_back({ decl.slice, p, stages });
+            if (decl.slice == kAllSlices)
+                track.readers.clear();
+        }
+    }
+
+    std::vector<std::vector<uint32_t>> incoming(passCount), outgoing(passCount);
+    for (uint32_t e = 0; e < (uint32_t)edges.size(); ++e)
+    {
+        incoming[edges[e].to].push_back(e);
+        outgoing[edges[e].from].push_back(e);
+    }
+
+    // 2. Culling: keep what reaches a side effect or an output through data edges.
+    std::vector<bool> needed(passCount, !options.cull);
+    if (options.cull)
+    {
+        for (uint32_t p = passCount; p-- > 0; )
+        {
+            const Pass& pass = _passes[p];
+            if (!needed[p])
+            {
+                needed[p] = pass.sideEffects;
+                for (const AccessDecl& decl : pass.accesses)
+                {
+                    const Resource& res = _resources[decl.resource];
+                    if (decl.write && (res.imported || res.output))
+                        needed[p] = true;
+                }
+            }
+            if (!needed[p])
+                continue;
+            for (uint32_t e : incoming[p])
+                if (edges[e].data)
+                    needed[edges[e].from] = true;
+        }
+    }
+
+    // A culled pass can be the only link ordering two kept ones (read, culled clear,
+    // write): its own dependencies are inherited by whoever depended on it.
+    struct Dep { uint32_t from, fromStages, toStages; };
+    std::vector<std::vector<Dep>> deps(passCount);
+    for (uint32_t p = 0; p < passCount; ++p)
+    {
+        std::vector<Dep>& list = deps[p];
+        for (uint32_t e : incoming[p])
+        {
+            const Edge& edge = edges[e];
+            if (needed[edge.from])
+                list.push_back({ edge.from, edge.fromStages, edge.toStages });
+            else
+                for (const Dep& inherited : deps[edge.from])
+                    list.push_back({ inherited.from, inherited.fromStages, needed[p] ? edge.toStages : inherited.toStages });
+        }
+        std::sort(list.begin(), list.end(), []( const Dep& a, const Dep& b ) {
+            return (a.from != b.from ? a.from < b.from : a.fromStages != b.fromStages ? a.fromStages < b.fromStages : a.toStages < b.toStages);
+        });
+        list.erase(std::unique(list.begin(), list.end(), []( const Dep& a, const Dep& b ) {
+            return (a.from == b.from && a.fromStages == b.fromStages && a.toStages == b.toStages);
+        }), list.end());
+    }
+
+    // 3. Levels and execution order. Every dependency goes to a higher level, so sorting
+    //    by level keeps the order valid and puts independent passes side by side.
+    std::vector<uint32_t> level(passCount, 0);
+    std::vector<uint32_t> order;
+    for (uint32_t p = 0; p < passCount; ++p)
+    {
+        if (!needed[p])
+        {
+            ++out.culledPasses;
+            continue;
+        }
+        for (const Dep& dep : deps[p])
+            level[p] = std::max(level[p], level[dep.from] + 1);
+        order.push_back(p);
+    }
+    if (options.reorder)
+    {
+        std::stable_sort(order.begin(), order.end(), [&level]( uint32_t a, uint32_t b ) { return (level[a] < level[b]); });
+    }
+    std::vector<int> position(passCount, -1);
+    for (uint32_t i = 0; i < (uint32_t)order.size(); ++i)
+        position[order[i]] = (int)i;
+
+    // 4. Lifetimes of transient resources, then greedy interval colouring onto
+    //    physical resources with an identical description.
+    struct Lifetime { int first = -1, last = -1; uint32_t firstStages = 0, lastStages = 0; bool memoryless = true; };
+    std::vector<Lifetime> life(resourceCount);
+    for (uint32_t p : order)
+    {
+        const int i = position[p];
+        for (const AccessDecl& decl : _passes[p].accesses)
+        {
+            Lifetime& l = life[decl.resource];
+            const uint32_t stages = stagesOf(_passes[p].kind, decl.access);
+            if (l.first < 0)
+            {
+                l.first = i;
+                l.firstStages = 0;
+            }
+            if (l.first == i)
+                l.firstStages |= stages;
+            if (l.last != i)
+                l.lastStages = 0;
+            l.last = std::max(l.last, i);
+            l.lastStages |= stages;
+            if (!isAttachment(decl.access))
+                l.memoryless = false;
+        }
+    }
+
+    std::vector<ResourceId> byStart;
+    for (ResourceId r = 0; r < resourceCount; ++r)
+        if (!_resources[r].imported && !_resources[r].output && life[r].first >= 0)
+            byStart.push_back(r);
+    std::sort(byStart.begin(), byStart.end(), [&life]( ResourceId a, ResourceId b ) { return (life[a].first < life[b].first); });
+
+    struct Slot { int lastEnd; uint32_t lastStages; };
+    std::vector<Slot> slots;
+    struct AliasStart { int position; int prevEnd; uint32_t prevStages; uint32_t stages; };
+    std::vector<AliasStart> aliasStarts;
+    out.physicalOf.assign(resourceCount, kAllSlices);
+    for (ResourceId r : byStart)
+    {
+        int best = -1;
+        for (int s = 0; s < (int)slots.size(); ++s)
+        {
+            if (out.physical[s] == _resources[r].desc && slots[s].lastEnd < life[r].first &&
+                (best < 0 || slots[s].lastEnd > slots[best].lastEnd))
+                best = s;
+        }
+        if (best < 0)
+        {
+            best = (int)slots.size();
+            slots.push_back({ -1, 0 });
+            out.physical.push_back(_resources[r].desc);
+        }
+        else
+        {
+            aliasStarts.push_back({ life[r].first, slots[best].lastEnd, slots[best].lastStages, life[r].firstStages });
+        }
+        slots[best] = { life[r].last, life[r].lastStages };
+        out.physicalOf[r] = (uint32_t)best;
+    }
+    // Outputs are allocated but never share.
+    for (ResourceId r = 0; r < resourceCount; ++r)
+    {
+        if (!_resources[r].imported && _resources[r].output && life[r].first >= 0)
+        {
+            out.physicalOf[r] = (uint32_t)out.physical.size();
+            out.physical.push_back(_resources[r].desc);
+            life[r].memoryless = false;
+        }
+    }
+
+    // 5. Attachment actions, walking the execution order. They also settle which
+    //    physical textures can live in tile memory only.
+    out.passes.reserve(order.size());
+    for (uint32_t p : order)
+    {
+        const Pass& pass = _passes[p];
+        CompiledPass compiled;
+        compiled.pass = p;
+        compiled.level = level[p];
+        compiled.batch = 0;
+
+        for (size_t a = 0; a < pass.accesses.size(); ++a)
+        {
+            const AccessDecl& decl = pass.accesses[a];
+            if (pass.kind != PassKind::Render || !isAttachment(decl.access))
+                continue;
+            const Resource& res = _resources[decl.resource];
+
+            AttachmentOps ops;
+            ops.resource = decl.resource;
+            ops.slice = decl.slice;
+            ops.access = decl.access;
+            std::memcpy(ops.clearValue, decl.clearValue, sizeof(ops.clearValue));
+            if (decl.clear)
+                ops.load = LoadAction::Clear;
+            else if (hasPrior[p][a] || res.imported)
+                ops.load = LoadAction::Load;
+            else
+                ops.load = LoadAction::DontCare;
+
+            ops.store = (res.imported || res.output) ? StoreAction::Store : StoreAction::DontCare;
+            for (uint32_t e : outgoing[p])
+            {
+                const Edge& edge = edges[e];
+                if (edge.resource == decl.resource && edge.data && needed[edge.to])
+                    ops.store = StoreAction::Store;
+            }
+            if (!decl.write && ops.load == LoadAction::DontCare)
+                ops.load = LoadAction::Load;    // attachment only read (depth test against earlier depth)
+
+            if (ops.load == LoadAction::Load || ops.store == StoreAction::Store)
+                life[decl.resource].memoryless = false;
+            compiled.attachments.push_back(ops);
+        }
+        out.passes.push_back(std::move(compiled));
+    }
+
+    out.memoryless.assign(out.physical.size(), true);
+    for (ResourceId r = 0; r < resourceCount; ++r)
+    {
+        if (out.physicalOf[r] != kAllSlices && (!life[r].memoryless || _resources[r].desc.pixelFormat == 0))
+            out.memoryless[out.physicalOf[r]] = false;
+    }
+
+    // 6. Heap placement: physical resources never alive together share bytes, whatever
+    //    their description. Each one whose bytes were someone else's needs an alias barrier.
+    out.heapOffset.assign(out.physical.size(), kNotOnHeap);
+    if (options.heapSizeAndAlign)
+    {
+        const uint32_t physicalCount = (uint32_t)out.physical.size();
+        std::vector<Lifetime> slotLife(physicalCount);
+        for (ResourceId r = 0; r < resourceCount; ++r)
+        {
+            const uint32_t s = out.physicalOf[r];
+            if (s == kAllSlices)
+                continue;
+            Lifetime& l = slotLife[s];
+            if (l.first < 0 || life[r].first < l.first)
+            {
+                l.first = life[r].first;
+                l.firstStages = life[r].firstStages;
+            }
+            // Outputs are read after the graph: nothing may take their bytes.
+            const int last = _resources[r].output ? (int)order.size() : life[r].last;
+            if (last > l.last)
+            {
+                l.last = last;
+                l.lastStages = life[r].lastStages;
+            }
+        }
+
+        std::vector<alias_planner::Allocation> allocations;
+        std::vector<uint32_t> slotOf;
+        for (uint32_t s = 0; s < physicalCount; ++s)
+        {
+            if (out.memoryless[s] || slotLife[s].first < 0)
+                continue;
+            uint64_t size = 0, alignment = 1;
+            options.heapSizeAndAlign(out.physical[s], size, alignment);
+            allocations.push_back({ (uint32_t)slotLife[s].first, (uint32_t)slotLife[s].last, size, alignment });
+            slotOf.push_back(s);
+        }
+        const alias_planner::Plan plan = alias_planner::plan(allocations);
+        out.heapSize = plan.heapSize;
+        out.heapSavedBytes = plan.saved();
+        for (size_t i = 0; i < allocations.size(); ++i)
+        {
+            const alias_planner::Allocation& next = allocations[i];
+            out.heapOffset[slotOf[i]] = plan.offsets[i];
+            for (size_t j = 0; j < allocations.size(); ++j)
+            {
+                const alias_planner::Allocation& prev = allocations[j];
+                if (prev.last < next.first &&
+                    plan.offsets[j] < plan.offsets[i] + next.size && plan.offsets[i] < plan.offsets[j] + prev.size)
+                {
+                    aliasStarts.push_back({ (int)next.first, (int)prev.last, slotLife[slotOf[j]].lastStages, slotLife[slotOf[i]].firstStages });
+                }
+            }
+        }
+    }
+
+    // 7. Barriers, walking the execution order.
+    BarrierTracker tracker;
+    std::sort(aliasStarts.begin(), aliasStarts.end(), []( const AliasStart& a, const AliasStart& b ) { return (a.position < b.position); });
+    size_t nextAlias = 0;
+    for (int i = 0; i < (int)out.passes.size(); ++i)
+    {
+        CompiledPass& compiled = out.passes[i];
+        const uint32_t p = compiled.pass;
+
+        for (const Dep& dep : deps[p])
+            tracker.require(position[dep.from], dep.fromStages, dep.toStages, compiled.barrier);
+        for (; nextAlias < aliasStarts.size() && aliasStarts[nextAlias].position == i; ++nextAlias)
+        {
+            const AliasStart& alias = aliasStarts[nextAlias];
+            compiled.barrier.resourceAlias = true;
+            tracker.require(alias.prevEnd, alias.prevStages, alias.stages, compiled.barrier);
+            if (compiled.barrier.afterStages == 0)
+            {
+                // Already ordered, but the alias visibility still has to be requested.
+                compiled.barrier.afterStages = alias.prevStages;
+                compiled.barrier.beforeStages = alias.stages;
+            }
+        }
+        if (compiled.barrier.afterStages)
+        {
+            tracker.issue(i, compiled.barrier);
+            ++out.barrierCount;
+        }
+    }
+
+    // 8. Recording batches: contiguous runs of roughly equal cost.
+    const uint32_t executed = (uint32_t)out.passes.size();
+    const uint32_t batchCount = std::max(1u, std::min(options.maxBatches, executed));
+    float total = 0.f;
+    for (const CompiledPass& cp : out.passes)
+        total += _passes[cp.pass].cost;
+    float accumulated = 0.f;
+    uint32_t begin = 0;
+    for (uint32_t i = 0; i < executed; ++i)
+    {
+        accumulated += _passes[out.passes[i].pass].cost;
+        const uint32_t batch = (uint32_t)out.batches.size();
+        const uint32_t remainingPasses = executed - i - 1;
+        const uint32_t remainingBatches = batchCount - batch - 1;
+        const bool full = accumulated >= total * (float)(batch + 1) / (float)batchCount;
+        if (i + 1 == executed || (remainingBatches > 0 && (full || remainingPasses == remainingBatches)))
+        {
+            for (uint32_t k = begin; k <= i; ++k)
+                out.passes[k].batch = batch;
+            out.batches.push_back({ begin, i + 1 });
+            begin = i + 1;
+        }
+    }
+    return (out);
+}
+
+}
@@ -0,0 +1,225 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLRenderGraph.hpp          +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 20:05:17      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLRENDERGRAPH_HPP
+# define RMDLRENDERGRAPH_HPP
+
+# include <cstdint>
+# include <functional>
+# include <string>
+# include <vector>
+
+// Declarative frame description. Passes are declared in the order a single
+// thread would run them, each listing what it reads and writes; compile()
+// turns that into an execution order with culled passes removed, one merged
+// barrier per pass, attachment load/store actions, physical textures shared
+// by resources whose lifetimes do not overlap, and recording batches.
+// Pure CPU; RMDLRenderGraphExecutor records the result with Metal 4.
+
+namespace render_graph
+{
+    using ResourceId = uint32_t;
+    using PassId = uint32_t;
+
+    constexpr uint32_t kAllSlices = ~0u;
+    constexpr uint64_t kNotOnHeap = ~0ull;
+
+    /// Bit values match MTL::Stages so they can be passed straight to barriers.
+    enum Stage : uint32_t
+    {
+        StageVertex     = 1u << 0,
+        StageFragment   = 1u << 1,
+        StageDispatch   = 1u << 27,
+        StageBlit       = 1u << 28
+    };
+
+    enum class PassKind : uint32_t
+    {
+        Render,
+        Compute,
+        Blit
+    };
+
+    enum class Access : uint32_t
+    {
+        ColorAttachment,
+        DepthAttachment,
+        ShaderRead,
+        ShaderWrite,
+        CopySource,
+        CopyDestination
+    };
+
+    enum class LoadAction : uint32_t
+    {
+        DontCare,
+        Load,
+        Clear
+    };
+
+    enum class StoreAction : uint32_t
+    {
+        DontCare,
+        Store
+    };
+
+    /// Pixel formats are raw MTL::PixelFormat values. Buffers use `bytes` only.
+    struct ResourceDesc
+    {
+        uint32_t    width       = 0;
+        uint32_t    height      = 0;
+        uint32_t    arrayLength = 1;
+        uint32_t    pixelFormat = 0;
+        uint64_t    bytes       = 0;
+
+        bool        operator==( const ResourceDesc& o ) const;
+    };
+
+    struct AttachmentOps
+    {
+        ResourceId      resource;
+        uint32_t        slice;          // kAllSlices = slice 0 of a single-slice texture
+        Access          access;
+        LoadAction      load;
+        StoreAction     store;
+        float           clearValue[4];  // colour, or depth in [0]
+    };
+
+    struct Barrier
+    {
+        uint32_t        afterStages     = 0;    // 0: no barrier
+        uint32_t        beforeStages    = 0;
+        bool            resourceAlias   = false;    // a physical texture changes owner
+    };
+
+    struct CompiledPass
+    {
+        PassId                      pass;
+        uint32_t                    level;      // longest dependency chain leading to it
+        uint32_t                    batch;
+        Barrier                     barrier;    // issued before the pass
+        std::vector<AttachmentOps>  attachments;
+    };
+
+    struct CompiledGraph
+    {
+        struct Batch
+        {
+            uint32_t    begin;      // into `passes`
+            uint32_t    end;
+        };
+
+        std::vector<CompiledPass>   passes;         // execution order
+        std::vector<Batch>          batches;
+        std::vector<ResourceDesc>   physical;       // one entry per physical resource to allocate
+        std::vector<bool>           memoryless;     // per physical: never stored, never sampled
+        std::vector<uint32_t>       physicalOf;     // per resource; kAllSlices for imported / unused
+        std::vector<uint64_t>       heapOffset;     // per physical; kNotOnHeap unless placed
+        uint64_t                    heapSize        = 0;
+        uint64_t                    heapSavedBytes  = 0;    // versus one allocation per physical resource
+        uint32_t                    culledPasses    = 0;
+        uint32_t                    barrierCount    = 0;
+    };
+
+    struct CompileOptions
+    {
+        uint32_t    maxBatches      = 1;    // command buffers recorded in parallel
+        bool        cull            = true;
+        bool        reorder         = true; // group independent passes by dependency level
+        /// When set, non-memoryless physical resources are packed into one placement heap
+        /// (RMDLAliasPlanner). Reports the byte size and alignment of a description.
+        std::function<void( const ResourceDesc& desc, uint64_t& size, uint64_t& alignment )> heapSizeAndAlign;
+    };
+
+    class RenderGraph;
+
+    /// What a pass callback sees while it records.
+    struct PassContext
+    {
+        const RenderGraph*      pGraph;
+        const CompiledPass*     pPass;
+        void*                   pEncoder;
+        void* const*            pResources;     // native object per ResourceId
+
+        template< typename T >
+        T*      encoder() const                     { return (static_cast<T*>(pEncoder)); }
+        template< typename T >
+        T*      resource( ResourceId id ) const     { return (static_cast<T*>(pResources[id])); }
+    };
+
+    class RenderGraph
+    {
+    public:
+        using Execute = std::function<void( const PassContext& context )>;
+
+        /// Transient: allocated (and possibly aliased) by the graph.
+        ResourceId      createTexture( const std::string& name, const ResourceDesc& desc );
+        /// External, e.g. the drawable or a persistent buffer; never aliased, contents kept.
+        ResourceId      importResource( const std::string& name, const ResourceDesc& desc );
+        /// Keeps the passes writing `resource` even if nothing in the graph reads it.
+        void            markOutput( ResourceId resource );
+
+        PassId          addPass( const std::string& name, PassKind kind, Execute execute = {} );
+        /// Never culled (readbacks, presentation, writes to CPU-visible memory).
+        void            setSideEffects( PassId pass );
+        /// Relative recording cost, used to balance batches.
+        void            setCost( PassId pass, float cost );
+
+        void            read( PassId pass, ResourceId resource, Access access = Access::ShaderRead );
+        void            write( PassId pass, ResourceId resource, Access access, uint32_t slice = kAllSlices );
+        /// Attachment write that starts from a clear instead of the previous contents.
+        void            clear( PassId pass, ResourceId resource, Access access, const float value[4], uint32_t slice = kAllSlices );
+
+        CompiledGraph   compile( const CompileOptions& options = {} ) const;
+
+        uint32_t            passCount() const       { return ((uint32_t)_passes.size()); }
+        uint32_t            resourceCount() const   { return ((uint32_t)_resources.size()); }
+        const std::string&  passName( PassId pass ) const           { return (_passes[pass].name); }
+        PassKind            passKind( PassId pass ) const           { return (_passes[pass].kind); }
+        const Execute&      passExecute( PassId pass ) const        { return (_passes[pass].execute); }
+        const std::string&  resourceName( ResourceId id ) const     { return (_resources[id].name); }
+        const ResourceDesc& resourceDesc( ResourceId id ) const     { return (_resources[id].desc); }
+        bool                isImported( ResourceId id ) const       { return (_resources[id].imported); }
+
+    private:
+        struct Resource
+        {
+            std::string     name;
+            ResourceDesc    desc;
+            bool            imported;
+            bool            output;
+        };
+
+        struct AccessDecl
+        {
+            ResourceId      resource;
+            Access          access;
+            uint32_t        slice;
+            bool            write;
+            bool            clear;
+            float           clearValue[4];
+        };
+
+        struct Pass
+        {
+            std::string             name;
+            PassKind                kind;
+            Execute                 execute;
+            bool                    sideEffects;
+            float                   cost;
+            std::vector<AccessDecl> accesses;
+        };
+
+        std::vector<Resource>   _resources;
+        std::vector<Pass>       _passes;
+    };
+}
+
+#endif /* RMDLRENDERGRAPH_HPP */
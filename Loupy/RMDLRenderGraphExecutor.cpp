@@ -0,0 +1,258 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLRenderGraphExecutor.cpp  +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 20:48:09      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLRenderGraphExecutor.hpp"
+
+using namespace render_graph;
+
+RenderGraphExecutor::RenderGraphExecutor( MTL::Device* pDevice, uint32_t framesInFlight )
+: _pDevice( pDevice->retain() )
+, _frames( framesInFlight )
+{
+    NS::SharedPtr<MTL::ResidencySetDescriptor> pResidencyDesc = NS::TransferPtr( MTL::ResidencySetDescriptor::alloc()->init() );
+    NS::Error* pError = nullptr;
+    _pResidencySet = _pDevice->newResidencySet( pResidencyDesc.get(), &pError );
+    _pResidencySet->requestResidency();
+}
+
+RenderGraphExecutor::~RenderGraphExecutor()
+{
+    for (Frame& frame : _frames)
+    {
+        for (MTL::Texture* pTexture : frame.physical)
+        {
+            if (pTexture)
+                pTexture->release();
+        }
+        if (frame.pHeap)
+            frame.pHeap->release();
+    }
+    _pResidencySet->release();
+    _pDevice->release();
+}
+
+static MTL::TextureDescriptor* newTextureDescriptor( const ResourceDesc& desc, bool memoryless )
+{
+    MTL::TextureDescriptor* pTextureDesc = MTL::TextureDescriptor::alloc()->init();
+    pTextureDesc->setTextureType( desc.arrayLength > 1 ? MTL::TextureType2DArray : MTL::TextureType2D );
+    pTextureDesc->setPixelFormat( (MTL::PixelFormat)desc.pixelFormat );
+    pTextureDesc->setWidth( desc.width );
+    pTextureDesc->setHeight( desc.height );
+    pTextureDesc->setArrayLength( desc.arrayLength );
+    if (memoryless)
+    {
+        // Lives in tile memory only: never loaded, stored or sampled.
+        pTextureDesc->setStorageMode( MTL::StorageModeMemoryless );
+        pTextureDesc->setUsage( MTL::TextureUsageRenderTarget );
+    }
+    else
+    {
+        pTextureDesc->setStorageMode( MTL::StorageModePrivate );
+        pTextureDesc->setUsage( MTL::TextureUsageRenderTarget | MTL::TextureUsageShaderRead );
+    }
+    return (pTextureDesc);
+}
+
+std::function<void( const ResourceDesc&, uint64_t&, uint64_t& )> RenderGraphExecutor::heapSizeAndAlign() const
+{
+    MTL::Device* pDevice = _pDevice;
+    return ([pDevice]( const ResourceDesc& desc, uint64_t& size, uint64_t& alignment ) {
+        NS::SharedPtr<MTL::TextureDescriptor> pTextureDesc = NS::TransferPtr( newTextureDescriptor(desc, false) );
+        const MTL::SizeAndAlign sizeAndAlign = pDevice->heapTextureSizeAndAlign( pTextureDesc.get() );
+        size = sizeAndAlign.size;
+        alignment = sizeAndAlign.align;
+    });
+}
+
+void RenderGraphExecutor::bindImported( ResourceId resource, NS::Object* pObject )
+{
+    if (_imported.size() <= resource)
+        _imported.resize(resource + 1, nullptr);
+    _imported[resource] = pObject;
+}
+
+MTL::Texture* RenderGraphExecutor::texture( ResourceId resource ) const
+{
+    return (resource < _resources.size() ? static_cast<MTL::Texture*>(_resources[resource]) : nullptr);
+}
+
+void RenderGraphExecutor::realize( const RenderGraph& graph, const CompiledGraph& compiled, Frame& frame )
+{
+    // Physical textures survive until their frame comes round again; only slots
+    // whose description or placement changed are recreated. A heap that became
+    // too small is replaced along with everything placed on it.
+    bool changed = false;
+    const bool newHeap = compiled.heapSize > 0 && (!frame.pHeap || frame.pHeap->size() < compiled.heapSize);
+    if (newHeap)
+    {
+        for (size_t i = 0; i < frame.physical.size(); ++i)
+        {
+            if (frame.physical[i] && frame.physicalOffsets[i] != kNotOnHeap)
+            {
+                frame.physical[i]->release();
+                frame.physical[i] = nullptr;
+            }
+        }
+        if (frame.pHeap)
+            frame.pHeap->release();
+
+        NS::SharedPtr<MTL::HeapDescriptor> pHeapDesc = NS::TransferPtr( MTL::HeapDescriptor::alloc()->init() );
+        pHeapDesc->setType( MTL::HeapTypePlacement );
+        pHeapDesc->setStorageMode( MTL::StorageModePrivate );
+        pHeapDesc->setHazardTrackingMode( MTL::HazardTrackingModeUntracked );
+        pHeapDesc->setSize( compiled.heapSize );
+        frame.pHeap = _pDevice->newHeap( pHeapDesc.get() );
+        frame.pHeap->setLabel( MTLSTR("Render graph transients") );
+        changed = true;
+    }
+
+    for (size_t i = compiled.physical.size(); i < frame.physical.size(); ++i)
+    {
+        if (frame.physical[i])
+            frame.physical[i]->release();
+    }
+    changed |= frame.physical.size() != compiled.physical.size();
+    frame.physical.resize(compiled.physical.size(), nullptr);
+    frame.physicalDescs.resize(compiled.physical.size());
+    frame.physicalMemoryless.resize(compiled.physical.size(), false);
+    frame.physicalOffsets.resize(compiled.physical.size(), kNotOnHeap);
+
+    for (size_t i = 0; i < compiled.physical.size(); ++i)
+    {
+        const ResourceDesc& desc = compiled.physical[i];
+        const uint64_t offset = i < compiled.heapOffset.size() ? compiled.heapOffset[i] : kNotOnHeap;
+        if (frame.physical[i] && frame.physicalDescs[i] == desc && frame.physicalMemoryless[i] == compiled.memoryless[i] && frame.physicalOffsets[i] == offset)
+            continue;
+        if (frame.physical[i])
+            frame.physical[i]->release();
+
+        NS::SharedPtr<MTL::TextureDescriptor> pTextureDesc = NS::TransferPtr( newTextureDescriptor(desc, compiled.memoryless[i]) );
+        if (offset != kNotOnHeap)
+            frame.physical[i] = frame.pHeap->newTexture( pTextureDesc.get(), offset );
+        else
+            frame.physical[i] = _pDevice->newTexture( pTextureDesc.get() );
+        frame.physicalDescs[i] = desc;
+        frame.physicalMemoryless[i] = compiled.memoryless[i];
+        frame.physicalOffsets[i] = offset;
+        changed = true;
+    }
+    if (changed)
+        updateResidency();
+
+    _resources.assign(graph.resourceCount(), nullptr);
+    for (ResourceId r = 0; r < graph.resourceCount(); ++r)
+    {
+        if (graph.isImported(r))
+            _resources[r] = r < _imported.size() ? _imported[r] : nullptr;
+        else if (compiled.physicalOf[r] != kAllSlices)
+            _resources[r] = frame.physical[compiled.physicalOf[r]];
+    }
+}
+
+void RenderGraphExecutor::updateResidency()
+{
+    _pResidencySet->removeAllAllocations();
+    for (const Frame& frame : _frames)
+    {
+        if (frame.pHeap)
+            _pResidencySet->addAllocation( frame.pHeap );
+        for (size_t i = 0; i < frame.physical.size(); ++i)
+        {
+            if (frame.physicalOffsets[i] == kNotOnHeap && !frame.physicalMemoryless[i])
+                _pResidencySet->addAllocation( frame.physical[i] );
+        }
+    }
+    _pResidencySet->commit();
+}
+
+MTL4::RenderPassDescriptor* RenderGraphExecutor::newRenderPassDescriptor( const CompiledPass& pass ) const
+{
+    MTL4::RenderPassDescriptor* pDesc = MTL4::RenderPassDescriptor::alloc()->init();
+    NS::UInteger colorIndex = 0;
+    for (const AttachmentOps& ops : pass.attachments)
+    {
+        MTL::RenderPassAttachmentDescriptor* pAttachment = nullptr;
+        if (ops.access == Access::DepthAttachment)
+        {
+            MTL::RenderPassDepthAttachmentDescriptor* pDepth = pDesc->depthAttachment();
+            pDepth->setClearDepth( ops.clearValue[0] );
+            pAttachment = pDepth;
+        }
+        else
+        {
+            MTL::RenderPassColorAttachmentDescriptor* pColor = pDesc->colorAttachments()->object(colorIndex++);
+            pColor->setClearColor( MTL::ClearColor( ops.clearValue[0], ops.clearValue[1], ops.clearValue[2], ops.clearValue[3] ) );
+            pAttachment = pColor;
+        }
+        pAttachment->setTexture( static_cast<MTL::Texture*>(_resources[ops.resource]) );
+        pAttachment->setSlice( ops.slice == kAllSlices ? 0 : ops.slice );
+        pAttachment->setLoadAction( ops.load == LoadAction::Clear ? MTL::LoadActionClear
+                                  : ops.load == LoadAction::Load ? MTL::LoadActionLoad : MTL::LoadActionDontCare );
+        pAttachment->setStoreAction( ops.store == StoreAction::Store ? MTL::StoreActionStore : MTL::StoreActionDontCare );
+    }
+    return (pDesc);
+}
+
+void RenderGraphExecutor::recordBatch( const RenderGraph& graph, const CompiledGraph& compiled,
+                                       const CompiledGraph::Batch& batch, MTL4::CommandBuffer* pCommandBuffer ) const
+{
+    // Runs on a worker thread, which has no autorelease pool of its own.
+    NS::AutoreleasePool* pPool = NS::AutoreleasePool::alloc()->init();
+    for (uint32_t i = batch.begin; i < batch.end; ++i)
+    {
+        const CompiledPass& pass = compiled.passes[i];
+        MTL4::CommandEncoder* pEncoder = nullptr;
+        if (graph.passKind(pass.pass) == PassKind::Render)
+        {
+            MTL4::RenderPassDescriptor* pPassDesc = newRenderPassDescriptor(pass);
+            pEncoder = pCommandBuffer->renderCommandEncoder(pPassDesc);
+            pPassDesc->release();
+        }
+        else
+        {
+            // Metal 4 folds blits into the compute encoder.
+            pEncoder = pCommandBuffer->computeCommandEncoder();
+        }
+        pEncoder->setLabel( NS::String::string( graph.passName(pass.pass).c_str(), NS::UTF8StringEncoding ) );
+
+        if (pass.barrier.afterStages)
+        {
+            pEncoder->barrierAfterQueueStages( (MTL::Stages)pass.barrier.afterStages, (MTL::Stages)pass.barrier.beforeStages,
+                                               pass.barrier.resourceAlias ? MTL4::VisibilityOptionResourceAlias : MTL4::VisibilityOptionDevice );
+        }
+
+        if (const RenderGraph::Execute& execute = graph.passExecute(pass.pass))
+        {
+            const PassContext context = { &graph, &pass, pEncoder, _resources.data() };
+            execute(context);
+        }
+        pEncoder->endEncoding();
+    }
+    pPool->release();
+}
+
+void RenderGraphExecutor::record( const RenderGraph& graph, const CompiledGraph& compiled,
+                                  command_recording::ParallelRecorder& recorder, uint64_t frameIndex )
+{
+    realize(graph, compiled, _frames[frameIndex % _frames.size()]);
+
+    // Barriers act on earlier work in the queue, so batches commit in order.
+    std::vector<command_recording::RecordJob> jobs(compiled.batches.size());
+    for (uint32_t b = 0; b < (uint32_t)jobs.size(); ++b)
+    {
+        const CompiledGraph::Batch& batch = compiled.batches[b];
+        jobs[b].record = [this, &graph, &compiled, &batch]( void* pCommandBuffer ) {
+            recordBatch(graph, compiled, batch, static_cast<MTL4::CommandBuffer*>(pCommandBuffer));
+        };
+        if (b > 0)
+            jobs[b].after.push_back(b - 1);
+    }
+    recorder.record(jobs);
+}
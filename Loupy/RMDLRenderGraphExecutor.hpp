@@ -0,0 +1,76 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLRenderGraphExecutor.hpp  +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 20:48:02      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLRENDERGRAPHEXECUTOR_HPP
+# define RMDLRENDERGRAPHEXECUTOR_HPP
+
+# include <Metal/Metal.hpp>
+
+# include <functional>
+# include <vector>
+
+# include "RMDLRenderGraph.hpp"
+# include "RMDLCommandRecorder.hpp"
+# include "NonCopyable.h"
+
+/// Records a render_graph::CompiledGraph with Metal 4: owns the physical textures
+/// (placed on one aliasing heap when the graph was compiled with heapSizeAndAlign()),
+/// builds each render pass descriptor from the compiled load/store actions, issues
+/// the compiled barriers and hands every pass its encoder.
+/// The compiled barriers only order passes within a frame, so every frame in
+/// flight gets its own textures and heap.
+class RenderGraphExecutor : public NonCopyable
+{
+public:
+    RenderGraphExecutor( MTL::Device* pDevice, uint32_t framesInFlight );
+    ~RenderGraphExecutor();
+
+    /// Native object (texture or buffer) behind an imported resource, for the next record().
+    void            bindImported( render_graph::ResourceId resource, NS::Object* pObject );
+
+    /// One command buffer per compiled batch. Batches are recorded concurrently by
+    /// `recorder` and committed in order as they complete; pass callbacks of different
+    /// batches may therefore run at the same time. The GPU must be done with what was
+    /// recorded `framesInFlight` frames before `frameIndex`.
+    void            record( const render_graph::RenderGraph& graph, const render_graph::CompiledGraph& compiled,
+                            command_recording::ParallelRecorder& recorder, uint64_t frameIndex );
+
+    MTL::Texture*   texture( render_graph::ResourceId resource ) const;
+
+    /// For render_graph::CompileOptions::heapSizeAndAlign: the device's placement size.
+    std::function<void( const render_graph::ResourceDesc&, uint64_t&, uint64_t& )> heapSizeAndAlign() const;
+    /// Holds the heaps and the textures outside them; add it to the command queue once.
+    MTL::ResidencySet*  residencySet() const    { return (_pResidencySet); }
+
+private:
+    /// Physical resources of one frame in flight.
+    struct Frame
+    {
+        std::vector<MTL::Texture*>              physical;
+        std::vector<render_graph::ResourceDesc> physicalDescs;
+        std::vector<bool>                       physicalMemoryless;
+        std::vector<uint64_t>                   physicalOffsets;
+        MTL::Heap*                              pHeap = nullptr;
+    };
+
+    void            realize( const render_graph::RenderGraph& graph, const render_graph::CompiledGraph& compiled, Frame& frame );
+    void            updateResidency();
+    MTL4::RenderPassDescriptor* newRenderPassDescriptor( const render_graph::CompiledPass& pass ) const;
+    void            recordBatch( const render_graph::RenderGraph& graph, const render_graph::CompiledGraph& compiled,
+                                 const render_graph::CompiledGraph::Batch& batch, MTL4::CommandBuffer* pCommandBuffer ) const;
+
+    MTL::Device*                                _pDevice;
+    std::vector<Frame>                          _frames;
+    MTL::ResidencySet*                          _pResidencySet;
+    std::vector<NS::Object*>                    _imported;
+    std::vector<void*>                          _resources;     // per ResourceId in the current frame, for PassContext
+};
+
+#endif /* RMDLRENDERGRAPHEXECUTOR_HPP */
@@ -0,0 +1,257 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLResidencyBudget.cpp      +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 23:58:20      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLResidencyBudget.hpp"
+
+#include <algorithm>
+
+namespace residency
+{
+
+ResidencyBudget::ResidencyBudget( uint64_t budgetBytes, uint32_t framesInFlight, Policy policy )
+: _budget( budgetBytes )
+, _framesInFlight( std::max(1u, framesInFlight) )
+, _policy( policy )
+, _frame( 0 )
+{
+}
+
+AllocationId ResidencyBudget::add( uint64_t size, Priority priority )
+{
+    AllocationId id;
+    if (!_freeIds.empty())
+    {
+        id = _freeIds.back();
+        _freeIds.pop_back();
+        _entries[id] = Entry();
+    }
+    else
+    {
+        id = (AllocationId)_entries.size();
+        _entries.emplace_back();
+    }
+    Entry& entry = _entries[id];
+    entry.size = size;
+    entry.priority = priority;
+    entry.live = true;
+    if (priority == Priority::Pinned)
+        makeResident(id);
+    return (id);
+}
+
+void ResidencyBudget::remove( AllocationId id )
+{
+    if (id >= _entries.size() || !_entries[id].live)
+        return;
+    // Frames still in flight may read it: it stays in the set, and its slot and
+    // id stay taken, until they are done.
+    _entries[id].live = false;
+    _retiring.push_back({ id, _frame + _framesInFlight });
+}
+
+void ResidencyBudget::setPriority( AllocationId id, Priority priority )
+{
+    if (id >= _entries.size() || !_entries[id].live || _entries[id].priority == priority)
+        return;
+    Entry& entry = _entries[id];
+    const bool wasLinked = entry.resident && entry.priority != Priority::Pinned;
+    if (wasLinked)
+        unlink(id);
+    entry.priority = priority;
+    if (priority == Priority::Pinned)
+    {
+        if (!entry.resident)
+            makeResident(id);
+    }
+    else if (entry.resident)
+    {
+        link(id);
+    }
+}
+
+void ResidencyBudget::beginFrame( uint64_t frameIndex )
+{
+    _frame = frameIndex;
+}
+
+void ResidencyBudget::use( AllocationId id )
+{
+    if (id >= _entries.size() || !_entries[id].live)
+        return;
+    Entry& entry = _entries[id];
+    if (entry.everUsed && entry.lastUse == _frame && entry.resident)
+        return;
+    entry.everUsed = true;
+    entry.lastUse = _frame;
+    if (!entry.resident)
+    {
+        if (entry.evicted)
+            ++_stats.reloads;
+        makeResident(id);
+    }
+    else if (entry.priority != Priority::Pinned)
+    {
+        // Most recently used at the tail.
+        unlink(id);
+        link(id);
+    }
+}
+
+const Changes& ResidencyBudget::endFrame()
+{
+    size_t retired = 0;
+    while (retired < _retiring.size() && _retiring[retired].frame <= _frame)
+        retire(_retiring[retired++].id);
+    _retiring.erase(_retiring.begin(), _retiring.begin() + retired);
+
+    // Least recently used first, lowest priority list first; a list ordered by last
+    // use is done once its head is still protected.
+    for (uint32_t l = 0; l < kListCount && _stats.residentBytes > _budget; ++l)
+    {
+        while (_lists[l].head != kNone && _stats.residentBytes > _budget)
+        {
+            const uint32_t id = _lists[l].head;
+            if (isProtected(_entries[id]))
+                break;
+            evict(id);
+        }
+    }
+    _stats.overBudgetBytes = _stats.residentBytes > _budget ? _stats.residentBytes - _budget : 0;
+    _stats.peakResidentBytes = std::max(_stats.peakResidentBytes, _stats.residentBytes);
+
+    _changes.added.clear();
+    _changes.removed.clear();
+    _changes.released.clear();
+    for (AllocationId id : _dirty)
+    {
+        Entry& entry = _entries[id];
+        entry.dirty = false;
+        if (entry.resident != entry.committed)
+        {
+            (entry.resident ? _changes.added : _changes.removed).push_back(id);
+            entry.committed = entry.resident;
+        }
+        if (entry.retired)
+        {
+            _changes.released.push_back(id);
+            _freeIds.push_back(id);
+        }
+    }
+    _dirty.clear();
+    if (!_changes.empty())
+        ++_stats.commits;
+    return (_changes);
+}
+
+bool ResidencyBudget::isResident( AllocationId id ) const
+{
+    return (id < _entries.size() && _entries[id].live && _entries[id].resident);
+}
+
+#pragma mark - Lists
+
+uint32_t ResidencyBudget::listOf( const Entry& entry ) const
+{
+    return (_policy == Policy::Priority ? (uint32_t)entry.priority : 0);
+}
+
+void ResidencyBudget::link( uint32_t id )
+{
+    // Kept sorted by last use. Entries just used go straight to the tail; only a
+    // priority change walks back.
+    Entry& entry = _entries[id];
+    List& list = _lists[listOf(entry)];
+    uint32_t after = list.tail;
+    while (after != kNone && _entries[after].lastUse > entry.lastUse)
+        after = _entries[after].prev;
+    entry.prev = after;
+    entry.next = after != kNone ? _entries[after].next : list.head;
+    if (after != kNone)
+        _entries[after].next = id;
+    else
+        list.head = id;
+    if (entry.next != kNone)
+        _entries[entry.next].prev = id;
+    else
+        list.tail = id;
+}
+
+void ResidencyBudget::unlink( uint32_t id )
+{
+    Entry& entry = _entries[id];
+    List& list = _lists[listOf(entry)];
+    if (entry.prev != kNone)
+        _entries[entry.prev].next = entry.next;
+    else
+        list.head = entry.next;
+    if (entry.next != kNone)
+        _entries[entry.next].prev = entry.prev;
+    else
+        list.tail = entry.prev;
+    entry.prev = kNone;
+    entry.next = kNone;
+}
+
+void ResidencyBudget::makeResident( uint32_t id )
+{
+    Entry& entry = _entries[id];
+    entry.resident = true;
+    entry.evicted = false;
+    _stats.residentBytes += entry.size;
+    ++_stats.residentCount;
+    if (entry.priority != Priority::Pinned)
+        link(id);
+    markDirty(id);
+}
+
+void ResidencyBudget::evict( uint32_t id )
+{
+    Entry& entry = _entries[id];
+    unlink(id);
+    entry.resident = false;
+    entry.evicted = true;
+    _stats.residentBytes -= entry.size;
+    --_stats.residentCount;
+    ++_stats.evictions;
+    _stats.evictedBytes += entry.size;
+    markDirty(id);
+}
+
+void ResidencyBudget::retire( uint32_t id )
+{
+    Entry& entry = _entries[id];
+    if (entry.resident)
+    {
+        if (entry.priority != Priority::Pinned)
+            unlink(id);
+        entry.resident = false;
+        _stats.residentBytes -= entry.size;
+        --_stats.residentCount;
+    }
+    entry.retired = true;
+    markDirty(id);
+}
+
+void ResidencyBudget::markDirty( uint32_t id )
+{
+    if (!_entries[id].dirty)
+    {
+        _entries[id].dirty = true;
+        _dirty.push_back(id);
+    }
+}
+
+bool ResidencyBudget::isProtected( const Entry& entry ) const
+{
+    // Frames up to _frame - framesInFlight are done on the GPU.
+    return (entry.everUsed && entry.lastUse + _framesInFlight > _frame);
+}
+
+}
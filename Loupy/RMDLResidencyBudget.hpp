@@ -0,0 +1,145 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLResidencyBudget.hpp      +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 23:58:12      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLRESIDENCYBUDGET_HPP
+# define RMDLRESIDENCYBUDGET_HPP
+
+# include <cstdint>
+# include <vector>
+
+// Bookkeeping for what should be resident on the GPU under a byte budget. An
+// allocation becomes resident the first frame it is used and stays so until it
+// has to make room; the least recently used go first, lowest priority first
+// under Policy::Priority. Anything used in the last framesInFlight frames may
+// still be read by the GPU and is never evicted; for the same reason a remove()d
+// allocation stays resident until framesInFlight frames later. Changes are
+// batched: endFrame() returns everything to add and remove since the previous
+// call. Pure CPU and single-threaded; RMDLResidencyManager applies the batches
+// to a residency set.
+
+namespace residency
+{
+    using AllocationId = uint32_t;
+    static constexpr AllocationId kInvalidAllocation = ~0u;
+
+    enum class Priority : uint8_t
+    {
+        Low,
+        Normal,
+        High,
+        Pinned      // resident from add() on, never evicted
+    };
+
+    enum class Policy : uint8_t
+    {
+        LeastRecentlyUsed,  // priority only decides Pinned
+        Priority            // every Low before any Normal before any High, LRU within a level
+    };
+
+    struct Changes
+    {
+        std::vector<AllocationId>   added;
+        std::vector<AllocationId>   removed;
+        std::vector<AllocationId>   released;   // remove()d framesInFlight frames ago; their ids get reused from now on
+
+        bool    empty() const   { return (added.empty() && removed.empty() && released.empty()); }
+    };
+
+    struct BudgetStats
+    {
+        uint64_t    residentBytes       = 0;
+        uint64_t    peakResidentBytes   = 0;    // after eviction, over every frame
+        uint64_t    overBudgetBytes     = 0;    // at the last endFrame(): what nothing could be evicted for
+        uint64_t    evictions           = 0;
+        uint64_t    evictedBytes        = 0;
+        uint64_t    reloads             = 0;    // made resident again after an eviction
+        uint64_t    commits             = 0;    // endFrame() calls that changed anything
+        uint32_t    residentCount       = 0;
+    };
+
+    class ResidencyBudget
+    {
+    public:
+        ResidencyBudget( uint64_t budgetBytes, uint32_t framesInFlight, Policy policy = Policy::LeastRecentlyUsed );
+
+        /// Not resident until first used, unless pinned.
+        AllocationId    add( uint64_t size, Priority priority = Priority::Normal );
+        /// Gone from the caller's view at once; released framesInFlight frames later.
+        void            remove( AllocationId id );
+        void            setPriority( AllocationId id, Priority priority );
+        void            setBudget( uint64_t budgetBytes )   { _budget = budgetBytes; }
+
+        void            beginFrame( uint64_t frameIndex );
+        /// Needed by the frame being recorded: made resident if it is not.
+        void            use( AllocationId id );
+        /// Evicts down to the budget and returns the batch since the last call.
+        /// Valid until the next endFrame().
+        const Changes&  endFrame();
+
+        bool            isResident( AllocationId id ) const;
+        uint64_t        budget() const      { return (_budget); }
+        BudgetStats     stats() const       { return (_stats); }
+
+    private:
+        static constexpr uint32_t kNone = ~0u;
+        static constexpr uint32_t kListCount = 3;   // one per evictable priority
+
+        struct Entry
+        {
+            uint64_t    size        = 0;
+            uint64_t    lastUse     = 0;
+            uint32_t    prev        = kNone;
+            uint32_t    next        = kNone;
+            Priority    priority    = Priority::Normal;
+            bool        live        = false;
+            bool        resident    = false;
+            bool        committed   = false;    // resident as of the last batch
+            bool        dirty       = false;
+            bool        everUsed    = false;
+            bool        evicted     = false;    // since its last use
+            bool        retired     = false;    // remove()d and done on the GPU
+        };
+
+        struct Retiring
+        {
+            AllocationId    id;
+            uint64_t        frame;      // the first frame it can be released in
+        };
+
+        struct List
+        {
+            uint32_t    head = kNone;
+            uint32_t    tail = kNone;
+        };
+
+        uint32_t        listOf( const Entry& entry ) const;
+        void            link( uint32_t id );
+        void            unlink( uint32_t id );
+        void            makeResident( uint32_t id );
+        void            evict( uint32_t id );
+        void            retire( uint32_t id );
+        void            markDirty( uint32_t id );
+        bool            isProtected( const Entry& entry ) const;
+
+        uint64_t                    _budget;
+        uint32_t                    _framesInFlight;
+        Policy                      _policy;
+        uint64_t                    _frame;
+        std::vector<Entry>          _entries;
+        std::vector<AllocationId>   _freeIds;
+        std::vector<AllocationId>   _dirty;
+        std::vector<Retiring>       _retiring;  // by frame
+        List                        _lists[kListCount];
+        Changes                     _changes;
+        BudgetStats                 _stats;
+    };
+}
+
+#endif /* RMDLRESIDENCYBUDGET_HPP */
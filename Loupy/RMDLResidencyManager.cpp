@@ -0,0 +1,77 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLResidencyManager.cpp     +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 00:21:14      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLResidencyManager.hpp"
+
+ResidencyManager::ResidencyManager( MTL::Device* pDevice, uint64_t budgetBytes, uint32_t framesInFlight, residency::Policy policy )
+: _budget( budgetBytes, framesInFlight, policy )
+, _pDevice( pDevice->retain() )
+{
+    NS::Error* pError = nullptr;
+    NS::SharedPtr<MTL::ResidencySetDescriptor> pResidencyDesc = NS::TransferPtr( MTL::ResidencySetDescriptor::alloc()->init() );
+    pResidencyDesc->setLabel( MTLSTR("Budgeted residency") );
+    _pResidencySet = _pDevice->newResidencySet( pResidencyDesc.get(), &pError );
+    _pResidencySet->requestResidency();
+}
+
+ResidencyManager::~ResidencyManager()
+{
+    _pResidencySet->endResidency();
+    _pResidencySet->release();
+    for (MTL::Allocation* pAllocation : _allocations)
+    {
+        if (pAllocation)
+            pAllocation->release();
+    }
+    _pDevice->release();
+}
+
+residency::AllocationId ResidencyManager::track( MTL::Allocation* pAllocation, residency::Priority priority )
+{
+    const residency::AllocationId id = _budget.add( pAllocation->allocatedSize(), priority );
+    if (id >= _allocations.size())
+        _allocations.resize( id + 1, nullptr );
+    _allocations[id] = pAllocation->retain();
+    return (id);
+}
+
+void ResidencyManager::untrack( residency::AllocationId id )
+{
+    // Released by the endFrame() that takes it out of the set, framesInFlight frames from now.
+    _budget.remove(id);
+}
+
+void ResidencyManager::endFrame()
+{
+    const residency::Changes& changes = _budget.endFrame();
+    if (changes.empty())
+        return;
+
+    _batch.clear();
+    for (residency::AllocationId id : changes.removed)
+        _batch.push_back( _allocations[id] );
+    if (!_batch.empty())
+        _pResidencySet->removeAllocations( _batch.data(), _batch.size() );
+
+    _batch.clear();
+    for (residency::AllocationId id : changes.added)
+        _batch.push_back( _allocations[id] );
+    if (!_batch.empty())
+        _pResidencySet->addAllocations( _batch.data(), _batch.size() );
+
+    if (!changes.added.empty() || !changes.removed.empty())
+        _pResidencySet->commit();
+
+    for (residency::AllocationId id : changes.released)
+    {
+        _allocations[id]->release();
+        _allocations[id] = nullptr;
+    }
+}
@@ -0,0 +1,54 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLResidencyManager.hpp     +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 00:21:06      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLRESIDENCYMANAGER_HPP
+# define RMDLRESIDENCYMANAGER_HPP
+
+# include <Metal/Metal.hpp>
+
+# include <vector>
+
+# include "RMDLResidencyBudget.hpp"
+# include "NonCopyable.h"
+
+/// One MTL::ResidencySet kept under a byte budget by residency::ResidencyBudget.
+/// Allocations are tracked with their allocatedSize(), marked with use() by the
+/// frames that need them, and the set is updated and committed at most once per
+/// frame, in endFrame(). Render thread only.
+class ResidencyManager : public NonCopyable
+{
+public:
+    ResidencyManager( MTL::Device* pDevice, uint64_t budgetBytes, uint32_t framesInFlight,
+                      residency::Policy policy = residency::Policy::LeastRecentlyUsed );
+    ~ResidencyManager();
+
+    /// Retains `pAllocation` until untrack().
+    residency::AllocationId track( MTL::Allocation* pAllocation, residency::Priority priority = residency::Priority::Normal );
+    /// Stays in the set, and retained, until the frames in flight are done with it.
+    void                    untrack( residency::AllocationId id );
+    void                    setPriority( residency::AllocationId id, residency::Priority priority ) { _budget.setPriority(id, priority); }
+
+    void                    beginFrame( uint64_t frameIndex )   { _budget.beginFrame(frameIndex); }
+    void                    use( residency::AllocationId id )   { _budget.use(id); }
+    /// Applies this frame's batch to the set. Call before committing the frame's command buffers.
+    void                    endFrame();
+
+    MTL::ResidencySet*      residencySet() const    { return (_pResidencySet); }
+    residency::BudgetStats  stats() const           { return (_budget.stats()); }
+
+private:
+    residency::ResidencyBudget          _budget;
+    MTL::Device*                        _pDevice;
+    MTL::ResidencySet*                  _pResidencySet;
+    std::vector<MTL::Allocation*>       _allocations;   // by AllocationId
+    std::vector<const MTL::Allocation*> _batch;
+};
+
+#endif /* RMDLRESIDENCYMANAGER_HPP */
@@ -0,0 +1,513 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLSdfAtlas.cpp             +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 13:58:44      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLSdfAtlas.hpp"
+#include "RMDLParallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+
+namespace text
+{
+
+static constexpr float      kFar = 1e20f;
+static constexpr uint32_t   kAtlasFileVersion = 1;
+static constexpr uint32_t   kGlyphGap = 1;
+
+#pragma mark - SkylinePacker
+
+SkylinePacker::SkylinePacker( uint32_t width, uint32_t height )
+: _width( width )
+, _height( height )
+, _usedArea( 0 )
+{
+    _skyline.push_back({ 0, 0, width });
+}
+
+bool SkylinePacker::fits( size_t index, uint32_t width, uint32_t height, uint32_t& y ) const
+{
+    const uint32_t x = _skyline[index].x;
+    if (x + width > _width)
+        return (false);
+
+    uint32_t remaining = width;
+    y = 0;
+    for (size_t i = index; remaining > 0; ++i)
+    {
+        if (i == _skyline.size())
+            return (false);
+        y = std::max(y, _skyline[i].y);
+        if (y + height > _height)
+            return (false);
+        remaining -= std::min(remaining, _skyline[i].width);
+    }
+    return (true);
+}
+
+bool SkylinePacker::insert( uint32_t width, uint32_t height, uint32_t& x, uint32_t& y )
+{
+    size_t      bestIndex = _skyline.size();
+    uint32_t    bestTop = UINT32_MAX;
+    uint32_t    bestWidth = UINT32_MAX;
+    uint32_t    bestY = 0;
+
+    for (size_t i = 0; i < _skyline.size(); ++i)
+    {
+        uint32_t candidateY;
+        if (!fits(i, width, height, candidateY))
+            continue;
+        const uint32_t top = candidateY + height;
+        if (top < bestTop || (top == bestTop && _skyline[i].width < bestWidth))
+        {
+            bestIndex = i;
+            bestTop = top;
+            bestWidth = _skyline[i].width;
+            bestY = candidateY;
+        }
+    }
+    if (bestIndex == _skyline.size())
+        return (false);
+
+    x = _skyline[bestIndex].x;
+    y = bestY;
+    _skyline.insert(_skyline.begin() + bestIndex, Segment{ x, bestY + height, width });
+
+    // Trim the segments now hidden under the new one.
+    for (size_t i = bestIndex + 1; i < _skyline.size(); )
+    {
+        const Segment& prev = _skyline[i - 1];
+        Segment& seg = _skyline[i];
+        const uint32_t prevRight = prev.x + prev.width;
+        if (seg.x >= prevRight)
+            break;
+        const uint32_t shrink = prevRight - seg.x;
+        if (seg.width <= shrink)
+        {
+            _skyline.erase(_skyline.begin() + i);
+            continue;
+        }
+        seg.x += shrink;
+        seg.width -= shrink;
+        break;
+    }
+
+    // Merge neighbours left at the same height.
+    for (size_t i = 0; i + 1 < _skyline.size(); )
+    {
+        if (_skyline[i].y == _skyline[i + 1].y)
+        {
+            _skyline[i].width += _skyline[i + 1].width;
+            _skyline.erase(_skyline.begin() + i + 1);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    _usedArea += (uint64_t)width * height;
+    return (true);
+}
+
+float SkylinePacker::occupancy() const
+{
+    return ((float)((double)_usedArea / ((double)_width * _height)));
+}
+
+#pragma mark - Distance transform
+
+// 1D lower envelope of parabolas; f and d may not alias.
+static void distanceTransform1D( const float* f, float* d, uint32_t n, uint32_t* v, float* z )
+{
+    uint32_t k = 0;
+    v[0] = 0;
+    z[0] = -kFar;
+    z[1] = kFar;
+    for (uint32_t q = 1; q < n; ++q)
+    {
+        const float fq = f[q] + (float)q * q;
+        float s;
+        for (;;)
+        {
+            const uint32_t p = v[k];
+            s = (fq - (f[p] + (float)p * p)) / (2.f * q - 2.f * p);
+            if (s > z[k] || k == 0)
+                break;
+            --k;
+        }
+        if (s <= z[k])
+        {
+            // k == 0 and the new parabola dominates everywhere.
+            v[0] = q;
+            z[0] = -kFar;
+            z[1] = kFar;
+            continue;
+        }
+        ++k;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = kFar;
+    }
+    k = 0;
+    for (uint32_t q = 0; q < n; ++q)
+    {
+        while (z[k + 1] < (float)q)
+            ++k;
+        const float dq = (float)q - (float)v[k];
+        d[q] = dq * dq + f[v[k]];
+    }
+}
+
+void distanceTransform2D( std::vector<float>& grid, uint32_t width, uint32_t height )
+{
+    const uint32_t n = std::max(width, height);
+    std::vector<float>      f(n);
+    std::vector<float>      d(n);
+    std::vector<uint32_t>   v(n);
+    std::vector<float>      z(n + 1);
+
+    for (uint32_t x = 0; x < width; ++x)
+    {
+        for (uint32_t y = 0; y < height; ++y)
+            f[y] = grid[y * width + x];
+        distanceTransform1D(f.data(), d.data(), height, v.data(), z.data());
+        for (uint32_t y = 0; y < height; ++y)
+            grid[y * width + x] = d[y];
+    }
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        float* row = grid.data() + (size_t)y * width;
+        std::copy(row, row + width, f.begin());
+        distanceTransform1D(f.data(), row, width, v.data(), z.data());
+    }
+}
+
+void signedDistance( const GlyphBitmap& glyph, uint32_t spread, std::vector<float>& out )
+{
+    const uint32_t w = glyph.width + 2 * spread;
+    const uint32_t h = glyph.height + 2 * spread;
+    const size_t   count = (size_t)w * h;
+
+    std::vector<float> toInside(count, kFar);
+    std::vector<float> toOutside(count, 0.f);
+    for (uint32_t y = 0; y < glyph.height; ++y)
+    {
+        for (uint32_t x = 0; x < glyph.width; ++x)
+        {
+            if (glyph.coverage[(size_t)y * glyph.width + x] >= 128)
+            {
+                const size_t i = (size_t)(y + spread) * w + (x + spread);
+                toInside[i] = 0.f;
+                toOutside[i] = kFar;
+            }
+        }
+    }
+    distanceTransform2D(toInside, w, h);
+    distanceTransform2D(toOutside, w, h);
+
+    // The outline sits half way between an inside and an outside pixel centre.
+    out.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        out[i] = toInside[i] > 0.f ? std::sqrt(toInside[i]) - 0.5f
+                                   : 0.5f - std::sqrt(toOutside[i]);
+    }
+}
+
+#pragma mark - Atlas
+
+namespace
+{
+    struct EncodedGlyph
+    {
+        uint32_t                width   = 0;
+        uint32_t                height  = 0;
+        std::vector<uint8_t>    texels;
+    };
+
+    uint32_t nextPowerOfTwo( uint32_t v )
+    {
+        uint32_t p = 1;
+        while (p < v)
+            p <<= 1;
+        return (p);
+    }
+}
+
+static void encodeGlyph( const GlyphBitmap& glyph, const SdfAtlasDesc& desc, EncodedGlyph& out )
+{
+    if (glyph.width == 0 || glyph.height == 0)
+        return;
+
+    std::vector<float> distance;
+    signedDistance(glyph, desc.spread, distance);
+
+    const uint32_t ds = std::max(desc.downsample, 1u);
+    const uint32_t w = glyph.width + 2 * desc.spread;
+    const uint32_t h = glyph.height + 2 * desc.spread;
+    const float    spreadTexels = (float)desc.spread / (float)ds;
+
+    out.width = (w + ds - 1) / ds;
+    out.height = (h + ds - 1) / ds;
+    out.texels.resize((size_t)out.width * out.height);
+
+    for (uint32_t ty = 0; ty < out.height; ++ty)
+    {
+        for (uint32_t tx = 0; tx < out.width; ++tx)
+        {
+            float       sum = 0.f;
+            uint32_t    samples = 0;
+            for (uint32_t y = ty * ds; y < std::min((ty + 1) * ds, h); ++y)
+            {
+                for (uint32_t x = tx * ds; x < std::min((tx + 1) * ds, w); ++x)
+                {
+                    sum += distance[(size_t)y * w + x];
+                    ++samples;
+                }
+            }
+            const float d = (sum / (float)samples) / (float)ds;
+            const float v = std::clamp(0.5f - d / (2.f * spreadTexels), 0.f, 1.f);
+            out.texels[(size_t)ty * out.width + tx] = (uint8_t)(v * 255.f + 0.5f);
+        }
+    }
+}
+
+SdfAtlas buildSdfAtlas( const std::vector<GlyphBitmap>& glyphs, const SdfAtlasDesc& desc )
+{
+    const uint32_t ds = std::max(desc.downsample, 1u);
+
+    std::vector<EncodedGlyph> encoded(glyphs.size());
+    parallel::forEach(glyphs.size(), [&]( size_t i ) {
+        encodeGlyph(glyphs[i], desc, encoded[i]);
+    });
+
+    // Tallest first keeps the skyline flat.
+    std::vector<size_t> order(glyphs.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&]( size_t a, size_t b ) {
+        if (encoded[a].height != encoded[b].height)
+            return (encoded[a].height > encoded[b].height);
+        return (encoded[a].width > encoded[b].width);
+    });
+
+    uint64_t area = 0;
+    for (const EncodedGlyph& e : encoded)
+        area += (uint64_t)(e.width + kGlyphGap) * (e.height + kGlyphGap);
+    uint32_t width = std::min(std::max(64u, nextPowerOfTwo((uint32_t)std::ceil(std::sqrt((double)area)))), desc.maxSize);
+    uint32_t height = width;
+
+    std::vector<uint32_t> posX(glyphs.size(), 0);
+    std::vector<uint32_t> posY(glyphs.size(), 0);
+    std::vector<bool>     placed(glyphs.size(), false);
+    for (;;)
+    {
+        SkylinePacker packer(width, height);
+        bool allPlaced = true;
+        for (size_t i : order)
+        {
+            const EncodedGlyph& e = encoded[i];
+            placed[i] = e.width == 0 || packer.insert(e.width + kGlyphGap, e.height + kGlyphGap, posX[i], posY[i]);
+            allPlaced &= placed[i];
+        }
+        if (allPlaced || (width >= desc.maxSize && height >= desc.maxSize))
+            break;
+        if (height < width)
+            height *= 2;
+        else
+            width *= 2;
+        width = std::min(width, desc.maxSize);
+        height = std::min(height, desc.maxSize);
+    }
+
+    SdfAtlas atlas;
+    atlas.width = width;
+    atlas.height = height;
+    atlas.distanceRange = 2.f * (float)desc.spread / (float)ds;
+    atlas.lineHeight = desc.lineHeight;
+    atlas.ascent = desc.ascent;
+    atlas.pixels.assign((size_t)width * height, 0);
+    atlas.glyphs.reserve(glyphs.size());
+
+    const float toEm = 1.f / desc.rasterSize;
+    for (size_t i = 0; i < glyphs.size(); ++i)
+    {
+        const GlyphBitmap&  g = glyphs[i];
+        if (!placed[i])
+        {
+            atlas.dropped.push_back(g.codepoint);
+            continue;
+        }
+        const EncodedGlyph& e = encoded[i];
+        for (uint32_t y = 0; y < e.height; ++y)
+        {
+            std::memcpy(&atlas.pixels[(size_t)(posY[i] + y) * width + posX[i]],
+                        &e.texels[(size_t)y * e.width], e.width);
+        }
+
+        SdfGlyph out;
+        out.codepoint  = g.codepoint;
+        out.x          = (uint16_t)posX[i];
+        out.y          = (uint16_t)posY[i];
+        out.width      = (uint16_t)e.width;
+        out.height     = (uint16_t)e.height;
+        out.advance    = g.advance * toEm;
+        out.bearingX   = (g.bearingX - (float)desc.spread) * toEm;
+        out.bearingY   = (g.bearingY + (float)desc.spread) * toEm;
+        out.quadWidth  = (float)(e.width * ds) * toEm;
+        out.quadHeight = (float)(e.height * ds) * toEm;
+        atlas.glyphs.push_back(out);
+    }
+    return (atlas);
+}
+
+GlyphTable makeGlyphTable( const SdfAtlas& atlas )
+{
+    auto toUnorm16 = []( uint32_t texel, uint32_t size ) -> uint16_t {
+        return ((uint16_t)std::lround((double)texel / size * 65535.0));
+    };
+
+    GlyphTable table(atlas.lineHeight, atlas.ascent);
+    for (const SdfGlyph& g : atlas.glyphs)
+    {
+        GlyphMetrics m;
+        m.advance   = g.advance;
+        m.bearingX  = g.bearingX;
+        m.bearingY  = g.bearingY;
+        m.width     = g.width ? g.quadWidth : 0.f;
+        m.height    = g.height ? g.quadHeight : 0.f;
+        m.uvRect[0] = toUnorm16(g.x, atlas.width);
+        m.uvRect[1] = toUnorm16(g.y, atlas.height);
+        m.uvRect[2] = toUnorm16(g.x + g.width, atlas.width);
+        m.uvRect[3] = toUnorm16(g.y + g.height, atlas.height);
+        m.page      = 0;
+        table.setGlyph(g.codepoint, m);
+    }
+    return (table);
+}
+
+#pragma mark - Cache file
+
+namespace
+{
+    struct AtlasFileHeader
+    {
+        char        magic[4];
+        uint32_t    version;
+        uint64_t    key;
+        uint32_t    width;
+        uint32_t    height;
+        float       distanceRange;
+        float       lineHeight;
+        float       ascent;
+        uint32_t    glyphCount;
+    };
+
+    static_assert(sizeof(SdfGlyph) == 32);
+
+    uint64_t fnv1a( uint64_t h, const void* data, size_t len )
+    {
+        const uint8_t* p = (const uint8_t*)data;
+        for (size_t k = 0; k < len; ++k)
+        {
+            h ^= p[k];
+            h *= 0x100000001B3ull;
+        }
+        return (h);
+    }
+}
+
+uint64_t sdfAtlasKey( const std::string& fontName, const std::vector<uint32_t>& codepoints, const SdfAtlasDesc& desc )
+{
+    uint64_t h = 0xCBF29CE484222325ull;
+    h = fnv1a(h, &kAtlasFileVersion, sizeof(kAtlasFileVersion));
+    h = fnv1a(h, fontName.data(), fontName.size());
+    h = fnv1a(h, codepoints.data(), codepoints.size() * sizeof(uint32_t));
+    h = fnv1a(h, &desc.rasterSize, sizeof(desc.rasterSize));
+    h = fnv1a(h, &desc.spread, sizeof(desc.spread));
+    h = fnv1a(h, &desc.downsample, sizeof(desc.downsample));
+    h = fnv1a(h, &desc.maxSize, sizeof(desc.maxSize));
+    h = fnv1a(h, &desc.lineHeight, sizeof(desc.lineHeight));
+    h = fnv1a(h, &desc.ascent, sizeof(desc.ascent));
+    return (h);
+}
+
+bool saveSdfAtlas( const std::string& path, uint64_t key, const SdfAtlas& atlas )
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        return (false);
+
+    AtlasFileHeader header = {};
+    std::memcpy(header.magic, "RSDF", 4);
+    header.version       = kAtlasFileVersion;
+    header.key           = key;
+    header.width         = atlas.width;
+    header.height        = atlas.height;
+    header.distanceRange = atlas.distanceRange;
+    header.lineHeight    = atlas.lineHeight;
+    header.ascent        = atlas.ascent;
+    header.glyphCount    = (uint32_t)atlas.glyphs.size();
+
+    out.write((const char *)&header, sizeof(header));
+    out.write((const char *)atlas.glyphs.data(), atlas.glyphs.size() * sizeof(SdfGlyph));
+    out.write((const char *)atlas.pixels.data(), atlas.pixels.size());
+    return ((bool)out);
+}
+
+bool loadSdfAtlas( const std::string& path, uint64_t key, SdfAtlas& atlas )
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        return (false);
+
+    in.seekg(0, std::ios::end);
+    const uint64_t fileSize = (uint64_t)in.tellg();
+    in.seekg(0, std::ios::beg);
+
+    AtlasFileHeader header;
+    if (fileSize < sizeof(header) || !in.read((char *)&header, sizeof(header)))
+        return (false);
+    if (std::memcmp(header.magic, "RSDF", 4) != 0 || header.version != kAtlasFileVersion || header.key != key)
+        return (false);
+    if (header.width == 0 || header.height == 0 || header.width > 16384 || header.height > 16384)
+        return (false);
+    // The counts must account for the rest of the file exactly, before anything is allocated.
+    const uint64_t pixelBytes = (uint64_t)header.width * header.height;
+    const uint64_t remaining = fileSize - sizeof(header);
+    if (pixelBytes > remaining || header.glyphCount != (remaining - pixelBytes) / sizeof(SdfGlyph)
+        || (remaining - pixelBytes) % sizeof(SdfGlyph) != 0)
+        return (false);
+
+    SdfAtlas loaded;
+    loaded.width         = header.width;
+    loaded.height        = header.height;
+    loaded.distanceRange = header.distanceRange;
+    loaded.lineHeight    = header.lineHeight;
+    loaded.ascent        = header.ascent;
+    loaded.glyphs.resize(header.glyphCount);
+    loaded.pixels.resize((size_t)header.width * header.height);
+    if (!in.read((char *)loaded.glyphs.data(), loaded.glyphs.size() * sizeof(SdfGlyph)))
+        return (false);
+    if (!in.read((char *)loaded.pixels.data(), loaded.pixels.size()))
+        return (false);
+    for (const SdfGlyph& g : loaded.glyphs)
+    {
+        if ((uint32_t)g.x + g.width > header.width || (uint32_t)g.y + g.height > header.height)
+            return (false);
+    }
+
+    atlas = std::move(loaded);
+    return (true);
+}
+
+}
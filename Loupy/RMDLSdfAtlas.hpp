@@ -0,0 +1,121 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLSdfAtlas.hpp             +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 13:58:40      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLSDFATLAS_HPP
+# define RMDLSDFATLAS_HPP
+
+# include <cstdint>
+# include <string>
+# include <vector>
+
+# include "RMDLTextBatch.hpp"
+
+// Portable signed-distance-field atlas builder. Glyph coverage comes from the
+// platform rasterizer (CoreText in RMDLFontLoader.mm); everything after that
+// (distance transform, packing, cache file) is plain C++.
+
+namespace text
+{
+    /// Coverage bitmap of one glyph at the raster size, rows top-down.
+    struct GlyphBitmap
+    {
+        uint32_t                codepoint;
+        uint32_t                width;
+        uint32_t                height;
+        std::vector<uint8_t>    coverage;
+        float                   advance;    // raster pixels
+        float                   bearingX;   // pen -> bitmap left
+        float                   bearingY;   // baseline -> bitmap top, positive up
+    };
+
+    struct SdfAtlasDesc
+    {
+        float       rasterSize  = 64.f;     // em size the bitmaps were rasterized at
+        uint32_t    spread      = 8;        // distance range in raster pixels, each side of the edge
+        uint32_t    downsample  = 2;        // raster pixels per atlas texel
+        uint32_t    maxSize     = 4096;
+        float       lineHeight  = 1.2f;     // em
+        float       ascent      = 0.95f;    // em
+    };
+
+    /// Placement of one glyph in the atlas; metrics in em units.
+    struct SdfGlyph
+    {
+        uint32_t    codepoint;
+        uint16_t    x, y, width, height;    // atlas texels
+        float       advance;
+        float       bearingX;
+        float       bearingY;
+        float       quadWidth;
+        float       quadHeight;
+    };
+
+    struct SdfAtlas
+    {
+        uint32_t                width       = 0;
+        uint32_t                height      = 0;
+        float                   distanceRange = 0.f;    // atlas texels from 0 to 1 in the encoding
+        float                   lineHeight  = 0.f;
+        float                   ascent      = 0.f;
+        std::vector<uint8_t>    pixels;                 // R8, 128 on the outline, > 128 inside
+        std::vector<SdfGlyph>   glyphs;
+        /// Codepoints that did not fit in maxSize x maxSize; never saved.
+        std::vector<uint32_t>   dropped;
+    };
+
+    /// Bottom-left skyline rectangle packer (best-fit on the resulting top edge).
+    class SkylinePacker
+    {
+    public:
+        SkylinePacker( uint32_t width, uint32_t height );
+
+        bool        insert( uint32_t width, uint32_t height, uint32_t& x, uint32_t& y );
+        float       occupancy() const;
+
+    private:
+        struct Segment
+        {
+            uint32_t    x;
+            uint32_t    y;
+            uint32_t    width;
+        };
+
+        bool        fits( size_t index, uint32_t width, uint32_t height, uint32_t& y ) const;
+
+        uint32_t                _width;
+        uint32_t                _height;
+        uint64_t                _usedArea;
+        std::vector<Segment>    _skyline;
+    };
+
+    /// Squared Euclidean distance transform (Felzenszwalb-Huttenlocher), linear in the pixel count.
+    /// `grid` holds 0 on seed pixels and a large value elsewhere; it is overwritten with squared distances.
+    void        distanceTransform2D( std::vector<float>& grid, uint32_t width, uint32_t height );
+
+    /// Signed distance of a coverage bitmap, padded by `spread` on each side, in raster pixels
+    /// (negative inside). Output is (width + 2 * spread) x (height + 2 * spread).
+    void        signedDistance( const GlyphBitmap& glyph, uint32_t spread, std::vector<float>& out );
+
+    /// Builds the atlas; the distance transforms run in parallel over glyphs.
+    /// Glyphs that do not fit are left out and listed in SdfAtlas::dropped.
+    SdfAtlas    buildSdfAtlas( const std::vector<GlyphBitmap>& glyphs, const SdfAtlasDesc& desc );
+
+    /// Metrics for text::layoutText; sizes are in em, so TextStyle::scale is the pixel size.
+    GlyphTable  makeGlyphTable( const SdfAtlas& atlas );
+
+    /// Identifies a cached atlas: font, charset and every SdfAtlasDesc field.
+    uint64_t    sdfAtlasKey( const std::string& fontName, const std::vector<uint32_t>& codepoints, const SdfAtlasDesc& desc );
+    bool        saveSdfAtlas( const std::string& path, uint64_t key, const SdfAtlas& atlas );
+    /// Returns false (leaving `atlas` untouched) when the file is missing, truncated, inconsistent
+    /// or built for another key.
+    bool        loadSdfAtlas( const std::string& path, uint64_t key, SdfAtlas& atlas );
+}
+
+#endif /* RMDLSDFATLAS_HPP */
@@ -0,0 +1,420 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLShaderCache.cpp          +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 18:31:49      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLShaderCache.hpp"
+#include "RMDLParallel.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace shader_cache
+{
+
+#pragma mark - MappedFile
+
+std::shared_ptr<const MappedFile> MappedFile::open( const std::string& path )
+{
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return (nullptr);
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        ::close(fd);
+        return (nullptr);
+    }
+    void* pData = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);    // the mapping keeps the file alive
+    if (pData == MAP_FAILED)
+        return (nullptr);
+    return (std::shared_ptr<const MappedFile>(new MappedFile((const uint8_t *)pData, (size_t)st.st_size)));
+}
+
+MappedFile::MappedFile( const uint8_t* pData, size_t size )
+: _pData( pData )
+, _size( size )
+{
+}
+
+MappedFile::~MappedFile()
+{
+    munmap((void *)_pData, _size);
+}
+
+void MappedFile::willNeed() const
+{
+    madvise((void *)_pData, _size, MADV_WILLNEED);
+}
+
+#pragma mark - Hash
+
+namespace
+{
+    constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ull;
+    constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4Full;
+
+    inline uint64_t rotl( uint64_t x, int r )
+    {
+        return ((x << r) | (x >> (64 - r)));
+    }
+
+    inline uint64_t mixLane( uint64_t lane, uint64_t word )
+    {
+        return (rotl(lane + word * kPrime2, 31) * kPrime1);
+    }
+
+    inline uint64_t finalize( uint64_t h )
+    {
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ull;
+        h ^= h >> 33;
+        return (h);
+    }
+
+    inline uint64_t load64( const uint8_t* p )
+    {
+        uint64_t v;
+        std::memcpy(&v, p, 8);
+        return (v);
+    }
+}
+
+uint64_t hashBytes( const void* data, size_t size, uint64_t seed )
+{
+    const uint8_t* p = (const uint8_t *)data;
+    const uint8_t* end = p + size;
+
+    // Four independent lanes keep the multiplies pipelined on long inputs.
+    uint64_t a = seed + kPrime1 + kPrime2, b = seed + kPrime2, c = seed, d = seed - kPrime1;
+    for (; end - p >= 32; p += 32)
+    {
+        a = mixLane(a, load64(p));
+        b = mixLane(b, load64(p + 8));
+        c = mixLane(c, load64(p + 16));
+        d = mixLane(d, load64(p + 24));
+    }
+    uint64_t h = rotl(a, 1) + rotl(b, 7) + rotl(c, 12) + rotl(d, 18) + size;
+    for (; end - p >= 8; p += 8)
+        h = rotl(h ^ mixLane(0, load64(p)), 27) * kPrime1 + kPrime2;
+    for (; p < end; ++p)
+        h = rotl(h ^ (*p * kPrime1), 11) * kPrime2;
+    return (finalize(h));
+}
+
+#pragma mark - Tool compiler
+
+namespace
+{
+    /// ".<pid>.<n>" with n unique to this call, for scratch files that threads in this
+    /// process, and other processes, may be writing at the same time under the same key.
+    std::string uniqueSuffix()
+    {
+        static std::atomic<uint64_t> counter{ 0 };
+        char suffix[48];
+        snprintf(suffix, sizeof(suffix), ".%d.%llu", (int)getpid(),
+                 (unsigned long long)counter.fetch_add(1, std::memory_order_relaxed));
+        return (suffix);
+    }
+}
+
+Compiler toolCompiler( const std::string& command, const std::string& sourceExtension )
+{
+    return [command, sourceExtension]( const ShaderSource& source, std::vector<uint8_t>& artifact ) -> bool {
+        namespace fs = std::filesystem;
+        std::error_code ec;
+        const uint64_t id = hashBytes(source.options.data(), source.options.size(),
+                                      hashBytes(source.source.data(), source.source.size()));
+        char hash[32];
+        snprintf(hash, sizeof(hash), "rmdl-%016llx", (unsigned long long)id);
+        const std::string stem = hash + uniqueSuffix();
+        const fs::path tmp = fs::temp_directory_path(ec);
+        const std::string inPath = (tmp / (stem + sourceExtension)).string();
+        const std::string outPath = (tmp / (stem + ".out")).string();
+
+        {
+            std::ofstream in(inPath, std::ios::binary | std::ios::trunc);
+            in.write(source.source.data(), source.source.size());
+            if (!in)
+                return (false);
+        }
+
+        std::string line = command;
+        auto replace = [&line]( const std::string& from, const std::string& to ) {
+            for (size_t at = line.find(from); at != std::string::npos; at = line.find(from, at + to.size()))
+                line.replace(at, from.size(), to);
+        };
+        replace("{options}", source.options);
+        replace("{in}", "'" + inPath + "'");
+        replace("{out}", "'" + outPath + "'");
+
+        const int status = std::system(line.c_str());
+        bool ok = false;
+        if (status == 0)
+        {
+            std::ifstream out(outPath, std::ios::binary);
+            artifact.assign(std::istreambuf_iterator<char>(out), std::istreambuf_iterator<char>());
+            ok = !artifact.empty();
+        }
+        if (!ok)
+            printf("Error compiling shader \"%s\" (status %d)\n", source.name.c_str(), status);
+        fs::remove(inPath, ec);
+        fs::remove(outPath, ec);
+        return (ok);
+    };
+}
+
+#pragma mark - ArtifactStore
+
+namespace
+{
+    constexpr uint32_t kManifestVersion = 1;
+
+    struct ManifestHeader
+    {
+        char        magic[4];
+        uint32_t    version;
+        uint64_t    compilerKey;
+        uint32_t    entryCount;
+        uint32_t    reserved;
+    };
+
+    struct ManifestRecord
+    {
+        uint64_t    key;
+        uint64_t    size;
+        uint32_t    nameLength;
+        uint32_t    reserved;
+    };
+
+    double millisecondsSince( std::chrono::steady_clock::time_point start )
+    {
+        return (std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+}
+
+ArtifactStore::ArtifactStore( const std::string& directory, Compiler compiler, const std::string& compilerId )
+: _directory( directory )
+, _compiler( std::move(compiler) )
+, _compilerKey( hashBytes(compilerId.data(), compilerId.size()) )
+, _manifestDirty( false )
+{
+    std::error_code ec;
+    std::filesystem::create_directories(_directory, ec);
+    loadManifest();
+}
+
+ArtifactStore::~ArtifactStore()
+{
+    for (auto& [key, future] : _prefetched)
+        future.wait();
+    if (_manifestDirty)
+        saveManifest();
+}
+
+uint64_t ArtifactStore::key( const ShaderSource& source ) const
+{
+    uint64_t h = hashBytes(source.source.data(), source.source.size(), _compilerKey);
+    return (hashBytes(source.options.data(), source.options.size(), h));
+}
+
+std::string ArtifactStore::artifactPath( uint64_t key ) const
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.metallib", (unsigned long long)key);
+    return ((std::filesystem::path(_directory) / name).string());
+}
+
+std::shared_ptr<const MappedFile> ArtifactStore::mapArtifact( const std::string& name, uint64_t key )
+{
+    std::shared_future<std::shared_ptr<const MappedFile>> pending;
+    uint64_t expectedSize = 0;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _prefetched.find(key);
+        if (it != _prefetched.end())
+            pending = it->second;
+        auto entry = _manifest.find(name);
+        if (entry != _manifest.end() && entry->second.key == key)
+            expectedSize = entry->second.size;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    std::shared_ptr<const MappedFile> pFile = pending.valid() ? pending.get() : MappedFile::open(artifactPath(key));
+    // A truncated file (crash while storing) is treated as missing.
+    if (pFile && expectedSize != 0 && pFile->size() != expectedSize)
+        pFile = nullptr;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.mapMs += millisecondsSince(start);
+    return (pFile);
+}
+
+std::shared_ptr<const MappedFile> ArtifactStore::get( const ShaderSource& source )
+{
+    const uint64_t k = key(source);
+    std::shared_ptr<const MappedFile> pFile = mapArtifact(source.name, k);
+    if (!pFile)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<uint8_t> artifact;
+        if (!_compiler || !_compiler(source, artifact))
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            ++_stats.failed;
+            return (nullptr);
+        }
+
+        // Written aside and renamed, so a reader never maps a half-written artifact.
+        const std::string path = artifactPath(k);
+        const std::string tmpPath = path + uniqueSuffix() + ".tmp";
+        {
+            std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+            out.write((const char *)artifact.data(), artifact.size());
+        }
+        std::error_code ec;
+        std::filesystem::rename(tmpPath, path, ec);
+        pFile = MappedFile::open(path);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        ++_stats.cold;
+        _stats.compileMs += millisecondsSince(start);
+        if (!pFile)
+        {
+            ++_stats.failed;
+            return (nullptr);
+        }
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        ++_stats.warm;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    ManifestEntry& entry = _manifest[source.name];
+    if (entry.key != k || entry.size != pFile->size())
+    {
+        entry = { k, pFile->size() };
+        _manifestDirty = true;
+    }
+    return (pFile);
+}
+
+std::shared_ptr<const MappedFile> ArtifactStore::get( const std::string& name )
+{
+    uint64_t k;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _manifest.find(name);
+        if (it == _manifest.end())
+            return (nullptr);
+        k = it->second.key;
+    }
+    std::shared_ptr<const MappedFile> pFile = mapArtifact(name, k);
+    std::lock_guard<std::mutex> lock(_mutex);
+    ++(pFile ? _stats.warm : _stats.failed);
+    return (pFile);
+}
+
+void ArtifactStore::prefetch()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (const auto& [name, entry] : _manifest)
+    {
+        if (_prefetched.count(entry.key))
+            continue;
+        const std::string path = artifactPath(entry.key);
+        _prefetched[entry.key] = parallel::defaultPool().submit([path]() {
+            std::shared_ptr<const MappedFile> pFile = MappedFile::open(path);
+            if (pFile)
+                pFile->willNeed();
+            return (pFile);
+        }).share();
+    }
+}
+
+void ArtifactStore::loadManifest()
+{
+    std::ifstream in((std::filesystem::path(_directory) / "manifest.bin").string(), std::ios::binary);
+    if (!in)
+        return;
+
+    ManifestHeader header;
+    if (!in.read((char *)&header, sizeof(header)))
+        return;
+    // Another compiler means other keys: start from an empty manifest.
+    if (std::memcmp(header.magic, "RSHM", 4) != 0 || header.version != kManifestVersion || header.compilerKey != _compilerKey)
+        return;
+
+    for (uint32_t i = 0; i < header.entryCount; ++i)
+    {
+        ManifestRecord record;
+        if (!in.read((char *)&record, sizeof(record)) || record.nameLength > 4096)
+            return;
+        std::string name(record.nameLength, '\0');
+        if (!in.read(name.data(), name.size()))
+            return;
+        _manifest[name] = { record.key, record.size };
+    }
+}
+
+bool ArtifactStore::saveManifest()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    const std::string path = (std::filesystem::path(_directory) / "manifest.bin").string();
+    const std::string tmpPath = path + uniqueSuffix() + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return (false);
+
+        ManifestHeader header = {};
+        std::memcpy(header.magic, "RSHM", 4);
+        header.version     = kManifestVersion;
+        header.compilerKey = _compilerKey;
+        header.entryCount  = (uint32_t)_manifest.size();
+        out.write((const char *)&header, sizeof(header));
+        for (const auto& [name, entry] : _manifest)
+        {
+            const ManifestRecord record = { entry.key, entry.size, (uint32_t)name.size(), 0 };
+            out.write((const char *)&record, sizeof(record));
+            out.write(name.data(), name.size());
+        }
+        if (!out)
+            return (false);
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec)
+        return (false);
+    _manifestDirty = false;
+    return (true);
+}
+
+StoreStats ArtifactStore::stats() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return (_stats);
+}
+
+}
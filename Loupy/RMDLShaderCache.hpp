@@ -0,0 +1,128 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLShaderCache.hpp          +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 18:31:44      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLSHADERCACHE_HPP
+# define RMDLSHADERCACHE_HPP
+
+# include <cstdint>
+# include <functional>
+# include <future>
+# include <memory>
+# include <mutex>
+# include <string>
+# include <unordered_map>
+# include <vector>
+
+# include "NonCopyable.h"
+
+// Compiled shader libraries on disk. Artifacts are named after the hash of
+// (source, options, compiler), mapped read-only and handed to Metal without a
+// copy (see newLibraryFromArtifact in RMDLUtils). A manifest remembers which
+// artifact each named library resolved to last run, so a warm start maps files
+// and never compiles. No Metal here.
+
+namespace shader_cache
+{
+    /// Read-only private mapping of a whole file. Shared because a mapping handed to
+    /// Metal must live as long as the library made from it.
+    class MappedFile : public NonCopyable
+    {
+    public:
+        /// nullptr when the file is missing or empty.
+        static std::shared_ptr<const MappedFile>    open( const std::string& path );
+        ~MappedFile();
+
+        const uint8_t*  data() const    { return (_pData); }
+        size_t          size() const    { return (_size); }
+        /// Asks the kernel to start reading the pages in, without waiting for them.
+        void            willNeed() const;
+
+    private:
+        MappedFile( const uint8_t* pData, size_t size );
+
+        const uint8_t*  _pData;
+        size_t          _size;
+    };
+
+    /// 64-bit content hash, eight bytes per step on four lanes.
+    uint64_t    hashBytes( const void* data, size_t size, uint64_t seed = 0 );
+
+    struct ShaderSource
+    {
+        std::string     name;       // manifest entry, e.g. "BlackHole"
+        std::string     source;
+        std::string     options;    // compiler flags, part of the key
+    };
+
+    /// Turns `source` into an artifact. Returns false (with a message on stdout) on error.
+    using Compiler = std::function<bool( const ShaderSource& source, std::vector<uint8_t>& artifact )>;
+
+    /// Runs an external compiler. `command` is a shell template where {in}, {out} and
+    /// {options} are replaced by the source file, the artifact file and the options,
+    /// e.g. "xcrun -sdk macosx metal {options} -o {out} {in}".
+    Compiler    toolCompiler( const std::string& command, const std::string& sourceExtension );
+
+    struct StoreStats
+    {
+        uint32_t    warm            = 0;    // served from disk
+        uint32_t    cold            = 0;    // compiled this run
+        uint32_t    failed          = 0;
+        double      compileMs       = 0.0;
+        double      mapMs           = 0.0;
+    };
+
+    class ArtifactStore : public NonCopyable
+    {
+    public:
+        /// `compilerId` names the compiler version; changing it invalidates every key.
+        ArtifactStore( const std::string& directory, Compiler compiler, const std::string& compilerId );
+        /// Waits for prefetches still running and writes the manifest back if it changed.
+        ~ArtifactStore();
+
+        uint64_t    key( const ShaderSource& source ) const;
+
+        /// Artifact of `source`, compiled and stored only when no file with its key exists.
+        /// Thread-safe; two threads asking for the same new key may both compile it.
+        std::shared_ptr<const MappedFile>   get( const ShaderSource& source );
+        /// Last artifact the manifest recorded for `name`, for builds that ship without
+        /// sources. nullptr when the manifest does not know it.
+        std::shared_ptr<const MappedFile>   get( const std::string& name );
+
+        /// Maps every library of the manifest on the worker pool so the first get() of
+        /// each one only waits for an mmap that already happened.
+        void        prefetch();
+
+        bool        saveManifest();
+        StoreStats  stats() const;
+
+    private:
+        struct ManifestEntry
+        {
+            uint64_t    key;
+            uint64_t    size;
+        };
+
+        std::string                         artifactPath( uint64_t key ) const;
+        std::shared_ptr<const MappedFile>   mapArtifact( const std::string& name, uint64_t key );
+        void                                loadManifest();
+
+        std::string                                         _directory;
+        Compiler                                            _compiler;
+        uint64_t                                            _compilerKey;
+
+        mutable std::mutex                                  _mutex;
+        std::unordered_map<std::string, ManifestEntry>      _manifest;
+        std::unordered_map<uint64_t, std::shared_future<std::shared_ptr<const MappedFile>>> _prefetched;
+        bool                                                _manifestDirty;
+        StoreStats                                          _stats;
+    };
+}
+
+#endif /* RMDLSHADERCACHE_HPP */
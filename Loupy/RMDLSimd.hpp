@@ -0,0 +1,91 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLSimd.hpp                 +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 04:09:12      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLSIMD_HPP
+# define RMDLSIMD_HPP
+
+// Include this rather than <simd/simd.h>. On Apple platforms it is
+// <simd/simd.h>; elsewhere, or with RMDL_PORTABLE_SIMD defined, the same names
+// (simd::float3, matrix_float4x4, simd_inverse, vector_normalize...) come from
+// RMDLPortableSimd.hpp, so the CPU-side math builds on Linux and can be checked
+// against Apple's results.
+
+# if defined(__APPLE__) && !defined(RMDL_PORTABLE_SIMD)
+#  include <simd/simd.h>
+# else
+#  include "RMDLPortableSimd.hpp"
+
+namespace simd
+{
+    using portable_simd::float2;
+    using portable_simd::float3;
+    using portable_simd::float4;
+    using portable_simd::float3x3;
+    using portable_simd::float4x3;
+    using portable_simd::float4x4;
+
+    using portable_simd::dot;
+    using portable_simd::cross;
+    using portable_simd::length;
+    using portable_simd::length_squared;
+    using portable_simd::normalize;
+    using portable_simd::lerp;
+    using portable_simd::transpose;
+    using portable_simd::inverse;
+}
+
+typedef portable_simd::float2           simd_float2;
+typedef portable_simd::float3           simd_float3;
+typedef portable_simd::float4           simd_float4;
+typedef portable_simd::simd_float3x3    simd_float3x3;
+typedef portable_simd::simd_float4x3    simd_float4x3;
+typedef portable_simd::simd_float4x4    simd_float4x4;
+
+typedef simd_float2                     vector_float2;
+typedef simd_float3                     vector_float3;
+typedef simd_float4                     vector_float4;
+typedef simd_float3x3                   matrix_float3x3;
+typedef simd_float4x3                   matrix_float4x3;
+typedef simd_float4x4                   matrix_float4x4;
+
+inline simd_float4      simd_make_float4( float x, float y, float z, float w )  { return { x, y, z, w }; }
+inline simd_float4      simd_make_float4( simd_float3 v, float w )              { return { v.x, v.y, v.z, w }; }
+inline simd_float3      simd_make_float3( float x, float y, float z )           { return { x, y, z }; }
+
+inline simd_float3x3    simd_matrix( simd_float3 c0, simd_float3 c1, simd_float3 c2 )                      { return { { c0, c1, c2 } }; }
+inline simd_float4x3    simd_matrix( simd_float3 c0, simd_float3 c1, simd_float3 c2, simd_float3 c3 )      { return { { c0, c1, c2, c3 } }; }
+inline simd_float4x4    simd_matrix( simd_float4 c0, simd_float4 c1, simd_float4 c2, simd_float4 c3 )      { return { { c0, c1, c2, c3 } }; }
+inline simd_float3x3    simd_matrix_from_rows( simd_float3 r0, simd_float3 r1, simd_float3 r2 )            { return (portable_simd::transpose(simd_matrix(r0, r1, r2))); }
+inline simd_float4x4    simd_matrix_from_rows( simd_float4 r0, simd_float4 r1, simd_float4 r2, simd_float4 r3 ) { return (portable_simd::transpose(simd_matrix(r0, r1, r2, r3))); }
+
+inline simd_float3x3    simd_inverse( const simd_float3x3& m )      { return (portable_simd::inverse(m)); }
+inline simd_float4x4    simd_inverse( const simd_float4x4& m )      { return (portable_simd::inverse(m)); }
+inline simd_float3x3    simd_transpose( const simd_float3x3& m )    { return (portable_simd::transpose(m)); }
+inline simd_float4x4    simd_transpose( const simd_float4x4& m )    { return (portable_simd::transpose(m)); }
+inline simd_float3x3    simd_mul( const simd_float3x3& a, const simd_float3x3& b )  { return (portable_simd::mul(a, b)); }
+inline simd_float4x4    simd_mul( const simd_float4x4& a, const simd_float4x4& b )  { return (portable_simd::mul(a, b)); }
+inline simd_float3      simd_cross( simd_float3 a, simd_float3 b )  { return (portable_simd::cross(a, b)); }
+
+inline simd_float3x3    matrix_invert( const simd_float3x3& m )     { return (portable_simd::inverse(m)); }
+inline simd_float4x4    matrix_invert( const simd_float4x4& m )     { return (portable_simd::inverse(m)); }
+inline simd_float3x3    matrix_transpose( const simd_float3x3& m )  { return (portable_simd::transpose(m)); }
+inline simd_float4x4    matrix_transpose( const simd_float4x4& m )  { return (portable_simd::transpose(m)); }
+inline simd_float3x3    matrix_multiply( const simd_float3x3& a, const simd_float3x3& b )   { return (portable_simd::mul(a, b)); }
+inline simd_float4x4    matrix_multiply( const simd_float4x4& a, const simd_float4x4& b )   { return (portable_simd::mul(a, b)); }
+
+template< typename V > inline float vector_dot( V a, V b )          { return (portable_simd::dot(a, b)); }
+template< typename V > inline float vector_length( V a )            { return (portable_simd::length(a)); }
+template< typename V > inline float vector_length_squared( V a )    { return (portable_simd::length_squared(a)); }
+template< typename V > inline V     vector_normalize( V a )         { return (portable_simd::normalize(a)); }
+inline simd_float3      vector_cross( simd_float3 a, simd_float3 b )    { return (portable_simd::cross(a, b)); }
+
+# endif
+
+#endif /* RMDLSIMD_HPP */
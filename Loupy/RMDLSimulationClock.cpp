@@ -0,0 +1,72 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLSimulationClock.cpp      +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 01:37:22      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLSimulationClock.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace simulation
+{
+
+static int64_t toTicks( double seconds )
+{
+    return ((int64_t)std::llround(seconds * 1e9));
+}
+
+FixedStepClock::FixedStepClock( const ClockConfig& config )
+: _config( config )
+, _stepTicks( std::max<int64_t>(1, toTicks(config.step)) )
+, _accumulator( 0 )
+, _nextStep( 0 )
+, _droppedTicks( 0 )
+, _clampedFrames( 0 )
+{
+    _config.maxStepsPerFrame = std::max(1u, _config.maxStepsPerFrame);
+}
+
+StepPlan FixedStepClock::advance( double realDelta )
+{
+    StepPlan plan;
+    bool clamped = false;
+    if (!(realDelta > 0.0))
+        realDelta = 0.0;
+    if (realDelta > _config.maxFrameDelta)
+    {
+        plan.dropped = realDelta - _config.maxFrameDelta;
+        _droppedTicks += toTicks(plan.dropped);
+        realDelta = _config.maxFrameDelta;
+        clamped = true;
+    }
+    _accumulator += toTicks(realDelta);
+
+    int64_t steps = _accumulator / _stepTicks;
+    if (steps > (int64_t)_config.maxStepsPerFrame)
+    {
+        // Spiral of death: more steps would make the next frame longer still.
+        const int64_t excess = (steps - _config.maxStepsPerFrame) * _stepTicks;
+        _accumulator -= excess;
+        _droppedTicks += excess;
+        plan.dropped += (double)excess * 1e-9;
+        steps = _config.maxStepsPerFrame;
+        clamped = true;
+    }
+    _accumulator -= steps * _stepTicks;
+
+    plan.firstStep = _nextStep;
+    plan.steps = (uint32_t)steps;
+    plan.alpha = (float)((double)_accumulator / (double)_stepTicks);
+    _nextStep += (uint64_t)steps;
+    if (clamped)
+        ++_clampedFrames;
+    return (plan);
+}
+
+}
@@ -0,0 +1,168 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLSimulationClock.hpp      +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 01:37:15      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLSIMULATIONCLOCK_HPP
+# define RMDLSIMULATIONCLOCK_HPP
+
+# include <cstdint>
+# include <functional>
+# include <future>
+
+# include "RMDLParallel.hpp"
+
+// Simulation on a fixed time step, whatever the display rate. Real time goes into
+// an accumulator, whole steps come out, and the renderer draws the state blended
+// between the last two steps by what is left over. A long frame (breakpoint,
+// window drag) runs at most maxStepsPerFrame steps and drops the rest, so the
+// simulation never falls further behind trying to catch up. The accumulator
+// counts nanoseconds, so the step sequence does not drift with floating point.
+
+namespace simulation
+{
+    struct ClockConfig
+    {
+        double      step                = 1.0 / 120.0;
+        double      maxFrameDelta       = 0.25;     // longer frames are clamped to this first
+        uint32_t    maxStepsPerFrame    = 8;
+    };
+
+    struct StepPlan
+    {
+        uint64_t    firstStep   = 0;    // index of the first step to run
+        uint32_t    steps       = 0;
+        float       alpha       = 0.f;  // between the last two states, after the steps
+        double      dropped     = 0.0;  // real time thrown away, seconds
+    };
+
+    class FixedStepClock
+    {
+    public:
+        explicit FixedStepClock( const ClockConfig& config = ClockConfig() );
+
+        /// Adds `realDelta` seconds and says which steps are now due.
+        StepPlan    advance( double realDelta );
+
+        uint64_t    nextStep() const        { return (_nextStep); }
+        double      step() const            { return ((double)_stepTicks * 1e-9); }
+        /// Time at the end of the last step run.
+        double      simulatedTime() const   { return ((double)_nextStep * step()); }
+        double      droppedTime() const     { return ((double)_droppedTicks * 1e-9); }
+        uint64_t    clampedFrames() const   { return (_clampedFrames); }
+
+    private:
+        ClockConfig     _config;
+        int64_t         _stepTicks;
+        int64_t         _accumulator;
+        uint64_t        _nextStep;
+        int64_t         _droppedTicks;
+        uint64_t        _clampedFrames;
+    };
+
+    /// A FixedStepClock driving a State. `step(state, index, dt)` advances the state
+    /// by one step; `interpolate(a, b, t)` blends two of them for display.
+    template< typename State >
+    class FixedStepLoop
+    {
+    public:
+        using StepFunction = std::function<void( State&, uint64_t, double )>;
+        using InterpolateFunction = std::function<State( const State&, const State&, float )>;
+
+        FixedStepLoop( const ClockConfig& config, const State& initial, StepFunction step, InterpolateFunction interpolate );
+        /// Waits for steps still running on a pool.
+        ~FixedStepLoop();
+
+        /// Runs the due steps on the calling thread.
+        void            advance( double realDelta );
+        /// Runs them on `pool` instead; previous(), current() and interpolated()
+        /// wait for them. The step function must not touch render-thread state.
+        void            advanceAsync( double realDelta, parallel::ThreadPool& pool );
+        void            wait();
+
+        uint64_t        nextStep() const        { return (_clock.nextStep()); }
+        const State&    previous()              { wait(); return (_previous); }
+        const State&    current()               { wait(); return (_current); }
+        State           interpolated()          { wait(); return (_interpolate(_previous, _current, _alpha)); }
+        float           alpha() const           { return (_alpha); }
+        /// Simulated time the interpolated state stands for.
+        double          renderTime() const      { return (_clock.simulatedTime() - (1.0 - _alpha) * _clock.step()); }
+        const FixedStepClock& clock() const     { return (_clock); }
+
+    private:
+        void            run( const StepPlan& plan );
+
+        FixedStepClock          _clock;
+        State                   _previous;
+        State                   _current;
+        float                   _alpha;
+        StepFunction            _step;
+        InterpolateFunction     _interpolate;
+        std::future<void>       _pending;
+    };
+}
+
+template< typename State >
+simulation::FixedStepLoop<State>::FixedStepLoop( const ClockConfig& config, const State& initial,
+                                                 StepFunction step, InterpolateFunction interpolate )
+: _clock( config )
+, _previous( initial )
+, _current( initial )
+, _alpha( 0.f )
+, _step( std::move(step) )
+, _interpolate( std::move(interpolate) )
+{
+}
+
+template< typename State >
+simulation::FixedStepLoop<State>::~FixedStepLoop()
+{
+    // The pool task holds `this`. wait() would rethrow what a step threw; not here.
+    if (_pending.valid())
+        _pending.wait();
+}
+
+template< typename State >
+void simulation::FixedStepLoop<State>::run( const StepPlan& plan )
+{
+    const double dt = _clock.step();
+    for (uint32_t i = 0; i < plan.steps; ++i)
+    {
+        _previous = _current;
+        _step(_current, plan.firstStep + i, dt);
+    }
+}
+
+template< typename State >
+void simulation::FixedStepLoop<State>::advance( double realDelta )
+{
+    wait();
+    const StepPlan plan = _clock.advance(realDelta);
+    _alpha = plan.alpha;
+    run(plan);
+}
+
+template< typename State >
+void simulation::FixedStepLoop<State>::advanceAsync( double realDelta, parallel::ThreadPool& pool )
+{
+    wait();
+    const StepPlan plan = _clock.advance(realDelta);
+    _alpha = plan.alpha;
+    if (plan.steps == 0)
+        return;
+    _pending = pool.submit( [this, plan]() { run(plan); } );
+}
+
+template< typename State >
+void simulation::FixedStepLoop<State>::wait()
+{
+    if (_pending.valid())
+        _pending.get();
+}
+
+#endif /* RMDLSIMULATIONCLOCK_HPP */
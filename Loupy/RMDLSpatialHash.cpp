@@ -0,0 +1,601 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLSpatialHash.cpp          +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 07:12:31      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLSpatialHash.hpp"
+#include "RMDLParallel.hpp"
+#include "RMDLRadixSort.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cmath>
+
+namespace spatial
+{
+
+namespace
+{
+    static constexpr uint32_t kLarge = ~0u - 1;
+    static constexpr uint32_t kMoved = ~0u;
+    /// Cells in a query row from which a binary search beats hash probes.
+    static constexpr uint32_t kRowSearch = 8;
+    /// Cell coordinates are clamped to this, so any float maps to a cell, the
+    /// cells of all levels can be numbered in 64 bits, and a level and cell
+    /// pack into one (movedKey).
+    static constexpr int32_t kCellBits = 20;
+    static constexpr float kMaxCell = (1 << (kCellBits - 1)) - 1;
+    static constexpr float kLevelRatio = 8.f;
+    /// Objects per parallel job.
+    static constexpr size_t kGrain = 16 * 1024;
+    /// Moved objects are folded back into the grid past count / kMovedFraction.
+    static constexpr size_t kMovedFraction = 16;
+    static constexpr size_t kMinMoved = 256;
+    /// Relative to the coordinates: well above the float rounding of p +- r.
+    static constexpr float kRoundingMargin = 1.f / (1 << 16);
+
+    inline uint64_t hashKey( uint64_t key )
+    {
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdull;
+        key ^= key >> 33;
+        return (key);
+    }
+
+    inline uint64_t movedKey( uint32_t level, const int32_t cell[3] )
+    {
+        const uint64_t bias = 1u << (kCellBits - 1);
+        return (((uint64_t)level << (3 * kCellBits)) | ((cell[0] + bias) << (2 * kCellBits))
+              | ((cell[1] + bias) << kCellBits) | (cell[2] + bias));
+    }
+
+    inline int32_t cellCoordinate( float x, float inverseCellSize )
+    {
+        // fmax/fmin also send NaN to a cell; a NaN box overlaps nothing.
+        const float c = std::floor(x * inverseCellSize);
+        return ((int32_t)std::fmin(std::fmax(c, -kMaxCell), kMaxCell));
+    }
+}
+
+#pragma mark - Tests
+
+bool overlaps( const Aabb& a, const Aabb& b )
+{
+    return (a.min[0] <= b.max[0] && a.max[0] >= b.min[0]
+         && a.min[1] <= b.max[1] && a.max[1] >= b.min[1]
+         && a.min[2] <= b.max[2] && a.max[2] >= b.min[2]);
+}
+
+float distanceSquared( const Aabb& box, simd::float3 point )
+{
+    float sum = 0.f;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        const float d = std::max(0.f, std::max(box.min[axis] - point[axis], point[axis] - box.max[axis]));
+        sum += d * d;
+    }
+    return (sum);
+}
+
+bool overlapsSphere( const Aabb& box, simd::float3 center, float radius )
+{
+    const Aabb sphereBox = { { center[0] - radius, center[1] - radius, center[2] - radius },
+                             { center[0] + radius, center[1] + radius, center[2] + radius } };
+    return (overlaps(box, sphereBox) && distanceSquared(box, center) <= radius * radius);
+}
+
+#pragma mark - Levels
+
+void SpatialHash::Level::cellOf( simd::float3 p, int32_t cell[3] ) const
+{
+    for (int axis = 0; axis < 3; ++axis)
+        cell[axis] = cellCoordinate(p[axis], inverseCellSize);
+}
+
+bool SpatialHash::Level::keyOf( const int32_t cell[3], uint64_t& key ) const
+{
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        if (cell[axis] < gridMin[axis] || cell[axis] > gridMax[axis])
+            return (false);
+    }
+    const uint64_t nx = (uint64_t)(gridMax[0] - gridMin[0]) + 1;
+    const uint64_t ny = (uint64_t)(gridMax[1] - gridMin[1]) + 1;
+    key = ((uint64_t)(cell[2] - gridMin[2]) * ny + (uint64_t)(cell[1] - gridMin[1])) * nx + (uint64_t)(cell[0] - gridMin[0]);
+    return (true);
+}
+
+uint64_t SpatialHash::Level::cellCount() const
+{
+    uint64_t count = 1;
+    for (int axis = 0; axis < 3; ++axis)
+        count *= (uint64_t)std::max(0, gridMax[axis] - gridMin[axis] + 1);
+    return (count);
+}
+
+const SpatialHash::Cell* SpatialHash::Level::findCell( uint64_t key ) const
+{
+    for (uint64_t slot = hashKey(key) & tableMask; table[slot].begin != table[slot].end; slot = (slot + 1) & tableMask)
+    {
+        if (table[slot].key == key)
+            return (&table[slot]);
+    }
+    return (nullptr);
+}
+
+#pragma mark - Build
+
+SpatialHash::SpatialHash( float cellSize )
+: _cellSize( cellSize )
+, _movedMask( 0 )
+{
+    assert(cellSize > 0.f);
+    float levelCellSize = cellSize;
+    for (Level& level : _levels)
+    {
+        level.inverseCellSize = 1.f / levelCellSize;
+        levelCellSize *= kLevelRatio;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            level.gridMin[axis] = 0;
+            level.gridMax[axis] = -1;
+        }
+        level.entryBegin = level.entryEnd = 0;
+        level.tableMask = 0;
+    }
+}
+
+uint32_t SpatialHash::levelOf( const Aabb& box ) const
+{
+    for (uint32_t l = 0; l < kLevelCount; ++l)
+    {
+        int32_t lo[3], hi[3];
+        _levels[l].cellOf(box.min, lo);
+        _levels[l].cellOf(box.max, hi);
+        if (hi[0] - lo[0] <= 1 && hi[1] - lo[1] <= 1 && hi[2] - lo[2] <= 1)
+            return (l);
+    }
+    return (kLevelCount);
+}
+
+void SpatialHash::build( const Aabb* pBounds, size_t count )
+{
+    assert(count < kLarge);
+    _bounds.assign(pBounds, pBounds + count);
+    rebuild();
+}
+
+void SpatialHash::rebuild()
+{
+    const size_t count = _bounds.size();
+    const size_t blockCount = std::max<size_t>(1, (count + kGrain - 1) / kGrain);
+
+    // Each level's grid is the range of its objects' min corners.
+    struct Range { int32_t lo[3] = { INT_MAX, INT_MAX, INT_MAX }; int32_t hi[3] = { INT_MIN, INT_MIN, INT_MIN }; };
+    std::vector<Range> ranges(blockCount * kLevelCount);
+    std::vector<uint8_t> levels(count);
+    parallel::forEach(blockCount, [&]( size_t block )
+    {
+        const size_t end = std::min(count, (block + 1) * kGrain);
+        for (size_t i = block * kGrain; i < end; ++i)
+        {
+            const uint32_t l = levelOf(_bounds[i]);
+            levels[i] = (uint8_t)l;
+            if (l == kLevelCount)
+                continue;
+            Range& range = ranges[block * kLevelCount + l];
+            int32_t lo[3];
+            _levels[l].cellOf(_bounds[i].min, lo);
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                range.lo[axis] = std::min(range.lo[axis], lo[axis]);
+                range.hi[axis] = std::max(range.hi[axis], lo[axis]);
+            }
+        }
+    });
+
+    // Keys number the cells of level 0, then level 1...; large objects take
+    // one past the last and sort to the end.
+    uint64_t keyBase[kLevelCount + 1] = {};
+    for (uint32_t l = 0; l < kLevelCount; ++l)
+    {
+        Range grid;
+        for (size_t block = 0; block < blockCount; ++block)
+        {
+            const Range& range = ranges[block * kLevelCount + l];
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                grid.lo[axis] = std::min(grid.lo[axis], range.lo[axis]);
+                grid.hi[axis] = std::max(grid.hi[axis], range.hi[axis]);
+            }
+        }
+        Level& level = _levels[l];
+        const bool empty = grid.lo[0] > grid.hi[0];
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            level.gridMin[axis] = empty ? 0 : grid.lo[axis];
+            level.gridMax[axis] = empty ? -1 : grid.hi[axis];
+        }
+        keyBase[l + 1] = keyBase[l] + level.cellCount();
+    }
+    const uint64_t largeKey = keyBase[kLevelCount];
+
+    std::vector<uint64_t> keys(count);
+    _entryObjects.resize(count);
+    parallel::forEach(blockCount, [&]( size_t block )
+    {
+        const size_t end = std::min(count, (block + 1) * kGrain);
+        for (size_t i = block * kGrain; i < end; ++i)
+        {
+            const uint32_t l = levels[i];
+            keys[i] = largeKey;
+            if (l < kLevelCount)
+            {
+                int32_t cell[3];
+                uint64_t key = 0;
+                _levels[l].cellOf(_bounds[i].min, cell);
+                _levels[l].keyOf(cell, key);
+                keys[i] = keyBase[l] + key;
+            }
+            _entryObjects[i] = (uint32_t)i;
+        }
+    });
+    uint32_t keyBits = 0;
+    while (keyBits < 64 && (largeKey >> keyBits) != 0)
+        ++keyBits;
+    radix_sort::sort(keys.data(), _entryObjects.data(), count, keyBits);
+
+    // Runs of equal keys are the cells.
+    size_t e = 0;
+    for (uint32_t l = 0; l < kLevelCount; ++l)
+    {
+        Level& level = _levels[l];
+        level.cells.clear();
+        level.cells.reserve(std::min<uint64_t>(count - e, keyBase[l + 1] - keyBase[l]));
+        level.entryBegin = (uint32_t)e;
+        while (e < count && keys[e] < keyBase[l + 1])
+        {
+            const size_t begin = e;
+            const uint64_t key = keys[begin];
+            while (e < count && keys[e] == key)
+                ++e;
+            level.cells.push_back({ key - keyBase[l], (uint32_t)begin, (uint32_t)e });
+        }
+        level.entryEnd = (uint32_t)e;
+
+        size_t tableSize = 16;
+        while (tableSize < 2 * level.cells.size())
+            tableSize *= 2;
+        level.table.assign(tableSize, Cell{ 0, 0, 0 });
+        level.tableMask = tableSize - 1;
+        for (const Cell& cell : level.cells)
+        {
+            uint64_t slot = hashKey(cell.key) & level.tableMask;
+            while (level.table[slot].begin != level.table[slot].end)
+                slot = (slot + 1) & level.tableMask;
+            level.table[slot] = cell;
+        }
+    }
+    const size_t griddedCount = e;
+    _large.assign(_entryObjects.begin() + griddedCount, _entryObjects.end());
+    _entryObjects.resize(griddedCount);
+
+    _moved.clear();
+    size_t bucketCount = 16;
+    while (bucketCount < 2 * std::max(kMinMoved, count / kMovedFraction))
+        bucketCount *= 2;
+    _movedBuckets.assign(bucketCount, kNoObject);
+    _movedMask = bucketCount - 1;
+    _movedKey.resize(count);
+    _movedNext.resize(count);
+    _movedPrev.resize(count);
+
+    _entryBounds.resize(griddedCount);
+    _entryOf.assign(count, kLarge);
+    parallel::forRange(griddedCount, kGrain, [&]( size_t begin, size_t end )
+    {
+        for (size_t entry = begin; entry < end; ++entry)
+        {
+            const uint32_t object = _entryObjects[entry];
+            _entryBounds[entry] = _bounds[object];
+            _entryOf[object] = (uint32_t)entry;
+        }
+    });
+}
+
+#pragma mark - Updates
+
+uint64_t SpatialHash::movedKeyOf( const Aabb& box ) const
+{
+    int32_t cell[3] = { 0, 0, 0 };
+    const uint32_t l = levelOf(box);
+    if (l < kLevelCount)
+        _levels[l].cellOf(box.min, cell);
+    return (movedKey(l, cell));
+}
+
+void SpatialHash::linkMoved( uint32_t object, uint64_t key )
+{
+    uint32_t& head = _movedBuckets[hashKey(key) & _movedMask];
+    _movedKey[object] = key;
+    _movedPrev[object] = kNoObject;
+    _movedNext[object] = head;
+    if (head != kNoObject)
+        _movedPrev[head] = object;
+    head = object;
+}
+
+void SpatialHash::unlinkMoved( uint32_t object )
+{
+    const uint32_t next = _movedNext[object], prev = _movedPrev[object];
+    if (prev != kNoObject)
+        _movedNext[prev] = next;
+    else
+        _movedBuckets[hashKey(_movedKey[object]) & _movedMask] = next;
+    if (next != kNoObject)
+        _movedPrev[next] = prev;
+}
+
+void SpatialHash::update( uint32_t object, const Aabb& bounds )
+{
+    _bounds[object] = bounds;
+    const uint32_t entry = _entryOf[object];
+    if (entry == kLarge)
+        return;
+    if (entry == kMoved)
+    {
+        const uint64_t key = movedKeyOf(bounds);
+        if (key != _movedKey[object])
+        {
+            unlinkMoved(object);
+            linkMoved(object, key);
+        }
+        return;
+    }
+
+    // Still in the same level and cell: only the box changes.
+    const uint32_t l = levelOf(bounds);
+    if (l < kLevelCount && entry >= _levels[l].entryBegin && entry < _levels[l].entryEnd)
+    {
+        const Level& level = _levels[l];
+        int32_t cell[3];
+        uint64_t key;
+        level.cellOf(bounds.min, cell);
+        const Cell* pCell = level.keyOf(cell, key) ? level.findCell(key) : nullptr;
+        if (pCell && entry >= pCell->begin && entry < pCell->end)
+        {
+            _entryBounds[entry] = bounds;
+            return;
+        }
+    }
+    _entryObjects[entry] = kNoObject;
+    _entryOf[object] = kMoved;
+    _moved.push_back(object);
+    linkMoved(object, movedKeyOf(bounds));
+    if (_moved.size() > std::max(kMinMoved, _bounds.size() / kMovedFraction))
+        rebuild();
+}
+
+#pragma mark - Queries
+
+template< typename F >
+void SpatialHash::visit( simd::float3 lo, simd::float3 hi, F&& fn ) const
+{
+    for (const Level& level : _levels)
+    {
+        if (level.cells.empty())
+            continue;
+        // A gridded object overlapping [lo, hi] has its max corner's cell in
+        // the range, and its min corner at most one cell below.
+        int32_t first[3], last[3];
+        level.cellOf(lo, first);
+        level.cellOf(hi, last);
+        uint64_t volume = 1;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            first[axis] = std::max(first[axis] - 1, level.gridMin[axis]);
+            last[axis] = std::min(last[axis], level.gridMax[axis]);
+            volume *= (uint64_t)std::max(0, last[axis] - first[axis] + 1);
+        }
+
+        auto visitCell = [&]( const Cell& cell )
+        {
+            for (uint32_t e = cell.begin; e < cell.end; ++e)
+            {
+                if (_entryObjects[e] != kNoObject)
+                    fn(_entryObjects[e], _entryBounds[e]);
+            }
+        };
+        if (volume > level.cells.size())
+        {
+            // Wider than the occupied cells: walk those instead.
+            const uint64_t nx = (uint64_t)(level.gridMax[0] - level.gridMin[0]) + 1;
+            const uint64_t ny = (uint64_t)(level.gridMax[1] - level.gridMin[1]) + 1;
+            for (const Cell& cell : level.cells)
+            {
+                const int32_t x = level.gridMin[0] + (int32_t)(cell.key % nx);
+                const int32_t y = level.gridMin[1] + (int32_t)((cell.key / nx) % ny);
+                const int32_t z = level.gridMin[2] + (int32_t)(cell.key / (nx * ny));
+                if (x >= first[0] && x <= last[0] && y >= first[1] && y <= last[1] && z >= first[2] && z <= last[2])
+                    visitCell(cell);
+            }
+        }
+        else if (volume > 0)
+        {
+            // Cells along x have consecutive keys: a long row is one search
+            // in the sorted cells, a short one a few hash probes.
+            const bool searchRows = last[0] - first[0] >= (int32_t)kRowSearch;
+            int32_t cell[3];
+            for (cell[2] = first[2]; cell[2] <= last[2]; ++cell[2])
+            for (cell[1] = first[1]; cell[1] <= last[1]; ++cell[1])
+            {
+                uint64_t key, lastKey;
+                cell[0] = first[0];
+                level.keyOf(cell, key);
+                if (searchRows)
+                {
+                    lastKey = key + (uint64_t)(last[0] - first[0]);
+                    auto it = std::lower_bound(level.cells.begin(), level.cells.end(), key,
+                                               []( const Cell& c, uint64_t k ) { return (c.key < k); });
+                    for (; it != level.cells.end() && it->key <= lastKey; ++it)
+                        visitCell(*it);
+                    continue;
+                }
+                for (; cell[0] <= last[0]; ++cell[0], ++key)
+                {
+                    if (const Cell* pCell = level.findCell(key))
+                        visitCell(*pCell);
+                }
+            }
+        }
+    }
+
+    if (!_moved.empty())
+    {
+        // The same cell ranges, unclamped, through the moved objects' hash;
+        // a range with more cells than there are moved objects scans them all.
+        int32_t first[kLevelCount][3], last[kLevelCount][3];
+        bool scan = false;
+        for (uint32_t l = 0; l < kLevelCount; ++l)
+        {
+            _levels[l].cellOf(lo, first[l]);
+            _levels[l].cellOf(hi, last[l]);
+            uint64_t volume = 1;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                first[l][axis] -= 1;
+                volume *= (uint64_t)(last[l][axis] - first[l][axis] + 1);
+            }
+            scan |= (volume > _moved.size());
+        }
+        auto visitBucket = [&]( uint64_t key )
+        {
+            for (uint32_t object = _movedBuckets[hashKey(key) & _movedMask]; object != kNoObject; object = _movedNext[object])
+            {
+                if (_movedKey[object] == key)
+                    fn(object, _bounds[object]);
+            }
+        };
+        if (scan)
+        {
+            for (uint32_t object : _moved)
+                fn(object, _bounds[object]);
+        }
+        else
+        {
+            for (uint32_t l = 0; l < kLevelCount; ++l)
+            {
+                int32_t cell[3];
+                for (cell[2] = first[l][2]; cell[2] <= last[l][2]; ++cell[2])
+                for (cell[1] = first[l][1]; cell[1] <= last[l][1]; ++cell[1])
+                for (cell[0] = first[l][0]; cell[0] <= last[l][0]; ++cell[0])
+                    visitBucket(movedKey(l, cell));
+            }
+            const int32_t origin[3] = { 0, 0, 0 };
+            visitBucket(movedKey(kLevelCount, origin));
+        }
+    }
+
+    for (uint32_t object : _large)
+        fn(object, _bounds[object]);
+}
+
+bool SpatialHash::covers( simd::float3 lo, simd::float3 hi ) const
+{
+    for (const Level& level : _levels)
+    {
+        if (level.cells.empty())
+            continue;
+        int32_t first[3], last[3];
+        level.cellOf(lo, first);
+        level.cellOf(hi, last);
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            if (first[axis] - 1 > level.gridMin[axis] || last[axis] < level.gridMax[axis])
+                return (false);
+        }
+    }
+    return (true);
+}
+
+void SpatialHash::queryRadius( simd::float3 center, float radius, std::vector<uint32_t>& objects ) const
+{
+    const simd::float3 lo = { center[0] - radius, center[1] - radius, center[2] - radius };
+    const simd::float3 hi = { center[0] + radius, center[1] + radius, center[2] + radius };
+    visit(lo, hi, [&]( uint32_t object, const Aabb& box ) {
+        if (overlapsSphere(box, center, radius))
+            objects.push_back(object);
+    });
+}
+
+void SpatialHash::queryAabb( const Aabb& box, std::vector<uint32_t>& objects ) const
+{
+    visit(box.min, box.max, [&]( uint32_t object, const Aabb& objectBox ) {
+        if (overlaps(objectBox, box))
+            objects.push_back(object);
+    });
+}
+
+void SpatialHash::queryNearest( simd::float3 point, uint32_t k, std::vector<Neighbor>& neighbors ) const
+{
+    neighbors.clear();
+    if (k == 0 || _bounds.empty())
+        return;
+    auto nearer = []( const Neighbor& a, const Neighbor& b )
+    {
+        return (a.distanceSquared < b.distanceSquared || (a.distanceSquared == b.distanceSquared && a.object < b.object));
+    };
+
+    // Grow a search radius until k boxes lie within it, less a margin for the
+    // rounding in the search box that could have dropped one.
+    for (float radius = _cellSize; ; radius *= 2.f)
+    {
+        const simd::float3 lo = { point[0] - radius, point[1] - radius, point[2] - radius };
+        const simd::float3 hi = { point[0] + radius, point[1] + radius, point[2] + radius };
+        const bool everything = std::isinf(radius) || covers(lo, hi);
+
+        neighbors.clear();
+        const float radiusSquared = radius * radius;
+        visit(lo, hi, [&]( uint32_t object, const Aabb& box ) {
+            const float d = distanceSquared(box, point);
+            if (everything || d <= radiusSquared)
+                neighbors.push_back({ object, d });
+        });
+        if (neighbors.size() >= k)
+        {
+            std::partial_sort(neighbors.begin(), neighbors.begin() + k, neighbors.end(), nearer);
+            neighbors.resize(k);
+            const float extent = std::max(std::max(std::fabs(point[0]), std::fabs(point[1])), std::max(std::fabs(point[2]), radius));
+            const float sure = radius - extent * kRoundingMargin;
+            if (everything || (sure > 0.f && neighbors.back().distanceSquared <= sure * sure))
+                return;
+        }
+        else if (everything)
+        {
+            std::sort(neighbors.begin(), neighbors.end(), nearer);
+            return;
+        }
+    }
+}
+
+GridStats SpatialHash::stats() const
+{
+    GridStats stats;
+    for (const Level& level : _levels)
+    {
+        stats.cellCount += level.cells.size();
+        for (const Cell& cell : level.cells)
+            stats.maxPerCell = std::max(stats.maxPerCell, cell.end - cell.begin);
+    }
+    stats.largeCount = _large.size();
+    stats.movedCount = _moved.size();
+    return (stats);
+}
+
+}
@@ -0,0 +1,154 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLSpatialHash.hpp          +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 07:12:26      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLSPATIALHASH_HPP
+# define RMDLSPATIALHASH_HPP
+
+# include <cstddef>
+# include <cstdint>
+# include <vector>
+
+# include "RMDLSimd.hpp"
+
+// Broad phase for "what is near X" over many moving boxes: the terrain brush,
+// gameplay queries. Objects are keyed by the grid cell of their min corner and
+// sorted by key (parallel radix sort), so a cell is a run of one flat array; a
+// hash table maps the key of an occupied cell to its run. An object goes to
+// the finest of four grids, each eight times coarser than the last, where it
+// spans at most two cells per axis; a query then looks one cell below its own
+// range and is exact. Objects too large for every grid sit in a list every
+// query scans. An object that leaves its cell is unhooked from the sorted
+// array and chained into a small hash by its new cell until the next build.
+
+namespace spatial
+{
+    static constexpr uint32_t kNoObject = ~0u;
+
+    /// min <= max on every axis.
+    struct Aabb
+    {
+        simd::float3    min;
+        simd::float3    max;
+    };
+
+    struct Neighbor
+    {
+        uint32_t    object;
+        float       distanceSquared;    // from the query point to the box, 0 inside
+    };
+
+    struct GridStats
+    {
+        size_t      cellCount   = 0;    // over every level
+        size_t      largeCount  = 0;    // too big for every level
+        size_t      movedCount  = 0;    // left their cell since build()
+        uint32_t    maxPerCell  = 0;
+    };
+
+    /// The queries' tests, for checking them against a loop over every object.
+    bool        overlaps( const Aabb& a, const Aabb& b );
+    /// Squared distance from `point` to the box, 0 inside.
+    float       distanceSquared( const Aabb& box, simd::float3 point );
+    /// The box is within `radius` of `center`, and touches the sphere's bounding box.
+    bool        overlapsSphere( const Aabb& box, simd::float3 center, float radius );
+
+    class SpatialHash
+    {
+    public:
+        static constexpr uint32_t kLevelCount = 4;
+
+        /// The finest level's cell; size it so most objects span one or two
+        /// cells on each axis.
+        explicit SpatialHash( float cellSize );
+
+        /// Object i gets pBounds[i]; replaces whatever was there.
+        void            build( const Aabb* pBounds, size_t count );
+        /// Moves one object. Within its cell this only rewrites the box;
+        /// otherwise the object joins the moved objects, and once those are a
+        /// sixteenth of all objects the grid is built again.
+        void            update( uint32_t object, const Aabb& bounds );
+        /// Builds the grid again from the current boxes.
+        void            rebuild();
+
+        /// Appends the objects whose box touches the sphere, in no particular order.
+        void            queryRadius( simd::float3 center, float radius, std::vector<uint32_t>& objects ) const;
+        /// Appends the objects whose box overlaps `box`, in no particular order.
+        void            queryAabb( const Aabb& box, std::vector<uint32_t>& objects ) const;
+        /// Replaces `neighbors` with the k boxes nearest `point`, nearest first,
+        /// ties by object index.
+        void            queryNearest( simd::float3 point, uint32_t k, std::vector<Neighbor>& neighbors ) const;
+
+        size_t          objectCount() const         { return (_bounds.size()); }
+        float           cellSize() const            { return (_cellSize); }
+        const Aabb&     bounds( uint32_t object ) const { return (_bounds[object]); }
+        GridStats       stats() const;
+
+    private:
+        struct Cell
+        {
+            uint64_t    key;
+            uint32_t    begin;
+            uint32_t    end;
+        };
+
+        struct Level
+        {
+            float                   inverseCellSize;
+            // Occupied cell range; keys number the cells of this box.
+            int32_t                 gridMin[3];
+            int32_t                 gridMax[3];
+            uint32_t                entryBegin;
+            uint32_t                entryEnd;
+            std::vector<Cell>       cells;
+            std::vector<Cell>       table;      // open addressing; begin == end is empty
+            uint64_t                tableMask;
+
+            void            cellOf( simd::float3 p, int32_t cell[3] ) const;
+            bool            keyOf( const int32_t cell[3], uint64_t& key ) const;
+            uint64_t        cellCount() const;
+            const Cell*     findCell( uint64_t key ) const;
+        };
+
+        /// The finest level `box` spans at most two cells of, or kLevelCount.
+        uint32_t        levelOf( const Aabb& box ) const;
+        /// Level and cell of `box`, as the moved objects are hashed.
+        uint64_t        movedKeyOf( const Aabb& box ) const;
+        void            linkMoved( uint32_t object, uint64_t key );
+        void            unlinkMoved( uint32_t object );
+        /// Calls fn(object, box) for every object that may overlap [lo, hi]:
+        /// the levels' cells, the moved objects, then the large list.
+        template< typename F >
+        void            visit( simd::float3 lo, simd::float3 hi, F&& fn ) const;
+        /// Whether visit(lo, hi) reaches every cell of every level.
+        bool            covers( simd::float3 lo, simd::float3 hi ) const;
+
+        float                   _cellSize;
+        Level                   _levels[kLevelCount];
+
+        std::vector<Aabb>       _bounds;        // by object
+        std::vector<uint32_t>   _entryOf;       // object -> entry, or kLarge / kMoved
+
+        // Entries, sorted by level then cell. A moved object leaves kNoObject.
+        std::vector<uint32_t>   _entryObjects;
+        std::vector<Aabb>       _entryBounds;
+
+        std::vector<uint32_t>   _large;
+
+        // Moved objects, chained per bucket of their movedKeyOf().
+        std::vector<uint32_t>   _moved;
+        std::vector<uint32_t>   _movedBuckets;
+        uint64_t                _movedMask;
+        std::vector<uint64_t>   _movedKey;      // by object
+        std::vector<uint32_t>   _movedNext;
+        std::vector<uint32_t>   _movedPrev;
+    };
+}
+
+#endif /* RMDLSPATIALHASH_HPP */
@@ -0,0 +1,95 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLSpscRing.hpp             +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 02:41:03      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLSPSCRING_HPP
+# define RMDLSPSCRING_HPP
+
+# include <atomic>
+# include <cstddef>
+# include <cstdint>
+# include <type_traits>
+
+# include "NonCopyable.h"
+
+namespace parallel
+{
+    /// Bounded lock-free queue for exactly one producer thread and one consumer
+    /// thread. Neither side ever waits: push() fails when full, pop() when empty.
+    template< typename T, size_t Capacity >
+    class SpscRing : public NonCopyable
+    {
+        static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+        static_assert(std::is_trivially_copyable<T>::value, "SpscRing holds plain data");
+
+    public:
+        SpscRing() : _head( 0 ), _cachedTail( 0 ), _tail( 0 ), _cachedHead( 0 ) {}
+
+        /// Producer.
+        bool    push( const T& value )
+        {
+            const uint64_t head = _head.load(std::memory_order_relaxed);
+            if (head - _cachedTail >= Capacity)
+            {
+                _cachedTail = _tail.load(std::memory_order_acquire);
+                if (head - _cachedTail >= Capacity)
+                    return (false);
+            }
+            _items[head & (Capacity - 1)] = value;
+            _head.store(head + 1, std::memory_order_release);
+            return (true);
+        }
+
+        /// Consumer.
+        bool    pop( T& value )
+        {
+            const uint64_t tail = _tail.load(std::memory_order_relaxed);
+            if (tail == _cachedHead)
+            {
+                _cachedHead = _head.load(std::memory_order_acquire);
+                if (tail == _cachedHead)
+                    return (false);
+            }
+            value = _items[tail & (Capacity - 1)];
+            _tail.store(tail + 1, std::memory_order_release);
+            return (true);
+        }
+
+        /// Consumer: hands every queued item to `fn` and frees their slots at once.
+        template< typename F >
+        size_t  drain( F&& fn )
+        {
+            const uint64_t tail = _tail.load(std::memory_order_relaxed);
+            _cachedHead = _head.load(std::memory_order_acquire);
+            for (uint64_t i = tail; i != _cachedHead; ++i)
+                fn(_items[i & (Capacity - 1)]);
+            _tail.store(_cachedHead, std::memory_order_release);
+            return ((size_t)(_cachedHead - tail));
+        }
+
+        /// Approximate from either side.
+        size_t  size() const
+        {
+            return ((size_t)(_head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire)));
+        }
+
+        static constexpr size_t capacity()  { return (Capacity); }
+
+    private:
+        // Each side's index and its cached copy of the other's share a cache line;
+        // the two sides never write the same one.
+        alignas(64) std::atomic<uint64_t>   _head;
+        uint64_t                            _cachedTail;
+        alignas(64) std::atomic<uint64_t>   _tail;
+        uint64_t                            _cachedHead;
+        alignas(64) T                       _items[Capacity];
+    };
+}
+
+#endif /* RMDLSPSCRING_HPP */
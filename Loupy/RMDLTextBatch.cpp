@@ -0,0 +1,516 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLTextBatch.cpp            +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 10:12:35      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLTextBatch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace text
+{
+
+#pragma mark - GlyphTable
+
+GlyphTable::GlyphTable( float lineHeight, float ascent )
+: _ascii{}
+, _asciiValid{}
+, _fallback( '?' )
+, _lineHeight( lineHeight )
+, _ascent( ascent )
+, _generation( 1 )
+{
+}
+
+void GlyphTable::setGlyph( uint32_t codepoint, const GlyphMetrics& metrics )
+{
+    if (codepoint < 128)
+    {
+        _ascii[codepoint] = metrics;
+        _asciiValid[codepoint] = true;
+    }
+    else
+    {
+        _extended[codepoint] = metrics;
+    }
+    ++_generation;
+}
+
+void GlyphTable::setKerning( uint32_t left, uint32_t right, float amount )
+{
+    _kerning[((uint64_t)left << 32) | right] = amount;
+    ++_generation;
+}
+
+void GlyphTable::setFallback( uint32_t codepoint )
+{
+    _fallback = codepoint;
+    ++_generation;
+}
+
+const GlyphMetrics* GlyphTable::glyph( uint32_t codepoint ) const
+{
+    if (codepoint < 128)
+    {
+        if (_asciiValid[codepoint])
+            return (&_ascii[codepoint]);
+    }
+    else
+    {
+        auto it = _extended.find(codepoint);
+        if (it != _extended.end())
+            return (&it->second);
+    }
+    // Control characters never fall back to a visible glyph.
+    if (codepoint < 0x20 || codepoint == _fallback)
+        return (nullptr);
+    if (_fallback < 128)
+        return (_asciiValid[_fallback] ? &_ascii[_fallback] : nullptr);
+    auto it = _extended.find(_fallback);
+    return (it != _extended.end() ? &it->second : nullptr);
+}
+
+float GlyphTable::kerning( uint32_t left, uint32_t right ) const
+{
+    if (_kerning.empty())
+        return (0.f);
+    auto it = _kerning.find(((uint64_t)left << 32) | right);
+    return (it != _kerning.end() ? it->second : 0.f);
+}
+
+float GlyphTable::lineHeight() const
+{
+    return (_lineHeight);
+}
+
+float GlyphTable::ascent() const
+{
+    return (_ascent);
+}
+
+uint64_t GlyphTable::generation() const
+{
+    return (_generation);
+}
+
+#pragma mark - Layout
+
+uint32_t decodeUtf8( std::string_view str, size_t& i )
+{
+    static constexpr uint32_t kReplacement = 0xFFFD;
+
+    const uint8_t c0 = (uint8_t)str[i++];
+    if (c0 < 0x80)
+        return (c0);
+
+    uint32_t    cp;
+    int         extra;
+    uint32_t    minValue;
+    if ((c0 & 0xE0) == 0xC0)      { cp = c0 & 0x1F; extra = 1; minValue = 0x80; }
+    else if ((c0 & 0xF0) == 0xE0) { cp = c0 & 0x0F; extra = 2; minValue = 0x800; }
+    else if ((c0 & 0xF8) == 0xF0) { cp = c0 & 0x07; extra = 3; minValue = 0x10000; }
+    else
+        return (kReplacement);
+
+    for (int k = 0; k < extra; ++k)
+    {
+        if (i >= str.size() || ((uint8_t)str[i] & 0xC0) != 0x80)
+            return (kReplacement);
+        cp = (cp << 6) | ((uint8_t)str[i++] & 0x3F);
+    }
+    if (cp < minValue || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF))
+        return (kReplacement);
+    return (cp);
+}
+
+static inline uint16_t lerpUnorm16( uint16_t a, uint16_t b, float t )
+{
+    const float v = (float)a + ((float)b - (float)a) * t;
+    return ((uint16_t)std::clamp(v + 0.5f, 0.f, 65535.f));
+}
+
+static inline void emitGlyph( const GlyphMetrics& g, float x0, float y0, float w, float h, const TextStyle& style, std::vector<GlyphInstance>& out )
+{
+    GlyphInstance inst;
+    inst.position[0] = x0;
+    inst.position[1] = y0;
+    inst.size[0]     = w;
+    inst.size[1]     = h;
+    std::memcpy(inst.uvRect, g.uvRect, sizeof(inst.uvRect));
+    inst.color       = style.color;
+    inst.page        = g.page;
+
+    if (style.clip)
+    {
+        const ClipRect& r = style.clipRect;
+        const float cx0 = std::max(x0, r.minX);
+        const float cy0 = std::max(y0, r.minY);
+        const float cx1 = std::min(x0 + w, r.maxX);
+        const float cy1 = std::min(y0 + h, r.maxY);
+        if (cx0 >= cx1 || cy0 >= cy1)
+            return;
+        if (cx0 != x0 || cy0 != y0 || cx1 != x0 + w || cy1 != y0 + h)
+        {
+            const float tu0 = (cx0 - x0) / w;
+            const float tu1 = (cx1 - x0) / w;
+            const float tv0 = (cy0 - y0) / h;
+            const float tv1 = (cy1 - y0) / h;
+            inst.uvRect[0] = lerpUnorm16(g.uvRect[0], g.uvRect[2], tu0);
+            inst.uvRect[2] = lerpUnorm16(g.uvRect[0], g.uvRect[2], tu1);
+            inst.uvRect[1] = lerpUnorm16(g.uvRect[1], g.uvRect[3], tv0);
+            inst.uvRect[3] = lerpUnorm16(g.uvRect[1], g.uvRect[3], tv1);
+            inst.position[0] = cx0;
+            inst.position[1] = cy0;
+            inst.size[0]     = cx1 - cx0;
+            inst.size[1]     = cy1 - cy0;
+        }
+    }
+    out.push_back(inst);
+}
+
+size_t layoutText( std::string_view str, const GlyphProvider& glyphs, const TextStyle& style, std::vector<GlyphInstance>& out )
+{
+    const size_t    start        = out.size();
+    const float     scale        = style.scale;
+    const float     lineAdvance  = glyphs.lineHeight() * style.lineSpacing * scale;
+    const float     ascent       = glyphs.ascent() * scale;
+    const GlyphMetrics* pSpace   = glyphs.glyph(' ');
+    const float     tabAdvance   = (pSpace ? pSpace->advance : glyphs.lineHeight() * 0.5f) * style.tabWidth * scale;
+
+    // Codepoints never outnumber bytes, so this is the only growth per call.
+    out.reserve(start + str.size());
+
+    float       penX     = style.originX;
+    float       baseline = style.originY + ascent;
+    uint32_t    prev     = 0;
+    size_t      i        = 0;
+
+    while (i < str.size())
+    {
+        const uint32_t cp = decodeUtf8(str, i);
+
+        if (cp == '\n')
+        {
+            penX = style.originX;
+            baseline += lineAdvance;
+            prev = 0;
+            if (style.clip && baseline - ascent >= style.clipRect.maxY)
+                break;
+            continue;
+        }
+        if (cp == '\r')
+            continue;
+        if (cp == '\t')
+        {
+            if (tabAdvance > 0.f)
+                penX = style.originX + (std::floor((penX - style.originX) / tabAdvance) + 1.f) * tabAdvance;
+            prev = 0;
+            continue;
+        }
+
+        const GlyphMetrics* g = glyphs.glyph(cp);
+        if (!g)
+            continue;
+
+        if (prev)
+            penX += glyphs.kerning(prev, cp) * scale;
+
+        const float w = g->width * scale;
+        const float h = g->height * scale;
+        if (w > 0.f && h > 0.f)
+            emitGlyph(*g, penX + g->bearingX * scale, baseline - g->bearingY * scale, w, h, style, out);
+
+        penX += (g->advance + style.tracking) * scale;
+        prev = cp;
+
+        // Everything right of the clip rect on this line is invisible: skip to the next line.
+        if (style.clip && penX >= style.clipRect.maxX)
+        {
+            const size_t nl = str.find('\n', i);
+            if (nl == std::string_view::npos)
+                break;
+            i = nl;
+        }
+    }
+    return (out.size() - start);
+}
+
+static inline uint64_t fnv1a( uint64_t h, const void* data, size_t len )
+{
+    const uint8_t* p = (const uint8_t*)data;
+    for (size_t k = 0; k < len; ++k)
+    {
+        h ^= p[k];
+        h *= 0x100000001B3ull;
+    }
+    return (h);
+}
+
+template< typename T >
+static inline uint64_t fnv1aValue( uint64_t h, const T& value )
+{
+    return (fnv1a(h, &value, sizeof(T)));
+}
+
+uint64_t hashText( std::string_view str, const TextStyle& style, uint64_t glyphGeneration )
+{
+    uint64_t h = 0xCBF29CE484222325ull;
+    h = fnv1a(h, str.data(), str.size());
+    h = fnv1aValue(h, str.size());
+    h = fnv1aValue(h, style.originX);
+    h = fnv1aValue(h, style.originY);
+    h = fnv1aValue(h, style.scale);
+    h = fnv1aValue(h, style.lineSpacing);
+    h = fnv1aValue(h, style.tracking);
+    h = fnv1aValue(h, style.tabWidth);
+    h = fnv1aValue(h, style.color);
+    h = fnv1aValue(h, (uint8_t)style.clip);
+    if (style.clip)
+        h = fnv1aValue(h, style.clipRect);
+    h = fnv1aValue(h, glyphGeneration);
+    return (h);
+}
+
+#pragma mark - GlyphRing
+
+GlyphRing::GlyphRing()
+{
+    reset(nullptr, 0, 1);
+}
+
+void GlyphRing::reset( GlyphInstance* storage, uint32_t capacity, uint32_t framesInFlight )
+{
+    _storage        = storage;
+    _capacity       = storage ? capacity : 0;
+    _framesInFlight = std::clamp(framesInFlight, 1u, kMaxFrames);
+    _head           = 0;
+    _tail           = 0;
+    _used           = 0;
+    _frame          = 0;
+    _frameCount     = 1;
+    std::memset(_frameUsed, 0, sizeof(_frameUsed));
+}
+
+void GlyphRing::beginFrame()
+{
+    ++_frame;
+    _frameUsed[_frame % kMaxFrames] = 0;
+    ++_frameCount;
+
+    // The GPU may still read the `_framesInFlight - 1` frames before this one.
+    while (_frameCount > _framesInFlight)
+    {
+        const uint32_t oldest = _frame - _frameCount + 1;
+        const uint32_t retired = _frameUsed[oldest % kMaxFrames];
+        if (_capacity)
+            _tail = (_tail + retired) % _capacity;
+        _used -= retired;
+        --_frameCount;
+    }
+}
+
+GlyphInstance* GlyphRing::allocate( uint32_t count, uint32_t& firstInstance )
+{
+    if (count == 0 || count > _capacity - _used)
+        return (nullptr);
+
+    // An empty ring places from the start, so a span up to the capacity fits.
+    if (_used == 0)
+    {
+        _head = 0;
+        _tail = 0;
+    }
+
+    uint32_t& frameUsed = _frameUsed[_frame % kMaxFrames];
+    if (_used == 0 || _head > _tail)
+    {
+        // Free space is [head, capacity) followed by [0, tail).
+        if (count > _capacity - _head)
+        {
+            const uint32_t padding = _capacity - _head;
+            if (count > _tail || count + padding > _capacity - _used)
+                return (nullptr);
+            _used += padding;
+            frameUsed += padding;
+            _head = 0;
+        }
+    }
+    else if (count > _tail - _head)
+    {
+        return (nullptr);
+    }
+
+    firstInstance = _head;
+    _head = (_head + count) % _capacity;
+    _used += count;
+    frameUsed += count;
+    return (_storage + firstInstance);
+}
+
+uint32_t GlyphRing::capacity() const
+{
+    return (_capacity);
+}
+
+uint32_t GlyphRing::used() const
+{
+    return (_used);
+}
+
+#pragma mark - TextBatch
+
+bool TextBatch::CachedRun::matches( std::string_view str, const GlyphProvider& glyphs, const TextStyle& s ) const
+{
+    return (pGlyphs == &glyphs && generation == glyphs.generation() && text == str
+         && style.originX == s.originX && style.originY == s.originY && style.scale == s.scale
+         && style.lineSpacing == s.lineSpacing && style.tracking == s.tracking && style.tabWidth == s.tabWidth
+         && style.color == s.color && style.clip == s.clip
+         && (!s.clip || (style.clipRect.minX == s.clipRect.minX && style.clipRect.minY == s.clipRect.minY
+                      && style.clipRect.maxX == s.clipRect.maxX && style.clipRect.maxY == s.clipRect.maxY)));
+}
+
+TextBatch::TextBatch()
+: _stats{}
+, _frame( 0 )
+{
+}
+
+void TextBatch::reset( GlyphInstance* storage, uint32_t capacity, uint32_t framesInFlight )
+{
+    _ring.reset(storage, capacity, framesInFlight);
+    _cache.clear();
+    _spareVectors.clear();
+    _ranges.clear();
+    _ranges.reserve(16);
+    _stats = {};
+    _frame = 0;
+}
+
+void TextBatch::beginFrame()
+{
+    ++_frame;
+    _ring.beginFrame();
+    _ranges.clear();
+    _stats = {};
+    if ((_frame & 31) == 0)
+        evictStale();
+}
+
+void TextBatch::evictStale()
+{
+    static constexpr size_t kMaxSpareVectors = 64;
+
+    for (auto it = _cache.begin(); it != _cache.end(); )
+    {
+        if (_frame - it->second.lastUsedFrame > kEvictAfterFrames)
+        {
+            if (_spareVectors.size() < kMaxSpareVectors)
+            {
+                it->second.glyphs.clear();
+                _spareVectors.push_back(std::move(it->second.glyphs));
+            }
+            it = _cache.erase(it);
+            ++_stats.evictions;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void TextBatch::appendRange( uint32_t first, uint32_t count )
+{
+    if (!_ranges.empty() && _ranges.back().first + _ranges.back().count == first)
+    {
+        _ranges.back().count += count;
+        return;
+    }
+    if (_ranges.size() == _ranges.capacity())
+        ++_stats.allocations;
+    _ranges.push_back({ first, count });
+}
+
+RingSpan TextBatch::submit( std::string_view str, const GlyphProvider& glyphs, const TextStyle& style )
+{
+    ++_stats.submitted;
+
+    // Distinct providers (fonts) must never share an entry.
+    uint64_t key = hashText(str, style, glyphs.generation());
+    key ^= (uint64_t)(uintptr_t)&glyphs * 0x9E3779B97F4A7C15ull;
+
+    auto it = _cache.find(key);
+    if (it != _cache.end() && it->second.matches(str, glyphs, style))
+    {
+        ++_stats.cacheHits;
+    }
+    else
+    {
+        ++_stats.layouts;
+        if (it == _cache.end())
+        {
+            std::vector<GlyphInstance> instances;
+            if (!_spareVectors.empty())
+            {
+                instances = std::move(_spareVectors.back());
+                _spareVectors.pop_back();
+            }
+            it = _cache.emplace(key, CachedRun{ std::move(instances), _frame, std::string(), style, &glyphs, 0 }).first;
+            ++_stats.allocations;
+        }
+        CachedRun& run = it->second;
+        const size_t oldCapacity = run.glyphs.capacity();
+        run.glyphs.clear();
+        layoutText(str, glyphs, style, run.glyphs);
+        if (run.glyphs.capacity() != oldCapacity)
+            ++_stats.allocations;
+        if (str.size() > run.text.capacity())
+            ++_stats.allocations;
+        run.text.assign(str);
+        run.style = style;
+        run.pGlyphs = &glyphs;
+        run.generation = glyphs.generation();
+    }
+    it->second.lastUsedFrame = _frame;
+
+    const std::vector<GlyphInstance>& run = it->second.glyphs;
+    const uint32_t count = (uint32_t)run.size();
+    if (count == 0)
+        return { 0, 0 };
+
+    uint32_t first = 0;
+    GlyphInstance* pDst = _ring.allocate(count, first);
+    if (!pDst)
+    {
+        _stats.dropped += count;
+        return { 0, 0 };
+    }
+    std::memcpy(pDst, run.data(), count * sizeof(GlyphInstance));
+    _stats.glyphs += count;
+    appendRange(first, count);
+    return { first, count };
+}
+
+const std::vector<RingSpan>& TextBatch::drawRanges() const
+{
+    return (_ranges);
+}
+
+const TextBatchStats& TextBatch::stats() const
+{
+    return (_stats);
+}
+
+size_t TextBatch::cachedStrings() const
+{
+    return (_cache.size());
+}
+
+}
@@ -0,0 +1,219 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLTextBatch.hpp            +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 10:12:31      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLTEXTBATCH_HPP
+# define RMDLTEXTBATCH_HPP
+
+# include <cstddef>
+# include <cstdint>
+# include <string>
+# include <string_view>
+# include <unordered_map>
+# include <vector>
+
+// Portable text batching: no Metal / simd dependency so the layout and the
+// ring bookkeeping can be exercised anywhere. The GPU side lives in
+// RMDLTextRenderer, which owns the MTL::Buffer the ring writes into.
+
+namespace text
+{
+    /// One glyph quad as the GPU sees it. Mirrors `GlyphInstance` in BlackHole.metal.
+    struct GlyphInstance
+    {
+        float       position[2];    // top-left corner, y-down layout units
+        float       size[2];
+        uint16_t    uvRect[4];      // unorm16 u0, v0, u1, v1
+        uint32_t    color;          // RGBA8, R in the low byte
+        uint32_t    page;           // atlas array slice
+    };
+
+    static_assert(sizeof(GlyphInstance) == 32);
+
+    /// Placement of a glyph relative to the pen, in font units (scaled by TextStyle::scale).
+    struct GlyphMetrics
+    {
+        float       advance;
+        float       bearingX;       // pen x -> quad left
+        float       bearingY;       // baseline -> quad top (positive is up)
+        float       width;
+        float       height;
+        uint16_t    uvRect[4];
+        uint32_t    page;
+    };
+
+    class GlyphProvider
+    {
+    public:
+        virtual ~GlyphProvider() = default;
+
+        virtual const GlyphMetrics* glyph( uint32_t codepoint ) const = 0;
+        virtual float               kerning( uint32_t, uint32_t ) const { return (0.f); }
+        virtual float               lineHeight() const = 0;
+        virtual float               ascent() const = 0;
+        /// Changes whenever the metrics a layout depends on change; part of the cache key.
+        virtual uint64_t            generation() const { return (0); }
+    };
+
+    /// Static metrics table: flat array for ASCII, hash map for the rest.
+    class GlyphTable : public GlyphProvider
+    {
+    public:
+        GlyphTable( float lineHeight, float ascent );
+
+        void                setGlyph( uint32_t codepoint, const GlyphMetrics& metrics );
+        void                setKerning( uint32_t left, uint32_t right, float amount );
+        void                setFallback( uint32_t codepoint );
+
+        const GlyphMetrics* glyph( uint32_t codepoint ) const override;
+        float               kerning( uint32_t left, uint32_t right ) const override;
+        float               lineHeight() const override;
+        float               ascent() const override;
+        uint64_t            generation() const override;
+
+    private:
+        GlyphMetrics                                _ascii[128];
+        bool                                        _asciiValid[128];
+        std::unordered_map<uint32_t, GlyphMetrics>  _extended;
+        std::unordered_map<uint64_t, float>         _kerning;
+        uint32_t                                    _fallback;
+        float                                       _lineHeight;
+        float                                       _ascent;
+        uint64_t                                    _generation;
+    };
+
+    struct ClipRect
+    {
+        float       minX;
+        float       minY;
+        float       maxX;
+        float       maxY;
+    };
+
+    struct TextStyle
+    {
+        float       originX     = 0.f;
+        float       originY     = 0.f;
+        float       scale       = 1.f;
+        float       lineSpacing = 1.f;      // multiplier on GlyphProvider::lineHeight
+        float       tracking    = 0.f;      // extra advance between glyphs, font units
+        float       tabWidth    = 4.f;      // in multiples of the space advance
+        uint32_t    color       = 0xFFFFFFFF;
+        bool        clip        = false;
+        ClipRect    clipRect    = { 0.f, 0.f, 0.f, 0.f };
+    };
+
+    /// Decodes one UTF-8 sequence starting at `i`, advancing it. Malformed input yields U+FFFD.
+    uint32_t    decodeUtf8( std::string_view str, size_t& i );
+
+    /// Lays out `str` (UTF-8) and appends the visible glyph quads to `out`.
+    /// Handles '\n', '\t', kerning pairs and clipping (quads are trimmed, UVs follow).
+    /// Returns the number of instances appended.
+    size_t      layoutText( std::string_view str, const GlyphProvider& glyphs, const TextStyle& style, std::vector<GlyphInstance>& out );
+
+    /// 64-bit FNV-1a over the string and every style field that affects the output.
+    uint64_t    hashText( std::string_view str, const TextStyle& style, uint64_t glyphGeneration );
+
+    /// Contiguous sub-range of the instance ring, in instances.
+    struct RingSpan
+    {
+        uint32_t    first;
+        uint32_t    count;
+    };
+
+    /// Persistent ring of glyph instances shared by the frames in flight.
+    /// The ring does not own memory: `storage` is the contents() of a shared
+    /// MTL::Buffer (or any CPU array). A frame's span is recycled once
+    /// `framesInFlight` newer frames have begun, matching the CPU wait on
+    /// frame N - framesInFlight before frame N is recorded.
+    class GlyphRing
+    {
+    public:
+        GlyphRing();
+
+        void            reset( GlyphInstance* storage, uint32_t capacity, uint32_t framesInFlight );
+        void            beginFrame();
+        /// Reserves `count` contiguous instances; returns nullptr when the ring is full.
+        GlyphInstance*  allocate( uint32_t count, uint32_t& firstInstance );
+
+        uint32_t        capacity() const;
+        uint32_t        used() const;
+
+    private:
+        static constexpr uint32_t kMaxFrames = 8;
+
+        GlyphInstance*  _storage;
+        uint32_t        _capacity;
+        uint32_t        _framesInFlight;
+        uint32_t        _head;
+        uint32_t        _tail;
+        uint32_t        _used;
+        uint32_t        _frameUsed[kMaxFrames];
+        uint32_t        _frameCount;
+        uint32_t        _frame;
+    };
+
+    struct TextBatchStats
+    {
+        uint32_t    submitted;      // strings this frame
+        uint32_t    cacheHits;
+        uint32_t    layouts;        // strings laid out from scratch
+        uint32_t    glyphs;         // instances written to the ring
+        uint32_t    dropped;        // instances that did not fit
+        uint32_t    allocations;    // heap growths inside the batch (vectors, cache nodes)
+        uint32_t    evictions;
+    };
+
+    /// Collects every string drawn in a frame into the ring, reusing the
+    /// layout of strings whose content hash did not change.
+    class TextBatch
+    {
+    public:
+        TextBatch();
+
+        void                            reset( GlyphInstance* storage, uint32_t capacity, uint32_t framesInFlight );
+        void                            beginFrame();
+        RingSpan                        submit( std::string_view str, const GlyphProvider& glyphs, const TextStyle& style );
+
+        /// Ring ranges to draw this frame, merged when contiguous (one draw unless the ring wrapped).
+        const std::vector<RingSpan>&    drawRanges() const;
+        const TextBatchStats&           stats() const;
+        size_t                          cachedStrings() const;
+
+        /// Cached layouts untouched for this many frames are dropped.
+        static constexpr uint64_t       kEvictAfterFrames = 120;
+
+    private:
+        /// The inputs are kept so a hash collision lays out again instead
+        /// of drawing another string's glyphs.
+        struct CachedRun
+        {
+            std::vector<GlyphInstance>  glyphs;
+            uint64_t                    lastUsedFrame;
+            std::string                 text;
+            TextStyle                   style;
+            const GlyphProvider*        pGlyphs;
+            uint64_t                    generation;
+
+            bool                        matches( std::string_view str, const GlyphProvider& glyphs, const TextStyle& style ) const;
+        };
+
+        void                            appendRange( uint32_t first, uint32_t count );
+        void                            evictStale();
+
+        GlyphRing                                   _ring;
+        std::unordered_map<uint64_t, CachedRun>     _cache;
+        std::vector<std::vector<GlyphInstance>>     _spareVectors;
+        std::vector<RingSpan>                       _ranges;
+        TextBatchStats                              _stats;
+        uint64_t                                    _frame;
+    };
+}
+
+#endif /* RMDLTEXTBATCH_HPP */
@@ -0,0 +1,139 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLTextRenderer.cpp         +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 11:02:52      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <algorithm>
+
+#include "RMDLTextRenderer.hpp"
+#include "RMDLMeshUtils.hpp"
+
+struct TextUniforms
+{
+    float invViewportSize[2];
+};
+
+TextRenderer::TextRenderer( MTL::Device* pDevice, MTL::Library* pShaderLibrary, MTL::PixelFormat colorPixelFormat,
+                            uint32_t maxGlyphs, uint32_t framesInFlight )
+: _pDevice( pDevice->retain() )
+, _pPSO( nullptr )
+, _pSdfPSO( nullptr )
+, _framesInFlight( std::clamp(framesInFlight, 1u, kMaxFrames) )
+, _frameIndex( 0 )
+{
+    _pInstanceBuffer = _pDevice->newBuffer( maxGlyphs * sizeof(text::GlyphInstance), MTL::ResourceStorageModeShared );
+    _pInstanceBuffer->setLabel( MTLSTR("Text Glyph Instances") );
+    _batch.reset( (text::GlyphInstance *)_pInstanceBuffer->contents(), maxGlyphs, _framesInFlight );
+
+    _pQuadIndexBuffer = mesh_utils::newUnitQuadIndexBuffer( _pDevice );
+
+    for (uint32_t i = 0; i < kMaxFrames; ++i)
+    {
+        _pUniformBuffer[i] = _pDevice->newBuffer( sizeof(TextUniforms), MTL::ResourceStorageModeShared );
+    }
+
+    NS::Error* pError = nullptr;
+    NS::SharedPtr<MTL4::CompilerDescriptor> compilerDesc = NS::TransferPtr( MTL4::CompilerDescriptor::alloc()->init() );
+    NS::SharedPtr<MTL4::Compiler> compiler = NS::TransferPtr( _pDevice->newCompiler( compilerDesc.get(), &pError ) );
+    _pPSO = newPipeline( compiler.get(), pShaderLibrary, colorPixelFormat, MTLSTR("Text"), MTLSTR("TextGlyphPs") );
+    _pSdfPSO = newPipeline( compiler.get(), pShaderLibrary, colorPixelFormat, MTLSTR("Text SDF"), MTLSTR("TextSdfPs") );
+}
+
+MTL::RenderPipelineState* TextRenderer::newPipeline( MTL4::Compiler* pCompiler, MTL::Library* pShaderLibrary, MTL::PixelFormat colorPixelFormat,
+                                                     NS::String* pLabel, NS::String* pFragmentName )
+{
+    NS::Error* pError = nullptr;
+    NS::SharedPtr<MTL4::RenderPipelineDescriptor> pRenderPipDesc = NS::TransferPtr( MTL4::RenderPipelineDescriptor::alloc()->init() );
+    pRenderPipDesc->setLabel( pLabel );
+
+    NS::SharedPtr<MTL4::LibraryFunctionDescriptor> vertexFunction = NS::TransferPtr( MTL4::LibraryFunctionDescriptor::alloc()->init() );
+    vertexFunction->setName( MTLSTR("TextGlyphVs") );
+    vertexFunction->setLibrary( pShaderLibrary );
+    pRenderPipDesc->setVertexFunctionDescriptor( vertexFunction.get() );
+
+    NS::SharedPtr<MTL4::LibraryFunctionDescriptor> fragmentFunction = NS::TransferPtr( MTL4::LibraryFunctionDescriptor::alloc()->init() );
+    fragmentFunction->setName( pFragmentName );
+    fragmentFunction->setLibrary( pShaderLibrary );
+    pRenderPipDesc->setFragmentFunctionDescriptor( fragmentFunction.get() );
+
+    MTL4::RenderPipelineColorAttachmentDescriptor* pColor = pRenderPipDesc->colorAttachments()->object(0);
+    pColor->setPixelFormat( colorPixelFormat );
+    pColor->setBlendingState( MTL4::BlendStateEnabled );
+    pColor->setSourceRGBBlendFactor( MTL::BlendFactorSourceAlpha );
+    pColor->setDestinationRGBBlendFactor( MTL::BlendFactorOneMinusSourceAlpha );
+    pColor->setSourceAlphaBlendFactor( MTL::BlendFactorOne );
+    pColor->setDestinationAlphaBlendFactor( MTL::BlendFactorOneMinusSourceAlpha );
+
+    MTL::RenderPipelineState* pPSO = pCompiler->newRenderPipelineState( pRenderPipDesc.get(), nullptr, &pError );
+    if (!pPSO)
+    {
+        printf("Error building text pipeline: %s\n", pError->localizedDescription()->utf8String());
+        assert(pPSO);
+    }
+    return (pPSO);
+}
+
+TextRenderer::~TextRenderer()
+{
+    for (uint32_t i = 0; i < kMaxFrames; ++i)
+    {
+        _pUniformBuffer[i]->release();
+    }
+    _pQuadIndexBuffer->release();
+    _pInstanceBuffer->release();
+    _pSdfPSO->release();
+    _pPSO->release();
+    _pDevice->release();
+}
+
+void TextRenderer::beginFrame( uint32_t frameIndex, float viewportWidth, float viewportHeight )
+{
+    _frameIndex = frameIndex % _framesInFlight;
+    _batch.beginFrame();
+
+    TextUniforms* pUniforms = (TextUniforms *)_pUniformBuffer[_frameIndex]->contents();
+    pUniforms->invViewportSize[0] = 1.f / viewportWidth;
+    pUniforms->invViewportSize[1] = 1.f / viewportHeight;
+}
+
+text::RingSpan TextRenderer::drawText( std::string_view str, const text::GlyphProvider& glyphs, const text::TextStyle& style )
+{
+    return (_batch.submit(str, glyphs, style));
+}
+
+void TextRenderer::encode( MTL4::RenderCommandEncoder* pEncoder, MTL4::ArgumentTable* pArgumentTable,
+                           MTL::Texture* pAtlas, bool signedDistance )
+{
+    const std::vector<text::RingSpan>& ranges = _batch.drawRanges();
+    if (ranges.empty())
+        return;
+
+    pArgumentTable->setAddress( _pInstanceBuffer->gpuAddress(), 0 );
+    pArgumentTable->setAddress( _pUniformBuffer[_frameIndex]->gpuAddress(), 1 );
+    pArgumentTable->setTexture( pAtlas->gpuResourceID(), 0 );
+
+    pEncoder->setRenderPipelineState( signedDistance ? _pSdfPSO : _pPSO );
+    pEncoder->setArgumentTable( pArgumentTable, MTL::RenderStageVertex | MTL::RenderStageFragment );
+    for (const text::RingSpan& range : ranges)
+    {
+        // instance_id includes baseInstance, so the shader indexes the ring directly.
+        pEncoder->drawIndexedPrimitives( MTL::PrimitiveTypeTriangle, 6, MTL::IndexTypeUInt16,
+                                         _pQuadIndexBuffer->gpuAddress(), _pQuadIndexBuffer->length(),
+                                         range.count, 0, range.first );
+    }
+}
+
+const text::TextBatchStats& TextRenderer::stats() const
+{
+    return (_batch.stats());
+}
+
+MTL::Buffer* TextRenderer::instanceBuffer() const
+{
+    return (_pInstanceBuffer);
+}
@@ -0,0 +1,55 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLTextRenderer.hpp         +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 11:02:48      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLTEXTRENDERER_HPP
+# define RMDLTEXTRENDERER_HPP
+
+# include <Metal/Metal.hpp>
+
+# include "RMDLTextBatch.hpp"
+# include "RMDLFontLoader.h"
+# include "NonCopyable.h"
+
+/// Draws every glyph submitted to its text::TextBatch in one instanced draw
+/// per contiguous ring range, out of a single persistent instance buffer.
+/// The atlas is either a coverage bitmap (FontAtlas) or a distance field (SdfFontAtlas).
+class TextRenderer : public NonCopyable
+{
+public:
+    TextRenderer( MTL::Device* pDevice, MTL::Library* pShaderLibrary, MTL::PixelFormat colorPixelFormat,
+                  uint32_t maxGlyphs, uint32_t framesInFlight );
+    ~TextRenderer();
+
+    void                beginFrame( uint32_t frameIndex, float viewportWidth, float viewportHeight );
+    text::RingSpan      drawText( std::string_view str, const text::GlyphProvider& glyphs, const text::TextStyle& style );
+    void                encode( MTL4::RenderCommandEncoder* pEncoder, MTL4::ArgumentTable* pArgumentTable,
+                                MTL::Texture* pAtlas, bool signedDistance = false );
+
+    const text::TextBatchStats& stats() const;
+    MTL::Buffer*        instanceBuffer() const;
+
+private:
+    static constexpr uint32_t kMaxFrames = 4;
+
+    MTL::RenderPipelineState*   newPipeline( MTL4::Compiler* pCompiler, MTL::Library* pShaderLibrary, MTL::PixelFormat colorPixelFormat,
+                                             NS::String* pLabel, NS::String* pFragmentName );
+
+    MTL::Device*                _pDevice;
+    MTL::RenderPipelineState*   _pPSO;
+    MTL::RenderPipelineState*   _pSdfPSO;
+    MTL::Buffer*                _pInstanceBuffer;
+    MTL::Buffer*                _pQuadIndexBuffer;
+    MTL::Buffer*                _pUniformBuffer[kMaxFrames];
+    uint32_t                    _framesInFlight;
+    uint32_t                    _frameIndex;
+    text::TextBatch             _batch;
+};
+
+#endif /* RMDLTEXTRENDERER_HPP */
@@ -0,0 +1,652 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLTextureCooker.cpp        +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 17:52:36      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLTextureCooker.hpp"
+#include "RMDLParallel.hpp"
+#include "RMDLFloat4.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace texture_utils
+{
+
+namespace
+{
+    // BC7 4-bit index interpolation weights, in 64ths.
+    constexpr int kWeights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    struct BitWriter
+    {
+        uint8_t*    out;
+        uint32_t    pos = 0;
+
+        void write( uint32_t value, uint32_t bits )
+        {
+            for (uint32_t i = 0; i < bits; ++i, ++pos)
+            {
+                if (value & (1u << i))
+                    out[pos >> 3] |= (uint8_t)(1u << (pos & 7));
+            }
+        }
+    };
+
+    struct BitReader
+    {
+        const uint8_t*  in;
+        uint32_t        pos = 0;
+
+        uint32_t read( uint32_t bits )
+        {
+            uint32_t value = 0;
+            for (uint32_t i = 0; i < bits; ++i, ++pos)
+                value |= (uint32_t)((in[pos >> 3] >> (pos & 7)) & 1) << i;
+            return (value);
+        }
+    };
+
+#pragma mark - BC7 mode 6
+
+    // Mode 6: one subset, RGBA endpoints 7 bits + one p-bit each, 4-bit indices.
+    struct Mode6
+    {
+        uint8_t     q[2][4];        // 7-bit endpoints
+        uint8_t     p[2];
+        uint8_t     indices[16];
+        float       error;
+    };
+
+    inline Float4 unquantize( const uint8_t q[4], uint8_t p )
+    {
+        return (Float4::make((float)((q[0] << 1) | p), (float)((q[1] << 1) | p),
+                             (float)((q[2] << 1) | p), (float)((q[3] << 1) | p)));
+    }
+
+    inline void quantize( Float4 endpoint, uint8_t p, uint8_t q[4] )
+    {
+        float e[4];
+        endpoint.store(e);
+        for (int c = 0; c < 4; ++c)
+            q[c] = (uint8_t)std::clamp((int)std::lround((e[c] - p) * 0.5f), 0, 127);
+    }
+
+    // Picks the palette entry closest to each texel; returns the squared error.
+    float assignIndices( const Float4 texels[16], Mode6& m )
+    {
+        const Float4 e0 = unquantize(m.q[0], m.p[0]);
+        const Float4 e1 = unquantize(m.q[1], m.p[1]);
+
+        // Project on the endpoint axis first: the nearest entry is next to the projection.
+        const Float4 axis = e1 - e0;
+        const float axisLength2 = dot(axis, axis);
+        Float4 palette[16];
+        for (int i = 0; i < 16; ++i)
+        {
+            // Same rounding as the hardware: ((64 - w) * e0 + w * e1 + 32) >> 6.
+            float v[4], a[4], b[4];
+            e0.store(a);
+            e1.store(b);
+            for (int c = 0; c < 4; ++c)
+                v[c] = (float)((((64 - kWeights4[i]) * (int)a[c] + kWeights4[i] * (int)b[c] + 32) >> 6));
+            palette[i] = Float4::load(v);
+        }
+
+        float total = 0.f;
+        for (int t = 0; t < 16; ++t)
+        {
+            int guess = 0;
+            if (axisLength2 > 0.f)
+            {
+                const float s = dot(texels[t] - e0, axis) / axisLength2;
+                guess = (int)std::lround(std::clamp(s, 0.f, 1.f) * 15.f);
+            }
+            int best = guess;
+            Float4 d = texels[t] - palette[guess];
+            float bestError = dot(d, d);
+            for (int i = std::max(0, guess - 2); i <= std::min(15, guess + 2); ++i)
+            {
+                d = texels[t] - palette[i];
+                const float error = dot(d, d);
+                if (error < bestError)
+                {
+                    bestError = error;
+                    best = i;
+                }
+            }
+            m.indices[t] = (uint8_t)best;
+            total += bestError;
+        }
+        m.error = total;
+        return (total);
+    }
+
+    // Endpoints that minimise the squared error for fixed indices (per channel least squares).
+    bool solveEndpoints( const Float4 texels[16], const uint8_t indices[16], Float4& e0, Float4& e1 )
+    {
+        float aa = 0.f, ab = 0.f, bb = 0.f;
+        Float4 ax = Float4::zero(), bx = Float4::zero();
+        for (int t = 0; t < 16; ++t)
+        {
+            const float w = kWeights4[indices[t]] / 64.f;
+            const float a = 1.f - w;
+            aa += a * a;
+            ab += a * w;
+            bb += w * w;
+            ax = ax.madd(texels[t], a);
+            bx = bx.madd(texels[t], w);
+        }
+        const float det = aa * bb - ab * ab;
+        if (std::fabs(det) < 1e-6f)
+            return (false);
+        const float inv = 1.f / det;
+        e0 = (ax * bb - bx * ab) * inv;
+        e1 = (bx * aa - ax * ab) * inv;
+        const Float4 lo = Float4::zero(), hi = Float4::splat(255.f);
+        e0 = e0.max(lo).min(hi);
+        e1 = e1.max(lo).min(hi);
+        return (true);
+    }
+
+    void fitMode6( const Float4 texels[16], Float4 e0, Float4 e1, bool allPBits, Mode6& best )
+    {
+        const int pCount = allPBits ? 4 : 1;
+        for (int pp = 0; pp < pCount; ++pp)
+        {
+            Mode6 m;
+            if (allPBits)
+            {
+                m.p[0] = (uint8_t)(pp & 1);
+                m.p[1] = (uint8_t)(pp >> 1);
+            }
+            else
+            {
+                // The p-bit that brings each endpoint closest to its ideal value.
+                for (int e = 0; e < 2; ++e)
+                {
+                    const Float4 ideal = e == 0 ? e0 : e1;
+                    float bestError = 1e30f;
+                    for (uint8_t p = 0; p < 2; ++p)
+                    {
+                        uint8_t q[4];
+                        quantize(ideal, p, q);
+                        const Float4 d = unquantize(q, p) - ideal;
+                        if (dot(d, d) < bestError)
+                        {
+                            bestError = dot(d, d);
+                            m.p[e] = p;
+                        }
+                    }
+                }
+            }
+            quantize(e0, m.p[0], m.q[0]);
+            quantize(e1, m.p[1], m.q[1]);
+            if (assignIndices(texels, m) < best.error)
+                best = m;
+        }
+    }
+
+    void encodeMode6( const Float4 texels[16], CookQuality quality, Mode6& best )
+    {
+        // Principal axis of the block by power iteration on the covariance.
+        Float4 mean = Float4::zero();
+        for (int t = 0; t < 16; ++t)
+            mean = mean + texels[t];
+        mean = mean * (1.f / 16.f);
+
+        float cov[4][4] = {};
+        for (int t = 0; t < 16; ++t)
+        {
+            float d[4];
+            (texels[t] - mean).store(d);
+            for (int i = 0; i < 4; ++i)
+                for (int j = i; j < 4; ++j)
+                    cov[i][j] += d[i] * d[j];
+        }
+        for (int i = 0; i < 4; ++i)
+            for (int j = 0; j < i; ++j)
+                cov[i][j] = cov[j][i];
+
+        Float4 axis = Float4::make(1.f, 1.f, 1.f, 0.25f);
+        for (int iter = 0; iter < 8; ++iter)
+        {
+            float a[4], r[4];
+            axis.store(a);
+            for (int i = 0; i < 4; ++i)
+                r[i] = cov[i][0] * a[0] + cov[i][1] * a[1] + cov[i][2] * a[2] + cov[i][3] * a[3];
+            const Float4 next = Float4::load(r);
+            const float length2 = dot(next, next);
+            if (length2 < 1e-12f)
+                break;
+            axis = next * (1.f / std::sqrt(length2));
+        }
+
+        float lo = 0.f, hi = 0.f;
+        for (int t = 0; t < 16; ++t)
+        {
+            const float s = dot(texels[t] - mean, axis);
+            lo = std::min(lo, s);
+            hi = std::max(hi, s);
+        }
+        const Float4 clampLo = Float4::zero(), clampHi = Float4::splat(255.f);
+        Float4 e0 = mean.madd(axis, lo).max(clampLo).min(clampHi);
+        Float4 e1 = mean.madd(axis, hi).max(clampLo).min(clampHi);
+
+        const bool thorough = quality == CookQuality::Quality;
+        best.error = 1e30f;
+        fitMode6(texels, e0, e1, thorough, best);
+
+        const int passes = thorough ? 8 : 1;
+        for (int pass = 0; pass < passes && best.error > 0.f; ++pass)
+        {
+            const float before = best.error;
+            if (!solveEndpoints(texels, best.indices, e0, e1))
+                break;
+            fitMode6(texels, e0, e1, thorough, best);
+            if (best.error >= before)
+                break;
+        }
+    }
+
+#pragma mark - BC4
+
+    // One BC4 channel: 8-bit endpoints, 3-bit indices.
+    struct BC4
+    {
+        uint8_t     e0, e1;
+        uint8_t     indices[16];
+        uint32_t    error;
+    };
+
+    void bc4Palette( uint8_t e0, uint8_t e1, int palette[8] )
+    {
+        palette[0] = e0;
+        palette[1] = e1;
+        if (e0 > e1)
+        {
+            for (int i = 2; i < 8; ++i)
+                palette[i] = ((8 - i) * e0 + (i - 1) * e1) / 7;
+        }
+        else
+        {
+            for (int i = 2; i < 6; ++i)
+                palette[i] = ((6 - i) * e0 + (i - 1) * e1) / 5;
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+    }
+
+    void bc4Assign( const uint8_t values[16], BC4& b )
+    {
+        int palette[8];
+        bc4Palette(b.e0, b.e1, palette);
+        b.error = 0;
+        for (int t = 0; t < 16; ++t)
+        {
+            int best = 0, bestError = INT32_MAX;
+            for (int i = 0; i < 8; ++i)
+            {
+                const int d = (int)values[t] - palette[i];
+                if (d * d < bestError)
+                {
+                    bestError = d * d;
+                    best = i;
+                }
+            }
+            b.indices[t] = (uint8_t)best;
+            b.error += (uint32_t)bestError;
+        }
+    }
+
+    void encodeBC4( const uint8_t values[16], CookQuality quality, uint8_t out[8] )
+    {
+        uint8_t lo = 255, hi = 0;
+        uint8_t innerLo = 255, innerHi = 0;
+        for (int t = 0; t < 16; ++t)
+        {
+            lo = std::min(lo, values[t]);
+            hi = std::max(hi, values[t]);
+            if (values[t] != 0 && values[t] != 255)
+            {
+                innerLo = std::min(innerLo, values[t]);
+                innerHi = std::max(innerHi, values[t]);
+            }
+        }
+
+        BC4 best;
+        best.e0 = hi;
+        best.e1 = lo;
+        bc4Assign(values, best);
+
+        if (quality == CookQuality::Quality && best.error > 0)
+        {
+            // Nudge the endpoints inwards / outwards, and try the 6-value mode with exact 0 and 255.
+            for (int d0 = -2; d0 <= 2; ++d0)
+            {
+                for (int d1 = -2; d1 <= 2; ++d1)
+                {
+                    BC4 candidate;
+                    candidate.e0 = (uint8_t)std::clamp((int)hi + d0, 0, 255);
+                    candidate.e1 = (uint8_t)std::clamp((int)lo + d1, 0, 255);
+                    if (candidate.e0 <= candidate.e1)
+                        continue;
+                    bc4Assign(values, candidate);
+                    if (candidate.error < best.error)
+                        best = candidate;
+                }
+            }
+            if (innerLo <= innerHi)
+            {
+                BC4 candidate;
+                candidate.e0 = innerLo;
+                candidate.e1 = innerHi;
+                bc4Assign(values, candidate);
+                if (candidate.error < best.error)
+                    best = candidate;
+            }
+        }
+
+        std::memset(out, 0, 8);
+        BitWriter writer{ out };
+        writer.write(best.e0, 8);
+        writer.write(best.e1, 8);
+        for (int t = 0; t < 16; ++t)
+            writer.write(best.indices[t], 3);
+    }
+
+    void decodeBC4( const uint8_t in[8], uint8_t values[16] )
+    {
+        int palette[8];
+        bc4Palette(in[0], in[1], palette);
+        BitReader reader{ in, 16 };
+        for (int t = 0; t < 16; ++t)
+            values[t] = (uint8_t)palette[reader.read(3)];
+    }
+
+    uint32_t blockBytes( BlockFormat )
+    {
+        return (16);    // both BC7 and BC5
+    }
+}
+
+#pragma mark - Blocks
+
+void encodeBC7Block( const uint8_t rgba[64], CookQuality quality, uint8_t out[16] )
+{
+    Float4 texels[16];
+    for (int t = 0; t < 16; ++t)
+        texels[t] = Float4::make(rgba[4 * t], rgba[4 * t + 1], rgba[4 * t + 2], rgba[4 * t + 3]);
+
+    Mode6 m;
+    encodeMode6(texels, quality, m);
+
+    // The anchor (texel 0) index has an implicit 0 top bit: flip the block if it is set.
+    if (m.indices[0] & 8)
+    {
+        std::swap(m.q[0], m.q[1]);
+        std::swap(m.p[0], m.p[1]);
+        for (int t = 0; t < 16; ++t)
+            m.indices[t] = (uint8_t)(15 - m.indices[t]);
+    }
+
+    std::memset(out, 0, 16);
+    BitWriter writer{ out };
+    writer.write(1u << 6, 7);
+    for (int c = 0; c < 4; ++c)
+    {
+        writer.write(m.q[0][c], 7);
+        writer.write(m.q[1][c], 7);
+    }
+    writer.write(m.p[0], 1);
+    writer.write(m.p[1], 1);
+    writer.write(m.indices[0], 3);
+    for (int t = 1; t < 16; ++t)
+        writer.write(m.indices[t], 4);
+}
+
+void encodeBC5Block( const uint8_t rgba[64], CookQuality quality, uint8_t out[16] )
+{
+    uint8_t red[16], green[16];
+    for (int t = 0; t < 16; ++t)
+    {
+        red[t] = rgba[4 * t];
+        green[t] = rgba[4 * t + 1];
+    }
+    encodeBC4(red, quality, out);
+    encodeBC4(green, quality, out + 8);
+}
+
+bool decodeBC7Block( const uint8_t block[16], uint8_t rgba[64] )
+{
+    BitReader reader{ block };
+    if (reader.read(7) != (1u << 6))
+        return (false);
+
+    uint32_t q[2][4];
+    for (int c = 0; c < 4; ++c)
+    {
+        q[0][c] = reader.read(7);
+        q[1][c] = reader.read(7);
+    }
+    const uint32_t p0 = reader.read(1);
+    const uint32_t p1 = reader.read(1);
+    for (int t = 0; t < 16; ++t)
+    {
+        const uint32_t index = reader.read(t == 0 ? 3 : 4);
+        const int w = kWeights4[index];
+        for (int c = 0; c < 4; ++c)
+        {
+            const int a = (int)((q[0][c] << 1) | p0);
+            const int b = (int)((q[1][c] << 1) | p1);
+            rgba[4 * t + c] = (uint8_t)(((64 - w) * a + w * b + 32) >> 6);
+        }
+    }
+    return (true);
+}
+
+void decodeBC5Block( const uint8_t block[16], uint8_t rgba[64] )
+{
+    uint8_t red[16], green[16];
+    decodeBC4(block, red);
+    decodeBC4(block + 8, green);
+    for (int t = 0; t < 16; ++t)
+    {
+        rgba[4 * t]     = red[t];
+        rgba[4 * t + 1] = green[t];
+        rgba[4 * t + 2] = 0;
+        rgba[4 * t + 3] = 255;
+    }
+}
+
+#pragma mark - Images
+
+void compressImage( const Image& image, BlockFormat format, CookQuality quality, std::vector<uint8_t>& blocks )
+{
+    const uint32_t bw = (image.width + 3) / 4;
+    const uint32_t bh = (image.height + 3) / 4;
+    blocks.resize((size_t)bw * bh * blockBytes(format));
+
+    parallel::forRange(bh, 1, [&]( size_t begin, size_t end ) {
+        uint8_t texels[64];
+        for (size_t by = begin; by < end; ++by)
+        {
+            for (uint32_t bx = 0; bx < bw; ++bx)
+            {
+                for (uint32_t t = 0; t < 16; ++t)
+                {
+                    const uint32_t x = std::min(bx * 4 + (t & 3), image.width - 1);
+                    const uint32_t y = std::min((uint32_t)by * 4 + (t >> 2), image.height - 1);
+                    std::memcpy(&texels[4 * t], &image.rgba[((size_t)y * image.width + x) * 4], 4);
+                }
+                uint8_t* out = &blocks[((size_t)by * bw + bx) * blockBytes(format)];
+                if (format == BlockFormat::BC7)
+                    encodeBC7Block(texels, quality, out);
+                else
+                    encodeBC5Block(texels, quality, out);
+            }
+        }
+    });
+}
+
+void decompressImage( const std::vector<uint8_t>& blocks, BlockFormat format, uint32_t width, uint32_t height, Image& image )
+{
+    const uint32_t bw = (width + 3) / 4;
+    const uint32_t bh = (height + 3) / 4;
+    image.width = width;
+    image.height = height;
+    image.rgba.assign((size_t)width * height * 4, 0);
+
+    uint8_t texels[64];
+    for (uint32_t by = 0; by < bh; ++by)
+    {
+        for (uint32_t bx = 0; bx < bw; ++bx)
+        {
+            const uint8_t* in = &blocks[((size_t)by * bw + bx) * blockBytes(format)];
+            if (format == BlockFormat::BC7)
+                decodeBC7Block(in, texels);
+            else
+                decodeBC5Block(in, texels);
+            for (uint32_t t = 0; t < 16; ++t)
+            {
+                const uint32_t x = bx * 4 + (t & 3);
+                const uint32_t y = by * 4 + (t >> 2);
+                if (x < width && y < height)
+                    std::memcpy(&image.rgba[((size_t)y * width + x) * 4], &texels[4 * t], 4);
+            }
+        }
+    }
+}
+
+void cookTexture( const Image& base, const CookDesc& desc, CookedTexture& cooked )
+{
+    MipChainDesc mips = desc.mips;
+    if (desc.format == BlockFormat::BC5)
+        mips.srgb = false;      // normals are linear data
+
+    std::vector<Image> levels;
+    buildMipChain(base, mips, levels);
+
+    cooked.format = desc.format;
+    cooked.srgb = desc.format == BlockFormat::BC7 && mips.srgb;
+    cooked.levels.clear();
+    cooked.data.clear();
+
+    std::vector<uint8_t> blocks;
+    for (const Image& level : levels)
+    {
+        compressImage(level, desc.format, desc.quality, blocks);
+        CookedLevel out;
+        out.width       = level.width;
+        out.height      = level.height;
+        out.bytesPerRow = ((level.width + 3) / 4) * blockBytes(desc.format);
+        out.offset      = cooked.data.size();
+        out.size        = blocks.size();
+        cooked.levels.push_back(out);
+        cooked.data.insert(cooked.data.end(), blocks.begin(), blocks.end());
+    }
+}
+
+#pragma mark - Container
+
+namespace
+{
+    constexpr uint32_t kCookedVersion = 1;
+
+    struct CookedHeader
+    {
+        char        magic[4];
+        uint32_t    version;
+        uint32_t    format;
+        uint32_t    srgb;
+        uint32_t    levelCount;
+        uint32_t    reserved;
+        uint64_t    dataSize;
+    };
+}
+
+bool saveCookedTexture( const std::string& path, const CookedTexture& cooked )
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        return (false);
+
+    CookedHeader header = {};
+    std::memcpy(header.magic, "RTEX", 4);
+    header.version    = kCookedVersion;
+    header.format     = (uint32_t)cooked.format;
+    header.srgb       = cooked.srgb ? 1 : 0;
+    header.levelCount = (uint32_t)cooked.levels.size();
+    header.dataSize   = cooked.data.size();
+
+    out.write((const char *)&header, sizeof(header));
+    out.write((const char *)cooked.levels.data(), cooked.levels.size() * sizeof(CookedLevel));
+    out.write((const char *)cooked.data.data(), cooked.data.size());
+    return ((bool)out);
+}
+
+bool loadCookedTexture( const std::string& path, CookedTexture& cooked )
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        return (false);
+
+    CookedHeader header;
+    if (!in.read((char *)&header, sizeof(header)))
+        return (false);
+    if (std::memcmp(header.magic, "RTEX", 4) != 0 || header.version != kCookedVersion || header.levelCount > 32)
+        return (false);
+    if (header.format != (uint32_t)BlockFormat::BC7 && header.format != (uint32_t)BlockFormat::BC5)
+        return (false);
+
+    if (header.levelCount == 0)
+        return (false);
+
+    // The rest of the file must be exactly the level table and the data, before
+    // anything is allocated from the header.
+    const std::streamoff tableStart = in.tellg();
+    in.seekg(0, std::ios::end);
+    const uint64_t remaining = (uint64_t)(in.tellg() - tableStart);
+    in.seekg(tableStart);
+    const uint64_t tableSize = (uint64_t)header.levelCount * sizeof(CookedLevel);
+    if (!in || remaining < tableSize || header.dataSize != remaining - tableSize)
+        return (false);
+
+    CookedTexture loaded;
+    loaded.format = (BlockFormat)header.format;
+    loaded.srgb = header.srgb != 0;
+    loaded.levels.resize(header.levelCount);
+    if (!in.read((char *)loaded.levels.data(), loaded.levels.size() * sizeof(CookedLevel)))
+        return (false);
+
+    // Every level must be what cookTexture() would have written for this format,
+    // so the upload can trust widths, rows and sizes.
+    const CookedLevel& base = loaded.levels[0];
+    if (base.width == 0 || base.height == 0 || header.levelCount > mipLevelCount(base.width, base.height))
+        return (false);
+    for (uint32_t i = 0; i < header.levelCount; ++i)
+    {
+        const CookedLevel& level = loaded.levels[i];
+        const uint32_t bytesPerRow = ((std::max(1u, base.width >> i) + 3) / 4) * blockBytes(loaded.format);
+        if (level.width != std::max(1u, base.width >> i) || level.height != std::max(1u, base.height >> i)
+            || level.bytesPerRow != bytesPerRow || level.size != (uint64_t)bytesPerRow * ((level.height + 3) / 4))
+            return (false);
+        if (level.offset > header.dataSize || level.size > header.dataSize - level.offset)
+            return (false);
+    }
+    loaded.data.resize(header.dataSize);
+    if (!in.read((char *)loaded.data.data(), loaded.data.size()))
+        return (false);
+
+    cooked = std::move(loaded);
+    return (true);
+}
+
+}
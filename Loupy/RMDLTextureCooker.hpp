@@ -0,0 +1,84 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLTextureCooker.hpp        +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 17:52:31      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLTEXTURECOOKER_HPP
+# define RMDLTEXTURECOOKER_HPP
+
+# include <cstdint>
+# include <string>
+# include <vector>
+
+# include "RMDLTextureUtils.hpp"
+
+// Offline block compression: BC7 for colour, BC5 for tangent-space normals
+// (X and Y only, Z = sqrt(1 - x^2 - y^2) in the shader). Cooked textures are
+// stored with their whole mip chain, laid out exactly as replaceRegion wants it.
+
+namespace texture_utils
+{
+    enum class BlockFormat : uint32_t
+    {
+        BC7     = 1,
+        BC5     = 2
+    };
+
+    enum class CookQuality : uint32_t
+    {
+        Fast,       // principal-axis endpoints, one refinement pass
+        Quality     // least-squares refinement until it stops improving, every p-bit pair
+    };
+
+    struct CookDesc
+    {
+        BlockFormat     format  = BlockFormat::BC7;
+        CookQuality     quality = CookQuality::Fast;
+        MipChainDesc    mips;                       // mips.srgb also selects the sRGB pixel format for BC7
+    };
+
+    /// One 4x4 block from 16 RGBA8 texels in row order to 16 bytes.
+    void    encodeBC7Block( const uint8_t rgba[64], CookQuality quality, uint8_t out[16] );
+    /// Uses the R and G channels.
+    void    encodeBC5Block( const uint8_t rgba[64], CookQuality quality, uint8_t out[16] );
+
+    /// Reference decoders, to measure encoder error. The BC7 one only knows mode 6,
+    /// the only mode encodeBC7Block emits, and returns false for anything else.
+    bool    decodeBC7Block( const uint8_t block[16], uint8_t rgba[64] );
+    void    decodeBC5Block( const uint8_t block[16], uint8_t rgba[64] );
+
+    /// Compresses a whole level in parallel over block rows. Edge blocks of sizes that
+    /// are not multiples of 4 repeat the last row / column.
+    void    compressImage( const Image& image, BlockFormat format, CookQuality quality, std::vector<uint8_t>& blocks );
+    void    decompressImage( const std::vector<uint8_t>& blocks, BlockFormat format, uint32_t width, uint32_t height, Image& image );
+
+    struct CookedLevel
+    {
+        uint32_t    width;
+        uint32_t    height;
+        uint32_t    bytesPerRow;    // one row of blocks
+        uint64_t    offset;         // into CookedTexture::data
+        uint64_t    size;
+    };
+
+    struct CookedTexture
+    {
+        BlockFormat                 format  = BlockFormat::BC7;
+        bool                        srgb    = false;
+        std::vector<CookedLevel>    levels;
+        std::vector<uint8_t>        data;
+    };
+
+    void    cookTexture( const Image& base, const CookDesc& desc, CookedTexture& cooked );
+    bool    saveCookedTexture( const std::string& path, const CookedTexture& cooked );
+    /// False when the file is missing, truncated, from another container version, or
+    /// when its levels do not match the sizes its format and base level imply.
+    bool    loadCookedTexture( const std::string& path, CookedTexture& cooked );
+}
+
+#endif /* RMDLTEXTURECOOKER_HPP */
@@ -0,0 +1,384 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLTextureUtils.cpp         +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 16:41:12      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLTextureUtils.hpp"
+#include "RMDLParallel.hpp"
+#include "RMDLFloat4.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace texture_utils
+{
+
+namespace
+{
+    struct FloatImage
+    {
+        uint32_t            width;
+        uint32_t            height;
+        std::vector<float>  rgba;
+    };
+
+    // 8-bit -> linear is exact through a 256-entry table; linear -> 8-bit uses a
+    // 16K table, fine enough to stay within half a code near black.
+    constexpr uint32_t kToSrgbSize = 16384;
+
+    struct SrgbTables
+    {
+        float   toLinear[256];
+        uint8_t toSrgb[kToSrgbSize];
+
+        SrgbTables()
+        {
+            for (uint32_t i = 0; i < 256; ++i)
+            {
+                const float c = i / 255.f;
+                toLinear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+            }
+            for (uint32_t i = 0; i < kToSrgbSize; ++i)
+            {
+                const float l = (i + 0.5f) / kToSrgbSize;
+                const float c = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.f / 2.4f) - 0.055f;
+                toSrgb[i] = (uint8_t)std::clamp(c * 255.f + 0.5f, 0.f, 255.f);
+            }
+        }
+    };
+
+    const SrgbTables& srgbTables()
+    {
+        static const SrgbTables tables;
+        return (tables);
+    }
+
+    void decodeRow( const uint8_t* src, uint32_t width, bool srgb, float* dst )
+    {
+        const SrgbTables& tables = srgbTables();
+        for (size_t i = 0; i < (size_t)width * 4; i += 4)
+        {
+            for (size_t c = 0; c < 3; ++c)
+                dst[i + c] = srgb ? tables.toLinear[src[i + c]] : src[i + c] * (1.f / 255.f);
+            dst[i + 3] = src[i + 3] * (1.f / 255.f);
+        }
+    }
+
+    // Level 0 is never expanded to float as a whole: rows are decoded as the first
+    // downsample reads them, which saves a full-resolution float copy per slice.
+    struct Rows
+    {
+        uint32_t                width;
+        uint32_t                height;
+        const float*            pFloat;     // float level
+        const Image*            pImage;     // or 8-bit base level
+        bool                    srgb;
+        mutable std::vector<float> scratch[2];
+
+        const float* row( uint32_t y, int slot ) const
+        {
+            if (pFloat)
+                return (pFloat + (size_t)y * width * 4);
+            scratch[slot].resize((size_t)width * 4);
+            decodeRow(&pImage->rgba[(size_t)y * width * 4], width, srgb, scratch[slot].data());
+            return (scratch[slot].data());
+        }
+    };
+
+    void encodeLevel( const FloatImage& src, bool srgb, Image& dst )
+    {
+        const SrgbTables& tables = srgbTables();
+        const size_t count = (size_t)src.width * src.height;
+        dst.width = src.width;
+        dst.height = src.height;
+        dst.rgba.resize(count * 4);
+        for (size_t i = 0; i < count * 4; i += 4)
+        {
+            for (size_t c = 0; c < 3; ++c)
+            {
+                const float v = std::clamp(src.rgba[i + c], 0.f, 1.f);
+                dst.rgba[i + c] = srgb ? tables.toSrgb[std::min((uint32_t)(v * kToSrgbSize), kToSrgbSize - 1)]
+                                       : (uint8_t)(v * 255.f + 0.5f);
+            }
+            dst.rgba[i + 3] = (uint8_t)(std::clamp(src.rgba[i + 3], 0.f, 1.f) * 255.f + 0.5f);
+        }
+    }
+
+    void downsampleBox( const Rows& src, FloatImage& dst )
+    {
+        dst.width = std::max(1u, src.width / 2);
+        dst.height = std::max(1u, src.height / 2);
+        dst.rgba.resize((size_t)dst.width * dst.height * 4);
+
+        for (uint32_t y = 0; y < dst.height; ++y)
+        {
+            const float* row0 = src.row(std::min(2 * y, src.height - 1), 0);
+            const float* row1 = src.row(std::min(2 * y + 1, src.height - 1), 1);
+            float* out = &dst.rgba[(size_t)y * dst.width * 4];
+            for (uint32_t x = 0; x < dst.width; ++x)
+            {
+                const size_t x0 = (size_t)std::min(2 * x, src.width - 1) * 4;
+                const size_t x1 = (size_t)std::min(2 * x + 1, src.width - 1) * 4;
+                const Float4 sum = Float4::load(row0 + x0) + Float4::load(row0 + x1)
+                                 + Float4::load(row1 + x0) + Float4::load(row1 + x1);
+                (sum * 0.25f).store(out + (size_t)x * 4);
+            }
+        }
+    }
+
+    float besselI0( float x )
+    {
+        float sum = 1.f, term = 1.f;
+        const float q = x * x * 0.25f;
+        for (int k = 1; k < 32 && term > sum * 1e-8f; ++k)
+        {
+            term *= q / (float)(k * k);
+            sum += term;
+        }
+        return (sum);
+    }
+
+    // Taps of a Kaiser-windowed sinc for one output coordinate on one axis.
+    struct Taps
+    {
+        std::vector<int32_t>    first;      // per output texel
+        std::vector<float>      weights;    // `count` per output texel
+        int32_t                 count;
+    };
+
+    void buildTaps( uint32_t srcSize, uint32_t dstSize, const MipChainDesc& desc, Taps& taps )
+    {
+        const float scale  = (float)srcSize / (float)dstSize;          // >= 1
+        const float radius = desc.kaiserWidth * scale;                 // in source texels
+        const float i0a    = besselI0(desc.kaiserAlpha);
+        taps.count = (int32_t)std::ceil(radius) * 2 + 1;
+        taps.first.resize(dstSize);
+        taps.weights.resize((size_t)dstSize * taps.count);
+
+        for (uint32_t x = 0; x < dstSize; ++x)
+        {
+            const float center = (x + 0.5f) * scale;
+            const int32_t first = (int32_t)std::floor(center - radius);
+            taps.first[x] = first;
+            float* w = &taps.weights[(size_t)x * taps.count];
+            float total = 0.f;
+            for (int32_t t = 0; t < taps.count; ++t)
+            {
+                const float d = ((float)(first + t) + 0.5f - center) / scale;   // destination texels
+                float weight = 0.f;
+                if (std::fabs(d) < desc.kaiserWidth)
+                {
+                    const float r = d / desc.kaiserWidth;
+                    const float sinc = d == 0.f ? 1.f : std::sin((float)M_PI * d) / ((float)M_PI * d);
+                    weight = sinc * besselI0(desc.kaiserAlpha * std::sqrt(1.f - r * r)) / i0a;
+                }
+                w[t] = weight;
+                total += weight;
+            }
+            for (int32_t t = 0; t < taps.count; ++t)
+                w[t] /= total;
+        }
+    }
+
+    void downsampleKaiser( const Rows& src, const MipChainDesc& desc, FloatImage& tmp, FloatImage& dst )
+    {
+        dst.width = std::max(1u, src.width / 2);
+        dst.height = std::max(1u, src.height / 2);
+
+        Taps horizontal, vertical;
+        buildTaps(src.width, dst.width, desc, horizontal);
+        buildTaps(src.height, dst.height, desc, vertical);
+
+        // Horizontal pass: src.height rows of dst.width texels.
+        tmp.width = dst.width;
+        tmp.height = src.height;
+        tmp.rgba.resize((size_t)tmp.width * tmp.height * 4);
+        for (uint32_t y = 0; y < src.height; ++y)
+        {
+            const float* row = src.row(y, 0);
+            float* out = &tmp.rgba[(size_t)y * tmp.width * 4];
+            for (uint32_t x = 0; x < dst.width; ++x)
+            {
+                const float* w = &horizontal.weights[(size_t)x * horizontal.count];
+                Float4 sum = Float4::zero();
+                for (int32_t t = 0; t < horizontal.count; ++t)
+                {
+                    const int32_t sx = std::clamp(horizontal.first[x] + t, 0, (int32_t)src.width - 1);
+                    sum = sum.madd(Float4::load(row + (size_t)sx * 4), w[t]);
+                }
+                sum.store(out + (size_t)x * 4);
+            }
+        }
+
+        // Vertical pass, whole rows at a time so the loads stay sequential.
+        dst.rgba.assign((size_t)dst.width * dst.height * 4, 0.f);
+        for (uint32_t y = 0; y < dst.height; ++y)
+        {
+            const float* w = &vertical.weights[(size_t)y * vertical.count];
+            float* out = &dst.rgba[(size_t)y * dst.width * 4];
+            for (int32_t t = 0; t < vertical.count; ++t)
+            {
+                if (w[t] == 0.f)
+                    continue;
+                const int32_t sy = std::clamp(vertical.first[y] + t, 0, (int32_t)tmp.height - 1);
+                const float* row = &tmp.rgba[(size_t)sy * tmp.width * 4];
+                for (uint32_t x = 0; x < dst.width; ++x)
+                    Float4::load(out + (size_t)x * 4).madd(Float4::load(row + (size_t)x * 4), w[t]).store(out + (size_t)x * 4);
+            }
+        }
+    }
+}
+
+#pragma mark - Mip chain
+
+uint32_t mipLevelCount( uint32_t width, uint32_t height )
+{
+    uint32_t size = std::max(width, height);
+    uint32_t levels = 1;
+    while (size > 1)
+    {
+        size >>= 1;
+        ++levels;
+    }
+    return (levels);
+}
+
+void buildMipChain( const Image& base, const MipChainDesc& desc, std::vector<Image>& levels )
+{
+    const uint32_t count = mipLevelCount(base.width, base.height);
+    levels.resize(count);
+    levels[0] = base;
+
+    FloatImage current, next, scratch;
+    Rows rows = { base.width, base.height, nullptr, &base, desc.srgb, {} };
+    for (uint32_t level = 1; level < count; ++level)
+    {
+        if (desc.filter == MipFilter::Kaiser)
+            downsampleKaiser(rows, desc, scratch, next);
+        else
+            downsampleBox(rows, next);
+        encodeLevel(next, desc.srgb, levels[level]);
+        std::swap(current, next);
+        rows = { current.width, current.height, current.rgba.data(), nullptr, desc.srgb, {} };
+    }
+}
+
+void unpremultiply( Image& image )
+{
+    for (size_t i = 0; i < image.rgba.size(); i += 4)
+    {
+        const uint32_t alpha = image.rgba[i + 3];
+        if (alpha == 0 || alpha == 255)
+            continue;
+        for (size_t c = 0; c < 3; ++c)
+            image.rgba[i + c] = (uint8_t)std::min(255u, (image.rgba[i + c] * 255u + alpha / 2) / alpha);
+    }
+}
+
+#pragma mark - SliceStream
+
+struct SliceStream::State
+{
+    Decoder                 decoder;
+    MipChainDesc            desc;
+    uint32_t                count = 0;
+    std::mutex              mutex;
+    std::condition_variable ready;
+    std::deque<Slice>       done;
+    uint32_t                running = 0;
+    std::condition_variable idle;
+};
+
+/// Hands one slice back when it goes out of scope, however the job ended, so
+/// `running` always reaches zero and ~SliceStream() cannot hang.
+struct SliceStream::Delivery
+{
+    State&  state;
+    Slice   slice;
+
+    Delivery( State& state, uint32_t index )
+    : state( state )
+    , slice{ index, false, {} }
+    {
+    }
+
+    ~Delivery()
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.done.push_back(std::move(slice));
+        --state.running;
+        state.ready.notify_one();
+        if (state.running == 0)
+            state.idle.notify_all();
+    }
+};
+
+SliceStream::SliceStream( const std::vector<std::string>& paths, Decoder decoder, const MipChainDesc& desc )
+: SliceStream( paths, std::move(decoder), desc, parallel::defaultPool() )
+{
+}
+
+SliceStream::SliceStream( const std::vector<std::string>& paths, Decoder decoder, const MipChainDesc& desc, parallel::ThreadPool& pool )
+: _pState( std::make_shared<State>() )
+, _delivered( 0 )
+{
+    _pState->decoder = std::move(decoder);
+    _pState->desc = desc;
+    _pState->count = (uint32_t)paths.size();
+    _pState->running = _pState->count;
+
+    for (uint32_t i = 0; i < _pState->count; ++i)
+    {
+        pool.enqueue( [pState = _pState, path = paths[i], i]() {
+            Delivery delivery(*pState, i);
+            Image base;
+            try
+            {
+                delivery.slice.ok = pState->decoder(path, base) && base.width && base.height;
+                if (delivery.slice.ok)
+                    buildMipChain(base, pState->desc, delivery.slice.levels);
+            }
+            catch (...)
+            {
+                // A throwing decoder must not take the pool worker with it; the slice just fails.
+                delivery.slice.ok = false;
+                delivery.slice.levels.clear();
+            }
+        });
+    }
+}
+
+SliceStream::~SliceStream()
+{
+    // The decoder may capture things owned by the caller: do not return while it can still run.
+    std::unique_lock<std::mutex> lock(_pState->mutex);
+    _pState->idle.wait(lock, [this]() { return (_pState->running == 0); });
+}
+
+bool SliceStream::next( Slice& slice )
+{
+    if (_delivered == _pState->count)
+        return (false);
+
+    std::unique_lock<std::mutex> lock(_pState->mutex);
+    _pState->ready.wait(lock, [this]() { return (!_pState->done.empty()); });
+    slice = std::move(_pState->done.front());
+    _pState->done.pop_front();
+    ++_delivered;
+    return (true);
+}
+
+uint32_t SliceStream::sliceCount() const
+{
+    return (_pState->count);
+}
+
+}
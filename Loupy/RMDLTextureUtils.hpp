@@ -0,0 +1,97 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLTextureUtils.hpp         +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 19/10/2026 16:41:07      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLTEXTUREUTILS_HPP
+# define RMDLTEXTUREUTILS_HPP
+
+# include <cstdint>
+# include <functional>
+# include <memory>
+# include <string>
+# include <vector>
+
+# include "NonCopyable.h"
+
+// CPU side of texture building: mip chains and the worker-thread pipeline
+// that feeds array slices. No Metal here; RMDLFontLoader.mm uploads the result.
+
+namespace parallel
+{
+    class ThreadPool;
+}
+
+namespace texture_utils
+{
+    /// Tightly packed RGBA8, rows top-down.
+    struct Image
+    {
+        uint32_t                width   = 0;
+        uint32_t                height  = 0;
+        std::vector<uint8_t>    rgba;
+    };
+
+    enum class MipFilter
+    {
+        Box,        // 2x2 average, cheapest
+        Kaiser      // windowed sinc, keeps detail sharper in the small levels
+    };
+
+    struct MipChainDesc
+    {
+        MipFilter   filter      = MipFilter::Box;
+        bool        srgb        = true;     // filter RGB in linear light; alpha is always linear
+        float       kaiserAlpha = 4.f;
+        float       kaiserWidth = 3.f;      // half-width in destination texels
+    };
+
+    /// floor(log2(max(width, height))) + 1: the full chain down to 1x1.
+    uint32_t    mipLevelCount( uint32_t width, uint32_t height );
+
+    /// levels[0] is `base`; every level halves each dimension (rounding down, minimum 1).
+    /// Filtering runs on linear float RGBA, four channels per SIMD lane group.
+    void        buildMipChain( const Image& base, const MipChainDesc& desc, std::vector<Image>& levels );
+
+    /// Divides RGB by alpha, for decoders that only hand out premultiplied pixels.
+    /// Fully transparent texels keep RGB at 0.
+    void        unpremultiply( Image& image );
+
+    /// Decodes and mips the slices of a texture array on a thread pool and hands them
+    /// back in completion order, so the first slices can be uploaded while the rest are
+    /// still decoding.
+    class SliceStream : public NonCopyable
+    {
+    public:
+        using Decoder = std::function<bool( const std::string& path, Image& out )>;
+
+        struct Slice
+        {
+            uint32_t            index;      // position in `paths`
+            bool                ok;         // false when decoding failed
+            std::vector<Image>  levels;
+        };
+
+        SliceStream( const std::vector<std::string>& paths, Decoder decoder, const MipChainDesc& desc );
+        SliceStream( const std::vector<std::string>& paths, Decoder decoder, const MipChainDesc& desc, parallel::ThreadPool& pool );
+        ~SliceStream();
+
+        /// Blocks until another slice is done. Returns false once every slice was returned.
+        bool        next( Slice& slice );
+        uint32_t    sliceCount() const;
+
+    private:
+        struct State;
+        struct Delivery;
+
+        std::shared_ptr<State>  _pState;
+        uint32_t                _delivered;
+    };
+}
+
+#endif /* RMDLTEXTUREUTILS_HPP */
@@ -0,0 +1,355 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLTransformHierarchy.cpp   +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 05:36:30      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "RMDLTransformHierarchy.hpp"
+#include "RMDLBatchMath.hpp"
+#include "RMDLParallel.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+namespace scene
+{
+
+namespace
+{
+    static constexpr uint32_t kNoSlot = ~0u;
+    /// Nodes per parallel job.
+    static constexpr size_t kGrain = 2048;
+    /// Nodes per compose/multiply call; the scratch matrices stay in L1.
+    static constexpr uint32_t kSpan = 128;
+}
+
+TransformHierarchy::TransformHierarchy()
+: _structureDirty( false )
+{
+}
+
+#pragma mark - Structure
+
+uint32_t TransformHierarchy::appendSlot( NodeId node )
+{
+    const uint32_t slot = (uint32_t)_nodeAt.size();
+    _nodeAt.push_back(node);
+    _parentSlot.push_back(kNoSlot);
+    _tx.push_back(0.f); _ty.push_back(0.f); _tz.push_back(0.f);
+    _rx.push_back(0.f); _ry.push_back(0.f); _rz.push_back(0.f); _rw.push_back(1.f);
+    _sx.push_back(1.f); _sy.push_back(1.f); _sz.push_back(1.f);
+    _world.push_back(matrix4x4_identity());
+    return (slot);
+}
+
+NodeId TransformHierarchy::create( NodeId parent )
+{
+    NodeId node;
+    if (!_freeIds.empty())
+    {
+        node = _freeIds.back();
+        _freeIds.pop_back();
+        _parent[node] = parent;
+        _queued[node] = 0;
+        _destroyed[node] = 0;
+    }
+    else
+    {
+        node = (NodeId)_parent.size();
+        _parent.push_back(parent);
+        _slot.push_back(kNoSlot);
+        _queued.push_back(0);
+        _destroyed.push_back(0);
+    }
+    _slot[node] = appendSlot(node);
+    _structureDirty = true;
+    return (node);
+}
+
+void TransformHierarchy::destroy( NodeId node )
+{
+    _destroyed[node] = 1;
+    _structureDirty = true;
+}
+
+bool TransformHierarchy::isAlive( NodeId node ) const
+{
+    return (node < _slot.size() && _slot[node] != kNoSlot && !_destroyed[node]);
+}
+
+bool TransformHierarchy::setParent( NodeId node, NodeId parent )
+{
+    for (NodeId p = parent; p != kNoNode; p = _parent[p])
+    {
+        if (p == node)
+            return (false);
+    }
+    _parent[node] = parent;
+    _structureDirty = true;
+    return (true);
+}
+
+void TransformHierarchy::rebuild()
+{
+    // Children of every handle, in handle order, as one array.
+    const size_t handleCount = _parent.size();
+    std::vector<uint32_t> childOffset(handleCount + 1, 0);
+    std::vector<NodeId> roots;
+    for (NodeId node = 0; node < handleCount; ++node)
+    {
+        if (_slot[node] == kNoSlot || _destroyed[node])
+            continue;
+        if (_parent[node] == kNoNode)
+            roots.push_back(node);
+        else
+            ++childOffset[_parent[node] + 1];
+    }
+    for (size_t i = 0; i < handleCount; ++i)
+        childOffset[i + 1] += childOffset[i];
+    std::vector<NodeId> children(childOffset[handleCount]);
+    {
+        std::vector<uint32_t> cursor(childOffset.begin(), childOffset.end() - 1);
+        for (NodeId node = 0; node < handleCount; ++node)
+        {
+            if (_slot[node] != kNoSlot && !_destroyed[node] && _parent[node] != kNoNode)
+                children[cursor[_parent[node]]++] = node;
+        }
+    }
+
+    // Breadth first from the roots; nodes under a destroyed one are not reached.
+    std::vector<NodeId> order = std::move(roots);
+    std::vector<uint32_t> levelStart = { 0 };
+    for (size_t levelBegin = 0; levelBegin < order.size(); )
+    {
+        const size_t levelEnd = order.size();
+        for (size_t i = levelBegin; i < levelEnd; ++i)
+        {
+            const NodeId node = order[i];
+            order.insert(order.end(), children.begin() + childOffset[node], children.begin() + childOffset[node + 1]);
+        }
+        levelStart.push_back((uint32_t)levelEnd);
+        levelBegin = levelEnd;
+    }
+
+    const uint32_t count = (uint32_t)order.size();
+    std::vector<uint32_t> newSlot(handleCount, kNoSlot);
+    for (uint32_t slot = 0; slot < count; ++slot)
+        newSlot[order[slot]] = slot;
+
+    auto permute = [&]( auto& values )
+    {
+        std::remove_reference_t<decltype(values)> sorted(count);
+        for (uint32_t slot = 0; slot < count; ++slot)
+            sorted[slot] = values[_slot[order[slot]]];
+        values.swap(sorted);
+    };
+    permute(_tx); permute(_ty); permute(_tz);
+    permute(_rx); permute(_ry); permute(_rz); permute(_rw);
+    permute(_sx); permute(_sy); permute(_sz);
+    _world.resize(count);
+
+    _nodeAt = order;
+    _parentSlot.assign(count, kNoSlot);
+    _childStart.assign(count + 1, 0);
+    _childStart[0] = levelStart.size() > 1 ? levelStart[1] : 0;
+    for (uint32_t slot = 0; slot < count; ++slot)
+    {
+        const NodeId node = order[slot];
+        if (_parent[node] != kNoNode)
+            _parentSlot[slot] = newSlot[_parent[node]];
+        _childStart[slot + 1] = _childStart[slot] + (childOffset[node + 1] - childOffset[node]);
+    }
+    _levelStart = std::move(levelStart);
+
+    // Handles that were not reached are free again.
+    for (NodeId node = 0; node < handleCount; ++node)
+    {
+        if (_slot[node] != kNoSlot && newSlot[node] == kNoSlot)
+        {
+            _freeIds.push_back(node);
+            _destroyed[node] = 0;
+        }
+        _queued[node] = 0;
+    }
+    _slot = std::move(newSlot);
+    _dirtyNodes.clear();
+    _structureDirty = false;
+}
+
+#pragma mark - Local transforms
+
+void TransformHierarchy::markDirty( NodeId node )
+{
+    if (!_queued[node])
+    {
+        _queued[node] = 1;
+        _dirtyNodes.push_back(node);
+    }
+}
+
+void TransformHierarchy::setLocal( NodeId node, simd::float3 translation, quaternion_float rotation, simd::float3 scale )
+{
+    const uint32_t slot = _slot[node];
+    _tx[slot] = translation.x; _ty[slot] = translation.y; _tz[slot] = translation.z;
+    _rx[slot] = rotation.x; _ry[slot] = rotation.y; _rz[slot] = rotation.z; _rw[slot] = rotation.w;
+    _sx[slot] = scale.x; _sy[slot] = scale.y; _sz[slot] = scale.z;
+    markDirty(node);
+}
+
+void TransformHierarchy::setTranslation( NodeId node, simd::float3 translation )
+{
+    const uint32_t slot = _slot[node];
+    _tx[slot] = translation.x; _ty[slot] = translation.y; _tz[slot] = translation.z;
+    markDirty(node);
+}
+
+void TransformHierarchy::setRotation( NodeId node, quaternion_float rotation )
+{
+    const uint32_t slot = _slot[node];
+    _rx[slot] = rotation.x; _ry[slot] = rotation.y; _rz[slot] = rotation.z; _rw[slot] = rotation.w;
+    markDirty(node);
+}
+
+void TransformHierarchy::setScale( NodeId node, simd::float3 scale )
+{
+    const uint32_t slot = _slot[node];
+    _sx[slot] = scale.x; _sy[slot] = scale.y; _sz[slot] = scale.z;
+    markDirty(node);
+}
+
+#pragma mark - Update
+
+void TransformHierarchy::recomputeSpan( uint32_t begin, uint32_t end, bool roots )
+{
+    alignas(64) float local[16 * kSpan];
+    alignas(64) float parents[16 * kSpan];
+
+    for (uint32_t s = begin; s < end; s += kSpan)
+    {
+        const uint32_t n = std::min(kSpan, end - s);
+        const batch_math::Vec3Streams translation = { _tx.data() + s, _ty.data() + s, _tz.data() + s };
+        const batch_math::QuatStreams rotation = { _rx.data() + s, _ry.data() + s, _rz.data() + s, _rw.data() + s };
+        const batch_math::Vec3Streams scale = { _sx.data() + s, _sy.data() + s, _sz.data() + s };
+        if (roots)
+        {
+            batch_math::composeTransforms(translation, rotation, scale, (float*)(_world.data() + s), n);
+            continue;
+        }
+        batch_math::composeTransforms(translation, rotation, scale, local, n);
+        // Siblings are adjacent, so this mostly rereads the same parent.
+        for (uint32_t i = 0; i < n; ++i)
+            memcpy(parents + 16 * i, &_world[_parentSlot[s + i]], sizeof(simd::float4x4));
+        batch_math::multiplyMatrices(parents, local, (float*)(_world.data() + s), n);
+    }
+}
+
+void TransformHierarchy::recompute( const std::vector<Range>& ranges, bool roots )
+{
+    std::vector<size_t> offsets(ranges.size() + 1, 0);
+    for (size_t i = 0; i < ranges.size(); ++i)
+        offsets[i + 1] = offsets[i] + (ranges[i].end - ranges[i].begin);
+    const size_t total = offsets.back();
+    _stats.recomputed += total;
+
+    auto run = [&]( size_t begin, size_t end )
+    {
+        size_t r = std::upper_bound(offsets.begin(), offsets.end(), begin) - offsets.begin() - 1;
+        for (; begin < end; ++r)
+        {
+            const size_t pieceEnd = std::min(end, offsets[r + 1]);
+            recomputeSpan(ranges[r].begin + (uint32_t)(begin - offsets[r]), ranges[r].begin + (uint32_t)(pieceEnd - offsets[r]), roots);
+            begin = pieceEnd;
+        }
+    };
+    if (total <= kGrain)
+        run(0, total);
+    else
+        parallel::forRange(total, kGrain, run);
+}
+
+void TransformHierarchy::update()
+{
+    _stats = UpdateStats();
+    std::vector<Range> current;
+    if (_structureDirty)
+    {
+        rebuild();
+        _stats.rebuilt = true;
+        if (!_nodeAt.empty())
+            current.push_back({ _levelStart[0], _levelStart[1] });
+    }
+    else if (_dirtyNodes.empty())
+        return;
+
+    // Moved nodes, by slot; each is the top of a run to recompute.
+    std::vector<uint32_t> dirty;
+    dirty.reserve(_dirtyNodes.size());
+    for (NodeId node : _dirtyNodes)
+    {
+        _queued[node] = 0;
+        if (_slot[node] != kNoSlot)
+            dirty.push_back(_slot[node]);
+    }
+    _dirtyNodes.clear();
+    std::sort(dirty.begin(), dirty.end());
+
+    std::vector<Range> work;
+    std::vector<Range> next;
+    size_t d = 0;
+    for (size_t level = 0; level + 1 < _levelStart.size(); ++level)
+    {
+        const uint32_t levelEnd = _levelStart[level + 1];
+
+        // Runs inherited from the level above, merged with this level's moved nodes.
+        work.clear();
+        size_t c = 0;
+        while (c < current.size() || (d < dirty.size() && dirty[d] < levelEnd))
+        {
+            Range r;
+            if (c < current.size() && (d >= dirty.size() || dirty[d] >= levelEnd || current[c].begin <= dirty[d]))
+                r = current[c++];
+            else
+                r = { dirty[d], dirty[d] + 1 }, ++d;
+            if (!work.empty() && r.begin <= work.back().end)
+                work.back().end = std::max(work.back().end, r.end);
+            else
+                work.push_back(r);
+        }
+        if (work.empty())
+        {
+            if (d == dirty.size())
+                break;
+            continue;
+        }
+
+        recompute(work, level == 0);
+        _stats.levels = (uint32_t)level + 1;
+
+        // The children of a run are a run one level down.
+        next.clear();
+        for (const Range& r : work)
+        {
+            const Range children = { _childStart[r.begin], _childStart[r.end] };
+            if (children.begin == children.end)
+                continue;
+            if (!next.empty() && children.begin <= next.back().end)
+                next.back().end = std::max(next.back().end, children.end);
+            else
+                next.push_back(children);
+        }
+        current.swap(next);
+    }
+}
+
+void TransformHierarchy::gatherWorld( const NodeId* pNodes, size_t count, simd::float4x4* pOut ) const
+{
+    for (size_t i = 0; i < count; ++i)
+        pOut[i] = _world[_slot[pNodes[i]]];
+}
+
+}
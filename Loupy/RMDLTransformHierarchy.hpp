@@ -0,0 +1,112 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLTransformHierarchy.hpp   +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 05:36:22      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLTRANSFORMHIERARCHY_HPP
+# define RMDLTRANSFORMHIERARCHY_HPP
+
+# include <cstddef>
+# include <cstdint>
+# include <vector>
+
+# include "RMDLMathUtils.hpp"
+# include "NonCopyable.h"
+
+// Parent/child transforms. Node handles are stable; the data behind them lives
+// in arrays (one per translation, rotation and scale component, plus the world
+// matrices) kept in breadth-first order, so every level is one contiguous run
+// after its parents, and the children of any run of nodes are themselves one
+// run in the next level. update() walks the levels top down and recomputes only
+// the runs under moved nodes, in parallel chunks, with batch_math's TRS compose
+// and matrix multiply.
+
+namespace scene
+{
+    typedef uint32_t NodeId;
+    static constexpr NodeId kNoNode = ~0u;
+
+    class TransformHierarchy : public NonCopyable
+    {
+    public:
+        struct UpdateStats
+        {
+            uint32_t    levels      = 0;
+            size_t      recomputed  = 0;    // world matrices written
+            bool        rebuilt     = false;
+        };
+
+        TransformHierarchy();
+
+        /// Identity local transform.
+        NodeId          create( NodeId parent = kNoNode );
+        /// The node and its descendants; their handles are freed at the next update().
+        void            destroy( NodeId node );
+        /// Keeps the local transform, which is now relative to `parent`. False,
+        /// and nothing changes, if `parent` is `node` or below it.
+        bool            setParent( NodeId node, NodeId parent );
+        NodeId          parent( NodeId node ) const     { return (_parent[node]); }
+        bool            isAlive( NodeId node ) const;
+
+        void            setLocal( NodeId node, simd::float3 translation, quaternion_float rotation, simd::float3 scale );
+        void            setTranslation( NodeId node, simd::float3 translation );
+        void            setRotation( NodeId node, quaternion_float rotation );
+        void            setScale( NodeId node, simd::float3 scale );
+
+        /// Brings world matrices up to date: all of them after a structural
+        /// change, otherwise the moved nodes and what hangs below them.
+        void            update();
+        const UpdateStats&  lastUpdate() const      { return (_stats); }
+
+        /// As of the last update().
+        const simd::float4x4&   world( NodeId node ) const  { return (_world[_slot[node]]); }
+        /// Every world matrix in storage order, ready to copy into a buffer;
+        /// storageIndex() says where a node is. Valid until the next update().
+        const simd::float4x4*   worldMatrices() const       { return (_world.data()); }
+        uint32_t        storageIndex( NodeId node ) const   { return (_slot[node]); }
+        size_t          nodeCount() const                   { return (_nodeAt.size()); }
+        /// The world matrices of `pNodes`, in that order: an instance buffer.
+        void            gatherWorld( const NodeId* pNodes, size_t count, simd::float4x4* pOut ) const;
+
+    private:
+        struct Range
+        {
+            uint32_t    begin;
+            uint32_t    end;
+        };
+
+        uint32_t        appendSlot( NodeId node );
+        void            markDirty( NodeId node );
+        void            rebuild();
+        void            recompute( const std::vector<Range>& ranges, bool roots );
+        void            recomputeSpan( uint32_t begin, uint32_t end, bool roots );
+
+        // Per handle.
+        std::vector<NodeId>     _parent;
+        std::vector<uint32_t>   _slot;
+        std::vector<uint8_t>    _queued;
+        std::vector<uint8_t>    _destroyed;
+        std::vector<NodeId>     _freeIds;
+        std::vector<NodeId>     _dirtyNodes;
+
+        // Per slot, breadth-first.
+        std::vector<NodeId>     _nodeAt;
+        std::vector<uint32_t>   _parentSlot;
+        std::vector<uint32_t>   _childStart;    // children of slot i: [_childStart[i], _childStart[i + 1])
+        std::vector<uint32_t>   _levelStart;    // one past the end for the last level
+        std::vector<float>      _tx, _ty, _tz;
+        std::vector<float>      _rx, _ry, _rz, _rw;
+        std::vector<float>      _sx, _sy, _sz;
+        std::vector<simd::float4x4>     _world;
+
+        bool                    _structureDirty;
+        UpdateStats             _stats;
+    };
+}
+
+#endif /* RMDLTRANSFORMHIERARCHY_HPP */
@@ -36,33 +36,28 @@ void *ft_memset(void *s, int c, size_t n)
     return (s);
 }
 
-std::vector<uint8_t> readBytecode( const std::string& path )
+MTL::Library* newLibraryFromArtifact( const std::shared_ptr<const shader_cache::MappedFile>& pArtifact, MTL::Device* pDevice )
 {
-    std::ifstream in(path);
-    if (in)
-    {
-        in.seekg(0, std::ios::end);
-        size_t siz = in.tellg();
-        in.seekg(0, std::ios::beg);
-        
-        std::vector<uint8_t> bytecode(siz);
-        in.read((char *)bytecode.data(), siz);
-        
-        return (bytecode);
-    }
-    return {};
-}
+    // The block owns a reference to the mapping: Metal may keep reading the pages
+    // after this returns, until the library itself is released.
+    auto* pHold = new std::shared_ptr<const shader_cache::MappedFile>(pArtifact);
+    dispatch_data_t data = dispatch_data_create(pArtifact->data(), pArtifact->size(), nullptr, ^{ delete pHold; });
 
-MTL::Library* newLibraryFromBytecode( const std::vector<uint8_t>& bytecode, MTL::Device* pDevice )
-{
     NS::Error* pError = nullptr;
-    dispatch_data_t data = dispatch_data_create(bytecode.data(), bytecode.size(), dispatch_get_main_queue(), DISPATCH_DATA_DESTRUCTOR_DEFAULT);
     MTL::Library* pLib = pDevice->newLibrary(data, &pError);
     if (!pLib)
     {
         printf("Error building Metal library: %s\n", pError->localizedDescription()->utf8String());
         assert(pLib);
     }
-    CFRelease(data);
-    return pLib;
+    dispatch_release(data);
+    return (pLib);
+}
+
+MTL::Library* newLibraryFromFile( const std::string& path, MTL::Device* pDevice )
+{
+    std::shared_ptr<const shader_cache::MappedFile> pFile = shader_cache::MappedFile::open(path);
+    if (!pFile)
+        return (nullptr);
+    return (newLibraryFromArtifact(pFile, pDevice));
 }
@@ -17,11 +17,20 @@
 # include <sys/sysctl.h>
 # include <stdlib.h>
 # include <fstream>
+# include <memory>
 # include <Metal/Metal.hpp>
 
+# include "RMDLShaderCache.hpp"
+
 void *ft_memcpy(void *dst, const void *src, size_t n);
 void *ft_memset(void *s, int c, size_t n);
-std::vector<uint8_t> readBytecode(const std::string& path);
-MTL::Library* newLibraryFromBytecode( const std::vector<uint8_t>& bytecode, MTL::Device* pDevice );
+/// Shell template for shader_cache::toolCompiler that builds a metallib straight from source.
+constexpr const char* kMetalCompilerCommand = "xcrun -sdk macosx metal {options} -o {out} {in}";
+
+/// Wraps the mapped pages in dispatch_data without copying; the mapping is released
+/// together with the library.
+MTL::Library* newLibraryFromArtifact( const std::shared_ptr<const shader_cache::MappedFile>& pArtifact, MTL::Device* pDevice );
+/// Maps a metallib and loads it with newLibraryFromArtifact. nullptr if the file cannot be mapped.
+MTL::Library* newLibraryFromFile( const std::string& path, MTL::Device* pDevice );
 
 #endif /* RMDLUTILS_HPP */
@@ -0,0 +1,178 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLAliasPlannerTests.cpp    +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 11:04:26      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+// Sources: RMDLAliasPlanner.cpp RMDLRenderGraph.cpp
+
+#include "RMDLTest.hpp"
+#include "RMDLAliasPlanner.hpp"
+#include "RMDLRenderGraph.hpp"
+
+#include <algorithm>
+#include <random>
+#include <string>
+
+using namespace alias_planner;
+
+namespace
+{
+    /// Checked here without validate(), so a bug there cannot hide one in plan().
+    bool overlapsWhileAlive( const std::vector<Allocation>& allocations, const Plan& plan )
+    {
+        for (size_t i = 0; i < allocations.size(); ++i)
+        {
+            const Allocation& a = allocations[i];
+            if (a.alignment > 1 && plan.offsets[i] % a.alignment != 0)
+                return (true);
+            if (plan.offsets[i] + a.size > plan.heapSize)
+                return (true);
+            for (size_t j = i + 1; j < allocations.size(); ++j)
+            {
+                const Allocation& b = allocations[j];
+                const bool alive = a.first <= b.last && b.first <= a.last;
+                const bool bytes = plan.offsets[i] < plan.offsets[j] + b.size && plan.offsets[j] < plan.offsets[i] + a.size;
+                if (alive && bytes)
+                    return (true);
+            }
+        }
+        return (false);
+    }
+
+    /// 500 textures over 120 passes: mostly short-lived, some long.
+    std::vector<Allocation> frameOfTransients( std::mt19937& rng )
+    {
+        const uint32_t passes = 120;
+        std::vector<Allocation> allocations;
+        for (int i = 0; i < 500; ++i)
+        {
+            const uint32_t first = rng() % passes;
+            const uint32_t length = 1 + rng() % (rng() % 4 == 0 ? 60 : 8);
+            const uint64_t width = 64ull << (rng() % 5), height = 64ull << (rng() % 5), bytesPerPixel = 1ull << (rng() % 4);
+            allocations.push_back({ first, std::min(passes - 1, first + length), width * height * bytesPerPixel, rng() % 2 ? 65536u : 4096u });
+        }
+        return (allocations);
+    }
+}
+
+RMDL_TEST( theFrameFitsInLess )
+{
+    // Shadow array, then three G-buffer targets, then the lit target.
+    const std::vector<Allocation> allocations = {
+        { 0, 2, 1024 * 1024 * 4 * 3, 65536 }, { 3, 5, 1920 * 1080 * 4, 65536 }, { 3, 5, 1920 * 1080 * 8, 65536 },
+        { 3, 5, 1920 * 1080 * 4, 65536 }, { 6, 6, 1920 * 1080 * 8, 65536 } };
+    for (Strategy strategy : { Strategy::BestFit, Strategy::IntervalColoring })
+    {
+        const Plan p = plan(allocations, strategy);
+        RMDL_CHECK(validate(allocations, p) && !overlapsWhileAlive(allocations, p));
+        RMDL_CHECK(p.heapSize >= p.peakLiveSize && p.heapSize < p.unaliasedSize);
+    }
+    RMDL_CHECK(plan(allocations).peakLiveSize == 1920 * 1080 * 16);
+}
+
+RMDL_TEST( smallRandomPlansAreValidAndNeverWorse )
+{
+    std::mt19937 rng(3);
+    for (int frame = 0; frame < 2000; ++frame)
+    {
+        std::vector<Allocation> allocations;
+        for (int i = 0, n = 3 + rng() % 10; i < n; ++i)
+        {
+            const uint32_t first = rng() % 10;
+            allocations.push_back({ first, first + (uint32_t)(rng() % 10), 1 + rng() % 100, 1u << (rng() % 4) });
+        }
+        for (Strategy strategy : { Strategy::BestFit, Strategy::IntervalColoring })
+        {
+            const Plan p = plan(allocations, strategy);
+            RMDL_CHECK(validate(allocations, p) && !overlapsWhileAlive(allocations, p));
+            RMDL_CHECK(p.heapSize >= p.peakLiveSize && p.heapSize <= p.unaliasedSize);
+        }
+    }
+    // validate() itself catches an overlap.
+    const std::vector<Allocation> two = { { 0, 1, 64, 16 }, { 1, 2, 64, 16 } };
+    Plan broken = plan(two);
+    broken.offsets = { 0, 32 };
+    RMDL_CHECK(!validate(two, broken));
+}
+
+RMDL_TEST( heapReuseIsFencedByAliasBarriers )
+{
+    using namespace render_graph;
+    std::mt19937 rng(11);
+    const float clear[4] = {};
+    // A chain of passes, each drawing into a texture of its own size read by the next
+    // one, so nothing can share a physical texture but the heap can overlap them.
+    RenderGraph graph;
+    std::vector<ResourceId> textures;
+    for (int i = 0; i < 40; ++i)
+        textures.push_back(graph.createTexture("t" + std::to_string(i), { 256u << (rng() % 3), 256u + 16 * i, 1, 115, 0 }));
+    graph.markOutput(textures.back());
+    for (int i = 0; i < 40; ++i)
+    {
+        const PassId pass = graph.addPass("p" + std::to_string(i), PassKind::Render);
+        if (i > 0)
+            graph.read(pass, textures[i - 1]);
+        graph.clear(pass, textures[i], Access::ColorAttachment, clear);
+    }
+    CompileOptions options;
+    auto sizeOf = []( const ResourceDesc& d ) { return ((uint64_t)d.width * d.height * d.arrayLength * 8); };
+    options.heapSizeAndAlign = [&]( const ResourceDesc& d, uint64_t& size, uint64_t& alignment ) {
+        size = sizeOf(d);
+        alignment = 65536;
+    };
+    const CompiledGraph compiled = graph.compile(options);
+    RMDL_CHECK(compiled.heapSavedBytes > 0);
+
+    // Whenever a texture takes over bytes of an earlier one, some pass in between,
+    // or the taking pass itself, starts with an alias barrier.
+    for (uint32_t later = 0; later < 40; ++later)
+    {
+        for (uint32_t earlier = 0; earlier + 1 < later; ++earlier)
+        {
+            const uint32_t a = compiled.physicalOf[textures[earlier]], b = compiled.physicalOf[textures[later]];
+            if (compiled.heapOffset[a] == kNotOnHeap || compiled.heapOffset[b] == kNotOnHeap)
+                continue;
+            const bool bytes = compiled.heapOffset[a] < compiled.heapOffset[b] + sizeOf(compiled.physical[b])
+                            && compiled.heapOffset[b] < compiled.heapOffset[a] + sizeOf(compiled.physical[a]);
+            if (!bytes)
+                continue;
+            bool fenced = false;
+            for (uint32_t q = earlier + 2; q <= later; ++q)
+                fenced |= compiled.passes[q].barrier.resourceAlias;
+            RMDL_CHECK(fenced);
+        }
+    }
+}
+
+RMDL_BENCH( fiveHundredTransients )
+{
+    for (Strategy strategy : { Strategy::BestFit, Strategy::IntervalColoring })
+    {
+        std::mt19937 rng(7);
+        double ms = 0.0;
+        uint64_t unaliased = 0, heap = 0, peak = 0;
+        int invalid = 0;
+        const int frames = 50;
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            const std::vector<Allocation> allocations = frameOfTransients(rng);
+            Plan p;
+            ms += rmdl_test::milliseconds([&]() { p = plan(allocations, strategy); });
+            invalid += !validate(allocations, p);
+            unaliased += p.unaliasedSize;
+            heap += p.heapSize;
+            peak += p.peakLiveSize;
+        }
+        RMDL_CHECK(invalid == 0);
+        std::printf("  %-9s 500 transients: %.3f ms/frame, unaliased %.1f MB, heap %.1f MB, peak live %.1f MB, saved %.1f%%\n",
+                    strategy == Strategy::BestFit ? "best fit" : "coloring", ms / frames, unaliased / frames / 1e6,
+                    heap / frames / 1e6, peak / frames / 1e6, 100.0 * (double)(unaliased - heap) / unaliased);
+    }
+}
+
+RMDL_TEST_MAIN()
@@ -0,0 +1,348 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLBvhTests.cpp             +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 13:56:33      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+// Sources: RMDLBvh.cpp RMDLParallel.cpp RMDLRandom.cpp
+
+#include "RMDLTest.hpp"
+#include "RMDLBvh.hpp"
+#include "RMDLRandom.hpp"
+
+#include <cmath>
+#include <type_traits>
+
+using namespace bvh;
+
+namespace
+{
+    struct Mesh
+    {
+        std::vector<float>      positions;
+        std::vector<uint32_t>   indices;
+
+        TriangleMesh view() const
+        {
+            return (TriangleMesh{ positions.data(), 3, positions.size() / 3, indices.data(), indices.size() / 3 });
+        }
+    };
+
+    /// Möller-Trumbore in double: the nearest t along the ray, if any.
+    bool referenceHit( const Mesh& mesh, size_t triangle, const double o[3], const double d[3], double& t )
+    {
+        const float* a = &mesh.positions[3 * mesh.indices[3 * triangle]];
+        const float* b = &mesh.positions[3 * mesh.indices[3 * triangle + 1]];
+        const float* c = &mesh.positions[3 * mesh.indices[3 * triangle + 2]];
+        double e1[3], e2[3], s[3];
+        for (int k = 0; k < 3; ++k)
+        {
+            e1[k] = b[k] - a[k];
+            e2[k] = c[k] - a[k];
+            s[k] = o[k] - a[k];
+        }
+        const double p[3] = { d[1] * e2[2] - d[2] * e2[1], d[2] * e2[0] - d[0] * e2[2], d[0] * e2[1] - d[1] * e2[0] };
+        const double det = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+        if (std::fabs(det) < 1e-18)
+            return (false);
+        const double u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) / det;
+        if (u < 0.0 || u > 1.0)
+            return (false);
+        const double q[3] = { s[1] * e1[2] - s[2] * e1[1], s[2] * e1[0] - s[0] * e1[2], s[0] * e1[1] - s[1] * e1[0] };
+        const double v = (d[0] * q[0] + d[1] * q[1] + d[2] * q[2]) / det;
+        if (v < 0.0 || u + v > 1.0)
+            return (false);
+        t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) / det;
+        return (t >= 0.0);
+    }
+
+    /// Small triangles scattered through a cube of side 2 * `extent`.
+    Mesh soup( rng::Stream& random, size_t count, float extent, float size )
+    {
+        Mesh mesh;
+        for (size_t t = 0; t < count; ++t)
+        {
+            const float c[3] = { random.uniform(-extent, extent), random.uniform(-extent, extent), random.uniform(-extent, extent) };
+            for (int k = 0; k < 3; ++k)
+            {
+                for (int axis = 0; axis < 3; ++axis)
+                    mesh.positions.push_back(c[axis] + random.uniform(-size, size));
+                mesh.indices.push_back((uint32_t)(3 * t + k));
+            }
+        }
+        return (mesh);
+    }
+
+    /// An n x n heightfield, two triangles per cell, diagonals alternating.
+    Mesh terrain( rng::Stream& random, int n, float amplitude )
+    {
+        Mesh mesh;
+        for (int y = 0; y <= n; ++y)
+        {
+            for (int x = 0; x <= n; ++x)
+            {
+                mesh.positions.push_back((float)x);
+                mesh.positions.push_back(amplitude * std::sin(x * 0.05f) * std::cos(y * 0.07f) + 0.1f * amplitude * random.nextFloat());
+                mesh.positions.push_back((float)y);
+            }
+        }
+        for (int y = 0; y < n; ++y)
+        {
+            for (int x = 0; x < n; ++x)
+            {
+                const uint32_t a = y * (n + 1) + x, b = a + 1, c = a + n + 1, d = c + 1;
+                if ((x + y) & 1)
+                    mesh.indices.insert(mesh.indices.end(), { a, c, b, b, c, d });
+                else
+                    mesh.indices.insert(mesh.indices.end(), { a, c, d, a, d, b });
+            }
+        }
+        return (mesh);
+    }
+
+    Ray ray( simd::float3 origin, simd::float3 direction )
+    {
+        Ray r;
+        r.origin = origin;
+        r.direction = direction;
+        return (r);
+    }
+
+    template< int W >
+    void setLane( RayPacket<W>& packet, int lane, const Ray& r )
+    {
+        packet.originX[lane] = r.origin.x;
+        packet.originY[lane] = r.origin.y;
+        packet.originZ[lane] = r.origin.z;
+        packet.directionX[lane] = r.direction.x;
+        packet.directionY[lane] = r.direction.y;
+        packet.directionZ[lane] = r.direction.z;
+        packet.tMin[lane] = r.tMin;
+        packet.tMax[lane] = r.tMax;
+    }
+}
+
+RMDL_TEST( nearestHitMatchesBruteForce )
+{
+    rng::Stream random(11);
+    const Mesh mesh = soup(random, 20000, 50.f, 2.f);
+    Bvh tree;
+    tree.build(mesh.view());
+    // Grazing hits may go either way in float; allow a couple.
+    int mismatches = 0;
+    for (int k = 0; k < 2000; ++k)
+    {
+        const Ray r = ray(simd_make_float3(random.uniform(-60.f, 60.f), random.uniform(-60.f, 60.f), random.uniform(-60.f, 60.f)),
+                          simd::normalize(simd_make_float3(random.uniform(-1.f, 1.f), random.uniform(-1.f, 1.f), random.uniform(-1.f, 1.f))));
+        const double o[3] = { r.origin.x, r.origin.y, r.origin.z }, d[3] = { r.direction.x, r.direction.y, r.direction.z };
+        double best = INFINITY;
+        size_t nearest = kNoHit;
+        for (size_t t = 0; t < mesh.indices.size() / 3; ++t)
+        {
+            double hit;
+            if (referenceHit(mesh, t, o, d, hit) && hit < best)
+            {
+                best = hit;
+                nearest = t;
+            }
+        }
+        const Hit h = tree.intersect(r);
+        mismatches += tree.occluded(r) != (nearest != kNoHit);
+        mismatches += nearest == kNoHit ? h.triangle != kNoHit : std::fabs(h.t - best) > 1e-3 * (1.0 + best);
+    }
+    RMDL_CHECK(mismatches <= 2);
+}
+
+RMDL_TEST( raysThroughVerticesAndEdgesHit )
+{
+    rng::Stream random(12);
+    const Mesh mesh = terrain(random, 256, 5.f);
+    Bvh tree;
+    tree.build(mesh.view());
+    int misses = 0;
+    for (int y = 1; y < 256; ++y)
+    {
+        for (int x = 1; x < 256; ++x)
+        {
+            // The vertex and the two edge midpoints next to it, straight down.
+            for (int k = 0; k < 3; ++k)
+            {
+                const float fx = x + (k == 1 ? 0.5f : 0.f), fy = y + (k == 2 ? 0.5f : 0.f);
+                misses += tree.intersect(ray(simd_make_float3(fx, 100.f, fy), simd_make_float3(0.f, -1.f, 0.f))).triangle == kNoHit;
+            }
+        }
+    }
+    for (int k = 0; k < 100000; ++k)
+    {
+        // Slanted, aimed exactly at a vertex.
+        const int x = 1 + random.nextU32() % 254, y = 1 + random.nextU32() % 254;
+        const float* v = &mesh.positions[3 * (y * 257 + x)];
+        const simd::float3 direction = simd::normalize(simd_make_float3(random.uniform(-1.f, 1.f), -1.f, random.uniform(-1.f, 1.f)));
+        misses += tree.intersect(ray(simd_make_float3(v[0], v[1], v[2]) - direction * 50.f, direction)).triangle == kNoHit;
+    }
+    RMDL_CHECK(misses == 0);
+}
+
+RMDL_TEST( packetsAgreeWithSingleRays )
+{
+    rng::Stream random(13);
+    const Mesh mesh = terrain(random, 256, 5.f);
+    Bvh tree;
+    tree.build(mesh.view());
+    int disagreements = 0;
+    for (int k = 0; k < 20000; ++k)
+    {
+        RayPacket<8> p8;
+        RayPacket<4> p4;
+        Ray rays[8];
+        const float bx = random.uniform(0.f, 240.f), by = random.uniform(0.f, 240.f);
+        for (int lane = 0; lane < 8; ++lane)
+        {
+            rays[lane] = ray(simd_make_float3(bx + (lane & 3) * 0.7f, 50.f, by + (lane >> 2) * 0.7f),
+                             simd::normalize(simd_make_float3(random.uniform(-0.3f, 0.3f), -1.f, random.uniform(-0.3f, 0.3f))));
+            setLane(p8, lane, rays[lane]);
+            if (lane < 4)
+                setLane(p4, lane, rays[lane]);
+        }
+        HitPacket<8> h8;
+        HitPacket<4> h4;
+        tree.intersect(p8, h8);
+        tree.intersect(p4, h4);
+        for (int lane = 0; lane < 8; ++lane)
+        {
+            const Hit h = tree.intersect(rays[lane]);
+            disagreements += std::fabs(h.t - h8.t[lane]) > 1e-4f * h.t || (h.triangle != h8.triangle[lane] && std::fabs(h.t - h8.t[lane]) > 1e-5f);
+            if (lane < 4)
+                disagreements += h4.triangle[lane] != h8.triangle[lane] || h4.t[lane] != h8.t[lane];
+        }
+    }
+    RMDL_CHECK(disagreements == 0);
+}
+
+RMDL_TEST( refitAnswersLikeARebuild )
+{
+    rng::Stream random(14);
+    Mesh mesh = terrain(random, 256, 5.f);
+    Bvh tree;
+    tree.build(mesh.view());
+    for (size_t i = 1; i < mesh.positions.size(); i += 3)
+        mesh.positions[i] += 3.f * std::sin(mesh.positions[i - 1] * 0.1f);
+    tree.refit(mesh.view());
+    Bvh fresh;
+    fresh.build(mesh.view());
+    int differences = 0;
+    for (int k = 0; k < 20000; ++k)
+    {
+        const Ray r = ray(simd_make_float3(random.uniform(0.f, 256.f), 60.f, random.uniform(0.f, 256.f)),
+                          simd::normalize(simd_make_float3(random.uniform(-0.5f, 0.5f), -1.f, random.uniform(-0.5f, 0.5f))));
+        const Hit a = tree.intersect(r), b = fresh.intersect(r);
+        differences += a.triangle != b.triangle || a.t != b.t;
+    }
+    RMDL_CHECK(differences == 0);
+}
+
+RMDL_TEST( pickingRayLeavesTheNearPlane )
+{
+    const simd::float4x4 viewProjection = simd_matrix(simd_make_float4(1.f, 0.f, 0.f, 0.f), simd_make_float4(0.f, 1.f, 0.f, 0.f),
+                                                      simd_make_float4(0.f, 0.f, 0.5f, 0.f), simd_make_float4(0.f, 0.f, 0.5f, 1.f));
+    const Ray r = rayThroughPixel(50.f, 50.f, 100.f, 100.f, simd::inverse(viewProjection));
+    RMDL_CHECK(std::fabs(r.direction.z - 1.f) < 1e-5f && std::fabs(r.origin.z + 1.f) < 1e-5f);
+}
+
+RMDL_BENCH( buildMillisecondsPerMillionTriangles )
+{
+    rng::Stream random(21);
+    const Mesh ground = terrain(random, 708, 20.f);
+    const Mesh scattered = soup(random, 1000000, 50.f, 0.5f);
+    for (const Mesh* pMesh : { &ground, &scattered })
+    {
+        const TriangleMesh mesh = pMesh->view();
+        Bvh tree;
+        const double parallel = rmdl_test::bestOf(3, [&]() { tree.build(mesh); });
+        BuildOptions serial;
+        serial.parallelThreshold = ~(size_t)0;
+        Bvh serialTree;
+        const double single = rmdl_test::bestOf(3, [&]() { serialTree.build(mesh, serial); });
+        const double refit = rmdl_test::bestOf(3, [&]() { tree.refit(mesh); });
+        std::printf("  %-7s %zu triangles: build %.0f ms (%.0f ms/Mtri), serial %.0f ms, refit %.1f ms; depth %u, SAH %.1f\n",
+                    pMesh == &ground ? "terrain" : "soup", mesh.triangleCount, parallel, parallel * 1e6 / mesh.triangleCount, single, refit,
+                    tree.stats().depth, tree.stats().sahCost);
+    }
+}
+
+RMDL_BENCH( megaraysPerSecond )
+{
+    rng::Stream random(22);
+    const Mesh ground = terrain(random, 708, 20.f);
+    Bvh tree;
+    tree.build(ground.view());
+
+    // Primary rays from a camera over the terrain, 1024 x 1024.
+    const int side = 1024;
+    std::vector<Ray> rays(side * side);
+    for (int y = 0; y < side; ++y)
+        for (int x = 0; x < side; ++x)
+            rays[y * side + x] = ray(simd_make_float3(354.f, 80.f, -50.f),
+                                     simd::normalize(simd_make_float3((x - side / 2) / (float)side, -0.4f - (y / (float)side) * 0.5f, 1.f)));
+    auto single = [&]()
+    {
+        size_t hits = 0;
+        const double ms = rmdl_test::bestOf(3, [&]()
+        {
+            hits = 0;
+            for (const Ray& r : rays)
+                hits += tree.intersect(r).triangle != kNoHit;
+        });
+        return (std::make_pair(rays.size() / ms * 1e-3, hits));
+    };
+    auto packets = [&]( auto width )
+    {
+        // 2 x 2 or 4 x 2 pixel tiles.
+        constexpr int W = decltype(width)::value, across = W / 2;
+        size_t hits = 0;
+        const double ms = rmdl_test::bestOf(3, [&]()
+        {
+            RayPacket<W> packet;
+            HitPacket<W> result;
+            hits = 0;
+            for (int y = 0; y < side; y += 2)
+            {
+                for (int x = 0; x < side; x += across)
+                {
+                    for (int lane = 0; lane < W; ++lane)
+                        setLane(packet, lane, rays[(y + lane / across) * side + x + lane % across]);
+                    tree.intersect(packet, result);
+                    for (int lane = 0; lane < W; ++lane)
+                        hits += result.triangle[lane] != kNoHit;
+                }
+            }
+        });
+        return (std::make_pair(rays.size() / ms * 1e-3, hits));
+    };
+    const auto coherent = single();
+    const auto four = packets(std::integral_constant<int, 4>{});
+    const auto eight = packets(std::integral_constant<int, 8>{});
+    RMDL_CHECK(four.second == coherent.second && eight.second == coherent.second);
+    std::printf("  coherent, %zu triangles: single %.2f Mrays/s, 4-wide %.2f, 8-wide %.2f (%zu hits)\n",
+                tree.triangleCount(), coherent.first, four.first, eight.first, coherent.second);
+
+    for (Ray& r : rays)
+        r = ray(simd_make_float3(random.uniform(0.f, 700.f), random.uniform(-20.f, 40.f), random.uniform(0.f, 700.f)),
+                simd::normalize(simd_make_float3(random.uniform(-1.f, 1.f), random.uniform(-1.f, 1.f), random.uniform(-1.f, 1.f))));
+    const auto incoherent = single();
+    size_t blocked = 0;
+    const double occlusion = rmdl_test::bestOf(3, [&]()
+    {
+        blocked = 0;
+        for (const Ray& r : rays)
+            blocked += tree.occluded(r);
+    });
+    RMDL_CHECK(blocked == incoherent.second);
+    std::printf("  incoherent: nearest hit %.2f Mrays/s, occlusion %.2f Mrays/s\n", incoherent.first, rays.size() / occlusion * 1e-3);
+}
+
+RMDL_TEST_MAIN()
@@ -0,0 +1,217 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLCommandRecorderTests.cpp +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 11:15:37      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+// Sources: RMDLCommandRecorder.cpp RMDLParallel.cpp
+
+#include "RMDLTest.hpp"
+#include "RMDLCommandRecorder.hpp"
+#include "RMDLParallel.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <thread>
+
+using namespace command_recording;
+
+namespace
+{
+    constexpr uint32_t kFramesInFlight = 3;
+
+    struct FakeAllocator
+    {
+        std::atomic<int>    users { 0 };
+        uint64_t            lastFrame = 0;
+    };
+
+    struct FakeCommandBuffer
+    {
+        FakeAllocator*  pAllocator;
+        int             job = -1;
+        bool            ended = false;
+    };
+
+    /// Counts every misuse the real backend would turn into a GPU fault: two threads
+    /// on one allocator, resetting one still in flight, committing an open buffer.
+    struct FakeBackend : RecordingBackend
+    {
+        std::mutex          mutex;
+        std::vector<int>    committed;
+        std::atomic<int>    errors { 0 };
+        std::atomic<int>    liveBuffers { 0 };
+        std::atomic<int>    liveAllocators { 0 };
+        uint64_t            frame = 0;
+
+        void* newAllocator() override
+        {
+            ++liveAllocators;
+            return (new FakeAllocator);
+        }
+
+        void resetAllocator( void* pAllocator ) override
+        {
+            FakeAllocator* pFake = (FakeAllocator *)pAllocator;
+            errors += pFake->users != 0 || (pFake->lastFrame && frame - pFake->lastFrame < kFramesInFlight);
+        }
+
+        void releaseAllocator( void* pAllocator ) override
+        {
+            --liveAllocators;
+            delete (FakeAllocator *)pAllocator;
+        }
+
+        void* beginCommandBuffer( void* pAllocator ) override
+        {
+            FakeAllocator* pFake = (FakeAllocator *)pAllocator;
+            errors += pFake->users.fetch_add(1) != 0;
+            pFake->lastFrame = frame;
+            ++liveBuffers;
+            return (new FakeCommandBuffer{ pFake });
+        }
+
+        void endCommandBuffer( void* pCommandBuffer ) override
+        {
+            FakeCommandBuffer* pFake = (FakeCommandBuffer *)pCommandBuffer;
+            pFake->ended = true;
+            --pFake->pAllocator->users;
+        }
+
+        void submit( void* const* pCommandBuffers, size_t count ) override
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t i = 0; i < count; ++i)
+            {
+                FakeCommandBuffer* pFake = (FakeCommandBuffer *)pCommandBuffers[i];
+                errors += !pFake->ended;
+                committed.push_back(pFake->job);
+                delete pFake;
+                --liveBuffers;
+            }
+        }
+    };
+
+    RecordJob job( int index, int spin )
+    {
+        RecordJob j;
+        j.record = [index, spin]( void* pCommandBuffer ) {
+            ((FakeCommandBuffer *)pCommandBuffer)->job = index;
+            volatile int x = 0;
+            for (int i = 0; i < spin; ++i)
+                x = x + i;
+        };
+        return (j);
+    }
+}
+
+RMDL_TEST( submissionOrderFollowsDependencies )
+{
+    std::vector<RecordJob> jobs(4);
+    jobs[0].after = { 2 };
+    jobs[1].after = { 3 };
+    std::vector<uint32_t> order;
+    RMDL_CHECK(submissionOrder(jobs, order));
+    RMDL_CHECK((order == std::vector<uint32_t>{ 2, 0, 3, 1 }));
+    jobs[2].after = { 0 };
+    RMDL_CHECK(!submissionOrder(jobs, order) && order.size() == 4);
+}
+
+RMDL_TEST( stressWithAFakeBackend )
+{
+    FakeBackend backend;
+    parallel::ThreadPool pool(7);
+    {
+        ParallelRecorder recorder(backend, kFramesInFlight, pool);
+        std::mt19937 rng(1);
+        int orderErrors = 0, cycles = 0;
+        for (uint64_t frame = 1; frame <= 3000; ++frame)
+        {
+            backend.frame = frame;
+            recorder.beginFrame(frame);
+            const int count = 1 + rng() % 24;
+            std::vector<RecordJob> jobs;
+            for (int j = 0; j < count; ++j)
+            {
+                jobs.push_back(job(j, rng() % 2000));
+                for (int k = 0; k < 2; ++k)
+                {
+                    if (j && rng() % 3 == 0)
+                        jobs[j].after.push_back(rng() % j);
+                }
+            }
+            const bool cyclic = frame % 97 == 5 && count > 2;
+            if (cyclic)
+                jobs[0].after.push_back(count - 1);
+            backend.committed.clear();
+            const bool ok = recorder.record(jobs);
+            cycles += !ok;
+            if ((int)backend.committed.size() != count)
+            {
+                ++orderErrors;
+                continue;
+            }
+            std::vector<int> position(count, -1);
+            for (int i = 0; i < count; ++i)
+                position[backend.committed[i]] = i;
+            for (int j = 0; ok && j < count; ++j)
+            {
+                for (uint32_t before : jobs[j].after)
+                    orderErrors += position[before] > position[j];
+            }
+        }
+        const RecorderStats stats = recorder.stats();
+        RMDL_CHECK(orderErrors == 0 && backend.errors == 0 && backend.liveBuffers == 0);
+        RMDL_CHECK(cycles > 0 && stats.submits <= stats.jobs && stats.allocators <= kFramesInFlight * 8);
+    }
+    RMDL_CHECK(backend.liveAllocators == 0);
+}
+
+RMDL_BENCH( recordingScales )
+{
+    FakeBackend backend;
+    std::vector<RecordJob> jobs;
+    for (int j = 0; j < 8; ++j)
+    {
+        RecordJob busy;
+        busy.record = []( void* ) {
+            const auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(2);
+            while (std::chrono::steady_clock::now() < end)
+                ;
+        };
+        jobs.push_back(busy);
+    }
+    for (unsigned workers : { 1u, 7u })
+    {
+        parallel::ThreadPool pool(workers);
+        ParallelRecorder recorder(backend, kFramesInFlight, pool);
+        uint64_t frame = 0;
+        const double ms = rmdl_test::bestOf(5, [&]() {
+            backend.frame = ++frame;
+            recorder.beginFrame(frame);
+            recorder.record(jobs);
+        });
+        std::printf("  8 jobs of 2 ms, %u workers + caller: %.2f ms per frame (%u hardware threads here)\n",
+                    workers, ms, std::thread::hardware_concurrency());
+    }
+
+    parallel::ThreadPool pool(3);
+    ParallelRecorder recorder(backend, kFramesInFlight, pool);
+    std::vector<RecordJob> small;
+    for (int j = 0; j < 24; ++j)
+        small.push_back(job(j, 0));
+    uint64_t frame = 0;
+    const double overhead = rmdl_test::bestOf(200, [&]() {
+        backend.frame = ++frame;
+        recorder.beginFrame(frame);
+        recorder.record(small);
+    });
+    std::printf("  24 empty jobs: %.1f us per frame of recorder overhead\n", overhead * 1e3);
+}
+
+RMDL_TEST_MAIN()
@@ -0,0 +1,117 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLCullingTests.cpp         +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 11:27:50      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+// Sources: RMDLCulling.cpp RMDLParallel.cpp
+
+#include "RMDLTest.hpp"
+#include "RMDLCulling.hpp"
+#include "RMDLParallel.hpp"
+
+#include <cmath>
+#include <random>
+
+using namespace culling;
+
+namespace
+{
+    constexpr uint32_t kMeshCount = 64;
+
+    /// A 90-degree frustum looking down +z, near 0.1, far 150.
+    RMDLCullParams cullParams( uint32_t instanceCount )
+    {
+        const float planes[6][4] = { { 0.7071f, 0.f, 0.7071f, 0.f }, { -0.7071f, 0.f, 0.7071f, 0.f },
+                                     { 0.f, 0.7071f, 0.7071f, 0.f }, { 0.f, -0.7071f, 0.7071f, 0.f },
+                                     { 0.f, 0.f, 1.f, -0.1f }, { 0.f, 0.f, -1.f, 150.f } };
+        RMDLCullParams params = {};
+        std::memcpy(params.frustumPlanes, planes, sizeof(planes));
+        params.instanceCount = instanceCount;
+        params.meshCount = kMeshCount;
+        return (params);
+    }
+
+    /// Spheres scattered around the camera, with a few bad mesh indices and NaN centres.
+    std::vector<RMDLCullInstance> scatter( uint32_t count )
+    {
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<float> position(-200.f, 200.f), radius(0.1f, 5.f);
+        std::vector<RMDLCullInstance> instances(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            instances[i] = { { position(rng), position(rng) * 0.25f, position(rng), radius(rng) }, (uint32_t)(rng() % kMeshCount), {} };
+            if (i % 100000 == 7)
+                instances[i].meshIndex = 999;
+            if (i % 77777 == 3)
+                instances[i].boundingSphere[0] = NAN;
+        }
+        return (instances);
+    }
+
+    std::vector<RMDLCullMesh> meshes()
+    {
+        std::vector<RMDLCullMesh> all(kMeshCount);
+        for (uint32_t m = 0; m < kMeshCount; ++m)
+            all[m] = { 36 + m * 3, m * 1000, (int32_t)(m * 10), 0 };
+        return (all);
+    }
+}
+
+RMDL_TEST( spheresOnThePlanes )
+{
+    const RMDLCullParams params = cullParams(1);
+    RMDLCullInstance instance = { { 0.f, 0.f, 10.f, 1.f }, 0, {} };
+    RMDL_CHECK(sphereVisible(params, instance));
+    // Behind the far plane by less, then by more, than its radius.
+    instance.boundingSphere[2] = 150.5f;
+    RMDL_CHECK(sphereVisible(params, instance));
+    instance.boundingSphere[2] = 151.5f;
+    RMDL_CHECK(!sphereVisible(params, instance));
+    // Behind the camera.
+    instance.boundingSphere[2] = -5.f;
+    RMDL_CHECK(!sphereVisible(params, instance));
+}
+
+RMDL_TEST( simdMatchesScalarBitForBit )
+{
+    // Counts around the four-wide steps and the pool's chunking.
+    const std::vector<RMDLCullInstance> instances = scatter(200000);
+    const std::vector<RMDLCullMesh> all = meshes();
+    std::vector<RMDLDrawIndexedArguments> scalar(instances.size()), simd(instances.size());
+    parallel::ThreadPool pool(3);
+    for (uint32_t count : { 0u, 1u, 3u, 4u, 5u, 16383u, 16384u, 16385u, 40001u, 200000u })
+    {
+        const RMDLCullParams params = cullParams(count);
+        const uint32_t expected = cullAndCompactScalar(params, instances.data(), all.data(), scalar.data());
+        const uint32_t single = cullAndCompact(params, instances.data(), all.data(), simd.data());
+        RMDL_CHECK(single == expected && std::memcmp(scalar.data(), simd.data(), expected * sizeof(RMDLDrawIndexedArguments)) == 0);
+        const uint32_t pooled = cullAndCompact(params, instances.data(), all.data(), simd.data(), pool);
+        RMDL_CHECK(pooled == expected && std::memcmp(scalar.data(), simd.data(), expected * sizeof(RMDLDrawIndexedArguments)) == 0);
+    }
+    // Bad mesh indices and NaN centres never make it into the draws.
+    const uint32_t visible = cullAndCompactScalar(cullParams(200000), instances.data(), all.data(), scalar.data());
+    for (uint32_t i = 0; i < visible; ++i)
+        RMDL_CHECK(scalar[i].instanceCount == 1 && scalar[i].indexCount >= 36);
+}
+
+RMDL_BENCH( millionInstances )
+{
+    const uint32_t count = 1u << 20;
+    const std::vector<RMDLCullInstance> instances = scatter(count);
+    const std::vector<RMDLCullMesh> all = meshes();
+    std::vector<RMDLDrawIndexedArguments> scalar(count), simd(count);
+    const RMDLCullParams params = cullParams(count);
+    uint32_t expected = 0, visible = 0;
+    const double scalarMs = rmdl_test::bestOf(3, [&]() { expected = cullAndCompactScalar(params, instances.data(), all.data(), scalar.data()); });
+    const double simdMs = rmdl_test::bestOf(10, [&]() { visible = cullAndCompact(params, instances.data(), all.data(), simd.data()); });
+    RMDL_CHECK(visible == expected && std::memcmp(scalar.data(), simd.data(), visible * sizeof(RMDLDrawIndexedArguments)) == 0);
+    std::printf("  1M instances, %u visible: scalar %.2f ms, SIMD + pool (%u workers) %.2f ms, %.1fx\n",
+                visible, scalarMs, parallel::defaultPool().size(), simdMs, scalarMs / simdMs);
+}
+
+RMDL_TEST_MAIN()
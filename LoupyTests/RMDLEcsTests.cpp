@@ -0,0 +1,309 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLEcsTests.cpp             +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 13:47:12      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+// Sources: RMDLEcs.cpp RMDLParallel.cpp
+
+#include "RMDLTest.hpp"
+#include "RMDLEcs.hpp"
+
+#include <algorithm>
+#include <map>
+#include <optional>
+#include <random>
+
+using namespace ecs;
+
+namespace
+{
+    struct Position { float x, y, z; };
+    struct Velocity { float x, y, z; };
+    struct Health { int hp; };
+    // Owns heap memory, so a relocation that copied bytes wrongly would show.
+    struct Name { std::string s; };
+    struct Tag { };
+
+    /// What each entity should have, kept outside the world.
+    struct Expected
+    {
+        Entity                      entity;
+        std::optional<Position>     position;
+        std::optional<Health>       health;
+        std::optional<Name>         name;
+    };
+
+    using Model = std::map<uint32_t, Expected>;
+
+    Model populate( World& world, std::mt19937& rng )
+    {
+        Model model;
+        for (int i = 0; i < 30000; ++i)
+        {
+            Expected e;
+            switch (rng() % 4)
+            {
+                case 0:
+                    e.entity = world.create();
+                    break;
+                case 1:
+                    e.position = Position{ (float)i, 0.f, 0.f };
+                    e.entity = world.create(*e.position);
+                    break;
+                case 2:
+                    e.position = Position{ (float)i, 1.f, 0.f };
+                    e.name = Name{ "n" + std::to_string(i) + std::string(20, 'x') };
+                    e.entity = world.create(*e.position, Name{ e.name->s });
+                    break;
+                default:
+                    e.health = Health{ i };
+                    e.name = Name{ std::to_string(i) };
+                    e.entity = world.create(*e.health, Name{ e.name->s });
+                    break;
+            }
+            model[e.entity.index] = e;
+        }
+        return (model);
+    }
+
+    /// Random adds, removes, destroys and creates, mirrored in the model.
+    bool churn( World& world, Model& model, std::mt19937& rng, int operations )
+    {
+        bool reusedHandle = false;
+        for (int i = 0; i < operations; ++i)
+        {
+            Model::iterator it = model.lower_bound(rng() % 40000);
+            if (it == model.end())
+                it = model.begin();
+            Expected& e = it->second;
+            switch (rng() % 8)
+            {
+                case 0: e.position = Position{ (float)i, 2.f, 3.f }; world.add(e.entity, *e.position); break;
+                case 1: e.position.reset(); world.remove<Position>(e.entity); break;
+                case 2: e.health = Health{ i }; world.add(e.entity, *e.health); break;
+                case 3: e.health.reset(); world.remove<Health>(e.entity); break;
+                case 4: e.name = Name{ "name" + std::to_string(i) + std::string(i % 40, 'y') }; world.add(e.entity, Name{ e.name->s }); break;
+                case 5: e.name.reset(); world.remove<Name>(e.entity); break;
+                case 6:
+                {
+                    const Entity old = e.entity;
+                    world.destroy(old);
+                    model.erase(it);
+                    const Entity fresh = world.create();
+                    reusedHandle |= world.isAlive(old) || fresh == old;
+                    model[fresh.index] = Expected{ fresh, {}, {}, {} };
+                    break;
+                }
+                default:
+                    world.add(e.entity, Tag{});
+                    world.remove<Tag>(e.entity);
+                    break;
+            }
+        }
+        return (!reusedHandle);
+    }
+
+    size_t mismatches( World& world, const Model& model )
+    {
+        size_t wrong = 0;
+        for (const auto& [index, e] : model)
+        {
+            const Position* p = world.get<Position>(e.entity);
+            const Health* h = world.get<Health>(e.entity);
+            const Name* n = world.get<Name>(e.entity);
+            wrong += !world.isAlive(e.entity);
+            wrong += !p != !e.position || (p && (p->x != e.position->x || p->y != e.position->y));
+            wrong += !h != !e.health || (h && h->hp != e.health->hp);
+            wrong += !n != !e.name || (n && n->s != e.name->s);
+        }
+        return (wrong);
+    }
+}
+
+RMDL_TEST( worldMatchesModelUnderChurn )
+{
+    std::mt19937 rng(7);
+    World world;
+    Model model = populate(world, rng);
+    RMDL_CHECK(churn(world, model, rng, 200000));
+    RMDL_CHECK(mismatches(world, model) == 0 && world.entityCount() == model.size());
+
+    size_t positions = 0, healths = 0, wrongRows = 0;
+    world.each<const Position>([&]( const Position& ) { ++positions; });
+    world.each<Health>([&]( Entity e, Health& h ) { ++healths; wrongRows += world.get<Health>(e) != &h; });
+    const size_t expectedPositions = std::count_if(model.begin(), model.end(), []( const auto& m ) { return (m.second.position.has_value()); });
+    const size_t expectedHealths = std::count_if(model.begin(), model.end(), []( const auto& m ) { return (m.second.health.has_value()); });
+    RMDL_CHECK(positions == expectedPositions && healths == expectedHealths && wrongRows == 0);
+}
+
+RMDL_TEST( chunksAreSixteenKilobytes )
+{
+    World world;
+    for (int i = 0; i < 10000; ++i)
+        world.create(Position{ 0.f, 0.f, 0.f }, Velocity{ 0.f, 0.f, 0.f });
+    // Two 12-byte components plus the entity handle per row, at most.
+    const size_t perChunk = kChunkBytes / (sizeof(Position) + sizeof(Velocity) + sizeof(Entity));
+    std::vector<size_t> rows;
+    world.eachChunk<const Position, const Velocity>([&]( size_t count, const Position*, const Velocity* ) { rows.push_back(count); });
+    RMDL_CHECK(rows.size() == world.chunkCount() && rows[0] <= perChunk && rows[0] * (rows.size() - 1) < 10000);
+    // Full chunks, then the rest.
+    RMDL_CHECK(std::all_of(rows.begin(), rows.end() - 1, [&]( size_t n ) { return (n == rows[0]); }));
+    RMDL_CHECK(rows[0] * (rows.size() - 1) + rows.back() == 10000);
+}
+
+RMDL_TEST( commandBuffersApplyInOrder )
+{
+    std::mt19937 rng(11);
+    World world;
+    Model model = populate(world, rng);
+    const Entity victim = model.begin()->second.entity;
+
+    CommandBuffer commands;
+    const Entity pending = commands.create();
+    commands.add(pending, Name{ std::string(100, 'z') });
+    commands.add(pending, Health{ 5 });
+    commands.destroy(victim);
+    commands.add(victim, Health{ 1 });          // after the destroy: dropped
+    const Entity stillborn = commands.create();
+    commands.destroy(stillborn);
+    commands.add(stillborn, Name{ "dropped payload" });
+    {
+        // Never applied: its payloads are released with it.
+        CommandBuffer discarded;
+        discarded.add(victim, Name{ std::string(200, 'q') });
+    }
+    const size_t before = world.entityCount();
+    world.apply(commands);
+    RMDL_CHECK(world.entityCount() == before && !world.isAlive(victim) && commands.empty());
+    int found = 0;
+    world.each<Name, Health>([&]( Name& n, Health& h ) { found += h.hp == 5 && n.s == std::string(100, 'z'); });
+    RMDL_CHECK(found == 1);
+}
+
+RMDL_TEST( scheduleRunsNonConflictingSystemsTogether )
+{
+    Schedule schedule;
+    const uint32_t integrate = schedule.add("integrate", { maskOf<Velocity>(), maskOf<Position>() }, []( World& w, CommandBuffer& )
+    {
+        w.parallelEach<const Velocity, Position>([]( const Velocity& v, Position& p ) { p.x += v.x; });
+    });
+    const uint32_t damage = schedule.add("damage", { maskOf<Position>(), maskOf<Health>() }, []( World& w, CommandBuffer& c )
+    {
+        w.each<const Position, Health>([&]( Entity e, const Position& p, Health& h )
+        {
+            if (p.x > 5.f && --h.hp <= 0)
+                c.destroy(e);
+        });
+    });
+    const uint32_t names = schedule.add("names", { 0, maskOf<Name>() }, []( World& w, CommandBuffer& ) { w.each<Name>([]( Name& n ) { n.s += "!"; }); });
+    const uint32_t spawn = schedule.add("spawn", { 0, 0, true }, []( World&, CommandBuffer& c )
+    {
+        const Entity e = c.create();
+        c.add(e, Position{ 0.f, 0.f, 0.f });
+        c.add(e, Velocity{ 1.f, 0.f, 0.f });
+        c.add(e, Health{ 3 });
+    });
+    const uint32_t read = schedule.add("read", { maskOf<Position>(), 0 }, []( World& w, CommandBuffer& )
+    {
+        float sum = 0.f;
+        w.each<const Position>([&]( const Position& p ) { sum += p.x; });
+        (void)sum;
+    });
+    RMDL_CHECK(schedule.phaseOf(integrate) == 0 && schedule.phaseOf(names) == 0);
+    RMDL_CHECK(schedule.phaseOf(damage) == 1 && schedule.phaseOf(spawn) == 2 && schedule.phaseOf(read) == 3);
+
+    // One spawn a frame; each lives 6 frames to reach x > 5, then 3 more.
+    World world;
+    for (int frame = 0; frame < 20; ++frame)
+        schedule.run(world);
+    RMDL_CHECK(world.entityCount() == 8);
+}
+
+RMDL_BENCH( millionEntityIteration )
+{
+    const size_t count = 1000000;
+    World world;
+    std::vector<Entity> entities;
+    entities.reserve(count);
+    const double create = rmdl_test::milliseconds([&]()
+    {
+        for (size_t i = 0; i < count; ++i)
+            entities.push_back(world.create(Position{ (float)i, 0.f, 0.f }, Velocity{ 1.f, 2.f, 3.f }));
+    });
+    // A quarter in a second archetype, so queries span two.
+    for (size_t i = 0; i < count; i += 4)
+        world.add(entities[i], Health{ 1 });
+    std::printf("  create %zu (Position, Velocity): %.1f ms, %zu chunks\n", count, create, world.chunkCount());
+
+    const float dt = 0.016f;
+    std::vector<Position> positions(count);
+    std::vector<Velocity> velocities(count, Velocity{ 1.f, 2.f, 3.f });
+    auto step = [dt]( const Velocity& v, Position& p ) { p.x += v.x * dt; p.y += v.y * dt; p.z += v.z * dt; };
+    const double plain = rmdl_test::bestOf(10, [&]()
+    {
+        for (size_t i = 0; i < count; ++i)
+            step(velocities[i], positions[i]);
+    });
+    const double each = rmdl_test::bestOf(10, [&]() { world.each<const Velocity, Position>(step); });
+    const double chunked = rmdl_test::bestOf(10, [&]()
+    {
+        world.eachChunk<const Velocity, Position>([&]( size_t n, const Velocity* v, Position* p )
+        {
+            for (size_t i = 0; i < n; ++i)
+                step(v[i], p[i]);
+        });
+    });
+    const double parallel = rmdl_test::bestOf(10, [&]() { world.parallelEach<const Velocity, Position>(step); });
+    float sum = 0.f;
+    world.each<const Position>([&]( const Position& p ) { sum += p.x; });
+    volatile float sink = sum + positions[count - 1].x;
+    (void)sink;
+    std::printf("  iterate: plain arrays %.2f ms, each %.2f ms, eachChunk %.2f ms, parallelEach %.2f ms\n", plain, each, chunked, parallel);
+}
+
+RMDL_BENCH( componentChurn )
+{
+    const size_t count = 1000000;
+    World world;
+    std::vector<Entity> entities;
+    entities.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+        entities.push_back(world.create(Position{ 0.f, 0.f, 0.f }, Velocity{ 0.f, 0.f, 0.f }));
+
+    // Every tenth entity moves to an archetype and back.
+    const double direct = rmdl_test::bestOf(5, [&]()
+    {
+        for (size_t i = 0; i < count; i += 10)
+            world.add(entities[i], Tag{});
+        for (size_t i = 0; i < count; i += 10)
+            world.remove<Tag>(entities[i]);
+    });
+    double buffered = 1e300;
+    for (int run = 0; run < 5; ++run)
+    {
+        CommandBuffer commands;
+        for (size_t i = 1; i < count; i += 10)
+            commands.add(entities[i], Tag{});
+        for (size_t i = 1; i < count; i += 10)
+            commands.remove<Tag>(entities[i]);
+        buffered = std::min(buffered, rmdl_test::milliseconds([&]() { world.apply(commands); }));
+    }
+    const double recycle = rmdl_test::milliseconds([&]()
+    {
+        for (size_t i = 0; i < count; i += 2)
+            world.destroy(entities[i]);
+        for (size_t i = 0; i < count / 2; ++i)
+            world.create(Position{ 0.f, 0.f, 0.f }, Velocity{ 0.f, 0.f, 0.f });
+    });
+    RMDL_CHECK(world.entityCount() == count);
+    std::printf("  add + remove on 100k entities: %.1f ms (%.0f ns per change), through a command buffer %.1f ms\n",
+                direct, direct * 1e6 / (count / 5), buffered);
+    std::printf("  destroy + create 500k: %.1f ms\n", recycle);
+}
+
+RMDL_TEST_MAIN()
@@ -0,0 +1,175 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLFramePacerTests.cpp      +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 11:58:34      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+// Sources: RMDLFramePacer.cpp
+
+#include "RMDLTest.hpp"
+#include "RMDLFramePacer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <thread>
+
+using namespace frame_pacing;
+
+namespace
+{
+    constexpr double kVsync = 1.0 / 60.0;
+
+    struct Load
+    {
+        double  cpu;
+        double  gpu;
+        double  jitter;     // standard deviation of both
+    };
+
+    /// The frame loop on a simulated clock: one CPU and one GPU timeline, a
+    /// drawable that frees up when the frame three back is presented, and
+    /// presentation at the first vsync after the GPU is done.
+    PacingStats simulate( const Load& load, uint32_t minInFlight, uint32_t maxInFlight, uint32_t frames = 1200 )
+    {
+        PacerConfig config;
+        config.minInFlight = minInFlight;
+        config.maxInFlight = maxInFlight;
+        FramePacer pacer(config);
+        std::mt19937 rng(1);
+        std::normal_distribution<double> jitter(0.0, load.jitter);
+        std::vector<double> gpuDone(frames + 1, 0.0), presents(frames + 1, 0.0);
+        double cpuFree = 0.0, gpuFree = 0.0, lastPresent = 0.0;
+        for (uint64_t frame = 1; frame <= frames; ++frame)
+        {
+            const uint64_t wait = pacer.waitTarget(frame);
+            const double start = pacer.startTime(std::max(cpuFree, wait ? gpuDone[wait] : 0.0));
+            pacer.beginFrame(frame, start);
+            const double acquired = std::max(start, frame > 3 ? presents[frame - 3] : 0.0);
+            pacer.blocked(frame, acquired - start);
+            pacer.latchInput(frame, acquired);
+
+            const double cpuEnd = acquired + std::max(0.0005, load.cpu + jitter(rng));
+            pacer.endCpu(frame, cpuEnd);
+            cpuFree = cpuEnd;
+            const double gpuStart = std::max(cpuEnd, gpuFree);
+            gpuFree = gpuDone[frame] = gpuStart + std::max(0.0005, load.gpu + jitter(rng));
+            pacer.gpuCompleted(frame, gpuStart, gpuFree);
+
+            double present = std::ceil(gpuFree / kVsync) * kVsync;
+            if (present <= lastPresent)
+                present = lastPresent + kVsync;
+            presents[frame] = lastPresent = present;
+            pacer.presented(frame, present);
+        }
+        return (pacer.stats());
+    }
+
+    const Load kLight   = { 0.004, 0.005, 0.0003 };
+    const Load kMedium  = { 0.008, 0.010, 0.0005 };
+    const Load kHeavy   = { 0.013, 0.014, 0.0015 };
+
+    bool near( double a, double b, double tolerance ) { return (std::fabs(a - b) <= tolerance); }
+}
+
+RMDL_TEST( percentilesOfTheWindow )
+{
+    PercentileWindow window(100);
+    RMDL_CHECK(window.percentile(0.5) == 0.0);
+    for (int i = 1; i <= 100; ++i)
+        window.push(101 - i);
+    RMDL_CHECK(window.percentile(0.0) == 1.0 && window.percentile(1.0) == 100.0);
+    RMDL_CHECK(window.percentile(0.5) == 50.0 && window.percentile(0.99) == 99.0);
+    // Only the last 100 count.
+    for (int i = 0; i < 100; ++i)
+        window.push(7.0);
+    RMDL_CHECK(window.count() == 100 && window.percentile(1.0) == 7.0);
+}
+
+RMDL_TEST( lightLoadRunsOneFrameInFlight )
+{
+    const PacingStats stats = simulate(kLight, 1, 3);
+    RMDL_CHECK(stats.inFlight == 1);
+    RMDL_CHECK(near(stats.frameP50, kVsync, 1e-4) && near(stats.frameP99, kVsync, 1e-4));
+    // Latched late enough to be shown within the frame it was made for.
+    RMDL_CHECK(stats.latencyP99 < kVsync);
+}
+
+RMDL_TEST( mediumLoadGoesToTwoAndHoldsTheRate )
+{
+    const PacingStats adaptive = simulate(kMedium, 1, 3);
+    const PacingStats single = simulate(kMedium, 1, 1);
+    RMDL_CHECK(adaptive.inFlight == 2 && adaptive.depthChanges >= 1);
+    RMDL_CHECK(near(adaptive.frameP99, kVsync, 1e-4));
+    // CPU and GPU back to back miss vsync with only one in flight.
+    RMDL_CHECK(single.inFlight == 1 && single.frameP99 > adaptive.frameP99 + 0.001);
+}
+
+RMDL_TEST( heavyLoadGoesToThree )
+{
+    const PacingStats stats = simulate(kHeavy, 1, 3);
+    RMDL_CHECK(stats.inFlight == 3);
+    RMDL_CHECK(stats.frameP50 < kVsync + 1e-4);
+}
+
+RMDL_TEST( fixedDepthNeverChanges )
+{
+    for (const Load& load : { kLight, kMedium, kHeavy })
+    {
+        for (uint32_t depth = 1; depth <= 3; ++depth)
+        {
+            const PacingStats stats = simulate(load, depth, depth, 300);
+            RMDL_CHECK(stats.inFlight == depth && stats.depthChanges == 0);
+        }
+    }
+}
+
+RMDL_TEST( reportsFromAnotherThread )
+{
+    FramePacer pacer;
+    std::thread gpu([&]()
+    {
+        for (uint64_t frame = 1; frame < 5000; ++frame)
+        {
+            pacer.gpuCompleted(frame, frame * kVsync, frame * kVsync + 0.001);
+            pacer.presented(frame, (frame + 1) * kVsync);
+        }
+    });
+    for (uint64_t frame = 1; frame < 5000; ++frame)
+    {
+        pacer.beginFrame(frame, frame * kVsync);
+        pacer.endCpu(frame, frame * kVsync + 0.001);
+        RMDL_CHECK(pacer.stats().inFlight >= 1);
+    }
+    gpu.join();
+}
+
+RMDL_BENCH( loadsOnASimulatedClock )
+{
+    struct Row
+    {
+        const char* name;
+        Load        load;
+        uint32_t    minInFlight;
+        uint32_t    maxInFlight;
+    };
+    const Row rows[] =
+    {
+        { "light, adaptive",  kLight,  1, 3 }, { "light, 3",  kLight,  3, 3 },
+        { "medium, adaptive", kMedium, 1, 3 }, { "medium, 1", kMedium, 1, 1 }, { "medium, 3", kMedium, 3, 3 },
+        { "heavy, adaptive",  kHeavy,  1, 3 }, { "heavy, 2",  kHeavy,  2, 2 },
+    };
+    for (const Row& row : rows)
+    {
+        const PacingStats s = simulate(row.load, row.minInFlight, row.maxInFlight);
+        std::printf("  %-17s %u in flight, frame p50/p99 %.2f/%.2f ms, latency p50/p99 %.2f/%.2f ms, %llu late\n",
+                    row.name, s.inFlight, s.frameP50 * 1e3, s.frameP99 * 1e3, s.latencyP50 * 1e3, s.latencyP99 * 1e3,
+                    (unsigned long long)s.lateFrames);
+    }
+}
+
+RMDL_TEST_MAIN()
@@ -0,0 +1,206 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLGlyphCacheTests.cpp      +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 09:33:05      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+// Sources: RMDLGlyphCache.cpp RMDLTextBatch.cpp
+
+#include "RMDLTest.hpp"
+#include "RMDLGlyphCache.hpp"
+
+#include <cmath>
+#include <random>
+#include <string>
+
+using namespace text;
+
+namespace
+{
+    /// Fills every glyph with its codepoint's low byte, so a texel tells
+    /// which glyph it belongs to. U+FFFF does not exist.
+    struct FakeRasterizer : GlyphRasterizer
+    {
+        uint64_t    calls = 0;
+
+        bool rasterize( uint32_t codepoint, uint16_t, uint16_t pixelSize, GlyphBitmap& out ) override
+        {
+            ++calls;
+            if (codepoint == 0xFFFF)
+                return (false);
+            out.advance = pixelSize * 0.6f;
+            out.bearingX = 0.f;
+            out.bearingY = pixelSize * 0.8f;
+            out.width = codepoint == ' ' ? 0 : (uint32_t)(codepoint >= 0x4E00 ? pixelSize : pixelSize * 0.6f);
+            out.height = codepoint == ' ' ? 0 : (uint32_t)(pixelSize * 0.8f);
+            out.coverage.assign((size_t)out.width * out.height, (uint8_t)(codepoint | 1));
+            return (true);
+        }
+
+        void lineMetrics( uint16_t, uint16_t pixelSize, float& lineHeight, float& ascent ) override
+        {
+            lineHeight = pixelSize * 1.2f;
+            ascent = pixelSize * 0.9f;
+        }
+    };
+
+    void appendUtf8( std::string& s, uint32_t cp )
+    {
+        if (cp < 0x80)
+            s += (char)cp;
+        else if (cp < 0x800)
+        {
+            s += (char)(0xC0 | cp >> 6);
+            s += (char)(0x80 | (cp & 63));
+        }
+        else if (cp < 0x10000)
+        {
+            s += (char)(0xE0 | cp >> 12);
+            s += (char)(0x80 | ((cp >> 6) & 63));
+            s += (char)(0x80 | (cp & 63));
+        }
+        else
+        {
+            s += (char)(0xF0 | cp >> 18);
+            s += (char)(0x80 | ((cp >> 12) & 63));
+            s += (char)(0x80 | ((cp >> 6) & 63));
+            s += (char)(0x80 | (cp & 63));
+        }
+    }
+
+    /// Latin, Cyrillic, Greek, a skewed draw of 3000 CJK ideographs, emoji.
+    uint32_t mixedScript( std::mt19937& rng )
+    {
+        const uint32_t k = rng() % 100;
+        if (k < 50)
+            return ('a' + rng() % 26);
+        if (k < 65)
+            return (0x410 + rng() % 32);
+        if (k < 75)
+            return (0x391 + rng() % 24);
+        if (k < 97)
+            return (0x4E00 + (uint32_t)(std::pow((rng() % 10000) / 10000.0, 3) * 3000));
+        return (0x1F600 + rng() % 64);
+    }
+
+    /// Every glyph on screen samples its own pixels.
+    bool glyphPixelsMatch( GlyphCache& cache, uint32_t codepoint, uint16_t font, uint16_t size )
+    {
+        const GlyphMetrics* pGlyph = cache.find(codepoint, font, size);
+        if (!pGlyph || pGlyph->width == 0)
+            return (true);
+        const uint32_t x = (uint32_t)(pGlyph->uvRect[0] / 65535.0 * cache.width() + 0.5);
+        const uint32_t y = (uint32_t)(pGlyph->uvRect[1] / 65535.0 * cache.height() + 0.5);
+        return (cache.pixels(pGlyph->page)[(size_t)y * cache.width() + x] == (uint8_t)(codepoint | 1));
+    }
+
+    struct HitRate
+    {
+        double      rate;
+        double      uploadBytesPerFrame;
+        double      msPerFrame;
+        uint32_t    evictions;
+    };
+
+    HitRate runCorpus( uint32_t atlasSize, uint32_t frames, bool& consistent )
+    {
+        FakeRasterizer rasterizer;
+        GlyphCacheDesc desc;
+        desc.width = desc.height = atlasSize;
+        GlyphCache cache(rasterizer, desc);
+        GlyphCacheFont fonts[3] = { { cache, 0, 14 }, { cache, 0, 24 }, { cache, 1, 20 } };
+        std::mt19937 rng(7);
+        std::string lines[40];
+        std::vector<GlyphInstance> out;
+        HitRate result = {};
+        double ms = 0.0, uploadBytes = 0.0;
+        consistent = true;
+        for (uint32_t frame = 0; frame < frames; ++frame)
+        {
+            cache.beginFrame();
+            for (int k = 0; k < (frame == 0 ? 40 : 4); ++k)
+            {
+                std::string& line = lines[rng() % 40];
+                line.clear();
+                for (int i = 0; i < 60; ++i)
+                    appendUtf8(line, i % 7 == 0 ? ' ' : mixedScript(rng));
+            }
+            ms += rmdl_test::milliseconds([&]()
+            {
+                for (int i = 0; i < 40; ++i)
+                    fonts[i % 3].prefetch(lines[i]);
+                cache.update();
+                out.clear();
+                for (int i = 0; i < 40; ++i)
+                    layoutText(lines[i], fonts[i % 3], TextStyle(), out);
+            });
+            uploadBytes += (double)cache.stats().uploadBytes;
+            result.evictions += cache.stats().evictions;
+            for (int i = 0; i < 40; i += 7)
+            {
+                size_t k = 0;
+                while (k < lines[i].size())
+                {
+                    const uint32_t cp = decodeUtf8(lines[i], k);
+                    consistent &= glyphPixelsMatch(cache, cp, i % 3 == 2 ? 1 : 0, i % 3 == 0 ? 14 : (i % 3 == 1 ? 24 : 20));
+                }
+            }
+        }
+        uint64_t lookups = 0, hits = 0;
+        for (const GlyphCacheFont& font : fonts)
+        {
+            lookups += font.lookups();
+            hits += font.hits();
+        }
+        result.rate = lookups ? (double)hits / (double)lookups : 0.0;
+        result.uploadBytesPerFrame = uploadBytes / frames;
+        result.msPerFrame = ms / frames;
+        return (result);
+    }
+}
+
+RMDL_TEST( missesAreFilledByUpdate )
+{
+    FakeRasterizer rasterizer;
+    GlyphCache cache(rasterizer, GlyphCacheDesc());
+    cache.beginFrame();
+    RMDL_CHECK(cache.find('A', 0, 16) == nullptr);
+    RMDL_CHECK(cache.find(0xFFFF, 0, 16) == nullptr);
+    cache.update();
+    RMDL_CHECK(cache.stats().inserts == 2 && !cache.uploads().empty());
+
+    cache.beginFrame();
+    const GlyphMetrics* pGlyph = cache.find('A', 0, 16);
+    RMDL_CHECK(pGlyph && pGlyph->width > 0.f);
+    RMDL_CHECK(glyphPixelsMatch(cache, 'A', 0, 16));
+    // A missing glyph is remembered, not rasterized every frame.
+    RMDL_CHECK(cache.find(0xFFFF, 0, 16) == nullptr);
+    cache.update();
+    RMDL_CHECK(rasterizer.calls == 2);
+}
+
+RMDL_TEST( smallAtlasEvictsAndStaysConsistent )
+{
+    bool consistent = false;
+    const HitRate result = runCorpus(256, 120, consistent);
+    RMDL_CHECK(consistent);
+    RMDL_CHECK(result.evictions > 0);
+}
+
+RMDL_BENCH( mixedScriptHitRate )
+{
+    for (uint32_t size : { 256u, 512u, 1024u })
+    {
+        bool consistent = false;
+        const HitRate result = runCorpus(size, 300, consistent);
+        RMDL_CHECK(consistent);
+        std::printf("  %4ux%-4u atlas: hit rate %.2f%%, %.0f upload bytes/frame, %u evictions, %.3f ms/frame\n",
+                    size, size, 100.0 * result.rate, result.uploadBytesPerFrame, result.evictions, result.msPerFrame);
+    }
+}
+
+RMDL_TEST_MAIN()
@@ -0,0 +1,224 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLHalfTests.cpp            +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 13:14:26      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+// Sources: RMDLHalf.cpp
+
+#include "RMDLTest.hpp"
+#include "RMDLHalf.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace half_float;
+
+namespace
+{
+    uint32_t bitsOf( float f )
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+        return (bits);
+    }
+
+    float floatOf( uint32_t bits )
+    {
+        float f;
+        std::memcpy(&f, &bits, sizeof(f));
+        return (f);
+    }
+
+    bool isNan( uint16_t h ) { return ((h & 0x7C00) == 0x7C00 && (h & 0x3FF) != 0); }
+
+    /// Independent of the bit tricks: the value in double, then the float bits.
+    uint32_t referenceFloat( uint16_t h )
+    {
+        const int exponent = (h >> 10) & 0x1F;
+        const int mantissa = h & 0x3FF;
+        const double sign = (h & 0x8000) ? -1.0 : 1.0;
+        if (exponent == 0x1F)
+        {
+            if (mantissa == 0)
+                return (bitsOf((float)(sign * INFINITY)));
+            // Quieted, payload at the top.
+            return ((h & 0x8000u) << 16 | 0x7FC00000u | (uint32_t)mantissa << 13);
+        }
+        const double value = exponent == 0 ? std::ldexp((double)mantissa, -24) : std::ldexp(1.0 + mantissa / 1024.0, exponent - 15);
+        return (bitsOf((float)(sign * value)));
+    }
+
+    /// Nearest half by arithmetic in double, ties to even.
+    uint16_t referenceHalf( float f )
+    {
+        const uint32_t bits = bitsOf(f);
+        const uint16_t sign = (uint16_t)((bits >> 16) & 0x8000);
+        const uint32_t magnitude = bits & 0x7FFFFFFF;
+        if (magnitude > 0x7F800000)
+            return (sign | 0x7E00 | ((magnitude >> 13) & 0x3FF));
+        const double a = std::fabs((double)f);
+        if (a >= 65520.0)
+            return (sign | 0x7C00);
+        int exponent;
+        std::frexp(a, &exponent);
+        const int unit = std::max(exponent - 11, -24);
+        const double n = std::nearbyint(a / std::ldexp(1.0, unit));
+        const double value = n * std::ldexp(1.0, unit);
+        if (value == 0.0)
+            return (sign);
+        int e;
+        const double x = std::frexp(value, &e);
+        const int biased = e - 1 + 15;
+        if (biased <= 0)
+            return (sign | (uint16_t)(value / std::ldexp(1.0, -24)));
+        return (sign | (uint16_t)(biased << 10) | (uint16_t)((x * 2.0 - 1.0) * 1024.0));
+    }
+
+    /// Runs `fn` on every path this CPU has, then restores the default.
+    template< typename F >
+    void forEachPath( F&& fn )
+    {
+        const Path original = activePath();
+        for (Path path : { Path::Software, Path::Neon, Path::F16c, Path::Avx512 })
+        {
+            if (forcePath(path))
+                fn(path);
+        }
+        forcePath(original);
+    }
+
+    bool none( uint64_t mismatches, Path path, const char* what )
+    {
+        if (mismatches != 0)
+            std::fprintf(stderr, "  %s %s: %llu mismatches\n", pathName(path), what, (unsigned long long)mismatches);
+        return (mismatches == 0);
+    }
+}
+
+RMDL_TEST( everyHalfConvertsAndRoundTrips )
+{
+    std::vector<uint16_t> halves(65536), back(65536);
+    std::vector<float> floats(65536);
+    for (uint32_t h = 0; h < 65536; ++h)
+        halves[h] = (uint16_t)h;
+    forEachPath([&]( Path path )
+    {
+        toFloat(halves.data(), floats.data(), halves.size());
+        toHalf(floats.data(), back.data(), floats.size());
+        uint64_t toFloatMismatches = 0, roundTripMismatches = 0;
+        for (uint32_t h = 0; h < 65536; ++h)
+        {
+            toFloatMismatches += bitsOf(floats[h]) != referenceFloat((uint16_t)h);
+            // Signaling NaNs come back quiet.
+            const uint16_t expected = isNan((uint16_t)h) ? (uint16_t)(h | 0x200) : (uint16_t)h;
+            roundTripMismatches += back[h] != expected;
+        }
+        RMDL_CHECK(none(toFloatMismatches, path, "half to float"));
+        RMDL_CHECK(none(roundTripMismatches, path, "round trip"));
+    });
+}
+
+RMDL_TEST( floatsRoundToNearestEven )
+{
+    // The software function against arithmetic in double, every 1009th float.
+    uint64_t mismatches = 0;
+    for (uint64_t x = 0; x < 0x100000000ull; x += 1009)
+        mismatches += halfFromFloat(floatOf((uint32_t)x)) != referenceHalf(floatOf((uint32_t)x));
+    RMDL_CHECK(none(mismatches, Path::Software, "against double"));
+    // Ties, both ways, and the edges.
+    RMDL_CHECK(halfFromFloat(1.f + 0x1p-11f) == 0x3C00 && halfFromFloat(1.f + 3 * 0x1p-11f) == 0x3C02);
+    RMDL_CHECK(halfFromFloat(65519.f) == 0x7BFF && halfFromFloat(65520.f) == 0x7C00);
+    RMDL_CHECK(halfFromFloat(0x1p-25f) == 0x0000 && halfFromFloat(0x1.000002p-25f) == 0x0001);
+    RMDL_CHECK(halfFromFloat(-0.f) == 0x8000 && halfFromFloat(1.f) == 0x3C00);
+}
+
+RMDL_TEST( everyPathGivesTheSameBits )
+{
+    // Every 61st float bit pattern, in batches, against the software function.
+    std::vector<float> floats(1 << 20);
+    std::vector<uint16_t> halves(floats.size());
+    forEachPath([&]( Path path )
+    {
+        uint64_t mismatches = 0;
+        for (uint64_t base = 0; base < 0x100000000ull; base += floats.size() * 61)
+        {
+            for (size_t k = 0; k < floats.size(); ++k)
+                floats[k] = floatOf((uint32_t)(base + k * 61));
+            toHalf(floats.data(), halves.data(), floats.size());
+            for (size_t k = 0; k < floats.size(); ++k)
+                mismatches += halves[k] != halfFromFloat(floats[k]);
+        }
+        RMDL_CHECK(none(mismatches, path, "float to half"));
+    });
+}
+
+RMDL_TEST( tailsWriteOnlyTheirElements )
+{
+    std::mt19937 rng(5);
+    std::vector<float> floats(48);
+    for (float& f : floats)
+        f = std::uniform_real_distribution<float>(-70000.f, 70000.f)(rng);
+    forEachPath([&]( Path path )
+    {
+        uint64_t mismatches = 0;
+        for (size_t count = 0; count <= 40; ++count)
+        {
+            std::vector<uint16_t> halves(count + 1, 0xAAAA);
+            toHalf(floats.data(), halves.data(), count);
+            std::vector<float> back(count + 1, -7.f);
+            toFloat(halves.data(), back.data(), count);
+            for (size_t k = 0; k < count; ++k)
+                mismatches += halves[k] != halfFromFloat(floats[k]) || bitsOf(back[k]) != bitsOf(floatFromHalf(halves[k]));
+            mismatches += halves[count] != 0xAAAA || back[count] != -7.f;
+        }
+        RMDL_CHECK(none(mismatches, path, "tails"));
+    });
+}
+
+RMDL_BENCH( everyFloatOnTheDefaultPath )
+{
+    // All 2^32 bit patterns, against the software function; too slow to run
+    // as a test on every path.
+    std::vector<float> floats(1 << 20);
+    std::vector<uint16_t> halves(floats.size());
+    uint64_t mismatches = 0;
+    const double ms = rmdl_test::milliseconds([&]()
+    {
+        for (uint64_t base = 0; base < 0x100000000ull; base += floats.size())
+        {
+            for (size_t k = 0; k < floats.size(); ++k)
+                floats[k] = floatOf((uint32_t)(base + k));
+            toHalf(floats.data(), halves.data(), floats.size());
+            for (size_t k = 0; k < floats.size(); ++k)
+                mismatches += halves[k] != halfFromFloat(floats[k]);
+        }
+    });
+    RMDL_CHECK(none(mismatches, activePath(), "every float"));
+    std::printf("  %s: 2^32 floats, %llu mismatches, %.1f s\n", pathName(activePath()), (unsigned long long)mismatches, ms * 1e-3);
+}
+
+RMDL_BENCH( gigabytesPerSecond )
+{
+    const size_t count = 4 << 20;
+    std::vector<float> floats(count);
+    std::vector<uint16_t> halves(count);
+    std::mt19937 rng(1);
+    for (float& f : floats)
+        f = std::uniform_real_distribution<float>(-1000.f, 1000.f)(rng);
+    forEachPath([&]( Path path )
+    {
+        const double toHalfMs = rmdl_test::bestOf(10, [&]() { toHalf(floats.data(), halves.data(), count); });
+        const double toFloatMs = rmdl_test::bestOf(10, [&]() { toFloat(halves.data(), floats.data(), count); });
+        // Bytes read plus written.
+        std::printf("  %-8s to half %.1f GB/s, to float %.1f GB/s\n", pathName(path),
+                    count * 6 / toHalfMs * 1e-6, count * 6 / toFloatMs * 1e-6);
+    });
+}
+
+RMDL_TEST_MAIN()
@@ -0,0 +1,287 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLInputTests.cpp           +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 12:24:19      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+// Sources: RMDLInput.cpp RMDLSimulationClock.cpp RMDLParallel.cpp
+
+#include "RMDLTest.hpp"
+#include "RMDLInput.hpp"
+#include "RMDLSimulationClock.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <filesystem>
+#include <random>
+#include <thread>
+
+using namespace input;
+
+namespace
+{
+    double now()
+    {
+        return (std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    InputEvent button( double time, Button b, bool down )
+    {
+        InputEvent event;
+        event.time = time;
+        event.type = down ? EventType::ButtonDown : EventType::ButtonUp;
+        event.code = (uint8_t)b;
+        return (event);
+    }
+
+    /// Random buttons, axes and mouse motion, stamped when posted.
+    InputEvent randomEvent( std::mt19937& rng, bool (&down)[kButtonCount] )
+    {
+        InputEvent event;
+        event.time = now();
+        switch (rng() % 4)
+        {
+            case 0:
+            case 1:
+            {
+                const uint32_t b = rng() % kButtonCount;
+                event.type = down[b] ? EventType::ButtonUp : EventType::ButtonDown;
+                event.code = (uint8_t)b;
+                down[b] = !down[b];
+                break;
+            }
+            case 2:
+                event.type = EventType::AxisValue;
+                event.code = (uint8_t)(rng() % kAxisCount);
+                event.value[0] = (float)((int)(rng() % 201) - 100) / 100.f;
+                break;
+            default:
+                event.type = EventType::MouseDelta;
+                event.value[0] = (float)((int)(rng() % 7) - 3);
+                event.value[1] = (float)((int)(rng() % 5) - 2);
+                break;
+        }
+        return (event);
+    }
+
+    double percentile( std::vector<double> values, double p )
+    {
+        if (values.empty())
+            return (0.0);
+        std::sort(values.begin(), values.end());
+        return (values[std::min(values.size() - 1, (size_t)(p * values.size()))]);
+    }
+}
+
+RMDL_TEST( tapInsideOneTick )
+{
+    InputStateMachine machine;
+    machine.push(button(1.2, Button::KeyW, true));
+    machine.push(button(1.5, Button::KeyW, false));
+    const InputState state = machine.tick(1.0, 2.0);
+    RMDL_CHECK(state.wasPressed(Button::KeyW) && state.wasReleased(Button::KeyW) && !state.isDown(Button::KeyW));
+    RMDL_CHECK(std::fabs(state.held(Button::KeyW) - 0.3f) < 1e-6f);
+}
+
+RMDL_TEST( heldTimeSplitsAcrossTicks )
+{
+    InputStateMachine machine;
+    machine.push(button(0.25, Button::Space, true));
+    machine.push(button(0.25, Button::Space, true));    // key repeat
+    machine.push(button(2.5, Button::Space, false));
+    const InputState a = machine.tick(0.0, 1.0);
+    const InputState b = machine.tick(1.0, 2.0);
+    const InputState c = machine.tick(2.0, 3.0);
+    RMDL_CHECK(a.held(Button::Space) == 0.75f && b.held(Button::Space) == 1.f && c.held(Button::Space) == 0.5f);
+    RMDL_CHECK(a.wasPressed(Button::Space) && !b.wasPressed(Button::Space) && b.isDown(Button::Space));
+    RMDL_CHECK(c.wasReleased(Button::Space) && !c.isDown(Button::Space));
+}
+
+RMDL_TEST( lateEventsCountAtTheTickStart )
+{
+    InputStateMachine machine;
+    machine.tick(0.0, 1.0);
+    // Drained after its tick had passed.
+    machine.push(button(0.5, Button::KeyA, true));
+    const InputState state = machine.tick(1.0, 2.0);
+    RMDL_CHECK(state.wasPressed(Button::KeyA) && state.held(Button::KeyA) == 1.f);
+}
+
+RMDL_TEST( liveSessionReplaysExactly )
+{
+    // A producer thread posts as the platform callbacks would; the consumer
+    // drains and ticks on its own schedule and records what it consumed.
+    InputQueue queue;
+    InputStateMachine live;
+    std::vector<InputEvent> recording;
+    live.record(&recording);
+    std::atomic<bool> done(false);
+    std::thread producer([&]()
+    {
+        std::mt19937 rng(1);
+        bool down[kButtonCount] = {};
+        for (int i = 0; i < 20000; ++i)
+        {
+            const InputEvent event = randomEvent(rng, down);
+            while (!queue.post(event))
+                std::this_thread::yield();
+            if (i % 50 == 0)
+                std::this_thread::sleep_for(std::chrono::microseconds(20));
+        }
+        done = true;
+    });
+    std::vector<InputState> states;
+    double last = now();
+    for (;;)
+    {
+        const bool finished = done.load();
+        std::this_thread::sleep_for(std::chrono::microseconds(300));
+        queue.drainInto(live);
+        const double end = now();
+        states.push_back(live.tick(last, end));
+        last = end;
+        if (finished && queue.drainInto(live) == 0 && live.pendingCount() == 0)
+            break;
+    }
+    producer.join();
+    RMDL_CHECK(recording.size() == 20000 && queue.dropped() == 0);
+
+    const std::string path = (std::filesystem::temp_directory_path() / "loupy-test.rinp").string();
+    RMDL_CHECK(saveRecording(path, recording));
+    std::vector<InputEvent> loaded;
+    RMDL_CHECK(loadRecording(path, loaded) && loaded.size() == recording.size());
+    InputStateMachine replay;
+    for (const InputEvent& event : loaded)
+        replay.push(event);
+    size_t mismatches = 0;
+    for (const InputState& state : states)
+    {
+        const InputState replayed = replay.tick(state.start, state.end);
+        mismatches += std::memcmp(&replayed, &state, sizeof(state)) != 0;
+    }
+    RMDL_CHECK(mismatches == 0);
+
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    RMDL_CHECK(!loadRecording(path, loaded));
+    std::filesystem::remove(path);
+}
+
+RMDL_TEST( heldTimeSurvivesFixedSteps )
+{
+    // The renderer gives every fixed step the slice of real time it stands for;
+    // summed over the steps, a held key is held exactly as long as it was.
+    InputStateMachine machine;
+    machine.push(button(100.0123, Button::KeyW, true));
+    machine.push(button(101.5077, Button::KeyW, false));
+    simulation::FixedStepLoop<int>* pLoop = nullptr;
+    double latch = 0.0, held = 0.0;
+    simulation::FixedStepLoop<int> loop(simulation::ClockConfig(), 0, [&]( int&, uint64_t step, double dt )
+    {
+        const double end = latch - ((double)(pLoop->nextStep() - 1 - step) + pLoop->alpha()) * dt;
+        held += machine.tick(end - dt, end).held(Button::KeyW);
+    }, []( const int& a, const int&, float ) { return (a); });
+    pLoop = &loop;
+    std::mt19937 rng(7);
+    double previous = -1.0;
+    for (double t = 99.0; t < 103.0; )
+    {
+        t += 1.0 / (30 + rng() % 200);
+        latch = t;
+        loop.advance(previous < 0.0 ? 0.0 : t - previous);
+        previous = t;
+    }
+    RMDL_CHECK(std::fabs(held - (101.5077 - 100.0123)) < 1e-4);
+}
+
+RMDL_BENCH( eventToTickLatency )
+{
+    // From post to the end of the tick that consumes it: the tick rate sets
+    // the latency, the queue adds next to nothing.
+    for (double tickRate : { 120.0, 1000.0 })
+    {
+        const int count = 1000;
+        InputQueue queue;
+        InputStateMachine machine;
+        std::vector<InputEvent> consumed;
+        machine.record(&consumed);
+        // Written before the post, read after the drain: the ring orders them.
+        std::vector<double> stamps(count, 0.0);
+        std::atomic<bool> done(false);
+        std::thread producer([&]()
+        {
+            std::mt19937 rng(2);
+            for (int i = 0; i < count; ++i)
+            {
+                InputEvent event;
+                event.type = EventType::AxisValue;
+                event.value[1] = (float)i;      // unused by axes; survives recording
+                event.time = stamps[i] = now();
+                queue.post(event);
+                std::this_thread::sleep_for(std::chrono::microseconds(200 + rng() % 800));
+            }
+            done = true;
+        });
+        std::vector<double> latencies;
+        double last = now();
+        while (!done.load() || machine.pendingCount() != 0 || latencies.size() < (size_t)count)
+        {
+            std::this_thread::sleep_for(std::chrono::duration<double>(1.0 / tickRate));
+            queue.drainInto(machine);
+            const size_t before = consumed.size();
+            const double end = now();
+            machine.tick(last, end);
+            for (size_t k = before; k < consumed.size(); ++k)
+                latencies.push_back(end - stamps[(size_t)consumed[k].value[1]]);
+            last = end;
+        }
+        producer.join();
+        RMDL_CHECK(latencies.size() == (size_t)count && queue.dropped() == 0);
+        std::printf("  %4.0f Hz ticks: event to tick p50 %.3f ms, p99 %.3f ms\n",
+                    tickRate, percentile(latencies, 0.5) * 1e3, percentile(latencies, 0.99) * 1e3);
+    }
+}
+
+RMDL_BENCH( queueThroughput )
+{
+    const int count = 200000;
+    InputEvent event;
+    event.type = EventType::MouseDelta;
+    parallel::SpscRing<InputEvent, 1024> ring;
+    long sum = 0;
+    const double ringMs = rmdl_test::milliseconds([&]()
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            event.code = (uint8_t)i;
+            ring.push(event);
+            InputEvent out;
+            ring.pop(out);
+            sum += out.code;
+        }
+    });
+    InputQueue queue;
+    InputStateMachine machine;
+    const double tickMs = rmdl_test::milliseconds([&]()
+    {
+        for (int i = 0; i < count / 1000; ++i)
+        {
+            for (int k = 0; k < 1000; ++k)
+            {
+                event.time = i;
+                queue.post(event);
+            }
+            queue.drainInto(machine);
+            machine.tick(i, i + 1);
+        }
+    });
+    RMDL_CHECK(sum > 0);
+    std::printf("  ring push + pop %.1f ns/event, post + drain + tick %.1f ns/event\n",
+                ringMs * 1e6 / count, tickMs * 1e6 / count);
+}
+
+RMDL_TEST_MAIN()
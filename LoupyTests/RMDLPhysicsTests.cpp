@@ -0,0 +1,250 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLPhysicsTests.cpp         +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 14:21:44      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+// Sources: RMDLPhysics.cpp RMDLParallel.cpp RMDLBinarySpacePartitioning.cpp
+
+#include "RMDLTest.hpp"
+#include "RMDLPhysics.hpp"
+#include "RMDLParallel.hpp"
+
+#include <cmath>
+
+using namespace physics;
+
+namespace
+{
+    Scalar scalar( double d )
+    {
+        return (Scalar::fromFloat((float)d));
+    }
+
+    Vec3 vec3( double x, double y, double z )
+    {
+        return (Vec3{ scalar(x), scalar(y), scalar(z) });
+    }
+
+    void addFloor( World& world, double half )
+    {
+        const Triangle floor[2] = { { vec3(-half, 0, -half), vec3(half, 0, -half), vec3(half, 0, half) },
+                                    { vec3(-half, 0, -half), vec3(half, 0, half), vec3(-half, 0, half) } };
+        world.addTriangles(floor, 2);
+    }
+
+    /// How close the body's nearest axis is to vertical: 1 when it lies on a face.
+    double uprightness( const World& world, BodyId body )
+    {
+        Vec3 axes[3];
+        fixed_point::rotationAxes(world.orientation(body), axes);
+        return (std::max(std::fabs(axes[0].y.toDouble()), std::max(std::fabs(axes[1].y.toDouble()), std::fabs(axes[2].y.toDouble()))));
+    }
+
+    /// A 200 x 200 floor of 800 triangles, and `count` bodies stacked in
+    /// layers of 60 x 60 above it; a third are boxes, turned and spinning,
+    /// and a fifth bounce.
+    void buildScene( World& world, int count, uint32_t seed )
+    {
+        std::vector<Triangle> floor;
+        const int cells = 20;
+        const double size = 10.0, origin = -cells * size / 2;
+        for (int i = 0; i < cells; ++i)
+        {
+            for (int k = 0; k < cells; ++k)
+            {
+                const Vec3 a = vec3(origin + i * size, 0.0, origin + k * size), b = vec3(origin + (i + 1) * size, 0.0, origin + k * size);
+                const Vec3 c = vec3(origin + (i + 1) * size, 0.0, origin + (k + 1) * size), d = vec3(origin + i * size, 0.0, origin + (k + 1) * size);
+                floor.push_back(Triangle{ a, b, c });
+                floor.push_back(Triangle{ a, c, d });
+            }
+        }
+        world.addTriangles(floor.data(), floor.size());
+
+        uint32_t state = seed;
+        auto random = [&state]() { state = state * 1664525u + 1013904223u; return ((state >> 8) / 16777216.0); };
+        const int side = 60;
+        for (int i = 0; i < count; ++i)
+        {
+            BodyDesc desc;
+            desc.shape = i % 3 == 0 ? Shape::Box : Shape::Sphere;
+            const int x = i % side, z = (i / side) % side, y = i / (side * side);
+            desc.position = vec3(origin + 5 + x * 1.5 + random() * 0.2, 1 + y * 1.2, origin + 5 + z * 1.5 + random() * 0.2);
+            desc.velocity = vec3(random() - 0.5, 0.0, random() - 0.5);
+            desc.halfExtents = vec3(0.4 + random() * 0.1, 0.4 + random() * 0.1, 0.4 + random() * 0.1);
+            desc.restitution = scalar(i % 5 == 0 ? 0.3 : 0.0);
+            if (desc.shape == Shape::Box)
+            {
+                const Vec3 axis = vec3(0.6, 0.64, 0.48);
+                desc.orientation = fixed_point::fromAxisAngle(axis, random() * 3.0);
+                desc.angularVelocity = vec3(random() - 0.5, random() - 0.5, random() - 0.5);
+            }
+            world.addBody(desc);
+        }
+    }
+}
+
+RMDL_TEST( degenerateTrianglesDoNotDivideByZero )
+{
+    // Two corners on one point: the first edge has no length, and the
+    // closest point is on the other two.
+    const Triangle sliver = { vec3(0, 0, 0), vec3(0, 0, 0), vec3(2, 0, 0) };
+    World world;
+    RMDL_CHECK(world.addTriangles(&sliver, 1) == 0);
+
+    // A thin triangle that keeps some area, but whose first edge squares to
+    // nothing at 1/65536 resolution; the sphere is nearest its long edge.
+    const Triangle thin = { vec3(0, 0, 0), Vec3{ Scalar::fromRaw(1), Scalar(), Scalar() }, vec3(0, 0, 10) };
+    RMDL_CHECK(world.addTriangles(&thin, 1) == 1);
+    BodyDesc desc;
+    desc.position = vec3(0.25, 0.25, 1);
+    desc.velocity = vec3(0, -1, 0);
+    world.addBody(desc);
+    world.step();
+    RMDL_CHECK(world.stats().contacts == 1 && world.velocity(0).y > Scalar());
+}
+
+RMDL_TEST( restsOnTheFloor )
+{
+    World world;
+    addFloor(world, 10);
+    BodyDesc desc;
+    desc.position = vec3(0, 20, 0);
+    world.addBody(desc);
+    desc.shape = Shape::Box;
+    desc.position = vec3(3, 5, 0);
+    world.addBody(desc);
+    for (int step = 0; step < 600; ++step)
+        world.step();
+    // Half a unit up, within the slop.
+    for (BodyId body : { 0u, 1u })
+    {
+        RMDL_CHECK(std::fabs(world.position(body).y.toDouble() - 0.5) < 0.02);
+        RMDL_CHECK(std::fabs(world.velocity(body).y.toDouble()) < 0.05);
+    }
+}
+
+RMDL_TEST( tiltedBoxSettlesOnAFace )
+{
+    // Dropped on a corner: the off-centre contact turns it over until a face
+    // lies flat, and four points hold it there. Clear of the floor's
+    // diagonal, so one triangle holds it.
+    World world;
+    addFloor(world, 10);
+    BodyDesc desc;
+    desc.shape = Shape::Box;
+    desc.position = vec3(4, 2, -4);
+    desc.orientation = fixed_point::fromAxisAngle(vec3(0.6, 0, 0.8), 0.6);
+    world.addBody(desc);
+    RMDL_CHECK(uprightness(world, 0) < 0.9);
+    double spin = 0.0;
+    for (int step = 0; step < 600; ++step)
+    {
+        world.step();
+        spin = std::max(spin, length(world.angularVelocity(0)).toDouble());
+    }
+    RMDL_CHECK(spin > 1.0);
+    RMDL_CHECK(uprightness(world, 0) > 0.999);
+    RMDL_CHECK(std::fabs(world.position(0).y.toDouble() - 0.5) < 0.02);
+    RMDL_CHECK(length(world.velocity(0)).toDouble() < 0.05 && length(world.angularVelocity(0)).toDouble() < 0.05);
+    RMDL_CHECK(world.stats().contacts == 4);
+}
+
+RMDL_TEST( slidingSphereStartsRolling )
+{
+    // Friction at the contact point slows a sliding ball and spins it up
+    // until it rolls, without slipping at the contact point: a solid sphere
+    // ends at 5/7 of its speed.
+    World world;
+    addFloor(world, 50);
+    BodyDesc desc;
+    desc.position = vec3(-20, 0.5, 0);
+    desc.velocity = vec3(7, 0, 0);
+    world.addBody(desc);
+    for (int step = 0; step < 180; ++step)
+        world.step();
+    const double vx = world.velocity(0).x.toDouble(), wz = world.angularVelocity(0).z.toDouble(), arm = world.position(0).y.toDouble();
+    RMDL_CHECK(std::fabs(vx - 5.0) < 0.05);
+    RMDL_CHECK(std::fabs(vx + wz * arm) < 0.01);
+}
+
+RMDL_TEST( boxesStack )
+{
+    // Face against face, the upper box turned a little about y: clipped
+    // manifolds on both contacts keep the stack still.
+    World world;
+    addFloor(world, 10);
+    BodyDesc desc;
+    desc.shape = Shape::Box;
+    desc.position = vec3(0, 0.5, 0);
+    world.addBody(desc);
+    desc.position = vec3(0.1, 1.6, 0);
+    desc.orientation = fixed_point::fromAxisAngle(vec3(0, 1, 0), 0.3);
+    world.addBody(desc);
+    for (int step = 0; step < 600; ++step)
+        world.step();
+    RMDL_CHECK(std::fabs(world.position(1).y.toDouble() - 1.5) < 0.04);
+    RMDL_CHECK(std::fabs(world.position(1).x.toDouble() - 0.1) < 0.02);
+    RMDL_CHECK(uprightness(world, 0) > 0.999 && uprightness(world, 1) > 0.999);
+    RMDL_CHECK(length(world.velocity(1)).toDouble() < 0.05 && length(world.angularVelocity(1)).toDouble() < 0.05);
+}
+
+RMDL_TEST( replayHashesMatchAtEveryThreadCount )
+{
+    // One replay per pool size, hashed after every step.
+    const int count = 2000, steps = 120;
+    parallel::ThreadPool one(1), four(4), seven(7);
+    World a, b, c, d;
+    buildScene(a, count, 7);
+    buildScene(b, count, 7);
+    buildScene(c, count, 7);
+    buildScene(d, count, 7);
+    int mismatches = 0;
+    std::vector<uint64_t> hashes;
+    for (int step = 0; step < steps; ++step)
+    {
+        a.step(one);
+        b.step(four);
+        c.step(seven);
+        d.step();
+        hashes.push_back(a.stateHash());
+        mismatches += a.stateHash() != b.stateHash() || a.stateHash() != c.stateHash() || a.stateHash() != d.stateHash();
+    }
+    RMDL_CHECK(mismatches == 0);
+
+    // And again from scratch: the same hash, step for step.
+    World again;
+    buildScene(again, count, 7);
+    int diverged = 0;
+    for (int step = 0; step < steps; ++step)
+    {
+        again.step(four);
+        diverged += again.stateHash() != hashes[step];
+    }
+    RMDL_CHECK(diverged == 0);
+}
+
+RMDL_BENCH( tenThousandBodies )
+{
+    const int count = 10000, steps = 300;
+    parallel::ThreadPool pool(1);
+    World world;
+    buildScene(world, count, 7);
+    double total = 0.0, worst = 0.0;
+    for (int step = 0; step < steps; ++step)
+    {
+        const double ms = rmdl_test::milliseconds([&]() { world.step(pool); });
+        total += ms;
+        worst = std::max(worst, ms);
+    }
+    const double pooled = rmdl_test::milliseconds([&]() { world.step(); });
+    std::printf("  %d bodies, %d steps: %.0f bodies/ms on one thread (%.2f ms/step, worst %.2f ms), %.0f bodies/ms on the default pool; %u pairs, %u contact points\n",
+                count, steps, count * steps / total, total / steps, worst, count / pooled, world.stats().pairs, world.stats().contacts);
+    std::printf("  state hash %016llx\n", (unsigned long long)world.stateHash());
+}
+
+RMDL_TEST_MAIN()
@@ -0,0 +1,228 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLPipelineCacheTests.cpp   +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 10:31:52      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+// Sources: RMDLPipelineCache.cpp RMDLShaderCache.cpp RMDLParallel.cpp
+
+#include "RMDLTest.hpp"
+#include "RMDLPipelineCache.hpp"
+#include "RMDLParallel.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace pipeline_cache;
+
+namespace
+{
+    /// Pipelines are heap strings holding the label. Compiles wait while the gate
+    /// is closed, so a test decides what is still pending; "Broken" fails.
+    struct StubCompiler : PipelineCompiler
+    {
+        std::atomic<int>        calls { 0 };
+        std::atomic<int>        live { 0 };
+        int                     delayMs = 0;
+        std::mutex              mutex;
+        std::condition_variable opened;
+        bool                    gateOpen = true;
+
+        void* compile( const PipelineDesc& desc ) override
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                opened.wait(lock, [this]() { return (gateOpen); });
+            }
+            ++calls;
+            if (delayMs)
+                std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
+            if (desc.fragmentFunction == "Broken")
+                return (nullptr);
+            ++live;
+            return (new std::string(desc.label));
+        }
+
+        void release( void* pPipeline ) override
+        {
+            --live;
+            delete (std::string *)pPipeline;
+        }
+
+        void setGate( bool open )
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            gateOpen = open;
+            opened.notify_all();
+        }
+    };
+
+    PipelineDesc desc( const std::string& name )
+    {
+        PipelineDesc d;
+        d.label = name;
+        d.vertexFunction = name + "Vs";
+        d.fragmentFunction = "Ps";
+        d.colorFormats[0] = 115;
+        d.blend[0] = BlendMode::Alpha;
+        return (d);
+    }
+
+    const char* label( const PipelineRef& ref )
+    {
+        return (ref.get() ? ((std::string *)ref.get())->c_str() : "");
+    }
+}
+
+RMDL_TEST( keysIgnoreLabelsAndUnusedFields )
+{
+    PipelineDesc a = desc("A"), b = a;
+    b.label = "other";
+    b.computeFunction = "ignored";
+    b.blend[2] = BlendMode::Premultiplied;
+    RMDL_CHECK(pipelineKey(a) == pipelineKey(b));
+    b.colorFormats[0] = 80;
+    RMDL_CHECK(pipelineKey(a) != pipelineKey(b));
+
+    a.kind = PipelineKind::Compute;
+    a.computeFunction = "k";
+    const std::vector<uint8_t> bytes = canonicalBytes(a);
+    PipelineDesc parsed;
+    RMDL_CHECK(parseCanonicalBytes(bytes.data(), bytes.size(), parsed) && pipelineKey(parsed) == pipelineKey(a));
+    RMDL_CHECK(!parseCanonicalBytes(bytes.data(), bytes.size() - 1, parsed));
+}
+
+RMDL_TEST( placeholdersStandInUntilReady )
+{
+    StubCompiler stub;
+    parallel::ThreadPool pool(2);
+    {
+        PipelineManager manager(stub, pool);
+        const PipelineRef fallback = manager.request(desc("fallback"));
+        manager.wait(fallback);
+        stub.setGate(false);
+        const PipelineRef ref = manager.request(desc("A"), Priority::Immediate, fallback);
+        RMDL_CHECK(std::string(label(ref)) == "fallback" && ref.state() == PipelineState::Pending);
+        stub.setGate(true);
+        RMDL_CHECK(manager.wait(ref) && std::string(label(ref)) == "A");
+
+        PipelineDesc broken = desc("B");
+        broken.fragmentFunction = "Broken";
+        const PipelineRef failed = manager.request(broken, Priority::Immediate, fallback);
+        manager.waitAll();
+        RMDL_CHECK(failed.state() == PipelineState::Failed && std::string(label(failed)) == "fallback");
+        RMDL_CHECK(manager.request(desc("A")).key() == ref.key() && manager.stats().deduplicated == 1);
+    }
+    RMDL_CHECK(stub.live == 0);
+}
+
+RMDL_TEST( placeholderCyclesDoNotHang )
+{
+    StubCompiler stub;
+    parallel::ThreadPool pool(1);
+    stub.setGate(false);
+    {
+        PipelineManager manager(stub, pool);
+        // A waits on B, then B is asked for again with A as its placeholder.
+        const PipelineRef b = manager.request(desc("B"));
+        const PipelineRef a = manager.request(desc("A"), Priority::Immediate, b);
+        const PipelineRef b2 = manager.request(desc("B"), Priority::Immediate, a);
+        RMDL_CHECK(a.get() == nullptr && b.get() == nullptr && b2.get() == nullptr);
+        // And an entry that is its own placeholder.
+        const PipelineRef c = manager.request(desc("C"));
+        manager.request(desc("C"), Priority::Immediate, c);
+        RMDL_CHECK(c.get() == nullptr);
+        stub.setGate(true);
+        manager.waitAll();
+        RMDL_CHECK(std::string(label(a)) == "A" && std::string(label(b)) == "B" && std::string(label(c)) == "C");
+    }
+}
+
+RMDL_TEST( placeholderChainsResolveToTheirEnd )
+{
+    StubCompiler stub;
+    parallel::ThreadPool pool(1);
+    PipelineManager manager(stub, pool);
+    const PipelineRef root = manager.request(desc("root"));
+    manager.wait(root);
+    stub.setGate(false);
+    const PipelineRef middle = manager.request(desc("middle"));
+    // `leaf` points at `middle`, which only later gets `root` as its placeholder:
+    // `leaf` must follow it there.
+    const PipelineRef leaf = manager.request(desc("leaf"), Priority::Immediate, middle);
+    RMDL_CHECK(leaf.get() == nullptr);
+    manager.request(desc("middle"), Priority::Immediate, root);
+    RMDL_CHECK(std::string(label(middle)) == "root" && std::string(label(leaf)) == "root");
+    const PipelineRef other = manager.request(desc("other"), Priority::Immediate, leaf);
+    RMDL_CHECK(std::string(label(other)) == "root");
+    stub.setGate(true);
+    manager.waitAll();
+}
+
+RMDL_TEST( manifestsPrewarmAndQueuedWorkIsDropped )
+{
+    StubCompiler stub;
+    parallel::ThreadPool pool(2);
+    const std::string path = (std::filesystem::temp_directory_path() / "loupy-test-pipelines.bin").string();
+    {
+        PipelineManager manager(stub, pool);
+        for (int i = 0; i < 10; ++i)
+            manager.request(desc("P" + std::to_string(i)));
+        manager.waitAll();
+        RMDL_CHECK(manager.saveManifest(path));
+    }
+    stub.calls = 0;
+    {
+        PipelineManager manager(stub, pool);
+        RMDL_CHECK(manager.prewarm(path) == 10);
+        const PipelineRef ref = manager.request(desc("P7"));
+        RMDL_CHECK(manager.wait(ref) != nullptr);
+        manager.waitAll();
+        RMDL_CHECK(stub.calls == 10 && manager.stats().deduplicated == 1);
+    }
+    // Destroyed with compiles queued and one stuck in the compiler.
+    stub.setGate(false);
+    std::thread opener;
+    {
+        PipelineManager manager(stub, pool);
+        for (int i = 0; i < 10; ++i)
+            manager.request(desc("Q" + std::to_string(i)), Priority::Background);
+        opener = std::thread([&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            stub.setGate(true);
+        });
+    }
+    opener.join();
+    RMDL_CHECK(stub.live == 0 && stub.calls < 20);
+    std::filesystem::remove(path);
+}
+
+RMDL_BENCH( requestsDoNotWaitForCompiles )
+{
+    StubCompiler stub;
+    stub.delayMs = 20;
+    PipelineManager manager(stub);
+    const PipelineRef fallback = manager.request(desc("fallback"));
+    manager.wait(fallback);
+    std::vector<PipelineRef> refs;
+    const double requestMs = rmdl_test::milliseconds([&]() {
+        for (int i = 0; i < 40; ++i)
+            refs.push_back(manager.request(desc("P" + std::to_string(i)), Priority::Immediate, fallback));
+    });
+    int standIns = 0;
+    for (const PipelineRef& ref : refs)
+        standIns += ref.get() == fallback.get();
+    const double compileMs = rmdl_test::milliseconds([&]() { manager.waitAll(); });
+    std::printf("  40 requests of 20 ms pipelines: %.3f ms to request, %d drawn with the placeholder, %.0f ms to compile all on %u workers\n",
+                requestMs, standIns, compileMs, parallel::defaultPool().size());
+}
+
+RMDL_TEST_MAIN()
@@ -0,0 +1,173 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLPortableSimdTests.cpp    +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 12:57:41      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+// Sources: RMDLMathUtils.cpp RMDLCamera.cpp RMDLRandom.cpp
+
+#include "RMDLTest.hpp"
+#include "RMDLMathUtils.hpp"
+#include "RMDLCamera.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <random>
+
+// The shader-visible structs keep Apple's sizes and offsets.
+static_assert(sizeof(RMDLCameraUniforms) == 544 && offsetof(RMDLCameraUniforms, frustumPlanes) == 448, "camera uniforms layout");
+static_assert(sizeof(RMDLObjVertex) == 48, "vertex layout");
+static_assert(alignof(simd::float3) == 16 && alignof(simd::float4x4) == 16, "alignment");
+
+namespace
+{
+    struct Random
+    {
+        std::mt19937                            engine { 7 };
+        std::uniform_real_distribution<float>   range { -2.f, 2.f };
+
+        float           operator()()    { return (range(engine)); }
+        simd::float3    float3()        { return (simd::float3{ (*this)(), (*this)(), (*this)() }); }
+        simd::float4    float4()        { return (simd::float4{ (*this)(), (*this)(), (*this)(), (*this)() }); }
+        /// Diagonally dominant, so its inverse is well conditioned.
+        simd::float4x4  float4x4( float diagonal = 0.f )
+        {
+            simd::float4x4 m(float4(), float4(), float4(), float4());
+            for (int k = 0; k < 4; ++k)
+                m.columns[k][k] += diagonal;
+            return (m);
+        }
+    };
+
+    double identityError4( const simd::float4x4& m )
+    {
+        double error = 0.0;
+        for (int c = 0; c < 4; ++c)
+            for (int r = 0; r < 4; ++r)
+                error = std::max(error, std::fabs(m.columns[c][r] - (c == r ? 1.0 : 0.0)));
+        return (error);
+    }
+}
+
+RMDL_TEST( matrixOperationsMatchDouble )
+{
+    Random random;
+    double mul = 0.0, transpose = 0.0, inverse4 = 0.0, inverse3 = 0.0;
+    for (int i = 0; i < 100000; ++i)
+    {
+        const simd::float4x4 a = random.float4x4(), b = random.float4x4();
+        const simd::float4x4 p = a * b;
+        for (int c = 0; c < 4; ++c)
+        {
+            for (int r = 0; r < 4; ++r)
+            {
+                double sum = 0.0;
+                for (int k = 0; k < 4; ++k)
+                    sum += (double)a.columns[k][r] * b.columns[c][k];
+                mul = std::max(mul, std::fabs(sum - p.columns[c][r]));
+            }
+        }
+        const simd::float4x4 t = simd::transpose(a);
+        for (int c = 0; c < 4; ++c)
+            for (int r = 0; r < 4; ++r)
+                transpose = std::max(transpose, (double)std::fabs(t.columns[c][r] - a.columns[r][c]));
+
+        const simd::float4x4 w = random.float4x4(5.f);
+        inverse4 = std::max(inverse4, identityError4(w * simd_inverse(w)));
+        const simd::float3x3 m3(simd::float3{ random() + 5.f, random(), random() }, simd::float3{ random(), random() + 5.f, random() },
+                                simd::float3{ random(), random(), random() + 5.f });
+        const simd::float3x3 id3 = m3 * simd_inverse(m3);
+        for (int c = 0; c < 3; ++c)
+            for (int r = 0; r < 3; ++r)
+                inverse3 = std::max(inverse3, std::fabs(id3.columns[c][r] - (c == r ? 1.0 : 0.0)));
+    }
+    RMDL_CHECK(mul < 1e-5 && transpose == 0.0 && inverse4 < 1e-5 && inverse3 < 1e-5);
+}
+
+RMDL_TEST( vectorOperationsMatchDouble )
+{
+    Random random;
+    double cross = 0.0, normalize = 0.0, dot = 0.0;
+    for (int i = 0; i < 100000; ++i)
+    {
+        const simd::float3 u = random.float3(), v = random.float3();
+        const simd::float3 c = simd::cross(u, v);
+        cross = std::max(cross, std::fabs(c.x - ((double)u.y * v.z - (double)u.z * v.y))
+                              + std::fabs(c.y - ((double)u.z * v.x - (double)u.x * v.z))
+                              + std::fabs(c.z - ((double)u.x * v.y - (double)u.y * v.x)));
+        const double l = std::sqrt((double)u.x * u.x + (double)u.y * u.y + (double)u.z * u.z);
+        const simd::float3 n = simd::normalize(u);
+        normalize = std::max(normalize, std::fabs(n.x - u.x / l) + std::fabs(n.y - u.y / l) + std::fabs(n.z - u.z / l));
+        dot = std::max(dot, std::fabs(simd::dot(u, v) - ((double)u.x * v.x + (double)u.y * v.y + (double)u.z * v.z)));
+    }
+    RMDL_CHECK(cross < 1e-5 && normalize < 1e-6 && dot < 1e-5);
+}
+
+RMDL_TEST( paddingLaneStaysOutOfFloat3 )
+{
+    simd::float3 v;
+    std::memset((void*)&v, 0x7f, sizeof(v));
+    v.x = 1.f;
+    v.y = 2.f;
+    v.z = 3.f;
+    RMDL_CHECK(simd::dot(v, v) == 14.f);
+    RMDL_CHECK(simd::length_squared(v) == 14.f);
+}
+
+RMDL_TEST( quaternionsRotateLikeTheirMatrices )
+{
+    Random random;
+    double error = 0.0;
+    for (int i = 0; i < 10000; ++i)
+    {
+        const quaternion_float q = quaternion_normalize(quaternion(random(), random(), random(), random()));
+        const vector_float3 v = random.float3();
+        const vector_float3 a = quaternion_rotate_vector(q, v);
+        const vector_float4 b = simd::float4x4(matrix4x4_from_quaternion(q)) * simd::float4{ v.x, v.y, v.z, 0.f };
+        error = std::max(error, (double)(std::fabs(a.x - b.x) + std::fabs(a.y - b.y) + std::fabs(a.z - b.z)));
+    }
+    RMDL_CHECK(error < 1e-4);
+}
+
+RMDL_TEST( cameraInvertsItsViewProjection )
+{
+    RMDLCamera camera;
+    camera.initPerspectiveWithPosition(simd::float3{ 1.f, 2.f, 3.f }, simd::float3{ 0.f, 0.f, -1.f }, simd::float3{ 0.f, 1.f, 0.f },
+                                       1.f, 1.5f, 0.1f, 100.f);
+    const RMDLCameraUniforms uniforms = camera.uniforms();
+    RMDL_CHECK(identityError4(uniforms.viewProjectionMatrix * uniforms.invViewProjectionMatrix) < 1e-3);
+}
+
+RMDL_BENCH( matrixNanoseconds )
+{
+    Random random;
+    std::vector<simd::float4x4> matrices(4096);
+    for (simd::float4x4& m : matrices)
+        m = random.float4x4(5.f);
+    auto perMatrix = [&]( auto&& fn )
+    {
+        // Every element feeds the sum, so none of the work can be dropped.
+        simd::float4 sum = simd::float4{ 0.f, 0.f, 0.f, 0.f };
+        const double ms = rmdl_test::bestOf(5, [&]()
+        {
+            for (size_t k = 0; k < matrices.size(); ++k)
+            {
+                const simd::float4x4 m = fn(matrices[k], matrices[(k + 1) & 4095]);
+                sum += m.columns[0] + m.columns[1] + m.columns[2] + m.columns[3];
+            }
+        });
+        volatile float sink = sum.x + sum.y + sum.z + sum.w;
+        (void)sink;
+        return (ms * 1e6 / matrices.size());
+    };
+    const double mul = perMatrix([]( const simd::float4x4& a, const simd::float4x4& b ) { return (simd::float4x4(a * b)); });
+    const double inverse = perMatrix([]( const simd::float4x4& a, const simd::float4x4& ) { return (simd::float4x4(simd_inverse(a))); });
+    const double transpose = perMatrix([]( const simd::float4x4& a, const simd::float4x4& ) { return (simd::float4x4(simd::transpose(a))); });
+    std::printf("  4x4 multiply %.2f ns, inverse %.2f ns, transpose %.2f ns\n", mul, inverse, transpose);
+}
+
+RMDL_TEST_MAIN()
@@ -0,0 +1,274 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLRandomTests.cpp          +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 13:31:08      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+// Sources: RMDLRandom.cpp RMDLMathUtils.cpp
+
+#include "RMDLTest.hpp"
+#include "RMDLRandom.hpp"
+#include "RMDLMathUtils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <thread>
+
+using namespace rng;
+
+namespace
+{
+    double chiSquare( const std::vector<double>& observed, const std::vector<double>& expected )
+    {
+        double chi = 0.0;
+        for (size_t k = 0; k < observed.size(); ++k)
+            chi += (observed[k] - expected[k]) * (observed[k] - expected[k]) / expected[k];
+        return (chi);
+    }
+
+    /// Five standard deviations above the mean of chi-square with `df` degrees of freedom.
+    double chiSquareLimit( size_t df )
+    {
+        return (df + 5.0 * std::sqrt(2.0 * df));
+    }
+
+    double normalCdf( double x )
+    {
+        return (0.5 * std::erfc(-x / std::sqrt(2.0)));
+    }
+
+    /// 100 bins over [-5, 5) and the two tails, against the normal CDF; bins
+    /// expecting fewer than five are left out.
+    bool normalFits( const std::vector<float>& values, const char* what )
+    {
+        const int bins = 100;
+        std::vector<double> observed(bins + 2, 0.0), expected(bins + 2, 0.0);
+        double mean = 0.0, variance = 0.0;
+        for (float x : values)
+        {
+            mean += x;
+            variance += (double)x * x;
+            const int b = x < -5.f ? 0 : x >= 5.f ? bins + 1 : std::min(bins, 1 + (int)((x + 5.f) / 10.f * bins));
+            observed[b] += 1.0;
+        }
+        const double n = (double)values.size();
+        expected[0] = n * normalCdf(-5.0);
+        expected[bins + 1] = n * (1.0 - normalCdf(5.0));
+        for (int b = 0; b < bins; ++b)
+            expected[b + 1] = n * (normalCdf(-5.0 + 10.0 * (b + 1) / bins) - normalCdf(-5.0 + 10.0 * b / bins));
+        std::vector<double> o, e;
+        for (int b = 0; b < bins + 2; ++b)
+        {
+            if (expected[b] > 5.0)
+            {
+                o.push_back(observed[b]);
+                e.push_back(expected[b]);
+            }
+        }
+        mean /= n;
+        variance = variance / n - mean * mean;
+        const double chi = chiSquare(o, e);
+        const bool fits = chi < chiSquareLimit(o.size() - 1) && std::fabs(mean) < 0.002 && std::fabs(variance - 1.0) < 0.002;
+        if (!fits)
+            std::fprintf(stderr, "  %s: chi-square %.0f (df %zu), mean %.4f, variance %.4f\n", what, chi, o.size() - 1, mean, variance);
+        return (fits);
+    }
+
+    /// Every cell of the 2^a by 2^(m - a) grids holds exactly one point.
+    bool stratified( const std::vector<float>& points, uint32_t stride, uint32_t x, uint32_t y, int m )
+    {
+        const size_t n = (size_t)1 << m;
+        for (int a = 0; a <= m; ++a)
+        {
+            const int b = m - a;
+            std::vector<int> cells(n, 0);
+            for (size_t i = 0; i < n; ++i)
+                ++cells[((size_t)(points[i * stride + x] * (1 << a)) << b) | (size_t)(points[i * stride + y] * (1 << b))];
+            if (std::any_of(cells.begin(), cells.end(), []( int c ) { return (c != 1); }))
+                return (false);
+        }
+        return (true);
+    }
+}
+
+RMDL_TEST( philoxMatchesKnownAnswers )
+{
+    // Random123's kat_vectors for philox4x32_10.
+    struct Vector { uint32_t counter[4]; uint64_t key; uint32_t expected[4]; };
+    const Vector vectors[] = {
+        { { 0, 0, 0, 0 }, 0, { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 } },
+        { { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff }, 0xffffffffffffffffull, { 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd } },
+        { { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 }, 0x299f31d0a4093822ull, { 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 } },
+    };
+    for (const Vector& v : vectors)
+    {
+        uint32_t out[4];
+        philox4x32(v.key, v.counter, out);
+        RMDL_CHECK(std::memcmp(out, v.expected, sizeof(out)) == 0);
+    }
+}
+
+RMDL_TEST( fillMatchesNextWordForWord )
+{
+    // Misaligned starts and counts around the four-block batches.
+    for (uint32_t skip = 0; skip < 7; ++skip)
+    {
+        for (size_t count : { 0, 1, 31, 32, 33, 100, 1000 })
+        {
+            Stream a(42, 7), b(42, 7);
+            for (uint32_t k = 0; k < skip; ++k)
+            {
+                a.nextU32();
+                b.nextU32();
+            }
+            std::vector<uint32_t> words(count);
+            a.fillU32(words.data(), count);
+            size_t mismatches = 0;
+            for (size_t k = 0; k < count; ++k)
+                mismatches += words[k] != b.nextU32();
+            RMDL_CHECK(mismatches == 0 && a.nextU32() == b.nextU32());
+        }
+    }
+}
+
+RMDL_TEST( uniformPassesChiSquare )
+{
+    // 1024 bins, 10M samples from the batch path, then 256 bins from nextFloat.
+    const size_t count = 10000000;
+    std::vector<float> values(count);
+    Stream(1).fillUniform(values.data(), count);
+    std::vector<double> observed(1024, 0.0), expected(1024, count / 1024.0);
+    float lo = 1.f, hi = 0.f;
+    for (float x : values)
+    {
+        observed[(size_t)(x * 1024)] += 1.0;
+        lo = std::min(lo, x);
+        hi = std::max(hi, x);
+    }
+    RMDL_CHECK(lo >= 0.f && hi < 1.f);
+    RMDL_CHECK(chiSquare(observed, expected) < chiSquareLimit(1023));
+
+    Stream stream(2);
+    std::vector<double> scalar(256, 0.0), scalarExpected(256, 2000000 / 256.0);
+    for (int k = 0; k < 2000000; ++k)
+        scalar[(size_t)(stream.nextFloat() * 256)] += 1.0;
+    RMDL_CHECK(chiSquare(scalar, scalarExpected) < chiSquareLimit(255));
+}
+
+RMDL_TEST( normalPassesChiSquare )
+{
+    const size_t count = 10000000;
+    std::vector<float> values(count);
+    Stream scalar(3);
+    for (float& x : values)
+        x = scalar.normal();
+    RMDL_CHECK(normalFits(values, "normal"));
+    Stream(3).fillNormal(values.data(), count);
+    RMDL_CHECK(normalFits(values, "fillNormal"));
+}
+
+RMDL_TEST( splitStreamsShareNoWords )
+{
+    // 80000 words from 8 children: about 0.7 repeats by the birthday bound.
+    const Stream root(9);
+    std::set<uint32_t> seen;
+    size_t repeats = 0;
+    for (uint64_t index = 0; index < 8; ++index)
+    {
+        Stream child = root.split(index);
+        for (int k = 0; k < 10000; ++k)
+            repeats += !seen.insert(child.nextU32()).second;
+    }
+    RMDL_CHECK(repeats < 10);
+}
+
+RMDL_TEST( sobolIsStratified )
+{
+    const int m = 10;
+    const size_t n = (size_t)1 << m;
+    const Sobol sobol(8);
+    std::vector<float> points(n * 8);
+    sobol.fill(0, n, points.data());
+    for (uint32_t d = 0; d < 8; ++d)
+    {
+        std::vector<int> cells(n, 0);
+        for (size_t i = 0; i < n; ++i)
+            ++cells[(size_t)(points[i * 8 + d] * n)];
+        RMDL_CHECK(std::all_of(cells.begin(), cells.end(), []( int c ) { return (c == 1); }));
+    }
+    // The first two dimensions form a (0, m, 2)-net, scrambled or not.
+    RMDL_CHECK(stratified(points, 8, 0, 1, m));
+    const Sobol scrambled(2, 1234);
+    std::vector<float> shifted(n * 2);
+    scrambled.fill(0, n, shifted.data());
+    RMDL_CHECK(stratified(shifted, 2, 0, 1, m));
+
+    std::vector<float> one(8), batch(8 * 50);
+    sobol.fill(777, 50, batch.data());
+    size_t mismatches = 0;
+    for (uint32_t i = 0; i < 50; ++i)
+    {
+        sobol.sample(777 + i, one.data());
+        mismatches += std::memcmp(one.data(), &batch[i * 8], 8 * sizeof(float)) != 0;
+    }
+    RMDL_CHECK(mismatches == 0);
+}
+
+RMDL_TEST( haltonStartsWhereExpected )
+{
+    float x[4], y[4];
+    halton(1, 4, x, y);
+    RMDL_CHECK(x[0] == 0.5f && x[1] == 0.25f && x[2] == 0.75f && x[3] == 0.125f);
+    RMDL_CHECK(std::fabs(y[0] - 1.0 / 3.0) < 1e-7 && std::fabs(y[1] - 2.0 / 3.0) < 1e-7 && std::fabs(y[2] - 1.0 / 9.0) < 1e-7);
+}
+
+RMDL_TEST( threadStreamsAreIndependentAndReproducible )
+{
+    seedRand(5);
+    std::vector<std::vector<int32_t>> words(4, std::vector<int32_t>(1000));
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < words.size(); ++t)
+        threads.emplace_back([&words, t]() { for (int32_t& w : words[t]) w = randi(); });
+    for (std::thread& thread : threads)
+        thread.join();
+    for (size_t t = 1; t < words.size(); ++t)
+        RMDL_CHECK(words[t] != words[0]);
+
+    seedRand(5);
+    const int32_t first = randi();
+    seedRand(5);
+    RMDL_CHECK(randi() == first);
+    const vector_float3 v = generate_random_vector(-1.f, 2.f);
+    const float f = random_float(3.f, 4.f);
+    RMDL_CHECK(v.x >= -1.f && v.x < 2.f && f >= 3.f && f < 4.f);
+}
+
+RMDL_BENCH( nanosecondsPerValue )
+{
+    const size_t count = 1 << 22;
+    std::vector<uint32_t> words(count);
+    std::vector<float> floats(count), points(2 * count);
+    Stream stream(11);
+    const Sobol sobol(2);
+    uint32_t sum = 0;
+    float total = 0.f;
+    auto perValue = [&]( auto&& fn ) { return (rmdl_test::bestOf(5, fn) * 1e6 / count); };
+    const double fillU32 = perValue([&]() { stream.fillU32(words.data(), count); sum += words[count - 1]; });
+    const double fillUniform = perValue([&]() { stream.fillUniform(floats.data(), count); total += floats[count - 1]; });
+    const double fillNormal = perValue([&]() { stream.fillNormal(floats.data(), count); total += floats[count - 1]; });
+    const double nextU32 = perValue([&]() { for (size_t k = 0; k < count; ++k) sum += stream.nextU32(); });
+    const double normal = perValue([&]() { for (size_t k = 0; k < count; ++k) total += stream.normal(); });
+    const double libc = perValue([&]() { for (size_t k = 0; k < count; ++k) sum += (uint32_t)random(); });
+    const double sobol2 = perValue([&]() { sobol.fill(0, count, points.data()); total += points[count - 1]; });
+    volatile float sink = total + (float)sum;
+    (void)sink;
+    std::printf("  fillU32 %.2f ns (%.1f GB/s), fillUniform %.2f ns, fillNormal %.2f ns\n", fillU32, 4.0 / fillU32, fillUniform, fillNormal);
+    std::printf("  nextU32 %.2f ns, normal() %.2f ns, libc random() %.2f ns, Sobol 2D %.2f ns/point\n", nextU32, normal, libc, sobol2);
+}
+
+RMDL_TEST_MAIN()
@@ -0,0 +1,270 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLRenderGraphTests.cpp     +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 10:48:09      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+// Sources: RMDLRenderGraph.cpp RMDLAliasPlanner.cpp
+
+#include "RMDLTest.hpp"
+#include "RMDLRenderGraph.hpp"
+
+#include <algorithm>
+#include <random>
+#include <string>
+
+using namespace render_graph;
+
+namespace
+{
+    constexpr uint32_t kDepth32Float = 252;
+    constexpr uint32_t kRGBA8Unorm = 71;
+    constexpr uint32_t kRGBA16Float = 115;
+    const float kClear[4] = { 1.f, 0.f, 0.f, 0.f };
+
+    const CompiledPass* findPass( const RenderGraph& graph, const CompiledGraph& compiled, const std::string& name )
+    {
+        for (const CompiledPass& pass : compiled.passes)
+        {
+            if (graph.passName(pass.pass) == name)
+                return (&pass);
+        }
+        return (nullptr);
+    }
+
+    struct Declared
+    {
+        ResourceId  resource;
+        bool        write;
+        uint32_t    slice;
+    };
+
+    /// A random graph of `passCount` passes over `resourceCount` resources, the first
+    /// four imported, with the declarations kept to check the compiled result against.
+    RenderGraph randomGraph( std::mt19937& rng, uint32_t passCount, uint32_t resourceCount, std::vector<std::vector<Declared>>& declared )
+    {
+        const ResourceDesc descs[4] = { { 1920, 1080, 1, kRGBA8Unorm, 0 }, { 1920, 1080, 1, kRGBA16Float, 0 },
+                                        { 960, 540, 1, kRGBA16Float, 0 }, { 1024, 1024, 4, kDepth32Float, 0 } };
+        RenderGraph graph;
+        for (uint32_t r = 0; r < resourceCount; ++r)
+        {
+            if (r < 4)
+                graph.importResource("imported" + std::to_string(r), descs[r]);
+            else
+                graph.createTexture("t" + std::to_string(r), descs[rng() % 4]);
+        }
+        declared.assign(passCount, {});
+        for (uint32_t p = 0; p < passCount; ++p)
+        {
+            const PassKind kind = (PassKind)(rng() % 3);
+            const PassId pass = graph.addPass("p" + std::to_string(p), kind);
+            if (rng() % 20 == 0)
+                graph.setSideEffects(pass);
+            for (uint32_t i = 0, reads = rng() % 4; i < reads; ++i)
+            {
+                const ResourceId r = rng() % resourceCount;
+                graph.read(pass, r);
+                declared[p].push_back({ r, false, kAllSlices });
+            }
+            for (uint32_t i = 0, writes = 1 + rng() % 2; i < writes; ++i)
+            {
+                const ResourceId r = p < 10 || rng() % 3 == 0 ? rng() % resourceCount : 4 + (p * 3 + i) % (resourceCount - 4);
+                const uint32_t slice = graph.resourceDesc(r).arrayLength > 1 && rng() % 2 ? rng() % 4 : kAllSlices;
+                const Access access = kind != PassKind::Render ? Access::ShaderWrite
+                                    : graph.resourceDesc(r).pixelFormat == kDepth32Float ? Access::DepthAttachment : Access::ColorAttachment;
+                if (kind == PassKind::Render && rng() % 2)
+                    graph.clear(pass, r, access, kClear, slice);
+                else
+                    graph.write(pass, r, access, slice);
+                declared[p].push_back({ r, true, slice });
+            }
+        }
+        return (graph);
+    }
+
+    /// Counts ordering, barrier and aliasing violations of `compiled`.
+    int violations( const CompiledGraph& compiled, uint32_t resourceCount, const std::vector<std::vector<Declared>>& declared )
+    {
+        const int passCount = (int)declared.size();
+        std::vector<int> position(passCount, -1);
+        for (size_t i = 0; i < compiled.passes.size(); ++i)
+            position[compiled.passes[i].pass] = (int)i;
+
+        int bad = 0;
+        for (int a = 0; a < passCount; ++a)
+        {
+            for (int b = a + 1; b < passCount; ++b)
+            {
+                if (position[a] < 0 || position[b] < 0)
+                    continue;
+                bool conflict = false;
+                for (const Declared& x : declared[a])
+                {
+                    for (const Declared& y : declared[b])
+                    {
+                        const bool sameSlice = x.slice == kAllSlices || y.slice == kAllSlices || x.slice == y.slice;
+                        conflict |= x.resource == y.resource && (x.write || y.write) && (!(x.write && y.write) || sameSlice);
+                    }
+                }
+                if (!conflict)
+                    continue;
+                // Declaration order holds, with a barrier somewhere in between.
+                bool barrier = false;
+                for (int q = position[a] + 1; q <= position[b]; ++q)
+                    barrier |= compiled.passes[q].barrier.afterStages != 0;
+                bad += position[a] >= position[b] || !barrier;
+            }
+        }
+
+        // Resources sharing a physical texture have disjoint lifetimes.
+        std::vector<int> first(resourceCount, 1 << 30), last(resourceCount, -1);
+        for (int p = 0; p < passCount; ++p)
+        {
+            if (position[p] < 0)
+                continue;
+            for (const Declared& x : declared[p])
+            {
+                first[x.resource] = std::min(first[x.resource], position[p]);
+                last[x.resource] = std::max(last[x.resource], position[p]);
+            }
+        }
+        for (uint32_t r1 = 0; r1 < resourceCount; ++r1)
+        {
+            for (uint32_t r2 = r1 + 1; r2 < resourceCount; ++r2)
+            {
+                if (compiled.physicalOf[r1] != kAllSlices && compiled.physicalOf[r1] == compiled.physicalOf[r2])
+                    bad += !(last[r1] < first[r2] || last[r2] < first[r1]);
+            }
+        }
+        return (bad);
+    }
+}
+
+RMDL_TEST( theFrameGraphCompiles )
+{
+    RenderGraph graph;
+    const ResourceId shadow = graph.createTexture("Shadow", { 1024, 1024, 3, kDepth32Float, 0 });
+    const ResourceId gBuffer0 = graph.createTexture("GBuffer0", { 1920, 1080, 1, kRGBA8Unorm, 0 });
+    const ResourceId gBuffer1 = graph.createTexture("GBuffer1", { 1920, 1080, 1, kRGBA16Float, 0 });
+    const ResourceId depth = graph.createTexture("Depth", { 1920, 1080, 1, kDepth32Float, 0 });
+    const ResourceId lit = graph.createTexture("Lit", { 1920, 1080, 1, kRGBA16Float, 0 });
+    graph.markOutput(lit);
+    const ResourceId mouse = graph.importResource("Mouse", { 0, 0, 1, 0, 16 });
+    const ResourceId debug = graph.createTexture("Debug", { 1920, 1080, 1, kRGBA8Unorm, 0 });
+
+    for (uint32_t cascade = 0; cascade < 3; ++cascade)
+        graph.clear(graph.addPass("Shadow" + std::to_string(cascade), PassKind::Render), shadow, Access::DepthAttachment, kClear, cascade);
+    const PassId gBufferPass = graph.addPass("GBuffer", PassKind::Render);
+    graph.clear(gBufferPass, gBuffer0, Access::ColorAttachment, kClear);
+    graph.clear(gBufferPass, gBuffer1, Access::ColorAttachment, kClear);
+    graph.clear(gBufferPass, depth, Access::DepthAttachment, kClear);
+    const PassId debugPass = graph.addPass("Debug", PassKind::Render);
+    graph.read(debugPass, gBuffer0);
+    graph.write(debugPass, debug, Access::ColorAttachment);
+    const PassId mousePass = graph.addPass("Mouse", PassKind::Compute);
+    graph.read(mousePass, depth);
+    graph.write(mousePass, mouse, Access::ShaderWrite);
+    graph.setSideEffects(mousePass);
+    const PassId lightingPass = graph.addPass("Lighting", PassKind::Render);
+    for (ResourceId input : { gBuffer0, gBuffer1, depth, shadow })
+        graph.read(lightingPass, input);
+    graph.clear(lightingPass, lit, Access::ColorAttachment, kClear);
+
+    CompileOptions options;
+    options.maxBatches = 2;
+    const CompiledGraph compiled = graph.compile(options);
+    // Nothing reads Debug.
+    RMDL_CHECK(compiled.culledPasses == 1 && !findPass(graph, compiled, "Debug"));
+    RMDL_CHECK(compiled.physicalOf[debug] == kAllSlices && compiled.physicalOf[mouse] == kAllSlices);
+    RMDL_CHECK(compiled.passes.size() == 6 && compiled.batches.size() == 2);
+
+    const CompiledPass* pShadow = findPass(graph, compiled, "Shadow1");
+    RMDL_CHECK(pShadow && pShadow->attachments.size() == 1 && pShadow->attachments[0].slice == 1);
+    RMDL_CHECK(pShadow->attachments[0].load == LoadAction::Clear && pShadow->attachments[0].store == StoreAction::Store);
+    const CompiledPass* pLighting = findPass(graph, compiled, "Lighting");
+    RMDL_CHECK(pLighting && pLighting->level == 1 && pLighting->barrier.afterStages == StageFragment);
+    RMDL_CHECK(pLighting->barrier.beforeStages == (StageVertex | StageFragment));
+    const CompiledPass* pMouse = findPass(graph, compiled, "Mouse");
+    RMDL_CHECK(pMouse && pMouse->barrier.beforeStages == StageDispatch);
+}
+
+RMDL_TEST( disjointLifetimesShareMemory )
+{
+    RenderGraph graph;
+    const ResourceDesc desc = { 1024, 1024, 1, kRGBA16Float, 0 };
+    const ResourceId a = graph.createTexture("A", desc);
+    const ResourceId b = graph.createTexture("B", desc);
+    const ResourceId c = graph.createTexture("C", desc);
+    const ResourceId scratch = graph.createTexture("Scratch", desc);
+    const ResourceId out = graph.createTexture("Out", desc);
+    graph.markOutput(out);
+    // A -> B -> C -> Out, each pass also drawing into a scratch it never stores.
+    const ResourceId chain[4] = { a, b, c, out };
+    graph.clear(graph.addPass("p0", PassKind::Render), a, Access::ColorAttachment, kClear);
+    for (int i = 1; i < 4; ++i)
+    {
+        const PassId pass = graph.addPass("p" + std::to_string(i), PassKind::Render);
+        graph.read(pass, chain[i - 1]);
+        graph.clear(pass, chain[i], Access::ColorAttachment, kClear);
+        if (i == 2)
+            graph.clear(pass, scratch, Access::ColorAttachment, kClear);
+    }
+
+    CompileOptions options;
+    options.heapSizeAndAlign = []( const ResourceDesc& d, uint64_t& size, uint64_t& alignment ) {
+        size = (uint64_t)d.width * d.height * 8;
+        alignment = 65536;
+    };
+    const CompiledGraph compiled = graph.compile(options);
+    RMDL_CHECK(compiled.physicalOf[a] == compiled.physicalOf[c]);
+    RMDL_CHECK(compiled.physicalOf[a] != compiled.physicalOf[b]);
+    RMDL_CHECK(compiled.memoryless[compiled.physicalOf[scratch]]);
+    RMDL_CHECK(compiled.physical.size() < 5);
+    RMDL_CHECK(compiled.heapSize > 0 && compiled.heapSavedBytes > 0);
+}
+
+RMDL_TEST( randomGraphsKeepTheirDependencies )
+{
+    std::mt19937 rng(7);
+    for (int iteration = 0; iteration < 40; ++iteration)
+    {
+        std::vector<std::vector<Declared>> declared;
+        const RenderGraph graph = randomGraph(rng, 120, 60, declared);
+        CompileOptions options;
+        options.maxBatches = 4;
+        RMDL_CHECK(violations(graph.compile(options), 60, declared) == 0);
+    }
+}
+
+RMDL_BENCH( compileTwoHundredPasses )
+{
+    std::mt19937 rng(7);
+    double totalMs = 0.0, bestMs = 1e300;
+    size_t physical = 0, transient = 0;
+    int bad = 0;
+    const int graphs = 200;
+    for (int iteration = 0; iteration < graphs; ++iteration)
+    {
+        std::vector<std::vector<Declared>> declared;
+        const RenderGraph graph = randomGraph(rng, 200, 120, declared);
+        CompileOptions options;
+        options.maxBatches = 4;
+        CompiledGraph compiled;
+        const double ms = rmdl_test::milliseconds([&]() { compiled = graph.compile(options); });
+        totalMs += ms;
+        bestMs = std::min(bestMs, ms);
+        bad += violations(compiled, 120, declared);
+        physical += compiled.physical.size();
+        for (ResourceId r = 4; r < 120; ++r)
+            transient += compiled.physicalOf[r] != kAllSlices;
+    }
+    RMDL_CHECK(bad == 0);
+    std::printf("  200 passes, 120 resources: compile %.1f us mean, %.1f us best; %.2f physical per transient\n",
+                totalMs * 1e3 / graphs, bestMs * 1e3, (double)physical / transient);
+}
+
+RMDL_TEST_MAIN()
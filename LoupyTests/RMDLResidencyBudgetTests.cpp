@@ -0,0 +1,205 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLResidencyBudgetTests.cpp +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 11:41:08      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+// Sources: RMDLResidencyBudget.cpp
+
+#include "RMDLTest.hpp"
+#include "RMDLResidencyBudget.hpp"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <set>
+
+using namespace residency;
+
+namespace
+{
+    /// What the budget has told the residency set, and what the caller has done.
+    struct Model
+    {
+        std::set<AllocationId>              inSet;
+        std::map<AllocationId, Priority>    live;
+        std::map<AllocationId, uint64_t>    lastUse;
+        std::map<AllocationId, uint64_t>    removedAt;
+        std::map<AllocationId, uint64_t>    removedLastUse;     // 0 if never used
+    };
+
+    bool inFlight( uint64_t lastUse, uint32_t framesInFlight, uint64_t frame )
+    {
+        return (lastUse != 0 && lastUse + framesInFlight > frame);
+    }
+}
+
+RMDL_TEST( removedAllocationsWaitForTheFramesInFlight )
+{
+    ResidencyBudget budget(1000, 3);
+    budget.beginFrame(1);
+    const AllocationId id = budget.add(100);
+    budget.use(id);
+    RMDL_CHECK(budget.endFrame().added.size() == 1);
+
+    budget.beginFrame(2);
+    budget.remove(id);
+    RMDL_CHECK(!budget.isResident(id));
+    const Changes& changes = budget.endFrame();
+    RMDL_CHECK(changes.removed.empty() && changes.released.empty());
+    // The id is still taken.
+    RMDL_CHECK(budget.add(10) != id);
+
+    budget.beginFrame(4);
+    RMDL_CHECK(budget.endFrame().released.empty());
+    budget.beginFrame(5);
+    const Changes& later = budget.endFrame();
+    RMDL_CHECK(later.removed.size() == 1 && later.removed[0] == id);
+    RMDL_CHECK(later.released.size() == 1 && later.released[0] == id);
+    RMDL_CHECK(budget.add(10) == id);
+}
+
+RMDL_TEST( randomOperationsKeepTheInvariants )
+{
+    std::mt19937_64 rng(7);
+    for (int trial = 0; trial < 300; ++trial)
+    {
+        const uint32_t framesInFlight = 1 + trial % 3;
+        ResidencyBudget budget(1000 + rng() % 20000, framesInFlight, trial % 2 ? Policy::Priority : Policy::LeastRecentlyUsed);
+        Model model;
+        for (uint64_t frame = 1; frame < 200; ++frame)
+        {
+            budget.beginFrame(frame);
+            std::set<AllocationId> usedNow;
+            const int ops = (int)(rng() % 20);
+            for (int op = 0; op < ops; ++op)
+            {
+                const int kind = (int)(rng() % 10);
+                if (kind < 3 || model.live.empty())
+                {
+                    const Priority priority = rng() % 4 == 0 ? Priority::Pinned : (Priority)(rng() % 3);
+                    const AllocationId id = budget.add(1 + rng() % 500, priority);
+                    // Not handed out again before it is released.
+                    RMDL_CHECK(!model.live.count(id) && !model.removedAt.count(id) && !model.inSet.count(id));
+                    model.live[id] = priority;
+                    continue;
+                }
+                auto it = model.live.begin();
+                std::advance(it, rng() % model.live.size());
+                const AllocationId id = it->first;
+                if (kind < 8)
+                {
+                    budget.use(id);
+                    usedNow.insert(id);
+                    model.lastUse[id] = frame;
+                    RMDL_CHECK(budget.isResident(id));
+                }
+                else if (kind < 9)
+                {
+                    const Priority priority = (Priority)(rng() % 4);
+                    budget.setPriority(id, priority);
+                    model.live[id] = priority;
+                }
+                else
+                {
+                    budget.remove(id);
+                    model.removedAt[id] = frame;
+                    model.removedLastUse[id] = model.lastUse.count(id) ? model.lastUse[id] : 0;
+                    model.live.erase(id);
+                    model.lastUse.erase(id);
+                    usedNow.erase(id);
+                }
+            }
+
+            const Changes& changes = budget.endFrame();
+            for (AllocationId id : changes.added)
+                RMDL_CHECK(model.inSet.insert(id).second);
+            for (AllocationId id : changes.removed)
+            {
+                RMDL_CHECK(model.inSet.erase(id) == 1);
+                // Nothing leaves the set while a frame in flight may read it.
+                const uint64_t lastUse = model.lastUse.count(id) ? model.lastUse[id]
+                                       : (model.removedLastUse.count(id) ? model.removedLastUse[id] : 0);
+                RMDL_CHECK(!inFlight(lastUse, framesInFlight, frame));
+            }
+            for (AllocationId id : changes.released)
+            {
+                RMDL_CHECK(!model.inSet.count(id) && model.removedAt.count(id));
+                RMDL_CHECK(model.removedAt[id] + framesInFlight <= frame);
+                model.removedAt.erase(id);
+                model.removedLastUse.erase(id);
+            }
+            // Removed ones are released as soon as the frames in flight are done.
+            for (const auto& [id, removed] : model.removedAt)
+                RMDL_CHECK(removed + framesInFlight > frame);
+
+            uint32_t resident = 0;
+            bool evictable = false;
+            for (const auto& [id, priority] : model.live)
+            {
+                const bool isResident = budget.isResident(id);
+                const bool protect = model.lastUse.count(id) && inFlight(model.lastUse[id], framesInFlight, frame);
+                RMDL_CHECK(isResident == (model.inSet.count(id) == 1));
+                RMDL_CHECK(isResident || (priority != Priority::Pinned && !usedNow.count(id) && !protect));
+                resident += isResident;
+                evictable |= isResident && priority != Priority::Pinned && !protect;
+            }
+            RMDL_CHECK(model.inSet.size() >= resident);
+            // Over budget only when nothing left could be evicted.
+            RMDL_CHECK(budget.stats().overBudgetBytes == 0 || !evictable);
+        }
+    }
+}
+
+RMDL_BENCH( streamingWorkingSet )
+{
+    // 20000 assets of 64 KB to 2 MB under 1 GB; each frame uses 1500 around a
+    // center that drifts through them, and streams 20 out and 20 in.
+    for (Policy policy : { Policy::LeastRecentlyUsed, Policy::Priority })
+    {
+        std::mt19937_64 rng(7);
+        ResidencyBudget budget(1024ull << 20, 3, policy);
+        std::vector<AllocationId> ids;
+        for (int i = 0; i < 20000; ++i)
+            ids.push_back(budget.add((64ull << 10) << (rng() % 6), (Priority)(rng() % 3)));
+        std::normal_distribution<double> spread(0.0, 400.0);
+        uint64_t added = 0, removed = 0, released = 0;
+        double worst = 0.0;
+        const uint32_t frames = 2000;
+        const double total = rmdl_test::milliseconds([&]()
+        {
+            for (uint64_t frame = 1; frame <= frames; ++frame)
+            {
+                worst = std::max(worst, rmdl_test::milliseconds([&]()
+                {
+                    budget.beginFrame(frame);
+                    for (int k = 0; k < 20; ++k)
+                    {
+                        AllocationId& id = ids[rng() % ids.size()];
+                        budget.remove(id);
+                        id = budget.add((64ull << 10) << (rng() % 6), (Priority)(rng() % 3));
+                    }
+                    const size_t center = (frame * 7) % ids.size();
+                    for (int k = 0; k < 1500; ++k)
+                        budget.use(ids[(center + (size_t)(spread(rng) + 20000.0)) % ids.size()]);
+                    const Changes& changes = budget.endFrame();
+                    added += changes.added.size();
+                    removed += changes.removed.size();
+                    released += changes.released.size();
+                }));
+            }
+        });
+        const BudgetStats stats = budget.stats();
+        RMDL_CHECK(released == 20 * (frames - 3));
+        std::printf("  %-8s %.3f ms/frame (worst %.3f), %llu adds, %llu removes, %llu evictions, %llu reloads, peak %llu MB\n",
+                    policy == Policy::Priority ? "priority" : "lru", total / frames, worst,
+                    (unsigned long long)added, (unsigned long long)removed, (unsigned long long)stats.evictions,
+                    (unsigned long long)stats.reloads, (unsigned long long)(stats.peakResidentBytes >> 20));
+    }
+}
+
+RMDL_TEST_MAIN()
@@ -0,0 +1,242 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLSdfAtlasTests.cpp        +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 09:21:47      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+// Sources: RMDLSdfAtlas.cpp RMDLTextBatch.cpp RMDLParallel.cpp
+
+#include "RMDLTest.hpp"
+#include "RMDLSdfAtlas.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+
+using namespace text;
+
+namespace
+{
+    GlyphBitmap disc( uint32_t codepoint, uint32_t radius, uint32_t extraHeight = 0 )
+    {
+        GlyphBitmap g;
+        g.codepoint = codepoint;
+        g.width = 2 * radius;
+        g.height = 2 * radius + extraHeight;
+        g.coverage.resize((size_t)g.width * g.height);
+        for (uint32_t y = 0; y < g.height; ++y)
+        {
+            for (uint32_t x = 0; x < g.width; ++x)
+            {
+                const float dx = x + 0.5f - radius, dy = y + 0.5f - radius;
+                g.coverage[(size_t)y * g.width + x] = dx * dx + dy * dy < (float)(radius * radius) ? 255 : 0;
+            }
+        }
+        g.advance = 2.f * radius + 2.f;
+        g.bearingX = 1.f;
+        g.bearingY = (float)g.height;
+        return (g);
+    }
+
+    std::vector<GlyphBitmap> asciiDiscs( uint32_t scale = 1 )
+    {
+        std::vector<GlyphBitmap> glyphs;
+        for (uint32_t c = 33; c < 127; ++c)
+            glyphs.push_back(disc(c, (8 + c % 20) * scale, (c % 7) * scale));
+        GlyphBitmap space = {};
+        space.codepoint = ' ';
+        space.advance = 20.f;
+        glyphs.push_back(space);
+        return (glyphs);
+    }
+
+    /// A ring: a convex outline outside, a concave one inside.
+    struct Ring
+    {
+        float   cx, cy, outer, inner;
+
+        /// Exact signed distance in raster pixels, negative inside.
+        float   distance( float x, float y ) const
+        {
+            const float r = std::hypot(x - cx, y - cy);
+            return (std::fabs(r - 0.5f * (outer + inner)) - 0.5f * (outer - inner));
+        }
+
+        GlyphBitmap bitmap( uint32_t codepoint ) const
+        {
+            GlyphBitmap g = {};
+            g.codepoint = codepoint;
+            g.width = g.height = (uint32_t)std::ceil(2.f * cx);
+            g.coverage.resize((size_t)g.width * g.height);
+            for (uint32_t y = 0; y < g.height; ++y)
+                for (uint32_t x = 0; x < g.width; ++x)
+                    g.coverage[(size_t)y * g.width + x] = distance(x + 0.5f, y + 0.5f) < 0.f ? 255 : 0;
+            g.advance = (float)g.width;
+            g.bearingY = (float)g.height;
+            return (g);
+        }
+    };
+
+    /// Bilinear sample of one glyph's texels at (u, v) in texels from its
+    /// top-left corner, clamped to its rectangle; 0..1 like the shader sees it.
+    float sampleGlyph( const SdfAtlas& atlas, const SdfGlyph& glyph, float u, float v )
+    {
+        const float x = std::clamp(u - 0.5f, 0.f, glyph.width - 1.f), y = std::clamp(v - 0.5f, 0.f, glyph.height - 1.f);
+        const uint32_t x0 = (uint32_t)x, y0 = (uint32_t)y;
+        const uint32_t x1 = std::min<uint32_t>(x0 + 1, glyph.width - 1u), y1 = std::min<uint32_t>(y0 + 1, glyph.height - 1u);
+        const float fx = x - x0, fy = y - y0;
+        auto texel = [&]( uint32_t tx, uint32_t ty ) { return (atlas.pixels[(size_t)(glyph.y + ty) * atlas.width + glyph.x + tx] / 255.f); };
+        const float top = texel(x0, y0) + (texel(x1, y0) - texel(x0, y0)) * fx;
+        const float bottom = texel(x0, y1) + (texel(x1, y1) - texel(x0, y1)) * fx;
+        return (top + (bottom - top) * fy);
+    }
+
+    std::string tempPath( const char* name )
+    {
+        return ((std::filesystem::temp_directory_path() / name).string());
+    }
+}
+
+RMDL_TEST( signedDistanceMatchesADisc )
+{
+    const uint32_t radius = 21, spread = 8;
+    std::vector<float> distance;
+    signedDistance(disc('a', radius), spread, distance);
+    const uint32_t size = 2 * radius + 2 * spread;
+    float maxError = 0.f;
+    for (uint32_t y = 0; y < size; ++y)
+    {
+        for (uint32_t x = 0; x < size; ++x)
+        {
+            const float dx = x + 0.5f - spread - radius, dy = y + 0.5f - spread - radius;
+            const float exact = std::sqrt(dx * dx + dy * dy) - radius;
+            if (std::fabs(exact) < 6.f)
+                maxError = std::max(maxError, std::fabs(exact - distance[(size_t)y * size + x]));
+        }
+    }
+    // Coverage is binary, so the edge is only known to half a pixel.
+    RMDL_CHECK(maxError < 1.f);
+}
+
+RMDL_TEST( edgesReconstructAcrossScales )
+{
+    // The ring drawn from the atlas at 1x, 2x and 4x its texel size,
+    // thresholded at the outline value like the text shader does: wherever
+    // inside and outside disagree with the exact shape, the exact outline
+    // must be within half an atlas texel, however far the glyph is scaled.
+    const Ring ring = { 48.f, 48.f, 40.f, 17.f };
+    for (uint32_t downsample : { 1u, 2u, 4u })
+    {
+        SdfAtlasDesc desc;
+        desc.downsample = downsample;
+        const SdfAtlas atlas = buildSdfAtlas({ ring.bitmap('o') }, desc);
+        RMDL_CHECK(atlas.glyphs.size() == 1);
+        const SdfGlyph& glyph = atlas.glyphs[0];
+
+        float worst = 0.f;
+        for (uint32_t scale : { 1u, 2u, 4u })
+        {
+            for (uint32_t py = 0; py < glyph.height * scale; ++py)
+            {
+                for (uint32_t px = 0; px < glyph.width * scale; ++px)
+                {
+                    const float u = (px + 0.5f) / scale, v = (py + 0.5f) / scale;
+                    const float exact = ring.distance(u * downsample - desc.spread, v * downsample - desc.spread);
+                    const bool inside = sampleGlyph(atlas, glyph, u, v) > 0.5f;
+                    if (inside != (exact < 0.f))
+                        worst = std::max(worst, std::fabs(exact) / downsample);
+                }
+            }
+        }
+        RMDL_CHECK(worst < 0.5f);
+    }
+}
+
+RMDL_TEST( atlasGlyphsDoNotOverlap )
+{
+    const SdfAtlas atlas = buildSdfAtlas(asciiDiscs(), SdfAtlasDesc());
+    RMDL_CHECK(atlas.glyphs.size() == 95 && atlas.dropped.empty());
+    for (size_t i = 0; i < atlas.glyphs.size(); ++i)
+    {
+        const SdfGlyph& p = atlas.glyphs[i];
+        RMDL_CHECK(p.x + p.width <= atlas.width && p.y + p.height <= atlas.height);
+        for (size_t j = i + 1; j < atlas.glyphs.size(); ++j)
+        {
+            const SdfGlyph& q = atlas.glyphs[j];
+            if (p.width && q.width)
+                RMDL_CHECK(!(p.x < q.x + q.width && q.x < p.x + p.width && p.y < q.y + q.height && q.y < p.y + p.height));
+        }
+    }
+    const GlyphTable table = makeGlyphTable(atlas);
+    RMDL_CHECK(table.glyph(' ') && table.glyph(' ')->width == 0.f);
+}
+
+RMDL_TEST( glyphsThatDoNotFitAreReported )
+{
+    SdfAtlasDesc desc;
+    desc.maxSize = 64;
+    const SdfAtlas atlas = buildSdfAtlas(asciiDiscs(), desc);
+    RMDL_CHECK(!atlas.dropped.empty());
+    RMDL_CHECK(atlas.glyphs.size() + atlas.dropped.size() == 95);
+}
+
+RMDL_TEST( cacheFileRoundTrips )
+{
+    const SdfAtlasDesc desc;
+    const SdfAtlas atlas = buildSdfAtlas(asciiDiscs(), desc);
+    const uint64_t key = sdfAtlasKey("Disc", { 33, 34 }, desc);
+    const std::string path = tempPath("loupy-test.rsdf");
+    RMDL_CHECK(saveSdfAtlas(path, key, atlas));
+
+    SdfAtlas loaded;
+    RMDL_CHECK(loadSdfAtlas(path, key, loaded));
+    RMDL_CHECK(loaded.pixels == atlas.pixels && loaded.glyphs.size() == atlas.glyphs.size());
+    RMDL_CHECK(!loadSdfAtlas(path, key + 1, loaded));
+    std::filesystem::remove(path);
+}
+
+RMDL_TEST( damagedCacheFilesAreRejected )
+{
+    const SdfAtlasDesc desc;
+    const SdfAtlas atlas = buildSdfAtlas(asciiDiscs(), desc);
+    const uint64_t key = sdfAtlasKey("Disc", { 33 }, desc);
+    const std::string path = tempPath("loupy-test-damaged.rsdf");
+    RMDL_CHECK(saveSdfAtlas(path, key, atlas));
+    const uint64_t size = std::filesystem::file_size(path);
+
+    // Truncated, then a glyph count no file could hold.
+    std::filesystem::resize_file(path, size - 1);
+    SdfAtlas loaded;
+    RMDL_CHECK(!loadSdfAtlas(path, key, loaded));
+    RMDL_CHECK(saveSdfAtlas(path, key, atlas));
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        const uint32_t count = 0x7fffffff;
+        file.seekp(36);
+        file.write((const char*)&count, sizeof(count));
+    }
+    RMDL_CHECK(!loadSdfAtlas(path, key, loaded));
+    RMDL_CHECK(loaded.glyphs.empty());
+    std::filesystem::remove(path);
+}
+
+RMDL_BENCH( buildAtlas )
+{
+    const std::vector<GlyphBitmap> small = asciiDiscs();
+    const double smallMs = rmdl_test::bestOf(5, [&]() { buildSdfAtlas(small, SdfAtlasDesc()); });
+
+    SdfAtlasDesc desc;
+    desc.rasterSize = 256.f;
+    desc.spread = 32;
+    desc.downsample = 8;
+    const std::vector<GlyphBitmap> large = asciiDiscs(4);
+    const double largeMs = rmdl_test::bestOf(3, [&]() { buildSdfAtlas(large, desc); });
+    std::printf("  95 glyphs: %.2f ms at 64 px, %.2f ms at 256 px\n", smallMs, largeMs);
+}
+
+RMDL_TEST_MAIN()
@@ -0,0 +1,155 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLShaderCacheTests.cpp     +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 10:16:23      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+// Sources: RMDLShaderCache.cpp RMDLParallel.cpp
+
+#include "RMDLTest.hpp"
+#include "RMDLShaderCache.hpp"
+
+#include <atomic>
+#include <filesystem>
+#include <thread>
+
+using namespace shader_cache;
+
+namespace
+{
+    std::string storeDirectory( const char* name )
+    {
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+        std::filesystem::remove_all(path);
+        std::filesystem::create_directories(path);
+        return (path.string());
+    }
+
+    /// Artifact = source followed by the options, counted.
+    Compiler countingCompiler( std::atomic<int>& calls )
+    {
+        return [&calls]( const ShaderSource& source, std::vector<uint8_t>& artifact ) {
+            ++calls;
+            artifact.assign(source.source.begin(), source.source.end());
+            artifact.insert(artifact.end(), source.options.begin(), source.options.end());
+            return (true);
+        };
+    }
+
+    bool holds( const std::shared_ptr<const MappedFile>& pFile, const std::string& bytes )
+    {
+        return (pFile && pFile->size() == bytes.size() && std::memcmp(pFile->data(), bytes.data(), bytes.size()) == 0);
+    }
+
+    std::vector<ShaderSource> libraries( int count, size_t size )
+    {
+        std::vector<ShaderSource> sources;
+        for (int i = 0; i < count; ++i)
+            sources.push_back({ "lib" + std::to_string(i), std::string(size + i, (char)('a' + i)), "-O2" });
+        return (sources);
+    }
+}
+
+RMDL_TEST( warmStartsMapWithoutCompiling )
+{
+    const std::string directory = storeDirectory("loupy-test-store");
+    const std::vector<ShaderSource> sources = libraries(4, 1000);
+    std::atomic<int> calls{ 0 };
+    {
+        ArtifactStore store(directory, countingCompiler(calls), "v1");
+        for (const ShaderSource& source : sources)
+            RMDL_CHECK(holds(store.get(source), source.source + source.options));
+        RMDL_CHECK(store.stats().cold == 4 && calls == 4);
+    }
+    {
+        ArtifactStore store(directory, countingCompiler(calls), "v1");
+        store.prefetch();
+        for (const ShaderSource& source : sources)
+            RMDL_CHECK(holds(store.get(source), source.source + source.options));
+        RMDL_CHECK(holds(store.get("lib2"), sources[2].source + "-O2"));
+        RMDL_CHECK(store.stats().warm == 5 && calls == 4);
+
+        ShaderSource changed = sources[0];
+        changed.options = "-O3";
+        RMDL_CHECK(holds(store.get(changed), changed.source + "-O3"));
+        RMDL_CHECK(store.stats().cold == 1);
+    }
+    {
+        ArtifactStore store(directory, countingCompiler(calls), "v2");
+        RMDL_CHECK(store.get("lib2") == nullptr);
+    }
+    std::filesystem::remove_all(directory);
+}
+
+RMDL_TEST( concurrentCompilesOfOneSourceKeepTheirOptions )
+{
+    // Same source, different options, all in flight at once: each one must get
+    // its own scratch files.
+    const Compiler compiler = toolCompiler("sleep 0.05; (cat {in}; printf %s '{options}') > {out}", ".metal");
+    std::vector<std::thread> threads;
+    std::vector<std::vector<uint8_t>> artifacts(8);
+    std::vector<int> ok(8, 0);
+    for (int i = 0; i < 8; ++i)
+    {
+        threads.emplace_back([&, i]() {
+            const ShaderSource source = { "lib", "kernel void f() {}", "-DVARIANT=" + std::to_string(i % 4) };
+            ok[i] = compiler(source, artifacts[i]);
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+    for (int i = 0; i < 8; ++i)
+    {
+        const std::string expected = "kernel void f() {}-DVARIANT=" + std::to_string(i % 4);
+        RMDL_CHECK(ok[i] && std::string(artifacts[i].begin(), artifacts[i].end()) == expected);
+    }
+}
+
+RMDL_TEST( concurrentGetsOfOneNewKeyAllSucceed )
+{
+    const std::string directory = storeDirectory("loupy-test-store-race");
+    std::atomic<int> calls{ 0 };
+    ArtifactStore store(directory, countingCompiler(calls), "v1");
+    const ShaderSource source = { "lib", std::string(1 << 20, 'x'), "-O2" };
+    std::vector<std::thread> threads;
+    std::atomic<int> good{ 0 };
+    for (int i = 0; i < 8; ++i)
+        threads.emplace_back([&]() { good += holds(store.get(source), source.source + source.options); });
+    for (std::thread& thread : threads)
+        thread.join();
+    RMDL_CHECK(good == 8 && store.stats().failed == 0);
+    // Only the artifact itself is left: no scratch file lost a rename race.
+    for (const auto& entry : std::filesystem::directory_iterator(directory))
+        RMDL_CHECK(entry.path().extension() != ".tmp");
+    std::filesystem::remove_all(directory);
+}
+
+RMDL_BENCH( coldAndWarmStarts )
+{
+    const std::string directory = storeDirectory("loupy-bench-store");
+    const std::vector<ShaderSource> sources = libraries(12, 200000);
+    // Stands in for a 50 ms compiler.
+    const Compiler compiler = toolCompiler("sleep 0.05; cp {in} {out}", ".metal");
+    for (int run = 0; run < 3; ++run)
+    {
+        ArtifactStore store(directory, compiler, "metal-32000");
+        const double ms = rmdl_test::milliseconds([&]() {
+            store.prefetch();
+            for (const ShaderSource& source : sources)
+                RMDL_CHECK(store.get(source) != nullptr);
+        });
+        const StoreStats stats = store.stats();
+        std::printf("  %s start, 12 libraries of 200 KB: %.1f ms (%u compiled, %u mapped, %.2f ms mapping)\n",
+                    run == 0 ? "cold" : "warm", ms, stats.cold, stats.warm, stats.mapMs);
+    }
+    std::vector<uint8_t> big(64 << 20, 7);
+    const double hashMs = rmdl_test::bestOf(3, [&]() { RMDL_CHECK(hashBytes(big.data(), big.size()) != 0); });
+    std::printf("  hashBytes: %.2f GB/s\n", 64.0 / 1024.0 / (hashMs / 1e3));
+    std::filesystem::remove_all(directory);
+}
+
+RMDL_TEST_MAIN()
@@ -0,0 +1,179 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLSimulationClockTests.cpp +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 12:10:52      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+// Sources: RMDLSimulationClock.cpp RMDLCameraSimulation.cpp RMDLParallel.cpp
+
+#include "RMDLTest.hpp"
+#include "RMDLSimulationClock.hpp"
+#include "RMDLCameraSimulation.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <thread>
+
+using namespace simulation;
+
+namespace
+{
+    using CameraLoop = FixedStepLoop<CameraState>;
+
+    std::unique_ptr<CameraLoop> cameraLoop( CameraController& controller )
+    {
+        return (std::make_unique<CameraLoop>(ClockConfig(), CameraState(),
+                                             [&controller]( CameraState& state, uint64_t index, double dt ) { controller.step(state, index, dt); },
+                                             interpolate));
+    }
+
+    /// A live session: random frame times, a command on every third frame.
+    std::vector<CameraCommand> recordSession( uint64_t& steps, CameraState& final )
+    {
+        std::mt19937 rng(3);
+        std::uniform_real_distribution<double> frameTime(0.004, 0.05);
+        std::uniform_real_distribution<float> amount(-0.1f, 0.1f);
+        std::vector<CameraCommand> log;
+        CameraController live;
+        live.record(&log);
+        std::unique_ptr<CameraLoop> pLoop = cameraLoop(live);
+        for (int frame = 0; frame < 3000; ++frame)
+        {
+            const double dt = frameTime(rng);
+            if (rng() % 3 == 0)
+            {
+                CameraCommand command;
+                command.step = pLoop->nextStep();
+                command.move[rng() % 3] = amount(rng);
+                command.yaw = amount(rng) * 0.2f;
+                command.pitch = amount(rng) * 0.2f;
+                live.queue(command);
+            }
+            pLoop->advance(dt);
+        }
+        steps = pLoop->nextStep();
+        final = pLoop->current();
+        return (log);
+    }
+}
+
+RMDL_TEST( clockDoesNotDrift )
+{
+    FixedStepClock clock;
+    for (int frame = 0; frame < 60 * 3600; ++frame)
+        clock.advance(1.0 / 60.0);
+    RMDL_CHECK(clock.nextStep() == 120ull * 3600);
+    RMDL_CHECK(clock.droppedTime() == 0.0);
+}
+
+RMDL_TEST( longFramesAreClamped )
+{
+    FixedStepClock clock;
+    const StepPlan plan = clock.advance(5.0);
+    RMDL_CHECK(plan.steps == ClockConfig().maxStepsPerFrame);
+    RMDL_CHECK(plan.dropped > 4.0 && clock.clampedFrames() == 1);
+}
+
+RMDL_TEST( replayMatchesBitForBit )
+{
+    uint64_t steps = 0;
+    CameraState recorded;
+    const std::vector<CameraCommand> log = recordSession(steps, recorded);
+    parallel::ThreadPool pool(2);
+    for (bool async : { false, true })
+    {
+        // Fixed display rates, then a random one.
+        for (double rate : { 1.0 / 60.0, 1.0 / 120.0, 1.0 / 144.0, 1.0 / 30.0, 0.0 })
+        {
+            CameraController replay;
+            replay.replay(log);
+            std::unique_ptr<CameraLoop> pLoop = cameraLoop(replay);
+            std::mt19937 rng(9);
+            std::uniform_real_distribution<double> frameTime(0.001, 0.1);
+            while (pLoop->nextStep() < steps)
+            {
+                // Stop on the recorded step, not past it.
+                const double remaining = (double)(steps - pLoop->nextStep()) * pLoop->clock().step();
+                const double dt = std::min(rate > 0.0 ? rate : frameTime(rng), remaining + 1e-12);
+                if (async)
+                    pLoop->advanceAsync(dt, pool);
+                else
+                    pLoop->advance(dt);
+            }
+            const CameraState& state = pLoop->current();
+            RMDL_CHECK(pLoop->nextStep() == steps);
+            RMDL_CHECK(std::memcmp(&state, &recorded, sizeof(state)) == 0);
+        }
+    }
+}
+
+RMDL_TEST( destroyingWaitsForPendingSteps )
+{
+    parallel::ThreadPool pool(1);
+    std::atomic<uint32_t> steps(0);
+    {
+        CameraLoop loop(ClockConfig(), CameraState(), [&steps]( CameraState& state, uint64_t, double )
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            state.position[0] += 1.f;
+            ++steps;
+        }, interpolate);
+        loop.advanceAsync(1.0 / 30.0, pool);
+    }
+    RMDL_CHECK(steps == 4);
+}
+
+RMDL_BENCH( displayedSpeedJitter )
+{
+    // Constant motion of 1 unit/s, shown at several display rates: the speed
+    // seen from frame to frame with the latest step and with interpolation.
+    for (double hz : { 60.0, 120.0, 144.0, 0.0 })
+    {
+        for (bool interpolated : { false, true })
+        {
+            CameraController controller(1e-4f);
+            std::unique_ptr<CameraLoop> pLoop = cameraLoop(controller);
+            std::mt19937 rng(5);
+            std::uniform_real_distribution<double> frameTime(1.0 / 144.0, 1.0 / 40.0);
+            std::vector<double> speeds;
+            uint64_t queued = 0;
+            double previous = 0.0;
+            for (int frame = 0; frame < 2000; ++frame)
+            {
+                const double dt = hz > 0.0 ? 1.0 / hz : frameTime(rng);
+                for (; queued < pLoop->nextStep() + 20; ++queued)
+                {
+                    CameraCommand command;
+                    command.step = queued;
+                    command.move[2] = -1.f / 120.f;
+                    controller.queue(command);
+                }
+                pLoop->advance(dt);
+                const double z = -(interpolated ? pLoop->interpolated() : pLoop->current()).position[2];
+                if (frame > 10)
+                    speeds.push_back((z - previous) / dt);
+                previous = z;
+            }
+            double mean = 0.0, variance = 0.0;
+            for (double speed : speeds)
+                mean += speed;
+            mean /= speeds.size();
+            for (double speed : speeds)
+                variance += (speed - mean) * (speed - mean);
+            const double deviation = std::sqrt(variance / speeds.size());
+            char rate[16];
+            std::snprintf(rate, sizeof(rate), hz > 0.0 ? "%.0f Hz" : "jittered", hz);
+            std::printf("  %-8s %-12s speed %.3f u/s, stddev %.3f (%.1f%%)\n",
+                        rate, interpolated ? "interpolated" : "latest step", mean, deviation, 100.0 * deviation / mean);
+        }
+    }
+}
+
+RMDL_TEST_MAIN()
@@ -0,0 +1,270 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLSpatialHashTests.cpp     +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 14:08:17      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+// Sources: RMDLSpatialHash.cpp RMDLParallel.cpp RMDLRadixSort.cpp
+
+#include "RMDLTest.hpp"
+#include "RMDLSpatialHash.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace spatial;
+
+namespace
+{
+    struct Random
+    {
+        std::mt19937    engine;
+
+        explicit Random( uint32_t seed ) : engine(seed) {}
+
+        float           operator()( float min, float max )  { return (std::uniform_real_distribution<float>(min, max)(engine)); }
+        simd::float3    point( float extent )               { return (simd::float3{ (*this)(-extent, extent), (*this)(-extent, extent), (*this)(-extent, extent) }); }
+        /// Mostly small boxes; one in a hundred eight times larger.
+        Aabb            box( float extent, float maxHalfSize )
+        {
+            const simd::float3 c = point(extent);
+            const float scale = (*this)(0.f, 1.f) < 0.01f ? 8.f : 1.f;
+            const simd::float3 h = simd::float3{ (*this)(0.f, maxHalfSize), (*this)(0.f, maxHalfSize), (*this)(0.f, maxHalfSize) } * scale;
+            return (Aabb{ c - h, c + h });
+        }
+    };
+
+    /// Radius, box and k-nearest queries, each against a loop over every
+    /// object; returns how many differ.
+    int bruteForceMismatches( const SpatialHash& grid, const std::vector<Aabb>& boxes, Random& random, int queries, float extent )
+    {
+        int mismatches = 0;
+        std::vector<uint32_t> got, want;
+        std::vector<Neighbor> nearest, all;
+        for (int q = 0; q < queries; ++q)
+        {
+            // Some queries cover the whole world, some reach past it.
+            const simd::float3 center = random.point(extent * 1.2f);
+            const float radius = q % 10 == 0 ? random(0.f, 3.f * extent) : random(0.f, extent * 0.3f);
+            got.clear();
+            want.clear();
+            grid.queryRadius(center, radius, got);
+            for (uint32_t i = 0; i < boxes.size(); ++i)
+                if (overlapsSphere(boxes[i], center, radius))
+                    want.push_back(i);
+            std::sort(got.begin(), got.end());
+            mismatches += got != want;
+
+            const Aabb box = random.box(extent * 1.2f, extent * 0.2f);
+            got.clear();
+            want.clear();
+            grid.queryAabb(box, got);
+            for (uint32_t i = 0; i < boxes.size(); ++i)
+                if (overlaps(boxes[i], box))
+                    want.push_back(i);
+            std::sort(got.begin(), got.end());
+            mismatches += got != want;
+
+            // More neighbours than objects now and then.
+            const uint32_t k = q % 17 == 0 ? (uint32_t)boxes.size() + 3 : 1 + q % 20;
+            grid.queryNearest(center, k, nearest);
+            all.clear();
+            for (uint32_t i = 0; i < boxes.size(); ++i)
+                all.push_back(Neighbor{ i, distanceSquared(boxes[i], center) });
+            std::sort(all.begin(), all.end(), []( const Neighbor& a, const Neighbor& b )
+            {
+                return (a.distanceSquared < b.distanceSquared || (a.distanceSquared == b.distanceSquared && a.object < b.object));
+            });
+            all.resize(std::min<size_t>(k, all.size()));
+            bool same = nearest.size() == all.size();
+            for (size_t i = 0; same && i < all.size(); ++i)
+                same = nearest[i].object == all[i].object && nearest[i].distanceSquared == all[i].distanceSquared;
+            mismatches += !same;
+        }
+        return (mismatches);
+    }
+}
+
+RMDL_TEST( queriesMatchBruteForce )
+{
+    // Cells smaller than, about as large as, and much larger than the boxes.
+    for (float cellSize : { 0.5f, 2.f, 10.f })
+    {
+        Random random(7);
+        std::vector<Aabb> boxes(5000);
+        for (Aabb& box : boxes)
+            box = random.box(50.f, 1.f);
+        SpatialHash grid(cellSize);
+        grid.build(boxes.data(), boxes.size());
+        RMDL_CHECK(bruteForceMismatches(grid, boxes, random, 300, 50.f) == 0);
+    }
+}
+
+RMDL_TEST( incrementalUpdatesStayExact )
+{
+    // Mostly small moves, some jumps out of the world, with queries between.
+    for (float cellSize : { 0.5f, 2.f, 10.f })
+    {
+        Random random(8);
+        std::vector<Aabb> boxes(5000);
+        for (Aabb& box : boxes)
+            box = random.box(50.f, 1.f);
+        SpatialHash grid(cellSize);
+        grid.build(boxes.data(), boxes.size());
+        int mismatches = 0;
+        size_t moved = 0;
+        for (int frame = 0; frame < 20; ++frame)
+        {
+            for (int j = 0; j < 300; ++j)
+            {
+                const uint32_t i = random.engine() % boxes.size();
+                if (j % 10 == 0)
+                {
+                    boxes[i] = random.box(60.f, 1.f);
+                }
+                else
+                {
+                    const float d = random(-0.2f, 0.2f);
+                    boxes[i].min += simd::float3{ d, d, d };
+                    boxes[i].max += simd::float3{ d, d, d };
+                }
+                grid.update(i, boxes[i]);
+            }
+            moved = std::max(moved, grid.stats().movedCount);
+            mismatches += bruteForceMismatches(grid, boxes, random, 30, 50.f);
+        }
+        RMDL_CHECK(mismatches == 0 && moved > 0);
+    }
+}
+
+RMDL_TEST( fuzzAgainstBruteForce )
+{
+    // Random sizes, world extents and cell sizes; small populations so that
+    // near-empty and crowded grids both come up.
+    Random random(9);
+    int mismatches = 0;
+    for (int round = 0; round < 60; ++round)
+    {
+        const float extent = random(1.f, 200.f);
+        const float cellSize = random(0.1f, 20.f);
+        std::vector<Aabb> boxes(1 + random.engine() % 2000);
+        for (Aabb& box : boxes)
+            box = random.box(extent, random(0.f, extent * 0.1f));
+        SpatialHash grid(cellSize);
+        grid.build(boxes.data(), boxes.size());
+        mismatches += bruteForceMismatches(grid, boxes, random, 20, extent);
+        for (int j = 0; j < 200; ++j)
+        {
+            const uint32_t i = random.engine() % boxes.size();
+            boxes[i] = random.box(extent, random(0.f, extent * 0.1f));
+            grid.update(i, boxes[i]);
+        }
+        mismatches += bruteForceMismatches(grid, boxes, random, 20, extent);
+    }
+    RMDL_CHECK(mismatches == 0);
+}
+
+RMDL_TEST( degenerateWorlds )
+{
+    // Everything at one far point, one box spanning the whole axis.
+    Random random(10);
+    std::vector<Aabb> boxes(1000, Aabb{ simd::float3{ 1e9f, 1e9f, 1e9f }, simd::float3{ 1e9f, 1e9f, 1e9f } });
+    boxes[3] = Aabb{ simd::float3{ -1e30f, 0.f, 0.f }, simd::float3{ 1e30f, 1.f, 1.f } };
+    SpatialHash grid(1.f);
+    grid.build(boxes.data(), boxes.size());
+    RMDL_CHECK(grid.stats().largeCount == 1);
+    RMDL_CHECK(bruteForceMismatches(grid, boxes, random, 50, 10.f) == 0);
+
+    SpatialHash empty(1.f);
+    empty.build(nullptr, 0);
+    std::vector<uint32_t> objects;
+    std::vector<Neighbor> nearest;
+    empty.queryRadius(simd::float3{ 0.f, 0.f, 0.f }, 5.f, objects);
+    empty.queryNearest(simd::float3{ 0.f, 0.f, 0.f }, 3, nearest);
+    RMDL_CHECK(objects.empty() && nearest.empty());
+}
+
+RMDL_BENCH( hundredThousandToMillionObjects )
+{
+    for (size_t count : { 100000, 300000, 1000000 })
+    {
+        // About one object per 8 cubic units, whatever the count.
+        const float extent = std::cbrt((float)count) * 2.f;
+        Random random(11);
+        std::vector<Aabb> boxes(count);
+        for (Aabb& box : boxes)
+            box = random.box(extent, 0.5f);
+        SpatialHash grid(2.f);
+        const double build = rmdl_test::milliseconds([&]() { grid.build(boxes.data(), count); });
+        const double rebuild = rmdl_test::bestOf(3, [&]() { grid.rebuild(); });
+
+        const int queries = 20000;
+        std::vector<uint32_t> objects;
+        std::vector<Neighbor> nearest;
+        size_t found = 0;
+        auto measure = [&]()
+        {
+            Random points(12);
+            const double radius = rmdl_test::milliseconds([&]()
+            {
+                for (int q = 0; q < queries; ++q)
+                {
+                    objects.clear();
+                    grid.queryRadius(points.point(extent), 3.f, objects);
+                    found += objects.size();
+                }
+            });
+            const double knn = rmdl_test::milliseconds([&]()
+            {
+                for (int q = 0; q < queries; ++q)
+                {
+                    grid.queryNearest(points.point(extent), 8, nearest);
+                    found += nearest.size();
+                }
+            });
+            return (std::make_pair(radius * 1e3 / queries, knn * 1e3 / queries));
+        };
+        const auto clean = measure();
+
+        // A frame where everything moves a little and one in fifty jumps.
+        const double update = rmdl_test::milliseconds([&]()
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (i % 50 == 0)
+                {
+                    boxes[i] = random.box(extent, 0.5f);
+                }
+                else
+                {
+                    boxes[i].min += simd::float3{ 0.01f, 0.01f, 0.01f };
+                    boxes[i].max += simd::float3{ 0.01f, 0.01f, 0.01f };
+                }
+                grid.update((uint32_t)i, boxes[i]);
+            }
+        });
+        const auto moved = measure();
+
+        // One brute-force radius query, for scale.
+        const simd::float3 center = random.point(extent);
+        const double brute = rmdl_test::bestOf(3, [&]()
+        {
+            objects.clear();
+            for (uint32_t i = 0; i < count; ++i)
+                if (overlapsSphere(boxes[i], center, 3.f))
+                    objects.push_back(i);
+        });
+        RMDL_CHECK(found > 0);
+        std::printf("  %7zu objects: build %.1f ms, rebuild %.1f ms, update all %.1f ms (%.0f ns/object)\n",
+                    count, build, rebuild, update, update * 1e6 / count);
+        std::printf("           radius 3: %.2f us clean, %.2f us after moves (brute force %.0f us); 8 nearest: %.2f us, %.2f us\n",
+                    clean.first, moved.first, brute * 1e3, clean.second, moved.second);
+    }
+}
+
+RMDL_TEST_MAIN()
@@ -0,0 +1,122 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLTest.hpp                 +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 09:02:10      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef RMDLTEST_HPP
+# define RMDLTEST_HPP
+
+# include <chrono>
+# include <cstdio>
+# include <cstdlib>
+# include <cstring>
+# include <vector>
+
+// Tests for the parts of Loupy that build without Metal. Every file here is
+// its own program, built by run_tests.sh from the Loupy sources named on its
+// "// Sources:" line. RMDL_TEST cases always run; RMDL_BENCH cases run with
+// --bench and print their timings. The exit code is the number of failed
+// checks, capped at 1.
+
+namespace rmdl_test
+{
+    struct Case
+    {
+        const char* name;
+        void        (*fn)();
+        bool        benchmark;
+    };
+
+    inline std::vector<Case>& cases()
+    {
+        static std::vector<Case> all;
+        return (all);
+    }
+
+    inline int& failures()
+    {
+        static int count = 0;
+        return (count);
+    }
+
+    struct Register
+    {
+        Register( const char* name, void (*fn)(), bool benchmark ) { cases().push_back({ name, fn, benchmark }); }
+    };
+
+    inline bool check( bool ok, const char* expression, const char* file, int line )
+    {
+        if (!ok)
+        {
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+            ++failures();
+        }
+        return (ok);
+    }
+
+    /// Wall time of fn(), in milliseconds.
+    template< typename F >
+    double milliseconds( F&& fn )
+    {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        return (std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    /// Best of `runs` timings of fn(), in milliseconds.
+    template< typename F >
+    double bestOf( int runs, F&& fn )
+    {
+        double best = 1e300;
+        for (int i = 0; i < runs; ++i)
+        {
+            const double ms = milliseconds(fn);
+            best = ms < best ? ms : best;
+        }
+        return (best);
+    }
+
+    inline int run( int argc, char** argv )
+    {
+        bool benchmarks = false;
+        const char* pOnly = nullptr;
+        for (int i = 1; i < argc; ++i)
+        {
+            if (std::strcmp(argv[i], "--bench") == 0)
+                benchmarks = true;
+            else
+                pOnly = argv[i];
+        }
+        for (const Case& c : cases())
+        {
+            if ((c.benchmark && !benchmarks) || (pOnly && std::strcmp(pOnly, c.name) != 0))
+                continue;
+            const int before = failures();
+            const double ms = milliseconds(c.fn);
+            std::printf("%-6s %s (%.1f ms)\n", failures() == before ? "ok" : "FAILED", c.name, ms);
+        }
+        return (failures() != 0);
+    }
+}
+
+# define RMDL_CHECK( expression ) rmdl_test::check((expression), #expression, __FILE__, __LINE__)
+
+# define RMDL_TEST( name ) \
+    static void name(); \
+    static const rmdl_test::Register name##Registration( #name, name, false ); \
+    static void name()
+
+# define RMDL_BENCH( name ) \
+    static void name(); \
+    static const rmdl_test::Register name##Registration( #name, name, true ); \
+    static void name()
+
+# define RMDL_TEST_MAIN() \
+    int main( int argc, char** argv ) { return (rmdl_test::run(argc, argv)); }
+
+#endif /* RMDLTEST_HPP */
@@ -0,0 +1,168 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLTextBatchTests.cpp       +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 09:04:31      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+// Sources: RMDLTextBatch.cpp
+
+#include "RMDLTest.hpp"
+#include "RMDLTextBatch.hpp"
+
+#include <string>
+
+using namespace text;
+
+namespace
+{
+    GlyphTable asciiTable()
+    {
+        GlyphTable table(1.2f, 1.f);
+        for (uint32_t c = 32; c < 127; ++c)
+            table.setGlyph(c, GlyphMetrics{ 1.f, 0.f, 1.f, c == ' ' ? 0.f : 1.f, 1.f, { 0, 0, 65535, 65535 }, 0 });
+        table.setFallback('?');
+        return (table);
+    }
+}
+
+RMDL_TEST( layoutPlacesGlyphsOnLines )
+{
+    const GlyphTable table = asciiTable();
+    TextStyle style;
+    style.scale = 10.f;
+    std::vector<GlyphInstance> out;
+    RMDL_CHECK(layoutText("ab\ncd", table, style, out) == 4);
+    RMDL_CHECK(out[1].position[0] == 10.f && out[1].position[1] == out[0].position[1]);
+    RMDL_CHECK(out[2].position[0] == 0.f && out[2].position[1] == out[0].position[1] + 12.f);
+}
+
+RMDL_TEST( clippingTrimsQuadsAndUvs )
+{
+    const GlyphTable table = asciiTable();
+    TextStyle style;
+    style.scale = 10.f;
+    style.clip = true;
+    style.clipRect = { 5.f, 0.f, 15.f, 100.f };
+    std::vector<GlyphInstance> out;
+    layoutText("abcdef", table, style, out);
+    RMDL_CHECK(out.size() == 2);
+    RMDL_CHECK(out[0].position[0] == 5.f && out[0].size[0] == 5.f && out[0].uvRect[0] > 0);
+}
+
+RMDL_TEST( ringRecyclesRetiredFrames )
+{
+    std::vector<GlyphInstance> storage(10);
+    GlyphRing ring;
+    ring.reset(storage.data(), 10, 3);
+    uint32_t first = 0;
+    RMDL_CHECK(ring.allocate(6, first) && first == 0);
+    ring.beginFrame();
+    RMDL_CHECK(ring.allocate(4, first) && first == 6);
+    ring.beginFrame();
+    RMDL_CHECK(!ring.allocate(1, first));
+    ring.beginFrame();
+    RMDL_CHECK(ring.allocate(5, first) && first == 0);
+    RMDL_CHECK(!ring.allocate(2, first));
+    ring.beginFrame();
+    RMDL_CHECK(ring.allocate(5, first) && first == 5);
+}
+
+RMDL_TEST( emptyRingTakesAFullSpan )
+{
+    std::vector<GlyphInstance> storage(10);
+    GlyphRing ring;
+    ring.reset(storage.data(), 10, 2);
+    uint32_t first = 0;
+    RMDL_CHECK(ring.allocate(7, first));
+    ring.beginFrame();
+    ring.beginFrame();
+    RMDL_CHECK(ring.used() == 0);
+    // head and tail both sit at 7; the whole ring is still free.
+    RMDL_CHECK(ring.allocate(10, first) && first == 0);
+}
+
+RMDL_TEST( cacheReusesLayoutsAndSeesStyleChanges )
+{
+    const GlyphTable table = asciiTable();
+    std::vector<GlyphInstance> storage(1024);
+    TextBatch batch;
+    batch.reset(storage.data(), 1024, 3);
+    TextStyle style;
+
+    batch.beginFrame();
+    const RingSpan a = batch.submit("hello", table, style);
+    batch.beginFrame();
+    const RingSpan b = batch.submit("hello", table, style);
+    RMDL_CHECK(batch.stats().cacheHits == 1 && batch.stats().layouts == 0);
+    RMDL_CHECK(a.count == 5 && b.count == 5);
+
+    style.originX = 100.f;
+    const RingSpan c = batch.submit("hello", table, style);
+    RMDL_CHECK(batch.stats().layouts == 1);
+    RMDL_CHECK(storage[c.first].position[0] == storage[b.first].position[0] + 100.f);
+
+    batch.submit("world", table, style);
+    RMDL_CHECK(batch.stats().layouts == 2 && batch.cachedStrings() == 3);
+}
+
+RMDL_TEST( cachedRunsDrawTheirOwnText )
+{
+    const GlyphTable table = asciiTable();
+    std::vector<GlyphInstance> storage(64 * 1024);
+    TextBatch batch;
+    batch.reset(storage.data(), (uint32_t)storage.size(), 2);
+    std::vector<GlyphInstance> expected;
+    for (int frame = 0; frame < 3; ++frame)
+    {
+        batch.beginFrame();
+        for (int i = 0; i < 500; ++i)
+        {
+            const std::string str = std::string(1 + i % 40, 'x') + std::to_string(i);
+            TextStyle style;
+            style.originY = (float)(i % 7);
+            const RingSpan span = batch.submit(str, table, style);
+            expected.clear();
+            layoutText(str, table, style, expected);
+            RMDL_CHECK(span.count == expected.size());
+            RMDL_CHECK(std::memcmp(&storage[span.first], expected.data(), expected.size() * sizeof(GlyphInstance)) == 0);
+        }
+    }
+}
+
+RMDL_BENCH( hundredThousandGlyphs )
+{
+    const GlyphTable table = asciiTable();
+    std::vector<GlyphInstance> storage(300000);
+    TextBatch batch;
+    batch.reset(storage.data(), (uint32_t)storage.size(), 3);
+    std::vector<std::string> lines;
+    for (int i = 0; i < 1000; ++i)
+    {
+        std::string line;
+        for (int k = 0; k < 100; ++k)
+            line += (char)('a' + (i + k) % 26);
+        lines.push_back(line);
+    }
+    auto frame = [&]( int salt )
+    {
+        batch.beginFrame();
+        for (int i = 0; i < 1000; ++i)
+        {
+            TextStyle style;
+            style.originY = (float)(i * 12);
+            style.color = (uint32_t)salt;
+            batch.submit(lines[i], table, style);
+        }
+    };
+    int salt = 0;
+    const double layout = rmdl_test::bestOf(10, [&]() { frame(++salt); });
+    const double cached = rmdl_test::bestOf(10, [&]() { frame(salt); });
+    RMDL_CHECK(batch.stats().glyphs == 100000 && batch.stats().dropped == 0);
+    std::printf("  100k glyphs: %.3f ms laid out, %.3f ms cached, %u allocations\n", layout, cached, batch.stats().allocations);
+}
+
+RMDL_TEST_MAIN()
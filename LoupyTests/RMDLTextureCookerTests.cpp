@@ -0,0 +1,180 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLTextureCookerTests.cpp   +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 10:02:40      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+// Sources: RMDLTextureCooker.cpp RMDLTextureUtils.cpp RMDLParallel.cpp
+
+#include "RMDLTest.hpp"
+#include "RMDLTextureCooker.hpp"
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+
+using namespace texture_utils;
+
+namespace
+{
+    /// Smooth gradients with a little noise in RGB, a ramp in alpha.
+    Image colourImage( uint32_t size )
+    {
+        Image image;
+        image.width = image.height = size;
+        image.rgba.resize((size_t)size * size * 4);
+        uint32_t seed = 1;
+        for (uint32_t y = 0; y < size; ++y)
+        {
+            for (uint32_t x = 0; x < size; ++x)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                uint8_t* p = &image.rgba[((size_t)y * size + x) * 4];
+                p[0] = (uint8_t)(128 + 100 * std::sin(x * 0.05) + (seed >> 28));
+                p[1] = (uint8_t)(128 + 90 * std::cos(y * 0.03));
+                p[2] = (uint8_t)((x ^ y) & 255);
+                p[3] = (uint8_t)(200 + x % 32);
+            }
+        }
+        return (image);
+    }
+
+    Image normalImage( uint32_t size )
+    {
+        Image image = colourImage(size);
+        for (uint32_t y = 0; y < size; ++y)
+        {
+            for (uint32_t x = 0; x < size; ++x)
+            {
+                uint8_t* p = &image.rgba[((size_t)y * size + x) * 4];
+                const float nx = 0.5f * std::sin(x * 0.07f), ny = 0.5f * std::cos(y * 0.05f + x * 0.01f);
+                p[0] = (uint8_t)std::lround((nx * 0.5f + 0.5f) * 255);
+                p[1] = (uint8_t)std::lround((ny * 0.5f + 0.5f) * 255);
+            }
+        }
+        return (image);
+    }
+
+    double psnr( const Image& a, const Image& b, int channels )
+    {
+        double squared = 0.0;
+        size_t count = 0;
+        for (size_t i = 0; i < a.rgba.size(); i += 4)
+        {
+            for (int c = 0; c < channels; ++c, ++count)
+            {
+                const double d = (double)a.rgba[i + c] - b.rgba[i + c];
+                squared += d * d;
+            }
+        }
+        const double mse = squared / count;
+        return (mse == 0.0 ? 99.0 : 10.0 * std::log10(255.0 * 255.0 / mse));
+    }
+
+    std::string tempPath( const char* name )
+    {
+        return ((std::filesystem::temp_directory_path() / name).string());
+    }
+
+    /// Saves `cooked`, lets `damage` edit the level table, and tries to load it back.
+    template< typename F >
+    bool loadsAfter( const CookedTexture& cooked, F&& damage )
+    {
+        CookedTexture copy = cooked;
+        damage(copy);
+        const std::string path = tempPath("loupy-test-damaged.rtex");
+        saveCookedTexture(path, copy);
+        CookedTexture loaded;
+        const bool ok = loadCookedTexture(path, loaded);
+        std::filesystem::remove(path);
+        return (ok);
+    }
+}
+
+RMDL_TEST( flatBlocksStayFlat )
+{
+    uint8_t block[64], out[16], back[64];
+    for (int i = 0; i < 64; ++i)
+        block[i] = (uint8_t)(i % 4 == 3 ? 255 : 130);
+    encodeBC7Block(block, CookQuality::Quality, out);
+    RMDL_CHECK(decodeBC7Block(out, back));
+    // Mode 6 shares one p-bit across RGBA, so 130 and 255 cannot both be exact.
+    for (int i = 0; i < 64; ++i)
+        RMDL_CHECK(std::abs(back[i] - block[i]) <= 1 && back[i] == back[i & 3]);
+}
+
+RMDL_TEST( compressionKeepsQuality )
+{
+    const Image colour = colourImage(128), normals = normalImage(128);
+    std::vector<uint8_t> blocks;
+    Image decoded;
+    compressImage(colour, BlockFormat::BC7, CookQuality::Fast, blocks);
+    decompressImage(blocks, BlockFormat::BC7, 128, 128, decoded);
+    const double fast = psnr(colour, decoded, 4);
+    compressImage(colour, BlockFormat::BC7, CookQuality::Quality, blocks);
+    decompressImage(blocks, BlockFormat::BC7, 128, 128, decoded);
+    const double quality = psnr(colour, decoded, 4);
+    RMDL_CHECK(fast > 30.0 && quality >= fast);
+
+    compressImage(normals, BlockFormat::BC5, CookQuality::Fast, blocks);
+    decompressImage(blocks, BlockFormat::BC5, 128, 128, decoded);
+    RMDL_CHECK(psnr(normals, decoded, 2) > 40.0);
+}
+
+RMDL_TEST( cookedFilesRoundTrip )
+{
+    Image small;
+    small.width = 13;
+    small.height = 7;
+    small.rgba.assign(13 * 7 * 4, 77);
+    CookedTexture cooked;
+    cookTexture(small, CookDesc(), cooked);
+    RMDL_CHECK(cooked.levels.size() == 4 && cooked.levels[0].bytesPerRow == 4 * 16);
+
+    const std::string path = tempPath("loupy-test.rtex");
+    RMDL_CHECK(saveCookedTexture(path, cooked));
+    CookedTexture loaded;
+    RMDL_CHECK(loadCookedTexture(path, loaded));
+    RMDL_CHECK(loaded.data == cooked.data && loaded.levels.size() == cooked.levels.size());
+
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    RMDL_CHECK(!loadCookedTexture(path, loaded));
+    std::filesystem::remove(path);
+}
+
+RMDL_TEST( damagedLevelTablesAreRejected )
+{
+    CookedTexture cooked;
+    cookTexture(colourImage(64), CookDesc(), cooked);
+    RMDL_CHECK(loadsAfter(cooked, []( CookedTexture& ) {}));
+    // offset + size wraps around to a small number.
+    RMDL_CHECK(!loadsAfter(cooked, []( CookedTexture& c ) { c.levels[2].offset = ~0ull - 8; }));
+    RMDL_CHECK(!loadsAfter(cooked, []( CookedTexture& c ) { c.levels[1].width = 64; }));
+    RMDL_CHECK(!loadsAfter(cooked, []( CookedTexture& c ) { c.levels[3].bytesPerRow *= 2; }));
+    RMDL_CHECK(!loadsAfter(cooked, []( CookedTexture& c ) { c.levels[0].size -= 16; }));
+    RMDL_CHECK(!loadsAfter(cooked, []( CookedTexture& c ) { c.levels.push_back(c.levels.back()); }));
+    RMDL_CHECK(!loadsAfter(cooked, []( CookedTexture& c ) { c.levels.clear(); }));
+}
+
+RMDL_BENCH( compressionSpeedAndQuality )
+{
+    const Image colour = colourImage(1024), normals = normalImage(1024);
+    std::vector<uint8_t> blocks;
+    Image decoded;
+    for (CookQuality quality : { CookQuality::Fast, CookQuality::Quality })
+    {
+        const char* name = quality == CookQuality::Fast ? "fast" : "quality";
+        double ms = rmdl_test::milliseconds([&]() { compressImage(colour, BlockFormat::BC7, quality, blocks); });
+        decompressImage(blocks, BlockFormat::BC7, 1024, 1024, decoded);
+        std::printf("  BC7 %-7s 1024^2: %7.1f ms, %6.2f MP/s, PSNR RGBA %.2f dB\n", name, ms, 1048.576 / ms, psnr(colour, decoded, 4));
+        ms = rmdl_test::milliseconds([&]() { compressImage(normals, BlockFormat::BC5, quality, blocks); });
+        decompressImage(blocks, BlockFormat::BC5, 1024, 1024, decoded);
+        std::printf("  BC5 %-7s 1024^2: %7.1f ms, %6.2f MP/s, PSNR RG %.2f dB\n", name, ms, 1048.576 / ms, psnr(normals, decoded, 2));
+    }
+}
+
+RMDL_TEST_MAIN()
@@ -0,0 +1,178 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLTextureUtilsTests.cpp    +++     +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 09:47:18      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+// Sources: RMDLTextureUtils.cpp RMDLParallel.cpp
+
+#include "RMDLTest.hpp"
+#include "RMDLTextureUtils.hpp"
+#include "RMDLParallel.hpp"
+
+#include <cstdlib>
+#include <stdexcept>
+
+using namespace texture_utils;
+
+namespace
+{
+    Image checkerboard( uint32_t width, uint32_t height )
+    {
+        Image image;
+        image.width = width;
+        image.height = height;
+        image.rgba.resize((size_t)width * height * 4);
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                uint8_t* texel = &image.rgba[((size_t)y * width + x) * 4];
+                texel[0] = texel[1] = texel[2] = ((x ^ y) & 1) ? 255 : 0;
+                texel[3] = 255;
+            }
+        }
+        return (image);
+    }
+
+    Image noise( uint32_t size )
+    {
+        Image image;
+        image.width = image.height = size;
+        image.rgba.resize((size_t)size * size * 4);
+        for (size_t i = 0; i < image.rgba.size(); ++i)
+            image.rgba[i] = (uint8_t)(i * 2654435761u >> 24);
+        return (image);
+    }
+}
+
+RMDL_TEST( levelCountsAndSizes )
+{
+    RMDL_CHECK(mipLevelCount(1024, 1024) == 11 && mipLevelCount(1000, 600) == 10);
+    RMDL_CHECK(mipLevelCount(1, 1) == 1 && mipLevelCount(2, 1) == 2);
+
+    std::vector<Image> levels;
+    buildMipChain(checkerboard(12, 5), MipChainDesc(), levels);
+    RMDL_CHECK(levels.size() == 4);
+    RMDL_CHECK(levels[1].width == 6 && levels[1].height == 2);
+    RMDL_CHECK(levels[3].width == 1 && levels[3].height == 1 && levels[3].rgba.size() == 4);
+}
+
+RMDL_TEST( checkerboardAveragesInTheRightSpace )
+{
+    // Half black, half white is 0.5 in linear light: 188 in sRGB, 128 stored linear.
+    for (MipFilter filter : { MipFilter::Box, MipFilter::Kaiser })
+    {
+        for (bool srgb : { true, false })
+        {
+            MipChainDesc desc;
+            desc.filter = filter;
+            desc.srgb = srgb;
+            std::vector<Image> levels;
+            buildMipChain(checkerboard(64, 64), desc, levels);
+            const int expected = srgb ? 188 : 128;
+            // A windowed sinc does not quite cancel a pattern right at Nyquist.
+            const int tolerance = filter == MipFilter::Box ? 1 : 8;
+            for (size_t level = 1; level < levels.size(); ++level)
+            {
+                const uint8_t* texel = &levels[level].rgba[0];
+                RMDL_CHECK(std::abs(texel[0] - expected) <= tolerance && texel[3] == 255);
+            }
+        }
+    }
+}
+
+RMDL_TEST( unpremultiplyRestoresColor )
+{
+    Image image;
+    image.width = 3;
+    image.height = 1;
+    image.rgba = { 64, 32, 0, 128,   0, 0, 0, 0,   10, 20, 30, 255 };
+    unpremultiply(image);
+    RMDL_CHECK(image.rgba[0] == 128 && image.rgba[1] == 64 && image.rgba[2] == 0 && image.rgba[3] == 128);
+    RMDL_CHECK(image.rgba[4] == 0 && image.rgba[7] == 0);
+    RMDL_CHECK(image.rgba[8] == 10 && image.rgba[10] == 30);
+}
+
+RMDL_TEST( streamDeliversEverySlice )
+{
+    parallel::ThreadPool pool(2);
+    std::vector<std::string> paths = { "a", "bad", "throw", "b", "empty" };
+    const Image base = checkerboard(32, 16);
+    std::vector<bool> seen(paths.size(), false);
+    {
+        SliceStream stream(paths, [&]( const std::string& path, Image& out ) {
+            if (path == "bad")
+                return (false);
+            if (path == "throw")
+                throw std::runtime_error("corrupt file");
+            if (path != "empty")
+                out = base;
+            return (true);
+        }, MipChainDesc(), pool);
+        RMDL_CHECK(stream.sliceCount() == 5);
+        SliceStream::Slice slice;
+        while (stream.next(slice))
+        {
+            seen[slice.index] = true;
+            const bool good = paths[slice.index] == "a" || paths[slice.index] == "b";
+            RMDL_CHECK(slice.ok == good);
+            RMDL_CHECK(slice.levels.size() == (good ? 6u : 0u));
+        }
+    }
+    for (bool s : seen)
+        RMDL_CHECK(s);
+}
+
+RMDL_TEST( destroyingAnUnreadStreamWaitsForItsJobs )
+{
+    parallel::ThreadPool pool(2);
+    int calls = 0;
+    std::mutex mutex;
+    {
+        SliceStream stream(std::vector<std::string>(6, "x"), [&]( const std::string&, Image& out ) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (++calls % 2)
+                throw std::bad_alloc();
+            out = checkerboard(8, 8);
+            return (true);
+        }, MipChainDesc(), pool);
+    }
+    // ~SliceStream returned, so no job can touch `calls` any more.
+    RMDL_CHECK(calls == 6);
+}
+
+RMDL_BENCH( mipChainsAndSlices )
+{
+    const Image big = noise(2048);
+    std::vector<Image> levels;
+    MipChainDesc desc;
+    const double box = rmdl_test::bestOf(3, [&]() { buildMipChain(big, desc, levels); });
+    desc.filter = MipFilter::Kaiser;
+    const double kaiser = rmdl_test::bestOf(3, [&]() { buildMipChain(big, desc, levels); });
+    std::printf("  2048^2 chain: box %.1f ms (%.0f MP/s), kaiser %.1f ms (%.0f MP/s)\n",
+                box, 4.194304 / box * 1e3, kaiser, 4.194304 / kaiser * 1e3);
+
+    double first = 0.0;
+    const double all = rmdl_test::milliseconds([&]() {
+        const auto start = std::chrono::steady_clock::now();
+        SliceStream stream(std::vector<std::string>(8, "x"), [&]( const std::string&, Image& out ) {
+            out = big;
+            return (true);
+        }, MipChainDesc());
+        SliceStream::Slice slice;
+        while (stream.next(slice))
+        {
+            if (first == 0.0)
+                first = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+    });
+    std::printf("  8 slices of 2048^2 on %u workers: first after %.1f ms, all after %.1f ms\n",
+                parallel::defaultPool().size(), first, all);
+}
+
+RMDL_TEST_MAIN()
@@ -0,0 +1,259 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                        +       +          */
+/*      File: RMDLTransformHierarchyTests.cpp ++   +++		**/
+/*                                        +       +          */
+/*      By: Laboitederemdal      **        +       +        **/
+/*                                       +           +       */
+/*      Created: 20/10/2026 13:38:50      + + + + + +   * ****/
+/*                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+// Sources: RMDLTransformHierarchy.cpp RMDLBatchMath.cpp RMDLParallel.cpp RMDLMathUtils.cpp RMDLRandom.cpp
+
+#include "RMDLTest.hpp"
+#include "RMDLTransformHierarchy.hpp"
+#include "RMDLRandom.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace scene;
+
+namespace
+{
+    /// What the hierarchy should hold, kept by handle and composed the slow way.
+    struct Reference
+    {
+        std::vector<NodeId>             parent;
+        std::vector<simd::float3>       translation, scale;
+        std::vector<quaternion_float>   rotation;
+
+        void set( NodeId node, NodeId p, simd::float3 t, quaternion_float r, simd::float3 s )
+        {
+            if (node >= parent.size())
+            {
+                parent.resize(node + 1);
+                translation.resize(node + 1);
+                scale.resize(node + 1);
+                rotation.resize(node + 1);
+            }
+            parent[node] = p;
+            translation[node] = t;
+            rotation[node] = r;
+            scale[node] = s;
+        }
+
+        simd::float4x4 local( NodeId node ) const
+        {
+            return (simd::float4x4(matrix4x4_translation(translation[node])) * simd::float4x4(matrix4x4_from_quaternion(rotation[node]))
+                    * simd::float4x4(matrix4x4_scale(scale[node])));
+        }
+
+        simd::float4x4 world( NodeId node ) const
+        {
+            return (parent[node] == kNoNode ? local(node) : world(parent[node]) * local(node));
+        }
+
+        bool isAncestor( NodeId ancestor, NodeId node ) const
+        {
+            for (NodeId p = node; p != kNoNode; p = parent[p])
+            {
+                if (p == ancestor)
+                    return (true);
+            }
+            return (false);
+        }
+    };
+
+    struct Random
+    {
+        rng::Stream     stream { 3 };
+
+        simd::float3    float3( float min, float max )  { return (simd::float3{ stream.uniform(min, max), stream.uniform(min, max), stream.uniform(min, max) }); }
+        quaternion_float rotation()
+        {
+            return (quaternion_normalize(quaternion(stream.uniform(-1.f, 1.f), stream.uniform(-1.f, 1.f), stream.uniform(-1.f, 1.f), stream.uniform(-1.f, 1.f))));
+        }
+        NodeId          pick( const std::vector<NodeId>& nodes )    { return (nodes[stream.nextU32() % nodes.size()]); }
+    };
+
+    /// Largest relative difference from the reference over `nodes`.
+    double worldError( const TransformHierarchy& hierarchy, const Reference& reference, const std::vector<NodeId>& nodes )
+    {
+        double error = 0.0;
+        for (NodeId node : nodes)
+        {
+            const simd::float4x4 a = hierarchy.world(node), b = reference.world(node);
+            for (int c = 0; c < 4; ++c)
+                for (int r = 0; r < 4; ++r)
+                    error = std::max(error, std::fabs(a.columns[c][r] - b.columns[c][r]) / (1.0 + std::fabs(b.columns[c][r])));
+        }
+        return (error);
+    }
+
+    /// 20000 nodes, created in random order under random parents.
+    std::vector<NodeId> randomForest( TransformHierarchy& hierarchy, Reference& reference, Random& random )
+    {
+        std::vector<NodeId> nodes;
+        for (int i = 0; i < 20000; ++i)
+        {
+            const NodeId parent = nodes.empty() || random.stream.nextFloat() < 0.01f ? kNoNode : random.pick(nodes);
+            const NodeId node = hierarchy.create(parent);
+            reference.set(node, parent, random.float3(-1.f, 1.f), random.rotation(), random.float3(0.9f, 1.1f));
+            hierarchy.setLocal(node, reference.translation[node], reference.rotation[node], reference.scale[node]);
+            nodes.push_back(node);
+        }
+        return (nodes);
+    }
+
+    /// Complete 4-ary tree of `count` nodes, about ten levels for 1M.
+    std::vector<NodeId> wideTree( TransformHierarchy& hierarchy, Random& random, size_t count )
+    {
+        std::vector<NodeId> nodes;
+        nodes.reserve(count);
+        nodes.push_back(hierarchy.create());
+        for (size_t i = 1; i < count; ++i)
+        {
+            const NodeId node = hierarchy.create(nodes[(i - 1) / 4]);
+            hierarchy.setLocal(node, random.float3(-1.f, 1.f), random.rotation(), random.float3(0.9f, 1.1f));
+            nodes.push_back(node);
+        }
+        return (nodes);
+    }
+}
+
+RMDL_TEST( fullUpdateMatchesComposition )
+{
+    TransformHierarchy hierarchy;
+    Reference reference;
+    Random random;
+    const std::vector<NodeId> nodes = randomForest(hierarchy, reference, random);
+    hierarchy.update();
+    RMDL_CHECK(hierarchy.lastUpdate().rebuilt && hierarchy.nodeCount() == nodes.size());
+    RMDL_CHECK(worldError(hierarchy, reference, nodes) < 1e-4);
+}
+
+RMDL_TEST( partialUpdatesRecomputeOnlyMovedBranches )
+{
+    TransformHierarchy hierarchy;
+    Reference reference;
+    Random random;
+    const std::vector<NodeId> nodes = randomForest(hierarchy, reference, random);
+    hierarchy.update();
+    for (int frame = 0; frame < 20; ++frame)
+    {
+        for (int k = 0; k < 50; ++k)
+        {
+            const NodeId node = random.pick(nodes);
+            reference.translation[node] = random.float3(-1.f, 1.f);
+            hierarchy.setTranslation(node, reference.translation[node]);
+            if (k % 3 == 0)
+            {
+                reference.rotation[node] = random.rotation();
+                hierarchy.setRotation(node, reference.rotation[node]);
+            }
+        }
+        hierarchy.update();
+        RMDL_CHECK(!hierarchy.lastUpdate().rebuilt && hierarchy.lastUpdate().recomputed < nodes.size());
+    }
+    RMDL_CHECK(worldError(hierarchy, reference, nodes) < 1e-4);
+    hierarchy.update();
+    RMDL_CHECK(hierarchy.lastUpdate().recomputed == 0);
+}
+
+RMDL_TEST( reparentingRefusesCycles )
+{
+    TransformHierarchy hierarchy;
+    Reference reference;
+    Random random;
+    const std::vector<NodeId> nodes = randomForest(hierarchy, reference, random);
+    RMDL_CHECK(!hierarchy.setParent(nodes[10], nodes[10]));
+    size_t wrong = 0;
+    for (int k = 0; k < 200; ++k)
+    {
+        const NodeId node = random.pick(nodes), parent = random.pick(nodes);
+        const bool moved = hierarchy.setParent(node, parent);
+        wrong += moved == reference.isAncestor(node, parent);
+        if (moved)
+            reference.parent[node] = parent;
+    }
+    RMDL_CHECK(wrong == 0);
+    hierarchy.update();
+    RMDL_CHECK(worldError(hierarchy, reference, nodes) < 1e-4);
+}
+
+RMDL_TEST( destroyRemovesSubtreesAndReusesHandles )
+{
+    TransformHierarchy hierarchy;
+    Reference reference;
+    Random random;
+    const std::vector<NodeId> nodes = randomForest(hierarchy, reference, random);
+    std::vector<NodeId> gone;
+    for (int k = 0; k < 30; ++k)
+    {
+        gone.push_back(random.pick(nodes));
+        hierarchy.destroy(gone.back());
+    }
+    hierarchy.update();
+    std::vector<NodeId> alive;
+    size_t wrong = 0;
+    for (NodeId node : nodes)
+    {
+        const bool under = std::any_of(gone.begin(), gone.end(), [&]( NodeId g ) { return (reference.isAncestor(g, node)); });
+        wrong += hierarchy.isAlive(node) == under;
+        if (!under)
+            alive.push_back(node);
+    }
+    RMDL_CHECK(wrong == 0 && hierarchy.nodeCount() == alive.size());
+    RMDL_CHECK(worldError(hierarchy, reference, alive) < 1e-4);
+    RMDL_CHECK(hierarchy.create() < nodes.size());
+
+    std::vector<simd::float4x4> instances(alive.size());
+    hierarchy.gatherWorld(alive.data(), alive.size(), instances.data());
+    size_t mismatches = 0;
+    for (size_t k = 0; k < alive.size(); ++k)
+        mismatches += std::memcmp(&instances[k], &hierarchy.world(alive[k]), sizeof(simd::float4x4)) != 0;
+    RMDL_CHECK(mismatches == 0);
+}
+
+RMDL_BENCH( millionNodeUpdates )
+{
+    const size_t count = 1 << 20;
+    TransformHierarchy hierarchy;
+    Random random;
+    const std::vector<NodeId> nodes = wideTree(hierarchy, random, count);
+    const double first = rmdl_test::milliseconds([&]() { hierarchy.update(); });
+    std::printf("  %zu nodes, %u levels: first update (rebuild) %.1f ms\n", count, hierarchy.lastUpdate().levels, first);
+
+    // Moving the root dirties everything.
+    const double full = rmdl_test::bestOf(5, [&]()
+    {
+        hierarchy.setTranslation(nodes[0], random.float3(-1.f, 1.f));
+        hierarchy.update();
+    });
+    RMDL_CHECK(hierarchy.lastUpdate().recomputed == count);
+    std::printf("  full update %.2f ms (%.1f ns/node)\n", full, full * 1e6 / count);
+
+    for (size_t moved : { 1000, 10000 })
+    {
+        const double partial = rmdl_test::bestOf(5, [&]()
+        {
+            for (size_t k = 0; k < moved; ++k)
+                hierarchy.setTranslation(nodes[count / 2 + random.stream.nextU32() % (count / 2)], random.float3(-1.f, 1.f));
+            hierarchy.update();
+        });
+        std::printf("  %zu random leaves moved: %.3f ms (%zu recomputed)\n", moved, partial, hierarchy.lastUpdate().recomputed);
+    }
+    const double subtree = rmdl_test::bestOf(5, [&]()
+    {
+        hierarchy.setRotation(nodes[5], random.rotation());
+        hierarchy.update();
+    });
+    std::printf("  one depth-2 subtree moved: %.3f ms (%zu recomputed)\n", subtree, hierarchy.lastUpdate().recomputed);
+
+    std::vector<simd::float4x4> instances(count);
+    const double gather = rmdl_test::bestOf(5, [&]() { hierarchy.gatherWorld(nodes.data(), count, instances.data()); });
+    std::printf("  gather %zu instance matrices %.2f ms\n", count, gather);
+}
+
+RMDL_TEST_MAIN()
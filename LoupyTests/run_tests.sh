@@ -0,0 +1,50 @@
+#!/bin/sh
+#
+# Builds and runs the tests in this folder against the Loupy sources.
+#
+#   LoupyTests/run_tests.sh                 every test
+#   LoupyTests/run_tests.sh --bench         tests and benchmarks
+#   LoupyTests/run_tests.sh RMDLRadixSortTests [--bench]
+#
+# CXX, CXXFLAGS and BUILD_DIR override the compiler, its flags and where the
+# programs go.
+
+here=$(cd "$(dirname "$0")" && pwd)
+loupy="$here/../Loupy"
+build="${BUILD_DIR:-${TMPDIR:-/tmp}/loupy-tests}"
+cxx="${CXX:-c++}"
+flags="${CXXFLAGS:--std=gnu++20 -O2 -g -Wall -Wextra -Wno-unknown-pragmas}"
+
+only=""
+args=""
+for arg in "$@"; do
+    case "$arg" in
+        RMDL*) only="$only $arg" ;;
+        *) args="$args $arg" ;;
+    esac
+done
+
+mkdir -p "$build" || exit 1
+failed=""
+for test in "$here"/RMDL*Tests.cpp; do
+    name=$(basename "$test" .cpp)
+    if [ -n "$only" ] && ! echo " $only " | grep -q " $name "; then
+        continue
+    fi
+    sources=""
+    for source in $(sed -n 's#^// Sources:##p' "$test"); do
+        sources="$sources $loupy/$source"
+    done
+    echo "== $name"
+    if ! $cxx $flags -I"$loupy" -I"$here" "$test" $sources -pthread -o "$build/$name"; then
+        failed="$failed $name"
+        continue
+    fi
+    "$build/$name" $args || failed="$failed $name"
+done
+
+if [ -n "$failed" ]; then
+    echo "failed:$failed"
+    exit 1
+fi
+echo "all passed"